@@ -14,8 +14,56 @@ SOURCES += \
     src/core/session_manager.cpp \
     src/core/command_parser.cpp \
     src/engines/network/network_engine.cpp \
+    src/engines/network/scan_protocol.cpp \
+    src/engines/network/scan_coordinator.cpp \
+    src/engines/network/scan_worker.cpp \
+    src/engines/network/trace_prober.cpp \
+    src/engines/network/proxy_scanner.cpp \
+    src/engines/network/connect_scanner.cpp \
+    src/engines/network/syn_scanner.cpp \
+    src/engines/network/host_guard.cpp \
+    src/engines/network/liveness_tracker.cpp \
+    src/engines/network/scan_baseline.cpp \
+    src/engines/web/http_parser.cpp \
+    src/engines/web/http_client.cpp \
+    src/engines/web/content_discovery.cpp \
+    src/engines/web/response_filter.cpp \
+    src/engines/web/tech_fingerprint.cpp \
+    src/engines/web/html_tokenizer.cpp \
+    src/engines/web/crawler.cpp \
+    src/engines/web/web_engine.cpp \
+    src/engines/tls/tls_hello.cpp \
+    src/engines/tls/x509_info.cpp \
+    src/engines/tls/tls_session.cpp \
+    src/engines/tls/tls_prober.cpp \
+    src/engines/tls/cipher_enum.cpp \
+    src/engines/tls/tls_fingerprint.cpp \
+    src/engines/tls/tls_engine.cpp \
+    src/engines/service/service_prober.cpp \
+    src/engines/service/database_probes.cpp \
+    src/engines/service/ssh_probe.cpp \
+    src/engines/service/conversation.cpp \
+    src/engines/service/text_probes.cpp \
+    src/engines/service/service_engine.cpp \
+    src/engines/dns/dns_message.cpp \
+    src/engines/dns/dns_client.cpp \
+    src/engines/dns/subdomain_enum.cpp \
+    src/engines/dns/dns_engine.cpp \
     src/ai/ai_manager.cpp \
     src/utils/network_utils.cpp \
+    src/utils/packet_template.cpp \
+    src/utils/packet_channel.cpp \
+    src/utils/xdp_channel.cpp \
+    src/utils/socket_budget.cpp \
+    src/utils/proxy_pool.cpp \
+    src/utils/target_space.cpp \
+    src/utils/json_utils.cpp \
+    src/utils/event_loop.cpp \
+    src/utils/wordlist.cpp \
+    src/utils/host_cluster.cpp \
+    src/utils/multi_pattern.cpp \
+    src/utils/bloom_filter.cpp \
+    src/utils/buffer_arena.cpp \
     src/core/database.cpp \
     src/core/config_manager.cpp
 
@@ -26,8 +74,56 @@ HEADERS += \
     src/core/command_parser.h \
     src/engines/engine_interface.h \
     src/engines/network/network_engine.h \
+    src/engines/network/scan_protocol.h \
+    src/engines/network/scan_coordinator.h \
+    src/engines/network/scan_worker.h \
+    src/engines/network/trace_prober.h \
+    src/engines/network/proxy_scanner.h \
+    src/engines/network/connect_scanner.h \
+    src/engines/network/syn_scanner.h \
+    src/engines/network/host_guard.h \
+    src/engines/network/liveness_tracker.h \
+    src/engines/network/scan_baseline.h \
+    src/engines/web/http_parser.h \
+    src/engines/web/http_client.h \
+    src/engines/web/content_discovery.h \
+    src/engines/web/response_filter.h \
+    src/engines/web/tech_fingerprint.h \
+    src/engines/web/html_tokenizer.h \
+    src/engines/web/crawler.h \
+    src/engines/web/web_engine.h \
+    src/engines/tls/tls_hello.h \
+    src/engines/tls/x509_info.h \
+    src/engines/tls/tls_session.h \
+    src/engines/tls/tls_prober.h \
+    src/engines/tls/cipher_enum.h \
+    src/engines/tls/tls_fingerprint.h \
+    src/engines/tls/tls_engine.h \
+    src/engines/service/service_prober.h \
+    src/engines/service/database_probes.h \
+    src/engines/service/ssh_probe.h \
+    src/engines/service/conversation.h \
+    src/engines/service/text_probes.h \
+    src/engines/service/service_engine.h \
+    src/engines/dns/dns_message.h \
+    src/engines/dns/dns_client.h \
+    src/engines/dns/subdomain_enum.h \
+    src/engines/dns/dns_engine.h \
     src/ai/ai_manager.h \
     src/utils/network_utils.h \
+    src/utils/packet_template.h \
+    src/utils/packet_channel.h \
+    src/utils/xdp_channel.h \
+    src/utils/socket_budget.h \
+    src/utils/proxy_pool.h \
+    src/utils/target_space.h \
+    src/utils/json_utils.h \
+    src/utils/event_loop.h \
+    src/utils/wordlist.h \
+    src/utils/host_cluster.h \
+    src/utils/multi_pattern.h \
+    src/utils/bloom_filter.h \
+    src/utils/buffer_arena.h \
     src/core/database.h \
     src/core/config_manager.h
 
@@ -37,3 +133,10 @@ INCLUDEPATH += src
 win32 {
     LIBS += -lws2_32 -liphlpapi
 }
+
+# OpenSSL可选 (完整TLS握手、会话复用和HTTPS)
+packagesExist(openssl) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += openssl
+    DEFINES += MINDSPLOIT_HAVE_OPENSSL
+}
@@ -361,8 +361,21 @@ void CommandParser::defineBuiltinCommands() {
     // === 网络扫描命令 ===
     defineCommand("discover", "主机发现", "discover <target>", {"ping"}, CommandType::ENGINE, "network");
     defineCommand("scan", "端口扫描", "scan <target> [ports=<ports>]", {"portscan"}, CommandType::ENGINE, "network");
+    defineCommand("traceroute", "并行路由跟踪与拓扑发现", "traceroute <target> [method=udp|tcp|icmp] [max-ttl=<n>]", {"tracert"}, CommandType::ENGINE, "network");
     defineCommand("service", "服务识别", "service <target>", {"svc"}, CommandType::ENGINE, "network");
     defineCommand("os", "操作系统识别", "os <target>", {"osdetect"}, CommandType::ENGINE, "network");
+    defineCommand("coordinator", "分布式扫描协调节点", "coordinator <target> [ports=<ports>] [listen=<addr:port>]", {}, CommandType::ENGINE, "network");
+    defineCommand("worker", "分布式扫描工作节点", "worker <host:port>", {}, CommandType::ENGINE, "network");
+    defineCommand("http", "HTTP探测", "http <target|url> [ports=<ports>] [paths=<paths>]", {}, CommandType::ENGINE, "web");
+    defineCommand("dirscan", "目录与文件内容发现", "dirscan <target|url> wordlist=<file> [extensions=<exts>]", {}, CommandType::ENGINE, "web");
+    defineCommand("crawl", "Web爬虫", "crawl <target|url> [depth=<n>] [pages=<n>] [delay=<ms>]", {}, CommandType::ENGINE, "web");
+    defineCommand("tls", "TLS握手与证书采集", "tls <target|host:port> [ports=<ports>] [mode=full|cert]", {}, CommandType::ENGINE, "tls");
+    defineCommand("ciphers", "TLS协议版本与密码套件枚举", "ciphers <target|host:port> [ports=<ports>]", {}, CommandType::ENGINE, "tls");
+    defineCommand("tlsfp", "主动TLS服务端指纹与聚类", "tlsfp <target|host:port> [ports=<ports>]", {}, CommandType::ENGINE, "tls");
+    defineCommand("dbscan", "数据库与缓存服务探测", "dbscan <target|host:port> [ports=<ports>] [protocols=<list>]", {}, CommandType::ENGINE, "service");
+    defineCommand("sshscan", "SSH版本与算法枚举", "sshscan <target|host:port> [ports=<ports>] [hostkey=on|off]", {}, CommandType::ENGINE, "service");
+    defineCommand("capscan", "邮件与FTP服务能力探测", "capscan <target|host:port> [ports=<ports>] [protocols=smtp,ftp,pop3,imap]", {}, CommandType::ENGINE, "service");
+    defineCommand("dns-enum", "子域名枚举", "dns-enum <domain> wordlist=<file> [resolvers=<list>] [rate=<qps>]", {"subenum"}, CommandType::ENGINE, "dns");
 
     // === 别名管理 ===
     defineCommand("alias", "创建别名", "alias <name> <command>", {}, CommandType::BUILTIN);
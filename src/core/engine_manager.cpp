@@ -1,5 +1,9 @@
 #include "engine_manager.h"
 #include "../engines/network/network_engine.h"
+#include "../engines/web/web_engine.h"
+#include "../engines/tls/tls_engine.h"
+#include "../engines/service/service_engine.h"
+#include "../engines/dns/dns_engine.h"
 #include <iostream>
 
 namespace MindSploit::Core {
@@ -231,6 +235,46 @@ void EngineManager::registerBuiltinEngines() {
     } else {
         std::cout << "[+] 网络引擎加载成功" << std::endl;
     }
+
+    // 注册Web探测引擎
+    auto webFactory = std::make_unique<EngineFactoryTemplate<Web::WebEngine>>();
+    registerEngine("web", std::move(webFactory));
+
+    if (!loadEngine("web")) {
+        std::cerr << "[!] 警告: Web引擎加载失败" << std::endl;
+    } else {
+        std::cout << "[+] Web引擎加载成功" << std::endl;
+    }
+
+    // 注册TLS探测引擎
+    auto tlsFactory = std::make_unique<EngineFactoryTemplate<Tls::TlsEngine>>();
+    registerEngine("tls", std::move(tlsFactory));
+
+    if (!loadEngine("tls")) {
+        std::cerr << "[!] 警告: TLS引擎加载失败" << std::endl;
+    } else {
+        std::cout << "[+] TLS引擎加载成功" << std::endl;
+    }
+
+    // 注册服务探测引擎
+    auto serviceFactory = std::make_unique<EngineFactoryTemplate<Service::ServiceEngine>>();
+    registerEngine("service", std::move(serviceFactory));
+
+    if (!loadEngine("service")) {
+        std::cerr << "[!] 警告: 服务探测引擎加载失败" << std::endl;
+    } else {
+        std::cout << "[+] 服务探测引擎加载成功" << std::endl;
+    }
+
+    // 注册DNS引擎
+    auto dnsFactory = std::make_unique<EngineFactoryTemplate<Dns::DnsEngine>>();
+    registerEngine("dns", std::move(dnsFactory));
+
+    if (!loadEngine("dns")) {
+        std::cerr << "[!] 警告: DNS引擎加载失败" << std::endl;
+    } else {
+        std::cout << "[+] DNS引擎加载成功" << std::endl;
+    }
 }
 
 void EngineManager::buildCommandRouting() {
@@ -3,6 +3,7 @@
 #include "session_manager.h"
 #include "command_parser.h"
 #include "database.h"
+#include <QJsonArray>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -260,6 +261,8 @@ bool TerminalInterface::processCommand(const std::string& input) {
     context.outputCallback = [this](const std::string& msg) { printInfo(msg); };
     context.errorCallback = [this](const std::string& msg) { printError(msg); };
     
+    attachScanBaseline(context);
+    
     auto result = m_engineManager->executeCommand(command, context);
     
     if (!result.success) {
@@ -271,9 +274,107 @@ bool TerminalInterface::processCommand(const std::string& input) {
         printSuccess(result.message);
     }
     
+    persistScanResult(context, result);
+    
     return true;
 }
 
+void TerminalInterface::attachScanBaseline(CommandContext& context) {
+    // -diff-against 对比同一命令的历史结果，-from-scan 以端口扫描结果作为输入
+    std::string reference;
+    std::string sourceCommand;
+    if (context.parameters.count("baseline")) {
+        return;
+    } else if (context.parameters.count("diff-against")) {
+        reference = context.parameters.at("diff-against");
+        sourceCommand = context.command;
+    } else if (context.parameters.count("from-scan")) {
+        reference = context.parameters.at("from-scan");
+        sourceCommand = "scan";
+    } else {
+        return;
+    }
+    
+    // latest或结果编号从结果库读取，其余取值 (结果文件) 由引擎直接处理
+    bool byId = !reference.empty() && std::all_of(reference.begin(), reference.end(), ::isdigit);
+    if (reference != "latest" && !byId) {
+        return;
+    }
+    
+    auto& database = MindSploit::Core::Database::instance();
+    if (database.isNoDatabaseMode() || !database.isConnected()) {
+        printWarning("数据库不可用，无法读取历史扫描结果");
+        return;
+    }
+    
+    QString project = database.getCurrentProject().isEmpty() ? "default" : database.getCurrentProject();
+    auto rows = database.getScanResults(project, QString::fromStdString(context.target),
+                                        QString::fromStdString(sourceCommand));
+    
+    // 结果按时间倒序排列
+    for (const auto& row : rows) {
+        if (byId && std::to_string(row["id"].toInt()) != reference) {
+            continue;
+        }
+        
+        std::string lines;
+        for (const auto& record : row.value("result").toObject().value("results").toArray()) {
+            lines += QJsonDocument(record.toObject()).toJson(QJsonDocument::Compact).toStdString() + "\n";
+        }
+        context.parameters["baseline"] = lines;
+        context.parameters["baseline-id"] = std::to_string(row["id"].toInt());
+        printInfo((sourceCommand == context.command ? "对比历史结果 #" : "使用扫描结果 #") +
+                  std::to_string(row["id"].toInt()) + " (" + row["timestamp"].toString().toStdString() + ")");
+        return;
+    }
+}
+
+void TerminalInterface::persistScanResult(const CommandContext& context, const ExecutionResult& result) {
+    auto recordsIt = result.data.find("results");
+    if (recordsIt == result.data.end()) {
+        return;
+    }
+    
+    // 单个分片只覆盖部分空间，不能作为后续增量重扫的基线
+    auto shardIt = result.data.find("shard");
+    if (shardIt != result.data.end() && shardIt->second != "0/1") {
+        return;
+    }
+    
+    auto& database = MindSploit::Core::Database::instance();
+    if (database.isNoDatabaseMode() || !database.isConnected()) {
+        return;
+    }
+    
+    QJsonArray records;
+    std::istringstream stream(recordsIt->second);
+    std::string line;
+    while (std::getline(stream, line)) {
+        auto doc = QJsonDocument::fromJson(QByteArray::fromStdString(line));
+        if (doc.isObject()) {
+            records.append(doc.object());
+        }
+    }
+    
+    QJsonObject summary;
+    for (const auto& [key, value] : result.data) {
+        if (key != "results") {
+            summary[QString::fromStdString(key)] = QString::fromStdString(value);
+        }
+    }
+    auto portsIt = context.parameters.find("ports");
+    if (portsIt != context.parameters.end()) {
+        summary["ports"] = QString::fromStdString(portsIt->second);
+    }
+    summary["results"] = records;
+    
+    QString project = database.getCurrentProject().isEmpty() ? "default" : database.getCurrentProject();
+    if (!database.addScanResult(QString::fromStdString(context.target), QString::fromStdString(context.command),
+                                summary, project)) {
+        printWarning("扫描结果保存失败");
+    }
+}
+
 bool TerminalInterface::executeBuiltinCommand(const std::string& command, const std::vector<std::string>& args) {
     // === 系统控制命令 ===
     if (command == "help") return cmdHelp(args);
@@ -6,6 +6,11 @@
 #include <iostream>
 #include <sstream>
 
+namespace MindSploit {
+struct CommandContext;
+struct ExecutionResult;
+}
+
 namespace MindSploit::Core {
 
 class EngineManager;
@@ -113,6 +118,10 @@ private:
     bool cmdAlias(const std::vector<std::string>& args);
     bool cmdUnalias(const std::vector<std::string>& args);
     
+    // 扫描结果库
+    void attachScanBaseline(CommandContext& context);
+    void persistScanResult(const CommandContext& context, const ExecutionResult& result);
+    
     // 工具方法
     std::vector<std::string> parseInput(const std::string& input);
     std::string formatTable(const std::vector<std::vector<std::string>>& data,
@@ -0,0 +1,530 @@
+#include "dns_client.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+namespace MindSploit::Dns {
+
+namespace {
+
+constexpr size_t RECEIVE_BUFFER = 4096;
+constexpr int SOCKET_BUFFER = 4 * 1024 * 1024;
+
+// 健康分: 成功率的指数移动平均
+constexpr double SCORE_WEIGHT = 0.05;
+constexpr double SUSPEND_SCORE = 0.3;          // 低于此分数暂停使用
+constexpr double RESUME_SCORE = 0.5;           // 暂停结束后的分数
+constexpr uint64_t MIN_SAMPLES = 20;           // 发送数不足时不暂停
+constexpr auto SUSPEND_TIME = std::chrono::seconds(5);
+
+std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(start, end - start + 1);
+}
+
+} // namespace
+
+std::string DnsServer::toString() const {
+    if (address.isIPv6) {
+        return "[" + address.address + "]:" + std::to_string(port);
+    }
+    return address.address + ":" + std::to_string(port);
+}
+
+bool parseDnsServers(const std::string& list, std::vector<DnsServer>& servers, std::string& error) {
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = trim(item);
+        if (item.empty()) {
+            continue;
+        }
+
+        std::string host = item;
+        std::string port;
+        if (item[0] == '[') {
+            size_t close = item.find(']');
+            if (close == std::string::npos) {
+                error = "Invalid resolver: " + item;
+                return false;
+            }
+            host = item.substr(1, close - 1);
+            if (close + 1 < item.size()) {
+                if (item[close + 1] != ':') {
+                    error = "Invalid resolver: " + item;
+                    return false;
+                }
+                port = item.substr(close + 2);
+            }
+        } else if (std::count(item.begin(), item.end(), ':') == 1) {
+            size_t colon = item.find(':');
+            host = item.substr(0, colon);
+            port = item.substr(colon + 1);
+        }
+
+        DnsServer server;
+        server.address = Utils::IPAddress(host);
+        if (!Utils::NetworkUtils::isValidIP(host)) {
+            error = "Invalid resolver address: " + host;
+            return false;
+        }
+        if (!port.empty()) {
+            try {
+                int value = std::stoi(port);
+                if (!Utils::NetworkUtils::isValidPort(value)) {
+                    throw std::out_of_range(port);
+                }
+                server.port = static_cast<uint16_t>(value);
+            } catch (const std::exception&) {
+                error = "Invalid resolver port: " + item;
+                return false;
+            }
+        }
+        servers.push_back(server);
+    }
+    return true;
+}
+
+std::vector<DnsServer> systemDnsServers() {
+    std::vector<DnsServer> servers;
+#ifndef _WIN32
+    std::ifstream file("/etc/resolv.conf");
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string keyword;
+        std::string address;
+        if (fields >> keyword >> address && keyword == "nameserver") {
+            // 去掉IPv6的区域标识 (fe80::1%eth0)
+            address = address.substr(0, address.find('%'));
+            if (Utils::NetworkUtils::isValidIP(address)) {
+                DnsServer server;
+                server.address = Utils::IPAddress(address);
+                servers.push_back(server);
+            }
+        }
+    }
+#endif
+    return servers;
+}
+
+DnsClient::DnsClient(Utils::EventLoop& loop, const DnsClientConfig& config)
+    : m_loop(loop)
+    , m_config(config)
+    , m_random(std::random_device{}()) {
+    if (m_config.socketsPerServer == 0) {
+        m_config.socketsPerServer = 1;
+    }
+    if (m_config.maxInflight == 0) {
+        m_config.maxInflight = 1;
+    }
+}
+
+DnsClient::~DnsClient() {
+    if (m_sendTimer != 0) {
+        m_loop.cancelTimer(m_sendTimer);
+    }
+    if (m_sweepTimer != 0) {
+        m_loop.cancelTimer(m_sweepTimer);
+    }
+    for (const auto& channel : m_channels) {
+        m_loop.unwatch(channel->socket.getHandle());
+    }
+}
+
+bool DnsClient::open(std::string& error) {
+    if (m_config.servers.empty()) {
+        error = "No DNS resolvers configured";
+        return false;
+    }
+
+    for (const auto& address : m_config.servers) {
+        Server server;
+        server.address = address;
+        server.health.server = address.toString();
+
+        for (size_t i = 0; i < m_config.socketsPerServer; ++i) {
+            auto channel = std::make_unique<Channel>(address.address.isIPv6 ? AF_INET6 : AF_INET);
+            // UDP的connect只设置默认对端，同时过滤其它来源的报文
+            if (!channel->socket.isValid() || !channel->socket.connect(address.address, address.port)) {
+                error = "Failed to open socket for resolver " + address.toString();
+                return false;
+            }
+            channel->socket.setNonBlocking(true);
+            int fd = channel->socket.getHandle();
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&SOCKET_BUFFER), sizeof(SOCKET_BUFFER));
+
+            size_t index = m_channels.size();
+            channel->server = m_servers.size();
+            if (!m_loop.watch(fd, Utils::EventLoop::EVENT_READ, [this, index](uint32_t) { onReadable(index); })) {
+                error = "Failed to watch resolver socket";
+                return false;
+            }
+            server.channels.push_back(index);
+            m_channels.push_back(std::move(channel));
+        }
+        m_servers.push_back(std::move(server));
+    }
+
+    m_refilled = Clock::now();
+    m_tokens = 1.0;
+    return true;
+}
+
+bool DnsClient::submit(const std::string& name, uint16_t type, Callback callback) {
+    std::string normalized;
+    if (!normalizeDnsName(name, normalized) || normalized != name) {
+        return false;
+    }
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Query& query = m_slots[slot];
+    query.name = name;
+    query.type = type;
+    query.callback = std::move(callback);
+    query.submitted = Clock::now();
+    query.attempts = 0;
+    query.active = true;
+
+    ++m_stats.queries;
+    m_queue.push_back(slot);
+    pump();
+    return true;
+}
+
+void DnsClient::run(const std::atomic<bool>& stopRequested) {
+    while (outstanding() > 0 && !stopRequested) {
+        m_loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (outstanding() > 0) {
+        cancelAll("Stopped");
+    }
+}
+
+void DnsClient::cancelAll(const std::string& reason) {
+    std::vector<uint32_t> slots;
+    for (uint32_t slot = 0; slot < m_slots.size(); ++slot) {
+        if (m_slots[slot].active) {
+            slots.push_back(slot);
+        }
+    }
+    m_queue.clear();
+    m_pending.clear();
+    m_expiries.clear();
+    m_inflight = 0;
+    for (auto& server : m_servers) {
+        server.inflight = 0;
+    }
+
+    for (uint32_t slot : slots) {
+        DnsQueryResult result;
+        result.error = reason;
+        complete(slot, result);
+    }
+}
+
+std::vector<DnsServerHealth> DnsClient::getServerHealth() const {
+    std::vector<DnsServerHealth> health;
+    for (const auto& server : m_servers) {
+        health.push_back(server.health);
+    }
+    return health;
+}
+
+void DnsClient::pump() {
+    if (m_queue.empty() || m_inflight >= m_config.maxInflight) {
+        return;
+    }
+
+    // 令牌桶容量为10毫秒的发送量，空闲之后也不会突发过多
+    auto now = Clock::now();
+    const double rate = std::max<uint32_t>(1, m_config.rate);
+    const double burst = std::max(1.0, rate / 100.0);
+    double elapsed = std::chrono::duration<double>(now - m_refilled).count();
+    m_tokens = std::min(burst, m_tokens + elapsed * rate);
+    m_refilled = now;
+
+    while (!m_queue.empty() && m_inflight < m_config.maxInflight && m_tokens >= 1.0) {
+        uint32_t slot = m_queue.front();
+        if (!send(slot)) {
+            // 发送缓冲区满，稍后再试
+            scheduleSend(now + std::chrono::milliseconds(1));
+            return;
+        }
+        m_queue.pop_front();
+        m_tokens -= 1.0;
+    }
+
+    if (!m_queue.empty() && m_inflight < m_config.maxInflight) {
+        auto wait = std::chrono::duration<double>((1.0 - m_tokens) / rate);
+        scheduleSend(now + std::chrono::duration_cast<Clock::duration>(wait));
+    }
+}
+
+void DnsClient::scheduleSend(Clock::time_point when) {
+    if (m_sendTimer != 0) {
+        return;
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(when - Clock::now());
+    m_sendTimer = m_loop.addTimer(std::max(delay, std::chrono::milliseconds(1)), [this]() {
+        m_sendTimer = 0;
+        pump();
+    });
+}
+
+bool DnsClient::send(uint32_t slot) {
+    Query& query = m_slots[slot];
+    size_t serverIndex = selectServer(query);
+    Server& server = m_servers[serverIndex];
+    size_t channel = server.channels[server.nextChannel++ % server.channels.size()];
+
+    uint16_t id;
+    do {
+        id = static_cast<uint16_t>(m_random());
+    } while (m_pending.count(pendingKey(channel, id)));
+
+    // 名字在submit时已检查，编码不会失败
+    uint8_t packet[DNS_QUERY_MAX];
+    size_t length = encodeDnsQuery(id, query.name, query.type, packet, sizeof(packet));
+    if (m_channels[channel]->socket.send(packet, length) != static_cast<ssize_t>(length)) {
+        return false;
+    }
+
+    query.server = serverIndex;
+    query.channel = channel;
+    query.id = id;
+    query.sentAt = Clock::now();
+    ++query.attempts;
+    ++query.generation;
+
+    m_pending[pendingKey(channel, id)] = slot;
+    m_expiries.push_back({slot, query.generation, query.sentAt + m_config.timeout});
+    ++m_inflight;
+    ++server.inflight;
+    ++server.health.sent;
+    ++m_stats.sent;
+    m_stats.peakInflight = std::max(m_stats.peakInflight, m_inflight);
+    scheduleSweep();
+    return true;
+}
+
+size_t DnsClient::selectServer(const Query& query) {
+    auto now = Clock::now();
+    const bool retry = query.attempts > 0;
+    size_t best = m_servers.size();
+    double bestCost = 0.0;
+
+    for (size_t i = 0; i < m_servers.size(); ++i) {
+        Server& server = m_servers[i];
+        if (server.health.suspended) {
+            if (now < server.suspendedUntil) {
+                continue;
+            }
+            server.health.suspended = false;
+            server.health.score = RESUME_SCORE;
+        }
+        // 重试避开上次的服务器
+        if (retry && i == query.server && m_servers.size() > 1) {
+            continue;
+        }
+        double cost = (server.inflight + 1) * std::max(server.health.rtt, 1.0) / std::max(server.health.score, 0.01);
+        if (best == m_servers.size() || cost < bestCost) {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    if (best != m_servers.size()) {
+        return best;
+    }
+
+    // 其它服务器都暂停时取分数最高的
+    best = 0;
+    for (size_t i = 1; i < m_servers.size(); ++i) {
+        if (m_servers[i].health.score > m_servers[best].health.score) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void DnsClient::onReadable(size_t channel) {
+    uint8_t buffer[RECEIVE_BUFFER];
+    while (true) {
+        ssize_t received = m_channels[channel]->socket.receive(buffer, sizeof(buffer));
+        if (received <= 0) {
+#ifndef _WIN32
+            // 之前某次发送引起的ICMP端口不可达，对应查询由超时处理，继续读取
+            if (received < 0 && errno == ECONNREFUSED) {
+                continue;
+            }
+#endif
+            break;
+        }
+        handleResponse(channel, buffer, static_cast<size_t>(received));
+    }
+    pump();
+}
+
+void DnsClient::handleResponse(size_t channel, const uint8_t* data, size_t length) {
+    DnsResponse response;
+    if (!parseDnsResponse(data, length, response)) {
+        ++m_stats.unmatched;
+        return;
+    }
+    auto it = m_pending.find(pendingKey(channel, response.id));
+    if (it == m_pending.end()) {
+        ++m_stats.unmatched;
+        return;
+    }
+    uint32_t slot = it->second;
+    Query& query = m_slots[slot];
+    // 问题须与查询一致，ID碰撞或伪造的应答不接受
+    if (response.question != query.name || response.questionType != query.type) {
+        ++m_stats.unmatched;
+        return;
+    }
+
+    m_pending.erase(it);
+    --m_inflight;
+    Server& server = m_servers[query.server];
+    --server.inflight;
+
+    if (response.rcode != RCODE_NOERROR && response.rcode != RCODE_NXDOMAIN) {
+        recordFailure(server, false);
+        retryOrFail(slot, dnsRcodeName(response.rcode));
+        return;
+    }
+
+    auto rtt = std::chrono::duration<double, std::milli>(Clock::now() - query.sentAt).count();
+    recordSuccess(server, rtt);
+
+    DnsQueryResult result;
+    result.response = std::move(response);
+    result.server = server.health.server;
+    complete(slot, result);
+}
+
+void DnsClient::retryOrFail(uint32_t slot, const std::string& error) {
+    Query& query = m_slots[slot];
+    ++query.generation;
+    if (query.attempts <= m_config.retries) {
+        ++m_stats.retries;
+        // 重试排在新查询之前，尽快完成已开始的查询
+        m_queue.push_front(slot);
+        return;
+    }
+
+    DnsQueryResult result;
+    result.error = error;
+    result.server = m_servers[query.server].health.server;
+    complete(slot, result);
+}
+
+void DnsClient::complete(uint32_t slot, DnsQueryResult& result) {
+    Query& query = m_slots[slot];
+    result.name = std::move(query.name);
+    result.type = query.type;
+    result.attempts = query.attempts;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - query.submitted);
+    Callback callback = std::move(query.callback);
+    release(slot);
+
+    ++m_stats.completed;
+    if (!result.ok()) {
+        ++m_stats.failures;
+    }
+    // 回调中可能submit而使m_slots扩容，此后不再引用query
+    if (callback) {
+        callback(result);
+    }
+}
+
+void DnsClient::release(uint32_t slot) {
+    Query& query = m_slots[slot];
+    query.active = false;
+    ++query.generation;
+    query.callback = nullptr;
+    query.name.clear();
+    m_freeSlots.push_back(slot);
+}
+
+void DnsClient::recordSuccess(Server& server, double rttMs) {
+    DnsServerHealth& health = server.health;
+    ++health.answered;
+    health.score = health.score * (1.0 - SCORE_WEIGHT) + SCORE_WEIGHT;
+    health.rtt = health.rtt == 0.0 ? rttMs : health.rtt * 0.875 + rttMs * 0.125;
+}
+
+void DnsClient::recordFailure(Server& server, bool timeout) {
+    DnsServerHealth& health = server.health;
+    if (timeout) {
+        ++health.timeouts;
+    } else {
+        ++health.failures;
+    }
+    health.score *= 1.0 - SCORE_WEIGHT;
+
+    if (health.suspended || health.score >= SUSPEND_SCORE || health.sent < MIN_SAMPLES) {
+        return;
+    }
+    // 至少保留一个可用的服务器
+    size_t available = std::count_if(m_servers.begin(), m_servers.end(),
+                                     [](const Server& s) { return !s.health.suspended; });
+    if (available > 1) {
+        health.suspended = true;
+        server.suspendedUntil = Clock::now() + SUSPEND_TIME;
+    }
+}
+
+void DnsClient::scheduleSweep() {
+    if (m_sweepTimer != 0 || m_expiries.empty()) {
+        return;
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(m_expiries.front().deadline - Clock::now());
+    m_sweepTimer = m_loop.addTimer(std::max(delay + std::chrono::milliseconds(1), std::chrono::milliseconds(1)),
+                                   [this]() {
+        m_sweepTimer = 0;
+        sweep();
+    });
+}
+
+void DnsClient::sweep() {
+    auto now = Clock::now();
+    while (!m_expiries.empty() && m_expiries.front().deadline <= now) {
+        Expiry expiry = m_expiries.front();
+        m_expiries.pop_front();
+
+        Query& query = m_slots[expiry.slot];
+        if (!query.active || query.generation != expiry.generation) {
+            continue;   // 已应答或已重发
+        }
+        m_pending.erase(pendingKey(query.channel, query.id));
+        --m_inflight;
+        Server& server = m_servers[query.server];
+        --server.inflight;
+        ++m_stats.timeouts;
+        recordFailure(server, true);
+        retryOrFail(expiry.slot, "Timeout");
+    }
+    pump();
+    scheduleSweep();
+}
+
+} // namespace MindSploit::Dns
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "dns_message.h"
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include <atomic>
+#include <deque>
+#include <random>
+
+namespace MindSploit::Dns {
+
+struct DnsServer {
+    Utils::IPAddress address;
+    uint16_t port = 53;
+
+    std::string toString() const;
+};
+
+// 解析 "ip[:port]" 或 "[ipv6]:port" 形式的服务器列表 (逗号分隔)
+bool parseDnsServers(const std::string& list, std::vector<DnsServer>& servers, std::string& error);
+// 系统配置的递归服务器 (/etc/resolv.conf)，读取失败时为空
+std::vector<DnsServer> systemDnsServers();
+
+struct DnsClientConfig {
+    std::vector<DnsServer> servers;
+    uint32_t rate = 20000;                          // 每秒发出的查询数 (含重试)
+    size_t maxInflight = 10000;                     // 同时等待应答的查询数
+    std::chrono::milliseconds timeout{1500};        // 单次发送的应答超时
+    int retries = 3;                                // 超时或SERVFAIL/REFUSED后换服务器重试的次数
+    size_t socketsPerServer = 4;                    // 每个服务器的UDP套接字数，分散源端口和16位ID空间
+};
+
+struct DnsQueryResult {
+    std::string name;
+    uint16_t type = 0;
+    DnsResponse response;
+    std::string server;                             // 给出应答的服务器
+    int attempts = 0;
+    std::chrono::milliseconds elapsed{0};
+    std::string error;                              // 非空表示所有尝试都失败
+
+    bool ok() const { return error.empty(); }
+};
+
+// 单个服务器的健康状态
+struct DnsServerHealth {
+    std::string server;
+    uint64_t sent = 0;
+    uint64_t answered = 0;
+    uint64_t timeouts = 0;
+    uint64_t failures = 0;                          // SERVFAIL/REFUSED/格式错误
+    double score = 1.0;                             // 成功率的指数移动平均
+    double rtt = 0.0;                               // 平滑往返时间 (毫秒)
+    bool suspended = false;
+};
+
+struct DnsClientStats {
+    uint64_t queries = 0;
+    uint64_t completed = 0;
+    uint64_t failures = 0;
+    uint64_t sent = 0;
+    uint64_t retries = 0;
+    uint64_t timeouts = 0;
+    uint64_t unmatched = 0;                         // ID或问题与任何未完成查询都不符的应答
+    size_t peakInflight = 0;
+};
+
+// 基于事件循环的异步DNS客户端
+//
+// 所有查询通过少量非阻塞UDP套接字发出 (每个服务器socketsPerServer个，已connect，只接收该服务器的应答)，
+// 以 (套接字, 随机ID) 对应未完成的查询，应答的问题名和类型须与查询一致。
+//   - 令牌桶限制总发送速率，未完成查询数达到maxInflight时排队
+//   - 每次发送选择 (未完成数+1)×平滑RTT/健康分 最小的服务器，快且可靠的服务器承担更多查询
+//   - 超时和SERVFAIL/REFUSED降低健康分，低于阈值的服务器暂停一段时间后再以较低分数恢复;
+//     重试优先换到其它服务器
+//   - 超时检查利用发送顺序即截止时间顺序，只检查队首，不扫描全部未完成查询
+// 回调在事件循环线程中执行，可以在回调里继续submit。
+class DnsClient {
+public:
+    using Callback = std::function<void(const DnsQueryResult& result)>;
+
+    DnsClient(Utils::EventLoop& loop, const DnsClientConfig& config);
+    ~DnsClient();
+
+    DnsClient(const DnsClient&) = delete;
+    DnsClient& operator=(const DnsClient&) = delete;
+
+    bool open(std::string& error);
+
+    // name须已规范化 (normalizeDnsName)，否则返回false且不调用回调
+    bool submit(const std::string& name, uint16_t type, Callback callback);
+    size_t outstanding() const { return m_queue.size() + m_inflight; }
+    size_t inflight() const { return m_inflight; }
+    // 驱动事件循环直到全部查询完成或stopRequested置位
+    void run(const std::atomic<bool>& stopRequested);
+    void cancelAll(const std::string& reason);
+
+    DnsClientStats getStats() const { return m_stats; }
+    std::vector<DnsServerHealth> getServerHealth() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Query {
+        std::string name;
+        uint16_t type = 0;
+        Callback callback;
+        Clock::time_point submitted;
+        Clock::time_point sentAt;
+        int attempts = 0;
+        size_t server = 0;
+        size_t channel = 0;
+        uint16_t id = 0;
+        uint32_t generation = 0;                    // 每次发送和释放时递增，使过期的超时项失效
+        bool active = false;
+    };
+
+    struct Channel {
+        Utils::Socket socket;
+        size_t server = 0;
+
+        Channel(int domain) : socket(domain, SOCK_DGRAM) {}
+    };
+
+    struct Server {
+        DnsServer address;
+        std::vector<size_t> channels;
+        size_t nextChannel = 0;
+        size_t inflight = 0;
+        Clock::time_point suspendedUntil;
+        DnsServerHealth health;
+    };
+
+    struct Expiry {
+        uint32_t slot;
+        uint32_t generation;
+        Clock::time_point deadline;
+    };
+
+    void pump();
+    void scheduleSend(Clock::time_point when);
+    bool send(uint32_t slot);
+    size_t selectServer(const Query& query);
+    void onReadable(size_t channel);
+    void handleResponse(size_t channel, const uint8_t* data, size_t length);
+    void retryOrFail(uint32_t slot, const std::string& error);
+    void complete(uint32_t slot, DnsQueryResult& result);
+    void release(uint32_t slot);
+    void recordSuccess(Server& server, double rttMs);
+    void recordFailure(Server& server, bool timeout);
+
+    void scheduleSweep();
+    void sweep();
+
+    static uint64_t pendingKey(size_t channel, uint16_t id) { return (static_cast<uint64_t>(channel) << 16) | id; }
+
+private:
+    Utils::EventLoop& m_loop;
+    DnsClientConfig m_config;
+    std::vector<Server> m_servers;
+    std::vector<std::unique_ptr<Channel>> m_channels;
+
+    std::vector<Query> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::deque<uint32_t> m_queue;                   // 等待发送 (新查询和重试)
+    std::unordered_map<uint64_t, uint32_t> m_pending;  // (套接字, ID) -> 槽位
+    std::deque<Expiry> m_expiries;                  // 按发送顺序，即按截止时间
+    size_t m_inflight = 0;
+
+    // 令牌桶
+    double m_tokens = 0.0;
+    Clock::time_point m_refilled;
+    Utils::EventLoop::TimerId m_sendTimer = 0;
+    Utils::EventLoop::TimerId m_sweepTimer = 0;
+
+    std::mt19937 m_random;
+    DnsClientStats m_stats;
+};
+
+} // namespace MindSploit::Dns
@@ -0,0 +1,399 @@
+#include "dns_engine.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/json_utils.h"
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+namespace MindSploit::Dns {
+
+namespace {
+
+// 系统没有配置递归服务器时使用的公共服务器
+const char* const FALLBACK_RESOLVERS = "1.1.1.1,8.8.8.8,9.9.9.9";
+
+std::string subdomainRecord(const SubdomainResult& result) {
+    std::string records;
+    for (const auto& record : result.records) {
+        records += std::string(records.empty() ? "" : ",") + "{\"name\":\"" + Utils::jsonEscape(record.name) +
+                   "\",\"type\":\"" + dnsTypeName(record.type) + "\",\"ttl\":" + std::to_string(record.ttl) +
+                   ",\"data\":\"" + Utils::jsonEscape(record.data) + "\"}";
+    }
+    return "{\"name\":\"" + Utils::jsonEscape(result.name) + "\",\"source\":\"" + result.source +
+           "\",\"records\":[" + records + "]}";
+}
+
+std::string formatRate(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+    return buffer;
+}
+
+} // namespace
+
+DnsEngine::DnsEngine() {
+    m_options["timeout"] = "1500";
+    m_options["rate"] = "20000";
+    m_options["concurrency"] = "10000";
+    m_options["retries"] = "3";
+    m_options["types"] = "A";
+    m_options["permute"] = "on";
+}
+
+DnsEngine::~DnsEngine() {
+    shutdown();
+}
+
+bool DnsEngine::initialize() {
+    if (!Utils::NetworkUtils::initialize()) {
+        return false;
+    }
+
+    m_status = EngineStatus::IDLE;
+    return true;
+}
+
+bool DnsEngine::shutdown() {
+    stop();
+    return true;
+}
+
+ExecutionResult DnsEngine::execute(const CommandContext& context) {
+    ExecutionResult result;
+
+    if (context.command == "dns-enum") {
+        result = executeSubdomainEnum(context);
+    } else {
+        result.success = false;
+        result.message = "Unsupported command: " + context.command;
+    }
+
+    return result;
+}
+
+void DnsEngine::stop() {
+    m_stopRequested = true;
+}
+
+EngineStatus DnsEngine::getStatus() const {
+    return m_status;
+}
+
+std::string DnsEngine::getDescription() const {
+    return "Asynchronous DNS enumeration engine";
+}
+
+std::vector<std::string> DnsEngine::getSupportedCommands() const {
+    return {"dns-enum"};
+}
+
+std::map<std::string, std::string> DnsEngine::getRequiredParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "dns-enum") {
+        params["target"] = "Domain or comma separated domains";
+        params["wordlist"] = "Wordlist file, one label per line";
+    }
+
+    return params;
+}
+
+std::map<std::string, std::string> DnsEngine::getOptionalParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "dns-enum") {
+        params["resolvers"] = "Recursive resolvers ip[:port],... (default: system resolvers)";
+        params["rate"] = "Queries per second across all resolvers (default: 20000)";
+        params["concurrency"] = "Maximum queries awaiting a reply (default: 10000)";
+        params["retries"] = "Retries on timeout, SERVFAIL or REFUSED (default: 3)";
+        params["types"] = "Record types to query per name (default: A)";
+        params["permute"] = "on generates variants of discovered names (default: on)";
+        params["output"] = "Write results as JSON lines to file";
+    }
+
+    params["timeout"] = "Per-attempt response timeout in milliseconds";
+
+    return params;
+}
+
+bool DnsEngine::setOption(const std::string& key, const std::string& value) {
+    m_options[key] = value;
+    return true;
+}
+
+std::string DnsEngine::getOption(const std::string& key) const {
+    auto it = m_options.find(key);
+    return (it != m_options.end()) ? it->second : "";
+}
+
+std::map<std::string, std::string> DnsEngine::getAllOptions() const {
+    return m_options;
+}
+
+bool DnsEngine::checkDependencies() const {
+    return true;
+}
+
+std::vector<std::string> DnsEngine::getMissingDependencies() const {
+    return {};
+}
+
+std::string DnsEngine::getHelp() const {
+    return R"(
+DNS Engine - DNS枚举引擎
+
+支持的命令:
+  dns-enum <domain[,domain...]> -wordlist <file> [options] - 子域名字典枚举与变体生成
+
+选项:
+  -wordlist <file>       - 字典文件，每行一个标签，映射到内存按需读取
+  -resolvers <list>      - 递归服务器 ip[:port]，逗号分隔 (默认 /etc/resolv.conf 中的服务器)
+  -rate <qps>            - 所有服务器合计的每秒查询数，含重试 (默认 20000)
+  -concurrency <num>     - 同时等待应答的查询上限 (默认 10000)
+  -timeout <ms>          - 单次查询的应答超时 (默认 1500)
+  -retries <num>         - 超时或SERVFAIL/REFUSED后换服务器重试的次数 (默认 3)
+  -types <list>          - 每个名字查询的记录类型，如 A,AAAA (默认 A)
+  -permute <on|off>      - 对字典发现的名字生成 dev-api、api2 等变体 (默认 on)
+  -output <file>         - 结果以JSON行写入文件
+
+说明:
+  开始前对每个域名查询几个随机名字检测泛解析; 泛解析域名下应答与随机名字相同
+  (同一地址集合或地址都属于随机名字的应答) 的名字被丢弃，与泛解析共用地址的真实主机也会被丢弃。
+  每个服务器按成功率和往返时间计分，查询优先发往快且可靠的服务器，
+  持续超时或拒绝的服务器暂停使用一段时间。
+
+示例:
+  dns-enum example.com -wordlist subdomains.txt
+  dns-enum example.com,example.org -wordlist subdomains.txt -resolvers 1.1.1.1,8.8.8.8,9.9.9.9 -rate 5000
+  dns-enum corp.example -wordlist words.txt -resolvers 10.0.0.53 -types A,AAAA -permute off
+)";
+}
+
+std::string DnsEngine::getCommandHelp(const std::string& command) const {
+    if (command == "dns-enum") {
+        return "dns-enum <domain> -wordlist <file> [options] - 以多个递归服务器高速查询字典和变体，过滤泛解析应答";
+    }
+
+    return "";
+}
+
+ExecutionResult DnsEngine::executeSubdomainEnum(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    auto failWith = [&](const std::string& message) {
+        result.success = false;
+        result.message = message;
+        m_status = EngineStatus::IDLE;
+        return result;
+    };
+
+    if (context.target.empty()) {
+        return failWith("Target is required for dns-enum command");
+    }
+    std::vector<std::string> domains;
+    std::stringstream targetList(context.target);
+    std::string item;
+    while (std::getline(targetList, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        item.erase(item.find_last_not_of(' ') + 1);
+        if (item.empty()) {
+            continue;
+        }
+        std::string domain;
+        if (!normalizeDnsName(item, domain)) {
+            return failWith("Invalid domain: " + item);
+        }
+        if (std::find(domains.begin(), domains.end(), domain) == domains.end()) {
+            domains.push_back(domain);
+        }
+    }
+    if (domains.empty()) {
+        return failWith("Target is required for dns-enum command");
+    }
+
+    std::string wordlistPath = parameter(context, "wordlist");
+    if (wordlistPath.empty()) {
+        return failWith("Wordlist is required for dns-enum command");
+    }
+    Utils::Wordlist wordlist;
+    std::string error;
+    if (!wordlist.open(wordlistPath, error)) {
+        return failWith(error);
+    }
+
+    DnsClientConfig clientConfig;
+    if (!buildClientConfig(context, clientConfig, error)) {
+        return failWith(error);
+    }
+
+    SubdomainConfig config;
+    config.types.clear();
+    std::stringstream typeList(parameter(context, "types"));
+    std::string typeName;
+    while (std::getline(typeList, typeName, ',')) {
+        uint16_t type;
+        if (typeName.empty()) {
+            continue;
+        }
+        if (!parseDnsType(typeName, type)) {
+            return failWith("Unknown record type: " + typeName);
+        }
+        if (std::find(config.types.begin(), config.types.end(), type) == config.types.end()) {
+            config.types.push_back(type);
+        }
+    }
+    std::string permute = parameter(context, "permute");
+    if (permute != "on" && permute != "off") {
+        return failWith("Invalid permute option: " + permute + " (expected on or off)");
+    }
+    config.permute = permute == "on";
+    // 客户端中保持两倍于在途上限的查询，排队的部分让令牌桶始终有查询可发
+    config.window = clientConfig.maxInflight * 2;
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            return failWith("Failed to open output file");
+        }
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        return failWith("Failed to create event loop");
+    }
+    DnsClient client(loop, clientConfig);
+    if (!client.open(error)) {
+        return failWith(error);
+    }
+
+    std::string resolverNames;
+    for (const auto& server : clientConfig.servers) {
+        resolverNames += (resolverNames.empty() ? "" : ",") + server.toString();
+    }
+    notifyOutput(context, "子域名枚举 " + std::to_string(domains.size()) + " 个域名, 字典 " +
+                 std::to_string(wordlist.count()) + " 行, 服务器 " + resolverNames);
+
+    std::string records;
+    auto onResult = [&](const SubdomainResult& found) {
+        std::string line = "[+] " + found.name + " ";
+        for (const auto& record : found.records) {
+            line += " " + dnsTypeName(record.type) + " " + record.data;
+        }
+        if (found.source == "permutation") {
+            line += "  (变体)";
+        }
+        notifyOutput(context, line);
+
+        std::string record = subdomainRecord(found);
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+    };
+
+    SubdomainEnumerator enumerator(client, wordlist, config, onResult);
+    auto start = std::chrono::steady_clock::now();
+    enumerator.run(domains, m_stopRequested);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    SubdomainStats stats = enumerator.getStats();
+    DnsClientStats clientStats = client.getStats();
+    std::vector<std::string> wildcards = enumerator.wildcardZones();
+    for (const auto& zone : wildcards) {
+        notifyOutput(context, "[*] 泛解析: *." + zone);
+    }
+
+    std::string health;
+    for (const auto& server : client.getServerHealth()) {
+        health += std::string(health.empty() ? "" : ",") + "{\"server\":\"" + Utils::jsonEscape(server.server) +
+                  "\",\"sent\":" + std::to_string(server.sent) + ",\"answered\":" + std::to_string(server.answered) +
+                  ",\"timeouts\":" + std::to_string(server.timeouts) + ",\"failures\":" +
+                  std::to_string(server.failures) + ",\"score\":" + formatRate(server.score * 100.0) +
+                  ",\"rtt_ms\":" + formatRate(server.rtt) + ",\"suspended\":" +
+                  (server.suspended ? "true" : "false") + "}";
+        notifyOutput(context, "[*] 服务器 " + server.server + ": 发送 " + std::to_string(server.sent) + ", 应答 " +
+                     std::to_string(server.answered) + ", 超时 " + std::to_string(server.timeouts) + ", 失败 " +
+                     std::to_string(server.failures) + ", 分数 " + formatRate(server.score * 100.0) +
+                     ", RTT " + formatRate(server.rtt) + "ms" + (server.suspended ? " (暂停)" : ""));
+    }
+
+    double seconds = std::max<double>(static_cast<double>(elapsed.count()), 1.0) / 1000.0;
+    double qps = clientStats.sent / seconds;
+
+    result.success = true;
+    result.message = "子域名枚举完成，" + std::to_string(stats.resolved) + " 个子域名, " +
+                     std::to_string(stats.candidates) + " 个候选, " + formatRate(qps) + " 查询/秒";
+    if (stats.wildcardFiltered > 0) {
+        result.message += ", 过滤泛解析 " + std::to_string(stats.wildcardFiltered) + " 个";
+    }
+    if (m_stopRequested) {
+        result.message += " (已中止)";
+    }
+    result.data["found"] = std::to_string(stats.resolved);
+    result.data["candidates"] = std::to_string(stats.candidates);
+    result.data["permutations"] = std::to_string(stats.permutations);
+    result.data["wildcard_zones"] = std::to_string(wildcards.size());
+    result.data["wildcard_filtered"] = std::to_string(stats.wildcardFiltered);
+    result.data["nxdomain"] = std::to_string(stats.nxdomain);
+    result.data["failures"] = std::to_string(stats.failures);
+    result.data["queries"] = std::to_string(clientStats.sent);
+    result.data["retries"] = std::to_string(clientStats.retries);
+    result.data["timeouts"] = std::to_string(clientStats.timeouts);
+    result.data["unmatched"] = std::to_string(clientStats.unmatched);
+    result.data["peak_inflight"] = std::to_string(clientStats.peakInflight);
+    result.data["qps"] = formatRate(qps);
+    result.data["resolvers"] = "[" + health + "]";
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+bool DnsEngine::buildClientConfig(const CommandContext& context, DnsClientConfig& config, std::string& error) const {
+    std::string resolvers = parameter(context, "resolvers");
+    if (!resolvers.empty()) {
+        if (!parseDnsServers(resolvers, config.servers, error)) {
+            return false;
+        }
+    } else {
+        config.servers = systemDnsServers();
+        if (config.servers.empty() && !parseDnsServers(FALLBACK_RESOLVERS, config.servers, error)) {
+            return false;
+        }
+    }
+    if (config.servers.empty()) {
+        error = "No DNS resolvers configured";
+        return false;
+    }
+
+    try {
+        config.rate = static_cast<uint32_t>(std::stoul(parameter(context, "rate")));
+        config.maxInflight = std::stoul(parameter(context, "concurrency"));
+        config.timeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.retries = std::stoi(parameter(context, "retries"));
+    } catch (const std::exception&) {
+        error = "Invalid numeric option";
+        return false;
+    }
+    if (config.rate == 0 || config.maxInflight == 0 || config.timeout.count() <= 0 || config.retries < 0) {
+        error = "rate, concurrency and timeout must be positive";
+        return false;
+    }
+    return true;
+}
+
+std::string DnsEngine::parameter(const CommandContext& context, const std::string& key) const {
+    auto it = context.parameters.find(key);
+    if (it != context.parameters.end()) {
+        return it->second;
+    }
+    return getOption(key);
+}
+
+} // namespace MindSploit::Dns
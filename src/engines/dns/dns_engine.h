@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../engine_interface.h"
+#include "subdomain_enum.h"
+#include <vector>
+#include <atomic>
+
+namespace MindSploit::Dns {
+
+// DNS引擎: 通过异步DNS客户端以多个递归服务器高速查询，枚举子域名
+class DnsEngine : public EngineInterface {
+public:
+    static constexpr const char* ENGINE_NAME = "DnsEngine";
+
+    DnsEngine();
+    virtual ~DnsEngine();
+
+    // 基础接口实现
+    bool initialize() override;
+    bool shutdown() override;
+    ExecutionResult execute(const CommandContext& context) override;
+    void stop() override;
+
+    EngineStatus getStatus() const override;
+    std::string getName() const override { return "DnsEngine"; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override;
+
+    std::vector<std::string> getSupportedCommands() const override;
+    std::map<std::string, std::string> getRequiredParameters(const std::string& command) const override;
+    std::map<std::string, std::string> getOptionalParameters(const std::string& command) const override;
+
+    bool setOption(const std::string& key, const std::string& value) override;
+    std::string getOption(const std::string& key) const override;
+    std::map<std::string, std::string> getAllOptions() const override;
+
+    bool checkDependencies() const override;
+    std::vector<std::string> getMissingDependencies() const override;
+
+    std::string getHelp() const override;
+    std::string getCommandHelp(const std::string& command) const override;
+
+private:
+    ExecutionResult executeSubdomainEnum(const CommandContext& context);
+
+    // 客户端配置: -resolvers、-rate、-concurrency、-timeout、-retries
+    bool buildClientConfig(const CommandContext& context, DnsClientConfig& config, std::string& error) const;
+    std::string parameter(const CommandContext& context, const std::string& key) const;
+
+private:
+    std::atomic<EngineStatus> m_status{EngineStatus::IDLE};
+    std::atomic<bool> m_stopRequested{false};
+    std::map<std::string, std::string> m_options;
+};
+
+} // namespace MindSploit::Dns
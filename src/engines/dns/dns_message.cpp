@@ -0,0 +1,293 @@
+#include "dns_message.h"
+#include "../../utils/network_utils.h"
+#include <cctype>
+#include <cstring>
+
+namespace MindSploit::Dns {
+
+namespace {
+
+constexpr size_t HEADER_SIZE = 12;
+constexpr size_t MAX_NAME = 253;
+constexpr size_t MAX_LABEL = 63;
+// 压缩指针的跳转上限，防止构造的环
+constexpr int MAX_POINTERS = 32;
+
+constexpr uint16_t FLAG_RD = 0x0100;
+constexpr uint16_t FLAG_TC = 0x0200;
+constexpr uint16_t FLAG_QR = 0x8000;
+constexpr uint16_t CLASS_IN = 1;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+bool isLabelChar(unsigned char c) {
+    // 允许下划线 (_dmarc、_domainkey等服务标签)
+    return std::isalnum(c) || c == '-' || c == '_';
+}
+
+// 从offset读取 (可能压缩的) 名字，next为名字之后的偏移
+bool readName(const uint8_t* data, size_t length, size_t offset, std::string& name, size_t& next) {
+    name.clear();
+    bool jumped = false;
+    int pointers = 0;
+    while (true) {
+        if (offset >= length) {
+            return false;
+        }
+        uint8_t size = data[offset];
+        if ((size & 0xc0) == 0xc0) {
+            if (offset + 1 >= length || ++pointers > MAX_POINTERS) {
+                return false;
+            }
+            if (!jumped) {
+                next = offset + 2;
+                jumped = true;
+            }
+            offset = ((size & 0x3f) << 8) | data[offset + 1];
+            continue;
+        }
+        if (size & 0xc0) {
+            return false;
+        }
+        if (size == 0) {
+            if (!jumped) {
+                next = offset + 1;
+            }
+            return true;
+        }
+        if (offset + 1 + size > length || name.size() + size + 1 > MAX_NAME + 1) {
+            return false;
+        }
+        if (!name.empty()) {
+            name += '.';
+        }
+        for (size_t i = 0; i < size; ++i) {
+            name += static_cast<char>(std::tolower(data[offset + 1 + i]));
+        }
+        offset += 1 + size;
+    }
+}
+
+std::string addressText(int family, const uint8_t* data) {
+    char text[INET6_ADDRSTRLEN] = {0};
+    inet_ntop(family, data, text, sizeof(text));
+    return text;
+}
+
+} // namespace
+
+std::string dnsTypeName(uint16_t type) {
+    switch (type) {
+        case TYPE_A: return "A";
+        case TYPE_NS: return "NS";
+        case TYPE_CNAME: return "CNAME";
+        case TYPE_SOA: return "SOA";
+        case TYPE_PTR: return "PTR";
+        case TYPE_MX: return "MX";
+        case TYPE_TXT: return "TXT";
+        case TYPE_AAAA: return "AAAA";
+        case TYPE_OPT: return "OPT";
+        default: return "TYPE" + std::to_string(type);
+    }
+}
+
+bool parseDnsType(const std::string& name, uint16_t& type) {
+    std::string upper;
+    for (unsigned char c : name) {
+        upper += static_cast<char>(std::toupper(c));
+    }
+    static const uint16_t types[] = {TYPE_A, TYPE_NS, TYPE_CNAME, TYPE_SOA, TYPE_PTR, TYPE_MX, TYPE_TXT, TYPE_AAAA};
+    for (uint16_t candidate : types) {
+        if (dnsTypeName(candidate) == upper) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string dnsRcodeName(uint8_t rcode) {
+    switch (rcode) {
+        case RCODE_NOERROR: return "NOERROR";
+        case RCODE_FORMERR: return "FORMERR";
+        case RCODE_SERVFAIL: return "SERVFAIL";
+        case RCODE_NXDOMAIN: return "NXDOMAIN";
+        case RCODE_NOTIMP: return "NOTIMP";
+        case RCODE_REFUSED: return "REFUSED";
+        default: return "RCODE" + std::to_string(rcode);
+    }
+}
+
+bool normalizeDnsName(std::string_view name, std::string& normalized) {
+    if (!name.empty() && name.back() == '.') {
+        name.remove_suffix(1);
+    }
+    if (name.empty() || name.size() > MAX_NAME) {
+        return false;
+    }
+    normalized.clear();
+    normalized.reserve(name.size());
+    size_t label = 0;
+    for (unsigned char c : name) {
+        if (c == '.') {
+            if (label == 0) {
+                return false;
+            }
+            label = 0;
+        } else if (!isLabelChar(c) || ++label > MAX_LABEL) {
+            return false;
+        }
+        normalized += static_cast<char>(std::tolower(c));
+    }
+    return label > 0;
+}
+
+size_t encodeDnsQuery(uint16_t id, std::string_view name, uint16_t type, uint8_t* buffer, size_t size) {
+    // 首部 + 名字 (各标签长度字节 + 根) + 类型/类 + OPT记录
+    const size_t length = HEADER_SIZE + name.size() + 2 + 4 + 11;
+    if (name.empty() || name.size() > MAX_NAME || length > size) {
+        return 0;
+    }
+
+    uint8_t* p = buffer;
+    writeU16(p, id);
+    writeU16(p + 2, FLAG_RD);
+    writeU16(p + 4, 1);         // QDCOUNT
+    writeU16(p + 6, 0);
+    writeU16(p + 8, 0);
+    writeU16(p + 10, 1);        // ARCOUNT: OPT
+    p += HEADER_SIZE;
+
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t dot = name.find('.', start);
+        if (dot == std::string_view::npos) {
+            dot = name.size();
+        }
+        size_t labelLength = dot - start;
+        if (labelLength == 0 || labelLength > MAX_LABEL) {
+            return 0;
+        }
+        *p++ = static_cast<uint8_t>(labelLength);
+        std::memcpy(p, name.data() + start, labelLength);
+        p += labelLength;
+        start = dot + 1;
+    }
+    *p++ = 0;
+    writeU16(p, type);
+    writeU16(p + 2, CLASS_IN);
+    p += 4;
+
+    // OPT: 根名字、类型41、类为UDP载荷大小、扩展RCODE/版本/标志为0、无选项
+    *p++ = 0;
+    writeU16(p, TYPE_OPT);
+    writeU16(p + 2, DNS_UDP_PAYLOAD);
+    std::memset(p + 4, 0, 6);
+    p += 10;
+    return static_cast<size_t>(p - buffer);
+}
+
+bool parseDnsResponse(const uint8_t* data, size_t length, DnsResponse& response) {
+    if (length < HEADER_SIZE) {
+        return false;
+    }
+    uint16_t flags = readU16(data + 2);
+    if (!(flags & FLAG_QR)) {
+        return false;
+    }
+    response.id = readU16(data);
+    response.rcode = static_cast<uint8_t>(flags & 0x0f);
+    response.truncated = (flags & FLAG_TC) != 0;
+    response.question.clear();
+    response.questionType = 0;
+    response.answers.clear();
+
+    uint16_t questions = readU16(data + 4);
+    uint16_t answers = readU16(data + 6);
+    size_t offset = HEADER_SIZE;
+    for (uint16_t i = 0; i < questions; ++i) {
+        std::string name;
+        if (!readName(data, length, offset, name, offset) || offset + 4 > length) {
+            return false;
+        }
+        if (i == 0) {
+            response.question = std::move(name);
+            response.questionType = readU16(data + offset);
+        }
+        offset += 4;
+    }
+
+    for (uint16_t i = 0; i < answers; ++i) {
+        DnsRecord record;
+        if (!readName(data, length, offset, record.name, offset) || offset + 10 > length) {
+            return false;
+        }
+        record.type = readU16(data + offset);
+        record.ttl = readU32(data + offset + 4);
+        uint16_t rdLength = readU16(data + offset + 8);
+        offset += 10;
+        if (offset + rdLength > length) {
+            return false;
+        }
+        const uint8_t* rdata = data + offset;
+
+        size_t unused;
+        switch (record.type) {
+            case TYPE_A:
+                if (rdLength == 4) {
+                    record.data = addressText(AF_INET, rdata);
+                }
+                break;
+            case TYPE_AAAA:
+                if (rdLength == 16) {
+                    record.data = addressText(AF_INET6, rdata);
+                }
+                break;
+            case TYPE_CNAME:
+            case TYPE_NS:
+            case TYPE_PTR:
+                if (!readName(data, length, offset, record.data, unused)) {
+                    return false;
+                }
+                break;
+            case TYPE_MX:
+                if (rdLength > 2) {
+                    std::string exchange;
+                    if (!readName(data, length, offset + 2, exchange, unused)) {
+                        return false;
+                    }
+                    record.data = std::to_string(readU16(rdata)) + " " + exchange;
+                }
+                break;
+            case TYPE_TXT:
+                for (size_t position = 0; position < rdLength;) {
+                    size_t size = rdata[position];
+                    if (position + 1 + size > rdLength) {
+                        return false;
+                    }
+                    record.data.append(reinterpret_cast<const char*>(rdata) + position + 1, size);
+                    position += 1 + size;
+                }
+                break;
+            default:
+                break;
+        }
+        offset += rdLength;
+        response.answers.push_back(std::move(record));
+    }
+    return true;
+}
+
+} // namespace MindSploit::Dns
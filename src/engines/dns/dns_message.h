@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MindSploit::Dns {
+
+// 资源记录类型
+enum DnsType : uint16_t {
+    TYPE_A = 1,
+    TYPE_NS = 2,
+    TYPE_CNAME = 5,
+    TYPE_SOA = 6,
+    TYPE_PTR = 12,
+    TYPE_MX = 15,
+    TYPE_TXT = 16,
+    TYPE_AAAA = 28,
+    TYPE_OPT = 41
+};
+
+// 应答码
+enum DnsRcode : uint8_t {
+    RCODE_NOERROR = 0,
+    RCODE_FORMERR = 1,
+    RCODE_SERVFAIL = 2,
+    RCODE_NXDOMAIN = 3,
+    RCODE_NOTIMP = 4,
+    RCODE_REFUSED = 5
+};
+
+std::string dnsTypeName(uint16_t type);
+bool parseDnsType(const std::string& name, uint16_t& type);
+std::string dnsRcodeName(uint8_t rcode);
+
+struct DnsRecord {
+    std::string name;
+    uint16_t type = 0;
+    uint32_t ttl = 0;
+    std::string data;       // A/AAAA为地址文本，CNAME/NS/PTR为域名，MX为 "优先级 域名"，TXT为文本，其它类型为空
+};
+
+struct DnsResponse {
+    uint16_t id = 0;
+    uint8_t rcode = 0;
+    bool truncated = false;
+    std::string question;   // 小写，不带末尾的点
+    uint16_t questionType = 0;
+    std::vector<DnsRecord> answers;
+};
+
+// 查询报文的最大长度 (首部 + 253字节的名字 + 问题尾部 + OPT记录)
+constexpr size_t DNS_QUERY_MAX = 12 + 255 + 4 + 11;
+// EDNS0通告的UDP载荷大小，不超过常见路径MTU，避免分片
+constexpr uint16_t DNS_UDP_PAYLOAD = 1232;
+
+// 规范化域名: 转小写、去掉末尾的点，检查标签长度和字符，非法时返回false
+bool normalizeDnsName(std::string_view name, std::string& normalized);
+
+// 编码一个带EDNS0 OPT记录的递归查询，名字须已规范化; 返回报文长度，buffer不足时返回0
+size_t encodeDnsQuery(uint16_t id, std::string_view name, uint16_t type, uint8_t* buffer, size_t size);
+
+// 解析应答，支持名字压缩; 格式错误返回false
+bool parseDnsResponse(const uint8_t* data, size_t length, DnsResponse& response);
+
+} // namespace MindSploit::Dns
@@ -0,0 +1,328 @@
+#include "subdomain_enum.h"
+#include <algorithm>
+#include <random>
+#include <cctype>
+
+namespace MindSploit::Dns {
+
+namespace {
+
+// 常见的环境/用途词，与发现的标签组合
+const std::vector<std::string>& defaultPermutationWords() {
+    static const std::vector<std::string> words = {
+        "dev", "test", "stage", "staging", "prod", "qa", "uat", "api", "admin",
+        "internal", "int", "old", "new", "beta", "v1", "v2", "backup", "demo"
+    };
+    return words;
+}
+
+uint64_t mix64(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+uint64_t hashString(const std::string& text) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// 参与泛解析比较的记录: 地址和CNAME目标
+bool isComparable(const DnsRecord& record) {
+    return !record.data.empty() &&
+           (record.type == TYPE_A || record.type == TYPE_AAAA || record.type == TYPE_CNAME);
+}
+
+// 标签中最后一段数字加减一 (dev01 → dev00/dev02)，保持位数
+void numberVariants(const std::string& label, std::vector<std::string>& variants) {
+    size_t end = label.find_last_of("0123456789");
+    if (end == std::string::npos) {
+        variants.push_back(label + "1");
+        variants.push_back(label + "2");
+        return;
+    }
+    size_t start = end;
+    while (start > 0 && std::isdigit(static_cast<unsigned char>(label[start - 1]))) {
+        --start;
+    }
+    std::string digits = label.substr(start, end - start + 1);
+    if (digits.size() > 9) {
+        return;
+    }
+    long value = std::stol(digits);
+    for (long next : {value - 1, value + 1}) {
+        if (next < 0) {
+            continue;
+        }
+        std::string text = std::to_string(next);
+        if (text.size() < digits.size()) {
+            text.insert(0, digits.size() - text.size(), '0');
+        }
+        variants.push_back(label.substr(0, start) + text + label.substr(end + 1));
+    }
+}
+
+} // namespace
+
+SubdomainEnumerator::SubdomainEnumerator(DnsClient& client, const Utils::Wordlist& wordlist,
+                                         const SubdomainConfig& config, ResultHandler onResult)
+    : m_client(client)
+    , m_wordlist(wordlist)
+    , m_config(config)
+    , m_onResult(std::move(onResult))
+    , m_randomState(config.seed != 0 ? config.seed
+                                     : (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()) {
+    if (m_config.types.empty()) {
+        m_config.types.push_back(TYPE_A);
+    }
+    if (m_config.window == 0) {
+        m_config.window = 1;
+    }
+    if (m_config.permutationWords.empty()) {
+        m_config.permutationWords = defaultPermutationWords();
+    }
+}
+
+void SubdomainEnumerator::run(const std::vector<std::string>& domains, const std::atomic<bool>& stopRequested) {
+    m_stopRequested = &stopRequested;
+    m_zones = domains;
+    m_wildcards.assign(m_zones.size(), Wildcard());
+    if (m_zones.empty()) {
+        return;
+    }
+
+    detectWildcards();
+
+    pump();
+    m_client.run(stopRequested);
+}
+
+std::vector<std::string> SubdomainEnumerator::wildcardZones() const {
+    std::vector<std::string> zones;
+    for (size_t i = 0; i < m_zones.size(); ++i) {
+        if (m_wildcards[i].detected) {
+            zones.push_back(m_zones[i]);
+        }
+    }
+    return zones;
+}
+
+void SubdomainEnumerator::detectWildcards() {
+    for (size_t zone = 0; zone < m_zones.size(); ++zone) {
+        for (size_t i = 0; i < m_config.wildcardProbes; ++i) {
+            std::string name = randomLabel() + "." + m_zones[zone];
+            if (name.size() > 253) {
+                break;
+            }
+            for (uint16_t type : m_config.types) {
+                m_client.submit(name, type, [this, zone](const DnsQueryResult& result) {
+                    if (!result.ok() || result.response.rcode != RCODE_NOERROR) {
+                        return;
+                    }
+                    std::vector<DnsRecord> records;
+                    for (const auto& record : result.response.answers) {
+                        if (isComparable(record)) {
+                            records.push_back(record);
+                        }
+                    }
+                    if (records.empty()) {
+                        return;
+                    }
+                    Wildcard& wildcard = m_wildcards[zone];
+                    wildcard.detected = true;
+                    wildcard.signatures.insert(answerSignature(records));
+                    for (const auto& record : records) {
+                        wildcard.answers.insert(record.data);
+                    }
+                });
+            }
+        }
+    }
+    m_client.run(*m_stopRequested);
+}
+
+void SubdomainEnumerator::pump() {
+    while (!*m_stopRequested && m_client.outstanding() + m_config.types.size() <= m_config.window) {
+        std::string name;
+        size_t zone;
+        bool permutation = false;
+        if (!m_permutationQueue.empty()) {
+            name = std::move(m_permutationQueue.front().first);
+            zone = m_permutationQueue.front().second;
+            m_permutationQueue.pop_front();
+            permutation = true;
+        } else if (!nextWordCandidate(name, zone)) {
+            return;
+        }
+        submitCandidate(name, zone, permutation);
+    }
+}
+
+bool SubdomainEnumerator::nextWordCandidate(std::string& name, size_t& zone) {
+    while (true) {
+        if (m_zoneIndex == 0 && !m_wordlist.next(m_offset, m_word)) {
+            return false;
+        }
+        zone = m_zoneIndex;
+        m_zoneIndex = (m_zoneIndex + 1) % m_zones.size();
+
+        std::string candidate;
+        candidate.reserve(m_word.size() + 1 + m_zones[zone].size());
+        candidate.append(m_word).append(".").append(m_zones[zone]);
+        if (!normalizeDnsName(candidate, name)) {
+            ++m_stats.invalid;
+            continue;
+        }
+        if (!m_seen.insert(name)) {
+            ++m_stats.duplicates;
+            continue;
+        }
+        return true;
+    }
+}
+
+void SubdomainEnumerator::submitCandidate(const std::string& name, size_t zone, bool permutation) {
+    auto inserted = m_candidates.emplace(name, Candidate());
+    if (!inserted.second) {
+        ++m_stats.duplicates;
+        return;
+    }
+    Candidate& candidate = inserted.first->second;
+    candidate.zone = zone;
+    candidate.permutation = permutation;
+    candidate.remaining = m_config.types.size();
+    ++m_stats.candidates;
+
+    for (uint16_t type : m_config.types) {
+        m_client.submit(name, type, [this](const DnsQueryResult& result) { onAnswer(result); });
+    }
+}
+
+void SubdomainEnumerator::onAnswer(const DnsQueryResult& result) {
+    auto it = m_candidates.find(result.name);
+    if (it == m_candidates.end()) {
+        return;
+    }
+    Candidate& candidate = it->second;
+    if (!result.ok()) {
+        candidate.failed = true;
+    } else if (result.response.rcode == RCODE_NOERROR) {
+        candidate.exists = true;
+        candidate.records.insert(candidate.records.end(), result.response.answers.begin(),
+                                 result.response.answers.end());
+    }
+
+    if (--candidate.remaining == 0) {
+        finishCandidate(it->first, candidate);
+        m_candidates.erase(it);
+    }
+    pump();
+}
+
+void SubdomainEnumerator::finishCandidate(const std::string& name, Candidate& candidate) {
+    bool answered = std::any_of(candidate.records.begin(), candidate.records.end(), isComparable);
+    if (!answered) {
+        if (candidate.failed) {
+            ++m_stats.failures;
+        } else if (!candidate.exists) {
+            ++m_stats.nxdomain;
+        }
+        return;
+    }
+
+    const Wildcard& wildcard = m_wildcards[candidate.zone];
+    if (wildcard.detected && isWildcardAnswer(wildcard, candidate.records)) {
+        ++m_stats.wildcardFiltered;
+        return;
+    }
+
+    ++m_stats.resolved;
+    SubdomainResult result;
+    result.name = name;
+    result.records = std::move(candidate.records);
+    result.source = candidate.permutation ? "permutation" : "wordlist";
+    if (m_onResult) {
+        m_onResult(result);
+    }
+
+    if (m_config.permute && !candidate.permutation) {
+        addPermutations(name, candidate.zone);
+    }
+}
+
+bool SubdomainEnumerator::isWildcardAnswer(const Wildcard& wildcard, const std::vector<DnsRecord>& records) const {
+    if (wildcard.signatures.count(answerSignature(records))) {
+        return true;
+    }
+    // 轮换地址池的泛解析: 各随机名字拿到的地址不同，但都来自同一集合
+    for (const auto& record : records) {
+        if (isComparable(record) && !wildcard.answers.count(record.data)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SubdomainEnumerator::addPermutations(const std::string& name, size_t zone) {
+    const std::string& domain = m_zones[zone];
+    if (name.size() <= domain.size() + 1) {
+        return;
+    }
+    // 只变换最左边的标签，保持在同一区域
+    size_t dot = name.find('.');
+    std::string label = name.substr(0, dot);
+    std::string parent = name.substr(dot);
+
+    std::vector<std::string> variants;
+    for (const auto& word : m_config.permutationWords) {
+        if (word == label) {
+            continue;
+        }
+        variants.push_back(label + "-" + word);
+        variants.push_back(word + "-" + label);
+        variants.push_back(label + word);
+        variants.push_back(word + label);
+    }
+    numberVariants(label, variants);
+
+    for (const auto& variant : variants) {
+        std::string candidate;
+        if (!normalizeDnsName(variant + parent, candidate)) {
+            continue;
+        }
+        if (!m_seen.insert(candidate)) {
+            ++m_stats.duplicates;
+            continue;
+        }
+        ++m_stats.permutations;
+        m_permutationQueue.emplace_back(std::move(candidate), zone);
+    }
+}
+
+std::string SubdomainEnumerator::randomLabel() {
+    static const char ALPHABET[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::string label;
+    for (int i = 0; i < 16; ++i) {
+        m_randomState = mix64(m_randomState);
+        label += ALPHABET[m_randomState % (sizeof(ALPHABET) - 1)];
+    }
+    return label;
+}
+
+uint64_t SubdomainEnumerator::answerSignature(const std::vector<DnsRecord>& records) {
+    // 与顺序无关: 各记录哈希混合后相加
+    uint64_t signature = 0;
+    for (const auto& record : records) {
+        if (isComparable(record)) {
+            signature += mix64(hashString(record.data) ^ record.type);
+        }
+    }
+    return signature;
+}
+
+} // namespace MindSploit::Dns
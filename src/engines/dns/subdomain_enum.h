@@ -0,0 +1,108 @@
+#pragma once
+
+#include "dns_client.h"
+#include "../../utils/wordlist.h"
+#include "../../utils/bloom_filter.h"
+#include <unordered_set>
+
+namespace MindSploit::Dns {
+
+struct SubdomainConfig {
+    std::vector<uint16_t> types{TYPE_A};            // 每个候选名字查询的类型
+    size_t window = 20000;                          // 同时提交给客户端的查询上限 (含排队)
+    size_t wildcardProbes = 4;                      // 每个区域探测的随机名字数
+    bool permute = true;                            // 对字典发现的名字生成变体
+    std::vector<std::string> permutationWords;      // 为空时使用内置的环境/用途词
+    uint64_t seed = 0;                              // 随机名字的种子，0为随机
+};
+
+struct SubdomainResult {
+    std::string name;
+    std::vector<DnsRecord> records;                 // 各类型的应答记录
+    std::string source;                             // wordlist 或 permutation
+};
+
+struct SubdomainStats {
+    uint64_t candidates = 0;
+    uint64_t resolved = 0;
+    uint64_t wildcardFiltered = 0;                  // 应答与泛解析相同而丢弃的名字
+    uint64_t nxdomain = 0;
+    uint64_t failures = 0;                          // 所有重试都失败的查询
+    uint64_t permutations = 0;
+    uint64_t duplicates = 0;                        // 字典重复和变体重复
+    uint64_t invalid = 0;                           // 不是合法标签的字典行
+};
+
+// 子域名枚举
+//
+// 候选名字从映射到内存的字典按需生成，保持客户端中有window个查询，不预先展开全部名字:
+//   - 开始前对每个区域查询若干随机名字，有应答的区域为泛解析，记录应答集合 (地址和CNAME目标)
+//   - 泛解析区域下的候选名字，应答集合的签名等于某个随机名字的签名，或全部地址都出现在随机名字的应答中时丢弃;
+//     比较只需一次哈希和集合查找，不另外发送验证查询
+//   - 字典发现的名字生成变体 (dev → dev-test, test-dev, dev1 → dev2 等)，排在字典之前查询，变体不再生成变体
+//   - 名字经可扩展Bloom过滤器去重
+class SubdomainEnumerator {
+public:
+    using ResultHandler = std::function<void(const SubdomainResult& result)>;
+
+    SubdomainEnumerator(DnsClient& client, const Utils::Wordlist& wordlist, const SubdomainConfig& config,
+                        ResultHandler onResult);
+
+    // domains须已规范化
+    void run(const std::vector<std::string>& domains, const std::atomic<bool>& stopRequested);
+
+    // 检测到泛解析的区域
+    std::vector<std::string> wildcardZones() const;
+    SubdomainStats getStats() const { return m_stats; }
+
+private:
+    struct Wildcard {
+        bool detected = false;
+        std::unordered_set<std::string> answers;
+        std::unordered_set<uint64_t> signatures;
+    };
+
+    struct Candidate {
+        size_t remaining = 0;                       // 未完成的类型数
+        size_t zone = 0;
+        bool permutation = false;
+        bool failed = false;
+        bool exists = false;                        // 任一类型NOERROR (包括无记录)
+        std::vector<DnsRecord> records;
+    };
+
+    void detectWildcards();
+    void pump();
+    // 生成下一个字典候选，字典读完返回false
+    bool nextWordCandidate(std::string& name, size_t& zone);
+    void submitCandidate(const std::string& name, size_t zone, bool permutation);
+    void onAnswer(const DnsQueryResult& result);
+    void finishCandidate(const std::string& name, Candidate& candidate);
+    bool isWildcardAnswer(const Wildcard& wildcard, const std::vector<DnsRecord>& records) const;
+    void addPermutations(const std::string& name, size_t zone);
+    std::string randomLabel();
+
+    static uint64_t answerSignature(const std::vector<DnsRecord>& records);
+
+private:
+    DnsClient& m_client;
+    const Utils::Wordlist& m_wordlist;
+    SubdomainConfig m_config;
+    ResultHandler m_onResult;
+    const std::atomic<bool>* m_stopRequested = nullptr;
+
+    std::vector<std::string> m_zones;
+    std::vector<Wildcard> m_wildcards;
+    // 字典位置: 每个词依次与各区域组合
+    size_t m_offset = 0;
+    std::string_view m_word;
+    size_t m_zoneIndex = 0;
+
+    std::deque<std::pair<std::string, size_t>> m_permutationQueue;
+    std::unordered_map<std::string, Candidate> m_candidates;
+    Utils::ScalableBloomFilter m_seen;
+    uint64_t m_randomState;
+    SubdomainStats m_stats;
+};
+
+} // namespace MindSploit::Dns
@@ -0,0 +1,238 @@
+#include "connect_scanner.h"
+#include "../../utils/socket_budget.h"
+#include <algorithm>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+namespace MindSploit::Network {
+
+namespace {
+
+constexpr std::chrono::milliseconds SWEEP_INTERVAL{50};
+
+int lastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool connectInProgress(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EINPROGRESS;
+#endif
+}
+
+// RST和ICMP管理禁止说明主机存在; 主机/网络不可达 (含ARP无应答) 与超时一样视为沉默
+bool isAnswer(int error) {
+#ifdef _WIN32
+    return error == WSAECONNREFUSED;
+#else
+    return error == ECONNREFUSED || error == EACCES || error == EPERM;
+#endif
+}
+
+} // namespace
+
+ConnectScanner::ConnectScanner(Utils::EventLoop& loop, const ConnectScanConfig& config)
+    : m_loop(loop), m_config(config) {}
+
+ConnectScanner::~ConnectScanner() {
+    abandon();
+}
+
+void ConnectScanner::run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested) {
+    m_source = std::move(source);
+    m_onResult = std::move(onResult);
+    m_sourceDone = false;
+
+    pump();
+    auto lastSweep = Clock::now();
+    while (!stopRequested && (!m_sourceDone || !m_queue.empty() || !m_probes.empty())) {
+        m_loop.runOnce(SWEEP_INTERVAL);
+        auto now = Clock::now();
+        if (now - lastSweep >= SWEEP_INTERVAL) {
+            lastSweep = now;
+            sweep();
+        }
+        // 完成的探测释放了名额，窗口也可能已经增长
+        pump();
+    }
+    if (stopRequested) {
+        abandon();
+        m_queue.clear();
+    }
+}
+
+void ConnectScanner::pump() {
+    while (true) {
+        if (m_queue.empty()) {
+            if (m_sourceDone) {
+                return;
+            }
+            Target target;
+            if (!m_source(target.address, target.port, target.tag)) {
+                m_sourceDone = true;
+                return;
+            }
+            m_queue.push_back(std::move(target));
+        }
+
+        Target target = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (!start(target)) {
+            m_queue.push_front(std::move(target));
+            return;
+        }
+    }
+}
+
+bool ConnectScanner::start(const Target& target) {
+    auto& budget = Utils::SocketBudget::instance();
+    if (!budget.acquire(std::chrono::milliseconds(0))) {
+        return false;
+    }
+
+    int fd = budget.openProbeSocket(target.address);
+    if (fd < 0) {
+        int error = lastSocketError();
+        budget.release();
+        if (!m_probes.empty()) {
+            // fd耗尽: 等在途探测结束后再试
+            return false;
+        }
+        report(target, false, false, error, 0.0);
+        return true;
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen = Utils::NetworkUtils::toSockaddr(target.address, target.port, addr);
+    auto started = Clock::now();
+    int result = ::connect(fd, (struct sockaddr*)&addr, addrLen);
+    int error = result == 0 ? 0 : lastSocketError();
+    if (result != 0 && !connectInProgress(error)) {
+        budget.reportError(error);
+        budget.closeProbeSocket(fd);
+        budget.release();
+        if (Utils::SocketBudget::isExhaustion(error) && !m_probes.empty()) {
+            // 临时端口耗尽不代表目标状态，窗口已减半，排队重试
+            ++m_stats.retries;
+            return false;
+        }
+        report(target, false, false, error, 0.0);
+        return true;
+    }
+
+    auto probe = std::make_unique<Probe>();
+    probe->target = target;
+    probe->fd = fd;
+    probe->started = started;
+    m_probes[fd] = std::move(probe);
+    m_stats.peakInFlight = std::max(m_stats.peakInFlight, m_probes.size());
+
+    if (result == 0) {
+        budget.reportSuccess();
+        finish(fd, true, false, 0);
+        return true;
+    }
+    m_loop.watch(fd, Utils::EventLoop::EVENT_WRITE, [this, fd](uint32_t events) { onEvent(fd, events); });
+    return true;
+}
+
+void ConnectScanner::onEvent(int fd, uint32_t events) {
+    if (m_probes.find(fd) == m_probes.end()) {
+        return;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+    if (error == 0 && !(events & Utils::EventLoop::EVENT_WRITE)) {
+        return;
+    }
+    auto& budget = Utils::SocketBudget::instance();
+    if (error == 0) {
+        budget.reportSuccess();
+    } else {
+        budget.reportError(error);
+    }
+    finish(fd, error == 0, false, error);
+}
+
+void ConnectScanner::finish(int fd, bool open, bool timedOut, int errorCode) {
+    auto it = m_probes.find(fd);
+    if (it == m_probes.end()) {
+        return;
+    }
+    Target target = it->second->target;
+    double responseTime = std::chrono::duration<double, std::milli>(Clock::now() - it->second->started).count();
+
+    if (m_loop.isWatched(fd)) {
+        m_loop.unwatch(fd);
+    }
+    auto& budget = Utils::SocketBudget::instance();
+    budget.closeProbeSocket(fd);
+    budget.release();
+    m_probes.erase(it);
+
+    report(target, open, timedOut, errorCode, responseTime);
+}
+
+void ConnectScanner::report(const Target& target, bool open, bool timedOut, int errorCode, double responseTime) {
+    ++m_stats.probes;
+    if (open) {
+        ++m_stats.open;
+    } else if (timedOut) {
+        ++m_stats.timeouts;
+    } else {
+        ++m_stats.closed;
+    }
+
+    if (!m_onResult) {
+        return;
+    }
+    ConnectProbeResult result;
+    result.target = target.address;
+    result.port = target.port;
+    result.tag = target.tag;
+    result.open = open;
+    result.answered = open || isAnswer(errorCode);
+    result.errorCode = errorCode;
+    result.responseTime = responseTime;
+    m_onResult(result);
+}
+
+void ConnectScanner::sweep() {
+    auto deadline = Clock::now() - m_config.timeout;
+    std::vector<int> expired;
+    for (const auto& entry : m_probes) {
+        if (entry.second->started <= deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        // 超时说明连接已结束，按成功计入窗口
+        Utils::SocketBudget::instance().reportSuccess();
+        finish(fd, false, true, 0);
+    }
+}
+
+void ConnectScanner::abandon() {
+    auto& budget = Utils::SocketBudget::instance();
+    for (auto& entry : m_probes) {
+        int fd = entry.first;
+        if (m_loop.isWatched(fd)) {
+            m_loop.unwatch(fd);
+        }
+        budget.closeProbeSocket(fd);
+        budget.release();
+    }
+    m_probes.clear();
+}
+
+} // namespace MindSploit::Network
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "../../utils/network_utils.h"
+#include "../../utils/event_loop.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+struct ConnectScanConfig {
+    std::chrono::milliseconds timeout{3000};        // 单个连接的超时
+};
+
+struct ConnectProbeResult {
+    Utils::IPAddress target;
+    uint16_t port = 0;
+    uint64_t tag = 0;                               // 数据源给出的标记 (如排列索引)，原样返回
+    bool open = false;
+    bool answered = false;                          // 收到SYN-ACK、RST或ICMP管理禁止，主机存在
+    int errorCode = 0;
+    double responseTime = 0.0;                      // 毫秒
+};
+
+struct ConnectScanStats {
+    uint64_t probes = 0;
+    uint64_t open = 0;
+    uint64_t closed = 0;
+    uint64_t timeouts = 0;
+    uint64_t retries = 0;                           // 端口/fd耗尽后重新排队的次数
+    size_t peakInFlight = 0;
+};
+
+// 直连的并发连接扫描
+//
+// 所有非阻塞connect在一个事件循环中并发，在途数由SocketBudget的自适应窗口决定:
+// 每个探测占用一个名额，端口或fd耗尽时窗口减半，目标重新排队而不是报告为关闭。
+// 连接建立即为开放，随即以RST关闭; 拒绝和ICMP管理禁止为关闭; 超时和不可达为无应答。
+class ConnectScanner {
+public:
+    // 返回false表示目标已取完
+    using Source = std::function<bool(Utils::IPAddress& target, uint16_t& port, uint64_t& tag)>;
+    using ResultHandler = std::function<void(const ConnectProbeResult& result)>;
+
+    ConnectScanner(Utils::EventLoop& loop, const ConnectScanConfig& config);
+    ~ConnectScanner();
+
+    ConnectScanner(const ConnectScanner&) = delete;
+    ConnectScanner& operator=(const ConnectScanner&) = delete;
+
+    void run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested);
+
+    ConnectScanStats getStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Target {
+        Utils::IPAddress address;
+        uint16_t port = 0;
+        uint64_t tag = 0;
+    };
+
+    struct Probe {
+        Target target;
+        int fd = -1;
+        Clock::time_point started;
+    };
+
+    // 启动尽可能多的探测
+    void pump();
+    // 返回false表示暂时没有名额
+    bool start(const Target& target);
+    void onEvent(int fd, uint32_t events);
+    void finish(int fd, bool open, bool timedOut, int errorCode);
+    void report(const Target& target, bool open, bool timedOut, int errorCode, double responseTime);
+    void sweep();
+    // 关闭全部在途探测，不报告结果
+    void abandon();
+
+private:
+    Utils::EventLoop& m_loop;
+    ConnectScanConfig m_config;
+
+    Source m_source;
+    ResultHandler m_onResult;
+    bool m_sourceDone = false;
+    std::deque<Target> m_queue;                     // 待启动的目标，耗尽后重试的排在队首
+    std::unordered_map<int, std::unique_ptr<Probe>> m_probes;
+    ConnectScanStats m_stats;
+};
+
+} // namespace MindSploit::Network
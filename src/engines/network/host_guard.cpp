@@ -0,0 +1,137 @@
+#include "host_guard.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MindSploit::Network {
+
+std::string hostVerdictName(HostVerdict verdict) {
+    switch (verdict) {
+        case HostVerdict::ALL_OPEN: return "all-open";
+        case HostVerdict::UNIFORM_TIMING: return "uniform-timing";
+        case HostVerdict::ZERO_WINDOW: return "zero-window";
+        case HostVerdict::TIME_BUDGET: return "time-budget";
+        default: return "normal";
+    }
+}
+
+HostGuard::HostGuard(const HostGuardConfig& config)
+    : m_config(config) {
+    m_config.sampleSize = std::max<uint32_t>(1, m_config.sampleSize);
+    m_config.timingSamples = std::max<uint32_t>(2, m_config.timingSamples);
+}
+
+bool HostGuard::admit(const std::string& host) {
+    HostState& state = m_hosts[host];
+    if (state.verdict != HostVerdict::NORMAL) {
+        if (state.samplesLeft == 0) {
+            ++state.skipped;
+            ++m_skipped;
+            return false;
+        }
+        --state.samplesLeft;
+    }
+    ++state.probed;
+    return true;
+}
+
+void HostGuard::recordOpen(const std::string& host, double rtt, int window) {
+    HostState& state = m_hosts[host];
+    ++state.open;
+    if (rtt >= 0.0) {
+        ++state.rttCount;
+        state.rttSum += rtt;
+        state.rttSquares += rtt * rtt;
+    }
+    if (window == 0) {
+        ++state.zeroWindows;
+    }
+    evaluate(state);
+}
+
+void HostGuard::recordSpent(const std::string& host, double milliseconds, bool banner) {
+    HostState& state = m_hosts[host];
+    state.spentMs += std::max(0.0, milliseconds);
+    if (banner) {
+        ++state.banners;
+    }
+    evaluate(state);
+}
+
+bool HostGuard::flagged(const std::string& host) const {
+    auto it = m_hosts.find(host);
+    return it != m_hosts.end() && it->second.verdict != HostVerdict::NORMAL;
+}
+
+HostVerdict HostGuard::verdict(const std::string& host) const {
+    auto it = m_hosts.find(host);
+    return it != m_hosts.end() ? it->second.verdict : HostVerdict::NORMAL;
+}
+
+bool HostGuard::isTarpit(const std::string& host) const {
+    HostVerdict hostVerdict = verdict(host);
+    return hostVerdict != HostVerdict::NORMAL && hostVerdict != HostVerdict::TIME_BUDGET;
+}
+
+std::vector<SuspiciousHost> HostGuard::suspiciousHosts() const {
+    std::vector<SuspiciousHost> hosts;
+    for (const auto& entry : m_hosts) {
+        const HostState& state = entry.second;
+        if (state.verdict == HostVerdict::NORMAL) {
+            continue;
+        }
+        SuspiciousHost host;
+        host.host = entry.first;
+        host.verdict = state.verdict;
+        host.probed = state.probed;
+        host.open = state.open;
+        host.skipped = state.skipped;
+        host.spentMs = state.spentMs;
+        hosts.push_back(host);
+    }
+    std::sort(hosts.begin(), hosts.end(), [](const SuspiciousHost& a, const SuspiciousHost& b) {
+        return a.host < b.host;
+    });
+    return hosts;
+}
+
+void HostGuard::evaluate(HostState& state) {
+    if (state.verdict != HostVerdict::NORMAL) {
+        // 已标记的主机仍受时间上限约束，抽样也随之停止
+        if (m_config.hostBudget.count() > 0 && state.spentMs >= m_config.hostBudget.count()) {
+            state.samplesLeft = 0;
+        }
+        return;
+    }
+
+    if (state.zeroWindows >= m_config.zeroWindowPorts && m_config.zeroWindowPorts > 0) {
+        flag(state, HostVerdict::ZERO_WINDOW);
+        return;
+    }
+
+    // 在途探测按未开放计入，比例只会低估
+    double ratio = state.probed > 0 ? static_cast<double>(state.open) / state.probed : 0.0;
+    if (state.probed >= m_config.sampleSize && ratio >= m_config.openRatio) {
+        flag(state, HostVerdict::ALL_OPEN);
+        return;
+    }
+
+    if (state.rttCount >= m_config.timingSamples && state.banners == 0 && ratio >= m_config.timingOpenRatio) {
+        double mean = state.rttSum / state.rttCount;
+        double variance = std::max(0.0, state.rttSquares / state.rttCount - mean * mean);
+        if (mean > 0.0 && std::sqrt(variance) / mean < m_config.timingSpread) {
+            flag(state, HostVerdict::UNIFORM_TIMING);
+            return;
+        }
+    }
+
+    if (m_config.hostBudget.count() > 0 && state.spentMs >= m_config.hostBudget.count()) {
+        flag(state, HostVerdict::TIME_BUDGET);
+    }
+}
+
+void HostGuard::flag(HostState& state, HostVerdict verdict) {
+    state.verdict = verdict;
+    state.samplesLeft = verdict == HostVerdict::TIME_BUDGET ? 0 : m_config.flaggedSamples;
+}
+
+} // namespace MindSploit::Network
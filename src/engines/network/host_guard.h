@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MindSploit::Network {
+
+// 主机被标记的原因
+enum class HostVerdict {
+    NORMAL,
+    ALL_OPEN,           // 抽样中几乎所有端口都开放
+    UNIFORM_TIMING,     // 大量开放端口的握手时间几乎相同且没有任何横幅
+    ZERO_WINDOW,        // SYN-ACK通告零窗口 (LaBrea式tarpit)
+    TIME_BUDGET         // 在该主机已建立的连接上等待横幅的时间超过上限 (不是tarpit判定)
+};
+
+std::string hostVerdictName(HostVerdict verdict);
+
+struct HostGuardConfig {
+    uint32_t sampleSize = 64;                       // 判定全端口开放前至少发出的探测数
+    double openRatio = 0.9;                         // 开放比例达到此值视为全端口开放
+    uint32_t timingSamples = 16;                    // 判定时间均匀性所需的开放端口数
+    double timingOpenRatio = 0.5;                   // 时间均匀判定还要求的最低开放比例
+    double timingSpread = 0.05;                     // 握手时间变异系数低于此值视为均匀
+    uint32_t zeroWindowPorts = 2;                   // 零窗口SYN-ACK达到此数即标记
+    uint32_t flaggedSamples = 16;                   // 标记后仍抽样探测的端口数
+    std::chrono::milliseconds hostBudget{120000};   // 每个主机占用连接 (等待横幅) 的时间上限，0为不限
+};
+
+struct SuspiciousHost {
+    std::string host;
+    HostVerdict verdict = HostVerdict::NORMAL;
+    uint64_t probed = 0;
+    uint64_t open = 0;
+    uint64_t skipped = 0;                           // 标记后跳过的探测
+    double spentMs = 0.0;
+};
+
+// 在线识别tarpit和蜜罐主机，避免少数主机耗尽扫描预算
+//
+// 扫描按排列顺序发出探测，同一主机的端口分散在整个扫描中，先到的探测就是该主机端口的随机样本:
+//   - 样本足够后开放比例接近1: 对所有端口回复SYN-ACK的主机
+//   - 开放端口的握手时间几乎相同 (变异系数很小) 且没有一个端口给出横幅: SYN代理或伪造协议栈
+//   - SYN-ACK通告零窗口: 连接被无限期挂起
+//   - 已建立连接上累计的占用时间 (横幅等待) 超过上限; 连接超时不计入，过滤端口多的普通主机不会因此被标记
+// 被标记的主机只再抽样flaggedSamples个端口，其余探测直接跳过，也不再采集横幅; 时间超限的主机立即停止。
+// 只有前三种判定 (isTarpit) 说明开放端口不可信，时间超限的主机已发现的开放端口照常报告。
+// 不是线程安全的，由扫描循环所在的线程调用。
+class HostGuard {
+public:
+    explicit HostGuard(const HostGuardConfig& config = HostGuardConfig());
+
+    // 发出探测前调用，返回false表示跳过该探测
+    bool admit(const std::string& host);
+    // 端口开放; rtt为握手时间 (毫秒，<0未知)，window为SYN-ACK通告窗口 (<0未知)
+    void recordOpen(const std::string& host, double rtt, int window);
+    // 一个开放端口的连接结束，计入连接建立后占用的时间; banner表示收到了横幅
+    void recordSpent(const std::string& host, double milliseconds, bool banner);
+
+    bool flagged(const std::string& host) const;
+    HostVerdict verdict(const std::string& host) const;
+    // 判定为tarpit/蜜罐，开放端口不可信
+    bool isTarpit(const std::string& host) const;
+    std::vector<SuspiciousHost> suspiciousHosts() const;
+    uint64_t skipped() const { return m_skipped; }
+
+private:
+    struct HostState {
+        uint64_t probed = 0;
+        uint64_t open = 0;
+        uint64_t banners = 0;
+        uint64_t zeroWindows = 0;
+        uint64_t skipped = 0;
+        uint64_t samplesLeft = 0;
+        double spentMs = 0.0;
+        // 握手时间的累计量，用于计算变异系数
+        uint64_t rttCount = 0;
+        double rttSum = 0.0;
+        double rttSquares = 0.0;
+        HostVerdict verdict = HostVerdict::NORMAL;
+    };
+
+    void evaluate(HostState& state);
+    void flag(HostState& state, HostVerdict verdict);
+
+private:
+    HostGuardConfig m_config;
+    std::unordered_map<std::string, HostState> m_hosts;
+    uint64_t m_skipped = 0;
+};
+
+} // namespace MindSploit::Network
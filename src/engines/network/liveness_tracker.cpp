@@ -0,0 +1,201 @@
+#include "liveness_tracker.h"
+#include <algorithm>
+#include <cstring>
+
+namespace MindSploit::Network {
+
+bool parseLivenessLevel(const std::string& name, LivenessLevel& level) {
+    if (name == "off") {
+        level = LivenessLevel::OFF;
+    } else if (name == "low") {
+        level = LivenessLevel::LOW;
+    } else if (name == "medium") {
+        level = LivenessLevel::MEDIUM;
+    } else if (name == "high") {
+        level = LivenessLevel::HIGH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+LivenessConfig LivenessConfig::forLevel(LivenessLevel level) {
+    LivenessConfig config;
+    switch (level) {
+        case LivenessLevel::OFF:
+            config.hostTimeouts = 0;
+            config.subnetHosts = 0;
+            break;
+        case LivenessLevel::LOW:
+            break;
+        case LivenessLevel::MEDIUM:
+            config.hostTimeouts = 4;
+            config.subnetHosts = 8;
+            config.subnetTimeouts = 32;
+            config.skipHosts = true;
+            break;
+        case LivenessLevel::HIGH:
+            config.hostTimeouts = 2;
+            config.subnetHosts = 4;
+            config.subnetTimeouts = 8;
+            config.skipHosts = true;
+            config.skipSubnets = true;
+            break;
+    }
+    return config;
+}
+
+LivenessTracker::LivenessTracker(const LivenessConfig& config)
+    : m_config(config) {
+    m_config.subnetPrefix = std::min<uint32_t>(32, m_config.subnetPrefix);
+}
+
+ProbeDecision LivenessTracker::admit(const Utils::IPAddress& host, uint64_t index) {
+    expirePending();
+
+    // 沉寂子网中没有探测过的主机不建立状态，稀疏地址空间上内存只随抽样增长
+    SubnetState& subnetState = m_subnets[subnetKey(host)];
+    auto it = m_hosts.find(host.address);
+    HostState* known = it != m_hosts.end() ? &it->second : nullptr;
+    // 已有应答的主机不受任何沉寂判定约束
+    LivenessDecision* decision = known != nullptr && known->alive ? nullptr : decisionFor(known, &subnetState);
+
+    if (decision != nullptr) {
+        if (decision->action == ProbeDecision::SKIP) {
+            ++decision->skipped;
+            ++m_stats.skipped;
+        } else {
+            ++decision->deferred;
+            ++m_stats.deferred;
+            if (known != nullptr) {
+                known->deferred = true;
+            }
+        }
+        return decision->action;
+    }
+
+    HostState& hostState = known != nullptr ? *known : m_hosts[host.address];
+    if (!hostState.alive || hostState.deferred) {
+        hostState.probed.push_back(index);
+    }
+    return ProbeDecision::PROBE;
+}
+
+bool LivenessTracker::admitDeferred(const Utils::IPAddress& host, uint64_t index) {
+    auto subnetIt = m_subnets.find(subnetKey(host));
+    auto it = m_hosts.find(host.address);
+    HostState* known = it != m_hosts.end() ? &it->second : nullptr;
+    // 有应答的主机第一遍中没有被推迟过的位置都已探测
+    if (known != nullptr && known->alive && !known->deferred) {
+        return false;
+    }
+    LivenessDecision* decision = decisionFor(known, subnetIt != m_subnets.end() ? &subnetIt->second : nullptr);
+    if (decision == nullptr || decision->action != ProbeDecision::DEFER) {
+        return false;
+    }
+    if (known != nullptr && std::find(known->probed.begin(), known->probed.end(), index) != known->probed.end()) {
+        return false;
+    }
+    ++decision->revisited;
+    ++m_stats.revisited;
+    return true;
+}
+
+void LivenessTracker::recordAlive(const Utils::IPAddress& host) {
+    HostState& hostState = m_hosts[host.address];
+    SubnetState& subnetState = m_subnets[subnetKey(host)];
+    hostState.alive = true;
+    subnetState.alive = true;
+    // 之后不会再推迟该主机的探测，没有推迟过就不需要第二遍的去重记录
+    if (!hostState.deferred) {
+        std::vector<uint64_t>().swap(hostState.probed);
+    }
+}
+
+void LivenessTracker::recordTimeout(const Utils::IPAddress& host) {
+    HostState& hostState = m_hosts[host.address];
+    SubnetState& subnetState = m_subnets[subnetKey(host)];
+    if (hostState.timeouts++ == 0) {
+        ++subnetState.hosts;
+    }
+    ++subnetState.timeouts;
+
+    if (m_config.hostTimeouts > 0 && !hostState.alive && !hostState.decided &&
+        hostState.timeouts >= m_config.hostTimeouts) {
+        decide("host", host.address, m_config.skipHosts, hostState.timeouts, 1, hostState.decided,
+               hostState.decision);
+        ++m_stats.deadHosts;
+    }
+    if (m_config.subnetHosts > 0 && !subnetState.alive && !subnetState.decided &&
+        subnetState.hosts >= m_config.subnetHosts && subnetState.timeouts >= m_config.subnetTimeouts) {
+        decide("subnet", subnetKey(host), m_config.skipSubnets, subnetState.timeouts, subnetState.hosts,
+               subnetState.decided, subnetState.decision);
+        ++m_stats.deadSubnets;
+    }
+}
+
+void LivenessTracker::recordPending(const Utils::IPAddress& host) {
+    m_pending.emplace_back(Clock::now(), host);
+}
+
+std::vector<LivenessDecision> LivenessTracker::decisions() const {
+    return m_decisions;
+}
+
+LivenessStats LivenessTracker::getStats() const {
+    return m_stats;
+}
+
+std::string LivenessTracker::subnetKey(const Utils::IPAddress& host) const {
+    char text[INET6_ADDRSTRLEN] = {0};
+    if (host.isIPv6) {
+        uint8_t address[16] = {0};
+        inet_pton(AF_INET6, host.address.c_str(), address);
+        std::memset(address + 8, 0, 8);
+        inet_ntop(AF_INET6, address, text, sizeof(text));
+        return std::string(text) + "/64";
+    }
+    uint32_t address = 0;
+    inet_pton(AF_INET, host.address.c_str(), &address);
+    uint32_t mask = m_config.subnetPrefix == 0 ? 0 : htonl(0xffffffffu << (32 - m_config.subnetPrefix));
+    address &= mask;
+    inet_ntop(AF_INET, &address, text, sizeof(text));
+    return std::string(text) + "/" + std::to_string(m_config.subnetPrefix);
+}
+
+LivenessDecision* LivenessTracker::decisionFor(const HostState* hostState, const SubnetState* subnetState) {
+    if (hostState != nullptr && hostState->decided) {
+        return &m_decisions[hostState->decision];
+    }
+    if (subnetState != nullptr && subnetState->decided) {
+        return &m_decisions[subnetState->decision];
+    }
+    return nullptr;
+}
+
+void LivenessTracker::expirePending() {
+    auto now = Clock::now();
+    while (!m_pending.empty() && m_pending.front().first + m_config.replyWindow <= now) {
+        Utils::IPAddress host = m_pending.front().second;
+        m_pending.pop_front();
+        auto it = m_hosts.find(host.address);
+        if (it == m_hosts.end() || !it->second.alive) {
+            recordTimeout(host);
+        }
+    }
+}
+
+void LivenessTracker::decide(const std::string& scope, const std::string& target, bool skip, uint64_t timeouts,
+                             uint64_t hosts, bool& decided, size_t& decision) {
+    LivenessDecision record;
+    record.scope = scope;
+    record.target = target;
+    record.action = skip ? ProbeDecision::SKIP : ProbeDecision::DEFER;
+    record.timeouts = timeouts;
+    record.hosts = hosts;
+    decided = true;
+    decision = m_decisions.size();
+    m_decisions.push_back(record);
+}
+
+} // namespace MindSploit::Network
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../../utils/network_utils.h"
+#include <deque>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+// 存活推断的激进程度
+enum class LivenessLevel {
+    OFF,
+    LOW,            // 沉寂主机和子网推迟到扫描末尾，不丢失任何探测
+    MEDIUM,         // 沉寂主机直接放弃，沉寂子网推迟
+    HIGH            // 沉寂主机和子网都直接放弃，判定所需的样本也更少
+};
+
+bool parseLivenessLevel(const std::string& name, LivenessLevel& level);
+
+enum class ProbeDecision {
+    PROBE,
+    DEFER,          // 第一遍不探测，留到第二遍 (低优先级)
+    SKIP            // 不再探测
+};
+
+struct LivenessConfig {
+    uint32_t hostTimeouts = 8;                      // 无任何应答的超时探测达到此数即判定主机沉寂
+    uint32_t subnetHosts = 16;                      // 判定子网沉寂前至少有超时记录的主机数
+    uint32_t subnetTimeouts = 64;                   // 以及子网内的超时探测总数
+    uint32_t subnetPrefix = 24;                     // IPv4子网前缀长度 (IPv6固定按/64)
+    bool skipHosts = false;                         // 沉寂主机: true跳过，false推迟
+    bool skipSubnets = false;                       // 沉寂子网: true跳过，false推迟
+    std::chrono::milliseconds replyWindow{2000};    // 异步探测: 发出后超过此时间无应答即记为超时
+
+    static LivenessConfig forLevel(LivenessLevel level);
+};
+
+// 一次放弃/推迟决定的审计记录
+struct LivenessDecision {
+    std::string scope;                              // host 或 subnet
+    std::string target;                             // 主机地址或子网CIDR
+    ProbeDecision action = ProbeDecision::DEFER;
+    uint64_t timeouts = 0;                          // 作出决定时的证据: 超时探测数
+    uint64_t hosts = 0;                             // 子网: 有超时记录的主机数
+    uint64_t skipped = 0;                           // 因此跳过的探测
+    uint64_t deferred = 0;                          // 因此推迟的探测
+    uint64_t revisited = 0;                         // 推迟后在第二遍中执行的探测
+};
+
+struct LivenessStats {
+    uint64_t deadHosts = 0;
+    uint64_t deadSubnets = 0;
+    uint64_t skipped = 0;
+    uint64_t deferred = 0;
+    uint64_t revisited = 0;
+};
+
+// 主机/子网存活推断，决定探测的先后和取舍
+//
+// 探测按排列顺序分散到各主机，每个主机最先发出的几个探测就是它端口的随机样本:
+//   - 主机的前hostTimeouts个探测全部超时，且没有收到任何RST或ICMP: 主机沉寂
+//   - 子网中已有subnetHosts个主机、共subnetTimeouts个探测超时，且子网内没有任何应答: 子网沉寂
+// 沉寂的主机或子网按配置推迟或跳过。推迟的探测在第一遍结束后按同一排列再遍历一遍执行
+// (admitDeferred)，第一遍已探测过的不会重复。决定不会撤销，但之后有应答的主机不再受决定约束:
+// 它余下的端口照常探测，此前被推迟的端口在第二遍补上 (已跳过的不再补)。
+// 每个决定都记录证据和受影响的探测数，供审计。
+// 同步探测 (连接扫描、ping) 直接调用recordTimeout; 异步探测 (SYN扫描) 调用recordPending，
+// 超过replyWindow仍无应答的探测在之后的admit中自动记为超时。不是线程安全的。
+class LivenessTracker {
+public:
+    explicit LivenessTracker(const LivenessConfig& config);
+
+    // 第一遍: index为排列中的位置，返回PROBE时记录为已探测
+    ProbeDecision admit(const Utils::IPAddress& host, uint64_t index);
+    // 第二遍: 第一遍中被推迟、尚未探测的位置返回true
+    bool admitDeferred(const Utils::IPAddress& host, uint64_t index);
+
+    void recordAlive(const Utils::IPAddress& host);
+    void recordTimeout(const Utils::IPAddress& host);
+    void recordPending(const Utils::IPAddress& host);
+
+    bool hasDeferred() const { return m_stats.deferred > 0; }
+    std::vector<LivenessDecision> decisions() const;
+    LivenessStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct HostState {
+        uint64_t timeouts = 0;
+        bool alive = false;
+        bool decided = false;
+        bool deferred = false;                      // 是否有探测被推迟过
+        size_t decision = 0;                        // m_decisions中的下标
+        std::vector<uint64_t> probed;               // 可能需要第二遍时探测过的位置，第二遍据此去重
+    };
+
+    struct SubnetState {
+        uint64_t hosts = 0;
+        uint64_t timeouts = 0;
+        bool alive = false;
+        bool decided = false;
+        size_t decision = 0;
+    };
+
+    std::string subnetKey(const Utils::IPAddress& host) const;
+    // 适用于该主机的放弃/推迟决定，没有则返回nullptr
+    LivenessDecision* decisionFor(const HostState* hostState, const SubnetState* subnetState);
+    void expirePending();
+    void decide(const std::string& scope, const std::string& target, bool skip, uint64_t timeouts,
+                uint64_t hosts, bool& decided, size_t& decision);
+
+private:
+    LivenessConfig m_config;
+    std::unordered_map<std::string, HostState> m_hosts;
+    std::unordered_map<std::string, SubnetState> m_subnets;
+    std::vector<LivenessDecision> m_decisions;
+    std::deque<std::pair<Clock::time_point, Utils::IPAddress>> m_pending;
+    LivenessStats m_stats;
+};
+
+} // namespace MindSploit::Network
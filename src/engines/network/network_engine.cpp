@@ -1,7 +1,28 @@
 #include "network_engine.h"
 #include "../../utils/network_utils.h"
+#include "../../utils/socket_budget.h"
+#include "../../utils/target_space.h"
+#include "../../utils/json_utils.h"
+#include "../../utils/proxy_pool.h"
+#include "scan_coordinator.h"
+#include "scan_worker.h"
+#include "scan_baseline.h"
+#include "trace_prober.h"
+#include "proxy_scanner.h"
+#include "connect_scanner.h"
+#include "syn_scanner.h"
+#include "host_guard.h"
+#include "liveness_tracker.h"
+#include "../tls/tls_engine.h"
+#include "../tls/tls_fingerprint.h"
 #include <iostream>
 #include <sstream>
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <unordered_set>
 
 namespace MindSploit::Network {
 
@@ -18,16 +39,214 @@ const std::map<int, std::string> NetworkEngine::COMMON_SERVICES = {
     {5900, "vnc"}, {8080, "http-proxy"}
 };
 
+namespace {
+
+// 增量重扫验证基线时，超时的端口再探测的次数
+constexpr int DIFF_VERIFY_RETRIES = 1;
+
+// 命令行中的 \r \n \t \\ \xHH 转义
+std::string decodeEscapes(const std::string& text) {
+    std::string decoded;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            decoded += text[i];
+            continue;
+        }
+        char c = text[++i];
+        switch (c) {
+            case 'r': decoded += '\r'; break;
+            case 'n': decoded += '\n'; break;
+            case 't': decoded += '\t'; break;
+            case 'x':
+                if (i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+                    std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+                    decoded += static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16));
+                    i += 2;
+                    break;
+                }
+                decoded += "\\x";
+                break;
+            default: decoded += c; break;
+        }
+    }
+    return decoded;
+}
+
+// 端口记录的公共字段 (不含结尾的'}')，结果文件与结果库使用同一格式
+std::string portRecordFields(const std::string& ip, const PortScanResult& port) {
+    std::string record = "{\"ip\":\"" + Utils::jsonEscape(ip) + "\",\"port\":" + std::to_string(port.port) +
+                         ",\"open\":" + (port.isOpen ? "true" : "false") +
+                         ",\"service\":\"" + Utils::jsonEscape(port.service) + "\"";
+    if (!port.banner.empty()) {
+        record += ",\"banner\":\"" + Utils::jsonEscape(port.banner) + "\"";
+    }
+    if (!port.tlsFingerprint.empty()) {
+        record += ",\"tls_fp\":\"" + port.tlsFingerprint + "\"";
+    }
+    return record;
+}
+
+// 可疑主机记录 (不含结尾的'}')，没有port字段，增量重扫的基线不会把它当作端口
+std::string suspiciousRecordFields(const SuspiciousHost& host) {
+    return "{\"ip\":\"" + Utils::jsonEscape(host.host) + "\",\"suspicious\":\"" + hostVerdictName(host.verdict) +
+           "\",\"probed\":" + std::to_string(host.probed) + ",\"open\":" + std::to_string(host.open) +
+           ",\"skipped\":" + std::to_string(host.skipped) +
+           ",\"spent_ms\":" + std::to_string(static_cast<uint64_t>(host.spentMs));
+}
+
+// 存活推断的审计记录 (不含结尾的'}')
+std::string livenessRecordFields(const LivenessDecision& decision) {
+    return "{\"" + decision.scope + "\":\"" + Utils::jsonEscape(decision.target) + "\",\"liveness\":\"" +
+           (decision.action == ProbeDecision::SKIP ? "skipped" : "deferred") +
+           "\",\"timeouts\":" + std::to_string(decision.timeouts) + ",\"hosts\":" + std::to_string(decision.hosts) +
+           ",\"skipped\":" + std::to_string(decision.skipped) + ",\"deferred\":" + std::to_string(decision.deferred) +
+           ",\"revisited\":" + std::to_string(decision.revisited);
+}
+
+std::string paramOr(const CommandContext& context, const std::string& key, const std::string& fallback) {
+    auto it = context.parameters.find(key);
+    return it != context.parameters.end() ? it->second : fallback;
+}
+
+bool isNumber(const std::string& text) {
+    return !text.empty() && std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
+} // namespace
+
+// 结果文件写入器 - 每行一条JSON记录，各分片的结果文件直接拼接即可合并
+NetworkEngine::ResultWriter::ResultWriter(const CommandContext& context, const Utils::ShardSpec& shard)
+    : m_shard(shard.toString()) {
+    auto outputParam = context.parameters.find("output");
+    if (outputParam != context.parameters.end()) {
+        m_file.open(outputParam->second, std::ios::out | std::ios::trunc);
+        m_enabled = true;
+    }
+}
+
+bool NetworkEngine::ResultWriter::isOpen() const {
+    return !m_enabled || m_file.is_open();
+}
+
+void NetworkEngine::ResultWriter::writeHost(const std::string& ip) {
+    if (!m_enabled) return;
+    m_file << "{\"ip\":\"" << Utils::jsonEscape(ip) << "\",\"alive\":true,\"shard\":\"" << m_shard << "\"}\n";
+}
+
+void NetworkEngine::ResultWriter::writePort(const std::string& ip, const PortScanResult& port) {
+    if (!m_enabled) return;
+    m_file << portRecordFields(ip, port) << ",\"shard\":\"" << m_shard << "\"}\n";
+}
+
+void NetworkEngine::ResultWriter::writeLiveness(const LivenessDecision& decision) {
+    if (!m_enabled) return;
+    m_file << livenessRecordFields(decision) << ",\"shard\":\"" << m_shard << "\"}\n";
+}
+
+void NetworkEngine::ResultWriter::writeSuspicious(const SuspiciousHost& host) {
+    if (!m_enabled) return;
+    m_file << suspiciousRecordFields(host) << ",\"shard\":\"" << m_shard << "\"}\n";
+}
+
+void NetworkEngine::ResultWriter::writeChange(const std::string& ip, const PortScanResult& port,
+                                              const std::string& change) {
+    if (!m_enabled) return;
+    m_file << portRecordFields(ip, port) << ",\"change\":\"" << change << "\"}\n";
+}
+
 NetworkEngine::NetworkEngine() {
     m_options["timeout"] = "3000";
     m_options["threads"] = "50";
     m_options["stealth"] = "false";
+    m_options["liveness"] = "low";
 }
 
 NetworkEngine::~NetworkEngine() {
     shutdown();
 }
 
+// 端口扫描结果汇集
+NetworkEngine::ScanSink::ScanSink(NetworkEngine& engine, const CommandContext& context, ResultWriter& writer,
+                                  std::unique_ptr<HostGuard> guard, bool tlsFingerprint)
+    : m_engine(engine), m_context(context), m_writer(writer), m_guard(std::move(guard)),
+      m_tlsFingerprint(tlsFingerprint) {}
+
+NetworkEngine::ScanSink::~ScanSink() = default;
+
+bool NetworkEngine::ScanSink::admit(const std::string& target) {
+    return !m_guard || m_guard->admit(target);
+}
+
+bool NetworkEngine::ScanSink::flagged(const std::string& target) const {
+    return m_guard && m_guard->flagged(target);
+}
+
+void NetworkEngine::ScanSink::observe(const std::string& target, const std::function<void(HostGuard&)>& record) {
+    if (!m_guard) {
+        return;
+    }
+    bool wasFlagged = m_guard->flagged(target);
+    record(*m_guard);
+    if (wasFlagged || !m_guard->flagged(target)) {
+        return;
+    }
+    if (m_guard->isTarpit(target)) {
+        m_engine.notifyError(m_context, "疑似tarpit/蜜罐主机: " + target + "，之后只抽样探测，不再逐个报告开放端口");
+    } else {
+        m_engine.notifyError(m_context, "主机等待横幅的时间超过上限: " + target + "，跳过其余端口");
+    }
+}
+
+void NetworkEngine::ScanSink::recordOpen(const std::string& target, const PortScanResult& port) {
+    if (m_guard && m_guard->isTarpit(target)) {
+        ++m_suppressed;
+        return;
+    }
+    m_openPorts++;
+    m_engine.notifyOutput(m_context, "开放端口: " + target + ":" + std::to_string(port.port) +
+                          " (" + port.service + ")" + (port.banner.empty() ? "" : " " + port.banner));
+    if (m_tlsFingerprint) {
+        m_tlsPending.emplace_back(target, port);
+        return;
+    }
+    m_writer.writePort(target, port);
+    m_records += portRecordFields(target, port) + "}\n";
+}
+
+void NetworkEngine::ScanSink::finish(ExecutionResult& result) {
+    if (m_guard) {
+        m_engine.reportSuspicious(m_context, *m_guard, m_writer, result);
+        result.data["suppressed_ports"] = std::to_string(m_suppressed);
+    }
+    
+    if (m_tlsFingerprint) {
+        size_t tlsClusters = m_engine.fingerprintTlsPorts(m_context, m_tlsPending);
+        for (const auto& entry : m_tlsPending) {
+            m_writer.writePort(entry.first, entry.second);
+            m_records += portRecordFields(entry.first, entry.second) + "}\n";
+        }
+        result.data["tls_clusters"] = std::to_string(tlsClusters);
+    }
+    
+    result.data["open_ports"] = std::to_string(m_openPorts);
+    result.data["probed"] = std::to_string(m_probed);
+    result.data["results"] = m_records;
+}
+
+PortScanResult NetworkEngine::ScanSink::openPort(uint16_t port, const std::string& banner, double responseTime) {
+    PortScanResult scanResult;
+    scanResult.port = port;
+    scanResult.isOpen = true;
+    scanResult.banner = banner;
+    scanResult.responseTime = responseTime;
+    auto serviceIt = COMMON_SERVICES.find(port);
+    scanResult.service = (serviceIt != COMMON_SERVICES.end()) ? serviceIt->second : "unknown";
+    if (scanResult.service == "unknown" && !banner.empty()) {
+        scanResult.service = Utils::NetworkUtils::detectService(port, banner);
+    }
+    return scanResult;
+}
+
 bool NetworkEngine::initialize() {
     if (!Utils::NetworkUtils::initialize()) {
         return false;
@@ -54,6 +273,12 @@ ExecutionResult NetworkEngine::execute(const CommandContext& context) {
         result = executeService(context);
     } else if (context.command == "os") {
         result = executeOS(context);
+    } else if (context.command == "coordinator") {
+        result = executeCoordinator(context);
+    } else if (context.command == "worker") {
+        result = executeWorker(context);
+    } else if (context.command == "traceroute") {
+        result = executeTraceroute(context);
     } else {
         result.success = false;
         result.message = "Unsupported command: " + context.command;
@@ -87,25 +312,97 @@ std::string NetworkEngine::getDescription() const {
 }
 
 std::vector<std::string> NetworkEngine::getSupportedCommands() const {
-    return {"discover", "scan", "service", "os"};
+    return {"discover", "scan", "service", "os", "coordinator", "worker", "traceroute"};
 }
 
 std::map<std::string, std::string> NetworkEngine::getRequiredParameters(const std::string& command) const {
     std::map<std::string, std::string> params;
     
-    if (command == "discover" || command == "scan" || command == "service" || command == "os") {
+    if (command == "discover" || command == "scan" || command == "service" || command == "os" ||
+        command == "coordinator" || command == "traceroute") {
         params["target"] = "Target IP address or hostname";
     }
     
+    if (command == "worker") {
+        params["target"] = "Coordinator address (host:port)";
+    }
+    
     return params;
 }
 
 std::map<std::string, std::string> NetworkEngine::getOptionalParameters(const std::string& command) const {
     std::map<std::string, std::string> params;
     
+    if (command == "discover") {
+        params["shard"] = "Probe only slice i/n of the permuted target space";
+        params["seed"] = "Permutation seed (all shards must use the same seed)";
+        params["output"] = "Write alive hosts as JSON lines to file";
+        params["liveness"] = "Subnet liveness inference: off, low or medium (defer silent /24s to the end), high (skip them) (default: low)";
+    }
+    
     if (command == "scan") {
         params["ports"] = "Port range to scan (e.g., 1-1000, 80,443)";
         params["type"] = "Scan type (tcp, udp, syn)";
+        params["shard"] = "Scan only slice i/n of the permuted target x port space";
+        params["seed"] = "Permutation seed (all shards must use the same seed)";
+        params["output"] = "Write results as JSON lines to file";
+        params["sources"] = "Local source addresses to spread connects over (comma separated)";
+        params["inflight"] = "Maximum in-flight connects (default: derived from fd/port budget)";
+        params["diff-against"] = "Rescan against a previous result (latest, result id or result file)";
+        params["sample"] = "Discovery sample for diff scans, N or N% of the space (default: 10%)";
+        params["tls-fp"] = "Fingerprint open TLS ports (tls) or all open ports (all) and store the fingerprint with each port";
+        params["proxy"] = "Scan through SOCKS5/HTTP-CONNECT upstreams (socks5://[user:pass@]host:port or http://host:port, comma separated)";
+        params["proxy-concurrency"] = "Maximum concurrent tunnels per proxy (default: 64)";
+        params["banner-wait"] = "Milliseconds to wait for a banner on ports opened through a proxy or by a SYN scan, 0 disables (default: 1000)";
+        params["rate"] = "SYN scan packets per second (default: 10000)";
+        params["wait"] = "Milliseconds to wait for late SYN scan replies (default: 2000)";
+        params["probe"] = "Request sent by the SYN scan when no banner arrives, supports \\r\\n escapes (default: HTTP HEAD)";
+        params["source-ports"] = "Local port range owned by the SYN scan, must not overlap net.ipv4.ip_local_port_range (default: the ports above that range, usually 61000-65535)";
+        params["tarpit"] = "Detect tarpit/honeypot hosts (all ports open, uniform SYN-ACK timing, zero window) and only sample their ports: on or off (default: on)";
+        params["host-budget"] = "Seconds per host spent holding open connections for banners before its remaining ports are skipped; connect timeouts do not count, 0 disables (default: 120)";
+        params["liveness"] = "Abandon silent hosts and subnets: off, low (defer to the end), medium (skip hosts) or high (skip hosts and subnets) (default: low)";
+        params["dead-after"] = "Timed-out probes with no RST/ICMP before a host is considered silent (default: 8/4/2 by -liveness)";
+        params["packet-io"] = "SYN scan packet I/O: raw (raw sockets) or xdp (AF_XDP, Linux) (default: raw)";
+        params["interface"] = "AF_XDP interface (default: interface routing to the first target)";
+        params["xdp-queue"] = "AF_XDP NIC queue to bind (default: 0)";
+        params["xdp-mode"] = "XDP attach mode: auto, native or skb (default: auto)";
+    }
+    
+    if (command == "coordinator") {
+        params["ports"] = "Port range to scan (e.g., 1-1000, 80,443)";
+        params["seed"] = "Permutation seed";
+        params["output"] = "Write merged results as JSON lines to file";
+        params["listen"] = "Listen address for workers (default: 127.0.0.1:7878; other addresses require -token)";
+        params["token"] = "Shared secret workers must present";
+        params["block"] = "Permutation positions per lease (default: 4096)";
+        params["lease-timeout"] = "Seconds of silence before a worker's leases are reclaimed (default: 30)";
+    }
+    
+    if (command == "traceroute") {
+        params["method"] = "Probe type: udp, tcp (SYN) or icmp (default: udp)";
+        params["port"] = "Destination port (default: 33434 for udp, 80 for tcp)";
+        params["first-ttl"] = "First TTL to probe (default: 1)";
+        params["max-ttl"] = "Maximum TTL to probe (default: 30, at most 63)";
+        params["rate"] = "Probe packets per second (default: 10000)";
+        params["wait"] = "Milliseconds to wait for replies after each round (default: 2000)";
+        params["pilot"] = "Pilot targets used to find the shared path prefix (default: 8, 0 disables)";
+        params["shard"] = "Trace only slice i/n of the permuted targets";
+        params["seed"] = "Seed for target order and probe flow identifiers";
+        params["output"] = "Write paths and the merged router graph as JSON to file";
+    }
+    
+    if (command == "worker") {
+        params["name"] = "Worker name reported to the coordinator";
+        params["token"] = "Shared secret configured on the coordinator";
+        params["sources"] = "Local source addresses to spread connects over (comma separated)";
+        params["inflight"] = "Maximum in-flight connects (default: derived from fd/port budget)";
+        params["proxy"] = "Probe leased targets through SOCKS5/HTTP-CONNECT upstreams (comma separated)";
+        params["proxy-concurrency"] = "Maximum concurrent tunnels per proxy (default: 64)";
+        params["banner-wait"] = "Milliseconds to wait for a banner on ports opened through a proxy, 0 disables (default: 1000)";
+        params["tarpit"] = "Detect tarpit/honeypot hosts in leased ranges and only sample their ports: on or off (default: on)";
+        params["host-budget"] = "Seconds per host spent holding proxied connections for banners, 0 disables (default: 120)";
+        params["liveness"] = "Abandon silent hosts and subnets in leased ranges (direct probes only): off, low, medium or high (default: low)";
+        params["dead-after"] = "Timed-out probes with no RST/ICMP before a host is considered silent (default: 8/4/2 by -liveness)";
     }
     
     params["timeout"] = "Connection timeout in milliseconds";
@@ -152,18 +449,77 @@ Network Engine - 网络扫描和发现引擎
   scan <target> [options] - 端口扫描
   service <target>        - 服务识别
   os <target>            - 操作系统识别
+  coordinator <target>    - 分布式扫描协调节点，把目标空间分块租给工作节点
+  worker <host:port>      - 分布式扫描工作节点，连接协调节点领取租约
+  traceroute <target>     - 并行路由跟踪，合并各路径得到路由器拓扑图
 
 选项:
   -ports <range>         - 端口范围 (例如: 1-1000, 80,443)
   -type <type>           - 扫描类型 (tcp, udp, syn)
+                           syn: 原始SYN扫描，开放端口在用户态完成握手并采集横幅，不占用内核套接字
+                           原始套接字方式 (-packet-io raw) 需丢弃内核对这些连接发出的RST，
+                           端口范围与-source-ports一致 (默认通常为 61000:65535):
+                           iptables -A OUTPUT -p tcp --tcp-flags ALL RST --sport 61000:65535 -j DROP
   -timeout <ms>          - 超时时间 (毫秒)
   -threads <num>         - 线程数
+  -shard <i/n>           - 只扫描排列后目标空间的第i片 (0 <= i < n)
+  -seed <num>            - 排列种子 (各分片需一致，默认由目标派生)
+  -output <file>         - 结果以JSON行写入文件，各分片文件拼接即可合并
+  -sources <ip,ip>       - 轮转使用的本地源地址
+  -inflight <num>        - 在途连接上限 (默认按fd和临时端口预算计算)
+  -diff-against <ref>    - 增量重扫，对比历史结果 (latest、结果编号或结果文件)，
+                           输出合并后的完整状态，变化的端口带change字段，可直接作为下一次的基线;
+                           超时的基线端口重试后仍无应答时保留基线记录，记为filtered (主机有其它应答)
+                           或unreachable (主机无任何应答); 只有RST/ICMP才记为closed
+  -sample <N|N%>         - 增量重扫的抽样发现规模 (默认 10%)
+  -tls-fp <tls|all>      - 为开放端口采集主动TLS指纹并记录到结果中，按指纹聚类
+                           tls: 只采集可能是TLS的端口  all: 所有开放端口
+  -proxy <list>          - 经上游代理池扫描 (socks5://[user:pass@]host:port 或 http://host:port，逗号分隔)
+                           负载按各代理在途数均衡，故障代理自动停用并换代理重试
+  -proxy-concurrency <n> - 每个代理的并发隧道上限 (默认 64)
+  -banner-wait <ms>      - 经代理或SYN扫描发现开放端口后等待横幅的时间，0为不采集 (默认 1000)
+  -probe <text>          - SYN扫描中服务端不主动发送横幅时发送的请求，支持\r\n转义 (默认 HTTP HEAD)
+  -source-ports <a-b>    - SYN扫描使用的本地端口范围，不能与内核临时端口范围
+                           (net.ipv4.ip_local_port_range) 重叠 (默认取该范围上方，通常为 61000-65535)
+  -tarpit <on|off>       - 检测tarpit/蜜罐主机 (全端口开放、SYN-ACK时间均匀、零窗口)，
+                           被标记的主机只抽样探测，不再采集横幅和逐个报告端口 (默认 on)
+  -host-budget <sec>     - 每个主机在已建立连接上等待横幅的累计时间上限 (连接超时不计入)，
+                           超过后跳过其余端口，已发现的开放端口照常报告，0为不限 (默认 120)
+  -liveness <level>      - 存活推断: 前几个端口全部超时 (无RST/ICMP) 的主机、抽样后毫无应答的/24子网
+                           off: 关闭  low: 推迟到最后探测 (默认)  medium: 放弃主机、推迟子网
+                           high: 主机和子网都放弃; 每个决定及其证据都写入结果，可审计
+  -dead-after <num>      - 判定主机沉寂所需的超时探测数 (默认按-liveness为 8/4/2)
+  -packet-io <raw|xdp>   - SYN扫描的收发方式 (默认 raw)
+                           xdp: AF_XDP套接字，报文直接写入网卡队列的UMEM帧，应答由XDP程序在进入协议栈前
+                           重定向，无需丢弃内核RST (仅Linux 5.9+)
+  -interface <name>      - AF_XDP收发接口 (默认按到第一个目标的路由选择)
+  -xdp-queue <num>       - AF_XDP绑定的网卡队列 (默认 0)
+  -xdp-mode <mode>       - XDP挂载方式 auto、native或skb (默认 auto)
+  -listen <addr:port>    - 协调节点监听地址 (默认 127.0.0.1:7878，其它地址须同时指定-token)
+  -token <secret>        - 协调节点与工作节点的共享令牌 (明文传输，只用于可信网络)
+  -block <num>           - 每个租约包含的排列位置数 (默认 4096)
+  -lease-timeout <sec>   - 工作节点静默超过该时间即回收其租约 (默认 30)
+  -method <udp|tcp|icmp> - traceroute探测方式 (默认 udp)
+  -max-ttl <num>         - traceroute最大TTL (默认 30，不超过63)
+  -rate <pps>            - SYN扫描/traceroute每秒发送的探测包数 (默认 10000)
+  -wait <ms>             - SYN扫描/traceroute发送后等待应答的时间 (默认 2000)
+  -pilot <num>           - traceroute先导目标数，用于确定共享的路径前缀 (默认 8，0为不使用)
 
 示例:
   discover 192.168.1.0/24
   scan 192.168.1.1 -ports 1-1000
   scan 192.168.1.1 -ports 80,443,8080 -type tcp
   service 192.168.1.1
+  scan 10.0.0.0/16 -ports 80,443 -shard 0/4 -output shard0.jsonl
+  scan 10.0.0.0/24 -ports 1-1024 -diff-against latest -sample 5%
+  scan 10.0.0.0/16 -ports 443,8443 -tls-fp tls
+  scan 10.0.0.0/8 -ports 22,80 -type syn -rate 100000 -output banners.jsonl
+  scan 10.0.0.0/8 -ports 22,80 -type syn -packet-io xdp -interface eth0 -rate 1000000
+  scan 10.0.0.0/8 -ports 22,80,443 -liveness high -output sparse.jsonl
+  scan 172.16.0.0/24 -ports 22,80,445 -proxy socks5://10.0.0.5:1080,socks5://10.0.0.6:1080
+  coordinator 10.0.0.0/16 -ports 80,443 -listen 0.0.0.0:7878 -token s3cret -output merged.jsonl
+  worker 192.168.1.10:7878 -token s3cret
+  traceroute 10.0.0.0/16 -method tcp -port 443 -output topology.json
 )";
 }
 
@@ -176,6 +532,12 @@ std::string NetworkEngine::getCommandHelp(const std::string& command) const {
         return "service <target> - 服务识别，识别目标主机上运行的服务";
     } else if (command == "os") {
         return "os <target> - 操作系统识别，尝试识别目标主机的操作系统";
+    } else if (command == "coordinator") {
+        return "coordinator <target> [options] - 分布式扫描协调节点，向工作节点租出排列区间并汇总结果";
+    } else if (command == "worker") {
+        return "worker <host:port> - 分布式扫描工作节点，连接协调节点并执行租到的探测";
+    } else if (command == "traceroute") {
+        return "traceroute <target> [options] - 同时探测所有目标的所有TTL，输出每条路径和合并后的路由器图";
     }
     
     return "";
@@ -194,35 +556,94 @@ ExecutionResult NetworkEngine::executeDiscover(const CommandContext& context) {
     
     notifyOutput(context, "开始主机发现: " + context.target);
     
-    // 解析目标
-    auto targets = parseTargets(context.target);
-    if (targets.empty()) {
+    // 解析目标和分片
+    Utils::TargetSpace space;
+    Utils::ShardSpec shard;
+    uint64_t seed = 0;
+    std::string error;
+    if (!prepareTargetSpace(context, {}, space, shard, seed, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ResultWriter writer(context, shard);
+    if (!writer.isOpen()) {
         result.success = false;
-        result.message = "Invalid target format";
+        result.message = "Failed to open output file";
         m_status = EngineStatus::IDLE;
         return result;
     }
     
     std::vector<HostInfo> aliveHosts;
+    uint64_t probed = 0;
     
-    for (const auto& target : targets) {
-        if (m_stopRequested) break;
+    auto liveness = createLivenessTracker(context, std::chrono::milliseconds(0), error);
+    if (!error.empty()) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    auto probeHost = [&](const Utils::IPAddress& address) {
+        std::string target = address.toString();
+        ++probed;
         
         notifyOutput(context, "检测主机: " + target);
         
-        if (pingHost(target)) {
+        bool alive = pingHost(target);
+        if (liveness) {
+            if (alive) {
+                liveness->recordAlive(address);
+            } else {
+                liveness->recordTimeout(address);
+            }
+        }
+        if (alive) {
             HostInfo host;
             host.ip = target;
             host.isAlive = true;
             aliveHosts.push_back(host);
+            writer.writeHost(target);
             
             notifyOutput(context, "发现存活主机: " + target);
         }
+    };
+    
+    // 第一遍按排列顺序，沉寂子网的其余主机推迟或跳过; 第二遍补做推迟的主机
+    Utils::TargetPermutation permutation(space.size(), seed);
+    auto cursor = permutation.shard(shard);
+    uint64_t index;
+    while (cursor.next(index)) {
+        if (m_stopRequested) break;
+        
+        Utils::IPAddress address = space.hostAt(space.hostIndexOf(index));
+        if (liveness && liveness->admit(address, index) != ProbeDecision::PROBE) {
+            continue;
+        }
+        probeHost(address);
+    }
+    if (liveness && liveness->hasDeferred()) {
+        auto revisit = permutation.shard(shard);
+        while (!m_stopRequested && revisit.next(index)) {
+            Utils::IPAddress address = space.hostAt(space.hostIndexOf(index));
+            if (liveness->admitDeferred(address, index)) {
+                probeHost(address);
+            }
+        }
+    }
+    if (liveness) {
+        reportLiveness(context, *liveness, writer, result);
     }
     
     result.success = true;
     result.message = "发现 " + std::to_string(aliveHosts.size()) + " 个存活主机";
     result.data["alive_hosts"] = std::to_string(aliveHosts.size());
+    result.data["probed_hosts"] = std::to_string(probed);
+    result.data["shard"] = shard.toString();
+    result.data["seed"] = std::to_string(seed);
     
     m_status = EngineStatus::COMPLETED;
     return result;
@@ -257,73 +678,1562 @@ ExecutionResult NetworkEngine::executeScan(const CommandContext& context) {
         return result;
     }
     
-    notifyOutput(context, "扫描 " + std::to_string(ports.size()) + " 个端口");
+    // 解析目标和分片
+    Utils::TargetSpace space;
+    Utils::ShardSpec shard;
+    uint64_t seed = 0;
+    std::string error;
+    if (!prepareTargetSpace(context, ports, space, shard, seed, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ResultWriter writer(context, shard);
+    if (!writer.isOpen()) {
+        result.success = false;
+        result.message = "Failed to open output file";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    notifyOutput(context, "扫描 " + std::to_string(space.hostCount()) + " 个主机, " +
+                 std::to_string(ports.size()) + " 个端口");
+    
+    applySocketBudget(context);
     
-    auto scanResults = scanPorts(context.target, ports);
+    const bool tlsFingerprint = context.parameters.count("tls-fp") > 0;
+    if (!configureProxies(context, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    const bool synScan = context.parameters.count("type") && context.parameters.at("type") == "syn";
+    if (m_proxyPool && synScan) {
+        // 原始SYN包不经过代理
+        result.success = false;
+        result.message = "-type syn cannot be combined with -proxy";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (m_proxyPool && tlsFingerprint) {
+        // TLS指纹采集是直连的，经代理扫描时不能泄露直连流量
+        result.success = false;
+        result.message = "-tls-fp cannot be combined with -proxy";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
     
-    int openPorts = 0;
-    for (const auto& scanResult : scanResults) {
-        if (scanResult.isOpen) {
-            openPorts++;
-            notifyOutput(context, "开放端口: " + std::to_string(scanResult.port) + 
-                        " (" + scanResult.service + ")");
+    if (context.parameters.count("diff-against")) {
+        if (context.parameters.count("shard")) {
+            // 增量重扫验证整个基线并按排列抽样，不能只覆盖一个分片
+            result.success = false;
+            result.message = "-shard cannot be combined with -diff-against";
+            m_status = EngineStatus::IDLE;
+            return result;
         }
+        if (synScan || tlsFingerprint) {
+            // 增量重扫只用连接探测 (直连或经代理) 验证和发现
+            result.success = false;
+            result.message = std::string(synScan ? "-type syn" : "-tls-fp") + " cannot be combined with -diff-against";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+        return executeDiffScan(context, space, seed, writer);
+    }
+    
+    // tarpit/蜜罐检测: 被标记的主机只抽样探测，其开放端口不再逐个报告
+    auto guard = createHostGuard(context, error);
+    if (!error.empty()) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ScanSink sink(*this, context, writer, std::move(guard), tlsFingerprint);
+    Utils::TargetPermutation permutation(space.size(), seed);
+    bool ok;
+    if (m_proxyPool) {
+        ok = scanViaProxies(context, space, permutation, shard, sink, result);
+    } else if (synScan) {
+        ok = scanSyn(context, space, permutation, shard, sink, result);
+    } else {
+        ok = scanConnect(context, space, permutation, shard, sink, result);
+    }
+    if (!ok) {
+        result.success = false;
+        m_status = EngineStatus::IDLE;
+        return result;
     }
+    sink.finish(result);
     
     result.success = true;
-    result.message = "扫描完成，发现 " + std::to_string(openPorts) + " 个开放端口";
-    result.data["open_ports"] = std::to_string(openPorts);
+    result.message = "扫描完成，发现 " + std::to_string(sink.openPorts()) + " 个开放端口";
     result.data["total_ports"] = std::to_string(ports.size());
+    result.data["shard"] = shard.toString();
+    result.data["seed"] = std::to_string(seed);
+    
+    auto budgetStats = Utils::SocketBudget::instance().getStats();
+    result.data["fd_limit"] = std::to_string(budgetStats.fileLimit);
+    result.data["peak_inflight"] = std::to_string(budgetStats.peakInFlight);
+    result.data["addr_exhausted"] = std::to_string(budgetStats.addressExhausted);
     
     m_status = EngineStatus::COMPLETED;
     return result;
 }
 
-ExecutionResult NetworkEngine::executeService(const CommandContext& context) {
-    ExecutionResult result;
-    result.success = true;
-    result.message = "Service detection completed";
-    return result;
+bool NetworkEngine::scanViaProxies(const CommandContext& context, const Utils::TargetSpace& space,
+                                   const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                                   ScanSink& sink, ExecutionResult& result) {
+    // 经代理池: 所有探测在事件循环中并发，并发度为各代理上限之和
+    ProxyScanConfig proxyConfig;
+    try {
+        proxyConfig.timeout = std::chrono::milliseconds(std::max(1, std::stoi(paramOr(context, "timeout", "3000"))));
+        proxyConfig.bannerWait =
+            std::chrono::milliseconds(std::max(0, std::stoi(paramOr(context, "banner-wait", "1000"))));
+    } catch (const std::exception&) {
+        result.message = "Invalid numeric option";
+        return false;
+    }
+    notifyOutput(context, "经 " + std::to_string(m_proxyPool->size()) + " 个代理扫描, 并发上限 " +
+                 std::to_string(m_proxyPool->capacity()));
+    
+    Utils::EventLoop loop;
+    ProxyScanner scanner(loop, *m_proxyPool, proxyConfig);
+    auto cursor = permutation.shard(shard);
+    uint64_t index;
+    scanner.run([&](Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+        while (cursor.next(index)) {
+            target = space.hostAt(space.hostIndexOf(index));
+            if (sink.admit(target.toString())) {
+                port = static_cast<uint16_t>(space.portAt(index));
+                tag = index;
+                return true;
+            }
+        }
+        return false;
+    }, [&](const ProxyProbeResult& probe) {
+        sink.countProbe();
+        if (!probe.open) {
+            return;
+        }
+        std::string target = probe.target.toString();
+        sink.observe(target, [&](HostGuard& guard) {
+            guard.recordOpen(target, -1.0, -1);
+            guard.recordSpent(target, probe.holdTime, !probe.banner.empty());
+        });
+        sink.recordOpen(target, ScanSink::openPort(probe.port, probe.banner, probe.responseTime));
+    }, m_stopRequested);
+    
+    auto proxyStats = scanner.getStats();
+    result.data["proxy_errors"] = std::to_string(proxyStats.errors);
+    result.data["proxy_retries"] = std::to_string(proxyStats.retries);
+    result.data["banners"] = std::to_string(proxyStats.banners);
+    if (scanner.aborted()) {
+        notifyError(context, "所有代理均不可用，扫描提前结束");
+    }
+    for (const auto& stats : m_proxyPool->getStats()) {
+        notifyOutput(context, "代理 " + stats.endpoint + " [" + stats.state + "]: 隧道 " +
+                     std::to_string(stats.established) + ", 目标失败 " + std::to_string(stats.targetFailures) +
+                     ", 代理失败 " + std::to_string(stats.proxyFailures) + ", 并发峰值 " +
+                     std::to_string(stats.peakInFlight));
+    }
+    return true;
 }
 
-ExecutionResult NetworkEngine::executeOS(const CommandContext& context) {
-    ExecutionResult result;
-    result.success = true;
-    result.message = "OS detection completed";
-    return result;
+bool NetworkEngine::scanSyn(const CommandContext& context, const Utils::TargetSpace& space,
+                            const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                            ScanSink& sink, ExecutionResult& result) {
+    // 原始SYN扫描: 握手在用户态完成，横幅采集不占用fd和临时端口
+    auto param = [&](const std::string& key, const std::string& fallback) {
+        return paramOr(context, key, fallback);
+    };
+    SynScanConfig synConfig;
+    synConfig.seed = permutation.seed();
+    try {
+        synConfig.rate = static_cast<uint32_t>(std::max(1, std::stoi(param("rate", "10000"))));
+        synConfig.wait = std::chrono::milliseconds(std::max(0, std::stoi(param("wait", "2000"))));
+        synConfig.bannerWait = std::chrono::milliseconds(std::max(0, std::stoi(param("banner-wait", "1000"))));
+        std::string range = param("source-ports", "");
+        if (!range.empty()) {
+            size_t dash = range.find('-');
+            int firstPort = std::stoi(range.substr(0, dash));
+            int lastPort = dash == std::string::npos ? firstPort : std::stoi(range.substr(dash + 1));
+            if (firstPort < 1 || lastPort > 65535 || firstPort > lastPort) {
+                throw std::out_of_range(range);
+            }
+            synConfig.firstSourcePort = static_cast<uint16_t>(firstPort);
+            synConfig.lastSourcePort = static_cast<uint16_t>(lastPort);
+        }
+        synConfig.channel.queue = static_cast<uint32_t>(std::max(0, std::stoi(param("xdp-queue", "0"))));
+    } catch (const std::exception&) {
+        result.message = "Invalid numeric option";
+        return false;
+    }
+    if (context.parameters.count("probe")) {
+        synConfig.probe = decodeEscapes(param("probe", ""));
+    }
+    if (!Utils::parsePacketBackend(param("packet-io", "raw"), synConfig.channel.backend) ||
+        !Utils::parseXdpMode(param("xdp-mode", "auto"), synConfig.channel.xdpMode)) {
+        result.message = "Invalid -packet-io or -xdp-mode (raw|xdp, auto|native|skb)";
+        return false;
+    }
+    synConfig.channel.interface = param("interface", "");
+    std::string error;
+    if (!SynScanner::selectSourcePorts(synConfig, error)) {
+        result.message = error;
+        return false;
+    }
+    notifyOutput(context, "原始SYN扫描, 速率 " + std::to_string(synConfig.rate) + " pps, 本地端口 " +
+                 std::to_string(synConfig.firstSourcePort) + "-" + std::to_string(synConfig.lastSourcePort) +
+                 (synConfig.bannerWait.count() > 0 ? ", 用户态握手采集横幅" : ""));
+    
+    // SYN探测是异步的，发出后超过-wait仍无应答才记为超时
+    auto liveness = createLivenessTracker(context, synConfig.wait, error);
+    if (!error.empty()) {
+        result.message = error;
+        return false;
+    }
+    
+    SynScanner scanner(synConfig);
+    if (sink.guarding() || liveness) {
+        // 被标记主机的开放端口不再完成握手采集横幅
+        scanner.setSynAckHandler([&](const Utils::IPAddress& target, uint16_t, uint32_t rtt, uint16_t window) {
+            if (liveness) {
+                liveness->recordAlive(target);
+            }
+            std::string host = target.toString();
+            sink.observe(host, [&](HostGuard& guard) { guard.recordOpen(host, rtt, window); });
+            return !sink.flagged(host);
+        });
+    }
+    if (liveness) {
+        scanner.setClosedHandler([&](const Utils::IPAddress& target, uint16_t) { liveness->recordAlive(target); });
+    }
+    // 沉寂的主机和子网推迟或跳过，推迟的探测在第一遍之后按同一排列补做
+    auto cursor = permutation.shard(shard);
+    auto revisit = permutation.shard(shard);
+    bool secondPass = false;
+    uint64_t index;
+    bool ok = scanner.run([&](Utils::IPAddress& target, uint16_t& port) {
+        while (true) {
+            if (!(secondPass ? revisit.next(index) : cursor.next(index))) {
+                if (secondPass || !liveness || !liveness->hasDeferred()) {
+                    return false;
+                }
+                secondPass = true;
+                continue;
+            }
+            target = space.hostAt(space.hostIndexOf(index));
+            if (liveness && (secondPass ? !liveness->admitDeferred(target, index)
+                                        : liveness->admit(target, index) != ProbeDecision::PROBE)) {
+                continue;
+            }
+            if (sink.admit(target.toString())) {
+                port = static_cast<uint16_t>(space.portAt(index));
+                sink.countProbe();
+                if (liveness) {
+                    liveness->recordPending(target);
+                }
+                return true;
+            }
+        }
+    }, [&](const SynProbeResult& probe) {
+        std::string target = probe.target.toString();
+        sink.observe(target, [&](HostGuard& guard) {
+            guard.recordSpent(target, probe.responseTime, !probe.banner.empty());
+        });
+        sink.recordOpen(target, ScanSink::openPort(probe.port, probe.banner, probe.responseTime));
+    }, m_stopRequested, error);
+    if (!ok) {
+        result.message = error;
+        return false;
+    }
+    
+    auto synStats = scanner.getStats();
+    auto channelStats = scanner.channelStats();
+    notifyOutput(context, "收发通道: " + scanner.channelDescription() + ", 发送 " +
+                 std::to_string(channelStats.sent) + ", 接收 " + std::to_string(channelStats.received) +
+                 ", 丢弃 " + std::to_string(channelStats.dropped) +
+                 ", 发送失败 " + std::to_string(channelStats.sendErrors));
+    result.data["packet_io"] = scanner.channelDescription();
+    result.data["packets_dropped"] = std::to_string(channelStats.dropped);
+    result.data["send_errors"] = std::to_string(channelStats.sendErrors);
+    result.data["closed_ports"] = std::to_string(synStats.closed);
+    result.data["banners"] = std::to_string(synStats.banners);
+    result.data["probes_sent"] = std::to_string(synStats.probesSent);
+    result.data["resets"] = std::to_string(synStats.resets);
+    result.data["peak_connections"] = std::to_string(synStats.peakConnections);
+    if (liveness) {
+        reportLiveness(context, *liveness, sink.writer(), result);
+    }
+    if (synStats.unsupported > 0) {
+        notifyError(context, "跳过 " + std::to_string(synStats.unsupported) + " 个非IPv4探测点");
+    }
+    if (synStats.open > 0 && synStats.resets == synStats.open &&
+        synConfig.channel.backend == Utils::PacketBackend::RAW_SOCKET) {
+        // 所有握手都在数据到达前被复位，通常是内核对未知连接的SYN-ACK回复了RST
+        notifyError(context, "所有连接都在收到横幅前被复位，请丢弃内核发出的RST: iptables -A OUTPUT -p tcp "
+                    "--tcp-flags ALL RST --sport " + std::to_string(synConfig.firstSourcePort) + ":" +
+                    std::to_string(synConfig.lastSourcePort) + " -j DROP");
+    }
+    return true;
 }
 
-bool NetworkEngine::pingHost(const std::string& target) {
-    Utils::IPAddress ip(target);
-    auto result = Utils::NetworkUtils::pingHost(ip);
-    return result.success;
+bool NetworkEngine::scanConnect(const CommandContext& context, const Utils::TargetSpace& space,
+                                const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                                ScanSink& sink, ExecutionResult& result) {
+    // 直连扫描: 所有connect在事件循环中并发，在途数由连接预算的自适应窗口约束
+    ConnectScanConfig connectConfig;
+    try {
+        connectConfig.timeout =
+            std::chrono::milliseconds(std::max(1, std::stoi(paramOr(context, "timeout", "3000"))));
+    } catch (const std::exception&) {
+        result.message = "Invalid numeric option";
+        return false;
+    }
+    std::string error;
+    auto liveness = createLivenessTracker(context, std::chrono::milliseconds(0), error);
+    if (!error.empty()) {
+        result.message = error;
+        return false;
+    }
+    
+    // 沉寂的主机和子网推迟或跳过，推迟的探测在第一遍之后按同一排列补做
+    Utils::EventLoop loop;
+    ConnectScanner scanner(loop, connectConfig);
+    auto cursor = permutation.shard(shard);
+    auto revisit = permutation.shard(shard);
+    bool secondPass = false;
+    uint64_t index;
+    scanner.run([&](Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+        while (true) {
+            if (!(secondPass ? revisit.next(index) : cursor.next(index))) {
+                if (secondPass || !liveness || !liveness->hasDeferred()) {
+                    return false;
+                }
+                secondPass = true;
+                continue;
+            }
+            target = space.hostAt(space.hostIndexOf(index));
+            if (liveness && (secondPass ? !liveness->admitDeferred(target, index)
+                                        : liveness->admit(target, index) != ProbeDecision::PROBE)) {
+                continue;
+            }
+            if (sink.admit(target.toString())) {
+                port = static_cast<uint16_t>(space.portAt(index));
+                tag = index;
+                return true;
+            }
+        }
+    }, [&](const ConnectProbeResult& probe) {
+        sink.countProbe();
+        if (liveness) {
+            if (probe.answered) {
+                liveness->recordAlive(probe.target);
+            } else {
+                liveness->recordTimeout(probe.target);
+            }
+        }
+        if (!probe.open) {
+            return;
+        }
+        // 连接建立后立即关闭，不占用时间预算
+        std::string target = probe.target.toString();
+        sink.observe(target, [&](HostGuard& guard) { guard.recordOpen(target, probe.responseTime, -1); });
+        sink.recordOpen(target, ScanSink::openPort(probe.port, "", probe.responseTime));
+    }, m_stopRequested);
+    
+    auto connectStats = scanner.getStats();
+    result.data["closed_ports"] = std::to_string(connectStats.closed);
+    result.data["timeouts"] = std::to_string(connectStats.timeouts);
+    result.data["connect_retries"] = std::to_string(connectStats.retries);
+    if (liveness) {
+        reportLiveness(context, *liveness, sink.writer(), result);
+    }
+    return true;
 }
 
-std::vector<PortScanResult> NetworkEngine::scanPorts(const std::string& target, const std::vector<int>& ports) {
-    std::vector<PortScanResult> results;
+size_t NetworkEngine::fingerprintTlsPorts(const CommandContext& context,
+                                          std::vector<std::pair<std::string, PortScanResult>>& ports) {
+    Tls::TlsProberConfig config;
+    try {
+        auto timeoutParam = context.parameters.find("timeout");
+        config.handshakeTimeout = std::chrono::milliseconds(
+            std::stoi(timeoutParam != context.parameters.end() ? timeoutParam->second : getOption("timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.handshakeTimeout);
+    } catch (const std::exception&) {
+    }
     
-    for (int port : ports) {
-        if (m_stopRequested) break;
-        
-        PortScanResult result;
-        result.port = port;
-        result.isOpen = tcpConnect(target, port, 3000);
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        notifyError(context, "TLS指纹: 无法创建事件循环");
+        return 0;
+    }
+    Tls::TlsProber prober(loop, config);
+    Tls::TlsFingerprinter fingerprinter(prober);
+    const size_t parallelEndpoints = std::max<size_t>(1, config.maxConnections / Tls::TlsFingerprinter::VARIANT_COUNT);
+    
+    // 所有可能是TLS的开放端口并发采集，每个端点约一次往返; -tls-fp all 时不按端口和服务筛选
+    auto modeParam = context.parameters.find("tls-fp");
+    const bool allPorts = modeParam != context.parameters.end() && modeParam->second == "all";
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (allPorts || Tls::TlsEngine::isTlsService(ports[i].second.port, ports[i].second.service)) {
+            candidates.push_back(i);
+        }
+    }
+    if (candidates.empty()) {
+        return 0;
+    }
+    notifyOutput(context, "采集TLS指纹: " + std::to_string(candidates.size()) + " 个端点");
+    
+    size_t next = 0;
+    std::map<std::string, size_t> clusters;
+    std::function<void()> pump;
+    pump = [&]() {
+        while (next < candidates.size() && fingerprinter.active() < parallelEndpoints && !m_stopRequested) {
+            size_t slot = candidates[next++];
+            fingerprinter.fingerprint(Utils::IPAddress(ports[slot].first), static_cast<uint16_t>(ports[slot].second.port),
+                                      "", [&, slot](const Tls::TlsFingerprintResult& probe) {
+                if (probe.ok() && probe.responses > 0) {
+                    ports[slot].second.tlsFingerprint = probe.fingerprint;
+                    ++clusters[probe.fingerprint];
+                }
+                pump();
+            });
+        }
+    };
+    pump();
+    prober.run(m_stopRequested);
+    
+    // 相同指纹即相同的TLS实现和配置
+    std::vector<std::pair<std::string, size_t>> ranked(clusters.begin(), clusters.end());
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (const auto& cluster : ranked) {
+        notifyOutput(context, "TLS指纹 " + cluster.first + ": " + std::to_string(cluster.second) + " 个端点");
+    }
+    return clusters.size();
+}
+
+ExecutionResult NetworkEngine::executeDiffScan(const CommandContext& context, const Utils::TargetSpace& space,
+                                               uint64_t seed, ResultWriter& writer) {
+    ExecutionResult result;
+    
+    ScanBaseline baseline;
+    std::string error;
+    if (!loadBaseline(context, baseline, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    // 抽样规模: 百分比或探测点个数，默认10%
+    uint64_t sampleSize = 0;
+    auto sampleParam = context.parameters.find("sample");
+    std::string sampleText = sampleParam != context.parameters.end() ? sampleParam->second : "10%";
+    try {
+        if (!sampleText.empty() && sampleText.back() == '%') {
+            double percent = std::stod(sampleText.substr(0, sampleText.size() - 1));
+            if (percent < 0 || percent > 100) {
+                throw std::out_of_range(sampleText);
+            }
+            sampleSize = static_cast<uint64_t>(static_cast<double>(space.size()) * percent / 100.0 + 0.5);
+        } else {
+            sampleSize = std::stoull(sampleText);
+        }
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid sample size (expected N or N%): " + sampleText;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    auto liveness = createLivenessTracker(context, std::chrono::milliseconds(0), error);
+    auto guard = error.empty() ? createHostGuard(context, error) : nullptr;
+    if (!error.empty()) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    notifyOutput(context, "增量扫描: 基线 " + std::to_string(baseline.size()) + " 个开放端口, 抽样 " +
+                 std::to_string(sampleSize) + " 个探测点");
+    
+    std::unordered_set<std::string> probed;     // ip|port
+    std::set<std::string> changedHosts;
+    std::set<std::string> unreachableHosts;
+    std::string records;                        // 本次扫描后的完整已知状态
+    size_t verified = 0, newOpen = 0, newlyClosed = 0, bannerChanged = 0, unanswered = 0, suppressed = 0;
+    uint64_t sampled = 0;
+    
+    auto probeKey = [](const std::string& ip, int port) { return ip + "|" + std::to_string(port); };
+    
+    // 第一轮: 验证基线中落在本次范围内的开放端口; 超时的重试，仍无应答的不判定为关闭
+    std::vector<const BaselineEntry*> entries;
+    for (const auto& entry : baseline.entries()) {
+        if (space.containsPort(entry.port) && space.containsHost(Utils::IPAddress(entry.ip))) {
+            entries.push_back(&entry);
+        }
+    }
+    std::vector<PortScanResult> outcomes(entries.size());
+    std::vector<bool> done(entries.size(), false);
+    std::vector<size_t> queue(entries.size());
+    for (size_t i = 0; i < queue.size(); ++i) {
+        queue[i] = i;
+    }
+    for (int attempt = 0; attempt <= DIFF_VERIFY_RETRIES && !queue.empty() && !m_stopRequested; ++attempt) {
+        std::vector<size_t> retry;
+        size_t next = 0;
+        // 基线端口不计入tarpit检测: 已知开放的端口会让正常主机看起来全端口开放
+        bool ok = probeConcurrently(context, [&](Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+            if (next >= queue.size()) {
+                return false;
+            }
+            tag = queue[next++];
+            target = Utils::IPAddress(entries[tag]->ip);
+            port = static_cast<uint16_t>(entries[tag]->port);
+            return true;
+        }, liveness.get(), nullptr, [&](uint64_t tag, const Utils::IPAddress&, PortScanResult& port) {
+            done[tag] = true;
+            outcomes[tag] = port;
+            if (!port.answered) {
+                retry.push_back(tag);
+            }
+        }, error);
+        if (!ok) {
+            result.success = false;
+            result.message = error;
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+        std::sort(retry.begin(), retry.end());
+        queue = std::move(retry);
+    }
+    
+    // 有任何端口应答的主机在线，其余端口无应答只说明被过滤
+    std::unordered_set<std::string> answeredHosts;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (done[i] && outcomes[i].answered) {
+            answeredHosts.insert(entries[i]->ip);
+        }
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const BaselineEntry& entry = *entries[i];
+        if (!done[i]) {
+            // 因中止未验证，原样保留
+            continue;
+        }
+        probed.insert(probeKey(entry.ip, entry.port));
+        ++verified;
         
-        if (result.isOpen) {
-            auto serviceIt = COMMON_SERVICES.find(port);
-            result.service = (serviceIt != COMMON_SERVICES.end()) ? serviceIt->second : "unknown";
+        PortScanResult& port = outcomes[i];
+        if (!port.isOpen && !port.answered) {
+            // 超时不说明端口关闭: 保留基线记录 (下一次重扫仍会验证)，标记为过滤或主机不可达
+            ++unanswered;
+            bool hostAnswered = answeredHosts.count(entry.ip) > 0;
+            port.isOpen = true;
+            port.service = entry.service;
+            port.banner = entry.banner;
+            writer.writeChange(entry.ip, port, hostAnswered ? "filtered" : "unreachable");
+            if (hostAnswered) {
+                notifyOutput(context, "[?] 端口无应答: " + entry.ip + ":" + std::to_string(entry.port) + " (保留基线记录)");
+            } else {
+                unreachableHosts.insert(entry.ip);
+            }
+            records += portRecordFields(entry.ip, port) + "}\n";
+            continue;
+        }
+        if (!port.isOpen) {
+            ++newlyClosed;
+            changedHosts.insert(entry.ip);
+            port.service = entry.service;
+            port.banner = entry.banner;
+            writer.writeChange(entry.ip, port, "closed");
+            notifyOutput(context, "[-] 端口已关闭: " + entry.ip + ":" + std::to_string(entry.port));
+            continue;
         }
         
-        results.push_back(result);
+        if (!entry.banner.empty() && !port.banner.empty() && port.banner != entry.banner) {
+            ++bannerChanged;
+            changedHosts.insert(entry.ip);
+            writer.writeChange(entry.ip, port, "banner");
+            notifyOutput(context, "[~] 横幅变化: " + entry.ip + ":" + std::to_string(entry.port) +
+                         " \"" + entry.banner + "\" -> \"" + port.banner + "\"");
+        } else {
+            if (port.banner.empty()) {
+                port.banner = entry.banner;
+            }
+            if (port.service == "unknown") {
+                port.service = entry.service;
+            }
+            writer.writePort(entry.ip, port);
+        }
+        records += portRecordFields(entry.ip, port) + "}\n";
+    }
+    for (const auto& ip : unreachableHosts) {
+        notifyOutput(context, "[?] 主机无应答: " + ip + " (保留基线记录)");
+    }
+    
+    auto recordNew = [&](uint64_t, const Utils::IPAddress& target, PortScanResult& port) {
+        if (!port.isOpen) {
+            return;
+        }
+        std::string ip = target.toString();
+        if (guard && guard->isTarpit(ip)) {
+            ++suppressed;
+            return;
+        }
+        ++newOpen;
+        records += portRecordFields(ip, port) + "}\n";
+        writer.writeChange(ip, port, "new");
+        notifyOutput(context, "[+] 新开放端口: " + ip + ":" + std::to_string(port.port) + " (" + port.service + ")");
+    };
+    
+    // 第二轮: 状态发生变化的主机重新探测全部端口
+    auto changedHost = changedHosts.begin();
+    size_t portSlot = 0;
+    const auto& ports = space.ports();
+    bool ok = probeConcurrently(context, [&](Utils::IPAddress& target, uint16_t& port, uint64_t&) {
+        for (; changedHost != changedHosts.end(); ++changedHost, portSlot = 0) {
+            while (portSlot < ports.size()) {
+                int candidate = ports[portSlot++];
+                if (probed.insert(probeKey(*changedHost, candidate)).second &&
+                    (!guard || guard->admit(*changedHost))) {
+                    target = Utils::IPAddress(*changedHost);
+                    port = static_cast<uint16_t>(candidate);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }, liveness.get(), guard.get(), recordNew, error);
+    
+    // 第三轮: 按排列抽样发现，起点随基线轮转，多次重扫逐步覆盖整个空间; 沉寂主机和tarpit不占抽样名额
+    Utils::TargetPermutation permutation(space.size(), seed);
+    uint64_t cycle = permutation.cycleLength();
+    auto baselineId = context.parameters.find("baseline-id");
+    std::string rotationKey = context.parameters.at("diff-against") + "|" +
+        (baselineId != context.parameters.end() ? baselineId->second : std::to_string(baseline.size()));
+    uint64_t offset = cycle > 0 ? Utils::TargetPermutation::deriveSeed(rotationKey) % cycle : 0;
+    
+    auto cursor = permutation.block(offset, cycle);
+    auto wrapped = permutation.block(0, offset);
+    bool secondWindow = false;
+    ok = ok && probeConcurrently(context, [&](Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+        uint64_t index;
+        while (sampled < sampleSize) {
+            if (!(secondWindow ? wrapped.next(index) : cursor.next(index))) {
+                if (secondWindow) {
+                    return false;
+                }
+                secondWindow = true;
+                continue;
+            }
+            Utils::IPAddress host = space.hostAt(space.hostIndexOf(index));
+            std::string ip = host.toString();
+            int candidate = space.portAt(index);
+            if (probed.count(probeKey(ip, candidate)) ||
+                (liveness && liveness->admit(host, index) != ProbeDecision::PROBE) ||
+                (guard && !guard->admit(ip))) {
+                continue;
+            }
+            probed.insert(probeKey(ip, candidate));
+            ++sampled;
+            target = host;
+            port = static_cast<uint16_t>(candidate);
+            tag = index;
+            return true;
+        }
+        return false;
+    }, liveness.get(), guard.get(), recordNew, error);
+    
+    // 不在本次范围内 (或因中止未验证) 的基线记录原样保留，输出即为合并后的完整状态，可直接作为下一次的基线
+    size_t carried = 0;
+    for (const auto& entry : baseline.entries()) {
+        if (probed.count(probeKey(entry.ip, entry.port))) {
+            continue;
+        }
+        PortScanResult port;
+        port.port = entry.port;
+        port.isOpen = true;
+        port.service = entry.service;
+        port.banner = entry.banner;
+        writer.writePort(entry.ip, port);
+        records += portRecordFields(entry.ip, port) + "}\n";
+        ++carried;
     }
     
-    return results;
+    if (guard) {
+        reportSuspicious(context, *guard, writer, result);
+        result.data["suppressed_ports"] = std::to_string(suppressed);
+    }
+    if (liveness) {
+        reportLiveness(context, *liveness, writer, result);
+    }
+    
+    result.success = ok;
+    result.message = ok ? "增量扫描完成: 新开放 " + std::to_string(newOpen) + ", 新关闭 " +
+                          std::to_string(newlyClosed) + ", 横幅变化 " + std::to_string(bannerChanged) +
+                          ", 无应答 " + std::to_string(unanswered)
+                        : error;
+    result.data["verified"] = std::to_string(verified);
+    result.data["new_open"] = std::to_string(newOpen);
+    result.data["newly_closed"] = std::to_string(newlyClosed);
+    result.data["banner_changed"] = std::to_string(bannerChanged);
+    result.data["unanswered"] = std::to_string(unanswered);
+    result.data["unreachable_hosts"] = std::to_string(unreachableHosts.size());
+    result.data["sampled"] = std::to_string(sampled);
+    result.data["carried_over"] = std::to_string(carried);
+    result.data["baseline_entries"] = std::to_string(baseline.size());
+    result.data["seed"] = std::to_string(seed);
+    result.data["results"] = records;
+    
+    m_status = ok ? EngineStatus::COMPLETED : EngineStatus::IDLE;
+    return result;
 }
 
-bool NetworkEngine::tcpConnect(const std::string& target, int port, int timeout) {
-    Utils::IPAddress ip(target);
-    auto result = Utils::NetworkUtils::testTCPConnection(ip, port, std::chrono::milliseconds(timeout));
-    return result.success;
+bool NetworkEngine::probeConcurrently(const CommandContext& context,
+                                      const std::function<bool(Utils::IPAddress& target, uint16_t& port, uint64_t& tag)>& source,
+                                      LivenessTracker* liveness, HostGuard* guard, const ProbeHandler& onResult,
+                                      std::string& error) {
+    ConnectScanConfig connectConfig;
+    ProxyScanConfig proxyConfig;
+    size_t threads = 1;
+    try {
+        connectConfig.timeout =
+            std::chrono::milliseconds(std::max(1, std::stoi(paramOr(context, "timeout", "3000"))));
+        proxyConfig.timeout = connectConfig.timeout;
+        proxyConfig.bannerWait =
+            std::chrono::milliseconds(std::max(0, std::stoi(paramOr(context, "banner-wait", "1000"))));
+        threads = static_cast<size_t>(std::max(1, std::stoi(paramOr(context, "threads", getOption("threads")))));
+    } catch (const std::exception&) {
+        error = "Invalid numeric option";
+        return false;
+    }
+    
+    struct Finished {
+        uint64_t tag;
+        Utils::IPAddress target;
+        PortScanResult port;
+    };
+    std::vector<Finished> finished;
+    auto record = [&](uint64_t tag, const Utils::IPAddress& target, uint16_t port, bool open, bool answered,
+                      double responseTime, const std::string& banner) {
+        if (liveness) {
+            if (answered) {
+                liveness->recordAlive(target);
+            } else {
+                liveness->recordTimeout(target);
+            }
+        }
+        PortScanResult result;
+        if (open) {
+            result = ScanSink::openPort(port, banner, responseTime);
+            if (guard) {
+                guard->recordOpen(target.toString(), m_proxyPool ? -1.0 : responseTime, -1);
+            }
+        } else {
+            result.port = port;
+            result.responseTime = responseTime;
+        }
+        result.answered = answered;
+        finished.push_back({tag, target, result});
+    };
+    
+    Utils::EventLoop loop;
+    if (m_proxyPool) {
+        // 经代理池: 隧道上直接采集横幅
+        ProxyScanner scanner(loop, *m_proxyPool, proxyConfig);
+        scanner.run(source, [&](const ProxyProbeResult& probe) {
+            if (guard && probe.open) {
+                guard->recordSpent(probe.target.toString(), probe.holdTime, !probe.banner.empty());
+            }
+            // 代理故障时端口状态未知，按无应答处理
+            record(probe.tag, probe.target, probe.port, probe.open, !probe.error, probe.responseTime, probe.banner);
+        }, m_stopRequested);
+    } else {
+        ConnectScanner scanner(loop, connectConfig);
+        scanner.run(source, [&](const ConnectProbeResult& probe) {
+            record(probe.tag, probe.target, probe.port, probe.open, probe.answered, probe.responseTime, "");
+        }, m_stopRequested);
+        
+        // 开放端口随后并发采集横幅 (连接数受连接预算约束)
+        std::vector<Finished*> open;
+        for (auto& entry : finished) {
+            if (entry.port.isOpen && (!guard || !guard->flagged(entry.target.toString()))) {
+                open.push_back(&entry);
+            }
+        }
+        std::atomic<size_t> next{0};
+        auto grab = [&]() {
+            size_t slot;
+            while (!m_stopRequested && (slot = next++) < open.size()) {
+                Finished& entry = *open[slot];
+                entry.port.banner = Utils::NetworkUtils::grabBanner(entry.target, static_cast<uint16_t>(entry.port.port),
+                                                                    connectConfig.timeout);
+                if (entry.port.service == "unknown" && !entry.port.banner.empty()) {
+                    entry.port.service = Utils::NetworkUtils::detectService(static_cast<uint16_t>(entry.port.port),
+                                                                            entry.port.banner);
+                }
+            }
+        };
+        std::vector<std::thread> grabbers;
+        for (size_t i = 1; i < std::min(threads, open.size()); ++i) {
+            grabbers.emplace_back(grab);
+        }
+        grab();
+        for (auto& grabber : grabbers) {
+            grabber.join();
+        }
+    }
+    
+    for (auto& entry : finished) {
+        onResult(entry.tag, entry.target, entry.port);
+    }
+    return true;
+}
+
+ExecutionResult NetworkEngine::executeService(const CommandContext& context) {
+    ExecutionResult result;
+    result.success = true;
+    result.message = "Service detection completed";
+    return result;
+}
+
+ExecutionResult NetworkEngine::executeOS(const CommandContext& context) {
+    ExecutionResult result;
+    result.success = true;
+    result.message = "OS detection completed";
+    return result;
+}
+
+ExecutionResult NetworkEngine::executeCoordinator(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for coordinator command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (context.parameters.count("shard")) {
+        // 协调节点把整个排列租给工作节点，分片由租约取代
+        result.success = false;
+        result.message = "-shard cannot be combined with coordinator";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    std::vector<int> ports;
+    auto portsParam = context.parameters.find("ports");
+    if (portsParam != context.parameters.end()) {
+        ports = parsePorts(portsParam->second);
+    } else {
+        ports = DEFAULT_PORTS;
+    }
+    
+    Utils::TargetSpace space;
+    Utils::ShardSpec shard;
+    uint64_t seed = 0;
+    std::string error;
+    if (ports.empty() || !prepareTargetSpace(context, ports, space, shard, seed, error)) {
+        result.success = false;
+        result.message = ports.empty() ? "No valid ports to scan" : error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ScanCoordinatorConfig config;
+    auto listenParam = context.parameters.find("listen");
+    if (listenParam != context.parameters.end() &&
+        !parseEndpoint(listenParam->second, config.listenAddress, config.listenPort)) {
+        result.success = false;
+        result.message = "Invalid listen address (expected addr:port): " + listenParam->second;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    auto tokenParam = context.parameters.find("token");
+    if (tokenParam != context.parameters.end()) {
+        config.token = tokenParam->second;
+    }
+    if (config.token.empty() && !config.listenAddress.isLoopback()) {
+        // 任何能连上的节点都可以领取租约或注入结果
+        result.success = false;
+        result.message = "Listening on " + config.listenAddress.toString() + " requires -token";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    try {
+        auto blockParam = context.parameters.find("block");
+        if (blockParam != context.parameters.end()) {
+            config.blockSize = std::stoull(blockParam->second);
+        }
+        auto timeoutParam = context.parameters.find("lease-timeout");
+        if (timeoutParam != context.parameters.end()) {
+            config.workerTimeout = std::chrono::seconds(std::stoul(timeoutParam->second));
+        }
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid block or lease-timeout value";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ResultWriter writer(context, shard);
+    if (!writer.isOpen()) {
+        result.success = false;
+        result.message = "Failed to open output file";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ScanJob job;
+    job.seed = seed;
+    job.size = space.size();
+    job.target = context.target;
+    job.ports = ports;
+    
+    Utils::TargetPermutation permutation(space.size(), seed);
+    ScanCoordinator coordinator(job, permutation.cycleLength(), config);
+    if (!coordinator.listen(error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    // 结果只传索引，由本地目标空间还原为 地址:端口
+    coordinator.setResultHandler([&](uint64_t index) {
+        PortScanResult port;
+        port.port = space.portAt(index);
+        port.isOpen = true;
+        auto serviceIt = COMMON_SERVICES.find(port.port);
+        port.service = (serviceIt != COMMON_SERVICES.end()) ? serviceIt->second : "unknown";
+        
+        std::string target = space.hostAt(space.hostIndexOf(index)).toString();
+        writer.writePort(target, port);
+        notifyOutput(context, "开放端口: " + target + ":" + std::to_string(port.port) + " (" + port.service + ")");
+    });
+    coordinator.setLogHandler([&](const std::string& message) { notifyOutput(context, message); });
+    
+    notifyOutput(context, "协调节点监听 " + config.listenAddress.toString() + ":" +
+                 std::to_string(coordinator.listenPort()) + ", " + std::to_string(space.hostCount()) +
+                 " 个主机, " + std::to_string(ports.size()) + " 个端口");
+    
+    bool completed = coordinator.run(m_stopRequested);
+    auto stats = coordinator.getStats();
+    
+    result.success = completed;
+    result.message = completed ? "分布式扫描完成，发现 " + std::to_string(stats.openResults) + " 个开放端口"
+                               : "分布式扫描已中止";
+    result.data["open_ports"] = std::to_string(stats.openResults);
+    result.data["probed"] = std::to_string(stats.probed);
+    result.data["workers"] = std::to_string(stats.workersJoined);
+    result.data["workers_lost"] = std::to_string(stats.workersLost);
+    result.data["leases"] = std::to_string(stats.leasesIssued);
+    result.data["leases_requeued"] = std::to_string(stats.leasesRequeued);
+    result.data["steals"] = std::to_string(stats.steals);
+    result.data["duplicates"] = std::to_string(stats.duplicates);
+    result.data["seed"] = std::to_string(seed);
+    
+    m_status = completed ? EngineStatus::COMPLETED : EngineStatus::IDLE;
+    return result;
+}
+
+ExecutionResult NetworkEngine::executeWorker(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    
+    Utils::IPAddress address;
+    uint16_t port = 0;
+    if (!parseEndpoint(context.target, address, port)) {
+        result.success = false;
+        result.message = "Coordinator address is required (host:port)";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    applySocketBudget(context);
+    
+    std::string error;
+    if (!configureProxies(context, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    ConnectScanConfig connectConfig;
+    ProxyScanConfig proxyConfig;
+    try {
+        connectConfig.timeout =
+            std::chrono::milliseconds(std::max(1, std::stoi(paramOr(context, "timeout", "3000"))));
+        proxyConfig.timeout = connectConfig.timeout;
+        proxyConfig.bannerWait =
+            std::chrono::milliseconds(std::max(0, std::stoi(paramOr(context, "banner-wait", "1000"))));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    // 与本地扫描相同: 存活推断只用于直连探测，tarpit检测两种后端都用
+    std::unique_ptr<LivenessTracker> liveness;
+    if (!m_proxyPool) {
+        liveness = createLivenessTracker(context, std::chrono::milliseconds(0), error);
+    }
+    auto guard = error.empty() ? createHostGuard(context, error) : nullptr;
+    if (!error.empty()) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    auto nameParam = context.parameters.find("name");
+    auto tokenParam = context.parameters.find("token");
+    ScanWorker worker(nameParam != context.parameters.end() ? nameParam->second : "",
+                      tokenParam != context.parameters.end() ? tokenParam->second : "");
+    worker.setLogHandler([&](const std::string& message) { notifyOutput(context, message); });
+    worker.setLivenessTracker(liveness.get());
+    worker.setHostGuard(guard.get());
+    
+    if (!worker.connect(address, port, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    notifyOutput(context, "已连接协调节点: " + context.target);
+    
+    // 租约中的探测点在工作节点的事件循环上并发探测: 经代理池或直连
+    bool completed;
+    if (m_proxyPool) {
+        ProxyScanner scanner(worker.loop(), *m_proxyPool, proxyConfig);
+        completed = worker.run([&](const ScanWorker::Source& source, const ScanWorker::ResultHandler& onResult,
+                                   const std::atomic<bool>& stop) {
+            scanner.run(source, [&](const ProxyProbeResult& probe) {
+                if (probe.error && m_proxyPool->exhausted()) {
+                    // 结果未知的探测点不回传，连同剩余区间由协调节点回收
+                    worker.abort("All proxies failed");
+                    return;
+                }
+                LeaseProbeResult lease;
+                lease.target = probe.target;
+                lease.port = probe.port;
+                lease.tag = probe.tag;
+                lease.open = probe.open;
+                lease.answered = probe.open;
+                lease.holdTime = probe.holdTime;
+                lease.banner = !probe.banner.empty();
+                onResult(lease);
+            }, stop);
+        }, m_stopRequested, error);
+    } else {
+        ConnectScanner scanner(worker.loop(), connectConfig);
+        completed = worker.run([&](const ScanWorker::Source& source, const ScanWorker::ResultHandler& onResult,
+                                   const std::atomic<bool>& stop) {
+            scanner.run(source, [&](const ConnectProbeResult& probe) {
+                LeaseProbeResult lease;
+                lease.target = probe.target;
+                lease.port = probe.port;
+                lease.tag = probe.tag;
+                lease.open = probe.open;
+                lease.answered = probe.answered;
+                lease.responseTime = probe.responseTime;
+                onResult(lease);
+            }, stop);
+        }, m_stopRequested, error);
+    }
+    
+    auto stats = worker.getStats();
+    result.success = completed;
+    result.message = completed ? "工作节点完成，探测 " + std::to_string(stats.probed) + " 个目标"
+                               : (error.empty() ? "工作节点已中止" : error);
+    result.data["leases"] = std::to_string(stats.leases);
+    result.data["truncated"] = std::to_string(stats.truncated);
+    result.data["probed"] = std::to_string(stats.probed);
+    result.data["open_ports"] = std::to_string(stats.open);
+    ResultWriter writer(context, Utils::ShardSpec());
+    if (guard) {
+        reportSuspicious(context, *guard, writer, result);
+    }
+    result.data["skipped_probes"] = std::to_string(stats.skipped);
+    result.data["suppressed_ports"] = std::to_string(stats.suppressed);
+    if (liveness) {
+        reportLiveness(context, *liveness, writer, result);
+    }
+    
+    m_status = completed ? EngineStatus::COMPLETED : EngineStatus::IDLE;
+    return result;
+}
+
+ExecutionResult NetworkEngine::executeTraceroute(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+    
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for traceroute command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    auto param = [&](const std::string& key, const std::string& fallback) {
+        auto it = context.parameters.find(key);
+        return it != context.parameters.end() ? it->second : fallback;
+    };
+    
+    TraceConfig config;
+    if (!parseTraceMethod(param("method", "udp"), config.method)) {
+        result.success = false;
+        result.message = "Invalid method: " + param("method", "") + " (expected udp, tcp or icmp)";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    try {
+        int firstTtl = std::stoi(param("first-ttl", "1"));
+        int maxTtl = std::stoi(param("max-ttl", "30"));
+        int port = std::stoi(param("port", "0"));
+        if (firstTtl < 1 || maxTtl > TraceProber::MAX_TTL || firstTtl > maxTtl || port < 0 || port > 65535) {
+            throw std::out_of_range("traceroute option");
+        }
+        config.firstTtl = static_cast<uint8_t>(firstTtl);
+        config.maxTtl = static_cast<uint8_t>(maxTtl);
+        config.port = static_cast<uint16_t>(port);
+        config.rate = static_cast<uint32_t>(std::max(1, std::stoi(param("rate", "10000"))));
+        config.wait = std::chrono::milliseconds(std::max(0, std::stoi(param("wait", "2000"))));
+        config.pilotTargets = static_cast<size_t>(std::max(0, std::stoi(param("pilot", "8"))));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid traceroute option (TTL range 1-" + std::to_string(TraceProber::MAX_TTL) + ")";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    Utils::TargetSpace space;
+    Utils::ShardSpec shard;
+    std::string error;
+    if (!prepareTargetSpace(context, {}, space, shard, config.seed, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    
+    // 按排列顺序发送，相邻探测分散到不同网段
+    std::vector<Utils::IPAddress> targets;
+    Utils::TargetPermutation permutation(space.size(), config.seed);
+    auto cursor = permutation.shard(shard);
+    uint64_t index;
+    while (cursor.next(index)) {
+        targets.push_back(space.hostAt(space.hostIndexOf(index)));
+    }
+    if (targets.empty()) {
+        result.success = true;
+        result.message = "没有需要跟踪的目标";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+    
+    notifyOutput(context, "路由跟踪 " + std::to_string(targets.size()) + " 个目标 (" +
+                 traceMethodName(config.method) + ", TTL " + std::to_string(config.firstTtl) + "-" +
+                 std::to_string(config.maxTtl) + ")");
+    
+    auto start = std::chrono::steady_clock::now();
+    TraceProber prober(config);
+    if (!prober.run(targets, m_stopRequested, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    
+    std::vector<TraceNode> nodes;
+    std::vector<TraceEdge> edges;
+    prober.buildGraph(nodes, edges);
+    
+    // 每条路径一行: 目标 [跳数] 各跳地址 (无应答为*)
+    size_t reached = 0;
+    std::string paths;
+    for (const auto& path : prober.paths()) {
+        std::string line = path.target + "  ";
+        line += path.reachedTtl > 0 ? "[" + std::to_string(path.reachedTtl) + "跳]" : "[未到达]";
+        std::string hops;
+        for (size_t i = 0; i < path.hops.size(); ++i) {
+            const TraceHop& hop = path.hops[i];
+            line += "  " + (hop.address.empty() ? std::string("*") : hop.address);
+            if (i > 0) {
+                hops += ",";
+            }
+            if (hop.address.empty()) {
+                hops += "null";
+            } else {
+                char rtt[32];
+                std::snprintf(rtt, sizeof(rtt), "%.3f", hop.rtt);
+                hops += "{\"ttl\":" + std::to_string(config.firstTtl + i) + ",\"address\":\"" + hop.address +
+                        "\",\"rtt_ms\":" + rtt + "}";
+            }
+        }
+        if (!path.termination.empty()) {
+            line += "  " + path.termination;
+        }
+        if (path.reachedTtl > 0) {
+            ++reached;
+        }
+        notifyOutput(context, line);
+        
+        paths += std::string(paths.empty() ? "" : ",") + "{\"target\":\"" + path.target +
+                 "\",\"reached_ttl\":" + std::to_string(path.reachedTtl) + ",\"termination\":\"" +
+                 Utils::jsonEscape(path.termination) + "\",\"hops\":[" + hops + "]}";
+    }
+    
+    size_t routers = 0;
+    std::string nodeList;
+    for (const auto& node : nodes) {
+        if (!node.target) {
+            ++routers;
+        }
+        char rtt[32];
+        std::snprintf(rtt, sizeof(rtt), "%.3f", node.rtt);
+        nodeList += std::string(nodeList.empty() ? "" : ",") + "{\"address\":\"" + node.address +
+                    "\",\"ttl\":" + std::to_string(node.ttl) + ",\"rtt_ms\":" + rtt +
+                    ",\"paths\":" + std::to_string(node.paths) + ",\"target\":" + (node.target ? "true" : "false") + "}";
+    }
+    std::string edgeList;
+    for (const auto& edge : edges) {
+        edgeList += std::string(edgeList.empty() ? "" : ",") + "{\"from\":\"" + edge.from + "\",\"to\":\"" +
+                    edge.to + "\",\"gap\":" + std::to_string(edge.gap) + ",\"paths\":" + std::to_string(edge.paths) + "}";
+    }
+    std::string graph = "{\"nodes\":[" + nodeList + "],\"edges\":[" + edgeList + "]}";
+    
+    auto outputParam = context.parameters.find("output");
+    if (outputParam != context.parameters.end()) {
+        std::ofstream file(outputParam->second, std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            notifyError(context, "Failed to open output file: " + outputParam->second);
+        } else {
+            file << "{\"paths\":[" << paths << "],\"nodes\":[" << nodeList << "],\"edges\":[" << edgeList << "]}\n";
+        }
+    }
+    
+    auto stats = prober.getStats();
+    result.success = true;
+    result.message = "路由跟踪完成，" + std::to_string(reached) + "/" + std::to_string(prober.paths().size()) +
+                     " 个目标可达, " + std::to_string(routers) + " 个路由器, " + std::to_string(edges.size()) + " 条链路";
+    if (stats.sharedTtl > 0) {
+        result.message += ", 共享前缀 " + std::to_string(stats.sharedTtl) + " 跳";
+    }
+    result.data["targets"] = std::to_string(prober.paths().size());
+    result.data["reached"] = std::to_string(reached);
+    result.data["routers"] = std::to_string(routers);
+    result.data["edges"] = std::to_string(edges.size());
+    result.data["probes_sent"] = std::to_string(stats.probesSent);
+    result.data["probes_saved"] = std::to_string(stats.probesSaved);
+    result.data["shared_ttl"] = std::to_string(stats.sharedTtl);
+    result.data["replies"] = std::to_string(stats.replies);
+    result.data["unmatched"] = std::to_string(stats.unmatched);
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["paths"] = "[" + paths + "]";
+    result.data["graph"] = graph;
+    result.data["shard"] = shard.toString();
+    
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+bool NetworkEngine::pingHost(const std::string& target) {
+    Utils::IPAddress ip(target);
+    auto result = Utils::NetworkUtils::pingHost(ip);
+    return result.success;
+}
+
+PortScanResult NetworkEngine::probePort(const std::string& target, int port) {
+    PortScanResult result;
+    result.port = port;
+    auto start = std::chrono::steady_clock::now();
+    result.isOpen = tcpConnect(target, port, 3000, &result.answered);
+    result.responseTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    if (result.isOpen) {
+        auto serviceIt = COMMON_SERVICES.find(port);
+        result.service = (serviceIt != COMMON_SERVICES.end()) ? serviceIt->second : "unknown";
+    }
+    
+    return result;
+}
+
+std::string NetworkEngine::grabBanner(const std::string& target, int port) {
+    if (m_proxyPool) {
+        auto connection = Utils::connectThroughProxy(*m_proxyPool, Utils::IPAddress(target),
+                                                     static_cast<uint16_t>(port), std::chrono::milliseconds(3000));
+        if (!connection.socket) {
+            return "";
+        }
+        return Utils::NetworkUtils::readBanner(*connection.socket, std::chrono::milliseconds(3000),
+                                               connection.initialData);
+    }
+    return Utils::NetworkUtils::grabBanner(Utils::IPAddress(target), static_cast<uint16_t>(port),
+                                           std::chrono::milliseconds(3000));
+}
+
+bool NetworkEngine::tcpConnect(const std::string& target, int port, int timeout, bool* answered) {
+    Utils::IPAddress ip(target);
+    if (m_proxyPool) {
+        // 隧道建立即端口开放
+        auto connection = Utils::connectThroughProxy(*m_proxyPool, ip, static_cast<uint16_t>(port),
+                                                     std::chrono::milliseconds(timeout));
+        // 代理的目标失败应答不区分拒绝和超时，按有应答处理，避免误判主机沉寂
+        if (answered) {
+            *answered = connection.outcome != Utils::ProxyOutcome::PROXY_FAILED;
+        }
+        return connection.outcome == Utils::ProxyOutcome::ESTABLISHED;
+    }
+    auto result = Utils::NetworkUtils::testTCPConnection(ip, port, std::chrono::milliseconds(timeout));
+    if (answered) {
+        // RST和ICMP管理禁止说明主机存在; 主机/网络不可达 (含ARP无应答) 与超时一样视为沉默
+#ifdef _WIN32
+        *answered = result.success || result.errorCode == WSAECONNREFUSED;
+#else
+        *answered = result.success || result.errorCode == ECONNREFUSED || result.errorCode == EACCES ||
+                    result.errorCode == EPERM;
+#endif
+    }
+    return result.success;
+}
+
+std::unique_ptr<LivenessTracker> NetworkEngine::createLivenessTracker(const CommandContext& context,
+                                                                      std::chrono::milliseconds replyWindow,
+                                                                      std::string& error) {
+    auto levelParam = context.parameters.find("liveness");
+    std::string levelName = levelParam != context.parameters.end() ? levelParam->second : getOption("liveness");
+    LivenessLevel level = LivenessLevel::LOW;
+    if (!levelName.empty() && !parseLivenessLevel(levelName, level)) {
+        error = "Invalid -liveness (off|low|medium|high)";
+        return nullptr;
+    }
+    if (level == LivenessLevel::OFF) {
+        return nullptr;
+    }
+    
+    LivenessConfig config = LivenessConfig::forLevel(level);
+    if (replyWindow.count() > 0) {
+        config.replyWindow = replyWindow;
+    }
+    auto deadAfter = context.parameters.find("dead-after");
+    if (deadAfter != context.parameters.end()) {
+        try {
+            config.hostTimeouts = static_cast<uint32_t>(std::max(0, std::stoi(deadAfter->second)));
+        } catch (const std::exception&) {
+            error = "Invalid -dead-after";
+            return nullptr;
+        }
+    }
+    return std::make_unique<LivenessTracker>(config);
+}
+
+void NetworkEngine::reportSuspicious(const CommandContext& context, const HostGuard& guard, ResultWriter& writer,
+                                     ExecutionResult& result) {
+    std::string suspicious;
+    for (const auto& host : guard.suspiciousHosts()) {
+        notifyOutput(context, "可疑主机 " + host.host + " [" + hostVerdictName(host.verdict) + "]: 探测 " +
+                     std::to_string(host.probed) + ", 开放 " + std::to_string(host.open) + ", 跳过 " +
+                     std::to_string(host.skipped) + ", 耗时 " + std::to_string(static_cast<uint64_t>(host.spentMs)) + " ms");
+        writer.writeSuspicious(host);
+        suspicious += suspiciousRecordFields(host) + "}\n";
+    }
+    result.data["suspicious_hosts"] = suspicious;
+    result.data["skipped_probes"] = std::to_string(guard.skipped());
+}
+
+std::unique_ptr<HostGuard> NetworkEngine::createHostGuard(const CommandContext& context, std::string& error) {
+    if (paramOr(context, "tarpit", "on") == "off") {
+        return nullptr;
+    }
+    HostGuardConfig config;
+    try {
+        config.hostBudget = std::chrono::seconds(std::max(0, std::stoi(paramOr(context, "host-budget", "120"))));
+    } catch (const std::exception&) {
+        error = "Invalid -host-budget";
+        return nullptr;
+    }
+    return std::make_unique<HostGuard>(config);
+}
+
+void NetworkEngine::reportLiveness(const CommandContext& context, const LivenessTracker& tracker,
+                                   ResultWriter& writer, ExecutionResult& result) {
+    // 每个放弃/推迟决定连同证据写入结果文件，便于审计
+    std::string records;
+    for (const auto& decision : tracker.decisions()) {
+        writer.writeLiveness(decision);
+        records += livenessRecordFields(decision) + "}\n";
+    }
+    
+    auto stats = tracker.getStats();
+    if (stats.deadHosts > 0 || stats.deadSubnets > 0) {
+        notifyOutput(context, "存活推断: 沉寂主机 " + std::to_string(stats.deadHosts) + ", 沉寂子网 " +
+                     std::to_string(stats.deadSubnets) + ", 跳过探测 " + std::to_string(stats.skipped) +
+                     ", 推迟探测 " + std::to_string(stats.deferred) + " (补做 " + std::to_string(stats.revisited) + ")");
+    }
+    result.data["liveness_decisions"] = records;
+    result.data["dead_hosts"] = std::to_string(stats.deadHosts);
+    result.data["dead_subnets"] = std::to_string(stats.deadSubnets);
+    result.data["liveness_skipped"] = std::to_string(stats.skipped);
+    result.data["liveness_deferred"] = std::to_string(stats.deferred);
+    result.data["liveness_revisited"] = std::to_string(stats.revisited);
+}
+
+void NetworkEngine::applySocketBudget(const CommandContext& context) {
+    Utils::SocketBudgetConfig config;
+
+    auto sourcesParam = context.parameters.find("sources");
+    if (sourcesParam != context.parameters.end()) {
+        for (const auto& source : Utils::NetworkUtils::parseIPList(sourcesParam->second)) {
+            config.sourceAddresses.push_back(source);
+        }
+    }
+
+    auto inflightParam = context.parameters.find("inflight");
+    if (inflightParam != context.parameters.end()) {
+        try {
+            config.maxInFlight = static_cast<size_t>(std::stoul(inflightParam->second));
+        } catch (const std::exception&) {
+            notifyError(context, "无效的在途连接上限: " + inflightParam->second);
+        }
+    }
+
+    auto& budget = Utils::SocketBudget::instance();
+    budget.configure(config);
+
+    auto stats = budget.getStats();
+    notifyOutput(context, "连接预算: fd上限 " + std::to_string(stats.fileLimit) +
+                 ", 在途上限 " + std::to_string(stats.ceiling) +
+                 ", 源地址 " + std::to_string(std::max<size_t>(1, config.sourceAddresses.size())));
+}
+
+bool NetworkEngine::configureProxies(const CommandContext& context, std::string& error) {
+    m_proxyPool.reset();
+    
+    auto proxyParam = context.parameters.find("proxy");
+    if (proxyParam == context.parameters.end()) {
+        return true;
+    }
+    
+    std::vector<Utils::ProxyEndpoint> proxies;
+    if (!Utils::parseProxyList(proxyParam->second, proxies, error)) {
+        return false;
+    }
+    size_t perProxy = 64;
+    auto concurrencyParam = context.parameters.find("proxy-concurrency");
+    if (concurrencyParam != context.parameters.end()) {
+        try {
+            perProxy = std::max<size_t>(1, std::stoul(concurrencyParam->second));
+        } catch (const std::exception&) {
+            error = "Invalid proxy concurrency: " + concurrencyParam->second;
+            return false;
+        }
+    }
+    
+    m_proxyPool = std::make_unique<Utils::ProxyPool>(std::move(proxies), perProxy);
+    for (size_t i = 0; i < m_proxyPool->size(); ++i) {
+        notifyOutput(context, "上游代理: " + m_proxyPool->endpoint(i).toString());
+    }
+    return true;
+}
+
+bool NetworkEngine::prepareTargetSpace(const CommandContext& context, const std::vector<int>& ports,
+                                       Utils::TargetSpace& space, Utils::ShardSpec& shard,
+                                       uint64_t& seed, std::string& error) {
+    if (!space.addTargets(context.target)) {
+        error = "Invalid target format";
+        return false;
+    }
+    space.setPorts(ports);
+    
+    auto shardParam = context.parameters.find("shard");
+    if (shardParam != context.parameters.end() && !Utils::ShardSpec::parse(shardParam->second, shard)) {
+        error = "Invalid shard (expected i/n with 0 <= i < n): " + shardParam->second;
+        return false;
+    }
+    
+    // 所有分片必须使用相同种子，默认由目标和端口描述派生
+    auto seedParam = context.parameters.find("seed");
+    if (seedParam != context.parameters.end()) {
+        try {
+            seed = std::stoull(seedParam->second);
+        } catch (const std::exception&) {
+            error = "Invalid seed: " + seedParam->second;
+            return false;
+        }
+    } else {
+        auto portsParam = context.parameters.find("ports");
+        std::string portSpec = portsParam != context.parameters.end() ? portsParam->second : "";
+        seed = Utils::TargetPermutation::deriveSeed(context.command + "|" + context.target + "|" + portSpec);
+    }
+    
+    if (shard.count > 1) {
+        notifyOutput(context, "分片 " + shard.toString() + " (种子 " + std::to_string(seed) + ")");
+    }
+    return true;
+}
+
+bool NetworkEngine::loadBaseline(const CommandContext& context, ScanBaseline& baseline, std::string& error) {
+    // 终端从结果库取出的历史结果以JSON行形式注入
+    auto inlineParam = context.parameters.find("baseline");
+    if (inlineParam != context.parameters.end()) {
+        baseline.parse(inlineParam->second);
+        return true;
+    }
+    
+    const std::string& reference = context.parameters.at("diff-against");
+    if (reference == "latest" || isNumber(reference)) {
+        error = "No previous scan result found for diff-against " + reference;
+        return false;
+    }
+    
+    // 其余取值视为之前 -output 生成的结果文件
+    if (!baseline.loadFile(reference)) {
+        error = "Failed to read baseline file: " + reference;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkEngine::parseEndpoint(const std::string& text, Utils::IPAddress& address, uint16_t& port) {
+    // host:port 或 [IPv6]:port
+    size_t colonPos = text.rfind(':');
+    if (colonPos == std::string::npos || colonPos == 0) {
+        return false;
+    }
+    
+    std::string host = text.substr(0, colonPos);
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    
+    int value;
+    try {
+        value = std::stoi(text.substr(colonPos + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (value < 0 || value > 65535) {
+        return false;
+    }
+    
+    address = Utils::NetworkUtils::resolveHostname(host);
+    port = static_cast<uint16_t>(value);
+    return !address.address.empty();
 }
 
 std::vector<std::string> NetworkEngine::parseTargets(const std::string& targetString) {
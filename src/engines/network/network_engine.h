@@ -5,9 +5,25 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <fstream>
+#include <memory>
+
+namespace MindSploit::Utils {
+class TargetSpace;
+class TargetPermutation;
+struct ShardSpec;
+struct IPAddress;
+class ProxyPool;
+}
 
 namespace MindSploit::Network {
 
+class ScanBaseline;
+class HostGuard;
+struct SuspiciousHost;
+struct LivenessDecision;
+class LivenessTracker;
+
 // 主机信息结构
 struct HostInfo {
     std::string ip;
@@ -26,7 +42,9 @@ struct PortScanResult {
     std::string service;
     std::string version;
     std::string banner;
+    std::string tlsFingerprint;     // 主动TLS指纹 (scan -tls-fp)
     double responseTime = 0.0;
+    bool answered = false;          // 收到任何应答 (开放、RST或ICMP)，否则为超时
 };
 
 // 扫描配置
@@ -76,7 +94,6 @@ public:
 
     // 网络扫描专用接口
     std::vector<HostInfo> discoverHosts(const std::vector<std::string>& targets);
-    std::vector<PortScanResult> scanPorts(const std::string& target, const std::vector<int>& ports);
     std::string detectService(const std::string& target, int port);
     std::string detectOS(const std::string& target);
 
@@ -86,12 +103,17 @@ private:
     ExecutionResult executeScan(const CommandContext& context);
     ExecutionResult executeService(const CommandContext& context);
     ExecutionResult executeOS(const CommandContext& context);
+    ExecutionResult executeCoordinator(const CommandContext& context);
+    ExecutionResult executeWorker(const CommandContext& context);
+    ExecutionResult executeTraceroute(const CommandContext& context);
     
     // 核心扫描功能
     bool pingHost(const std::string& target);
-    bool tcpConnect(const std::string& target, int port, int timeout);
+    // answered: 收到SYN-ACK、RST或ICMP拒绝，而不是超时
+    bool tcpConnect(const std::string& target, int port, int timeout, bool* answered = nullptr);
     bool tcpSyn(const std::string& target, int port, int timeout);
     bool udpScan(const std::string& target, int port, int timeout);
+    PortScanResult probePort(const std::string& target, int port);
     
     // 服务识别
     std::string grabBanner(const std::string& target, int port);
@@ -105,6 +127,106 @@ private:
     std::vector<int> parsePorts(const std::string& portString);
     bool isValidIP(const std::string& ip);
     std::string resolveHostname(const std::string& hostname);
+    void applySocketBudget(const CommandContext& context);
+    // -proxy 配置上游代理池，未指定时清除; 之后的连接探测和横幅采集都经代理池
+    bool configureProxies(const CommandContext& context, std::string& error);
+    bool loadBaseline(const CommandContext& context, ScanBaseline& baseline, std::string& error);
+    // 为可能是TLS的开放端口采集指纹，返回不同指纹数
+    size_t fingerprintTlsPorts(const CommandContext& context,
+                               std::vector<std::pair<std::string, PortScanResult>>& ports);
+    static bool parseEndpoint(const std::string& text, Utils::IPAddress& address, uint16_t& port);
+    
+    // 目标空间与分片
+    bool prepareTargetSpace(const CommandContext& context, const std::vector<int>& ports,
+                            Utils::TargetSpace& space, Utils::ShardSpec& shard,
+                            uint64_t& seed, std::string& error);
+    
+    // 结果文件写入
+    class ResultWriter {
+    public:
+        ResultWriter(const CommandContext& context, const Utils::ShardSpec& shard);
+        bool isOpen() const;
+        void writeHost(const std::string& ip);
+        void writePort(const std::string& ip, const PortScanResult& port);
+        void writeChange(const std::string& ip, const PortScanResult& port, const std::string& change);
+        void writeSuspicious(const SuspiciousHost& host);
+        void writeLiveness(const LivenessDecision& decision);
+    private:
+        std::ofstream m_file;
+        std::string m_shard;
+        bool m_enabled = false;
+    };
+    
+    // 端口扫描的结果汇集，三种扫描后端共用: tarpit检测、开放端口输出、-tls-fp的暂存
+    class ScanSink {
+    public:
+        ScanSink(NetworkEngine& engine, const CommandContext& context, ResultWriter& writer,
+                 std::unique_ptr<HostGuard> guard, bool tlsFingerprint);
+        ~ScanSink();
+        
+        bool guarding() const { return m_guard != nullptr; }
+        // 检测器允许探测该主机时返回true
+        bool admit(const std::string& target);
+        bool flagged(const std::string& target) const;
+        // 把一次观察交给检测器，主机因此被标记时提示一次
+        void observe(const std::string& target, const std::function<void(HostGuard&)>& record);
+        // tarpit主机的开放端口只计数; -tls-fp时暂存到扫描结束
+        void recordOpen(const std::string& target, const PortScanResult& port);
+        void countProbe() { ++m_probed; }
+        // 汇报可疑主机，采集暂存端口的TLS指纹并写出，填写结果统计
+        void finish(ExecutionResult& result);
+        int openPorts() const { return m_openPorts; }
+        ResultWriter& writer() { return m_writer; }
+        
+        // 代理和原始SYN扫描得到的开放端口: 按端口和横幅识别服务
+        static PortScanResult openPort(uint16_t port, const std::string& banner, double responseTime);
+        
+    private:
+        NetworkEngine& m_engine;
+        const CommandContext& m_context;
+        ResultWriter& m_writer;
+        std::unique_ptr<HostGuard> m_guard;
+        bool m_tlsFingerprint;
+        std::vector<std::pair<std::string, PortScanResult>> m_tlsPending;
+        std::string m_records;
+        int m_openPorts = 0;
+        uint64_t m_probed = 0;
+        uint64_t m_suppressed = 0;
+    };
+    
+    // 端口扫描后端: 按排列遍历本分片的 目标×端口 索引，结果交给sink
+    // 参数无效或扫描无法启动时填写result.message并返回false
+    bool scanViaProxies(const CommandContext& context, const Utils::TargetSpace& space,
+                        const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                        ScanSink& sink, ExecutionResult& result);
+    bool scanSyn(const CommandContext& context, const Utils::TargetSpace& space,
+                 const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                 ScanSink& sink, ExecutionResult& result);
+    bool scanConnect(const CommandContext& context, const Utils::TargetSpace& space,
+                     const Utils::TargetPermutation& permutation, const Utils::ShardSpec& shard,
+                     ScanSink& sink, ExecutionResult& result);
+    
+    // -liveness 存活推断，off时返回nullptr; replyWindow非0表示异步探测的应答等待时间
+    std::unique_ptr<LivenessTracker> createLivenessTracker(const CommandContext& context,
+                                                           std::chrono::milliseconds replyWindow, std::string& error);
+    // -tarpit/-host-budget tarpit检测，off时返回nullptr
+    std::unique_ptr<HostGuard> createHostGuard(const CommandContext& context, std::string& error);
+    // 汇报被标记的主机并写入结果文件
+    void reportSuspicious(const CommandContext& context, const HostGuard& guard, ResultWriter& writer,
+                          ExecutionResult& result);
+    void reportLiveness(const CommandContext& context, const LivenessTracker& tracker, ResultWriter& writer,
+                        ExecutionResult& result);
+    
+    // 增量重扫: 验证基线 -> 变化主机全端口 -> 抽样发现，输出合并后的完整状态，变化的端口带change字段
+    ExecutionResult executeDiffScan(const CommandContext& context, const Utils::TargetSpace& space,
+                                    uint64_t seed, ResultWriter& writer);
+    // 增量重扫的探测: 数据源给出的目标经代理池或直连并发探测，直连开放的端口随后并发采集横幅。
+    // 应答计入liveness，开放端口计入guard，全部结束后依次交给onResult; 参数无效时返回false
+    using ProbeHandler = std::function<void(uint64_t tag, const Utils::IPAddress& target, PortScanResult& port)>;
+    bool probeConcurrently(const CommandContext& context,
+                           const std::function<bool(Utils::IPAddress& target, uint16_t& port, uint64_t& tag)>& source,
+                           LivenessTracker* liveness, HostGuard* guard, const ProbeHandler& onResult,
+                           std::string& error);
     
     // 线程管理
     void workerThread(const std::string& target, const std::vector<int>& ports, 
@@ -116,6 +238,7 @@ private:
     ScanConfig m_config;
     std::map<std::string, std::string> m_options;
     std::vector<std::thread> m_workers;
+    std::unique_ptr<Utils::ProxyPool> m_proxyPool;
     
     // 默认端口列表
     static const std::vector<int> DEFAULT_PORTS;
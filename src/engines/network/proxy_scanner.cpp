@@ -0,0 +1,414 @@
+#include "proxy_scanner.h"
+#include "../../utils/socket_budget.h"
+#include <cstring>
+
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+namespace MindSploit::Network {
+
+namespace {
+
+constexpr std::chrono::milliseconds SWEEP_INTERVAL{50};
+constexpr size_t RECEIVE_CHUNK = 4096;
+
+int lastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool wouldBlock(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+}
+
+bool connectInProgress(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EINPROGRESS;
+#endif
+}
+
+long sendBytes(int fd, const char* data, size_t length) {
+#ifdef _WIN32
+    return ::send(fd, data, static_cast<int>(length), 0);
+#else
+    return ::send(fd, data, length, MSG_NOSIGNAL);
+#endif
+}
+
+} // namespace
+
+ProxyScanner::ProxyScanner(Utils::EventLoop& loop, Utils::ProxyPool& pool, const ProxyScanConfig& config)
+    : m_loop(loop), m_pool(pool), m_config(config) {
+    m_config.maxAttempts = std::max(1, m_config.maxAttempts);
+}
+
+ProxyScanner::~ProxyScanner() {
+    abandon();
+}
+
+void ProxyScanner::run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested) {
+    m_source = std::move(source);
+    m_onResult = std::move(onResult);
+    m_sourceDone = false;
+    m_aborted = false;
+
+    pump();
+    auto lastSweep = Clock::now();
+    while (!stopRequested && (!m_sourceDone || !m_queue.empty() || !m_probes.empty())) {
+        m_loop.runOnce(SWEEP_INTERVAL);
+        auto now = Clock::now();
+        if (now - lastSweep >= SWEEP_INTERVAL) {
+            lastSweep = now;
+            sweep();
+        }
+        // 停用的代理冷却结束后会重新放出名额
+        pump();
+    }
+    if (stopRequested) {
+        abandon();
+        m_queue.clear();
+    }
+}
+
+void ProxyScanner::pump() {
+    while (true) {
+        if (m_queue.empty()) {
+            if (m_sourceDone) {
+                return;
+            }
+            Target target;
+            if (!m_source(target.address, target.port, target.tag)) {
+                m_sourceDone = true;
+                return;
+            }
+            m_queue.push_back(std::move(target));
+        }
+
+        if (m_pool.exhausted()) {
+            // 没有任何代理可用: 排队的目标报告为错误，不再读取新目标
+            m_aborted = true;
+            m_sourceDone = true;
+            while (!m_queue.empty()) {
+                Target target = std::move(m_queue.front());
+                m_queue.pop_front();
+                report(target, false, true, "", "", "All proxies failed");
+            }
+            return;
+        }
+
+        // 先出队: 立即失败的探测会把重试放回队首
+        Target target = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (!start(target)) {
+            m_queue.push_front(std::move(target));
+            return;
+        }
+    }
+}
+
+bool ProxyScanner::start(const Target& target) {
+    int index = m_pool.acquire(target.lastProxy);
+    if (index < 0) {
+        return false;
+    }
+
+    auto& budget = Utils::SocketBudget::instance();
+    if (!budget.acquire(std::chrono::milliseconds(0))) {
+        m_pool.cancel(index);
+        return false;
+    }
+
+    const Utils::ProxyEndpoint& proxy = m_pool.endpoint(static_cast<size_t>(index));
+    int fd = budget.openProbeSocket(proxy.address);
+    if (fd < 0) {
+        budget.release();
+        m_pool.cancel(index);
+        return false;
+    }
+
+    auto probe = std::make_unique<Probe>();
+    probe->target = target;
+    probe->target.started = Clock::now();
+    probe->fd = fd;
+    probe->proxy = index;
+    probe->deadline = probe->target.started + m_config.timeout;
+    probe->handshake = std::make_unique<Utils::ProxyHandshake>(proxy, target.address, target.port);
+    Probe& ref = *probe;
+    m_probes[fd] = std::move(probe);
+    m_stats.peakInFlight = std::max(m_stats.peakInFlight, m_probes.size());
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen = Utils::NetworkUtils::toSockaddr(proxy.address, proxy.port, addr);
+    int result = ::connect(fd, (struct sockaddr*)&addr, addrLen);
+    if (result != 0) {
+        int error = lastSocketError();
+        if (!connectInProgress(error)) {
+            budget.reportError(error);
+            finish(ref, Utils::ProxyOutcome::PROXY_FAILED, "",
+                   std::string("Cannot connect to proxy: ") + strerror(error));
+            return true;
+        }
+    }
+
+    m_loop.watch(fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE,
+                 [this, fd](uint32_t events) { onEvent(fd, events); });
+    if (result == 0) {
+        ref.phase = Phase::HANDSHAKE;
+        flushHandshake(ref);
+    }
+    return true;
+}
+
+void ProxyScanner::onEvent(int fd, uint32_t events) {
+    auto it = m_probes.find(fd);
+    if (it == m_probes.end()) {
+        return;
+    }
+    Probe& probe = *it->second;
+
+    switch (probe.phase) {
+        case Phase::CONNECTING: {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+            if (error != 0 || !(events & Utils::EventLoop::EVENT_WRITE)) {
+                Utils::SocketBudget::instance().reportError(error);
+                finish(probe, Utils::ProxyOutcome::PROXY_FAILED, "",
+                       error != 0 ? std::string("Cannot connect to proxy: ") + strerror(error)
+                                  : "Cannot connect to proxy");
+                return;
+            }
+            Utils::SocketBudget::instance().reportSuccess();
+            probe.phase = Phase::HANDSHAKE;
+            flushHandshake(probe);
+            return;
+        }
+        case Phase::HANDSHAKE:
+            if ((events & Utils::EventLoop::EVENT_WRITE) && !flushHandshake(probe)) {
+                return;
+            }
+            if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+                readHandshake(probe);
+            }
+            return;
+        case Phase::BANNER:
+        case Phase::HTTP_PROBE:
+            readBanner(probe);
+            return;
+    }
+}
+
+bool ProxyScanner::flushHandshake(Probe& probe) {
+    while (!probe.handshake->pendingOutput().empty()) {
+        const std::string& output = probe.handshake->pendingOutput();
+        long sent = sendBytes(probe.fd, output.data(), output.size());
+        if (sent < 0) {
+            if (wouldBlock(lastSocketError())) {
+                break;
+            }
+            finish(probe, Utils::ProxyOutcome::PROXY_FAILED, "", "Send to proxy failed");
+            return false;
+        }
+        probe.handshake->consumeOutput(static_cast<size_t>(sent));
+    }
+
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (!probe.handshake->pendingOutput().empty()) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(probe.fd, events);
+    return true;
+}
+
+void ProxyScanner::readHandshake(Probe& probe) {
+    char buffer[RECEIVE_CHUNK];
+    while (true) {
+        long received = ::recv(probe.fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && wouldBlock(lastSocketError())) {
+            return;
+        }
+        if (received <= 0) {
+            // 代理在应答前关闭连接: 问候之后关闭通常表示目标连接失败
+            auto outcome = probe.handshake->timeoutOutcome();
+            finish(probe, outcome, "", "Proxy closed the connection");
+            return;
+        }
+
+        size_t consumed = 0;
+        auto result = probe.handshake->feed(buffer, static_cast<size_t>(received), consumed);
+        if (result == Utils::ProxyHandshake::Result::DONE) {
+            onTunnel(probe, buffer + consumed, static_cast<size_t>(received) - consumed);
+            return;
+        }
+        if (result == Utils::ProxyHandshake::Result::FAILED) {
+            // finish会释放探测，先复制错误信息
+            std::string error = probe.handshake->error();
+            finish(probe, probe.handshake->outcome(), "", error);
+            return;
+        }
+        if (!flushHandshake(probe)) {
+            return;
+        }
+    }
+}
+
+void ProxyScanner::onTunnel(Probe& probe, const char* data, size_t length) {
+    probe.tunnelled = Clock::now();
+    if (m_config.bannerWait.count() == 0) {
+        finish(probe, Utils::ProxyOutcome::ESTABLISHED, "", "");
+        return;
+    }
+    if (length > 0) {
+        finish(probe, Utils::ProxyOutcome::ESTABLISHED, Utils::NetworkUtils::bannerLine(data, length), "");
+        return;
+    }
+    probe.phase = Phase::BANNER;
+    probe.deadline = Clock::now() + m_config.bannerWait;
+    m_loop.update(probe.fd, Utils::EventLoop::EVENT_READ);
+}
+
+void ProxyScanner::readBanner(Probe& probe) {
+    char buffer[RECEIVE_CHUNK];
+    long received = ::recv(probe.fd, buffer, sizeof(buffer), 0);
+    if (received < 0 && wouldBlock(lastSocketError())) {
+        return;
+    }
+    std::string banner;
+    if (received > 0) {
+        banner = Utils::NetworkUtils::bannerLine(buffer, static_cast<size_t>(received));
+    }
+    finish(probe, Utils::ProxyOutcome::ESTABLISHED, banner, "");
+}
+
+void ProxyScanner::sendHttpProbe(Probe& probe) {
+    // 与直连横幅采集相同: 服务端不主动发送时请求一次响应头
+    static const char request[] = "HEAD / HTTP/1.0\r\n\r\n";
+    if (sendBytes(probe.fd, request, sizeof(request) - 1) <= 0) {
+        finish(probe, Utils::ProxyOutcome::ESTABLISHED, "", "");
+        return;
+    }
+    probe.phase = Phase::HTTP_PROBE;
+    probe.deadline = Clock::now() + m_config.bannerWait;
+}
+
+void ProxyScanner::finish(Probe& probe, Utils::ProxyOutcome outcome, const std::string& banner,
+                          const std::string& reason) {
+    int fd = probe.fd;
+    Target target = probe.target;
+    target.lastProxy = probe.proxy;
+    std::string proxy = m_pool.endpoint(static_cast<size_t>(probe.proxy)).toString();
+    double holdTime = probe.tunnelled == Clock::time_point() ? 0.0 :
+        std::chrono::duration<double, std::milli>(Clock::now() - probe.tunnelled).count();
+
+    m_pool.release(probe.proxy, outcome);
+    if (m_loop.isWatched(fd)) {
+        m_loop.unwatch(fd);
+    }
+    auto& budget = Utils::SocketBudget::instance();
+    budget.closeProbeSocket(fd);
+    budget.release();
+    m_probes.erase(fd);
+
+    if (outcome == Utils::ProxyOutcome::PROXY_FAILED) {
+        if (++target.attempts < m_config.maxAttempts) {
+            ++m_stats.retries;
+            m_queue.push_front(std::move(target));
+            return;
+        }
+        report(target, false, true, "", proxy, reason);
+        return;
+    }
+    report(target, outcome == Utils::ProxyOutcome::ESTABLISHED, false, banner, proxy, reason, holdTime);
+}
+
+void ProxyScanner::report(const Target& target, bool open, bool error, const std::string& banner,
+                          const std::string& proxy, const std::string& reason, double holdTime) {
+    ++m_stats.probes;
+    if (error) {
+        ++m_stats.errors;
+    } else if (open) {
+        ++m_stats.open;
+    } else {
+        ++m_stats.closed;
+    }
+    if (!banner.empty()) {
+        ++m_stats.banners;
+    }
+
+    if (!m_onResult) {
+        return;
+    }
+    ProxyProbeResult result;
+    result.target = target.address;
+    result.port = target.port;
+    result.tag = target.tag;
+    result.open = open;
+    result.error = error;
+    result.banner = banner;
+    result.proxy = proxy;
+    result.reason = reason;
+    result.holdTime = holdTime;
+    if (target.started != Clock::time_point()) {
+        result.responseTime =
+            std::chrono::duration<double, std::milli>(Clock::now() - target.started).count();
+    }
+    m_onResult(result);
+}
+
+void ProxyScanner::sweep() {
+    auto now = Clock::now();
+    std::vector<int> expired;
+    for (const auto& entry : m_probes) {
+        if (now >= entry.second->deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+
+    for (int fd : expired) {
+        auto it = m_probes.find(fd);
+        if (it == m_probes.end()) {
+            continue;
+        }
+        Probe& probe = *it->second;
+        switch (probe.phase) {
+            case Phase::CONNECTING:
+                finish(probe, Utils::ProxyOutcome::PROXY_FAILED, "", "Proxy connect timeout");
+                break;
+            case Phase::HANDSHAKE:
+                finish(probe, probe.handshake->timeoutOutcome(), "", "Tunnel timeout");
+                break;
+            case Phase::BANNER:
+                sendHttpProbe(probe);
+                break;
+            case Phase::HTTP_PROBE:
+                finish(probe, Utils::ProxyOutcome::ESTABLISHED, "", "");
+                break;
+        }
+    }
+}
+
+void ProxyScanner::abandon() {
+    auto& budget = Utils::SocketBudget::instance();
+    for (auto& entry : m_probes) {
+        int fd = entry.first;
+        if (m_loop.isWatched(fd)) {
+            m_loop.unwatch(fd);
+        }
+        budget.closeProbeSocket(fd);
+        budget.release();
+        m_pool.cancel(entry.second->proxy);
+    }
+    m_probes.clear();
+}
+
+} // namespace MindSploit::Network
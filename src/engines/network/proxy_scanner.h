@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../../utils/proxy_pool.h"
+#include "../../utils/event_loop.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+struct ProxyScanConfig {
+    std::chrono::milliseconds timeout{3000};        // 连接代理并建立隧道的时间
+    std::chrono::milliseconds bannerWait{1000};     // 隧道建立后等待横幅的时间，0为不采集横幅
+    int maxAttempts = 3;                            // 代理故障时换代理重试的总次数
+};
+
+struct ProxyProbeResult {
+    Utils::IPAddress target;
+    uint16_t port = 0;
+    uint64_t tag = 0;                               // 数据源给出的标记 (如排列索引)，原样返回
+    bool open = false;
+    bool error = false;                             // 所有尝试都因代理故障失败，端口状态未知
+    std::string banner;
+    std::string proxy;                              // 最后使用的代理
+    std::string reason;                             // 关闭或出错的原因
+    double responseTime = 0.0;                      // 毫秒，含隧道建立
+    double holdTime = 0.0;                          // 毫秒，隧道建立后等待横幅的时间
+};
+
+struct ProxyScanStats {
+    uint64_t probes = 0;
+    uint64_t open = 0;
+    uint64_t closed = 0;
+    uint64_t errors = 0;
+    uint64_t retries = 0;                           // 换代理重试次数
+    uint64_t banners = 0;
+    size_t peakInFlight = 0;
+};
+
+// 经代理池的连接扫描
+//
+// 每个 目标:端口 通过一个上游代理建立隧道 (SOCKS5 CONNECT或HTTP CONNECT)，隧道建立即为开放:
+//   - 所有探测在一个事件循环中并发，在途数受代理池各代理的并发上限和SocketBudget共同约束，
+//     吞吐随代理数增加，不再受限于单条串行隧道
+//   - 代理应答目标不可达/拒绝为关闭; 代理本身故障 (连接失败、协议错误、问候超时) 换另一个代理重试
+//   - 开放端口在同一条隧道上等待服务端横幅，没有横幅时发送一次HTTP HEAD请求，与直连的横幅采集一致
+class ProxyScanner {
+public:
+    // 返回false表示目标已取完
+    using Source = std::function<bool(Utils::IPAddress& target, uint16_t& port, uint64_t& tag)>;
+    using ResultHandler = std::function<void(const ProxyProbeResult& result)>;
+
+    ProxyScanner(Utils::EventLoop& loop, Utils::ProxyPool& pool, const ProxyScanConfig& config);
+    ~ProxyScanner();
+
+    ProxyScanner(const ProxyScanner&) = delete;
+    ProxyScanner& operator=(const ProxyScanner&) = delete;
+
+    void run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested);
+
+    ProxyScanStats getStats() const { return m_stats; }
+    // 所有代理都已永久停用，扫描提前结束
+    bool aborted() const { return m_aborted; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Phase {
+        CONNECTING,         // 连接代理
+        HANDSHAKE,          // 代理握手
+        BANNER,             // 隧道已建立，等待横幅
+        HTTP_PROBE          // 已发送HEAD请求，等待响应
+    };
+
+    struct Target {
+        Utils::IPAddress address;
+        uint16_t port = 0;
+        uint64_t tag = 0;
+        int attempts = 0;
+        int lastProxy = -1;                         // 上次失败的代理，重试时避开
+        Clock::time_point started;
+    };
+
+    struct Probe {
+        Target target;
+        int fd = -1;
+        int proxy = -1;
+        Phase phase = Phase::CONNECTING;
+        std::unique_ptr<Utils::ProxyHandshake> handshake;
+        Clock::time_point deadline;
+        Clock::time_point tunnelled;                // 隧道建立的时间
+    };
+
+    // 启动尽可能多的探测
+    void pump();
+    // 返回false表示暂时没有代理或套接字名额
+    bool start(const Target& target);
+    void onEvent(int fd, uint32_t events);
+    // 返回false表示探测已结束
+    bool flushHandshake(Probe& probe);
+    void readHandshake(Probe& probe);
+    void readBanner(Probe& probe);
+    void sendHttpProbe(Probe& probe);
+    void onTunnel(Probe& probe, const char* data, size_t length);
+    // 结束探测并释放代理和套接字; 代理故障且还有尝试次数时重新排队
+    void finish(Probe& probe, Utils::ProxyOutcome outcome, const std::string& banner, const std::string& reason);
+    void report(const Target& target, bool open, bool error, const std::string& banner,
+                const std::string& proxy, const std::string& reason, double holdTime = 0.0);
+    void sweep();
+    // 关闭全部在途探测，不报告结果
+    void abandon();
+
+private:
+    Utils::EventLoop& m_loop;
+    Utils::ProxyPool& m_pool;
+    ProxyScanConfig m_config;
+
+    Source m_source;
+    ResultHandler m_onResult;
+    bool m_sourceDone = false;
+    bool m_aborted = false;
+    std::deque<Target> m_queue;                     // 待启动的目标，重试的目标排在队首
+    std::unordered_map<int, std::unique_ptr<Probe>> m_probes;
+    ProxyScanStats m_stats;
+};
+
+} // namespace MindSploit::Network
@@ -0,0 +1,147 @@
+#include "scan_baseline.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+namespace MindSploit::Network {
+
+namespace {
+
+// 定位 "key": 之后的值起点
+size_t findValue(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\"";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) {
+        return std::string::npos;
+    }
+    pos = line.find_first_not_of(" \t", pos + pattern.size());
+    if (pos == std::string::npos || line[pos] != ':') {
+        return std::string::npos;
+    }
+    return line.find_first_not_of(" \t", pos + 1);
+}
+
+bool extractString(const std::string& line, const std::string& key, std::string& value) {
+    size_t pos = findValue(line, key);
+    if (pos == std::string::npos || line[pos] != '"') {
+        return false;
+    }
+
+    value.clear();
+    for (size_t i = pos + 1; i < line.size(); ++i) {
+        char c = line[i];
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\' || i + 1 >= line.size()) {
+            value += c;
+            continue;
+        }
+
+        char escaped = line[++i];
+        switch (escaped) {
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u':
+                // 结果文件只会对控制字符使用\u转义，非ASCII字符按'?'保留占位
+                if (i + 4 < line.size()) {
+                    unsigned long code = std::strtoul(line.substr(i + 1, 4).c_str(), nullptr, 16);
+                    value += code < 0x80 ? static_cast<char>(code) : '?';
+                    i += 4;
+                }
+                break;
+            default: value += escaped; break;
+        }
+    }
+    return false;
+}
+
+bool extractNumber(const std::string& line, const std::string& key, long& value) {
+    size_t pos = findValue(line, key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtol(line.c_str() + pos, &end, 10);
+    return end != line.c_str() + pos;
+}
+
+bool extractBool(const std::string& line, const std::string& key, bool& value) {
+    size_t pos = findValue(line, key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    if (line.compare(pos, 4, "true") == 0) {
+        value = true;
+        return true;
+    }
+    if (line.compare(pos, 5, "false") == 0) {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+size_t ScanBaseline::parse(const std::string& text) {
+    std::istringstream stream(text);
+    std::string line;
+    size_t parsed = 0;
+
+    while (std::getline(stream, line)) {
+        BaselineEntry entry;
+        long port;
+        if (!extractString(line, "ip", entry.ip) || !extractNumber(line, "port", port) ||
+            port <= 0 || port > 65535) {
+            continue;
+        }
+
+        bool open = true;
+        std::string change;
+        extractBool(line, "open", open);
+        extractString(line, "change", change);
+        if (!open || change == "closed") {
+            continue;
+        }
+
+        entry.port = static_cast<int>(port);
+        extractString(line, "service", entry.service);
+        extractString(line, "banner", entry.banner);
+        addEntry(std::move(entry));
+        ++parsed;
+    }
+
+    return parsed;
+}
+
+bool ScanBaseline::loadFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    parse(buffer.str());
+    return true;
+}
+
+const BaselineEntry* ScanBaseline::find(const std::string& ip, int port) const {
+    auto it = m_index.find(key(ip, port));
+    return it != m_index.end() ? &m_entries[it->second] : nullptr;
+}
+
+void ScanBaseline::addEntry(BaselineEntry entry) {
+    std::string entryKey = key(entry.ip, entry.port);
+    auto it = m_index.find(entryKey);
+    if (it != m_index.end()) {
+        // 同一端口出现多次时以后出现的记录为准
+        m_entries[it->second] = std::move(entry);
+        return;
+    }
+    m_index[entryKey] = m_entries.size();
+    m_entries.push_back(std::move(entry));
+}
+
+} // namespace MindSploit::Network
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+// 基线中的一条开放端口记录
+struct BaselineEntry {
+    std::string ip;
+    int port = 0;
+    std::string service;
+    std::string banner;
+};
+
+// 上一次扫描的已知状态，用于增量重扫
+//
+// 输入为JSON行，与 -output 文件及结果库中保存的记录格式相同:
+//   {"ip":"10.0.0.1","port":22,"open":true,"service":"ssh","banner":"SSH-2.0-..."}
+// 只保留开放记录，已关闭的变化记录 ("change":"closed") 被忽略。
+class ScanBaseline {
+public:
+    // 返回解析出的记录数
+    size_t parse(const std::string& text);
+    bool loadFile(const std::string& path);
+
+    const std::vector<BaselineEntry>& entries() const { return m_entries; }
+    const BaselineEntry* find(const std::string& ip, int port) const;
+    bool empty() const { return m_entries.empty(); }
+    size_t size() const { return m_entries.size(); }
+
+private:
+    void addEntry(BaselineEntry entry);
+    static std::string key(const std::string& ip, int port) { return ip + "|" + std::to_string(port); }
+
+private:
+    std::vector<BaselineEntry> m_entries;
+    std::unordered_map<std::string, size_t> m_index;
+};
+
+} // namespace MindSploit::Network
@@ -0,0 +1,475 @@
+#include "scan_coordinator.h"
+#include <algorithm>
+
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+namespace MindSploit::Network {
+
+namespace {
+
+// 剩余位置少于该值的租约不再拆分
+constexpr uint64_t MIN_STEAL_SPAN = 128;
+// 完成后等待DONE发送完毕的最长时间
+constexpr std::chrono::milliseconds FINISH_GRACE{2000};
+constexpr size_t RECEIVE_CHUNK = 64 * 1024;
+
+bool wouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+} // namespace
+
+ScanCoordinator::ScanCoordinator(const ScanJob& job, uint64_t cycleLength, const ScanCoordinatorConfig& config)
+    : m_job(job),
+      m_cycleLength(cycleLength),
+      m_config(config),
+      m_listener(config.listenAddress.isIPv6 ? AF_INET6 : AF_INET, SOCK_STREAM) {
+    m_config.blockSize = std::max<uint64_t>(1, m_config.blockSize);
+    m_config.leasesPerWorker = std::max<size_t>(1, m_config.leasesPerWorker);
+    if (m_cycleLength > 0) {
+        m_pending.emplace_back(0, m_cycleLength);
+    }
+}
+
+ScanCoordinator::~ScanCoordinator() {
+    for (const auto& entry : m_workers) {
+        m_loop.unwatch(entry.first);
+    }
+    if (m_listener.isValid()) {
+        m_loop.unwatch(m_listener.getHandle());
+    }
+}
+
+bool ScanCoordinator::listen(std::string& error) {
+    if (!m_loop.isValid() || !m_listener.isValid()) {
+        error = "Failed to create coordinator socket";
+        return false;
+    }
+
+    m_listener.setReuseAddress(true);
+    if (!m_listener.bind(m_config.listenAddress, m_config.listenPort) || !m_listener.listen(64)) {
+        error = "Failed to listen on " + m_config.listenAddress.toString() + ":" + std::to_string(m_config.listenPort);
+        return false;
+    }
+    m_listener.setNonBlocking(true);
+
+    m_loop.watch(m_listener.getHandle(), Utils::EventLoop::EVENT_READ, [this](uint32_t) { onAccept(); });
+    return true;
+}
+
+bool ScanCoordinator::run(const std::atomic<bool>& stopRequested) {
+    if (allWorkDone()) {
+        finish();
+    }
+    scheduleMaintenance();
+
+    while (!stopRequested) {
+        if (m_finished) {
+            bool flushed = std::all_of(m_workers.begin(), m_workers.end(),
+                                       [](const auto& entry) { return entry.second->output.empty(); });
+            if (flushed || Clock::now() >= m_finishDeadline) {
+                break;
+            }
+        }
+        m_loop.runOnce(std::chrono::milliseconds(200));
+    }
+
+    return m_finished;
+}
+
+void ScanCoordinator::onAccept() {
+    while (true) {
+        Utils::Socket client = m_listener.accept();
+        if (!client.isValid()) {
+            return;
+        }
+
+        client.setNonBlocking(true);
+        int fd = client.getHandle();
+        auto worker = std::make_unique<Worker>(std::move(client));
+        worker->lastSeen = Clock::now();
+        m_workers[fd] = std::move(worker);
+
+        m_loop.watch(fd, Utils::EventLoop::EVENT_READ, [this, fd](uint32_t events) { onWorkerEvent(fd, events); });
+    }
+}
+
+void ScanCoordinator::onWorkerEvent(int fd, uint32_t events) {
+    auto it = m_workers.find(fd);
+    if (it == m_workers.end()) {
+        return;
+    }
+    Worker& worker = *it->second;
+
+    if (events & Utils::EventLoop::EVENT_WRITE) {
+        if (!flush(worker)) {
+            dropWorker(fd, "发送失败");
+            return;
+        }
+    }
+
+    if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+        uint8_t buffer[RECEIVE_CHUNK];
+        auto received = worker.socket.receive(buffer, sizeof(buffer));
+        if (received == 0 || (received < 0 && !wouldBlock())) {
+            dropWorker(fd, "连接断开");
+            return;
+        }
+        if (received < 0) {
+            return;
+        }
+
+        worker.lastSeen = Clock::now();
+        worker.input.insert(worker.input.end(), buffer, buffer + received);
+
+        // 认证前只接受HELLO大小的帧
+        ScanMessageType type;
+        std::vector<uint8_t> payload;
+        size_t offset = 0;
+        int status;
+        while ((status = extractScanFrame(worker.input, offset, type, payload,
+                                          worker.ready ? SCAN_MAX_FRAME_SIZE : SCAN_MAX_HELLO_SIZE)) > 0) {
+            if (!handleMessage(worker, type, payload)) {
+                dropWorker(fd, "协议错误");
+                return;
+            }
+        }
+        if (status < 0) {
+            dropWorker(fd, "帧格式错误");
+            return;
+        }
+        worker.input.erase(worker.input.begin(), worker.input.begin() + offset);
+    }
+}
+
+bool ScanCoordinator::handleMessage(Worker& worker, ScanMessageType type, const std::vector<uint8_t>& payload) {
+    ScanMessageReader reader(payload.data(), payload.size());
+
+    if (!worker.ready && type != ScanMessageType::HELLO) {
+        return false;
+    }
+
+    switch (type) {
+        case ScanMessageType::HELLO: {
+            uint16_t version;
+            std::string token;
+            if (worker.ready || !reader.u16(version) || version != SCAN_PROTOCOL_VERSION ||
+                !reader.string(worker.name) || !reader.string(token)) {
+                return false;
+            }
+            if (!tokenMatches(token)) {
+                log("拒绝工作节点: " + worker.socket.getRemoteAddress().toString() + " (令牌不匹配)");
+                return false;
+            }
+            worker.ready = true;
+            ++m_stats.workersJoined;
+            log("工作节点加入: " + worker.name + " (" + worker.socket.getRemoteAddress().toString() + ")");
+
+            send(worker, encodeScanJob(m_job));
+            if (m_finished) {
+                send(worker, encodeScanDone());
+            } else {
+                assignWork(worker);
+            }
+            return true;
+        }
+
+        case ScanMessageType::RESULT: {
+            uint32_t leaseId, count;
+            if (!reader.u32(leaseId) || !reader.u32(count) || reader.remaining() != static_cast<size_t>(count) * 8) {
+                return false;
+            }
+            // 租约被回收或拆分后结果仍然有效，按索引去重即可
+            for (uint32_t i = 0; i < count; ++i) {
+                uint64_t index;
+                reader.u64(index);
+                if (index >= m_job.size) {
+                    return false;
+                }
+                if (!m_openIndices.insert(index).second) {
+                    ++m_stats.duplicates;
+                    continue;
+                }
+                ++m_stats.openResults;
+                if (m_resultHandler) {
+                    m_resultHandler(index);
+                }
+            }
+            return true;
+        }
+
+        case ScanMessageType::PROGRESS: {
+            uint32_t leaseId;
+            uint64_t position, probed;
+            if (!reader.u32(leaseId) || !reader.u64(position) || !reader.u64(probed)) {
+                return false;
+            }
+            auto it = m_leases.find(leaseId);
+            if (it != m_leases.end() && it->second.owner == worker.socket.getHandle()) {
+                // 截断通知晚到时持有者可能越过新终点，按终点截取
+                it->second.position = std::max(it->second.position, std::min(position, it->second.end));
+                it->second.probed = probed;
+            }
+            return true;
+        }
+
+        case ScanMessageType::COMPLETE: {
+            uint32_t leaseId;
+            uint64_t probed;
+            if (!reader.u32(leaseId) || !reader.u64(probed)) {
+                return false;
+            }
+            auto it = m_leases.find(leaseId);
+            if (it != m_leases.end() && it->second.owner == worker.socket.getHandle()) {
+                it->second.probed = probed;
+                completeLease(leaseId);
+                assignWork(worker);
+                if (allWorkDone()) {
+                    finish();
+                }
+            }
+            return true;
+        }
+
+        default:
+            // 协调节点发出的消息类型不应出现在这里
+            return false;
+    }
+}
+
+bool ScanCoordinator::tokenMatches(const std::string& token) const {
+    // 比较时间与不匹配的位置无关
+    const std::string& expected = m_config.token;
+    uint8_t difference = token.size() == expected.size() ? 0 : 1;
+    for (size_t i = 0; i < token.size(); ++i) {
+        difference |= static_cast<uint8_t>(token[i] ^ expected[i % std::max<size_t>(1, expected.size())]);
+    }
+    return difference == 0;
+}
+
+void ScanCoordinator::dropWorker(int fd, const std::string& reason) {
+    auto it = m_workers.find(fd);
+    if (it == m_workers.end()) {
+        return;
+    }
+
+    std::unique_ptr<Worker> worker = std::move(it->second);
+    m_workers.erase(it);
+    m_loop.unwatch(fd);
+
+    if (worker->ready) {
+        ++m_stats.workersLost;
+        log("工作节点离开: " + worker->name + " (" + reason + ")");
+    }
+
+    // 从最后上报的位置起回收未完成区间
+    for (uint32_t id : worker->leases) {
+        auto leaseIt = m_leases.find(id);
+        if (leaseIt == m_leases.end()) {
+            continue;
+        }
+        const Lease& lease = leaseIt->second;
+        if (lease.position < lease.end) {
+            requeue(lease.position, lease.end);
+            ++m_stats.leasesRequeued;
+        }
+        m_stats.probed += lease.probed;
+        m_leases.erase(leaseIt);
+    }
+    worker.reset();
+
+    if (m_finished) {
+        return;
+    }
+    for (auto& entry : m_workers) {
+        if (entry.second->ready) {
+            assignWork(*entry.second);
+        }
+    }
+}
+
+void ScanCoordinator::assignWork(Worker& worker) {
+    if (m_finished) {
+        return;
+    }
+
+    while (worker.leases.size() < m_config.leasesPerWorker) {
+        ScanLease lease;
+        if (!takePending(lease) && !stealWork(worker, lease)) {
+            break;
+        }
+
+        Lease entry;
+        entry.id = lease.id;
+        entry.owner = worker.socket.getHandle();
+        entry.begin = lease.begin;
+        entry.end = lease.end;
+        entry.position = lease.begin;
+        m_leases[lease.id] = entry;
+
+        // 空闲节点重新开始计时，避免等待期间被判定失联
+        if (worker.leases.empty()) {
+            worker.lastSeen = Clock::now();
+        }
+        worker.leases.push_back(lease.id);
+        ++m_stats.leasesIssued;
+        send(worker, encodeScanLease(lease));
+    }
+}
+
+bool ScanCoordinator::takePending(ScanLease& lease) {
+    if (m_pending.empty()) {
+        return false;
+    }
+
+    auto& range = m_pending.front();
+    lease.id = m_nextLeaseId++;
+    lease.begin = range.first;
+    lease.end = std::min(range.second, range.first + m_config.blockSize);
+    range.first = lease.end;
+    if (range.first >= range.second) {
+        m_pending.pop_front();
+    }
+    return true;
+}
+
+bool ScanCoordinator::stealWork(const Worker& thief, ScanLease& lease) {
+    int thiefFd = thief.socket.getHandle();
+    Lease* victim = nullptr;
+    for (auto& entry : m_leases) {
+        Lease& candidate = entry.second;
+        if (candidate.owner == thiefFd || candidate.end - candidate.position < MIN_STEAL_SPAN * 2) {
+            continue;
+        }
+        if (!victim || candidate.end - candidate.position > victim->end - victim->position) {
+            victim = &candidate;
+        }
+    }
+    if (!victim) {
+        return false;
+    }
+
+    uint64_t middle = victim->position + (victim->end - victim->position) / 2;
+    lease.id = m_nextLeaseId++;
+    lease.begin = middle;
+    lease.end = victim->end;
+    victim->end = middle;
+    ++m_stats.steals;
+
+    auto ownerIt = m_workers.find(victim->owner);
+    if (ownerIt != m_workers.end()) {
+        send(*ownerIt->second, encodeScanTruncate(victim->id, middle));
+    }
+    return true;
+}
+
+void ScanCoordinator::completeLease(uint32_t id) {
+    auto it = m_leases.find(id);
+    if (it == m_leases.end()) {
+        return;
+    }
+
+    m_stats.probed += it->second.probed;
+    auto ownerIt = m_workers.find(it->second.owner);
+    if (ownerIt != m_workers.end()) {
+        auto& leases = ownerIt->second->leases;
+        leases.erase(std::remove(leases.begin(), leases.end(), id), leases.end());
+    }
+    m_leases.erase(it);
+}
+
+void ScanCoordinator::requeue(uint64_t begin, uint64_t end) {
+    // 回收的区间优先分配，尽快补齐扫描进度
+    m_pending.emplace_front(begin, end);
+}
+
+void ScanCoordinator::send(Worker& worker, const std::vector<uint8_t>& frame) {
+    bool wasIdle = worker.output.empty();
+    worker.output.insert(worker.output.end(), frame.begin(), frame.end());
+    if (wasIdle) {
+        // 立即尝试发送，写不完再等待可写事件；失败由读事件发现断开
+        flush(worker);
+    }
+}
+
+bool ScanCoordinator::flush(Worker& worker) {
+    size_t sent = 0;
+    while (sent < worker.output.size()) {
+        auto result = worker.socket.send(worker.output.data() + sent, worker.output.size() - sent);
+        if (result < 0) {
+            if (!wouldBlock()) {
+                worker.output.clear();
+                return false;
+            }
+            break;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    worker.output.erase(worker.output.begin(), worker.output.begin() + sent);
+
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (!worker.output.empty()) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(worker.socket.getHandle(), events);
+    return true;
+}
+
+void ScanCoordinator::scheduleMaintenance() {
+    m_loop.addTimer(std::chrono::milliseconds(1000), [this] {
+        maintenance();
+        scheduleMaintenance();
+    });
+}
+
+void ScanCoordinator::maintenance() {
+    if (m_finished) {
+        return;
+    }
+
+    // 持有租约却长时间没有消息的节点视为失联
+    auto now = Clock::now();
+    std::vector<int> expired;
+    for (const auto& entry : m_workers) {
+        const Worker& worker = *entry.second;
+        bool holdsWork = !worker.leases.empty() || !worker.ready;
+        if (holdsWork && now - worker.lastSeen > m_config.workerTimeout) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        dropWorker(fd, "超时");
+    }
+
+    // 租约推进后可能出现新的可拆分区间
+    for (auto& entry : m_workers) {
+        if (entry.second->ready && entry.second->leases.size() < m_config.leasesPerWorker) {
+            assignWork(*entry.second);
+        }
+    }
+}
+
+void ScanCoordinator::finish() {
+    m_finished = true;
+    m_finishDeadline = Clock::now() + FINISH_GRACE;
+    for (auto& entry : m_workers) {
+        if (entry.second->ready) {
+            send(*entry.second, encodeScanDone());
+        }
+    }
+    log("全部租约已完成");
+}
+
+void ScanCoordinator::log(const std::string& message) {
+    if (m_logHandler) {
+        m_logHandler(message);
+    }
+}
+
+} // namespace MindSploit::Network
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "scan_protocol.h"
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_set>
+
+namespace MindSploit::Network {
+
+// 协调节点配置
+struct ScanCoordinatorConfig {
+    Utils::IPAddress listenAddress{"127.0.0.1"};         // 默认只接受本机工作节点
+    uint16_t listenPort = 7878;
+    std::string token;                                  // 共享令牌，工作节点的HELLO必须携带相同令牌
+    uint64_t blockSize = 4096;                          // 每个租约的循环位置数
+    size_t leasesPerWorker = 2;                         // 每个工作节点预取的租约数
+    std::chrono::milliseconds workerTimeout{30000};     // 持有租约的节点静默超过该时间即视为失联
+};
+
+// 协调统计
+struct ScanCoordinatorStats {
+    size_t workersJoined = 0;
+    size_t workersLost = 0;
+    size_t leasesIssued = 0;
+    size_t leasesRequeued = 0;      // 因节点失联而回收的租约
+    size_t steals = 0;              // 空闲节点从慢节点分走的租约
+    uint64_t probed = 0;
+    uint64_t openResults = 0;
+    uint64_t duplicates = 0;        // 重复探测产生的重复结果 (已去重)
+};
+
+// 扫描协调节点
+//
+// 把排列循环 [0, cycleLength) 按块租给工作节点，汇总并去重结果。
+// 节点失联时从最后上报的位置起回收剩余区间；节点空闲而没有待分配块时，
+// 把剩余最多的租约从中点一分为二，后半段交给空闲节点，并通知原持有者截断。
+class ScanCoordinator {
+public:
+    using ResultHandler = std::function<void(uint64_t index)>;
+    using LogHandler = std::function<void(const std::string& message)>;
+
+    ScanCoordinator(const ScanJob& job, uint64_t cycleLength, const ScanCoordinatorConfig& config);
+    ~ScanCoordinator();
+
+    ScanCoordinator(const ScanCoordinator&) = delete;
+    ScanCoordinator& operator=(const ScanCoordinator&) = delete;
+
+    void setResultHandler(ResultHandler handler) { m_resultHandler = std::move(handler); }
+    void setLogHandler(LogHandler handler) { m_logHandler = std::move(handler); }
+
+    bool listen(std::string& error);
+    uint16_t listenPort() const { return m_listener.getLocalPort(); }
+
+    // 运行直到全部区间完成或stopRequested置位，返回是否完成
+    bool run(const std::atomic<bool>& stopRequested);
+
+    ScanCoordinatorStats getStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Lease {
+        uint32_t id = 0;
+        int owner = -1;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        uint64_t position = 0;      // 持有者最后上报的下一个待探测位置
+        uint64_t probed = 0;
+    };
+
+    struct Worker {
+        explicit Worker(Utils::Socket&& sock) : socket(std::move(sock)) {}
+
+        Utils::Socket socket;
+        std::string name;
+        bool ready = false;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        std::vector<uint32_t> leases;
+        Clock::time_point lastSeen;
+    };
+
+    void onAccept();
+    void onWorkerEvent(int fd, uint32_t events);
+    bool handleMessage(Worker& worker, ScanMessageType type, const std::vector<uint8_t>& payload);
+    bool tokenMatches(const std::string& token) const;
+    void dropWorker(int fd, const std::string& reason);
+
+    void assignWork(Worker& worker);
+    bool takePending(ScanLease& lease);
+    bool stealWork(const Worker& thief, ScanLease& lease);
+    void completeLease(uint32_t id);
+    void requeue(uint64_t begin, uint64_t end);
+
+    void send(Worker& worker, const std::vector<uint8_t>& frame);
+    bool flush(Worker& worker);
+    void scheduleMaintenance();
+    void maintenance();
+    void finish();
+    bool allWorkDone() const { return m_pending.empty() && m_leases.empty(); }
+    void log(const std::string& message);
+
+private:
+    ScanJob m_job;
+    uint64_t m_cycleLength;
+    ScanCoordinatorConfig m_config;
+
+    Utils::EventLoop m_loop;
+    Utils::Socket m_listener;
+    std::map<int, std::unique_ptr<Worker>> m_workers;
+
+    std::deque<std::pair<uint64_t, uint64_t>> m_pending;   // 待分配的位置区间
+    std::map<uint32_t, Lease> m_leases;
+    uint32_t m_nextLeaseId = 1;
+
+    std::unordered_set<uint64_t> m_openIndices;
+    ScanCoordinatorStats m_stats;
+    ResultHandler m_resultHandler;
+    LogHandler m_logHandler;
+
+    bool m_finished = false;
+    Clock::time_point m_finishDeadline;
+};
+
+} // namespace MindSploit::Network
@@ -0,0 +1,193 @@
+#include "scan_protocol.h"
+#include <algorithm>
+
+namespace MindSploit::Network {
+
+ScanMessageWriter::ScanMessageWriter(ScanMessageType type) {
+    m_buffer.reserve(64);
+    m_buffer.push_back(static_cast<uint8_t>(type));
+    m_buffer.resize(SCAN_FRAME_HEADER_SIZE, 0);
+}
+
+ScanMessageWriter& ScanMessageWriter::u8(uint8_t value) {
+    m_buffer.push_back(value);
+    return *this;
+}
+
+ScanMessageWriter& ScanMessageWriter::u16(uint16_t value) {
+    m_buffer.push_back(static_cast<uint8_t>(value >> 8));
+    m_buffer.push_back(static_cast<uint8_t>(value));
+    return *this;
+}
+
+ScanMessageWriter& ScanMessageWriter::u32(uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        m_buffer.push_back(static_cast<uint8_t>(value >> shift));
+    }
+    return *this;
+}
+
+ScanMessageWriter& ScanMessageWriter::u64(uint64_t value) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        m_buffer.push_back(static_cast<uint8_t>(value >> shift));
+    }
+    return *this;
+}
+
+ScanMessageWriter& ScanMessageWriter::string(const std::string& value) {
+    u32(static_cast<uint32_t>(value.size()));
+    m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+    return *this;
+}
+
+std::vector<uint8_t> ScanMessageWriter::finish() {
+    uint32_t length = static_cast<uint32_t>(m_buffer.size() - SCAN_FRAME_HEADER_SIZE);
+    m_buffer[1] = static_cast<uint8_t>(length >> 24);
+    m_buffer[2] = static_cast<uint8_t>(length >> 16);
+    m_buffer[3] = static_cast<uint8_t>(length >> 8);
+    m_buffer[4] = static_cast<uint8_t>(length);
+    return std::move(m_buffer);
+}
+
+bool ScanMessageReader::read(uint8_t* out, size_t length) {
+    if (remaining() < length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        out[i] = m_data[m_offset + i];
+    }
+    m_offset += length;
+    return true;
+}
+
+bool ScanMessageReader::u8(uint8_t& value) {
+    return read(&value, 1);
+}
+
+bool ScanMessageReader::u16(uint16_t& value) {
+    uint8_t bytes[2];
+    if (!read(bytes, sizeof(bytes))) return false;
+    value = static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+    return true;
+}
+
+bool ScanMessageReader::u32(uint32_t& value) {
+    uint8_t bytes[4];
+    if (!read(bytes, sizeof(bytes))) return false;
+    value = 0;
+    for (uint8_t b : bytes) value = (value << 8) | b;
+    return true;
+}
+
+bool ScanMessageReader::u64(uint64_t& value) {
+    uint8_t bytes[8];
+    if (!read(bytes, sizeof(bytes))) return false;
+    value = 0;
+    for (uint8_t b : bytes) value = (value << 8) | b;
+    return true;
+}
+
+bool ScanMessageReader::string(std::string& value) {
+    uint32_t length;
+    if (!u32(length) || remaining() < length) {
+        return false;
+    }
+    value.assign(reinterpret_cast<const char*>(m_data + m_offset), length);
+    m_offset += length;
+    return true;
+}
+
+int extractScanFrame(const std::vector<uint8_t>& buffer, size_t& offset, ScanMessageType& type,
+                     std::vector<uint8_t>& payload, size_t maxLength) {
+    if (buffer.size() < offset + SCAN_FRAME_HEADER_SIZE) {
+        return 0;
+    }
+
+    const uint8_t* header = buffer.data() + offset;
+    uint32_t length = (static_cast<uint32_t>(header[1]) << 24) | (static_cast<uint32_t>(header[2]) << 16) |
+                      (static_cast<uint32_t>(header[3]) << 8) | header[4];
+    if (header[0] < static_cast<uint8_t>(ScanMessageType::HELLO) ||
+        header[0] > static_cast<uint8_t>(ScanMessageType::DONE) ||
+        length > std::min(maxLength, SCAN_MAX_FRAME_SIZE)) {
+        return -1;
+    }
+    if (buffer.size() - offset < SCAN_FRAME_HEADER_SIZE + length) {
+        return 0;
+    }
+
+    type = static_cast<ScanMessageType>(header[0]);
+    payload.assign(header + SCAN_FRAME_HEADER_SIZE, header + SCAN_FRAME_HEADER_SIZE + length);
+    offset += SCAN_FRAME_HEADER_SIZE + length;
+    return 1;
+}
+
+std::vector<uint8_t> encodeScanHello(const std::string& name, const std::string& token) {
+    return ScanMessageWriter(ScanMessageType::HELLO).u16(SCAN_PROTOCOL_VERSION).string(name).string(token).finish();
+}
+
+std::vector<uint8_t> encodeScanJob(const ScanJob& job) {
+    ScanMessageWriter writer(ScanMessageType::JOB);
+    writer.u16(SCAN_PROTOCOL_VERSION).u64(job.seed).u64(job.size).string(job.target);
+    writer.u32(static_cast<uint32_t>(job.ports.size()));
+    for (int port : job.ports) {
+        writer.u16(static_cast<uint16_t>(port));
+    }
+    return writer.finish();
+}
+
+std::vector<uint8_t> encodeScanLease(const ScanLease& lease) {
+    return ScanMessageWriter(ScanMessageType::LEASE).u32(lease.id).u64(lease.begin).u64(lease.end).finish();
+}
+
+std::vector<uint8_t> encodeScanTruncate(uint32_t leaseId, uint64_t end) {
+    return ScanMessageWriter(ScanMessageType::TRUNCATE).u32(leaseId).u64(end).finish();
+}
+
+std::vector<uint8_t> encodeScanResult(uint32_t leaseId, const std::vector<uint64_t>& indices) {
+    ScanMessageWriter writer(ScanMessageType::RESULT);
+    writer.u32(leaseId).u32(static_cast<uint32_t>(indices.size()));
+    for (uint64_t index : indices) {
+        writer.u64(index);
+    }
+    return writer.finish();
+}
+
+std::vector<uint8_t> encodeScanProgress(uint32_t leaseId, uint64_t position, uint64_t probed) {
+    return ScanMessageWriter(ScanMessageType::PROGRESS).u32(leaseId).u64(position).u64(probed).finish();
+}
+
+std::vector<uint8_t> encodeScanComplete(uint32_t leaseId, uint64_t probed) {
+    return ScanMessageWriter(ScanMessageType::COMPLETE).u32(leaseId).u64(probed).finish();
+}
+
+std::vector<uint8_t> encodeScanDone() {
+    return ScanMessageWriter(ScanMessageType::DONE).finish();
+}
+
+bool decodeScanJob(const std::vector<uint8_t>& payload, ScanJob& job) {
+    ScanMessageReader reader(payload.data(), payload.size());
+    uint16_t version;
+    uint32_t portCount;
+    if (!reader.u16(version) || version != SCAN_PROTOCOL_VERSION ||
+        !reader.u64(job.seed) || !reader.u64(job.size) ||
+        !reader.string(job.target) || !reader.u32(portCount) ||
+        reader.remaining() != static_cast<size_t>(portCount) * 2) {
+        return false;
+    }
+
+    job.ports.clear();
+    job.ports.reserve(portCount);
+    for (uint32_t i = 0; i < portCount; ++i) {
+        uint16_t port;
+        reader.u16(port);
+        job.ports.push_back(port);
+    }
+    return true;
+}
+
+bool decodeScanLease(const std::vector<uint8_t>& payload, ScanLease& lease) {
+    ScanMessageReader reader(payload.data(), payload.size());
+    return reader.u32(lease.id) && reader.u64(lease.begin) && reader.u64(lease.end) && lease.begin <= lease.end;
+}
+
+} // namespace MindSploit::Network
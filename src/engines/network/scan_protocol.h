@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace MindSploit::Network {
+
+// 协调节点/工作节点之间的二进制协议
+//
+// 帧格式: [类型 u8][负载长度 u32][负载]，整数均为网络字节序。
+// 工作单元是排列循环位置区间 [begin, end)，双方由(目标, 端口, 种子)各自重建同一排列，
+// 因此租约和结果只需传输位置和索引。
+constexpr uint16_t SCAN_PROTOCOL_VERSION = 2;
+constexpr size_t SCAN_FRAME_HEADER_SIZE = 5;
+constexpr size_t SCAN_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+// 认证前 (HELLO) 的帧长度上限，未通过令牌校验的连接不能让协调节点缓存大帧
+constexpr size_t SCAN_MAX_HELLO_SIZE = 1024;
+
+enum class ScanMessageType : uint8_t {
+    HELLO = 1,      // W->C 版本, 节点名, 共享令牌
+    JOB = 2,        // C->W 版本, 种子, 空间大小, 目标描述, 端口列表
+    LEASE = 3,      // C->W 租约号, 起点, 终点
+    TRUNCATE = 4,   // C->W 租约号, 新终点 (再平衡或回收)
+    RESULT = 5,     // W->C 租约号, 开放索引列表
+    PROGRESS = 6,   // W->C 租约号, 当前位置, 已探测数
+    COMPLETE = 7,   // W->C 租约号, 已探测数
+    DONE = 8        // C->W 扫描结束
+};
+
+// 扫描任务描述
+struct ScanJob {
+    uint64_t seed = 0;
+    uint64_t size = 0;              // 目标×端口空间大小，工作节点据此校验重建结果
+    std::string target;
+    std::vector<int> ports;
+};
+
+// 租约
+struct ScanLease {
+    uint32_t id = 0;
+    uint64_t begin = 0;
+    uint64_t end = 0;
+};
+
+// 消息编码
+class ScanMessageWriter {
+public:
+    explicit ScanMessageWriter(ScanMessageType type);
+
+    ScanMessageWriter& u8(uint8_t value);
+    ScanMessageWriter& u16(uint16_t value);
+    ScanMessageWriter& u32(uint32_t value);
+    ScanMessageWriter& u64(uint64_t value);
+    ScanMessageWriter& string(const std::string& value);
+
+    // 补全帧头并返回完整帧
+    std::vector<uint8_t> finish();
+
+private:
+    std::vector<uint8_t> m_buffer;
+};
+
+// 消息解码，越界读取返回false
+class ScanMessageReader {
+public:
+    ScanMessageReader(const uint8_t* data, size_t length) : m_data(data), m_length(length) {}
+
+    bool u8(uint8_t& value);
+    bool u16(uint16_t& value);
+    bool u32(uint32_t& value);
+    bool u64(uint64_t& value);
+    bool string(std::string& value);
+    size_t remaining() const { return m_length - m_offset; }
+
+private:
+    bool read(uint8_t* out, size_t length);
+
+    const uint8_t* m_data;
+    size_t m_length;
+    size_t m_offset = 0;
+};
+
+// 从接收缓冲区的offset处取出一帧并前移offset: 返回1取出成功, 0数据不足, -1帧格式错误或超过maxLength
+// 缓冲区不在逐帧时搬移，调用方处理完一次接收后再删除offset之前的数据
+int extractScanFrame(const std::vector<uint8_t>& buffer, size_t& offset, ScanMessageType& type,
+                     std::vector<uint8_t>& payload, size_t maxLength = SCAN_MAX_FRAME_SIZE);
+
+// 常用消息
+std::vector<uint8_t> encodeScanHello(const std::string& name, const std::string& token);
+std::vector<uint8_t> encodeScanJob(const ScanJob& job);
+std::vector<uint8_t> encodeScanLease(const ScanLease& lease);
+std::vector<uint8_t> encodeScanTruncate(uint32_t leaseId, uint64_t end);
+std::vector<uint8_t> encodeScanResult(uint32_t leaseId, const std::vector<uint64_t>& indices);
+std::vector<uint8_t> encodeScanProgress(uint32_t leaseId, uint64_t position, uint64_t probed);
+std::vector<uint8_t> encodeScanComplete(uint32_t leaseId, uint64_t probed);
+std::vector<uint8_t> encodeScanDone();
+
+bool decodeScanJob(const std::vector<uint8_t>& payload, ScanJob& job);
+bool decodeScanLease(const std::vector<uint8_t>& payload, ScanLease& lease);
+
+} // namespace MindSploit::Network
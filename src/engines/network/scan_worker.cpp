@@ -0,0 +1,402 @@
+#include "scan_worker.h"
+#include "liveness_tracker.h"
+#include "host_guard.h"
+#include <algorithm>
+
+#ifndef _WIN32
+#include <errno.h>
+#endif
+
+namespace MindSploit::Network {
+
+namespace {
+
+// 定时检查停止标志，每REPORT_INTERVAL回传一次进度
+constexpr std::chrono::milliseconds TICK_INTERVAL{100};
+constexpr std::chrono::milliseconds REPORT_INTERVAL{500};
+constexpr std::chrono::milliseconds IDLE_WAIT{200};
+constexpr size_t RECEIVE_CHUNK = 64 * 1024;
+
+bool wouldBlock() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+} // namespace
+
+ScanWorker::ScanWorker(const std::string& name, const std::string& token)
+    : m_name(name), m_token(token), m_socket(AF_INET, SOCK_STREAM) {}
+
+ScanWorker::~ScanWorker() {
+    if (m_socket.isValid() && m_loop.isWatched(m_socket.getHandle())) {
+        m_loop.unwatch(m_socket.getHandle());
+    }
+}
+
+bool ScanWorker::connect(const Utils::IPAddress& address, uint16_t port, std::string& error) {
+    if (address.isIPv6) {
+        m_socket = Utils::Socket(AF_INET6, SOCK_STREAM);
+    }
+    if (!m_socket.isValid() || !m_socket.connect(address, port, std::chrono::milliseconds(5000))) {
+        error = "Failed to connect to coordinator " + address.toString() + ":" + std::to_string(port);
+        return false;
+    }
+
+    if (m_name.empty()) {
+        m_name = m_socket.getLocalAddress().toString() + ":" + std::to_string(m_socket.getLocalPort());
+    }
+    return true;
+}
+
+bool ScanWorker::run(const Backend& backend, const std::atomic<bool>& stopRequested, std::string& error) {
+    if (!m_loop.isValid()) {
+        error = "Failed to create event loop";
+        return false;
+    }
+    int handle = m_socket.getHandle();
+    if (!m_socket.setNonBlocking(true) ||
+        !m_loop.watch(handle, Utils::EventLoop::EVENT_READ, [this](uint32_t events) { onCoordinatorEvent(events); })) {
+        error = "Failed to watch coordinator connection";
+        return false;
+    }
+    sendFrame(encodeScanHello(m_name, m_token));
+
+    // 协调节点的消息和所有探测在同一事件循环中处理; 有租约时由探测后端驱动循环
+    m_lastReport = Clock::now();
+    scheduleTick(stopRequested);
+
+    while (!m_halt && !m_done) {
+        if (m_leases.empty()) {
+            m_loop.runOnce(IDLE_WAIT);
+            continue;
+        }
+        // 后端取完目标后返回; 期间到达的新租约在下一轮开始探测
+        backend([this](Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+            return nextProbe(target, port, tag);
+        }, [this](const LeaseProbeResult& result) {
+            onResult(result);
+        }, m_halt);
+    }
+
+    m_inFlight.clear();
+    m_loop.cancelTimer(m_tickTimer);
+    m_loop.unwatch(handle);
+    if (!m_error.empty()) {
+        error = m_error;
+        return false;
+    }
+    return m_done;
+}
+
+bool ScanWorker::nextProbe(Utils::IPAddress& target, uint16_t& port, uint64_t& tag) {
+    // 按租约分配顺序取; 租约的光标走完后补做其中被推迟的探测点
+    for (auto it = m_leases.begin(); it != m_leases.end();) {
+        Lease& lease = it->second;
+        uint32_t leaseId = it->first;
+        ++it;   // settle可能删除该租约
+
+        uint64_t index;
+        while (!lease.drained) {
+            if (!lease.cursor.next(index)) {
+                lease.drained = true;
+                break;
+            }
+            lease.slots.push_back({lease.cursor.position(), index, false});
+            Slot& slot = lease.slots.back();
+            Utils::IPAddress host = m_space->hostAt(m_space->hostIndexOf(index));
+            ProbeDecision decision = m_liveness ? m_liveness->admit(host, index) : ProbeDecision::PROBE;
+            if (decision == ProbeDecision::DEFER) {
+                lease.deferred.push_back(&slot);
+            } else if (decision == ProbeDecision::SKIP) {
+                skip(slot);
+            } else if (issue(lease, slot, host, target, port, tag)) {
+                return true;
+            }
+        }
+
+        while (!lease.deferred.empty()) {
+            Slot& slot = *lease.deferred.front();
+            lease.deferred.pop_front();
+            if (slot.done) {
+                continue;
+            }
+            Utils::IPAddress host = m_space->hostAt(m_space->hostIndexOf(slot.index));
+            if (!m_liveness->admitDeferred(host, slot.index)) {
+                skip(slot);
+            } else if (issue(lease, slot, host, target, port, tag)) {
+                return true;
+            }
+        }
+
+        settle(leaseId);
+    }
+    return false;
+}
+
+bool ScanWorker::issue(Lease& lease, Slot& slot, const Utils::IPAddress& host, Utils::IPAddress& target,
+                       uint16_t& port, uint64_t& tag) {
+    if (m_guard && !m_guard->admit(host.toString())) {
+        skip(slot);
+        return false;
+    }
+    target = host;
+    port = static_cast<uint16_t>(m_space->portAt(slot.index));
+    tag = slot.index;
+    m_inFlight[slot.index] = {lease.id, &slot};
+    ++lease.probed;
+    ++m_stats.probed;
+    return true;
+}
+
+void ScanWorker::skip(Slot& slot) {
+    slot.done = true;
+    ++m_stats.skipped;
+}
+
+void ScanWorker::onResult(const LeaseProbeResult& result) {
+    auto it = m_inFlight.find(result.tag);
+    if (it == m_inFlight.end()) {
+        return;
+    }
+    uint32_t leaseId = it->second.first;
+    Slot& slot = *it->second.second;
+    m_inFlight.erase(it);
+
+    if (m_liveness) {
+        if (result.answered) {
+            m_liveness->recordAlive(result.target);
+        } else {
+            m_liveness->recordTimeout(result.target);
+        }
+    }
+
+    auto lease = m_leases.find(leaseId);
+    if (result.open && lease != m_leases.end()) {
+        std::string host = result.target.toString();
+        bool tarpit = false;
+        if (m_guard) {
+            bool wasFlagged = m_guard->flagged(host);
+            m_guard->recordOpen(host, result.responseTime, -1);
+            if (result.holdTime > 0.0 || result.banner) {
+                m_guard->recordSpent(host, result.holdTime, result.banner);
+            }
+            if (!wasFlagged && m_guard->flagged(host)) {
+                log("主机 " + host + " 疑似tarpit/蜜罐 (" + hostVerdictName(m_guard->verdict(host)) + ")，后续探测抽样进行");
+            }
+            tarpit = m_guard->isTarpit(host);
+        }
+        if (tarpit) {
+            ++m_stats.suppressed;
+        } else if (slot.position <= lease->second.cursor.end()) {
+            // 截断点之后的位置已交给其它工作节点，由它报告
+            lease->second.open.push_back(slot.index);
+            ++m_stats.open;
+        }
+    }
+
+    slot.done = true;
+    settle(leaseId);
+}
+
+void ScanWorker::settle(uint32_t leaseId) {
+    auto it = m_leases.find(leaseId);
+    if (it == m_leases.end()) {
+        return;
+    }
+    Lease& lease = it->second;
+    while (!lease.slots.empty() && lease.slots.front().done) {
+        lease.completed = lease.slots.front().position;
+        lease.slots.pop_front();
+    }
+    if (!lease.drained || !lease.deferred.empty() || !lease.slots.empty()) {
+        return;
+    }
+
+    report(lease);
+    sendFrame(encodeScanComplete(lease.id, lease.probed));
+    m_leases.erase(it);
+}
+
+void ScanWorker::onCoordinatorEvent(uint32_t events) {
+    if (events & Utils::EventLoop::EVENT_WRITE) {
+        flush();
+    }
+
+    if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+        uint8_t buffer[RECEIVE_CHUNK];
+        auto received = m_socket.receive(buffer, sizeof(buffer));
+        if (received == 0 || (received < 0 && !wouldBlock())) {
+            fail("Coordinator closed the connection");
+            return;
+        }
+        if (received < 0) {
+            return;
+        }
+        m_input.insert(m_input.end(), buffer, buffer + received);
+
+        ScanMessageType type;
+        std::vector<uint8_t> payload;
+        size_t offset = 0;
+        int status;
+        while ((status = extractScanFrame(m_input, offset, type, payload)) > 0) {
+            if (!handleMessage(type, payload)) {
+                return;
+            }
+        }
+        if (status < 0) {
+            fail("Malformed frame from coordinator");
+            return;
+        }
+        m_input.erase(m_input.begin(), m_input.begin() + offset);
+    }
+}
+
+bool ScanWorker::handleMessage(ScanMessageType type, const std::vector<uint8_t>& payload) {
+    switch (type) {
+        case ScanMessageType::JOB: {
+            if (!decodeScanJob(payload, m_job)) {
+                fail("Unsupported job description (protocol version mismatch?)");
+                return false;
+            }
+
+            // 各节点独立重建目标空间，大小不一致说明主机名解析结果不同
+            auto space = std::make_unique<Utils::TargetSpace>();
+            if (!space->addTargets(m_job.target)) {
+                fail("Failed to parse job target: " + m_job.target);
+                return false;
+            }
+            space->setPorts(m_job.ports);
+            if (space->size() != m_job.size) {
+                fail("Target space mismatch with coordinator");
+                return false;
+            }
+            m_space = std::move(space);
+            m_permutation = std::make_unique<Utils::TargetPermutation>(m_job.size, m_job.seed);
+            log("已接收任务: " + m_job.target + " (" + std::to_string(m_job.size) + " 个探测点)");
+            return true;
+        }
+
+        case ScanMessageType::LEASE: {
+            ScanLease lease;
+            if (!m_permutation || !decodeScanLease(payload, lease) || m_leases.count(lease.id)) {
+                fail("Invalid lease");
+                return false;
+            }
+            m_leases.emplace(lease.id, Lease(lease, m_permutation->block(lease.begin, lease.end)));
+            ++m_stats.leases;
+            return true;
+        }
+
+        case ScanMessageType::TRUNCATE: {
+            ScanMessageReader reader(payload.data(), payload.size());
+            uint32_t leaseId;
+            uint64_t end;
+            if (!reader.u32(leaseId) || !reader.u64(end)) {
+                fail("Invalid truncate message");
+                return false;
+            }
+            ++m_stats.truncated;
+            auto it = m_leases.find(leaseId);
+            if (it == m_leases.end()) {
+                return true;
+            }
+            // 尚未探测的推迟点随剩余区间一起交出; 在途的探测照常完成
+            Lease& lease = it->second;
+            lease.cursor.truncate(end);
+            uint64_t newEnd = lease.cursor.end();
+            lease.deferred.erase(std::remove_if(lease.deferred.begin(), lease.deferred.end(), [newEnd](Slot* slot) {
+                slot->done = slot->done || slot->position > newEnd;
+                return slot->done;
+            }), lease.deferred.end());
+            settle(leaseId);
+            return true;
+        }
+
+        case ScanMessageType::DONE:
+            m_done = true;
+            m_halt = true;
+            return true;
+
+        default:
+            fail("Unexpected message from coordinator");
+            return false;
+    }
+}
+
+void ScanWorker::scheduleTick(const std::atomic<bool>& stopRequested) {
+    m_tickTimer = m_loop.addTimer(TICK_INTERVAL, [this, &stopRequested] {
+        if (stopRequested) {
+            m_halt = true;
+        }
+        if (m_halt) {
+            return;
+        }
+        auto now = Clock::now();
+        if (now - m_lastReport >= REPORT_INTERVAL) {
+            m_lastReport = now;
+            for (auto& entry : m_leases) {
+                report(entry.second);
+            }
+        }
+        scheduleTick(stopRequested);
+    });
+}
+
+void ScanWorker::report(Lease& lease) {
+    if (!lease.open.empty()) {
+        sendFrame(encodeScanResult(lease.id, lease.open));
+        lease.open.clear();
+    }
+    // 最低的未完成位置: 协调节点回收时从这里开始，在途和推迟的探测点不会丢失
+    uint64_t position = lease.slots.empty() ? lease.cursor.position() : lease.completed;
+    sendFrame(encodeScanProgress(lease.id, std::min(position, lease.cursor.end()), lease.probed));
+}
+
+void ScanWorker::sendFrame(const std::vector<uint8_t>& frame) {
+    bool wasIdle = m_output.empty();
+    m_output.insert(m_output.end(), frame.begin(), frame.end());
+    if (wasIdle) {
+        flush();
+    }
+}
+
+void ScanWorker::flush() {
+    size_t sent = 0;
+    while (sent < m_output.size()) {
+        auto result = m_socket.send(m_output.data() + sent, m_output.size() - sent);
+        if (result < 0) {
+            if (!wouldBlock()) {
+                fail("Lost connection to coordinator");
+                return;
+            }
+            break;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    m_output.erase(m_output.begin(), m_output.begin() + sent);
+
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (!m_output.empty()) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(m_socket.getHandle(), events);
+}
+
+void ScanWorker::fail(const std::string& message) {
+    if (m_error.empty()) {
+        m_error = message;
+    }
+    m_output.clear();
+    m_halt = true;
+}
+
+void ScanWorker::log(const std::string& message) {
+    if (m_logHandler) {
+        m_logHandler(message);
+    }
+}
+
+} // namespace MindSploit::Network
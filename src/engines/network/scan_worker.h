@@ -0,0 +1,149 @@
+#pragma once
+
+#include "scan_protocol.h"
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/target_space.h"
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+class LivenessTracker;
+class HostGuard;
+
+// 工作节点统计
+struct ScanWorkerStats {
+    uint64_t leases = 0;
+    uint64_t truncated = 0;     // 被协调节点截断 (拆分) 的租约
+    uint64_t probed = 0;
+    uint64_t open = 0;
+    uint64_t skipped = 0;       // 存活推断或tarpit检测跳过的探测点
+    uint64_t suppressed = 0;    // tarpit主机上不报告的开放端口
+};
+
+// 租约中一个探测点的结果，由探测后端填写
+struct LeaseProbeResult {
+    Utils::IPAddress target;
+    uint16_t port = 0;
+    uint64_t tag = 0;                   // 数据源给出的标记，原样返回
+    bool open = false;
+    bool answered = false;              // 收到SYN-ACK、RST或ICMP管理禁止，主机存在
+    double responseTime = -1.0;         // 握手时间 (毫秒)，<0未知
+    double holdTime = 0.0;              // 连接建立后等待横幅的时间 (毫秒)
+    bool banner = false;
+};
+
+// 扫描工作节点
+//
+// 连接协调节点，按收到的JOB重建目标空间和排列。租约区间内的位置交给探测后端 (ConnectScanner或ProxyScanner)
+// 在工作节点的事件循环中并发探测，协调节点的截断/新租约/结束消息在同一事件循环中处理。
+// 探测乱序完成，回传的进度是最低的未完成位置，节点失联时协调节点从该位置起回收，在途的探测不会丢失。
+class ScanWorker {
+public:
+    using LogHandler = std::function<void(const std::string& message)>;
+    // 返回false表示目前没有可探测的位置
+    using Source = std::function<bool(Utils::IPAddress& target, uint16_t& port, uint64_t& tag)>;
+    using ResultHandler = std::function<void(const LeaseProbeResult& result)>;
+    // 探测后端: 在loop()上并发探测数据源给出的目标，数据源取完且在途探测结束或stopRequested置位后返回
+    using Backend = std::function<void(const Source& source, const ResultHandler& onResult,
+                                       const std::atomic<bool>& stopRequested)>;
+
+    // token须与协调节点的-token一致
+    ScanWorker(const std::string& name, const std::string& token);
+    ~ScanWorker();
+
+    ScanWorker(const ScanWorker&) = delete;
+    ScanWorker& operator=(const ScanWorker&) = delete;
+
+    void setLogHandler(LogHandler handler) { m_logHandler = std::move(handler); }
+    // 可选的存活推断 (推迟的探测点在租约末尾补做) 和tarpit检测，由调用方持有
+    void setLivenessTracker(LivenessTracker* tracker) { m_liveness = tracker; }
+    void setHostGuard(HostGuard* guard) { m_guard = guard; }
+
+    // 探测后端须在这个事件循环上运行
+    Utils::EventLoop& loop() { return m_loop; }
+
+    bool connect(const Utils::IPAddress& address, uint16_t port, std::string& error);
+    // 运行直到收到DONE (返回true)、连接出错或stopRequested置位
+    bool run(const Backend& backend, const std::atomic<bool>& stopRequested, std::string& error);
+    // 探测后端无法继续 (如代理全部失效) 时调用: run返回false，未完成的区间由协调节点回收
+    void abort(const std::string& message) { fail(message); }
+
+    ScanWorkerStats getStats() const { return m_stats; }
+
+private:
+    // 按位置顺序取出的探测点
+    struct Slot {
+        uint64_t position = 0;      // 探测点之后的循环位置
+        uint64_t index = 0;
+        bool done = false;
+    };
+
+    struct Lease {
+        Lease(const ScanLease& lease, const Utils::TargetPermutation::Cursor& cursor)
+            : id(lease.id), cursor(cursor), completed(lease.begin) {}
+
+        uint32_t id;
+        Utils::TargetPermutation::Cursor cursor;
+        std::deque<Slot> slots;             // 未完成的探测点，已完成的前缀随时弹出
+        std::deque<Slot*> deferred;         // 存活推断推迟的探测点，光标走完后补做
+        std::vector<uint64_t> open;         // 待回传的开放索引
+        uint64_t completed;                 // 此前的位置均已完成
+        uint64_t probed = 0;
+        bool drained = false;               // 光标已走完
+    };
+
+    // 探测后端的数据源和结果处理
+    bool nextProbe(Utils::IPAddress& target, uint16_t& port, uint64_t& tag);
+    bool issue(Lease& lease, Slot& slot, const Utils::IPAddress& host, Utils::IPAddress& target,
+               uint16_t& port, uint64_t& tag);
+    void onResult(const LeaseProbeResult& result);
+    void skip(Slot& slot);
+    // 弹出已完成的前缀，租约全部完成时回传COMPLETE
+    void settle(uint32_t leaseId);
+
+    void onCoordinatorEvent(uint32_t events);
+    bool handleMessage(ScanMessageType type, const std::vector<uint8_t>& payload);
+    void scheduleTick(const std::atomic<bool>& stopRequested);
+    void report(Lease& lease);
+    void sendFrame(const std::vector<uint8_t>& frame);
+    void flush();
+    void fail(const std::string& message);
+    void log(const std::string& message);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string m_name;
+    std::string m_token;
+    Utils::EventLoop m_loop;
+    Utils::Socket m_socket;
+    std::vector<uint8_t> m_input;
+    std::vector<uint8_t> m_output;
+
+    ScanJob m_job;
+    std::unique_ptr<Utils::TargetSpace> m_space;
+    std::unique_ptr<Utils::TargetPermutation> m_permutation;
+
+    std::map<uint32_t, Lease> m_leases;                                 // 按租约号，即按分配顺序探测
+    std::unordered_map<uint64_t, std::pair<uint32_t, Slot*>> m_inFlight; // 索引 -> 租约号, 探测点
+    LivenessTracker* m_liveness = nullptr;
+    HostGuard* m_guard = nullptr;
+
+    std::atomic<bool> m_halt{false};    // 中止正在运行的探测后端
+    bool m_done = false;
+    std::string m_error;
+    Clock::time_point m_lastReport;
+    Utils::EventLoop::TimerId m_tickTimer = 0;
+
+    ScanWorkerStats m_stats;
+    LogHandler m_logHandler;
+};
+
+} // namespace MindSploit::Network
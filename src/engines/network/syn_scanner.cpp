@@ -0,0 +1,482 @@
+#include "syn_scanner.h"
+#include "../../utils/socket_budget.h"
+#include <algorithm>
+#include <cstring>
+
+namespace MindSploit::Network {
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 256;
+constexpr auto SWEEP_INTERVAL = std::chrono::milliseconds(50);
+// 已完成连接的记录保留时间: Linux默认tcp_synack_retries=5，服务端约63秒后停止重传SYN-ACK
+constexpr auto FINISHED_RETENTION = std::chrono::seconds(64);
+// 自动选择本地端口时不使用特权端口; 临时端口范围上方至少有这么多端口时优先使用上方
+constexpr uint32_t MIN_SOURCE_PORT = 1024;
+constexpr uint32_t PREFERRED_SOURCE_PORTS = 1024;
+// 初始序列号的低位携带发送时刻 (毫秒，按4096取模)，SYN-ACK的确认号即可算出往返时间
+constexpr uint32_t ISN_TIME_MASK = 0xfff;
+
+constexpr uint8_t PROTO_TCP = 6;
+
+constexpr uint8_t TCP_FIN = 0x01;
+constexpr uint8_t TCP_SYN = 0x02;
+constexpr uint8_t TCP_RST = 0x04;
+constexpr uint8_t TCP_ACK = 0x10;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint64_t mix64(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+std::string addressString(uint32_t address) {
+    char text[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &address, text, sizeof(text));
+    return text;
+}
+
+Utils::PacketTemplateConfig segmentConfig(Utils::ProbeType type, const Utils::PacketChannel& channel,
+                                          uint16_t window, const std::string& payload = "") {
+    Utils::PacketTemplateConfig config;
+    config.type = type;
+    channel.configureTemplate(config);
+    config.tcpWindow = window;
+    config.tcpMss = type == Utils::ProbeType::TCP_SYN ? 1460 : 0;
+    config.payload.assign(payload.begin(), payload.end());
+    return config;
+}
+
+} // namespace
+
+struct SynScanner::ReplyBatches {
+    Utils::PacketTemplate ackTemplate;
+    Utils::PacketTemplate probeTemplate;
+    Utils::PacketTemplate resetTemplate;
+    std::vector<Utils::ProbeTarget> acks;
+    std::vector<Utils::ProbeTarget> probes;
+    std::vector<Utils::ProbeTarget> resets;
+
+    ReplyBatches(const Utils::PacketChannel& channel, const SynScanConfig& config)
+        : ackTemplate(segmentConfig(Utils::ProbeType::TCP_ACK, channel, config.window)),
+          probeTemplate(segmentConfig(Utils::ProbeType::TCP_DATA, channel, config.window, config.probe)),
+          resetTemplate(segmentConfig(Utils::ProbeType::TCP_RST, channel, 0)) {}
+};
+
+SynScanner::SynScanner(const SynScanConfig& config)
+    : m_config(config) {
+    if (m_config.firstSourcePort > m_config.lastSourcePort) {
+        std::swap(m_config.firstSourcePort, m_config.lastSourcePort);
+    }
+    m_config.rate = std::max<uint32_t>(1, m_config.rate);
+}
+
+SynScanner::~SynScanner() = default;
+
+bool SynScanner::selectSourcePorts(SynScanConfig& config, std::string& error) {
+    Utils::PortRange ephemeral = Utils::SocketBudget::ephemeralPortRange();
+    std::string ephemeralText = std::to_string(ephemeral.start) + "-" + std::to_string(ephemeral.end);
+
+    if (config.firstSourcePort == 0 && config.lastSourcePort == 0) {
+        // 临时端口范围上方通常没有监听服务，优先使用; 不够时取两侧较大的一段
+        uint32_t aboveFirst = static_cast<uint32_t>(ephemeral.end) + 1;
+        uint32_t above = aboveFirst <= 65535 ? 65536 - aboveFirst : 0;
+        uint32_t below = ephemeral.start > MIN_SOURCE_PORT ? ephemeral.start - MIN_SOURCE_PORT : 0;
+        if (above > 0 && (above >= PREFERRED_SOURCE_PORTS || above >= below)) {
+            config.firstSourcePort = static_cast<uint16_t>(aboveFirst);
+            config.lastSourcePort = 65535;
+        } else if (below > 0) {
+            config.firstSourcePort = static_cast<uint16_t>(MIN_SOURCE_PORT);
+            config.lastSourcePort = static_cast<uint16_t>(ephemeral.start - 1);
+        } else {
+            error = "No local ports outside the ephemeral port range " + ephemeralText +
+                    ", narrow net.ipv4.ip_local_port_range";
+            return false;
+        }
+        return true;
+    }
+
+    if (config.firstSourcePort > config.lastSourcePort) {
+        std::swap(config.firstSourcePort, config.lastSourcePort);
+    }
+    if (config.firstSourcePort == 0) {
+        error = "Invalid source port range";
+        return false;
+    }
+    if (config.firstSourcePort <= ephemeral.end && config.lastSourcePort >= ephemeral.start) {
+        error = "Source ports " + std::to_string(config.firstSourcePort) + "-" +
+                std::to_string(config.lastSourcePort) + " overlap the ephemeral port range " + ephemeralText +
+                " (net.ipv4.ip_local_port_range)";
+        return false;
+    }
+    return true;
+}
+
+bool SynScanner::run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested,
+                     std::string& error) {
+    m_onResult = std::move(onResult);
+    if (!selectSourcePorts(m_config, error)) {
+        return false;
+    }
+
+    // 取下一个IPv4目标，返回false表示已取完
+    auto nextTarget = [&](uint32_t& address, uint16_t& port) {
+        Utils::IPAddress target;
+        while (source(target, port)) {
+            if (!target.isIPv6 && inet_pton(AF_INET, target.address.c_str(), &address) == 1) {
+                return true;
+            }
+            ++m_stats.unsupported;
+        }
+        return false;
+    };
+
+    uint32_t address;
+    uint16_t port;
+    bool pending = nextTarget(address, port);
+    if (!pending) {
+        if (m_stats.unsupported > 0) {
+            error = "Only IPv4 targets are supported by the SYN scanner";
+            return false;
+        }
+        return true;
+    }
+
+    // 应答的目的端口即本地端口，通道只需接收这一范围 (AF_XDP在内核中分流)
+    Utils::PacketChannelConfig channelConfig = m_config.channel;
+    channelConfig.protocol = PROTO_TCP;
+    channelConfig.firstPort = m_config.firstSourcePort;
+    channelConfig.lastPort = m_config.lastSourcePort;
+    m_channel = Utils::PacketChannel::open(channelConfig, Utils::IPAddress(addressString(address)), error);
+    if (!m_channel) {
+        return false;
+    }
+
+    Utils::PacketTemplate synTemplate(segmentConfig(Utils::ProbeType::TCP_SYN, *m_channel, m_config.window));
+    std::vector<Utils::ProbeTarget> batch;
+    batch.reserve(BATCH_SIZE);
+    m_replies = std::make_unique<ReplyBatches>(*m_channel, m_config);
+
+    m_start = Clock::now();
+    m_finishedRotated = m_start;
+    const auto start = m_start;
+    while (pending && !stopRequested) {
+        const uint32_t sendTime = elapsedMs();
+        while (pending && batch.size() < BATCH_SIZE) {
+            uint64_t hash = flowHash(address, port);
+            Utils::ProbeTarget probe;
+            std::memcpy(probe.address, &address, 4);
+            probe.destinationPort = port;
+            probe.sourcePort = flowPort(hash);
+            probe.sequence = (static_cast<uint32_t>(hash) & ~ISN_TIME_MASK) | (sendTime & ISN_TIME_MASK);
+            probe.ipId = static_cast<uint16_t>(hash >> 48);
+            batch.push_back(probe);
+            pending = nextTarget(address, port);
+        }
+        m_stats.synSent += m_channel->send(synTemplate, batch.data(), batch.size());
+        batch.clear();
+
+        // 按速率限制发送，间隙中处理应答和连接
+        auto due = start + std::chrono::microseconds(m_stats.synSent * 1000000 / m_config.rate);
+        serviceUntil(std::max(due, Clock::now()));
+    }
+
+    // 等待迟到的SYN-ACK，之后直到所有连接结束 (每个连接最多两个bannerWait)
+    if (!stopRequested) {
+        serviceUntil(Clock::now() + m_config.wait);
+    }
+    while (!m_connections.empty() && !stopRequested) {
+        serviceUntil(Clock::now() + SWEEP_INTERVAL);
+    }
+
+    // 中止时剩余连接以开放、无横幅报告
+    while (!m_connections.empty()) {
+        Connection& conn = m_connections.begin()->second;
+        finish(conn, "", conn.remoteSeq);
+    }
+    flushReplies();
+    return true;
+}
+
+void SynScanner::serviceUntil(Clock::time_point deadline) {
+    auto handler = [this](const uint8_t* packet, size_t length) { handlePacket(packet, length); };
+
+    // 发送落后于速率时deadline已过，仍先取走已到达的应答
+    while (true) {
+        while (m_channel->receive(handler) > 0) {
+        }
+        sweep();
+        flushReplies();
+
+        auto now = Clock::now();
+        if (now >= deadline) {
+            return;
+        }
+        auto remaining = std::min(std::chrono::duration_cast<std::chrono::microseconds>(deadline - now),
+                                  std::chrono::duration_cast<std::chrono::microseconds>(SWEEP_INTERVAL));
+        m_channel->wait(remaining);
+    }
+}
+
+void SynScanner::handlePacket(const uint8_t* packet, size_t length) {
+    if (length < 20 || (packet[0] >> 4) != 4 || packet[9] != PROTO_TCP) {
+        return;
+    }
+    size_t headerLength = (packet[0] & 0x0f) * 4;
+    if (length < headerLength + 20) {
+        return;
+    }
+    const uint8_t* tcp = packet + headerLength;
+    uint16_t sourcePort = readU16(tcp + 2);
+    if (sourcePort < m_config.firstSourcePort || sourcePort > m_config.lastSourcePort) {
+        return;
+    }
+
+    uint32_t address;
+    std::memcpy(&address, packet + 12, 4);
+    uint16_t port = readU16(tcp);
+    uint32_t seq = readU32(tcp + 4);
+    uint32_t ack = readU32(tcp + 8);
+    uint8_t flags = tcp[13];
+
+    auto it = m_connections.find(makeKey(address, port));
+    if (it != m_connections.end() && it->second.sourcePort == sourcePort) {
+        if (flags & TCP_SYN) {
+            // 服务端没有收到ACK而重传SYN-ACK
+            if (flags & TCP_ACK) {
+                ++m_stats.retransmits;
+                queueAck(it->second);
+                if (it->second.phase == Phase::PROBED) {
+                    queueProbe(it->second);
+                }
+            }
+            return;
+        }
+        // 负载长度以IP总长度为准，接收缓冲区只需容纳横幅的开头
+        size_t tcpHeaderLength = (tcp[12] >> 4) * 4;
+        if (tcpHeaderLength < 20) {
+            return;
+        }
+        size_t total = std::max<size_t>(readU16(packet + 2), headerLength + tcpHeaderLength);
+        size_t payloadLength = total - headerLength - tcpHeaderLength;
+        size_t captured = std::min(payloadLength, length - std::min(length, headerLength + tcpHeaderLength));
+        onSegment(it->second, flags, seq, tcp + tcpHeaderLength, payloadLength, captured);
+        return;
+    }
+
+    // 没有连接记录: SYN探测的应答，确认号须为本端初始序列号+1 (不含发送时刻的各位)
+    uint64_t hash = flowHash(address, port);
+    uint32_t isn = ack - 1;
+    if (!(flags & TCP_ACK) || flowPort(hash) != sourcePort ||
+        ((isn ^ static_cast<uint32_t>(hash)) & ~ISN_TIME_MASK) != 0) {
+        return;
+    }
+    if ((flags & (TCP_SYN | TCP_RST)) == TCP_SYN) {
+        uint32_t rtt = (elapsedMs() - isn) & ISN_TIME_MASK;
+        onSynAck(address, port, sourcePort, seq, ack, rtt, readU16(tcp + 14));
+    } else if ((flags & TCP_RST) && !isFinished(makeKey(address, port))) {
+        ++m_stats.closed;
+        if (m_onClosed) {
+            m_onClosed(Utils::IPAddress(addressString(address)), port);
+        }
+    }
+}
+
+void SynScanner::onSynAck(uint32_t address, uint16_t port, uint16_t sourcePort, uint32_t serverSeq,
+                          uint32_t localSeq, uint32_t rtt, uint16_t window) {
+    Key key = makeKey(address, port);
+    Connection conn;
+    conn.address = address;
+    conn.port = port;
+    conn.sourcePort = sourcePort;
+    conn.localSeq = localSeq;
+    conn.remoteSeq = serverSeq + 1;
+    conn.synAckTime = static_cast<uint16_t>(rtt);
+    conn.window = window;
+    conn.established = Clock::now();
+
+    if (isFinished(key)) {
+        // 之前的RST丢失，服务端仍在重传SYN-ACK
+        queueReset(conn, conn.remoteSeq);
+        return;
+    }
+    ++m_stats.open;
+
+    // 只做SYN扫描，或调用方认为该主机不值得采集横幅: 不完成握手，直接复位
+    bool grab = m_config.bannerWait.count() > 0;
+    if (m_onSynAck && !m_onSynAck(Utils::IPAddress(addressString(address)), port, rtt, window)) {
+        grab = false;
+    }
+    if (!grab) {
+        queueReset(conn, conn.remoteSeq);
+        complete(conn, "");
+        return;
+    }
+
+    queueAck(conn);
+    m_connections.emplace(key, conn);
+    m_bannerTimers.emplace_back(conn.established + m_config.bannerWait, key);
+    m_stats.peakConnections = std::max(m_stats.peakConnections, m_connections.size());
+}
+
+void SynScanner::onSegment(Connection& conn, uint8_t flags, uint32_t seq, const uint8_t* payload,
+                           size_t payloadLength, size_t captured) {
+    if (flags & TCP_RST) {
+        // 服务端在发送数据前中止了连接 (内核的RST未被丢弃时也是这种情况)
+        ++m_stats.resets;
+        complete(conn, "");
+        return;
+    }
+    if (seq != conn.remoteSeq) {
+        return;
+    }
+    if (payloadLength > 0) {
+        // 第一个数据段即横幅
+        std::string banner = Utils::NetworkUtils::bannerLine(reinterpret_cast<const char*>(payload), captured);
+        finish(conn, banner, seq + static_cast<uint32_t>(payloadLength) + ((flags & TCP_FIN) ? 1 : 0));
+    } else if (flags & TCP_FIN) {
+        finish(conn, "", seq + 1);
+    }
+}
+
+void SynScanner::sweep() {
+    auto now = Clock::now();
+
+    if (now - m_finishedRotated >= FINISHED_RETENTION) {
+        m_finishedPrevious.clear();
+        m_finishedPrevious.swap(m_finished);
+        m_finishedRotated = now;
+    }
+
+    while (!m_bannerTimers.empty() && m_bannerTimers.front().first <= now) {
+        Key key = m_bannerTimers.front().second;
+        m_bannerTimers.pop_front();
+        auto it = m_connections.find(key);
+        if (it == m_connections.end() || it->second.phase != Phase::BANNER) {
+            continue;
+        }
+        if (m_config.probe.empty()) {
+            finish(it->second, "", it->second.remoteSeq);
+            continue;
+        }
+        // 服务端不主动发送横幅，发送probe请求
+        ++m_stats.probesSent;
+        it->second.phase = Phase::PROBED;
+        queueProbe(it->second);
+        m_probeTimers.emplace_back(now + m_config.bannerWait, key);
+    }
+
+    while (!m_probeTimers.empty() && m_probeTimers.front().first <= now) {
+        Key key = m_probeTimers.front().second;
+        m_probeTimers.pop_front();
+        auto it = m_connections.find(key);
+        if (it != m_connections.end()) {
+            finish(it->second, "", it->second.remoteSeq);
+        }
+    }
+}
+
+void SynScanner::finish(Connection& conn, const std::string& banner, uint32_t acknowledged) {
+    queueReset(conn, acknowledged);
+    complete(conn, banner);
+}
+
+void SynScanner::complete(Connection& conn, const std::string& banner) {
+    SynProbeResult result;
+    result.target = Utils::IPAddress(addressString(conn.address));
+    result.port = conn.port;
+    result.banner = banner;
+    result.probed = conn.phase == Phase::PROBED;
+    result.responseTime = std::chrono::duration<double, std::milli>(Clock::now() - conn.established).count();
+    result.synAckTime = conn.synAckTime;
+    result.window = conn.window;
+    if (!banner.empty()) {
+        ++m_stats.banners;
+    }
+
+    Key key = makeKey(conn.address, conn.port);
+    m_finished.insert(key);
+    m_connections.erase(key);
+    m_onResult(result);
+}
+
+void SynScanner::queueAck(const Connection& conn) {
+    Utils::ProbeTarget segment;
+    std::memcpy(segment.address, &conn.address, 4);
+    segment.destinationPort = conn.port;
+    segment.sourcePort = conn.sourcePort;
+    segment.sequence = conn.localSeq;
+    segment.acknowledgment = conn.remoteSeq;
+    m_replies->acks.push_back(segment);
+    if (m_replies->acks.size() >= BATCH_SIZE) {
+        flushReplies();
+    }
+}
+
+void SynScanner::queueProbe(const Connection& conn) {
+    Utils::ProbeTarget segment;
+    std::memcpy(segment.address, &conn.address, 4);
+    segment.destinationPort = conn.port;
+    segment.sourcePort = conn.sourcePort;
+    segment.sequence = conn.localSeq;
+    segment.acknowledgment = conn.remoteSeq;
+    m_replies->probes.push_back(segment);
+    if (m_replies->probes.size() >= BATCH_SIZE) {
+        flushReplies();
+    }
+}
+
+void SynScanner::queueReset(const Connection& conn, uint32_t acknowledged) {
+    Utils::ProbeTarget segment;
+    std::memcpy(segment.address, &conn.address, 4);
+    segment.destinationPort = conn.port;
+    segment.sourcePort = conn.sourcePort;
+    segment.sequence = conn.localSeq +
+        (conn.phase == Phase::PROBED ? static_cast<uint32_t>(m_config.probe.size()) : 0);
+    segment.acknowledgment = acknowledged;
+    m_replies->resets.push_back(segment);
+    if (m_replies->resets.size() >= BATCH_SIZE) {
+        flushReplies();
+    }
+}
+
+void SynScanner::flushReplies() {
+    if (!m_replies) {
+        return;
+    }
+    // ACK先于probe请求提交，同一连接的两个段按序到达
+    auto submit = [this](const Utils::PacketTemplate& packetTemplate, std::vector<Utils::ProbeTarget>& segments) {
+        if (!segments.empty()) {
+            m_channel->send(packetTemplate, segments.data(), segments.size());
+            segments.clear();
+        }
+    };
+    submit(m_replies->ackTemplate, m_replies->acks);
+    submit(m_replies->probeTemplate, m_replies->probes);
+    submit(m_replies->resetTemplate, m_replies->resets);
+}
+
+uint64_t SynScanner::flowHash(uint32_t address, uint16_t port) const {
+    return mix64(m_config.seed ^ ((static_cast<uint64_t>(address) << 16) | port));
+}
+
+uint32_t SynScanner::elapsedMs() const {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_start).count());
+}
+
+uint16_t SynScanner::flowPort(uint64_t hash) const {
+    uint32_t count = static_cast<uint32_t>(m_config.lastSourcePort - m_config.firstSourcePort) + 1;
+    return static_cast<uint16_t>(m_config.firstSourcePort + (hash >> 32) % count);
+}
+
+} // namespace MindSploit::Network
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "../../utils/packet_channel.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace MindSploit::Network {
+
+struct SynScanConfig {
+    uint32_t rate = 10000;                          // 每秒发送的SYN数
+    std::chrono::milliseconds wait{2000};           // SYN发送完毕后等待迟到应答的时间
+    std::chrono::milliseconds bannerWait{1000};     // 握手完成后等待横幅的时间，0为只做SYN扫描
+    std::string probe = "HEAD / HTTP/1.0\r\n\r\n";  // 服务端不主动发送横幅时发送的请求
+    uint16_t firstSourcePort = 0;                   // 本地端口范围，须在内核临时端口范围之外; 0为自动选择
+    uint16_t lastSourcePort = 0;
+    uint16_t window = 65535;                        // 通告窗口，只需要收下第一个响应段
+    uint64_t seed = 0;
+    Utils::PacketChannelConfig channel;             // 收发方式; 协议和端口范围由扫描器填写
+};
+
+struct SynProbeResult {
+    Utils::IPAddress target;
+    uint16_t port = 0;
+    std::string banner;
+    bool probed = false;                            // 横幅是对probe请求的响应
+    double responseTime = 0.0;                      // 毫秒，握手完成到收到横幅
+    double synAckTime = 0.0;                        // 毫秒，SYN发出到收到SYN-ACK
+    uint16_t window = 0;                            // SYN-ACK通告的窗口
+};
+
+struct SynScanStats {
+    uint64_t synSent = 0;
+    uint64_t open = 0;                              // 收到有效SYN-ACK
+    uint64_t closed = 0;                            // 收到RST
+    uint64_t banners = 0;
+    uint64_t probesSent = 0;                        // 发送了probe请求的连接
+    uint64_t resets = 0;                            // 握手完成后、收到数据前被RST的连接
+    uint64_t retransmits = 0;                       // 因SYN-ACK重传补发的ACK
+    uint64_t unsupported = 0;                       // 跳过的非IPv4目标
+    size_t peakConnections = 0;
+};
+
+// 原始SYN扫描与用户态TCP横幅采集 (zmap/zgrab式)
+//
+// SYN以预构建模板经PacketChannel批量按速率发送 (原始套接字或AF_XDP)，应答从同一通道接收:
+//   - 本地端口和初始序列号由 目标:端口 和种子散列得到，SYN-ACK的确认号即可校验，
+//     发送SYN不保存任何状态; 开放端口在收到SYN-ACK后才建立一条几十字节的连接记录。
+//     初始序列号的低12位是发送时刻 (毫秒)，不保存状态也能得到SYN-ACK往返时间，校验位相应减为20位
+//   - 用户态完成握手: 回ACK，等待服务端横幅，超时未收到时发送probe请求，
+//     收到第一个数据段即以RST+ACK结束连接并报告横幅
+//   - 不创建内核套接字，并发连接数不受fd和临时端口限制，只受内存限制
+// 原始套接字方式下内核也会收到SYN-ACK，并回复RST (不带ACK) 中断握手，需要丢弃这些RST，例如
+// 本地端口范围为61000-65535时:
+//   iptables -A OUTPUT -p tcp --tcp-flags ALL RST --sport 61000:65535 -j DROP
+// 扫描器自己发出的RST带有ACK标志，不受该规则影响。本地端口范围不能与内核临时端口范围重叠，
+// 否则内核自己的连接也会用到这些端口: 其应答被当作探测应答 (AF_XDP下被截走)，RST也被上面的规则丢弃。
+// AF_XDP方式下应答在进入协议栈前被重定向，无需该规则。只支持IPv4，需要root权限或CAP_NET_RAW。
+class SynScanner {
+public:
+    // 返回false表示目标已取完
+    using Source = std::function<bool(Utils::IPAddress& target, uint16_t& port)>;
+    using ResultHandler = std::function<void(const SynProbeResult& result)>;
+    // 收到有效SYN-ACK时调用 (rtt为毫秒)，返回false则不完成握手，直接以无横幅的开放端口报告
+    using SynAckHandler = std::function<bool(const Utils::IPAddress& target, uint16_t port, uint32_t rtt,
+                                             uint16_t window)>;
+    // 收到SYN探测的RST (端口关闭) 时调用
+    using ClosedHandler = std::function<void(const Utils::IPAddress& target, uint16_t port)>;
+
+    explicit SynScanner(const SynScanConfig& config);
+    ~SynScanner();
+
+    // 本地端口范围未指定时选择内核临时端口范围之外的一段 (优先其上方)，
+    // 指定的范围与临时端口范围重叠时失败; run会先调用，调用方也可以提前调用以得到实际范围
+    static bool selectSourcePorts(SynScanConfig& config, std::string& error);
+
+    SynScanner(const SynScanner&) = delete;
+    SynScanner& operator=(const SynScanner&) = delete;
+
+    bool run(Source source, ResultHandler onResult, const std::atomic<bool>& stopRequested,
+             std::string& error);
+
+    void setSynAckHandler(SynAckHandler handler) { m_onSynAck = std::move(handler); }
+    void setClosedHandler(ClosedHandler handler) { m_onClosed = std::move(handler); }
+
+    SynScanStats getStats() const { return m_stats; }
+    // run之后可用: 通道描述和收发统计
+    std::string channelDescription() const { return m_channel ? m_channel->describe() : ""; }
+    Utils::PacketChannelStats channelStats() const {
+        return m_channel ? m_channel->getStats() : Utils::PacketChannelStats();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Phase {
+        BANNER,             // 已回ACK，等待服务端主动发送的横幅
+        PROBED              // 已发送probe请求，等待响应
+    };
+
+    struct Connection {
+        uint32_t address = 0;                       // 网络字节序
+        uint16_t port = 0;
+        uint16_t sourcePort = 0;
+        uint32_t localSeq = 0;                      // 握手后的发送序列号 (ISN+1)
+        uint32_t remoteSeq = 0;                     // 期望的服务端序列号
+        uint16_t synAckTime = 0;                    // 毫秒
+        uint16_t window = 0;
+        Phase phase = Phase::BANNER;
+        Clock::time_point established;
+    };
+
+    using Key = uint64_t;
+    static Key makeKey(uint32_t address, uint16_t port) {
+        return (static_cast<uint64_t>(address) << 16) | port;
+    }
+
+    // 处理应答和连接超时直到deadline
+    void serviceUntil(Clock::time_point deadline);
+    void handlePacket(const uint8_t* packet, size_t length);
+    void onSynAck(uint32_t address, uint16_t port, uint16_t sourcePort, uint32_t serverSeq,
+                  uint32_t localSeq, uint32_t rtt, uint16_t window);
+    // captured: 接收缓冲区中实际收到的负载字节数 (不超过payloadLength)
+    void onSegment(Connection& conn, uint8_t flags, uint32_t seq, const uint8_t* payload,
+                   size_t payloadLength, size_t captured);
+    void sweep();
+    bool isFinished(Key key) const { return m_finished.count(key) || m_finishedPrevious.count(key); }
+    // 回复RST+ACK并报告结果
+    void finish(Connection& conn, const std::string& banner, uint32_t acknowledged);
+    // 报告开放端口并删除连接记录 (conn可以是不在表中的临时记录)
+    void complete(Connection& conn, const std::string& banner);
+
+    void queueAck(const Connection& conn);
+    void queueProbe(const Connection& conn);
+    void queueReset(const Connection& conn, uint32_t acknowledged);
+    void flushReplies();
+
+    // 低32位为初始序列号 (低12位替换为发送时刻)，高32位决定本地端口
+    uint64_t flowHash(uint32_t address, uint16_t port) const;
+    uint32_t elapsedMs() const;
+    uint16_t flowPort(uint64_t hash) const;
+
+private:
+    SynScanConfig m_config;
+    std::unique_ptr<Utils::PacketChannel> m_channel;
+    ResultHandler m_onResult;
+    SynAckHandler m_onSynAck;
+    ClosedHandler m_onClosed;
+    Clock::time_point m_start;
+
+    std::unordered_map<Key, Connection> m_connections;
+    // 已报告的开放端口，重传的SYN-ACK只再回RST。按时间分两代，每隔FINISHED_RETENTION
+    // 丢弃旧的一代，记录保留一到两个周期，超过SYN-ACK重传期后不再占用内存
+    std::unordered_set<Key> m_finished;
+    std::unordered_set<Key> m_finishedPrevious;
+    Clock::time_point m_finishedRotated;
+    // 同一阶段的超时时间按加入顺序递增，先进先出即可，过期项在弹出时校验
+    std::deque<std::pair<Clock::time_point, Key>> m_bannerTimers;
+    std::deque<std::pair<Clock::time_point, Key>> m_probeTimers;
+
+    // 回复包按类型各用一个模板批量发送，每轮接收处理完后统一提交
+    struct ReplyBatches;
+    std::unique_ptr<ReplyBatches> m_replies;
+    SynScanStats m_stats;
+};
+
+} // namespace MindSploit::Network
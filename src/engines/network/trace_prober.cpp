@@ -0,0 +1,624 @@
+#include "trace_prober.h"
+#include "../../utils/packet_template.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+namespace MindSploit::Network {
+
+namespace {
+
+constexpr uint16_t DEFAULT_UDP_PORT = 33434;
+constexpr uint16_t DEFAULT_TCP_PORT = 80;
+constexpr size_t BATCH_SIZE = 256;
+// 主轮探测到先导路径最远距离之外这么多跳，仍未到达的再补发其后的TTL
+constexpr int HORIZON_MARGIN = 4;
+constexpr size_t RECEIVE_BUFFER = 2048;
+constexpr int SOCKET_BUFFER = 4 * 1024 * 1024;
+
+constexpr uint8_t PROTO_ICMP = 1;
+constexpr uint8_t PROTO_TCP = 6;
+constexpr uint8_t PROTO_UDP = 17;
+
+constexpr uint8_t ICMP_ECHO_REPLY = 0;
+constexpr uint8_t ICMP_UNREACHABLE = 3;
+constexpr uint8_t ICMP_TIME_EXCEEDED = 11;
+
+constexpr uint8_t TCP_SYN = 0x02;
+constexpr uint8_t TCP_RST = 0x04;
+constexpr uint8_t TCP_ACK = 0x10;
+
+// IP标识/ICMP序号: 高10位为目标校验值，低6位为TTL
+constexpr int TTL_BITS = 6;
+constexpr uint16_t TTL_MASK = (1u << TTL_BITS) - 1;
+constexpr uint16_t CHECK_MASK = 0x3ff;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint64_t mix64(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+std::string addressString(uint32_t address) {
+    char text[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &address, text, sizeof(text));
+    return text;
+}
+
+uint8_t methodProtocol(TraceMethod method) {
+    switch (method) {
+        case TraceMethod::TCP_SYN: return PROTO_TCP;
+        case TraceMethod::ICMP: return PROTO_ICMP;
+        case TraceMethod::UDP: break;
+    }
+    return PROTO_UDP;
+}
+
+// 路由器返回的不可达代码 (traceroute的记法)
+const char* unreachableCode(uint8_t code) {
+    switch (code) {
+        case 0: return "!N";
+        case 1: return "!H";
+        case 2: return "!P";
+        case 4: return "!F";
+        case 9:
+        case 10:
+        case 13: return "!X";
+        default: return "!U";
+    }
+}
+
+} // namespace
+
+std::string traceMethodName(TraceMethod method) {
+    switch (method) {
+        case TraceMethod::TCP_SYN: return "tcp";
+        case TraceMethod::ICMP: return "icmp";
+        case TraceMethod::UDP: break;
+    }
+    return "udp";
+}
+
+bool parseTraceMethod(const std::string& name, TraceMethod& method) {
+    if (name == "udp") {
+        method = TraceMethod::UDP;
+    } else if (name == "tcp" || name == "syn") {
+        method = TraceMethod::TCP_SYN;
+    } else if (name == "icmp") {
+        method = TraceMethod::ICMP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+TraceProber::TraceProber(const TraceConfig& config)
+    : m_config(config) {
+    if (m_config.port == 0) {
+        m_config.port = m_config.method == TraceMethod::TCP_SYN ? DEFAULT_TCP_PORT : DEFAULT_UDP_PORT;
+    }
+}
+
+TraceProber::~TraceProber() {
+    Utils::NetworkUtils::closeRawSocket(m_sendSocket);
+    Utils::NetworkUtils::closeRawSocket(m_icmpSocket);
+    Utils::NetworkUtils::closeRawSocket(m_tcpSocket);
+}
+
+bool TraceProber::run(const std::vector<Utils::IPAddress>& targets, const std::atomic<bool>& stopRequested,
+                      std::string& error) {
+    if (m_config.firstTtl < 1 || m_config.maxTtl > MAX_TTL || m_config.firstTtl > m_config.maxTtl) {
+        error = "TTL range must be within 1-" + std::to_string(MAX_TTL);
+        return false;
+    }
+    if (m_config.rate == 0) {
+        error = "Rate must be positive";
+        return false;
+    }
+
+    const size_t span = m_config.maxTtl - m_config.firstTtl + 1;
+    for (const auto& target : targets) {
+        uint32_t address;
+        if (target.isIPv6 || inet_pton(AF_INET, target.address.c_str(), &address) != 1) {
+            error = "Only IPv4 targets are supported: " + target.address;
+            return false;
+        }
+        if (m_index.count(address)) {
+            continue;
+        }
+        m_index[address] = static_cast<uint32_t>(m_addresses.size());
+        m_addresses.push_back(address);
+
+        TracePath path;
+        path.target = target.address;
+        path.hops.resize(span);
+        m_paths.push_back(std::move(path));
+    }
+    if (m_addresses.empty()) {
+        error = "No targets";
+        return false;
+    }
+    m_sentAt.assign(m_addresses.size() * span, 0);
+
+    if (!openSockets(targets.front(), error)) {
+        return false;
+    }
+    m_start = Clock::now();
+
+    // 先导目标均匀取自目标列表，目标不多时一轮完成
+    std::vector<uint32_t> pilots;
+    std::vector<uint32_t> others;
+    const size_t count = m_addresses.size();
+    if (m_config.pilotTargets >= 2 && count > m_config.pilotTargets) {
+        for (size_t i = 0; i < m_config.pilotTargets; ++i) {
+            pilots.push_back(static_cast<uint32_t>(i * count / m_config.pilotTargets));
+        }
+        size_t next = 0;
+        for (uint32_t index = 0; index < count; ++index) {
+            if (next < pilots.size() && pilots[next] == index) {
+                ++next;
+            } else {
+                others.push_back(index);
+            }
+        }
+    } else {
+        for (uint32_t index = 0; index < count; ++index) {
+            pilots.push_back(index);
+        }
+    }
+
+    runRound(pilots, m_config.firstTtl, m_config.maxTtl, stopRequested);
+
+    if (!others.empty() && !stopRequested) {
+        int shared = computeSharedTtl(pilots);
+        m_stats.sharedTtl = shared;
+        if (shared >= m_config.firstTtl) {
+            // 共享前缀取自第一个先导路径，其余目标不再探测这些跳
+            size_t sharedSlots = shared - m_config.firstTtl + 1;
+            const TracePath& pilot = m_paths[pilots.front()];
+            for (uint32_t index : others) {
+                std::copy(pilot.hops.begin(), pilot.hops.begin() + sharedSlots, m_paths[index].hops.begin());
+            }
+        }
+
+        // 到达目标之后的每个探测都由目标应答，既浪费又容易触发目标的ICMP限速:
+        // 主轮只探测到先导路径最远距离之外HORIZON_MARGIN跳
+        int horizon = m_config.maxTtl;
+        int farthest = 0;
+        for (uint32_t index : pilots) {
+            farthest = std::max(farthest, m_paths[index].reachedTtl);
+        }
+        if (farthest > 0) {
+            horizon = std::min<int>(m_config.maxTtl, farthest + HORIZON_MARGIN);
+        }
+        int firstTtl = std::max<int>(shared + 1, m_config.firstTtl);
+        runRound(others, firstTtl, horizon, stopRequested);
+
+        // 超出视界仍有应答 (路径还在延伸) 的目标补发其后的TTL
+        std::vector<uint32_t> extended;
+        for (uint32_t index : others) {
+            const TracePath& path = m_paths[index];
+            if (path.reachedTtl > 0 || !path.termination.empty()) {
+                continue;
+            }
+            for (int ttl = std::max(firstTtl, horizon - HORIZON_MARGIN + 1); ttl <= horizon; ++ttl) {
+                if (!path.hops[ttl - m_config.firstTtl].address.empty()) {
+                    extended.push_back(index);
+                    break;
+                }
+            }
+        }
+        if (horizon < m_config.maxTtl && !extended.empty() && !stopRequested) {
+            runRound(extended, horizon + 1, m_config.maxTtl, stopRequested);
+        }
+    }
+    m_stats.probesSaved = static_cast<uint64_t>(span) * count - m_stats.probesSent;
+
+    // 到达目标之后的探测都由目标应答，去掉; 未到达的路径去掉末尾无应答的跳
+    for (auto& path : m_paths) {
+        if (path.reachedTtl > 0) {
+            path.hops.resize(path.reachedTtl - m_config.firstTtl + 1);
+        } else {
+            while (!path.hops.empty() && path.hops.back().address.empty()) {
+                path.hops.pop_back();
+            }
+        }
+    }
+    return true;
+}
+
+bool TraceProber::openSockets(const Utils::IPAddress& probeTarget, std::string& error) {
+#ifdef _WIN32
+    (void)probeTarget;
+    error = "Raw socket traceroute is not supported on Windows";
+    return false;
+#else
+    // 传输层校验和包含源地址，由到第一个目标的路由决定
+    Utils::Socket route(AF_INET, SOCK_DGRAM);
+    if (!route.isValid() || !route.connect(probeTarget, m_config.port)) {
+        error = "No route to " + probeTarget.address;
+        return false;
+    }
+    m_source = route.getLocalAddress();
+
+    m_sendSocket = Utils::NetworkUtils::createRawSocket(IPPROTO_RAW);
+    m_icmpSocket = static_cast<int>(socket(AF_INET, SOCK_RAW, IPPROTO_ICMP));
+    if (m_config.method == TraceMethod::TCP_SYN) {
+        m_tcpSocket = static_cast<int>(socket(AF_INET, SOCK_RAW, IPPROTO_TCP));
+    }
+    if (m_sendSocket < 0 || m_icmpSocket < 0 || (m_config.method == TraceMethod::TCP_SYN && m_tcpSocket < 0)) {
+        error = "Failed to create raw sockets (requires root or CAP_NET_RAW)";
+        return false;
+    }
+
+    // 应答集中在每轮发送之后到达，接收缓冲区要能容纳一轮的突发
+    for (int fd : {m_icmpSocket, m_tcpSocket}) {
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER, sizeof(SOCKET_BUFFER));
+    }
+    return true;
+#endif
+}
+
+void TraceProber::runRound(const std::vector<uint32_t>& targets, int firstTtl, int lastTtl,
+                           const std::atomic<bool>& stopRequested) {
+    if (firstTtl > lastTtl) {
+        return;
+    }
+
+    Utils::PacketTemplateConfig templateConfig;
+    switch (m_config.method) {
+        case TraceMethod::UDP: templateConfig.type = Utils::ProbeType::UDP; break;
+        case TraceMethod::TCP_SYN: templateConfig.type = Utils::ProbeType::TCP_SYN; break;
+        case TraceMethod::ICMP: templateConfig.type = Utils::ProbeType::ICMP_ECHO; break;
+    }
+    templateConfig.source = m_source;
+    Utils::PacketTemplate packetTemplate(templateConfig);
+    Utils::PacketBatch batch(packetTemplate, BATCH_SIZE);
+
+    const size_t span = m_config.maxTtl - m_config.firstTtl + 1;
+    const auto roundStart = Clock::now();
+    uint64_t sent = 0;
+
+    auto flush = [&]() {
+        size_t count = Utils::NetworkUtils::sendRawBatch(m_sendSocket, batch);
+        sent += count;
+        m_stats.probesSent += count;
+        batch.clear();
+        // 按速率限制发送，间隙中处理已到达的应答
+        auto due = roundStart + std::chrono::microseconds(sent * 1000000 / m_config.rate);
+        receiveUntil(std::max(due, Clock::now()));
+    };
+
+    // 按目标依次发出各TTL，同一路由器收到的探测分散在整轮中，减少ICMP限速造成的丢失
+    for (uint32_t index : targets) {
+        if (stopRequested) {
+            break;
+        }
+        uint32_t address = m_addresses[index];
+        uint32_t hash = flowHash(address);
+        for (int ttl = firstTtl; ttl <= lastTtl; ++ttl) {
+            uint16_t tagged = static_cast<uint16_t>(((hash & CHECK_MASK) << TTL_BITS) | ttl);
+
+            Utils::ProbeTarget probe;
+            std::memcpy(probe.address, &address, 4);
+            probe.ttl = static_cast<uint8_t>(ttl);
+            probe.ipId = tagged;
+            probe.sourcePort = flowPort(address);
+            probe.destinationPort = m_config.port;
+            probe.sequence = m_config.method == TraceMethod::TCP_SYN ? hash + ttl : tagged;
+
+            m_sentAt[index * span + (ttl - m_config.firstTtl)] = static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_start).count());
+            batch.add(probe);
+            if (batch.full()) {
+                flush();
+            }
+        }
+    }
+    if (batch.size() > 0) {
+        flush();
+    }
+
+    receiveUntil(Clock::now() + m_config.wait);
+}
+
+void TraceProber::receiveUntil(Clock::time_point deadline) {
+    uint8_t buffer[RECEIVE_BUFFER];
+
+    while (true) {
+        auto now = Clock::now();
+        auto remaining = deadline > now ? std::chrono::duration_cast<std::chrono::microseconds>(deadline - now)
+                                        : std::chrono::microseconds(0);
+
+        struct pollfd readable[2];
+        readable[0].fd = m_icmpSocket;
+        readable[0].events = POLLIN;
+        readable[0].revents = 0;
+        readable[1].fd = m_tcpSocket;
+        readable[1].events = POLLIN;
+        readable[1].revents = 0;
+        size_t count = m_tcpSocket >= 0 ? 2 : 1;
+        if (Utils::NetworkUtils::pollSockets(readable, count,
+                                             std::chrono::ceil<std::chrono::milliseconds>(remaining)) <= 0) {
+            return;
+        }
+
+        if (readable[0].revents != 0) {
+            int received;
+            while ((received = recv(m_icmpSocket, (char*)buffer, sizeof(buffer), 0)) > 0) {
+                handleIcmp(buffer, static_cast<size_t>(received));
+            }
+        }
+        if (count > 1 && readable[1].revents != 0) {
+            int received;
+            while ((received = recv(m_tcpSocket, (char*)buffer, sizeof(buffer), 0)) > 0) {
+                handleTcp(buffer, static_cast<size_t>(received));
+            }
+        }
+    }
+}
+
+void TraceProber::handleIcmp(const uint8_t* packet, size_t length) {
+    if (length < 20) {
+        return;
+    }
+    size_t headerLength = (packet[0] & 0x0f) * 4;
+    if (length < headerLength + 8) {
+        return;
+    }
+    uint32_t responder;
+    std::memcpy(&responder, packet + 12, 4);
+    const uint8_t* icmp = packet + headerLength;
+    uint8_t type = icmp[0];
+    uint8_t code = icmp[1];
+
+    if (type == ICMP_ECHO_REPLY) {
+        if (m_config.method != TraceMethod::ICMP) {
+            return;
+        }
+        auto it = m_index.find(responder);
+        uint16_t sequence = readU16(icmp + 6);
+        if (it == m_index.end() || readU16(icmp + 4) != flowPort(responder) ||
+            (sequence >> TTL_BITS) != (flowHash(responder) & CHECK_MASK)) {
+            return;
+        }
+        recordHop(it->second, static_cast<uint8_t>(sequence & TTL_MASK), responder, true, nullptr);
+        return;
+    }
+    if (type != ICMP_TIME_EXCEEDED && type != ICMP_UNREACHABLE) {
+        return;
+    }
+
+    uint32_t index;
+    uint8_t ttl;
+    if (!decodeQuoted(icmp + 8, length - headerLength - 8, index, ttl)) {
+        ++m_stats.unmatched;
+        return;
+    }
+    if (type == ICMP_TIME_EXCEEDED) {
+        recordHop(index, ttl, responder, false, nullptr);
+        return;
+    }
+
+    // 目标自己返回的端口/协议不可达即已到达
+    bool fromTarget = responder == m_addresses[index];
+    if (fromTarget && (code == 2 || code == 3)) {
+        recordHop(index, ttl, responder, true, nullptr);
+    } else {
+        recordHop(index, ttl, responder, fromTarget, unreachableCode(code));
+    }
+}
+
+void TraceProber::handleTcp(const uint8_t* packet, size_t length) {
+    if (length < 20) {
+        return;
+    }
+    size_t headerLength = (packet[0] & 0x0f) * 4;
+    if (length < headerLength + 20) {
+        return;
+    }
+    uint32_t source;
+    std::memcpy(&source, packet + 12, 4);
+    auto it = m_index.find(source);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    // SYN-ACK或RST-ACK，确认号为探测序列号+1
+    const uint8_t* tcp = packet + headerLength;
+    uint8_t flags = tcp[13];
+    if (readU16(tcp + 2) != flowPort(source) || !(flags & TCP_ACK) || !(flags & (TCP_SYN | TCP_RST))) {
+        return;
+    }
+    uint32_t ttl = readU32(tcp + 8) - 1 - flowHash(source);
+    if (ttl < m_config.firstTtl || ttl > m_config.maxTtl) {
+        ++m_stats.unmatched;
+        return;
+    }
+    recordHop(it->second, static_cast<uint8_t>(ttl), source, true, nullptr);
+}
+
+bool TraceProber::decodeQuoted(const uint8_t* quoted, size_t length, uint32_t& index, uint8_t& ttl) const {
+    if (length < 20 || (quoted[0] >> 4) != 4) {
+        return false;
+    }
+    size_t headerLength = (quoted[0] & 0x0f) * 4;
+    if (length < headerLength + 8 || quoted[9] != methodProtocol(m_config.method)) {
+        return false;
+    }
+    uint32_t address;
+    std::memcpy(&address, quoted + 16, 4);
+    auto it = m_index.find(address);
+    if (it == m_index.end()) {
+        return false;
+    }
+    index = it->second;
+
+    // 首部之后的8字节: UDP/TCP端口、TCP序列号或ICMP标识和序号
+    const uint8_t* l4 = quoted + headerLength;
+    uint32_t hash = flowHash(address);
+    uint32_t value = 0;
+    switch (m_config.method) {
+        case TraceMethod::UDP:
+            if (readU16(l4) != flowPort(address) || (readU16(quoted + 4) >> TTL_BITS) != (hash & CHECK_MASK)) {
+                return false;
+            }
+            value = readU16(quoted + 4) & TTL_MASK;
+            break;
+        case TraceMethod::TCP_SYN:
+            if (readU16(l4) != flowPort(address)) {
+                return false;
+            }
+            value = readU32(l4 + 4) - hash;
+            break;
+        case TraceMethod::ICMP:
+            if (readU16(l4 + 4) != flowPort(address) || (readU16(l4 + 6) >> TTL_BITS) != (hash & CHECK_MASK)) {
+                return false;
+            }
+            value = readU16(l4 + 6) & TTL_MASK;
+            break;
+    }
+    if (value < m_config.firstTtl || value > m_config.maxTtl) {
+        return false;
+    }
+    ttl = static_cast<uint8_t>(value);
+    return true;
+}
+
+void TraceProber::recordHop(uint32_t index, uint8_t ttl, uint32_t responder, bool reached,
+                            const char* termination) {
+    ++m_stats.replies;
+    TracePath& path = m_paths[index];
+    size_t slot = ttl - m_config.firstTtl;
+    TraceHop& hop = path.hops[slot];
+    if (!hop.address.empty()) {
+        return;
+    }
+
+    const size_t span = m_config.maxTtl - m_config.firstTtl + 1;
+    auto now = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_start).count();
+    hop.address = addressString(responder);
+    hop.rtt = (now - m_sentAt[index * span + slot]) / 1000.0;
+
+    if (reached && (path.reachedTtl == 0 || ttl < path.reachedTtl)) {
+        path.reachedTtl = ttl;
+    }
+    if (termination != nullptr && path.termination.empty()) {
+        path.termination = termination;
+    }
+}
+
+int TraceProber::computeSharedTtl(const std::vector<uint32_t>& pilots) const {
+    // 所有先导路径在该TTL都由同一路由器应答，且都尚未到达目标
+    int shared = m_config.firstTtl - 1;
+    for (int ttl = m_config.firstTtl; ttl <= m_config.maxTtl; ++ttl) {
+        size_t slot = ttl - m_config.firstTtl;
+        const std::string& address = m_paths[pilots.front()].hops[slot].address;
+        if (address.empty()) {
+            break;
+        }
+        for (uint32_t index : pilots) {
+            const TracePath& path = m_paths[index];
+            if (path.hops[slot].address != address || (path.reachedTtl > 0 && path.reachedTtl <= ttl)) {
+                return shared;
+            }
+        }
+        shared = ttl;
+    }
+    return shared;
+}
+
+void TraceProber::buildGraph(std::vector<TraceNode>& nodes, std::vector<TraceEdge>& edges) const {
+    std::map<std::string, TraceNode> nodeMap;
+    std::map<std::pair<std::string, std::string>, TraceEdge> edgeMap;
+
+    for (const auto& path : m_paths) {
+        // 同一路径中重复出现的节点和边只计一次
+        std::map<std::string, bool> seenNodes;
+        std::map<std::pair<std::string, std::string>, bool> seenEdges;
+        std::string previous;
+        int previousTtl = 0;
+
+        for (size_t slot = 0; slot < path.hops.size(); ++slot) {
+            const TraceHop& hop = path.hops[slot];
+            if (hop.address.empty()) {
+                continue;
+            }
+            int ttl = m_config.firstTtl + static_cast<int>(slot);
+
+            TraceNode& node = nodeMap[hop.address];
+            if (node.address.empty()) {
+                node.address = hop.address;
+                node.ttl = ttl;
+                node.rtt = hop.rtt;
+            }
+            node.ttl = std::min(node.ttl, ttl);
+            node.rtt = std::min(node.rtt, hop.rtt);
+            if (!seenNodes[hop.address]) {
+                seenNodes[hop.address] = true;
+                ++node.paths;
+            }
+            if (ttl == path.reachedTtl) {
+                node.target = true;
+            }
+
+            if (!previous.empty() && previous != hop.address) {
+                auto key = std::make_pair(previous, hop.address);
+                TraceEdge& edge = edgeMap[key];
+                if (edge.from.empty()) {
+                    edge.from = previous;
+                    edge.to = hop.address;
+                    edge.gap = ttl - previousTtl;
+                }
+                edge.gap = std::min(edge.gap, ttl - previousTtl);
+                if (!seenEdges[key]) {
+                    seenEdges[key] = true;
+                    ++edge.paths;
+                }
+            }
+            previous = hop.address;
+            previousTtl = ttl;
+        }
+    }
+
+    nodes.clear();
+    for (auto& entry : nodeMap) {
+        nodes.push_back(std::move(entry.second));
+    }
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [](const TraceNode& a, const TraceNode& b) { return a.ttl < b.ttl; });
+    edges.clear();
+    for (auto& entry : edgeMap) {
+        edges.push_back(std::move(entry.second));
+    }
+}
+
+uint32_t TraceProber::flowHash(uint32_t address) const {
+    return static_cast<uint32_t>(mix64(m_config.seed ^ address));
+}
+
+uint16_t TraceProber::flowPort(uint32_t address) const {
+    // 32768-49151，同一目标的所有探测使用相同的流标识
+    return static_cast<uint16_t>(32768 + ((flowHash(address) >> 16) & 0x3fff));
+}
+
+} // namespace MindSploit::Network
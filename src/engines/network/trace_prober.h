@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../../utils/network_utils.h"
+#include <atomic>
+#include <unordered_map>
+
+namespace MindSploit::Network {
+
+// 路由跟踪探测方式
+enum class TraceMethod {
+    UDP,            // UDP到高端口，目标以端口不可达应答
+    TCP_SYN,        // TCP SYN，目标以SYN-ACK或RST应答
+    ICMP            // ICMP Echo，目标以Echo Reply应答
+};
+
+std::string traceMethodName(TraceMethod method);
+bool parseTraceMethod(const std::string& name, TraceMethod& method);
+
+struct TraceConfig {
+    TraceMethod method = TraceMethod::UDP;
+    uint8_t firstTtl = 1;
+    uint8_t maxTtl = 30;                        // 不超过MAX_TTL
+    uint16_t port = 0;                          // 0为方式默认 (UDP 33434, TCP 80)
+    uint32_t rate = 10000;                      // 每秒发送的探测包数
+    std::chrono::milliseconds wait{2000};       // 每轮发送完毕后等待应答的时间
+    size_t pilotTargets = 8;                    // 先导轮的目标数，用于确定各路径共享的前缀
+    uint64_t seed = 0;
+};
+
+struct TraceHop {
+    std::string address;                        // 空表示无应答
+    double rtt = 0.0;                           // 毫秒
+};
+
+struct TracePath {
+    std::string target;
+    std::vector<TraceHop> hops;                 // 下标为 TTL-firstTtl
+    int reachedTtl = 0;                         // 目标应答的TTL，0为未到达
+    std::string termination;                    // 中途不可达: !N !H !P !X 等
+};
+
+// 合并后的路由器图
+struct TraceNode {
+    std::string address;
+    int ttl = 0;                                // 出现的最小TTL
+    double rtt = 0.0;                           // 最小往返时间
+    size_t paths = 0;                           // 经过该节点的路径数
+    bool target = false;
+};
+
+struct TraceEdge {
+    std::string from;
+    std::string to;
+    int gap = 1;                                // TTL差，大于1表示中间有无应答的跳
+    size_t paths = 0;
+};
+
+struct TraceStats {
+    uint64_t probesSent = 0;
+    uint64_t replies = 0;
+    uint64_t unmatched = 0;                     // 无法对应到探测的ICMP/TCP报文
+    int sharedTtl = 0;                          // 先导轮确定的共享前缀 (最后一个共享的TTL)
+    uint64_t probesSaved = 0;                   // 因共享前缀和探测视界少发的探测数
+};
+
+// 并行路由跟踪
+//
+// 所有目标的所有TTL一次发出，不逐跳等待应答:
+//   - 由一个IP_HDRINCL原始套接字以预构建模板批量发送，应答由ICMP (TCP方式另加TCP) 原始套接字接收
+//   - TTL和目标校验值写入IP标识以及TCP序列号/ICMP序号，ICMP差错中引用的原始首部即可还原
+//     目标和TTL，不保存逐个探测的状态; 同一目标的各TTL使用相同的端口/标识，负载均衡下走同一路径
+//   - 先导轮对少量目标探测全部TTL，所有先导路径都相同的前缀视为共享，其余目标从共享前缀之后开始，
+//     探测到先导路径最远距离之外几跳为止; 超出该范围仍有应答的路径再补发一轮
+// 用时为两到三轮 (发送时间 + 等待时间)，与跳数无关。只支持IPv4，需要root权限或CAP_NET_RAW。
+class TraceProber {
+public:
+    static constexpr uint8_t MAX_TTL = 63;      // TTL占IP标识的低6位
+
+    explicit TraceProber(const TraceConfig& config);
+    ~TraceProber();
+
+    TraceProber(const TraceProber&) = delete;
+    TraceProber& operator=(const TraceProber&) = delete;
+
+    bool run(const std::vector<Utils::IPAddress>& targets, const std::atomic<bool>& stopRequested,
+             std::string& error);
+
+    const std::vector<TracePath>& paths() const { return m_paths; }
+    void buildGraph(std::vector<TraceNode>& nodes, std::vector<TraceEdge>& edges) const;
+    TraceStats getStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool openSockets(const Utils::IPAddress& probeTarget, std::string& error);
+    // 对targets中的目标发送[firstTtl, lastTtl]的探测并等待应答
+    void runRound(const std::vector<uint32_t>& targets, int firstTtl, int lastTtl,
+                  const std::atomic<bool>& stopRequested);
+    // 等待并处理应答直到deadline
+    void receiveUntil(Clock::time_point deadline);
+    void handleIcmp(const uint8_t* packet, size_t length);
+    void handleTcp(const uint8_t* packet, size_t length);
+    // 由引用的原始IP首部还原目标和TTL，校验失败返回false
+    bool decodeQuoted(const uint8_t* quoted, size_t length, uint32_t& index, uint8_t& ttl) const;
+    void recordHop(uint32_t index, uint8_t ttl, uint32_t responder, bool reached, const char* termination);
+    int computeSharedTtl(const std::vector<uint32_t>& pilots) const;
+
+    uint32_t flowHash(uint32_t address) const;
+    uint16_t flowPort(uint32_t address) const;
+
+private:
+    TraceConfig m_config;
+    int m_sendSocket = -1;
+    int m_icmpSocket = -1;
+    int m_tcpSocket = -1;
+    Utils::IPAddress m_source;
+
+    std::vector<uint32_t> m_addresses;              // 网络字节序
+    std::unordered_map<uint32_t, uint32_t> m_index; // 地址 -> 目标下标
+    std::vector<TracePath> m_paths;
+    std::vector<uint32_t> m_sentAt;                 // [目标×TTL] 发送时刻 (微秒)
+    Clock::time_point m_start;
+    TraceStats m_stats;
+};
+
+} // namespace MindSploit::Network
@@ -0,0 +1,165 @@
+#include "conversation.h"
+#include "../../utils/buffer_arena.h"
+
+namespace MindSploit::Service {
+
+namespace {
+
+// 从offset开始的一行的结尾 (含\n)，没有完整的行时返回npos
+size_t lineEnd(std::string_view input, size_t offset) {
+    size_t end = input.find('\n', offset);
+    return end == std::string_view::npos ? end : end + 1;
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool isCode(std::string_view line) {
+    return line.size() >= 4 && line[0] >= '0' && line[0] <= '9' && line[1] >= '0' && line[1] <= '9' &&
+           line[2] >= '0' && line[2] <= '9';
+}
+
+// 对话对象池，块大小即对象大小
+Utils::BufferArena& framePool() {
+    static thread_local Utils::BufferArena pool(sizeof(ConversationDialog), 256);
+    return pool;
+}
+
+} // namespace
+
+size_t ReplyMatcher::match(std::string_view input) const {
+    size_t end = lineEnd(input, 0);
+    if (end == std::string_view::npos) {
+        return 0;
+    }
+    std::string_view first = input.substr(0, end);
+
+    switch (m_kind) {
+        case Kind::LINE:
+            return end;
+
+        case Kind::CODED: {
+            if (!isCode(first) || first[3] != '-') {
+                return end;
+            }
+            // 续行不一定带应答码 (如FTP的FEAT列表)，以同一应答码加空格的行结束
+            while (true) {
+                size_t next = lineEnd(input, end);
+                if (next == std::string_view::npos) {
+                    return 0;
+                }
+                std::string_view line = input.substr(end, next - end);
+                end = next;
+                if (isCode(line) && line.compare(0, 3, first.substr(0, 3)) == 0 && line[3] != '-') {
+                    return end;
+                }
+            }
+        }
+
+        case Kind::DOT_TERMINATED: {
+            if (!startsWith(first, "+OK")) {
+                return end;
+            }
+            while (true) {
+                size_t next = lineEnd(input, end);
+                if (next == std::string_view::npos) {
+                    return 0;
+                }
+                std::string_view line = input.substr(end, next - end);
+                end = next;
+                if (line == ".\r\n" || line == ".\n") {
+                    return end;
+                }
+            }
+        }
+
+        case Kind::TAGGED: {
+            size_t start = 0;
+            while (true) {
+                if (startsWith(input.substr(start, end - start), m_tag)) {
+                    return end;
+                }
+                start = end;
+                end = lineEnd(input, start);
+                if (end == std::string_view::npos) {
+                    return 0;
+                }
+            }
+        }
+    }
+    return end;
+}
+
+ConversationDialog::ConversationDialog(const ConversationScript& script)
+    : m_script(script) {
+}
+
+std::string_view ConversationDialog::request() {
+    return m_script.steps.empty() ? std::string_view() : m_script.steps.front().send;
+}
+
+ServiceDialog::Status ConversationDialog::receive(std::string_view input, size_t& consumed,
+                                                  std::string_view& output) {
+    consumed = 0;
+    while (m_step < m_script.steps.size()) {
+        const ConversationStep& step = m_script.steps[m_step];
+        size_t length = step.reply.match(input.substr(consumed));
+        if (length == 0) {
+            return Status::NEED_MORE;
+        }
+        std::string_view reply = input.substr(consumed, length);
+        consumed += length;
+
+        int next = step.handle(m_info, reply);
+        if (next == ConversationScript::DONE) {
+            return Status::DONE;
+        }
+        if (next < 0 || static_cast<size_t>(next) >= m_script.steps.size()) {
+            std::string line(reply.substr(0, reply.find_first_of("\r\n")));
+            return fail("Unexpected " + m_script.name + " reply: " + line.substr(0, 80));
+        }
+
+        m_step = static_cast<size_t>(next);
+        if (!m_script.steps[m_step].send.empty()) {
+            output = m_script.steps[m_step].send;
+            return Status::SEND;
+        }
+        // 不需要发送的步骤继续处理已收到的数据
+    }
+    return fail("Conversation script has no steps");
+}
+
+ServiceDialog::Status ConversationDialog::closed(std::string_view input) {
+    (void)input;
+    // 拒绝服务的应答之后断开很常见，已识别即足够
+    if (m_info.identified()) {
+        return Status::DONE;
+    }
+    return fail("Connection closed before " + m_script.name + " greeting");
+}
+
+std::chrono::milliseconds ConversationDialog::timeout() const {
+    return m_step < m_script.steps.size() ? m_script.steps[m_step].timeout : std::chrono::milliseconds(0);
+}
+
+void* ConversationDialog::operator new(size_t size) {
+    if (size > framePool().blockSize()) {
+        return ::operator new(size);
+    }
+    return framePool().acquire();
+}
+
+void ConversationDialog::operator delete(void* pointer, size_t size) {
+    if (size > framePool().blockSize()) {
+        ::operator delete(pointer);
+        return;
+    }
+    framePool().release(static_cast<char*>(pointer));
+}
+
+size_t ConversationDialog::pooled() {
+    return framePool().capacity();
+}
+
+} // namespace MindSploit::Service
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "service_prober.h"
+#include <chrono>
+
+namespace MindSploit::Service {
+
+// 应答的完整判定 (读取直到一个完整应答)
+class ReplyMatcher {
+public:
+    enum class Kind {
+        LINE,               // 一行，以\n结尾
+        CODED,              // SMTP/FTP应答码: "250-"续行，直到以"250 "开头的一行
+        DOT_TERMINATED,     // POP3: "+OK"之后直到单独一行"."，"-ERR"只有一行
+        TAGGED              // IMAP: 直到以标签开头的一行
+    };
+
+    static ReplyMatcher line() { return ReplyMatcher(Kind::LINE, {}); }
+    static ReplyMatcher coded() { return ReplyMatcher(Kind::CODED, {}); }
+    static ReplyMatcher dotTerminated() { return ReplyMatcher(Kind::DOT_TERMINATED, {}); }
+    // tag须为静态字符串，如 "a1 "
+    static ReplyMatcher tagged(std::string_view tag) { return ReplyMatcher(Kind::TAGGED, tag); }
+
+    // 返回input开头完整应答的长度，尚不完整时返回0
+    size_t match(std::string_view input) const;
+
+private:
+    ReplyMatcher(Kind kind, std::string_view tag) : m_kind(kind), m_tag(tag) {}
+
+    Kind m_kind;
+    std::string_view m_tag;
+};
+
+// 对话的一步: 进入时发送send (为空则只读取)，读到完整应答后交给handle决定下一步
+struct ConversationStep {
+    // 返回下一步的下标，或ConversationScript::DONE/FAILED
+    using Handler = int (*)(ServiceInfo& info, std::string_view reply);
+
+    std::string_view send;
+    ReplyMatcher reply;
+    Handler handle;
+    std::chrono::milliseconds timeout{0};       // 自连接建立或发送send起至少等待应答的时间
+};
+
+// 一个协议的对话脚本
+//
+// 脚本是静态的步骤表，所有连接共享; 每步的发送内容是常量，应答的解析和分支在处理函数中完成，
+// 处理函数只读写ServiceInfo，不持有连接状态。
+struct ConversationScript {
+    static constexpr int DONE = -1;
+    static constexpr int FAILED = -2;
+
+    std::string name;
+    std::vector<ConversationStep> steps;
+};
+
+// 按脚本执行的多步对话
+//
+// 把"发送-读取到完整应答-分支"的多步交互交给探测器的事件循环驱动，单线程上交错进行上万个对话:
+//   - 每个连接只保存脚本引用、当前步骤和得出的ServiceInfo
+//   - 对象本身从线程内的固定大小对象池分配，对话结束后归还，峰值之后创建对话不再触发堆分配
+//   - 服务端一次发来多个应答时在同一次receive中连续推进
+class ConversationDialog final : public ServiceDialog {
+public:
+    explicit ConversationDialog(const ConversationScript& script);
+
+    std::string_view request() override;
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override;
+    Status closed(std::string_view input) override;
+    std::chrono::milliseconds timeout() const override;
+
+    static void* operator new(size_t size);
+    static void operator delete(void* pointer, size_t size);
+    // 当前线程对象池已申请的块数
+    static size_t pooled();
+
+private:
+    const ConversationScript& m_script;
+    size_t m_step = 0;
+};
+
+} // namespace MindSploit::Service
@@ -0,0 +1,1047 @@
+#include "database_probes.h"
+#include <algorithm>
+#include <functional>
+#include <cctype>
+#include <cstring>
+
+namespace MindSploit::Service {
+
+namespace {
+
+uint32_t readLE16(std::string_view data, size_t offset) {
+    return static_cast<uint8_t>(data[offset]) | (static_cast<uint32_t>(static_cast<uint8_t>(data[offset + 1])) << 8);
+}
+
+uint32_t readLE32(std::string_view data, size_t offset) {
+    return readLE16(data, offset) | (readLE16(data, offset + 2) << 16);
+}
+
+uint32_t readBE32(std::string_view data, size_t offset) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(data[offset])) << 24) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(data[offset + 1])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(data[offset + 2])) << 8) |
+           static_cast<uint8_t>(data[offset + 3]);
+}
+
+void appendLE32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+void appendBE32(std::string& out, uint32_t value) {
+    for (int i = 3; i >= 0; --i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+// 以'\0'结尾的字符串，没有结尾时返回false
+bool readCString(std::string_view data, size_t& offset, std::string_view& value) {
+    size_t end = data.find('\0', offset);
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    value = data.substr(offset, end - offset);
+    offset = end + 1;
+    return true;
+}
+
+// 去掉不可打印字符，服务端返回的文本原样进入结果
+std::string printable(std::string_view text) {
+    std::string value;
+    value.reserve(text.size());
+    for (unsigned char c : text) {
+        if (c >= 0x20 && c < 0x7f) {
+            value += static_cast<char>(c);
+        }
+    }
+    while (!value.empty() && value.back() == ' ') {
+        value.pop_back();
+    }
+    return value;
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool containsIgnoreCase(std::string_view text, std::string_view needle) {
+    auto it = std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                          [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+    return it != text.end();
+}
+
+// ===== MySQL =====
+
+// 能力标志 (CLIENT_*)
+struct CapabilityFlag {
+    uint32_t bit;
+    const char* name;
+};
+
+const CapabilityFlag MYSQL_CAPABILITIES[] = {
+    {0x00000020, "compress"},
+    {0x00000200, "protocol41"},
+    {0x00000800, "ssl"},
+    {0x00008000, "secure_connection"},
+    {0x00010000, "multi_statements"},
+    {0x00080000, "plugin_auth"},
+    {0x00100000, "connect_attrs"},
+    {0x00800000, "session_track"},
+    {0x01000000, "deprecate_eof"},
+    {0x04000000, "zstd"},
+    {0x08000000, "query_attributes"},
+};
+
+// 服务端先发送握手包 (协议10) 或错误包
+class MysqlDialog : public ServiceDialog {
+public:
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)output;
+        if (input.size() < 4) {
+            return Status::NEED_MORE;
+        }
+        size_t length = input[0] & 0xff;
+        length |= static_cast<size_t>(input[1] & 0xff) << 8;
+        length |= static_cast<size_t>(input[2] & 0xff) << 16;
+        if (length == 0 || input[3] != 0) {
+            return fail("Not a MySQL handshake");
+        }
+        if (input.size() < 4 + length) {
+            return Status::NEED_MORE;
+        }
+        consumed = 4 + length;
+        std::string_view payload = input.substr(4, length);
+
+        uint8_t type = static_cast<uint8_t>(payload[0]);
+        if (type == 0xff && payload.size() >= 3) {
+            return parseError(payload);
+        }
+        if (type != 10 && type != 9) {
+            return fail("Not a MySQL handshake");
+        }
+
+        size_t offset = 1;
+        std::string_view version;
+        if (!readCString(payload, offset, version) || version.empty()) {
+            return fail("Not a MySQL handshake");
+        }
+        m_info.service = "mysql";
+        setVersion(printable(version));
+        // MySQL在握手之后总要认证，是否接受空密码需要登录尝试，这里不做
+        m_info.auth = AuthState::REQUIRED;
+        if (type == 9) {
+            m_info.addDetail("protocol", "9");
+            m_info.findings.push_back("Pre-4.1 protocol (insecure password hashing)");
+            return Status::DONE;
+        }
+
+        // 连接号(4) 认证数据1(8) 填充(1) 能力低16位(2)
+        if (payload.size() < offset + 15) {
+            return Status::DONE;
+        }
+        m_info.addDetail("connection_id", std::to_string(readLE32(payload, offset)));
+        offset += 4 + 8 + 1;
+        uint32_t capabilities = readLE16(payload, offset);
+        offset += 2;
+
+        // 字符集(1) 状态(2) 能力高16位(2) 认证数据长度(1) 保留(10)
+        uint8_t authDataLength = 0;
+        if (payload.size() >= offset + 16) {
+            m_info.addDetail("charset", std::to_string(static_cast<uint8_t>(payload[offset])));
+            capabilities |= readLE16(payload, offset + 3) << 16;
+            authDataLength = static_cast<uint8_t>(payload[offset + 5]);
+            offset += 16;
+        }
+        for (const auto& flag : MYSQL_CAPABILITIES) {
+            if (capabilities & flag.bit) {
+                m_info.capabilities.push_back(flag.name);
+            }
+        }
+        if (!(capabilities & 0x00000800)) {
+            m_info.findings.push_back("TLS not supported");
+        }
+
+        // 认证数据2 (至少13字节) 之后是认证插件名
+        if (capabilities & 0x00080000) {
+            offset += std::max<size_t>(13, authDataLength > 8 ? authDataLength - 8 : 0);
+            std::string_view plugin;
+            if (offset < payload.size()) {
+                if (!readCString(payload, offset, plugin)) {
+                    plugin = payload.substr(offset);
+                }
+                m_info.addDetail("auth_plugin", printable(plugin));
+                if (plugin == "mysql_old_password") {
+                    m_info.findings.push_back("Weak authentication plugin mysql_old_password");
+                } else if (plugin == "mysql_clear_password") {
+                    m_info.findings.push_back("Cleartext authentication plugin");
+                }
+            }
+        }
+        return Status::DONE;
+    }
+
+private:
+    void setVersion(const std::string& version) {
+        // MariaDB 10以上为兼容复制协议在版本前加 "5.5.5-"
+        std::string value = startsWith(version, "5.5.5-") ? version.substr(6) : version;
+        if (value.find("MariaDB") != std::string::npos) {
+            m_info.product = "MariaDB";
+        } else if (value.find("TiDB") != std::string::npos) {
+            m_info.product = "TiDB";
+        } else {
+            m_info.product = "MySQL";
+        }
+        m_info.version = value.substr(0, value.find('-'));
+        if (m_info.version != value) {
+            m_info.addDetail("version_string", value);
+        }
+    }
+
+    // 错误包: 0xff 错误码(2) ['#' SQLSTATE(5)] 消息
+    Status parseError(std::string_view payload) {
+        uint32_t code = readLE16(payload, 1);
+        size_t offset = 3;
+        if (payload.size() > 8 && payload[3] == '#') {
+            offset = 9;
+        }
+        m_info.service = "mysql";
+        m_info.addDetail("error_code", std::to_string(code));
+        m_info.addDetail("error", printable(payload.substr(std::min(offset, payload.size()))));
+        // 1130: 主机不允许连接  1129: 主机因连接错误过多被封禁
+        if (code == 1130 || code == 1129) {
+            m_info.auth = AuthState::DENIED;
+        }
+        return Status::DONE;
+    }
+};
+
+// ===== PostgreSQL =====
+
+class PostgresDialog : public ServiceDialog {
+public:
+    PostgresDialog() {
+        // 协议3.0的StartupMessage: 长度(4) 版本(4) 参数对 '\0'
+        std::string parameters;
+        for (const char* text : {"user", "postgres", "database", "postgres", "application_name", "mindsploit"}) {
+            parameters += text;
+            parameters += '\0';
+        }
+        parameters += '\0';
+        appendBE32(m_request, static_cast<uint32_t>(8 + parameters.size()));
+        appendBE32(m_request, 196608);
+        m_request += parameters;
+    }
+
+    std::string_view request() override { return m_request; }
+
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)output;
+        while (input.size() - consumed >= 5) {
+            std::string_view rest = input.substr(consumed);
+            char type = rest[0];
+            uint32_t length = readBE32(rest, 1);
+            if (std::strchr("REvNSKZ", type) == nullptr || type == '\0' || length < 4 || length > (1 << 20)) {
+                return fail("Not a PostgreSQL response");
+            }
+            if (rest.size() < 1 + length) {
+                return Status::NEED_MORE;
+            }
+            consumed += 1 + length;
+            m_info.service = "postgresql";
+            m_info.product = "PostgreSQL";
+
+            Status status = handleMessage(type, rest.substr(5, length - 4));
+            if (status != Status::NEED_MORE) {
+                return status;
+            }
+        }
+        return Status::NEED_MORE;
+    }
+
+    Status closed(std::string_view input) override {
+        (void)input;
+        return m_info.identified() ? Status::DONE : Status::FAILED;
+    }
+
+private:
+    Status handleMessage(char type, std::string_view body) {
+        switch (type) {
+            case 'R':
+                return body.size() >= 4 ? authentication(readBE32(body, 0), body.substr(4)) : fail("Invalid message");
+            case 'S': {
+                // trust认证后服务端报告运行参数
+                size_t offset = 0;
+                std::string_view name, value;
+                if (readCString(body, offset, name) && readCString(body, offset, value)) {
+                    if (name == "server_version") {
+                        std::string version = printable(value);
+                        m_info.version = version.substr(0, version.find(' '));
+                        if (m_info.version != version) {
+                            m_info.addDetail("version_string", version);
+                        }
+                    } else if (name == "server_encoding" || name == "is_superuser" ||
+                               name == "session_authorization") {
+                        m_info.addDetail(std::string(name), printable(value));
+                    }
+                }
+                return Status::NEED_MORE;
+            }
+            case 'E':
+                return error(body);
+            case 'Z':
+                return Status::DONE;
+            default:
+                return Status::NEED_MORE;
+        }
+    }
+
+    Status authentication(uint32_t code, std::string_view data) {
+        switch (code) {
+            case 0:
+                // 已通过认证，继续读取参数直到ReadyForQuery
+                m_info.auth = AuthState::NONE;
+                m_info.capabilities.push_back("trust");
+                m_info.findings.push_back("Trust authentication (no password for user postgres)");
+                return Status::NEED_MORE;
+            case 3:
+                m_info.capabilities.push_back("password");
+                m_info.findings.push_back("Cleartext password authentication");
+                break;
+            case 5:
+                m_info.capabilities.push_back("md5");
+                m_info.findings.push_back("MD5 password authentication");
+                break;
+            case 2:
+                m_info.capabilities.push_back("kerberos5");
+                break;
+            case 7:
+                m_info.capabilities.push_back("gss");
+                break;
+            case 9:
+                m_info.capabilities.push_back("sspi");
+                break;
+            case 10: {
+                // SASL机制列表，以空字符串结束
+                size_t offset = 0;
+                std::string_view mechanism;
+                while (readCString(data, offset, mechanism) && !mechanism.empty()) {
+                    m_info.capabilities.push_back("sasl:" + printable(mechanism));
+                }
+                break;
+            }
+            default:
+                m_info.addDetail("auth_request", std::to_string(code));
+                break;
+        }
+        m_info.auth = AuthState::REQUIRED;
+        return Status::DONE;
+    }
+
+    // 错误字段: 类型(1) 字符串'\0'，以'\0'结束
+    Status error(std::string_view body) {
+        std::string code;
+        std::string message;
+        size_t offset = 0;
+        while (offset < body.size() && body[offset] != '\0') {
+            char field = body[offset++];
+            std::string_view value;
+            if (!readCString(body, offset, value)) {
+                break;
+            }
+            if (field == 'C') {
+                code = std::string(value);
+            } else if (field == 'M') {
+                message = printable(value);
+            }
+        }
+        m_info.addDetail("error_code", code);
+        m_info.addDetail("error", message);
+
+        if (code == "28000") {
+            // pg_hba.conf中没有匹配本机的条目 (或明确reject)
+            m_info.auth = AuthState::DENIED;
+        } else if (code == "28P01") {
+            m_info.auth = AuthState::REQUIRED;
+        } else if (code == "3D000" && m_info.auth == AuthState::UNKNOWN) {
+            // 数据库不存在的检查在认证之后
+            m_info.auth = AuthState::NONE;
+        }
+        return Status::DONE;
+    }
+
+private:
+    std::string m_request;
+};
+
+// ===== Redis =====
+
+class RedisDialog : public ServiceDialog {
+public:
+    std::string_view request() override {
+        return "*2\r\n$4\r\nINFO\r\n$6\r\nserver\r\n";
+    }
+
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)output;
+        size_t lineEnd = input.find("\r\n");
+        if (lineEnd == std::string_view::npos) {
+            return input.size() > 512 ? fail("Not a Redis response") : Status::NEED_MORE;
+        }
+        std::string_view line = input.substr(0, lineEnd);
+
+        if (!line.empty() && line[0] == '-') {
+            consumed = lineEnd + 2;
+            return errorReply(line.substr(1));
+        }
+        if (line.empty() || line[0] != '$') {
+            return fail("Not a Redis response");
+        }
+
+        size_t length = 0;
+        for (char c : line.substr(1)) {
+            if (!std::isdigit((unsigned char)c) || length > (1 << 20)) {
+                return fail("Not a Redis response");
+            }
+            length = length * 10 + static_cast<size_t>(c - '0');
+        }
+        if (input.size() < lineEnd + 2 + length + 2) {
+            return Status::NEED_MORE;
+        }
+        consumed = lineEnd + 2 + length + 2;
+        parseInfo(input.substr(lineEnd + 2, length));
+        if (!m_info.identified()) {
+            return fail("Not a Redis INFO reply");
+        }
+        m_info.auth = AuthState::NONE;
+        m_info.findings.push_back("Unauthenticated access");
+        return Status::DONE;
+    }
+
+private:
+    Status errorReply(std::string_view message) {
+        m_info.service = "redis";
+        m_info.addDetail("error", printable(message));
+        if (startsWith(message, "NOAUTH") || startsWith(message, "NOPERM") ||
+            containsIgnoreCase(message, "authentication required")) {
+            m_info.auth = AuthState::REQUIRED;
+        } else if (startsWith(message, "DENIED")) {
+            // 保护模式: 没有密码且只允许本地连接
+            m_info.auth = AuthState::DENIED;
+            m_info.capabilities.push_back("protected_mode");
+        }
+        return Status::DONE;
+    }
+
+    void parseInfo(std::string_view body) {
+        size_t offset = 0;
+        while (offset < body.size()) {
+            size_t end = body.find('\n', offset);
+            if (end == std::string_view::npos) {
+                end = body.size();
+            }
+            std::string_view line = body.substr(offset, end - offset);
+            offset = end + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            size_t colon = line.find(':');
+            if (line.empty() || line[0] == '#' || colon == std::string_view::npos) {
+                continue;
+            }
+            std::string_view key = line.substr(0, colon);
+            std::string value = printable(line.substr(colon + 1));
+
+            if (key == "redis_version") {
+                m_info.service = "redis";
+                if (m_info.product.empty()) {
+                    m_info.product = "Redis";
+                    m_info.version = value;
+                }
+            } else if (key == "valkey_version" || key == "dragonfly_version") {
+                m_info.service = "redis";
+                m_info.product = key == "valkey_version" ? "Valkey" : "Dragonfly";
+                m_info.version = value;
+            } else if (key == "redis_mode") {
+                m_info.capabilities.push_back(value);
+            } else if (key == "os" || key == "arch_bits" || key == "process_id" || key == "tcp_port" ||
+                       key == "uptime_in_days" || key == "executable" || key == "config_file") {
+                m_info.addDetail(std::string(key), value);
+            }
+        }
+    }
+};
+
+// ===== MongoDB =====
+
+// 遍历BSON文档的顶层元素，value为元素值的原始字节
+bool forEachBsonField(std::string_view document,
+                      const std::function<void(uint8_t type, std::string_view name, std::string_view value)>& visit) {
+    if (document.size() < 5 || readLE32(document, 0) != document.size()) {
+        return false;
+    }
+    size_t offset = 4;
+    while (offset < document.size()) {
+        uint8_t type = static_cast<uint8_t>(document[offset++]);
+        if (type == 0) {
+            return true;
+        }
+        std::string_view name;
+        if (!readCString(document, offset, name)) {
+            return false;
+        }
+
+        size_t remaining = document.size() - offset;
+        size_t size;
+        switch (type) {
+            case 0x01: case 0x09: case 0x11: case 0x12: size = 8; break;
+            case 0x07: size = 12; break;
+            case 0x08: size = 1; break;
+            case 0x10: size = 4; break;
+            case 0x13: size = 16; break;
+            case 0x06: case 0x0a: case 0x7f: case 0xff: size = 0; break;
+            case 0x02: case 0x0d: case 0x0e:
+                size = remaining >= 4 ? 4 + readLE32(document, offset) : remaining + 1;
+                break;
+            case 0x03: case 0x04: case 0x0f:
+                size = remaining >= 4 ? readLE32(document, offset) : remaining + 1;
+                break;
+            case 0x05:
+                size = remaining >= 4 ? 5 + static_cast<size_t>(readLE32(document, offset)) : remaining + 1;
+                break;
+            case 0x0b: {
+                size_t end = offset;
+                std::string_view pattern, options;
+                if (!readCString(document, end, pattern) || !readCString(document, end, options)) {
+                    return false;
+                }
+                size = end - offset;
+                break;
+            }
+            case 0x0c:
+                size = remaining >= 4 ? 4 + static_cast<size_t>(readLE32(document, offset)) + 12 : remaining + 1;
+                break;
+            default:
+                return false;
+        }
+        if (size > remaining) {
+            return false;
+        }
+        visit(type, name, document.substr(offset, size));
+        offset += size;
+    }
+    return false;
+}
+
+std::string bsonString(uint8_t type, std::string_view value) {
+    if (type != 0x02 || value.size() < 5) {
+        return "";
+    }
+    return printable(value.substr(4, value.size() - 5));
+}
+
+// 数值元素 (double、int32、int64、bool)
+double bsonNumber(uint8_t type, std::string_view value) {
+    switch (type) {
+        case 0x01: {
+            double number;
+            std::memcpy(&number, value.data(), sizeof(number));
+            return number;
+        }
+        case 0x10:
+            return static_cast<int32_t>(readLE32(value, 0));
+        case 0x12:
+            return static_cast<double>(static_cast<int64_t>(readLE32(value, 0) | (uint64_t(readLE32(value, 4)) << 32)));
+        case 0x08:
+            return value[0] != 0 ? 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+class BsonBuilder {
+public:
+    BsonBuilder& int32(const char* name, int32_t value) {
+        m_body += '\x10';
+        m_body.append(name, std::strlen(name) + 1);
+        appendLE32(m_body, static_cast<uint32_t>(value));
+        return *this;
+    }
+
+    BsonBuilder& boolean(const char* name, bool value) {
+        m_body += '\x08';
+        m_body.append(name, std::strlen(name) + 1);
+        m_body += value ? '\x01' : '\x00';
+        return *this;
+    }
+
+    BsonBuilder& string(const char* name, const std::string& value) {
+        m_body += '\x02';
+        m_body.append(name, std::strlen(name) + 1);
+        appendLE32(m_body, static_cast<uint32_t>(value.size() + 1));
+        m_body.append(value.c_str(), value.size() + 1);
+        return *this;
+    }
+
+    std::string finish() const {
+        std::string document;
+        appendLE32(document, static_cast<uint32_t>(m_body.size() + 5));
+        document += m_body;
+        document += '\0';
+        return document;
+    }
+
+private:
+    std::string m_body;
+};
+
+// isMaster用OP_QUERY (所有版本的握手都接受)，之后两个用OP_MSG (3.6起)，三个请求一次发出
+class MongoDialog : public ServiceDialog {
+public:
+    MongoDialog() {
+        std::string query;
+        appendLE32(query, 0);
+        query.append("admin.$cmd", 11);
+        appendLE32(query, 0);
+        appendLE32(query, static_cast<uint32_t>(-1));
+        query += BsonBuilder().int32("isMaster", 1).finish();
+        appendMessage(REQUEST_IS_MASTER, OP_QUERY, query);
+
+        appendCommand(REQUEST_BUILD_INFO, BsonBuilder().int32("buildInfo", 1).string("$db", "admin").finish());
+        appendCommand(REQUEST_LIST_DATABASES,
+                      BsonBuilder().int32("listDatabases", 1).boolean("nameOnly", true).string("$db", "admin").finish());
+    }
+
+    std::string_view request() override { return m_request; }
+
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)output;
+        while (input.size() - consumed >= 16) {
+            std::string_view rest = input.substr(consumed);
+            uint32_t length = readLE32(rest, 0);
+            uint32_t responseTo = readLE32(rest, 8);
+            uint32_t opCode = readLE32(rest, 12);
+            if (length < 16 || length > (48u << 20) || (opCode != OP_REPLY && opCode != OP_MSG) ||
+                responseTo < REQUEST_IS_MASTER || responseTo > REQUEST_LIST_DATABASES) {
+                return fail("Not a MongoDB response");
+            }
+            if (rest.size() < length) {
+                return Status::NEED_MORE;
+            }
+            consumed += length;
+
+            // OP_REPLY: 标志(4) 游标(8) 起始(4) 数量(4) 文档  OP_MSG: 标志(4) 类型0(1) 文档
+            size_t documentOffset = opCode == OP_REPLY ? 36 : 21;
+            if (length <= documentOffset || (opCode == OP_MSG && rest[20] != 0)) {
+                return fail("Unsupported MongoDB reply");
+            }
+            std::string_view document = rest.substr(documentOffset, length - documentOffset);
+            if (!handleReply(responseTo, document)) {
+                return fail("Invalid BSON reply");
+            }
+            if (++m_replies == 3) {
+                return Status::DONE;
+            }
+        }
+        return Status::NEED_MORE;
+    }
+
+    // 3.6之前的服务端不认识OP_MSG，收到后断开
+    Status closed(std::string_view input) override {
+        (void)input;
+        return m_info.identified() ? Status::DONE : Status::FAILED;
+    }
+
+private:
+    static constexpr uint32_t OP_REPLY = 1;
+    static constexpr uint32_t OP_QUERY = 2004;
+    static constexpr uint32_t OP_MSG = 2013;
+    static constexpr uint32_t REQUEST_IS_MASTER = 1;
+    static constexpr uint32_t REQUEST_BUILD_INFO = 2;
+    static constexpr uint32_t REQUEST_LIST_DATABASES = 3;
+
+    void appendMessage(uint32_t requestId, uint32_t opCode, const std::string& body) {
+        appendLE32(m_request, static_cast<uint32_t>(16 + body.size()));
+        appendLE32(m_request, requestId);
+        appendLE32(m_request, 0);
+        appendLE32(m_request, opCode);
+        m_request += body;
+    }
+
+    void appendCommand(uint32_t requestId, const std::string& document) {
+        std::string body;
+        appendLE32(body, 0);
+        body += '\0';
+        body += document;
+        appendMessage(requestId, OP_MSG, body);
+    }
+
+    bool handleReply(uint32_t request, std::string_view document) {
+        bool ok = false;
+        int code = 0;
+        std::string errorMessage;
+        bool parsed = forEachBsonField(document, [&](uint8_t type, std::string_view name, std::string_view value) {
+            if (name == "ok") {
+                ok = bsonNumber(type, value) == 1;
+            } else if (name == "code") {
+                code = static_cast<int>(bsonNumber(type, value));
+            } else if (name == "errmsg") {
+                errorMessage = bsonString(type, value);
+            } else if (request == REQUEST_IS_MASTER) {
+                isMasterField(type, name, value);
+            } else if (request == REQUEST_BUILD_INFO) {
+                buildInfoField(type, name, value);
+            }
+        });
+        if (!parsed) {
+            return false;
+        }
+        m_info.service = "mongodb";
+        m_info.product = "MongoDB";
+
+        // 13: Unauthorized
+        if (request == REQUEST_LIST_DATABASES) {
+            if (ok) {
+                m_info.auth = AuthState::NONE;
+                m_info.findings.push_back("Unauthenticated access (listDatabases allowed)");
+            } else if (code == 13) {
+                m_info.auth = AuthState::REQUIRED;
+            } else {
+                m_info.addDetail("list_databases_error", errorMessage);
+            }
+        } else if (request == REQUEST_BUILD_INFO && !ok && code == 13) {
+            m_info.auth = AuthState::REQUIRED;
+        }
+        return true;
+    }
+
+    void isMasterField(uint8_t type, std::string_view name, std::string_view value) {
+        if (name == "maxWireVersion" || name == "minWireVersion") {
+            m_info.addDetail(name == "maxWireVersion" ? "max_wire_version" : "min_wire_version",
+                             std::to_string(static_cast<int>(bsonNumber(type, value))));
+        } else if (name == "setName") {
+            m_info.capabilities.push_back("replica_set");
+            m_info.addDetail("replica_set", bsonString(type, value));
+        } else if (name == "msg" && bsonString(type, value) == "isdbgrid") {
+            m_info.capabilities.push_back("mongos");
+        } else if (name == "saslSupportedMechs" && type == 0x04) {
+            forEachBsonField(value, [&](uint8_t itemType, std::string_view, std::string_view item) {
+                m_info.capabilities.push_back("sasl:" + bsonString(itemType, item));
+            });
+        } else if (name == "compression" && type == 0x04) {
+            forEachBsonField(value, [&](uint8_t itemType, std::string_view, std::string_view item) {
+                m_info.capabilities.push_back("compression:" + bsonString(itemType, item));
+            });
+        }
+    }
+
+    void buildInfoField(uint8_t type, std::string_view name, std::string_view value) {
+        if (name == "version") {
+            m_info.version = bsonString(type, value);
+        } else if (name == "gitVersion") {
+            m_info.addDetail("git_version", bsonString(type, value));
+        } else if (name == "modules" && type == 0x04) {
+            forEachBsonField(value, [&](uint8_t itemType, std::string_view, std::string_view item) {
+                m_info.capabilities.push_back(bsonString(itemType, item));
+            });
+        } else if (name == "openssl" && type == 0x03) {
+            m_info.capabilities.push_back("tls");
+        }
+    }
+
+private:
+    std::string m_request;
+    int m_replies = 0;
+};
+
+// ===== Memcached =====
+
+class MemcachedDialog : public ServiceDialog {
+public:
+    std::string_view request() override { return "stats\r\n"; }
+
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)output;
+        while (true) {
+            size_t end = input.find("\r\n", consumed);
+            if (end == std::string_view::npos) {
+                return input.size() - consumed > 1024 ? fail("Not a memcached response") : Status::NEED_MORE;
+            }
+            std::string_view line = input.substr(consumed, end - consumed);
+            consumed = end + 2;
+
+            if (line == "END") {
+                if (!m_info.identified()) {
+                    return fail("Not a memcached response");
+                }
+                m_info.auth = AuthState::NONE;
+                m_info.findings.push_back("Unauthenticated access");
+                return Status::DONE;
+            }
+            if (startsWith(line, "CLIENT_ERROR") && !m_info.identified()) {
+                // 启用SASL后文本协议的命令都被拒绝
+                m_info.service = "memcached";
+                m_info.product = "memcached";
+                m_info.auth = AuthState::REQUIRED;
+                m_info.addDetail("error", printable(line));
+                return Status::DONE;
+            }
+            if (!startsWith(line, "STAT ")) {
+                return fail("Not a memcached response");
+            }
+
+            line.remove_prefix(5);
+            size_t space = line.find(' ');
+            std::string_view key = line.substr(0, space);
+            std::string value = space == std::string_view::npos ? "" : printable(line.substr(space + 1));
+            m_info.service = "memcached";
+            m_info.product = "memcached";
+            if (key == "version") {
+                m_info.version = value;
+            } else if (key == "pid" || key == "uptime" || key == "curr_connections" || key == "threads" ||
+                       key == "curr_items" || key == "pointer_size" || key == "libevent") {
+                m_info.addDetail(std::string(key), value);
+            }
+        }
+    }
+};
+
+// ===== Elasticsearch =====
+
+// JSON中第一个 "key": "value" 的字符串值 (不处理转义和嵌套层次)
+std::string jsonString(std::string_view body, std::string_view key) {
+    std::string quoted = "\"" + std::string(key) + "\"";
+    size_t pos = body.find(quoted);
+    if (pos == std::string_view::npos) {
+        return "";
+    }
+    pos = body.find_first_not_of(" \t\r\n", pos + quoted.size());
+    if (pos == std::string_view::npos || body[pos] != ':') {
+        return "";
+    }
+    pos = body.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string_view::npos || body[pos] != '"') {
+        return "";
+    }
+    size_t end = body.find('"', pos + 1);
+    return end == std::string_view::npos ? "" : printable(body.substr(pos + 1, end - pos - 1));
+}
+
+std::string headerValue(std::string_view headers, std::string_view name) {
+    size_t offset = 0;
+    while (offset < headers.size()) {
+        size_t end = headers.find("\r\n", offset);
+        if (end == std::string_view::npos) {
+            end = headers.size();
+        }
+        std::string_view line = headers.substr(offset, end - offset);
+        offset = end + 2;
+        size_t colon = line.find(':');
+        if (colon == name.size() && containsIgnoreCase(line.substr(0, colon), name)) {
+            std::string_view value = line.substr(colon + 1);
+            size_t start = value.find_first_not_of(' ');
+            return start == std::string_view::npos ? "" : printable(value.substr(start));
+        }
+    }
+    return "";
+}
+
+class ElasticsearchDialog : public ServiceDialog {
+public:
+    explicit ElasticsearchDialog(const std::string& host)
+        : m_request("GET / HTTP/1.1\r\nHost: " + host +
+                    "\r\nUser-Agent: MindSploit\r\nAccept: application/json\r\nConnection: close\r\n\r\n") {}
+
+    std::string_view request() override { return m_request; }
+
+    // 应答不大，整体留在缓冲区中直到完整
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override {
+        (void)consumed;
+        (void)output;
+        size_t prefix = std::min<size_t>(5, input.size());
+        if (input.substr(0, prefix) != std::string_view("HTTP/").substr(0, prefix)) {
+            return fail("Not an HTTP response");
+        }
+        size_t headerEnd = input.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos) {
+            return Status::NEED_MORE;
+        }
+        std::string length = headerValue(input.substr(0, headerEnd + 2), "content-length");
+        if (length.empty()) {
+            return Status::NEED_MORE;
+        }
+        size_t bodyLength = 0;
+        try {
+            bodyLength = std::stoul(length);
+        } catch (const std::exception&) {
+            return fail("Invalid Content-Length");
+        }
+        if (input.size() < headerEnd + 4 + bodyLength) {
+            return Status::NEED_MORE;
+        }
+        return analyze(input.substr(0, headerEnd + 2), input.substr(headerEnd + 4, bodyLength));
+    }
+
+    // 没有Content-Length时以连接关闭为结束
+    Status closed(std::string_view input) override {
+        size_t headerEnd = input.find("\r\n\r\n");
+        if (!startsWith(input, "HTTP/") || headerEnd == std::string_view::npos) {
+            return fail("Connection closed by peer");
+        }
+        return analyze(input.substr(0, headerEnd + 2), input.substr(headerEnd + 4));
+    }
+
+private:
+    Status analyze(std::string_view headers, std::string_view body) {
+        int status = 0;
+        size_t space = headers.find(' ');
+        if (space != std::string_view::npos && headers.size() >= space + 4) {
+            for (char c : headers.substr(space + 1, 3)) {
+                status = status * 10 + (std::isdigit((unsigned char)c) ? c - '0' : 0);
+            }
+        }
+        std::string product = headerValue(headers, "x-elastic-product");
+        std::string authenticate = headerValue(headers, "www-authenticate");
+        m_info.addDetail("status", std::to_string(status));
+
+        if (status == 200 && body.find("\"cluster_name\"") != std::string_view::npos &&
+            body.find("\"number\"") != std::string_view::npos) {
+            m_info.service = "elasticsearch";
+            m_info.version = jsonString(body, "number");
+            std::string distribution = jsonString(body, "distribution");
+            m_info.product = distribution == "opensearch" ? "OpenSearch" : "Elasticsearch";
+            m_info.addDetail("cluster_name", jsonString(body, "cluster_name"));
+            m_info.addDetail("node_name", jsonString(body, "name"));
+            m_info.addDetail("lucene_version", jsonString(body, "lucene_version"));
+            std::string flavor = jsonString(body, "build_flavor");
+            if (!flavor.empty()) {
+                m_info.capabilities.push_back(flavor);
+            }
+            m_info.auth = AuthState::NONE;
+            m_info.findings.push_back("Security disabled (unauthenticated cluster access)");
+            return Status::DONE;
+        }
+
+        if (status == 401 && (!product.empty() || containsIgnoreCase(authenticate, "security") ||
+                              body.find("security_exception") != std::string_view::npos)) {
+            m_info.service = "elasticsearch";
+            m_info.product = containsIgnoreCase(authenticate, "opensearch") ? "OpenSearch" : "Elasticsearch";
+            m_info.auth = AuthState::REQUIRED;
+            m_info.addDetail("authenticate", authenticate);
+            return Status::DONE;
+        }
+        if (!product.empty()) {
+            m_info.service = "elasticsearch";
+            m_info.product = product;
+            return Status::DONE;
+        }
+        return fail("Not an Elasticsearch response (HTTP " + std::to_string(status) + ")");
+    }
+
+private:
+    std::string m_request;
+};
+
+struct ProtocolEntry {
+    DatabaseProtocol protocol;
+    const char* name;
+    std::vector<int> ports;
+    std::vector<const char*> services;          // 端口扫描结果中的服务名
+};
+
+const std::vector<ProtocolEntry>& protocolTable() {
+    static const std::vector<ProtocolEntry> table = {
+        {DatabaseProtocol::MYSQL, "mysql", {3306, 3307, 4000}, {"mysql", "mariadb"}},
+        {DatabaseProtocol::POSTGRESQL, "postgresql", {5432, 5433}, {"postgresql", "postgres"}},
+        {DatabaseProtocol::REDIS, "redis", {6379, 6380}, {"redis"}},
+        {DatabaseProtocol::MONGODB, "mongodb", {27017, 27018, 27019}, {"mongodb", "mongod"}},
+        {DatabaseProtocol::MEMCACHED, "memcached", {11211}, {"memcached", "memcache"}},
+        {DatabaseProtocol::ELASTICSEARCH, "elasticsearch", {9200}, {"elasticsearch", "opensearch"}},
+    };
+    return table;
+}
+
+} // namespace
+
+std::string protocolName(DatabaseProtocol protocol) {
+    for (const auto& entry : protocolTable()) {
+        if (entry.protocol == protocol) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+bool parseProtocol(const std::string& name, DatabaseProtocol& protocol) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "postgres" || lower == "pgsql") {
+        lower = "postgresql";
+    } else if (lower == "mongo") {
+        lower = "mongodb";
+    } else if (lower == "es" || lower == "opensearch") {
+        lower = "elasticsearch";
+    }
+    for (const auto& entry : protocolTable()) {
+        if (lower == entry.name) {
+            protocol = entry.protocol;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<DatabaseProtocol>& databaseProtocols() {
+    static const std::vector<DatabaseProtocol> protocols = [] {
+        std::vector<DatabaseProtocol> list;
+        for (const auto& entry : protocolTable()) {
+            list.push_back(entry.protocol);
+        }
+        return list;
+    }();
+    return protocols;
+}
+
+bool protocolForService(int port, const std::string& service, DatabaseProtocol& protocol) {
+    // 服务名优先，非标准端口上的服务由服务识别给出
+    for (const auto& entry : protocolTable()) {
+        for (const char* name : entry.services) {
+            if (service == name) {
+                protocol = entry.protocol;
+                return true;
+            }
+        }
+    }
+    for (const auto& entry : protocolTable()) {
+        if (std::find(entry.ports.begin(), entry.ports.end(), port) != entry.ports.end()) {
+            protocol = entry.protocol;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<int>& defaultDatabasePorts() {
+    static const std::vector<int> ports = [] {
+        std::vector<int> list;
+        for (const auto& entry : protocolTable()) {
+            list.insert(list.end(), entry.ports.begin(), entry.ports.end());
+        }
+        return list;
+    }();
+    return ports;
+}
+
+std::unique_ptr<ServiceDialog> createDatabaseDialog(DatabaseProtocol protocol, const std::string& host) {
+    switch (protocol) {
+        case DatabaseProtocol::MYSQL: return std::make_unique<MysqlDialog>();
+        case DatabaseProtocol::POSTGRESQL: return std::make_unique<PostgresDialog>();
+        case DatabaseProtocol::REDIS: return std::make_unique<RedisDialog>();
+        case DatabaseProtocol::MONGODB: return std::make_unique<MongoDialog>();
+        case DatabaseProtocol::MEMCACHED: return std::make_unique<MemcachedDialog>();
+        case DatabaseProtocol::ELASTICSEARCH: return std::make_unique<ElasticsearchDialog>(host);
+    }
+    return nullptr;
+}
+
+} // namespace MindSploit::Service
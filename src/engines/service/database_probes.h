@@ -0,0 +1,36 @@
+#pragma once
+
+#include "service_prober.h"
+
+namespace MindSploit::Service {
+
+// 数据库与缓存服务协议
+enum class DatabaseProtocol {
+    MYSQL,
+    POSTGRESQL,
+    REDIS,
+    MONGODB,
+    MEMCACHED,
+    ELASTICSEARCH
+};
+
+std::string protocolName(DatabaseProtocol protocol);
+bool parseProtocol(const std::string& name, DatabaseProtocol& protocol);
+const std::vector<DatabaseProtocol>& databaseProtocols();
+
+// 端口扫描给出的服务名或默认端口对应的协议
+bool protocolForService(int port, const std::string& service, DatabaseProtocol& protocol);
+const std::vector<int>& defaultDatabasePorts();
+
+// 握手级探测对话，一次往返得出版本、认证要求和能力:
+//   - MySQL: 读取服务端握手包 (版本、能力标志、认证插件)，不发送任何数据
+//   - PostgreSQL: 发送StartupMessage，由认证请求类型判断认证方式，trust时读取server_version
+//   - Redis: 发送INFO server，NOAUTH/DENIED应答即需要认证或处于保护模式
+//   - MongoDB: 一次发出isMaster、buildInfo和listDatabases三个请求
+//   - Memcached: 发送stats
+//   - Elasticsearch/OpenSearch: GET /，401即启用了安全认证
+// 都不尝试登录，只根据服务端在认证之前公开的信息得出结论。
+// host用于HTTP请求的Host头。
+std::unique_ptr<ServiceDialog> createDatabaseDialog(DatabaseProtocol protocol, const std::string& host);
+
+} // namespace MindSploit::Service
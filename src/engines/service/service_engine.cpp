@@ -0,0 +1,751 @@
+#include "service_engine.h"
+#include "ssh_probe.h"
+#include "../network/scan_baseline.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/target_space.h"
+#include "../../utils/json_utils.h"
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+namespace MindSploit::Service {
+
+namespace {
+
+std::string serviceRecord(const ServiceEndpoint& endpoint, const ServiceInfo& info,
+                          std::chrono::milliseconds elapsed) {
+    std::string details;
+    for (const auto& entry : info.details) {
+        details += (details.empty() ? "\"" : ",\"") + Utils::jsonEscape(entry.first) + "\":\"" +
+                   Utils::jsonEscape(entry.second) + "\"";
+    }
+    return "{\"ip\":\"" + Utils::jsonEscape(endpoint.ip) + "\",\"port\":" + std::to_string(endpoint.port) +
+           ",\"service\":\"" + Utils::jsonEscape(info.service) + "\",\"product\":\"" + Utils::jsonEscape(info.product) +
+           "\",\"version\":\"" + Utils::jsonEscape(info.version) + "\",\"auth\":\"" + authStateName(info.auth) +
+           "\",\"capabilities\":" + Utils::jsonArray(info.capabilities) + ",\"details\":{" + details +
+           "},\"findings\":" + Utils::jsonArray(info.findings) +
+           ",\"elapsed_ms\":" + std::to_string(elapsed.count()) + "}";
+}
+
+std::string joinList(const std::vector<std::string>& values) {
+    std::string text;
+    for (const auto& value : values) {
+        text += (text.empty() ? "" : ",") + value;
+    }
+    return text;
+}
+
+} // namespace
+
+ServiceEngine::ServiceEngine() {
+    m_options["timeout"] = "5000";
+    m_options["concurrency"] = "1000";
+    m_options["hostkey"] = "off";
+}
+
+ServiceEngine::~ServiceEngine() {
+    shutdown();
+}
+
+bool ServiceEngine::initialize() {
+    if (!Utils::NetworkUtils::initialize()) {
+        return false;
+    }
+
+    m_status = EngineStatus::IDLE;
+    return true;
+}
+
+bool ServiceEngine::shutdown() {
+    stop();
+    return true;
+}
+
+ExecutionResult ServiceEngine::execute(const CommandContext& context) {
+    ExecutionResult result;
+
+    if (context.command == "dbscan") {
+        result = executeDatabaseScan(context);
+    } else if (context.command == "sshscan") {
+        result = executeSshScan(context);
+    } else if (context.command == "capscan") {
+        result = executeCapabilityScan(context);
+    } else {
+        result.success = false;
+        result.message = "Unsupported command: " + context.command;
+    }
+
+    return result;
+}
+
+void ServiceEngine::stop() {
+    m_stopRequested = true;
+}
+
+EngineStatus ServiceEngine::getStatus() const {
+    return m_status;
+}
+
+std::string ServiceEngine::getDescription() const {
+    return "Protocol-native service probing engine";
+}
+
+std::vector<std::string> ServiceEngine::getSupportedCommands() const {
+    return {"dbscan", "sshscan", "capscan"};
+}
+
+std::map<std::string, std::string> ServiceEngine::getRequiredParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "dbscan" || command == "sshscan" || command == "capscan") {
+        params["target"] = "Target host[:port], IP address, range or CIDR";
+    }
+
+    return params;
+}
+
+std::map<std::string, std::string> ServiceEngine::getOptionalParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "dbscan") {
+        params["ports"] = "Ports to probe (default: standard database and cache ports)";
+        params["protocols"] = "Protocols to probe: mysql,postgresql,redis,mongodb,memcached,elasticsearch";
+        params["from-scan"] = "Probe open database ports of a previous scan (latest or result id)";
+        params["concurrency"] = "Maximum concurrent connections (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    } else if (command == "sshscan") {
+        params["ports"] = "Ports to probe (default: 22)";
+        params["from-scan"] = "Probe open SSH ports of a previous scan (latest or result id)";
+        params["hostkey"] = "on fetches the host key through a minimal curve25519 key exchange (default: off)";
+        params["concurrency"] = "Maximum concurrent connections (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    } else if (command == "capscan") {
+        params["ports"] = "Ports to probe (default: 21,25,110,143,587,2525)";
+        params["protocols"] = "Protocols to probe: smtp,ftp,pop3,imap";
+        params["from-scan"] = "Probe open mail and FTP ports of a previous scan (latest or result id)";
+        params["concurrency"] = "Maximum concurrent connections (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    }
+
+    params["timeout"] = "Connect and response timeout in milliseconds";
+
+    return params;
+}
+
+bool ServiceEngine::setOption(const std::string& key, const std::string& value) {
+    m_options[key] = value;
+    return true;
+}
+
+std::string ServiceEngine::getOption(const std::string& key) const {
+    auto it = m_options.find(key);
+    return (it != m_options.end()) ? it->second : "";
+}
+
+std::map<std::string, std::string> ServiceEngine::getAllOptions() const {
+    return m_options;
+}
+
+bool ServiceEngine::checkDependencies() const {
+    return true;
+}
+
+std::vector<std::string> ServiceEngine::getMissingDependencies() const {
+    return {};
+}
+
+std::string ServiceEngine::getHelp() const {
+    return R"(
+Service Engine - 服务探测引擎
+
+支持的命令:
+  dbscan <target|host:port> [options] - 数据库与缓存服务探测，识别版本、认证要求和能力
+  sshscan <target|host:port> [options] - SSH版本与算法枚举，检查弱算法
+  capscan <target|host:port> [options] - SMTP、FTP、POP3、IMAP的问候语与能力探测
+
+选项:
+  -ports <range>         - 探测端口 (默认各协议的标准端口)
+  -protocols <list>      - 只探测指定协议: mysql,postgresql,redis,mongodb,memcached,elasticsearch
+                           (capscan: smtp,ftp,pop3,imap)
+                           非标准端口按此推断协议，只指定一个协议时所有端口都按该协议探测
+  -from-scan <ref>       - 探测端口扫描结果中对应协议的开放端口 (latest 或结果编号)
+  -hostkey <on|off>      - sshscan: 以最小的curve25519密钥交换取得主机密钥及指纹 (默认 off)
+  -concurrency <num>     - 同时进行的连接上限 (默认 1000)
+  -timeout <ms>          - 连接和应答超时时间 (毫秒)
+  -output <file>         - 结果以JSON行写入文件
+
+说明:
+  每个端点一次连接、一次往返，只读取服务端在认证之前公开的信息，不尝试登录。
+  sshscan在收到服务端KEXINIT后即断开，取主机密钥时在KEX_ECDH_REPLY之后断开。
+  capscan按协议脚本进行多步对话: 问候语之后查询EHLO/FEAT/CAPA/CAPABILITY，
+  SMTP声明STARTTLS时发送STARTTLS确认，收到220后断开，不进行TLS握手。
+  auth: none (无需认证即可访问)、required、denied (拒绝本机连接)、unknown
+
+示例:
+  dbscan 192.168.1.10
+  dbscan 10.0.0.0/24 -protocols redis,memcached
+  dbscan db.example.com:15432 -protocols postgresql
+  dbscan 10.0.0.0/16 -from-scan latest
+  sshscan 10.0.0.0/24 -hostkey on
+  sshscan 10.0.0.0/16 -from-scan latest
+  capscan mail.example.com
+  capscan 10.0.0.0/24 -protocols smtp -ports 25,587,10025
+)";
+}
+
+std::string ServiceEngine::getCommandHelp(const std::string& command) const {
+    if (command == "dbscan") {
+        return "dbscan <target|host:port> [options] - 以协议握手并发探测MySQL、PostgreSQL、Redis、MongoDB、Memcached和Elasticsearch";
+    }
+    if (command == "sshscan") {
+        return "sshscan <target|host:port> [options] - 交换标识串并解析KEXINIT，枚举密钥交换、主机密钥、加密和MAC算法";
+    }
+    if (command == "capscan") {
+        return "capscan <target|host:port> [options] - 多步对话探测SMTP、FTP、POP3和IMAP的问候语、能力和STARTTLS支持";
+    }
+
+    return "";
+}
+
+ExecutionResult ServiceEngine::executeDatabaseScan(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for dbscan command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    // -protocols: 限定协议，只有一个时非标准端口也按它探测
+    std::vector<DatabaseProtocol> protocols;
+    std::stringstream protocolList(parameter(context, "protocols"));
+    std::string name;
+    while (std::getline(protocolList, name, ',')) {
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (name.empty()) {
+            continue;
+        }
+        DatabaseProtocol protocol;
+        if (!parseProtocol(name, protocol)) {
+            result.success = false;
+            result.message = "Unknown protocol: " + name;
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+        protocols.push_back(protocol);
+    }
+    auto resolve = [&](int port, const std::string& service, bool fromScan, std::string& resolved) {
+        DatabaseProtocol protocol;
+        if (protocolForService(port, service, protocol)) {
+            if (!protocols.empty() && std::find(protocols.begin(), protocols.end(), protocol) == protocols.end()) {
+                return false;
+            }
+        } else if (!fromScan && protocols.size() == 1) {
+            protocol = protocols.front();
+        } else {
+            return false;
+        }
+        resolved = protocolName(protocol);
+        return true;
+    };
+
+    std::vector<ServiceEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, defaultDatabasePorts(), resolve, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的数据库端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    notifyOutput(context, "数据库服务探测 " + std::to_string(endpoints.size()) + " 个端点");
+
+    uint64_t unauthenticated = 0;
+    auto createDialog = [](const ServiceEndpoint& endpoint) -> std::unique_ptr<ServiceDialog> {
+        DatabaseProtocol protocol;
+        if (!parseProtocol(endpoint.protocol, protocol)) {
+            return nullptr;
+        }
+        return createDatabaseDialog(protocol, endpoint.ip + ":" + std::to_string(endpoint.port));
+    };
+    auto onIdentified = [&](const ServiceEndpoint& endpoint, const ServiceInfo& info,
+                            const ServiceProbeResult& probe) {
+        if (info.auth == AuthState::NONE) {
+            ++unauthenticated;
+        }
+
+        std::string line = "[" + info.service + "] " + endpoint.ip + ":" + std::to_string(endpoint.port);
+        if (!info.product.empty()) {
+            line += "  " + info.product + (info.version.empty() ? "" : " " + info.version);
+        }
+        line += "  auth=" + authStateName(info.auth);
+        if (!info.capabilities.empty()) {
+            line += "  " + joinList(info.capabilities);
+        }
+        if (!probe.ok()) {
+            line += "  (" + probe.error + ")";
+        }
+        notifyOutput(context, line);
+        for (const auto& finding : info.findings) {
+            notifyOutput(context, "    [!] " + finding);
+        }
+        return serviceRecord(endpoint, info, probe.elapsed);
+    };
+
+    ProbeSummary summary;
+    if (!runProbes(context, endpoints, createDialog, onIdentified, summary, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    result.success = true;
+    result.message = "数据库服务探测完成，" + std::to_string(summary.identified) + " 个已识别, " +
+                     std::to_string(summary.failed) + " 个失败";
+    if (unauthenticated > 0) {
+        result.message += ", " + std::to_string(unauthenticated) + " 个无需认证";
+    }
+    result.data["identified"] = std::to_string(summary.identified);
+    result.data["failures"] = std::to_string(summary.failed);
+    result.data["unauthenticated"] = std::to_string(unauthenticated);
+    result.data["peak_connections"] = std::to_string(summary.stats.peakConnections);
+    result.data["receive_buffers"] = std::to_string(summary.stats.buffers);
+    result.data["elapsed_ms"] = std::to_string(summary.elapsed.count());
+    result.data["results"] = summary.records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+ExecutionResult ServiceEngine::executeSshScan(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for sshscan command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::string hostKeyOption = parameter(context, "hostkey");
+    if (hostKeyOption != "on" && hostKeyOption != "off") {
+        result.success = false;
+        result.message = "Invalid hostkey option: " + hostKeyOption + " (expected on or off)";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    const bool fetchHostKey = hostKeyOption == "on";
+
+    // 扫描结果中只取识别为ssh或在22端口的服务，显式指定的端口都按SSH探测
+    auto resolve = [](int port, const std::string& service, bool fromScan, std::string& protocol) {
+        if (fromScan && service != "ssh" && port != 22) {
+            return false;
+        }
+        protocol = "ssh";
+        return true;
+    };
+
+    std::vector<ServiceEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, {22}, resolve, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的SSH端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    notifyOutput(context, "SSH探测 " + std::to_string(endpoints.size()) + " 个端点" +
+                 (fetchHostKey ? " (获取主机密钥)" : ""));
+
+    uint64_t weakServers = 0;
+    uint64_t hostKeys = 0;
+    auto createDialog = [fetchHostKey](const ServiceEndpoint&) -> std::unique_ptr<ServiceDialog> {
+        return std::make_unique<SshDialog>(fetchHostKey);
+    };
+    auto onIdentified = [&](const ServiceEndpoint& endpoint, const ServiceInfo& info,
+                            const ServiceProbeResult& probe) {
+        std::string line = "[ssh] " + endpoint.ip + ":" + std::to_string(endpoint.port) + "  " + info.product;
+        if (!info.version.empty()) {
+            line += " " + info.version;
+        }
+        for (const auto& detail : info.details) {
+            if (detail.first == "hostkey_sha256") {
+                ++hostKeys;
+                line += "  " + detail.second;
+            } else if (detail.first == "hostkey_type" || detail.first == "hostkey_bits") {
+                line += "  " + detail.second;
+            }
+        }
+        if (!probe.ok()) {
+            line += "  (" + probe.error + ")";
+        }
+        notifyOutput(context, line);
+        if (!info.findings.empty()) {
+            ++weakServers;
+        }
+        for (const auto& finding : info.findings) {
+            notifyOutput(context, "    [!] " + finding);
+        }
+        return serviceRecord(endpoint, info, probe.elapsed);
+    };
+
+    ProbeSummary summary;
+    if (!runProbes(context, endpoints, createDialog, onIdentified, summary, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    result.success = true;
+    result.message = "SSH探测完成，" + std::to_string(summary.identified) + " 个已识别, " +
+                     std::to_string(summary.failed) + " 个失败";
+    if (weakServers > 0) {
+        result.message += ", " + std::to_string(weakServers) + " 个存在弱算法或已知问题";
+    }
+    result.data["identified"] = std::to_string(summary.identified);
+    result.data["failures"] = std::to_string(summary.failed);
+    result.data["weak"] = std::to_string(weakServers);
+    result.data["host_keys"] = std::to_string(hostKeys);
+    result.data["peak_connections"] = std::to_string(summary.stats.peakConnections);
+    result.data["receive_buffers"] = std::to_string(summary.stats.buffers);
+    result.data["elapsed_ms"] = std::to_string(summary.elapsed.count());
+    result.data["results"] = summary.records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+ExecutionResult ServiceEngine::executeCapabilityScan(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for capscan command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<TextProtocol> protocols;
+    std::stringstream protocolList(parameter(context, "protocols"));
+    std::string name;
+    while (std::getline(protocolList, name, ',')) {
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        if (name.empty()) {
+            continue;
+        }
+        TextProtocol protocol;
+        if (!parseTextProtocol(name, protocol)) {
+            result.success = false;
+            result.message = "Unknown protocol: " + name;
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+        protocols.push_back(protocol);
+    }
+    auto resolve = [&](int port, const std::string& service, bool fromScan, std::string& resolved) {
+        TextProtocol protocol;
+        if (textProtocolForService(port, service, protocol)) {
+            if (!protocols.empty() && std::find(protocols.begin(), protocols.end(), protocol) == protocols.end()) {
+                return false;
+            }
+        } else if (!fromScan && protocols.size() == 1) {
+            protocol = protocols.front();
+        } else {
+            return false;
+        }
+        resolved = textProtocolName(protocol);
+        return true;
+    };
+
+    std::vector<ServiceEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, defaultTextPorts(), resolve, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的邮件或FTP端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    notifyOutput(context, "能力探测 " + std::to_string(endpoints.size()) + " 个端点");
+
+    uint64_t noEncryption = 0;
+    auto createDialog = [](const ServiceEndpoint& endpoint) -> std::unique_ptr<ServiceDialog> {
+        TextProtocol protocol;
+        if (!parseTextProtocol(endpoint.protocol, protocol)) {
+            return nullptr;
+        }
+        return std::make_unique<ConversationDialog>(textProtocolScript(protocol));
+    };
+    auto onIdentified = [&](const ServiceEndpoint& endpoint, const ServiceInfo& info,
+                            const ServiceProbeResult& probe) {
+        bool encryption = std::any_of(info.capabilities.begin(), info.capabilities.end(),
+                                      [](const std::string& capability) {
+                                          return capability == "STARTTLS" || capability == "STLS" ||
+                                                 capability.compare(0, 5, "AUTH ") == 0;
+                                      });
+        if (!encryption && info.auth != AuthState::DENIED) {
+            ++noEncryption;
+        }
+
+        std::string line = "[" + info.service + "] " + endpoint.ip + ":" + std::to_string(endpoint.port);
+        if (!info.product.empty()) {
+            line += "  " + info.product + (info.version.empty() ? "" : " " + info.version);
+        }
+        if (info.auth != AuthState::UNKNOWN) {
+            line += "  auth=" + authStateName(info.auth);
+        }
+        if (!info.capabilities.empty()) {
+            line += "  " + joinList(info.capabilities);
+        }
+        if (!probe.ok()) {
+            line += "  (" + probe.error + ")";
+        }
+        notifyOutput(context, line);
+        for (const auto& finding : info.findings) {
+            notifyOutput(context, "    [!] " + finding);
+        }
+        return serviceRecord(endpoint, info, probe.elapsed);
+    };
+
+    ProbeSummary summary;
+    if (!runProbes(context, endpoints, createDialog, onIdentified, summary, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    result.success = true;
+    result.message = "能力探测完成，" + std::to_string(summary.identified) + " 个已识别, " +
+                     std::to_string(summary.failed) + " 个失败";
+    if (noEncryption > 0) {
+        result.message += ", " + std::to_string(noEncryption) + " 个不支持加密升级";
+    }
+    result.data["identified"] = std::to_string(summary.identified);
+    result.data["failures"] = std::to_string(summary.failed);
+    result.data["no_encryption"] = std::to_string(noEncryption);
+    result.data["peak_connections"] = std::to_string(summary.stats.peakConnections);
+    result.data["receive_buffers"] = std::to_string(summary.stats.buffers);
+    result.data["dialog_frames"] = std::to_string(ConversationDialog::pooled());
+    result.data["elapsed_ms"] = std::to_string(summary.elapsed.count());
+    result.data["results"] = summary.records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+bool ServiceEngine::runProbes(const CommandContext& context, const std::vector<ServiceEndpoint>& endpoints,
+                              const DialogFactory& createDialog, const ResultHandler& onIdentified,
+                              ProbeSummary& summary, std::string& error) {
+    ServiceProberConfig config;
+    size_t concurrency;
+    try {
+        config.responseTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = config.responseTimeout;
+        concurrency = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+    } catch (const std::exception&) {
+        error = "Invalid numeric option";
+        return false;
+    }
+    config.maxConnections = concurrency;
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            error = "Failed to open output file";
+            return false;
+        }
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        error = "Failed to create event loop";
+        return false;
+    }
+    ServiceProber prober(loop, config);
+
+    size_t nextEndpoint = 0;
+    std::function<void()> pump;
+    auto onResult = [&](size_t index, const ServiceProbeRequest& request, const ServiceProbeResult& probe) {
+        const ServiceEndpoint& endpoint = endpoints[index];
+
+        // 超时等情况下已识别出的部分信息同样记录
+        if (!request.dialog || !request.dialog->info().identified()) {
+            ++summary.failed;
+            if (endpoints.size() <= 16) {
+                notifyError(context, endpoint.protocol + "探测失败: " + endpoint.ip + ":" +
+                            std::to_string(endpoint.port) + " (" + probe.error + ")");
+            }
+            pump();
+            return;
+        }
+
+        ++summary.identified;
+        std::string record = onIdentified(endpoint, request.dialog->info(), probe);
+        summary.records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextEndpoint < endpoints.size() && prober.outstanding() < concurrency && !m_stopRequested) {
+            size_t index = nextEndpoint++;
+            const ServiceEndpoint& endpoint = endpoints[index];
+
+            ServiceProbeRequest request;
+            request.address = Utils::IPAddress(endpoint.ip);
+            request.port = static_cast<uint16_t>(endpoint.port);
+            request.dialog = createDialog(endpoint);
+            prober.submit(std::move(request), [&, index](const ServiceProbeRequest& done,
+                                                         const ServiceProbeResult& probe) {
+                onResult(index, done, probe);
+            });
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    pump();
+    prober.run(m_stopRequested);
+    summary.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    summary.stats = prober.getStats();
+    return true;
+}
+
+bool ServiceEngine::collectEndpoints(const CommandContext& context, const std::vector<int>& defaultPorts,
+                                     const PortResolver& resolve, std::vector<ServiceEndpoint>& endpoints,
+                                     std::string& error) {
+    std::string target = context.target;
+    int explicitPort = 0;
+
+    // host:port 或 [IPv6]:port
+    size_t colonPos = target.rfind(':');
+    size_t bracketPos = target.rfind(']');
+    if (colonPos != std::string::npos && target.find_first_of(",/") == std::string::npos &&
+        (bracketPos != std::string::npos ? colonPos > bracketPos : target.find(':') == colonPos)) {
+        try {
+            explicitPort = std::stoi(target.substr(colonPos + 1));
+        } catch (const std::exception&) {
+            error = "Invalid port in target: " + target;
+            return false;
+        }
+        if (explicitPort <= 0 || explicitPort > 65535) {
+            error = "Invalid port in target: " + target;
+            return false;
+        }
+        target = target.substr(0, colonPos);
+        if (target.size() > 2 && target.front() == '[' && target.back() == ']') {
+            target = target.substr(1, target.size() - 2);
+        }
+    }
+
+    Utils::TargetSpace space;
+    if (!space.addTargets(target)) {
+        error = "Invalid target format";
+        return false;
+    }
+
+    // -from-scan: 终端从结果库注入端口扫描结果，只取落在目标范围内的端口
+    if (context.parameters.count("from-scan")) {
+        auto baselineParam = context.parameters.find("baseline");
+        if (baselineParam == context.parameters.end()) {
+            error = "No scan result found for from-scan " + context.parameters.at("from-scan");
+            return false;
+        }
+
+        Network::ScanBaseline scan;
+        scan.parse(baselineParam->second);
+        for (const auto& entry : scan.entries()) {
+            ServiceEndpoint endpoint;
+            if (!space.containsHost(Utils::IPAddress(entry.ip)) ||
+                !resolve(entry.port, entry.service, true, endpoint.protocol)) {
+                continue;
+            }
+            endpoint.ip = entry.ip;
+            endpoint.port = entry.port;
+            endpoints.push_back(endpoint);
+        }
+        return true;
+    }
+
+    std::vector<int> ports;
+    std::string portSpec = parameter(context, "ports");
+    if (explicitPort != 0) {
+        ports = {explicitPort};
+    } else if (!portSpec.empty()) {
+        for (const auto& range : Utils::NetworkUtils::parsePortRange(portSpec)) {
+            auto values = range.toVector();
+            ports.insert(ports.end(), values.begin(), values.end());
+        }
+    } else {
+        ports = defaultPorts;
+    }
+
+    std::vector<std::pair<int, std::string>> probes;
+    for (int port : ports) {
+        std::string protocol;
+        if (resolve(port, "", false, protocol)) {
+            probes.emplace_back(port, protocol);
+        }
+    }
+    if (probes.empty()) {
+        error = ports.empty() ? "No valid ports to probe"
+                              : "No known protocol for the given ports" +
+                                    std::string(context.command != "sshscan" ? ", use -protocols" : "");
+        return false;
+    }
+
+    for (uint64_t host = 0; host < space.hostCount(); ++host) {
+        std::string ip = space.hostAt(host).toString();
+        for (const auto& probe : probes) {
+            ServiceEndpoint endpoint;
+            endpoint.ip = ip;
+            endpoint.port = probe.first;
+            endpoint.protocol = probe.second;
+            endpoints.push_back(endpoint);
+        }
+    }
+    return true;
+}
+
+std::string ServiceEngine::parameter(const CommandContext& context, const std::string& key) const {
+    auto it = context.parameters.find(key);
+    if (it != context.parameters.end()) {
+        return it->second;
+    }
+    return getOption(key);
+}
+
+} // namespace MindSploit::Service
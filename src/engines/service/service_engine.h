@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../engine_interface.h"
+#include "database_probes.h"
+#include "text_probes.h"
+#include <vector>
+#include <atomic>
+#include <functional>
+
+namespace MindSploit::Service {
+
+// 一个待探测的服务端点
+struct ServiceEndpoint {
+    std::string ip;
+    int port = 0;
+    std::string protocol;
+};
+
+// 服务探测引擎: 以协议原生的握手对话识别数据库、缓存、SSH和邮件/FTP服务的版本、认证要求、算法和能力
+class ServiceEngine : public EngineInterface {
+public:
+    static constexpr const char* ENGINE_NAME = "ServiceEngine";
+
+    ServiceEngine();
+    virtual ~ServiceEngine();
+
+    // 基础接口实现
+    bool initialize() override;
+    bool shutdown() override;
+    ExecutionResult execute(const CommandContext& context) override;
+    void stop() override;
+
+    EngineStatus getStatus() const override;
+    std::string getName() const override { return "ServiceEngine"; }
+    std::string getVersion() const override { return "1.0.0"; }
+    std::string getDescription() const override;
+
+    std::vector<std::string> getSupportedCommands() const override;
+    std::map<std::string, std::string> getRequiredParameters(const std::string& command) const override;
+    std::map<std::string, std::string> getOptionalParameters(const std::string& command) const override;
+
+    bool setOption(const std::string& key, const std::string& value) override;
+    std::string getOption(const std::string& key) const override;
+    std::map<std::string, std::string> getAllOptions() const override;
+
+    bool checkDependencies() const override;
+    std::vector<std::string> getMissingDependencies() const override;
+
+    std::string getHelp() const override;
+    std::string getCommandHelp(const std::string& command) const override;
+
+private:
+    ExecutionResult executeDatabaseScan(const CommandContext& context);
+    ExecutionResult executeSshScan(const CommandContext& context);
+    ExecutionResult executeCapabilityScan(const CommandContext& context);
+
+    struct ProbeSummary {
+        uint64_t identified = 0;
+        uint64_t failed = 0;
+        std::string records;
+        ServiceProberStats stats;
+        std::chrono::milliseconds elapsed{0};
+    };
+    using DialogFactory = std::function<std::unique_ptr<ServiceDialog>(const ServiceEndpoint& endpoint)>;
+    // 输出一个已识别的端点并返回其JSON记录
+    using ResultHandler = std::function<std::string(const ServiceEndpoint& endpoint, const ServiceInfo& info,
+                                                    const ServiceProbeResult& probe)>;
+
+    // 并发对全部端点执行对话，选项错误时返回false
+    bool runProbes(const CommandContext& context, const std::vector<ServiceEndpoint>& endpoints,
+                   const DialogFactory& createDialog, const ResultHandler& onIdentified,
+                   ProbeSummary& summary, std::string& error);
+
+    // 决定端口上探测的协议，fromScan为端口扫描结果中的端口 (service为识别出的服务名)
+    using PortResolver = std::function<bool(int port, const std::string& service, bool fromScan,
+                                            std::string& protocol)>;
+    // 端点收集: host:port、目标×端口，或 -from-scan 的开放端口
+    bool collectEndpoints(const CommandContext& context, const std::vector<int>& defaultPorts,
+                          const PortResolver& resolve, std::vector<ServiceEndpoint>& endpoints,
+                          std::string& error);
+    std::string parameter(const CommandContext& context, const std::string& key) const;
+
+private:
+    std::atomic<EngineStatus> m_status{EngineStatus::IDLE};
+    std::atomic<bool> m_stopRequested{false};
+    std::map<std::string, std::string> m_options;
+};
+
+} // namespace MindSploit::Service
@@ -0,0 +1,427 @@
+#include "service_prober.h"
+#include "../../utils/socket_budget.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace MindSploit::Service {
+
+namespace {
+
+constexpr std::chrono::milliseconds SWEEP_INTERVAL{100};
+
+int lastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool wouldBlock(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+}
+
+bool connectInProgress(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EINPROGRESS;
+#endif
+}
+
+} // namespace
+
+std::string authStateName(AuthState state) {
+    switch (state) {
+        case AuthState::NONE: return "none";
+        case AuthState::REQUIRED: return "required";
+        case AuthState::DENIED: return "denied";
+        default: return "unknown";
+    }
+}
+
+void ServiceInfo::addDetail(const std::string& key, const std::string& value) {
+    if (value.empty()) {
+        return;
+    }
+    for (auto& entry : details) {
+        if (entry.first == key) {
+            entry.second = value;
+            return;
+        }
+    }
+    details.emplace_back(key, value);
+}
+
+ServiceProber::ServiceProber(Utils::EventLoop& loop, const ServiceProberConfig& config)
+    : m_loop(loop), m_config(config), m_buffers(std::max<size_t>(512, config.receiveBuffer)) {
+    m_config.maxConnections = std::max<size_t>(1, m_config.maxConnections);
+    m_config.receiveBuffer = m_buffers.blockSize();
+}
+
+ServiceProber::~ServiceProber() {
+    cancelAll("Service prober destroyed");
+    if (m_sweepTimer != 0) {
+        m_loop.cancelTimer(m_sweepTimer);
+    }
+}
+
+void ServiceProber::submit(ServiceProbeRequest request, Callback callback) {
+    Pending pending;
+    pending.request = std::move(request);
+    pending.callback = std::move(callback);
+    pending.submitted = Clock::now();
+
+    ++m_stats.probes;
+    m_queue.push_back(std::move(pending));
+    startQueued();
+    scheduleSweep();
+}
+
+void ServiceProber::run(const std::atomic<bool>& stopRequested) {
+    while (!stopRequested && outstanding() > 0) {
+        m_loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (stopRequested) {
+        cancelAll("Probe cancelled");
+    }
+}
+
+void ServiceProber::cancelAll(const std::string& reason) {
+    m_cancelling = true;
+
+    std::vector<int> fds;
+    fds.reserve(m_active.size());
+    for (const auto& entry : m_active) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        auto it = m_active.find(fd);
+        if (it != m_active.end()) {
+            finishProbe(*it->second, reason);
+        }
+    }
+    std::deque<Pending> queue = std::move(m_queue);
+    m_queue.clear();
+    for (Pending& pending : queue) {
+        fail(pending, reason);
+    }
+
+    m_cancelling = false;
+}
+
+ServiceProberStats ServiceProber::getStats() const {
+    ServiceProberStats stats = m_stats;
+    stats.buffers = m_buffers.capacity();
+    return stats;
+}
+
+void ServiceProber::startQueued() {
+    if (m_cancelling) {
+        return;
+    }
+
+    while (!m_queue.empty() && m_active.size() < m_config.maxConnections) {
+        std::string error;
+        StartResult result = start(m_queue.front(), error);
+        if (result == StartResult::NO_CAPACITY) {
+            // 等待其它探测释放名额或由定时清理重试
+            break;
+        }
+        Pending pending = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (result == StartResult::FAILED) {
+            fail(pending, error);
+        }
+    }
+}
+
+ServiceProber::StartResult ServiceProber::start(Pending& pending, std::string& error) {
+    if (!pending.request.dialog) {
+        error = "No protocol dialog";
+        return StartResult::FAILED;
+    }
+
+    auto& budget = Utils::SocketBudget::instance();
+    if (!budget.acquire(std::chrono::milliseconds(0))) {
+        return StartResult::NO_CAPACITY;
+    }
+
+    const ServiceProbeRequest& request = pending.request;
+    int fd = budget.openProbeSocket(request.address);
+    if (fd < 0) {
+        budget.release();
+        return StartResult::NO_CAPACITY;
+    }
+
+    // 请求都是单个小报文
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen = Utils::NetworkUtils::toSockaddr(request.address, request.port, addr);
+    int result = ::connect(fd, (struct sockaddr*)&addr, addrLen);
+    if (result != 0) {
+        int code = lastSocketError();
+        if (!connectInProgress(code)) {
+            budget.reportError(code);
+            budget.closeProbeSocket(fd);
+            budget.release();
+            error = std::string("Connection failed: ") + strerror(code);
+            return StartResult::FAILED;
+        }
+    }
+
+    auto probe = std::make_unique<Probe>(std::move(pending));
+    probe->fd = fd;
+    probe->deadline = Clock::now() + m_config.connectTimeout;
+    probe->buffer = m_buffers.acquire();
+    Probe* raw = probe.get();
+    m_active[fd] = std::move(probe);
+    ++m_stats.connectionsOpened;
+    m_stats.peakConnections = std::max(m_stats.peakConnections, m_active.size());
+
+    m_loop.watch(fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE,
+                 [this, fd](uint32_t events) { onEvent(fd, events); });
+    if (result == 0) {
+        onConnected(*raw);
+    }
+    return StartResult::STARTED;
+}
+
+void ServiceProber::onEvent(int fd, uint32_t events) {
+    auto it = m_active.find(fd);
+    if (it == m_active.end()) {
+        return;
+    }
+    Probe& probe = *it->second;
+
+    if (!probe.connected) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+        if (error != 0 || !(events & Utils::EventLoop::EVENT_WRITE)) {
+            Utils::SocketBudget::instance().reportError(error);
+            finishProbe(probe, error != 0 ? std::string("Connection failed: ") + strerror(error)
+                                          : "Connection failed");
+            return;
+        }
+        onConnected(probe);
+        return;
+    }
+
+    if ((events & Utils::EventLoop::EVENT_WRITE) && !flush(probe)) {
+        return;
+    }
+    if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+        readResponse(probe);
+    }
+}
+
+void ServiceProber::onConnected(Probe& probe) {
+    probe.connected = true;
+    probe.result.connected = true;
+    probe.deadline = Clock::now() + responseTimeout(probe);
+    Utils::SocketBudget::instance().reportSuccess();
+
+    std::string_view request = probe.pending.request.dialog->request();
+    if (request.empty()) {
+        // 服务端先发言
+        m_loop.update(probe.fd, Utils::EventLoop::EVENT_READ);
+        return;
+    }
+    handleStatus(probe, ServiceDialog::Status::SEND, request);
+}
+
+bool ServiceProber::flush(Probe& probe) {
+    while (probe.outputOffset < probe.output.size()) {
+#ifdef _WIN32
+        int flags = 0;
+#else
+        int flags = MSG_NOSIGNAL;
+#endif
+        int sent = ::send(probe.fd, probe.output.data() + probe.outputOffset,
+                          static_cast<int>(probe.output.size() - probe.outputOffset), flags);
+        if (sent < 0) {
+            if (wouldBlock(lastSocketError())) {
+                break;
+            }
+            finishProbe(probe, "Send failed");
+            return false;
+        }
+        probe.outputOffset += static_cast<size_t>(sent);
+    }
+
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (probe.outputOffset < probe.output.size()) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    } else {
+        probe.output = {};
+        probe.outputOffset = 0;
+    }
+    m_loop.update(probe.fd, events);
+    return true;
+}
+
+void ServiceProber::readResponse(Probe& probe) {
+    ServiceDialog& dialog = *probe.pending.request.dialog;
+
+    while (true) {
+        if (probe.buffered == m_config.receiveBuffer) {
+            finishProbe(probe, "Response exceeds receive buffer");
+            return;
+        }
+
+        int received = ::recv(probe.fd, probe.buffer + probe.buffered,
+                              static_cast<int>(m_config.receiveBuffer - probe.buffered), 0);
+        if (received > 0) {
+            probe.buffered += static_cast<size_t>(received);
+            probe.result.received += static_cast<size_t>(received);
+
+            size_t consumed = 0;
+            std::string_view output;
+            ServiceDialog::Status status = dialog.receive(std::string_view(probe.buffer, probe.buffered),
+                                                          consumed, output);
+            consumed = std::min(consumed, probe.buffered);
+            if (consumed > 0) {
+                std::memmove(probe.buffer, probe.buffer + consumed, probe.buffered - consumed);
+                probe.buffered -= consumed;
+            }
+            if (!handleStatus(probe, status, output)) {
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && wouldBlock(lastSocketError())) {
+            return;
+        }
+
+        // 很多服务拒绝访问时直接断开，由对话判断已收到的数据是否足够
+        ServiceDialog::Status status = dialog.closed(std::string_view(probe.buffer, probe.buffered));
+        if (status == ServiceDialog::Status::DONE) {
+            finishProbe(probe, "");
+        } else {
+            finishProbe(probe, dialog.error().empty() ? "Connection closed by peer" : dialog.error());
+        }
+        return;
+    }
+}
+
+bool ServiceProber::handleStatus(Probe& probe, ServiceDialog::Status status, std::string_view output) {
+    switch (status) {
+        case ServiceDialog::Status::NEED_MORE:
+            return true;
+        case ServiceDialog::Status::SEND:
+            if (probe.outputOffset < probe.output.size()) {
+                finishProbe(probe, "Dialog output overlaps pending request");
+                return false;
+            }
+            probe.output = output;
+            probe.outputOffset = 0;
+            probe.deadline = Clock::now() + responseTimeout(probe);
+            return flush(probe);
+        case ServiceDialog::Status::DONE:
+            finishProbe(probe, "");
+            return false;
+        default: {
+            const std::string& error = probe.pending.request.dialog->error();
+            finishProbe(probe, error.empty() ? "Unexpected response" : error);
+            return false;
+        }
+    }
+}
+
+std::chrono::milliseconds ServiceProber::responseTimeout(const Probe& probe) const {
+    return std::max(probe.pending.request.dialog->timeout(), m_config.responseTimeout);
+}
+
+void ServiceProber::finishProbe(Probe& probe, const std::string& error) {
+    int fd = probe.fd;
+    m_loop.unwatch(fd);
+
+    auto& budget = Utils::SocketBudget::instance();
+    budget.closeProbeSocket(fd);
+    budget.release();
+    m_buffers.release(probe.buffer);
+    probe.buffer = nullptr;
+
+    Pending pending = std::move(probe.pending);
+    ServiceProbeResult result = std::move(probe.result);
+    m_active.erase(fd);
+
+    result.error = error;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    if (result.ok()) {
+        ++m_stats.completed;
+    } else {
+        ++m_stats.failures;
+    }
+    if (pending.callback) {
+        pending.callback(pending.request, result);
+    }
+
+    startQueued();
+}
+
+void ServiceProber::fail(Pending& pending, const std::string& error) {
+    ServiceProbeResult result;
+    result.error = error;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    ++m_stats.failures;
+    if (pending.callback) {
+        pending.callback(pending.request, result);
+    }
+}
+
+void ServiceProber::scheduleSweep() {
+    if (m_sweepTimer != 0) {
+        return;
+    }
+    m_sweepTimer = m_loop.addTimer(SWEEP_INTERVAL, [this]() {
+        m_sweepTimer = 0;
+        sweep();
+        if (outstanding() > 0) {
+            scheduleSweep();
+        }
+    });
+}
+
+void ServiceProber::sweep() {
+    auto now = Clock::now();
+
+    std::vector<int> expired;
+    for (const auto& entry : m_active) {
+        if (now >= entry.second->deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        auto it = m_active.find(fd);
+        if (it == m_active.end()) {
+            continue;
+        }
+        Probe& probe = *it->second;
+        finishProbe(probe, probe.connected ? "Response timeout" : "Connection timeout");
+    }
+
+    // 等待连接名额的探测同样受超时约束
+    auto queueLimit = m_config.connectTimeout + m_config.responseTimeout;
+    while (!m_queue.empty() && now - m_queue.front().submitted >= queueLimit) {
+        Pending pending = std::move(m_queue.front());
+        m_queue.pop_front();
+        fail(pending, "Probe timeout");
+    }
+
+    startQueued();
+}
+
+} // namespace MindSploit::Service
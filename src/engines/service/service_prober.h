@@ -0,0 +1,190 @@
+#pragma once
+
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/buffer_arena.h"
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace MindSploit::Service {
+
+// 访问控制状态
+enum class AuthState {
+    UNKNOWN,
+    NONE,           // 无需认证即可访问数据
+    REQUIRED,       // 需要认证
+    DENIED          // 拒绝本机连接 (访问控制列表、保护模式等)
+};
+
+std::string authStateName(AuthState state);
+
+// 一次协议对话得出的服务信息
+struct ServiceInfo {
+    std::string service;                        // 协议名，如 mysql、redis
+    std::string product;                        // 具体实现，如 MariaDB、Valkey
+    std::string version;
+    AuthState auth = AuthState::UNKNOWN;
+    std::vector<std::string> capabilities;
+    std::vector<std::pair<std::string, std::string>> details;
+    std::vector<std::string> findings;          // 安全相关的发现
+
+    bool identified() const { return !service.empty(); }
+    void addDetail(const std::string& key, const std::string& value);
+};
+
+// 协议对话状态机
+//
+// 探测器只负责连接、收发和超时，协议逻辑全部在对话对象中:
+//   - 连接建立后发送request()，服务端先发言的协议返回空
+//   - 每次收到数据调用receive()，input为尚未消耗的全部数据
+//   - 返回SEND时output指向要发送的数据，由对话对象持有直到下次调用
+class ServiceDialog {
+public:
+    enum class Status {
+        NEED_MORE,      // 数据不完整，继续读取
+        SEND,           // 发送output后继续读取
+        DONE,           // 已得出结论
+        FAILED          // 不是预期的协议
+    };
+
+    virtual ~ServiceDialog() = default;
+
+    virtual std::string_view request() { return {}; }
+    // consumed返回已处理的字节数，未处理的部分下次连同新数据一起传入
+    virtual Status receive(std::string_view input, size_t& consumed, std::string_view& output) = 0;
+    // 对端在DONE之前关闭连接，返回DONE表示已收到的数据足以得出结论
+    virtual Status closed(std::string_view input) { (void)input; return Status::FAILED; }
+    // 等待下一个应答至少需要的时间 (如SMTP的问候延迟)，连接建立和每次SEND时取它与配置中的较大者
+    virtual std::chrono::milliseconds timeout() const { return std::chrono::milliseconds(0); }
+
+    const ServiceInfo& info() const { return m_info; }
+    const std::string& error() const { return m_error; }
+
+protected:
+    Status fail(const std::string& error) {
+        m_error = error;
+        return Status::FAILED;
+    }
+
+protected:
+    ServiceInfo m_info;
+    std::string m_error;
+};
+
+// 探测器配置
+struct ServiceProberConfig {
+    size_t maxConnections = 1024;               // 同时进行的对话数 (另受SocketBudget约束)
+    std::chrono::milliseconds connectTimeout{5000};
+    std::chrono::milliseconds responseTimeout{5000};
+    size_t receiveBuffer = 16 * 1024;           // 每个连接的接收缓冲区，应答超出时失败
+};
+
+// 单次探测
+struct ServiceProbeRequest {
+    Utils::IPAddress address;
+    uint16_t port = 0;
+    std::unique_ptr<ServiceDialog> dialog;
+};
+
+struct ServiceProbeResult {
+    bool connected = false;
+    std::string error;
+    size_t received = 0;
+    std::chrono::milliseconds elapsed{0};
+
+    bool ok() const { return error.empty(); }
+};
+
+struct ServiceProberStats {
+    uint64_t probes = 0;
+    uint64_t completed = 0;
+    uint64_t failures = 0;
+    uint64_t connectionsOpened = 0;
+    size_t peakConnections = 0;
+    size_t buffers = 0;                         // 接收缓冲区池的块数 (即峰值并发)
+};
+
+// 基于事件循环的并发协议探测器
+//
+// 每个探测使用独立的连接，以对话状态机完成一到数次往返; 连接名额不足时排队。
+// 接收缓冲区从固定大小的缓冲区池分配，连接结束后归还，探测过程中不再为收发分配内存。
+// 回调在事件循环线程中执行，可以在回调里继续submit。
+class ServiceProber {
+public:
+    using Callback = std::function<void(const ServiceProbeRequest& request, const ServiceProbeResult& result)>;
+
+    ServiceProber(Utils::EventLoop& loop, const ServiceProberConfig& config);
+    ~ServiceProber();
+
+    ServiceProber(const ServiceProber&) = delete;
+    ServiceProber& operator=(const ServiceProber&) = delete;
+
+    void submit(ServiceProbeRequest request, Callback callback);
+    size_t outstanding() const { return m_queue.size() + m_active.size(); }
+    // 驱动事件循环直到全部探测完成或stopRequested置位
+    void run(const std::atomic<bool>& stopRequested);
+    void cancelAll(const std::string& reason);
+
+    ServiceProberStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        ServiceProbeRequest request;
+        Callback callback;
+        Clock::time_point submitted;
+    };
+
+    struct Probe {
+        int fd = -1;
+        Pending pending;
+        bool connected = false;
+        Clock::time_point deadline;
+        char* buffer = nullptr;                 // 缓冲区池中的块
+        size_t buffered = 0;
+        std::string_view output;
+        size_t outputOffset = 0;
+        ServiceProbeResult result;
+
+        explicit Probe(Pending p) : pending(std::move(p)) {}
+    };
+
+    void startQueued();
+    enum class StartResult {
+        STARTED,
+        NO_CAPACITY,
+        FAILED
+    };
+    StartResult start(Pending& pending, std::string& error);
+
+    void onEvent(int fd, uint32_t events);
+    void onConnected(Probe& probe);
+    // 发送output，返回false表示探测已结束
+    bool flush(Probe& probe);
+    void readResponse(Probe& probe);
+    // 处理对话状态，返回false表示探测已结束
+    bool handleStatus(Probe& probe, ServiceDialog::Status status, std::string_view output);
+    void finishProbe(Probe& probe, const std::string& error);
+    std::chrono::milliseconds responseTimeout(const Probe& probe) const;
+    void fail(Pending& pending, const std::string& error);
+
+    void scheduleSweep();
+    void sweep();
+
+private:
+    Utils::EventLoop& m_loop;
+    ServiceProberConfig m_config;
+    Utils::BufferArena m_buffers;
+    std::deque<Pending> m_queue;
+    std::unordered_map<int, std::unique_ptr<Probe>> m_active;
+    Utils::EventLoop::TimerId m_sweepTimer = 0;
+    bool m_cancelling = false;
+    ServiceProberStats m_stats;
+};
+
+} // namespace MindSploit::Service
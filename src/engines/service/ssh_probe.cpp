@@ -0,0 +1,578 @@
+#include "ssh_probe.h"
+#include <algorithm>
+#include <random>
+#include <cctype>
+#include <cstring>
+
+namespace MindSploit::Service {
+
+namespace {
+
+constexpr uint8_t SSH_MSG_DISCONNECT = 1;
+constexpr uint8_t SSH_MSG_KEXINIT = 20;
+constexpr uint8_t SSH_MSG_KEX_ECDH_INIT = 30;
+constexpr uint8_t SSH_MSG_KEX_ECDH_REPLY = 31;
+
+// 未加密阶段的包长上限 (RFC 4253要求至少支持35000)
+constexpr uint32_t MAX_PACKET_LENGTH = 35000;
+constexpr size_t MAX_IDENTIFICATION_LINE = 255;
+constexpr size_t MAX_IDENTIFICATION_LINES = 32;
+
+const char CLIENT_IDENTIFICATION[] = "SSH-2.0-MindSploit_1.0\r\n";
+
+// 主机密钥算法偏好，第一个服务端支持的用于取主机密钥
+const char* const HOST_KEY_PREFERENCE[] = {
+    "ssh-ed25519", "ecdsa-sha2-nistp256", "ecdsa-sha2-nistp384", "ecdsa-sha2-nistp521",
+    "rsa-sha2-512", "rsa-sha2-256", "ssh-rsa", "ssh-dss"
+};
+
+// 弱算法规则
+struct WeakAlgorithm {
+    enum Match { EXACT, PREFIX, CONTAINS } match;
+    const char* name;
+    const char* reason;
+};
+
+const WeakAlgorithm WEAK_KEX[] = {
+    {WeakAlgorithm::EXACT, "diffie-hellman-group1-sha1", "1024-bit DH group with SHA-1"},
+    {WeakAlgorithm::EXACT, "diffie-hellman-group14-sha1", "SHA-1"},
+    {WeakAlgorithm::EXACT, "diffie-hellman-group-exchange-sha1", "SHA-1"},
+    {WeakAlgorithm::EXACT, "rsa1024-sha1", "1024-bit RSA with SHA-1"},
+    {WeakAlgorithm::PREFIX, "gss-group1-sha1-", "1024-bit DH group with SHA-1"},
+    {WeakAlgorithm::PREFIX, "gss-group14-sha1-", "SHA-1"},
+    {WeakAlgorithm::PREFIX, "gss-gex-sha1-", "SHA-1"},
+};
+
+const WeakAlgorithm WEAK_HOST_KEYS[] = {
+    {WeakAlgorithm::PREFIX, "ssh-dss", "DSA limited to 1024 bits"},
+    {WeakAlgorithm::EXACT, "ssh-rsa", "RSA signatures with SHA-1"},
+    {WeakAlgorithm::EXACT, "ssh-rsa-cert-v01@openssh.com", "RSA signatures with SHA-1"},
+};
+
+const WeakAlgorithm WEAK_CIPHERS[] = {
+    {WeakAlgorithm::CONTAINS, "cbc", "CBC mode"},
+    {WeakAlgorithm::PREFIX, "arcfour", "RC4"},
+    {WeakAlgorithm::EXACT, "none", "no encryption"},
+};
+
+const WeakAlgorithm WEAK_MACS[] = {
+    {WeakAlgorithm::PREFIX, "hmac-md5", "MD5"},
+    {WeakAlgorithm::PREFIX, "hmac-sha1", "SHA-1"},
+    {WeakAlgorithm::PREFIX, "umac-64", "64-bit tag"},
+    {WeakAlgorithm::PREFIX, "hmac-ripemd160", "RIPEMD-160"},
+    {WeakAlgorithm::EXACT, "none", "no integrity protection"},
+};
+
+bool matches(const WeakAlgorithm& rule, const std::string& name) {
+    switch (rule.match) {
+        case WeakAlgorithm::EXACT: return name == rule.name;
+        case WeakAlgorithm::PREFIX: return name.compare(0, std::strlen(rule.name), rule.name) == 0;
+        default: return name.find(rule.name) != std::string::npos;
+    }
+}
+
+template <size_t N>
+void checkWeak(const std::vector<std::string>& names, const WeakAlgorithm (&rules)[N], const char* kind,
+               std::vector<std::string>& findings) {
+    for (const auto& name : names) {
+        for (const auto& rule : rules) {
+            if (matches(rule, name)) {
+                findings.push_back(std::string("Weak ") + kind + ": " + name + " (" + rule.reason + ")");
+                break;
+            }
+        }
+    }
+}
+
+bool contains(const std::vector<std::string>& names, const char* name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+uint32_t readBE32(std::string_view data, size_t offset) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(data[offset])) << 24) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(data[offset + 1])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(data[offset + 2])) << 8) |
+           static_cast<uint8_t>(data[offset + 3]);
+}
+
+// SSH string: uint32长度 + 数据
+bool readString(std::string_view data, size_t& offset, std::string_view& value) {
+    if (data.size() < offset + 4) {
+        return false;
+    }
+    uint32_t length = readBE32(data, offset);
+    if (data.size() - offset - 4 < length) {
+        return false;
+    }
+    value = data.substr(offset + 4, length);
+    offset += 4 + length;
+    return true;
+}
+
+std::vector<std::string> splitNameList(std::string_view list) {
+    std::vector<std::string> names;
+    size_t offset = 0;
+    while (offset <= list.size() && !list.empty()) {
+        size_t comma = list.find(',', offset);
+        if (comma == std::string_view::npos) {
+            comma = list.size();
+        }
+        if (comma > offset) {
+            names.emplace_back(list.substr(offset, comma - offset));
+        }
+        offset = comma + 1;
+    }
+    return names;
+}
+
+std::string joinNames(const std::vector<std::string>& names) {
+    std::string text;
+    for (const auto& name : names) {
+        text += (text.empty() ? "" : ",") + name;
+    }
+    return text;
+}
+
+// mpint的有效位数
+size_t mpintBits(std::string_view value) {
+    size_t offset = 0;
+    while (offset < value.size() && value[offset] == 0) {
+        ++offset;
+    }
+    if (offset == value.size()) {
+        return 0;
+    }
+    size_t bits = (value.size() - offset - 1) * 8;
+    for (uint8_t top = static_cast<uint8_t>(value[offset]); top != 0; top >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+void randomBytes(char* data, size_t length) {
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = static_cast<char>(generator() & 0xff);
+    }
+}
+
+// SHA-256 (FIPS 180-4)，只用于主机密钥指纹
+void sha256(std::string_view data, uint8_t digest[32]) {
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    auto rotate = [](uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); };
+
+    // 末尾填充0x80、若干0和64位长度
+    const uint64_t bitLength = static_cast<uint64_t>(data.size()) * 8;
+    const size_t blocks = (data.size() + 9 + 63) / 64;
+    for (size_t block = 0; block < blocks; ++block) {
+        uint8_t chunk[64];
+        for (size_t i = 0; i < 64; ++i) {
+            size_t position = block * 64 + i;
+            if (position < data.size()) {
+                chunk[i] = static_cast<uint8_t>(data[position]);
+            } else if (position == data.size()) {
+                chunk[i] = 0x80;
+            } else if (position >= blocks * 64 - 8) {
+                chunk[i] = static_cast<uint8_t>(bitLength >> (8 * (blocks * 64 - 1 - position)));
+            } else {
+                chunk[i] = 0;
+            }
+        }
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t(chunk[i * 4]) << 24) | (uint32_t(chunk[i * 4 + 1]) << 16) |
+                   (uint32_t(chunk[i * 4 + 2]) << 8) | chunk[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            digest[i * 4 + j] = static_cast<uint8_t>(state[i] >> (24 - 8 * j));
+        }
+    }
+}
+
+// OpenSSH格式的指纹: base64且不带填充
+std::string fingerprint(std::string_view key) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t digest[32];
+    sha256(key, digest);
+
+    std::string text = "SHA256:";
+    for (size_t i = 0; i < sizeof(digest); i += 3) {
+        uint32_t group = uint32_t(digest[i]) << 16;
+        if (i + 1 < sizeof(digest)) group |= uint32_t(digest[i + 1]) << 8;
+        if (i + 2 < sizeof(digest)) group |= digest[i + 2];
+        size_t characters = std::min<size_t>(4, (sizeof(digest) - i) * 8 / 6 + 1);
+        for (size_t j = 0; j < characters; ++j) {
+            text += ALPHABET[(group >> (18 - 6 * j)) & 0x3f];
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+SshDialog::SshDialog(bool fetchHostKey) : m_fetchHostKey(fetchHostKey) {}
+
+std::string_view SshDialog::request() {
+    return std::string_view(CLIENT_IDENTIFICATION, sizeof(CLIENT_IDENTIFICATION) - 1);
+}
+
+ServiceDialog::Status SshDialog::receive(std::string_view input, size_t& consumed, std::string_view& output) {
+    if (m_state == State::IDENTIFICATION) {
+        Status status = readIdentification(input, consumed);
+        if (status != Status::NEED_MORE || m_state == State::IDENTIFICATION) {
+            return status;
+        }
+    }
+    return readPacket(input, consumed, output);
+}
+
+ServiceDialog::Status SshDialog::closed(std::string_view input) {
+    (void)input;
+    if (!m_info.identified()) {
+        return fail("Connection closed by peer");
+    }
+    if (m_state == State::ECDH_REPLY) {
+        m_info.addDetail("hostkey_error", "connection closed during key exchange");
+    }
+    return Status::DONE;
+}
+
+ServiceDialog::Status SshDialog::readIdentification(std::string_view input, size_t& consumed) {
+    // 标识串之前允许有其它文本行
+    while (true) {
+        size_t end = input.find('\n', consumed);
+        if (end == std::string_view::npos) {
+            return input.size() - consumed > MAX_IDENTIFICATION_LINE ? fail("Not an SSH server") : Status::NEED_MORE;
+        }
+        std::string_view line = input.substr(consumed, end - consumed);
+        consumed = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.compare(0, 4, "SSH-") != 0) {
+            if (++m_identificationLines > MAX_IDENTIFICATION_LINES || line.size() > MAX_IDENTIFICATION_LINE) {
+                return fail("Not an SSH server");
+            }
+            continue;
+        }
+
+        // SSH-协议版本-软件版本 注释
+        std::string identification;
+        for (char c : line) {
+            if (c >= 0x20 && c < 0x7f) {
+                identification += c;
+            }
+        }
+        size_t dash = identification.find('-', 4);
+        std::string protocol = identification.substr(4, dash == std::string::npos ? std::string::npos : dash - 4);
+        std::string software = dash == std::string::npos ? "" : identification.substr(dash + 1);
+        size_t space = software.find(' ');
+        if (space != std::string::npos) {
+            m_info.addDetail("comments", software.substr(space + 1));
+            software = software.substr(0, space);
+        }
+
+        m_info.service = "ssh";
+        m_info.addDetail("identification", identification);
+        m_info.addDetail("protocol", protocol);
+        // 软件名与版本以最后一个后面跟数字的'_'或'-'分隔，如 OpenSSH_9.6p1、dropbear_2022.83
+        size_t split = std::string::npos;
+        for (size_t i = 0; i + 1 < software.size(); ++i) {
+            if ((software[i] == '_' || software[i] == '-') && std::isdigit((unsigned char)software[i + 1])) {
+                split = i;
+            }
+        }
+        m_info.product = software.substr(0, split);
+        if (split != std::string::npos) {
+            m_info.version = software.substr(split + 1);
+        }
+        if (m_info.product == "dropbear") {
+            m_info.product = "Dropbear";
+        }
+
+        if (protocol == "1.99") {
+            m_info.findings.push_back("SSH-1 protocol enabled");
+        } else if (protocol != "2.0") {
+            // 只支持SSH-1的服务端不会接受SSH-2客户端
+            m_info.findings.push_back("SSH-1 only server");
+            return Status::DONE;
+        }
+        m_state = State::KEXINIT;
+        return Status::NEED_MORE;
+    }
+}
+
+ServiceDialog::Status SshDialog::readPacket(std::string_view input, size_t& consumed, std::string_view& output) {
+    // 未加密的二进制包: 包长(4) 填充长度(1) 负载 填充
+    while (input.size() - consumed >= 5) {
+        std::string_view rest = input.substr(consumed);
+        uint32_t length = readBE32(rest, 0);
+        uint8_t padding = static_cast<uint8_t>(rest[4]);
+        if (length < 5 || length > MAX_PACKET_LENGTH || padding >= length) {
+            return m_state == State::KEXINIT ? fail("Invalid SSH packet") : Status::DONE;
+        }
+        if (rest.size() < 4 + length) {
+            return Status::NEED_MORE;
+        }
+        consumed += 4 + length;
+        std::string_view payload = rest.substr(5, length - 1 - padding);
+        if (payload.empty()) {
+            continue;
+        }
+
+        uint8_t type = static_cast<uint8_t>(payload[0]);
+        if (type == SSH_MSG_DISCONNECT) {
+            size_t offset = 5;
+            std::string_view reason;
+            if (readString(payload, offset, reason)) {
+                m_info.addDetail(m_state == State::KEXINIT ? "disconnect" : "hostkey_error", std::string(reason));
+            }
+            return m_state == State::KEXINIT ? fail("Disconnected: " + std::string(reason)) : Status::DONE;
+        }
+        if (m_state == State::KEXINIT && type == SSH_MSG_KEXINIT) {
+            return parseKexInit(payload, output);
+        }
+        if (m_state == State::ECDH_REPLY && type == SSH_MSG_KEX_ECDH_REPLY) {
+            return parseEcdhReply(payload);
+        }
+        // IGNORE、DEBUG等消息跳过
+    }
+    return Status::NEED_MORE;
+}
+
+ServiceDialog::Status SshDialog::parseKexInit(std::string_view payload, std::string_view& output) {
+    // 类型(1) cookie(16) 10个name-list
+    size_t offset = 17;
+    std::string_view lists[10];
+    for (auto& list : lists) {
+        if (!readString(payload, offset, list)) {
+            return fail("Invalid KEXINIT");
+        }
+    }
+
+    m_kex = splitNameList(lists[0]);
+    m_hostKeys = splitNameList(lists[1]);
+    m_ciphers = splitNameList(lists[3]);
+    m_macs = splitNameList(lists[5]);
+    m_info.addDetail("kex", joinNames(m_kex));
+    m_info.addDetail("hostkey_algorithms", joinNames(m_hostKeys));
+    m_info.addDetail("ciphers", std::string(lists[3]));
+    m_info.addDetail("macs", std::string(lists[5]));
+    m_info.addDetail("compression", std::string(lists[7]));
+    checkAlgorithms();
+
+    if (!m_fetchHostKey) {
+        return Status::DONE;
+    }
+    if (!buildKeyExchange(lists[3], lists[5])) {
+        return Status::DONE;
+    }
+    m_state = State::ECDH_REPLY;
+    output = std::string_view(m_output.data(), m_outputLength);
+    return Status::SEND;
+}
+
+void SshDialog::checkAlgorithms() {
+    // 扩展协商的伪算法名
+    std::vector<std::string> kex;
+    for (const auto& name : m_kex) {
+        if (name == "ext-info-s") {
+            m_info.capabilities.push_back("ext_info");
+        } else if (name == "kex-strict-s-v00@openssh.com") {
+            m_info.capabilities.push_back("strict_kex");
+        } else {
+            kex.push_back(name);
+        }
+    }
+
+    checkWeak(kex, WEAK_KEX, "kex", m_info.findings);
+    checkWeak(m_hostKeys, WEAK_HOST_KEYS, "host key algorithm", m_info.findings);
+    checkWeak(m_ciphers, WEAK_CIPHERS, "cipher", m_info.findings);
+    checkWeak(m_macs, WEAK_MACS, "MAC", m_info.findings);
+
+    // Terrapin: ChaCha20-Poly1305或CBC+EtM在没有严格密钥交换时可被截断序号
+    bool chacha = contains(m_ciphers, "chacha20-poly1305@openssh.com");
+    bool cbcEtm = std::any_of(m_ciphers.begin(), m_ciphers.end(),
+                              [](const std::string& name) { return name.find("cbc") != std::string::npos; }) &&
+                  std::any_of(m_macs.begin(), m_macs.end(),
+                              [](const std::string& name) { return name.find("-etm@openssh.com") != std::string::npos; });
+    if ((chacha || cbcEtm) && !contains(m_kex, "kex-strict-s-v00@openssh.com")) {
+        m_info.findings.push_back(std::string("Terrapin prefix truncation (CVE-2023-48795) via ") +
+                                  (chacha ? "chacha20-poly1305" : "CBC with EtM MAC"));
+    }
+}
+
+bool SshDialog::buildKeyExchange(std::string_view ciphers, std::string_view macs) {
+    const char* kex = contains(m_kex, "curve25519-sha256") ? "curve25519-sha256"
+                    : contains(m_kex, "curve25519-sha256@libssh.org") ? "curve25519-sha256@libssh.org" : nullptr;
+    if (kex == nullptr) {
+        m_info.addDetail("hostkey_error", "curve25519 key exchange not supported");
+        return false;
+    }
+    const char* hostKey = nullptr;
+    for (const char* name : HOST_KEY_PREFERENCE) {
+        if (contains(m_hostKeys, name)) {
+            hostKey = name;
+            break;
+        }
+    }
+    if (hostKey == nullptr) {
+        m_info.addDetail("hostkey_error", "no supported host key algorithm");
+        return false;
+    }
+
+    char kexInit[OUTPUT_CAPACITY];
+    size_t length = 0;
+    bool overflow = false;
+    auto append = [&](const void* data, size_t size) {
+        if (length + size > sizeof(kexInit)) {
+            overflow = true;
+            return;
+        }
+        std::memcpy(kexInit + length, data, size);
+        length += size;
+    };
+    auto appendString = [&](std::string_view value) {
+        uint8_t header[4] = {uint8_t(value.size() >> 24), uint8_t(value.size() >> 16),
+                             uint8_t(value.size() >> 8), uint8_t(value.size())};
+        append(header, sizeof(header));
+        append(value.data(), value.size());
+    };
+
+    uint8_t type = SSH_MSG_KEXINIT;
+    append(&type, 1);
+    char cookie[16];
+    randomBytes(cookie, sizeof(cookie));
+    append(cookie, sizeof(cookie));
+    appendString(kex);
+    appendString(hostKey);
+    // 加密、MAC和压缩直接回应服务端的列表，协商必然成功; 协商结果不会被使用
+    appendString(ciphers);
+    appendString(ciphers);
+    appendString(macs);
+    appendString(macs);
+    appendString("none,zlib@openssh.com,zlib");
+    appendString("none,zlib@openssh.com,zlib");
+    appendString("");
+    appendString("");
+    const uint8_t trailer[5] = {0, 0, 0, 0, 0};   // first_kex_packet_follows, reserved
+    append(trailer, sizeof(trailer));
+    if (overflow || !appendPacket(std::string_view(kexInit, length))) {
+        m_info.addDetail("hostkey_error", "algorithm lists too long");
+        return false;
+    }
+
+    // KEX_ECDH_INIT: Q_C为32字节的X25519公钥，任意值都是合法的曲线点
+    char ecdhInit[1 + 4 + 32] = {static_cast<char>(SSH_MSG_KEX_ECDH_INIT), 0, 0, 0, 32};
+    randomBytes(ecdhInit + 5, 32);
+    if (!appendPacket(std::string_view(ecdhInit, sizeof(ecdhInit)))) {
+        m_info.addDetail("hostkey_error", "algorithm lists too long");
+        return false;
+    }
+    m_info.addDetail("hostkey_algorithm", hostKey);
+    return true;
+}
+
+bool SshDialog::appendPacket(std::string_view payload) {
+    // 包长+填充长度+负载+填充为8的倍数，填充至少4字节
+    size_t padding = 8 - (5 + payload.size()) % 8;
+    if (padding < 4) {
+        padding += 8;
+    }
+    size_t total = 5 + payload.size() + padding;
+    if (m_outputLength + total > m_output.size()) {
+        return false;
+    }
+
+    char* out = m_output.data() + m_outputLength;
+    uint32_t length = static_cast<uint32_t>(1 + payload.size() + padding);
+    out[0] = static_cast<char>(length >> 24);
+    out[1] = static_cast<char>(length >> 16);
+    out[2] = static_cast<char>(length >> 8);
+    out[3] = static_cast<char>(length);
+    out[4] = static_cast<char>(padding);
+    std::memcpy(out + 5, payload.data(), payload.size());
+    std::memset(out + 5 + payload.size(), 0, padding);
+    m_outputLength += total;
+    return true;
+}
+
+ServiceDialog::Status SshDialog::parseEcdhReply(std::string_view payload) {
+    // 类型(1) K_S Q_S 签名
+    size_t offset = 1;
+    std::string_view hostKey;
+    if (!readString(payload, offset, hostKey)) {
+        m_info.addDetail("hostkey_error", "invalid KEX_ECDH_REPLY");
+        return Status::DONE;
+    }
+
+    size_t keyOffset = 0;
+    std::string_view keyType;
+    if (!readString(hostKey, keyOffset, keyType)) {
+        m_info.addDetail("hostkey_error", "invalid host key");
+        return Status::DONE;
+    }
+    m_info.addDetail("hostkey_type", std::string(keyType));
+    m_info.addDetail("hostkey_sha256", fingerprint(hostKey));
+
+    // 密钥长度: RSA为模数n，DSA为素数p，ECDSA和Ed25519由算法决定
+    size_t bits = 0;
+    std::string_view first, second;
+    if (keyType == "ssh-rsa") {
+        if (readString(hostKey, keyOffset, first) && readString(hostKey, keyOffset, second)) {
+            bits = mpintBits(second);
+        }
+    } else if (keyType == "ssh-dss") {
+        if (readString(hostKey, keyOffset, first)) {
+            bits = mpintBits(first);
+        }
+    } else if (keyType == "ssh-ed25519") {
+        bits = 256;
+    } else if (keyType.compare(0, 19, "ecdsa-sha2-nistp256") == 0) {
+        bits = 256;
+    } else if (keyType.compare(0, 19, "ecdsa-sha2-nistp384") == 0) {
+        bits = 384;
+    } else if (keyType.compare(0, 19, "ecdsa-sha2-nistp521") == 0) {
+        bits = 521;
+    }
+    if (bits > 0) {
+        m_info.addDetail("hostkey_bits", std::to_string(bits));
+        if ((keyType == "ssh-rsa" || keyType == "ssh-dss") && bits < 2048) {
+            m_info.findings.push_back("Weak host key: " + std::string(keyType) + " " + std::to_string(bits) + " bits");
+        }
+    }
+    return Status::DONE;
+}
+
+} // namespace MindSploit::Service
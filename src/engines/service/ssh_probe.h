@@ -0,0 +1,57 @@
+#pragma once
+
+#include "service_prober.h"
+#include <array>
+
+namespace MindSploit::Service {
+
+// SSH探测对话
+//
+// 交换标识串后解析服务端的KEXINIT，得到密钥交换、主机密钥、加密和MAC算法列表，随即断开:
+//   - 连接建立后立即发送客户端标识，不等服务端标识，一次往返即可收到KEXINIT
+//   - 需要主机密钥时回应KEXINIT并发送KEX_ECDH_INIT (curve25519，公钥为32个随机字节)，
+//     从KEX_ECDH_REPLY中取出主机密钥后断开; 不计算共享密钥也不验证签名，无需密码学库
+//   - 弱算法、SSH-1和Terrapin (CVE-2023-48795) 条件记入findings
+// 发送的报文在对象内的固定缓冲区中构造，接收使用探测器的缓冲区池，不另外分配连接缓冲区。
+class SshDialog : public ServiceDialog {
+public:
+    explicit SshDialog(bool fetchHostKey);
+
+    std::string_view request() override;
+    Status receive(std::string_view input, size_t& consumed, std::string_view& output) override;
+    Status closed(std::string_view input) override;
+
+private:
+    enum class State {
+        IDENTIFICATION,
+        KEXINIT,
+        ECDH_REPLY
+    };
+
+    Status readIdentification(std::string_view input, size_t& consumed);
+    Status readPacket(std::string_view input, size_t& consumed, std::string_view& output);
+    Status parseKexInit(std::string_view payload, std::string_view& output);
+    Status parseEcdhReply(std::string_view payload);
+    void checkAlgorithms();
+    // 构造KEXINIT和KEX_ECDH_INIT (ciphers和macs为服务端KEXINIT中的原始列表)，
+    // 服务端不支持curve25519或没有可选的主机密钥算法时返回false
+    bool buildKeyExchange(std::string_view ciphers, std::string_view macs);
+
+    bool appendPacket(std::string_view payload);
+
+private:
+    bool m_fetchHostKey;
+    State m_state = State::IDENTIFICATION;
+    size_t m_identificationLines = 0;
+
+    std::vector<std::string> m_kex;
+    std::vector<std::string> m_hostKeys;
+    std::vector<std::string> m_ciphers;
+    std::vector<std::string> m_macs;
+
+    static constexpr size_t OUTPUT_CAPACITY = 2048;
+    std::array<char, OUTPUT_CAPACITY> m_output;
+    size_t m_outputLength = 0;
+};
+
+} // namespace MindSploit::Service
@@ -0,0 +1,582 @@
+#include "text_probes.h"
+#include <algorithm>
+#include <cctype>
+
+namespace MindSploit::Service {
+
+namespace {
+
+constexpr int DONE = ConversationScript::DONE;
+constexpr int FAILED = ConversationScript::FAILED;
+
+// Postfix postscreen等在问候前有数秒的延迟 (RFC 5321建议客户端等待5分钟)
+constexpr std::chrono::milliseconds SMTP_GREETING_WAIT{10000};
+
+// 去掉不可打印字符，服务端返回的文本原样进入结果
+std::string printable(std::string_view text) {
+    std::string value;
+    value.reserve(text.size());
+    for (unsigned char c : text) {
+        if (c >= 0x20 && c < 0x7f) {
+            value += static_cast<char>(c);
+        }
+    }
+    size_t start = value.find_first_not_of(' ');
+    if (start == std::string::npos) {
+        return "";
+    }
+    return value.substr(start, value.find_last_not_of(' ') - start + 1);
+}
+
+std::string upper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::toupper(c); });
+    return text;
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+size_t findIgnoreCase(std::string_view text, std::string_view needle) {
+    auto it = std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                          [](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+    return it == text.end() ? std::string_view::npos : static_cast<size_t>(it - text.begin());
+}
+
+// 逐行处理应答，行不含\r\n
+template <typename Function>
+void forEachLine(std::string_view reply, Function function) {
+    size_t offset = 0;
+    while (offset < reply.size()) {
+        size_t end = reply.find('\n', offset);
+        if (end == std::string_view::npos) {
+            end = reply.size();
+        }
+        std::string_view line = reply.substr(offset, end - offset);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        function(line);
+        offset = end + 1;
+    }
+}
+
+std::string_view firstLine(std::string_view reply) {
+    return reply.substr(0, reply.find_first_of("\r\n"));
+}
+
+// SMTP/FTP应答码，不是 "ddd " 或 "ddd-" 时返回-1
+int replyCode(std::string_view reply) {
+    if (reply.size() < 4 || (reply[3] != ' ' && reply[3] != '-' && reply[3] != '\r')) {
+        return -1;
+    }
+    int code = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        if (reply[i] < '0' || reply[i] > '9') {
+            return -1;
+        }
+        code = code * 10 + (reply[i] - '0');
+    }
+    return code;
+}
+
+// 应答码之后的文本
+std::string_view codedText(std::string_view line) {
+    return line.size() > 4 ? line.substr(4) : std::string_view();
+}
+
+void addCapability(ServiceInfo& info, const std::string& capability) {
+    if (!capability.empty() &&
+        std::find(info.capabilities.begin(), info.capabilities.end(), capability) == info.capabilities.end()) {
+        info.capabilities.push_back(capability);
+    }
+}
+
+bool hasCapability(const ServiceInfo& info, std::string_view capability) {
+    return std::find(info.capabilities.begin(), info.capabilities.end(), capability) != info.capabilities.end();
+}
+
+bool hasCapabilityPrefix(const ServiceInfo& info, std::string_view prefix) {
+    return std::any_of(info.capabilities.begin(), info.capabilities.end(),
+                       [prefix](const std::string& capability) { return startsWith(capability, prefix); });
+}
+
+// 以空格分隔的列表，如认证机制 "PLAIN LOGIN"，逐项加上前缀记为能力
+void addTokens(ServiceInfo& info, const std::string& prefix, std::string_view list) {
+    size_t offset = 0;
+    while (offset < list.size()) {
+        size_t end = list.find(' ', offset);
+        if (end == std::string_view::npos) {
+            end = list.size();
+        }
+        if (end > offset) {
+            addCapability(info, prefix + upper(std::string(list.substr(offset, end - offset))));
+        }
+        offset = end + 1;
+    }
+}
+
+// 问候语中常见的实现名称，版本为名称之后不远处第一个带点的数字串
+struct ProductPattern {
+    const char* needle;
+    const char* product;
+};
+
+const ProductPattern PRODUCT_PATTERNS[] = {
+    {"Postfix", "Postfix"},
+    {"Exim", "Exim"},
+    {"Sendmail", "Sendmail"},
+    {"OpenSMTPD", "OpenSMTPD"},
+    {"Haraka", "Haraka"},
+    {"qmail", "qmail"},
+    {"Microsoft ESMTP", "Microsoft SMTP"},
+    {"Microsoft Exchange", "Microsoft Exchange"},
+    {"hMailServer", "hMailServer"},
+    {"MailEnable", "MailEnable"},
+    {"MDaemon", "MDaemon"},
+    {"Zimbra", "Zimbra"},
+    {"vsFTPd", "vsftpd"},
+    {"ProFTPD", "ProFTPD"},
+    {"Pure-FTPd", "Pure-FTPd"},
+    {"FileZilla Server", "FileZilla Server"},
+    {"Microsoft FTP Service", "Microsoft FTP Service"},
+    {"Serv-U", "Serv-U"},
+    {"wu-ftpd", "wu-ftpd"},
+    {"Dovecot", "Dovecot"},
+    {"Cyrus", "Cyrus"},
+    {"Courier", "Courier"},
+    {"Gimap", "Gmail"},
+};
+
+void detectProduct(ServiceInfo& info, std::string_view text) {
+    if (!info.product.empty()) {
+        return;
+    }
+    for (const auto& pattern : PRODUCT_PATTERNS) {
+        size_t pos = findIgnoreCase(text, pattern.needle);
+        if (pos == std::string_view::npos) {
+            continue;
+        }
+        info.product = pattern.product;
+
+        size_t start = pos + std::char_traits<char>::length(pattern.needle);
+        size_t limit = std::min(text.size(), start + 16);
+        while (start < limit && !std::isdigit((unsigned char)text[start])) {
+            ++start;
+        }
+        size_t end = start;
+        while (end < text.size() && (std::isalnum((unsigned char)text[end]) || text[end] == '.' || text[end] == '_')) {
+            ++end;
+        }
+        std::string_view version = text.substr(start, end - start);
+        while (!version.empty() && version.back() == '.') {
+            version.remove_suffix(1);
+        }
+        // 不带点的数字多半是协议名的一部分，如 IMAP4
+        if (version.find('.') != std::string_view::npos) {
+            info.version = std::string(version);
+        }
+        return;
+    }
+}
+
+// ===== SMTP =====
+
+enum SmtpStep {
+    SMTP_GREETING,
+    SMTP_EHLO,
+    SMTP_HELO,
+    SMTP_STARTTLS
+};
+
+int smtpGreeting(ServiceInfo& info, std::string_view reply) {
+    int code = replyCode(reply);
+    if (code < 0) {
+        return FAILED;
+    }
+    info.service = "smtp";
+    info.addDetail("banner", printable(codedText(firstLine(reply))));
+    detectProduct(info, reply);
+    if (code != 220) {
+        // 421/554: 拒绝本机连接
+        info.auth = AuthState::DENIED;
+        return DONE;
+    }
+    return SMTP_EHLO;
+}
+
+int smtpEhlo(ServiceInfo& info, std::string_view reply) {
+    int code = replyCode(reply);
+    if (code >= 500) {
+        return SMTP_HELO;
+    }
+    if (code != 250) {
+        info.addDetail("ehlo", printable(firstLine(reply)));
+        return DONE;
+    }
+
+    // 首行为服务端主机名，其后每行一个扩展
+    bool first = true;
+    forEachLine(reply, [&](std::string_view line) {
+        if (first) {
+            first = false;
+            return;
+        }
+        std::string keyword = upper(printable(codedText(line)));
+        if (startsWith(keyword, "AUTH ") || startsWith(keyword, "AUTH=")) {
+            addTokens(info, "AUTH=", std::string_view(keyword).substr(5));
+        } else if (startsWith(keyword, "SIZE ")) {
+            info.addDetail("max_size", keyword.substr(5));
+            addCapability(info, "SIZE");
+        } else {
+            addCapability(info, keyword.substr(0, keyword.find(' ')));
+        }
+    });
+
+    bool cleartextAuth = hasCapability(info, "AUTH=PLAIN") || hasCapability(info, "AUTH=LOGIN");
+    if (hasCapability(info, "STARTTLS")) {
+        if (cleartextAuth) {
+            info.findings.push_back("AUTH PLAIN/LOGIN offered before STARTTLS");
+        }
+        return SMTP_STARTTLS;
+    }
+    info.findings.push_back(cleartextAuth ? "STARTTLS not offered, AUTH PLAIN/LOGIN in cleartext"
+                                          : "STARTTLS not offered");
+    return DONE;
+}
+
+int smtpHelo(ServiceInfo& info, std::string_view reply) {
+    if (replyCode(reply) == 250) {
+        info.findings.push_back("ESMTP not supported (no STARTTLS)");
+    } else {
+        info.addDetail("helo", printable(firstLine(reply)));
+    }
+    return DONE;
+}
+
+int smtpStartTls(ServiceInfo& info, std::string_view reply) {
+    // 之后应开始TLS握手，这里到此为止
+    if (replyCode(reply) == 220) {
+        info.addDetail("starttls", "ready");
+    } else {
+        info.addDetail("starttls", printable(firstLine(reply)));
+        info.findings.push_back("STARTTLS advertised but refused");
+    }
+    return DONE;
+}
+
+// ===== FTP =====
+
+enum FtpStep {
+    FTP_GREETING,
+    FTP_FEAT
+};
+
+int ftpGreeting(ServiceInfo& info, std::string_view reply) {
+    int code = replyCode(reply);
+    if (code < 0) {
+        return FAILED;
+    }
+    info.service = "ftp";
+    info.addDetail("banner", printable(codedText(firstLine(reply))));
+    detectProduct(info, reply);
+    if (code != 220) {
+        info.auth = code >= 400 ? AuthState::DENIED : AuthState::UNKNOWN;
+        return DONE;
+    }
+    return FTP_FEAT;
+}
+
+int ftpFeat(ServiceInfo& info, std::string_view reply) {
+    if (replyCode(reply) != 211) {
+        info.addDetail("feat", "unsupported");
+        return DONE;
+    }
+
+    // 首尾两行带应答码，中间每行一个特性 (以空格开头)
+    forEachLine(reply, [&](std::string_view line) {
+        if (replyCode(line) >= 0) {
+            return;
+        }
+        std::string feature = upper(printable(line));
+        if (startsWith(feature, "AUTH ") || startsWith(feature, "REST ")) {
+            addCapability(info, feature);
+        } else {
+            addCapability(info, feature.substr(0, feature.find(' ')));
+        }
+    });
+    if (!hasCapabilityPrefix(info, "AUTH ")) {
+        info.findings.push_back("Explicit FTPS (AUTH TLS) not offered");
+    }
+    return DONE;
+}
+
+// ===== POP3 =====
+
+enum Pop3Step {
+    POP3_GREETING,
+    POP3_CAPA
+};
+
+int pop3Greeting(ServiceInfo& info, std::string_view reply) {
+    std::string_view line = firstLine(reply);
+    if (startsWith(line, "-ERR")) {
+        info.service = "pop3";
+        info.addDetail("banner", printable(line.substr(4)));
+        info.auth = AuthState::DENIED;
+        return DONE;
+    }
+    if (!startsWith(line, "+OK")) {
+        return FAILED;
+    }
+    info.service = "pop3";
+    info.addDetail("banner", printable(line.substr(3)));
+    detectProduct(info, line);
+    // APOP时间戳 <进程.时钟@主机>
+    size_t open = line.find('<');
+    if (open != std::string_view::npos && line.find('@', open) != std::string_view::npos &&
+        line.find('>', open) != std::string_view::npos) {
+        addCapability(info, "APOP");
+    }
+    return POP3_CAPA;
+}
+
+int pop3Capa(ServiceInfo& info, std::string_view reply) {
+    if (!startsWith(reply, "+OK")) {
+        info.addDetail("capa", "unsupported");
+        return DONE;
+    }
+
+    bool first = true;
+    forEachLine(reply, [&](std::string_view line) {
+        if (first || line == ".") {
+            first = false;
+            return;
+        }
+        std::string keyword = upper(printable(line));
+        if (startsWith(keyword, "SASL ")) {
+            addTokens(info, "SASL=", std::string_view(keyword).substr(5));
+        } else if (startsWith(keyword, "IMPLEMENTATION ")) {
+            std::string implementation = printable(line.substr(15));
+            info.addDetail("implementation", implementation);
+            detectProduct(info, implementation);
+        } else {
+            addCapability(info, keyword.substr(0, keyword.find(' ')));
+        }
+    });
+
+    bool cleartextLogin = hasCapability(info, "USER") || hasCapability(info, "SASL=PLAIN") ||
+                          hasCapability(info, "SASL=LOGIN");
+    if (!hasCapability(info, "STLS")) {
+        info.findings.push_back("STLS not offered");
+    } else if (cleartextLogin) {
+        info.findings.push_back("Cleartext login allowed before STLS");
+    }
+    return DONE;
+}
+
+// ===== IMAP =====
+
+enum ImapStep {
+    IMAP_GREETING,
+    IMAP_CAPABILITY
+};
+
+void checkImapCapabilities(ServiceInfo& info) {
+    if (!hasCapability(info, "STARTTLS")) {
+        info.findings.push_back("STARTTLS not offered");
+    } else if (!hasCapability(info, "LOGINDISABLED")) {
+        info.findings.push_back("LOGIN allowed before STARTTLS");
+    }
+}
+
+int imapGreeting(ServiceInfo& info, std::string_view reply) {
+    std::string_view line = firstLine(reply);
+    std::string_view text;
+    if (startsWith(line, "* OK")) {
+        text = line.substr(4);
+    } else if (startsWith(line, "* PREAUTH")) {
+        text = line.substr(9);
+        info.auth = AuthState::NONE;
+        info.findings.push_back("Session pre-authenticated (PREAUTH)");
+    } else if (startsWith(line, "* BYE")) {
+        info.service = "imap";
+        info.addDetail("banner", printable(line.substr(5)));
+        info.auth = AuthState::DENIED;
+        return DONE;
+    } else {
+        return FAILED;
+    }
+    info.service = "imap";
+
+    // 问候语可以带应答码 [CAPABILITY ...]，此时无需再查询
+    text = text.substr(std::min(text.size(), text.find_first_not_of(' ')));
+    bool listed = false;
+    if (startsWith(upper(std::string(text.substr(0, 12))), "[CAPABILITY ")) {
+        size_t close = text.find(']');
+        if (close != std::string_view::npos) {
+            addTokens(info, "", text.substr(12, close - 12));
+            text = text.substr(close + 1);
+            listed = true;
+        }
+    }
+    info.addDetail("banner", printable(text));
+    detectProduct(info, text);
+    if (listed) {
+        checkImapCapabilities(info);
+        return DONE;
+    }
+    return IMAP_CAPABILITY;
+}
+
+int imapCapability(ServiceInfo& info, std::string_view reply) {
+    bool listed = false;
+    forEachLine(reply, [&](std::string_view line) {
+        if (startsWith(upper(std::string(line.substr(0, 13))), "* CAPABILITY ")) {
+            addTokens(info, "", line.substr(13));
+            listed = true;
+        }
+    });
+    if (!listed) {
+        info.addDetail("capability", "unsupported");
+        return DONE;
+    }
+    checkImapCapabilities(info);
+    return DONE;
+}
+
+// ===== 协议表 =====
+
+const ConversationScript& smtpScript() {
+    static const ConversationScript script = {"smtp", {
+        {"", ReplyMatcher::coded(), smtpGreeting, SMTP_GREETING_WAIT},
+        {"EHLO mindsploit.local\r\n", ReplyMatcher::coded(), smtpEhlo},
+        {"HELO mindsploit.local\r\n", ReplyMatcher::coded(), smtpHelo},
+        {"STARTTLS\r\n", ReplyMatcher::coded(), smtpStartTls},
+    }};
+    return script;
+}
+
+const ConversationScript& ftpScript() {
+    static const ConversationScript script = {"ftp", {
+        {"", ReplyMatcher::coded(), ftpGreeting},
+        {"FEAT\r\n", ReplyMatcher::coded(), ftpFeat},
+    }};
+    return script;
+}
+
+const ConversationScript& pop3Script() {
+    static const ConversationScript script = {"pop3", {
+        {"", ReplyMatcher::line(), pop3Greeting},
+        {"CAPA\r\n", ReplyMatcher::dotTerminated(), pop3Capa},
+    }};
+    return script;
+}
+
+const ConversationScript& imapScript() {
+    static const ConversationScript script = {"imap", {
+        {"", ReplyMatcher::line(), imapGreeting},
+        {"a1 CAPABILITY\r\n", ReplyMatcher::tagged("a1 "), imapCapability},
+    }};
+    return script;
+}
+
+struct ProtocolEntry {
+    TextProtocol protocol;
+    const char* name;
+    std::vector<int> ports;
+    std::vector<const char*> services;          // 端口扫描结果中的服务名
+};
+
+const std::vector<ProtocolEntry>& protocolTable() {
+    static const std::vector<ProtocolEntry> table = {
+        {TextProtocol::SMTP, "smtp", {25, 587, 2525}, {"smtp", "submission"}},
+        {TextProtocol::FTP, "ftp", {21}, {"ftp"}},
+        {TextProtocol::POP3, "pop3", {110}, {"pop3", "pop"}},
+        {TextProtocol::IMAP, "imap", {143}, {"imap", "imap4"}},
+    };
+    return table;
+}
+
+} // namespace
+
+std::string textProtocolName(TextProtocol protocol) {
+    for (const auto& entry : protocolTable()) {
+        if (entry.protocol == protocol) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+bool parseTextProtocol(const std::string& name, TextProtocol& protocol) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "submission" || lower == "esmtp") {
+        lower = "smtp";
+    } else if (lower == "pop") {
+        lower = "pop3";
+    } else if (lower == "imap4") {
+        lower = "imap";
+    }
+    for (const auto& entry : protocolTable()) {
+        if (lower == entry.name) {
+            protocol = entry.protocol;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<TextProtocol>& textProtocols() {
+    static const std::vector<TextProtocol> protocols = [] {
+        std::vector<TextProtocol> list;
+        for (const auto& entry : protocolTable()) {
+            list.push_back(entry.protocol);
+        }
+        return list;
+    }();
+    return protocols;
+}
+
+bool textProtocolForService(int port, const std::string& service, TextProtocol& protocol) {
+    // 服务名优先，非标准端口上的服务由服务识别给出
+    for (const auto& entry : protocolTable()) {
+        for (const char* name : entry.services) {
+            if (service == name) {
+                protocol = entry.protocol;
+                return true;
+            }
+        }
+    }
+    for (const auto& entry : protocolTable()) {
+        if (std::find(entry.ports.begin(), entry.ports.end(), port) != entry.ports.end()) {
+            protocol = entry.protocol;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<int>& defaultTextPorts() {
+    static const std::vector<int> ports = [] {
+        std::vector<int> list;
+        for (const auto& entry : protocolTable()) {
+            list.insert(list.end(), entry.ports.begin(), entry.ports.end());
+        }
+        return list;
+    }();
+    return ports;
+}
+
+const ConversationScript& textProtocolScript(TextProtocol protocol) {
+    switch (protocol) {
+        case TextProtocol::SMTP: return smtpScript();
+        case TextProtocol::FTP: return ftpScript();
+        case TextProtocol::POP3: return pop3Script();
+        case TextProtocol::IMAP: break;
+    }
+    return imapScript();
+}
+
+} // namespace MindSploit::Service
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "conversation.h"
+
+namespace MindSploit::Service {
+
+// 以文本命令应答的服务协议
+enum class TextProtocol {
+    SMTP,
+    FTP,
+    POP3,
+    IMAP
+};
+
+std::string textProtocolName(TextProtocol protocol);
+bool parseTextProtocol(const std::string& name, TextProtocol& protocol);
+const std::vector<TextProtocol>& textProtocols();
+
+// 端口扫描给出的服务名或默认端口对应的协议
+bool textProtocolForService(int port, const std::string& service, TextProtocol& protocol);
+const std::vector<int>& defaultTextPorts();
+
+// 多步对话脚本，读取问候语后查询能力，不尝试登录:
+//   - SMTP: 问候语 → EHLO (不支持时HELO) → 声明了STARTTLS时发送STARTTLS确认可用，之后断开
+//   - FTP: 问候语 → FEAT
+//   - POP3: 问候语 (APOP时间戳) → CAPA
+//   - IMAP: 问候语中带CAPABILITY时直接结束，否则 → a1 CAPABILITY
+// 发现中记录未提供STARTTLS/STLS/AUTH TLS、加密之前即允许明文登录、预认证会话等。
+const ConversationScript& textProtocolScript(TextProtocol protocol);
+
+} // namespace MindSploit::Service
@@ -0,0 +1,161 @@
+#include "cipher_enum.h"
+#include <algorithm>
+
+namespace MindSploit::Tls {
+
+CipherEnumerator::CipherEnumerator(TlsProber& prober, const CipherEnumConfig& config)
+    : m_prober(prober), m_config(config) {
+    m_config.perEndpoint = std::max<size_t>(1, m_config.perEndpoint);
+    m_config.splitThreshold = std::max<size_t>(2, m_config.splitThreshold);
+}
+
+void CipherEnumerator::enumerate(const Utils::IPAddress& address, uint16_t port, const std::string& serverName,
+                                 Callback callback) {
+    auto job = std::make_shared<Job>();
+    job->result.address = address;
+    job->result.port = port;
+    job->result.serverName = serverName;
+    job->callback = std::move(callback);
+    job->started = Clock::now();
+
+    // 每个版本的首轮探测同时确定该版本是否支持
+    for (uint16_t version : m_config.versions) {
+        Offer offer;
+        offer.version = version;
+        for (const auto& suite : knownCipherSuites()) {
+            if (isTls13CipherSuite(suite.id) == (version == TLS_VERSION_1_3)) {
+                offer.cipherSuites.push_back(suite.id);
+            }
+        }
+        job->pending.push_back(std::move(offer));
+    }
+
+    ++m_active;
+    dispatch(job);
+}
+
+void CipherEnumerator::dispatch(const std::shared_ptr<Job>& job) {
+    while (!job->pending.empty() && job->inflight < m_config.perEndpoint) {
+        Offer offer = std::move(job->pending.front());
+        job->pending.pop_front();
+
+        TlsProbeRequest request;
+        request.address = job->result.address;
+        request.port = job->result.port;
+        request.serverName = job->result.serverName;
+        request.mode = TlsProbeRequest::Mode::HELLO;
+        request.clientHello = buildOffer(offer, job->result.serverName);
+        request.stopAt = TlsHandshakeReader::StopAt::SERVER_HELLO;
+
+        ++job->inflight;
+        m_prober.submit(std::move(request),
+                        [this, job, offer = std::move(offer)](const TlsProbeRequest&, const TlsProbeResult& probe) {
+                            onResult(job, offer, probe);
+                        });
+    }
+
+    // 提交失败时回调同步执行，可能已经在内层结束
+    if (job->pending.empty() && job->inflight == 0 && !job->finished) {
+        finish(*job);
+    }
+}
+
+void CipherEnumerator::onResult(const std::shared_ptr<Job>& job, Offer offer, const TlsProbeResult& probe) {
+    --job->inflight;
+    ++job->result.probes;
+    CipherEnumResult& result = job->result;
+
+    if (!probe.connected) {
+        // 连接失败不能说明服务端拒绝了这批套件
+        if (offer.attempts < m_config.maxRetries) {
+            ++offer.attempts;
+            job->pending.push_front(std::move(offer));
+        } else {
+            ++result.inconclusive;
+            ++job->connectFailures;
+            result.error = probe.error;
+        }
+        dispatch(job);
+        return;
+    }
+    ++job->answered;
+
+    // 告警、断开或协商了其它版本都表示剩余列表中没有该版本可用的套件
+    const ServerHelloInfo& hello = probe.serverHello;
+    auto chosen = std::find(offer.cipherSuites.begin(), offer.cipherSuites.end(), hello.cipherSuite);
+    if (hello.received && hello.version == offer.version && chosen != offer.cipherSuites.end()) {
+        if (std::find(result.versions.begin(), result.versions.end(), offer.version) == result.versions.end()) {
+            result.versions.push_back(offer.version);
+        }
+        auto& suites = result.cipherSuites[offer.version];
+        if (std::find(suites.begin(), suites.end(), hello.cipherSuite) == suites.end()) {
+            suites.push_back(hello.cipherSuite);
+        }
+        offer.cipherSuites.erase(chosen);
+        queueRemaining(*job, offer.version, std::move(offer.cipherSuites));
+    }
+
+    dispatch(job);
+}
+
+void CipherEnumerator::queueRemaining(Job& job, uint16_t version, std::vector<uint16_t> remaining) {
+    if (remaining.empty()) {
+        return;
+    }
+
+    // 候选较多时拆成两半并行，两半各自继续缩小
+    if (remaining.size() >= m_config.splitThreshold) {
+        size_t half = remaining.size() / 2;
+        Offer first;
+        first.version = version;
+        first.cipherSuites.assign(remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(half));
+        Offer second;
+        second.version = version;
+        second.cipherSuites.assign(remaining.begin() + static_cast<std::ptrdiff_t>(half), remaining.end());
+        job.pending.push_back(std::move(first));
+        job.pending.push_back(std::move(second));
+        return;
+    }
+
+    Offer offer;
+    offer.version = version;
+    offer.cipherSuites = std::move(remaining);
+    job.pending.push_back(std::move(offer));
+}
+
+void CipherEnumerator::finish(Job& job) {
+    job.finished = true;
+    CipherEnumResult& result = job.result;
+    std::sort(result.versions.begin(), result.versions.end());
+    for (auto& entry : result.cipherSuites) {
+        std::sort(entry.second.begin(), entry.second.end());
+    }
+    if (job.answered > 0) {
+        result.error.clear();
+    } else if (result.error.empty()) {
+        result.error = "Connection failed";
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - job.started);
+
+    --m_active;
+    if (job.callback) {
+        job.callback(result);
+    }
+}
+
+std::string CipherEnumerator::buildOffer(const Offer& offer, const std::string& serverName) {
+    ClientHelloSpec spec;
+    spec.serverName = serverName;
+    spec.cipherSuites = offer.cipherSuites;
+    if (offer.version == TLS_VERSION_1_3) {
+        spec.legacyVersion = TLS_VERSION_1_2;
+        spec.supportedVersions = {TLS_VERSION_1_3};
+    } else {
+        // 只提供单一版本，服务端不支持时应以protocol_version告警拒绝
+        spec.legacyVersion = offer.version;
+        spec.recordVersion = offer.version == SSL_VERSION_3_0 ? SSL_VERSION_3_0 : TLS_VERSION_1_0;
+    }
+    return buildClientHello(spec);
+}
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "tls_prober.h"
+#include <map>
+
+namespace MindSploit::Tls {
+
+// 枚举配置
+struct CipherEnumConfig {
+    size_t perEndpoint = 8;                     // 每个端点同时在途的ClientHello数
+    size_t splitThreshold = 8;                  // 剩余候选不少于此数时一分为二并行探测
+    int maxRetries = 1;                         // 连接失败的探测重试次数
+    std::vector<uint16_t> versions = {SSL_VERSION_3_0, TLS_VERSION_1_0, TLS_VERSION_1_1,
+                                      TLS_VERSION_1_2, TLS_VERSION_1_3};
+};
+
+// 单个端点的枚举结果
+struct CipherEnumResult {
+    Utils::IPAddress address;
+    uint16_t port = 0;
+    std::string serverName;
+    std::vector<uint16_t> versions;                             // 支持的协议版本，升序
+    std::map<uint16_t, std::vector<uint16_t>> cipherSuites;     // 版本 -> 支持的套件，按编号升序
+    size_t probes = 0;
+    size_t inconclusive = 0;                    // 重试后仍连接失败、结果不确定的探测
+    std::string error;                          // 端点不可达
+    std::chrono::milliseconds elapsed{0};
+
+    bool ok() const { return error.empty(); }
+};
+
+// 协议版本和密码套件枚举
+//
+// 不为每个套件单独握手，而是发送候选列表让服务端挑选:
+//   - 每个版本先提供全部套件，服务端选中的套件即为支持，从列表中移除后继续提供剩余部分
+//   - 服务端拒绝 (告警或断开) 说明剩余列表中没有支持的套件，整批排除
+//   - 剩余列表较长时拆成两半并行探测，探测轮数随支持的套件数对数增长
+// 探测次数约为 支持的套件数 + 被拒绝的分支数，远少于逐个套件握手。
+class CipherEnumerator {
+public:
+    using Callback = std::function<void(const CipherEnumResult& result)>;
+
+    CipherEnumerator(TlsProber& prober, const CipherEnumConfig& config);
+
+    CipherEnumerator(const CipherEnumerator&) = delete;
+    CipherEnumerator& operator=(const CipherEnumerator&) = delete;
+
+    void enumerate(const Utils::IPAddress& address, uint16_t port, const std::string& serverName,
+                   Callback callback);
+    // 进行中的端点数
+    size_t active() const { return m_active; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Offer {
+        uint16_t version = 0;
+        std::vector<uint16_t> cipherSuites;
+        int attempts = 0;
+    };
+
+    struct Job {
+        CipherEnumResult result;
+        Callback callback;
+        Clock::time_point started;
+        std::deque<Offer> pending;
+        size_t inflight = 0;
+        size_t connectFailures = 0;
+        size_t answered = 0;                    // 建立了连接的探测数
+        bool finished = false;
+    };
+
+    void dispatch(const std::shared_ptr<Job>& job);
+    void onResult(const std::shared_ptr<Job>& job, Offer offer, const TlsProbeResult& probe);
+    void queueRemaining(Job& job, uint16_t version, std::vector<uint16_t> remaining);
+    void finish(Job& job);
+
+    static std::string buildOffer(const Offer& offer, const std::string& serverName);
+
+private:
+    TlsProber& m_prober;
+    CipherEnumConfig m_config;
+    size_t m_active = 0;
+};
+
+} // namespace MindSploit::Tls
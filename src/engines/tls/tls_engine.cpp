@@ -0,0 +1,956 @@
+#include "tls_engine.h"
+#include "tls_prober.h"
+#include "cipher_enum.h"
+#include "tls_fingerprint.h"
+#include "../network/scan_baseline.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/target_space.h"
+#include "../../utils/json_utils.h"
+#include "../../utils/host_cluster.h"
+#include <sstream>
+#include <fstream>
+#include <ctime>
+#include <algorithm>
+#include <cctype>
+
+namespace MindSploit::Tls {
+
+// 未指定端口时探测的隐式TLS端口
+const std::vector<int> TlsEngine::DEFAULT_TLS_PORTS = {
+    443, 465, 636, 853, 989, 990, 992, 993, 994, 995, 5061, 8443
+};
+
+namespace {
+
+std::string endpointRecord(const TlsEndpointResult& probe) {
+    const CertificateInfo& cert = probe.certificate;
+    return "{\"ip\":\"" + Utils::jsonEscape(probe.ip) + "\",\"port\":" + std::to_string(probe.port) +
+           ",\"sni\":\"" + Utils::jsonEscape(probe.serverName) + "\",\"version\":\"" + Utils::jsonEscape(probe.version) +
+           "\",\"cipher\":\"" + Utils::jsonEscape(probe.cipher) + "\",\"alpn\":\"" + Utils::jsonEscape(probe.alpn) +
+           "\",\"subject\":\"" + Utils::jsonEscape(cert.subject) + "\",\"issuer\":\"" + Utils::jsonEscape(cert.issuer) +
+           "\",\"sans\":" + Utils::jsonArray(cert.subjectAltNames) + ",\"serial\":\"" + cert.serialNumber +
+           "\",\"not_before\":\"" + cert.notBefore + "\",\"not_after\":\"" + cert.notAfter +
+           "\",\"key\":\"" + Utils::jsonEscape(cert.keyDescription()) + "\",\"signature\":\"" +
+           Utils::jsonEscape(cert.signatureAlgorithm) + "\",\"self_signed\":" + (cert.selfSigned ? "true" : "false") +
+           ",\"chain\":" + std::to_string(probe.chainLength) + ",\"resumed\":" + (probe.resumed ? "true" : "false") +
+           ",\"elapsed_ms\":" + std::to_string(probe.elapsed.count()) + "}";
+}
+
+// inferredFrom非空表示结果来自指纹相同的代表端点，本端点未实际枚举
+std::string cipherRecord(const CipherEnumResult& probe, const std::string& inferredFrom = "") {
+    std::string versions;
+    std::string suites;
+    std::vector<std::string> weak;
+    for (uint16_t version : probe.versions) {
+        std::string name = versionName(version);
+        versions += (versions.empty() ? "\"" : ",\"") + name + "\"";
+
+        std::vector<std::string> names;
+        auto it = probe.cipherSuites.find(version);
+        if (it != probe.cipherSuites.end()) {
+            for (uint16_t id : it->second) {
+                names.push_back(cipherSuiteName(id));
+                if (isWeakCipherSuite(id) && std::find(weak.begin(), weak.end(), names.back()) == weak.end()) {
+                    weak.push_back(names.back());
+                }
+            }
+        }
+        suites += (suites.empty() ? "\"" : ",\"") + name + "\":" + Utils::jsonArray(names);
+    }
+    return "{\"ip\":\"" + Utils::jsonEscape(probe.address.toString()) + "\",\"port\":" + std::to_string(probe.port) +
+           ",\"sni\":\"" + Utils::jsonEscape(probe.serverName) + "\",\"versions\":[" + versions +
+           "],\"ciphers\":{" + suites + "},\"weak\":" + Utils::jsonArray(weak) +
+           ",\"probes\":" + std::to_string(probe.probes) + ",\"inconclusive\":" + std::to_string(probe.inconclusive) +
+           (inferredFrom.empty() ? "" : ",\"inferred_from\":\"" + Utils::jsonEscape(inferredFrom) + "\"") +
+           ",\"elapsed_ms\":" + std::to_string(probe.elapsed.count()) + "}";
+}
+
+std::string fingerprintRecord(const TlsFingerprintResult& probe) {
+    return "{\"ip\":\"" + Utils::jsonEscape(probe.address.toString()) + "\",\"port\":" + std::to_string(probe.port) +
+           ",\"sni\":\"" + Utils::jsonEscape(probe.serverName) + "\",\"fingerprint\":\"" + probe.fingerprint +
+           "\",\"responses\":" + std::to_string(probe.responses) +
+           ",\"elapsed_ms\":" + std::to_string(probe.elapsed.count()) + "}";
+}
+
+// 证书模式: 只提供TLS 1.2及以下，让服务端以明文发送证书
+std::string certificateHello(const std::string& serverName) {
+    ClientHelloSpec spec;
+    spec.serverName = serverName;
+    for (const auto& suite : knownCipherSuites()) {
+        if (!isTls13CipherSuite(suite.id)) {
+            spec.cipherSuites.push_back(suite.id);
+        }
+    }
+    return buildClientHello(spec);
+}
+
+// 单个主机名作为SNI，IP地址、范围和列表不发送
+bool isHostName(const std::string& host) {
+    if (host.empty() || host.find_first_of(",/:") != std::string::npos) {
+        return false;
+    }
+    return std::any_of(host.begin(), host.end(), [](unsigned char c) { return std::isalpha(c); });
+}
+
+} // namespace
+
+TlsEngine::TlsEngine() {
+    m_options["timeout"] = "10000";
+    m_options["concurrency"] = "1000";
+    m_options["mode"] = tlsAvailable() ? "full" : "cert";
+    m_options["per-host"] = "8";
+}
+
+TlsEngine::~TlsEngine() {
+    shutdown();
+}
+
+bool TlsEngine::initialize() {
+    if (!Utils::NetworkUtils::initialize()) {
+        return false;
+    }
+
+    m_status = EngineStatus::IDLE;
+    return true;
+}
+
+bool TlsEngine::shutdown() {
+    stop();
+    return true;
+}
+
+ExecutionResult TlsEngine::execute(const CommandContext& context) {
+    ExecutionResult result;
+
+    if (context.command == "tls") {
+        result = executeTls(context);
+    } else if (context.command == "ciphers") {
+        result = executeCiphers(context);
+    } else if (context.command == "tlsfp") {
+        result = executeFingerprint(context);
+    } else {
+        result.success = false;
+        result.message = "Unsupported command: " + context.command;
+    }
+
+    return result;
+}
+
+void TlsEngine::stop() {
+    m_stopRequested = true;
+}
+
+EngineStatus TlsEngine::getStatus() const {
+    return m_status;
+}
+
+std::string TlsEngine::getDescription() const {
+    return "Concurrent TLS handshake and certificate harvesting engine";
+}
+
+std::vector<std::string> TlsEngine::getSupportedCommands() const {
+    return {"tls", "ciphers", "tlsfp"};
+}
+
+std::map<std::string, std::string> TlsEngine::getRequiredParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "tls" || command == "ciphers" || command == "tlsfp") {
+        params["target"] = "Target host[:port], IP address, range or CIDR";
+    }
+
+    return params;
+}
+
+std::map<std::string, std::string> TlsEngine::getOptionalParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "tls") {
+        params["ports"] = "Ports to probe (default: common implicit-TLS ports)";
+        params["from-scan"] = "Probe open TLS ports of a previous scan (latest or result id)";
+        params["mode"] = "full (complete handshake, caches sessions) or cert (abort after Certificate)";
+        params["sni"] = "Server name to send (default: target host name)";
+        params["concurrency"] = "Maximum concurrent handshakes (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    } else if (command == "ciphers") {
+        params["ports"] = "Ports to probe (default: common implicit-TLS ports)";
+        params["from-scan"] = "Enumerate open TLS ports of a previous scan (latest or result id)";
+        params["sni"] = "Server name to send (default: target host name)";
+        params["per-host"] = "Concurrent ClientHellos per endpoint (default: 8)";
+        params["cluster"] = "on (default) enumerates one endpoint per TLS fingerprint and infers the rest, off enumerates all";
+        params["concurrency"] = "Maximum concurrent connections (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    } else if (command == "tlsfp") {
+        params["ports"] = "Ports to probe (default: common implicit-TLS ports)";
+        params["from-scan"] = "Fingerprint open TLS ports of a previous scan (latest or result id)";
+        params["sni"] = "Server name to send (default: target host name)";
+        params["concurrency"] = "Maximum concurrent connections (default: 1000)";
+        params["output"] = "Write results as JSON lines to file";
+    }
+
+    params["timeout"] = "Handshake timeout in milliseconds";
+
+    return params;
+}
+
+bool TlsEngine::setOption(const std::string& key, const std::string& value) {
+    m_options[key] = value;
+    return true;
+}
+
+std::string TlsEngine::getOption(const std::string& key) const {
+    auto it = m_options.find(key);
+    return (it != m_options.end()) ? it->second : "";
+}
+
+std::map<std::string, std::string> TlsEngine::getAllOptions() const {
+    return m_options;
+}
+
+bool TlsEngine::checkDependencies() const {
+    // 证书模式不依赖OpenSSL
+    return true;
+}
+
+std::vector<std::string> TlsEngine::getMissingDependencies() const {
+    if (!tlsAvailable()) {
+        return {"OpenSSL (full handshake, session resumption)"};
+    }
+    return {};
+}
+
+std::string TlsEngine::getHelp() const {
+    return R"(
+TLS Engine - TLS探测引擎
+
+支持的命令:
+  tls <target|host:port> [options] - TLS握手，采集证书、协商版本和密码套件
+  ciphers <target|host:port> [options] - 枚举支持的协议版本和密码套件
+  tlsfp <target|host:port> [options] - 主动TLS指纹，按指纹聚类相同的TLS实现
+
+选项:
+  -ports <range>         - 探测端口 (默认常见隐式TLS端口)
+  -from-scan <ref>       - 探测端口扫描结果中的开放TLS端口 (latest 或结果编号)
+  -mode <full|cert>      - full: 完整握手并缓存会话，后续HTTPS和枚举探测直接复用
+                           cert: 收到证书后立即中止，不需要OpenSSL，仅支持TLS 1.2及以下
+  -sni <name>            - 发送的服务器名称 (默认使用目标主机名)
+  -concurrency <num>     - 同时进行的握手上限 (默认 1000)
+  -per-host <num>        - ciphers: 每个端点同时发送的ClientHello数 (默认 8)
+  -cluster <on|off>      - ciphers: 先采集TLS指纹，指纹相同的端点只枚举一个并推断其余 (默认 on)
+  -timeout <ms>          - 握手超时时间 (毫秒)
+  -output <file>         - 结果以JSON行写入文件
+
+示例:
+  tls example.com
+  tls 192.168.1.0/24 -ports 443,8443 -mode cert
+  tls 10.0.0.0/16 -from-scan latest
+  ciphers example.com:443
+  ciphers 10.0.0.0/24 -from-scan latest -per-host 4
+  tlsfp 10.0.0.0/16 -from-scan latest
+)";
+}
+
+std::string TlsEngine::getCommandHelp(const std::string& command) const {
+    if (command == "tls") {
+        return "tls <target|host:port> [options] - TLS握手探测，采集证书并缓存会话供后续探测复用";
+    }
+    if (command == "ciphers") {
+        return "ciphers <target|host:port> [options] - 以逐步缩小的候选列表并行探测，枚举协议版本和密码套件";
+    }
+    if (command == "tlsfp") {
+        return "tlsfp <target|host:port> [options] - 同时发送10个ClientHello变体计算服务端指纹，相同指纹即相同的TLS实现和配置";
+    }
+
+    return "";
+}
+
+ExecutionResult TlsEngine::executeTls(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for tls command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::string mode = parameter(context, "mode");
+    if (mode != "full" && mode != "cert") {
+        result.success = false;
+        result.message = "Invalid mode: " + mode + " (expected full or cert)";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (mode == "full" && !tlsAvailable()) {
+        result.success = false;
+        result.message = "Full handshake requires OpenSSL support, use -mode cert";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    const bool certOnly = mode == "cert";
+
+    std::vector<TlsEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的TLS端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    TlsProberConfig config;
+    size_t concurrency;
+    try {
+        config.handshakeTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.handshakeTimeout);
+        concurrency = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    config.maxConnections = concurrency;
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    TlsProber prober(loop, config);
+
+    size_t nextEndpoint = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    uint64_t expired = 0;
+    uint64_t tls13Only = 0;
+    std::string records;
+    const int64_t now = static_cast<int64_t>(std::time(nullptr));
+
+    notifyOutput(context, "TLS探测 " + std::to_string(endpoints.size()) + " 个端点 (" +
+                 (certOnly ? "仅证书" : "完整握手") + ")");
+
+    std::function<void()> pump;
+    auto onResult = [&](size_t index, const TlsProbeResult& probe) {
+        const TlsEndpoint& endpoint = endpoints[index];
+        std::string label = endpoint.ip + ":" + std::to_string(endpoint.port);
+
+        if (!probe.ok() || (certOnly && probe.certificates.empty())) {
+            ++failed;
+            std::string reason = probe.error;
+            // 只支持TLS 1.3的服务端拒绝1.2握手，或协商出1.3 (证书已加密)
+            if (certOnly && probe.connected &&
+                (probe.serverHello.version == TLS_VERSION_1_3 ||
+                 (probe.serverHello.alert && probe.serverHello.alertDescription == 70))) {
+                ++tls13Only;
+                reason = "server requires TLS 1.3, certificate is encrypted (use -mode full)";
+            } else if (reason.empty()) {
+                reason = "no certificate received";
+            }
+            if (endpoints.size() <= 16) {
+                notifyError(context, "TLS探测失败: " + label + " (" + reason + ")");
+            }
+            pump();
+            return;
+        }
+
+        ++succeeded;
+        TlsEndpointResult entry;
+        entry.ip = endpoint.ip;
+        entry.port = endpoint.port;
+        entry.serverName = endpoint.serverName;
+        entry.resumed = probe.resumed;
+        entry.chainLength = probe.certificates.size();
+        entry.elapsed = probe.elapsed;
+        if (certOnly) {
+            entry.version = versionName(probe.serverHello.version);
+            entry.cipher = cipherSuiteName(probe.serverHello.cipherSuite);
+            entry.alpn = probe.serverHello.alpn;
+        } else {
+            entry.version = probe.version;
+            entry.cipher = probe.cipher;
+            entry.alpn = probe.alpn;
+        }
+        if (!probe.certificates.empty()) {
+            entry.certificate = parseCertificate(probe.certificates.front());
+        }
+
+        const CertificateInfo& cert = entry.certificate;
+        bool isExpired = cert.valid && cert.notAfterEpoch > 0 && cert.notAfterEpoch < now;
+        if (isExpired) {
+            ++expired;
+        }
+
+        std::string record = endpointRecord(entry);
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+
+        std::string line = "[" + entry.version + "] " + label + "  " + entry.cipher;
+        if (cert.valid) {
+            line += "  " + (cert.commonName.empty() ? cert.subject : cert.commonName);
+            line += "  " + cert.keyDescription() + "  到期 " + cert.notAfter.substr(0, 10);
+            if (isExpired) {
+                line += " (已过期)";
+            }
+            if (cert.selfSigned) {
+                line += " (自签名)";
+            }
+        }
+        if (entry.resumed) {
+            line += "  [会话复用]";
+        }
+        notifyOutput(context, line);
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextEndpoint < endpoints.size() && prober.outstanding() < concurrency && !m_stopRequested) {
+            size_t index = nextEndpoint++;
+            const TlsEndpoint& endpoint = endpoints[index];
+
+            TlsProbeRequest request;
+            request.address = Utils::IPAddress(endpoint.ip);
+            request.port = static_cast<uint16_t>(endpoint.port);
+            request.serverName = endpoint.serverName;
+            if (certOnly) {
+                request.mode = TlsProbeRequest::Mode::HELLO;
+                request.clientHello = certificateHello(endpoint.serverName);
+                request.stopAt = TlsHandshakeReader::StopAt::CERTIFICATE;
+            } else {
+                request.mode = TlsProbeRequest::Mode::HANDSHAKE;
+                request.alpn = {"h2", "http/1.1"};
+            }
+            prober.submit(std::move(request), [&, index](const TlsProbeRequest&, const TlsProbeResult& probe) {
+                onResult(index, probe);
+            });
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    pump();
+    prober.run(m_stopRequested);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    auto stats = prober.getStats();
+    auto cacheStats = TlsSessionCache::instance().getStats();
+
+    result.success = true;
+    result.message = "TLS探测完成，" + std::to_string(succeeded) + " 个成功, " + std::to_string(failed) + " 个失败";
+    if (expired > 0) {
+        result.message += ", " + std::to_string(expired) + " 个证书已过期";
+    }
+    if (tls13Only > 0) {
+        result.message += ", " + std::to_string(tls13Only) + " 个仅支持TLS 1.3";
+    }
+    if (stats.resumed > 0) {
+        result.message += ", " + std::to_string(stats.resumed) + " 次会话复用";
+    }
+    result.data["handshakes"] = std::to_string(succeeded);
+    result.data["failures"] = std::to_string(failed);
+    result.data["expired"] = std::to_string(expired);
+    result.data["resumed"] = std::to_string(stats.resumed);
+    result.data["sessions_cached"] = std::to_string(cacheStats.sessions);
+    result.data["peak_connections"] = std::to_string(stats.peakConnections);
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+ExecutionResult TlsEngine::executeCiphers(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for ciphers command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<TlsEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的TLS端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    TlsProberConfig config;
+    CipherEnumConfig enumConfig;
+    try {
+        config.handshakeTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.handshakeTimeout);
+        config.maxConnections = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+        enumConfig.perEndpoint = std::max<size_t>(1, std::stoul(parameter(context, "per-host")));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    // 同时枚举的端点数: 让全局连接上限基本用满
+    const size_t parallelEndpoints = std::max<size_t>(1, config.maxConnections / enumConfig.perEndpoint);
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    TlsProber prober(loop, config);
+    CipherEnumerator enumerator(prober, enumConfig);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 多个端点时先采集指纹聚类，相同TLS实现和配置的端点只枚举一个代表
+    std::vector<size_t> representativeOf(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        representativeOf[i] = i;
+    }
+    if (endpoints.size() > 1 && parameter(context, "cluster") != "off") {
+        representativeOf = clusterEndpoints(context, prober, endpoints, config.maxConnections);
+    }
+    std::vector<size_t> representatives;
+    std::vector<std::vector<size_t>> members(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        if (representativeOf[i] == i) {
+            representatives.push_back(i);
+        } else {
+            members[representativeOf[i]].push_back(i);
+        }
+    }
+
+    size_t nextEndpoint = 0;
+    uint64_t succeeded = 0;
+    uint64_t inferred = 0;
+    uint64_t failed = 0;
+    uint64_t weakEndpoints = 0;
+    uint64_t totalProbes = 0;
+    std::string records;
+
+    notifyOutput(context, "TLS套件枚举 " + std::to_string(representatives.size()) + " 个端点");
+
+    std::function<void()> pump;
+    auto onResult = [&](size_t index, const CipherEnumResult& probe) {
+        totalProbes += probe.probes;
+        std::string label = probe.address.toString() + ":" + std::to_string(probe.port);
+
+        if (!probe.ok() || probe.versions.empty()) {
+            ++failed;
+            if (endpoints.size() <= 16) {
+                notifyError(context, "TLS枚举失败: " + label + " (" +
+                            (probe.ok() ? std::string("no TLS version accepted") : probe.error) + ")");
+            }
+            pump();
+            return;
+        }
+
+        ++succeeded;
+        std::string record = cipherRecord(probe);
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+        for (size_t member : members[index]) {
+            CipherEnumResult copy = probe;
+            copy.address = Utils::IPAddress(endpoints[member].ip);
+            copy.port = static_cast<uint16_t>(endpoints[member].port);
+            copy.serverName = endpoints[member].serverName;
+            record = cipherRecord(copy, label);
+            records += record + "\n";
+            if (output.is_open()) {
+                output << record << "\n";
+            }
+            ++inferred;
+        }
+
+        bool weakFound = false;
+        notifyOutput(context, label + "  (" + std::to_string(probe.probes) + " 次探测, " +
+                     std::to_string(probe.elapsed.count()) + "ms" +
+                     (members[index].empty() ? "" : ", +" + std::to_string(members[index].size()) + " 个同指纹端点") +
+                     ")");
+        for (uint16_t version : probe.versions) {
+            const auto& suites = probe.cipherSuites.at(version);
+            notifyOutput(context, "  " + versionName(version) + ": " + std::to_string(suites.size()) + " 个套件");
+            for (uint16_t id : suites) {
+                bool weak = isWeakCipherSuite(id) || version <= TLS_VERSION_1_0;
+                weakFound = weakFound || weak;
+                notifyOutput(context, "    " + cipherSuiteName(id) + (weak ? "  [弱]" : ""));
+            }
+        }
+        if (weakFound) {
+            weakEndpoints += 1 + members[index].size();
+        }
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextEndpoint < representatives.size() && enumerator.active() < parallelEndpoints &&
+               !m_stopRequested) {
+            size_t index = representatives[nextEndpoint++];
+            const TlsEndpoint& endpoint = endpoints[index];
+            enumerator.enumerate(Utils::IPAddress(endpoint.ip), static_cast<uint16_t>(endpoint.port),
+                                 endpoint.serverName,
+                                 [&, index](const CipherEnumResult& probe) { onResult(index, probe); });
+        }
+    };
+
+    pump();
+    prober.run(m_stopRequested);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    result.success = true;
+    result.message = "TLS套件枚举完成，" + std::to_string(succeeded) + " 个端点, " + std::to_string(failed) +
+                     " 个失败, " + std::to_string(totalProbes) + " 次探测";
+    if (inferred > 0) {
+        result.message += ", " + std::to_string(inferred) + " 个端点按相同指纹推断";
+    }
+    if (weakEndpoints > 0) {
+        result.message += ", " + std::to_string(weakEndpoints) + " 个端点支持弱协议或弱套件";
+    }
+    result.data["endpoints"] = std::to_string(succeeded);
+    result.data["failures"] = std::to_string(failed);
+    result.data["inferred"] = std::to_string(inferred);
+    result.data["weak_endpoints"] = std::to_string(weakEndpoints);
+    result.data["probes"] = std::to_string(totalProbes);
+    result.data["peak_connections"] = std::to_string(prober.getStats().peakConnections);
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+ExecutionResult TlsEngine::executeFingerprint(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for tlsfp command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<TlsEndpoint> endpoints;
+    std::string error;
+    if (!collectEndpoints(context, endpoints, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的TLS端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    TlsProberConfig config;
+    try {
+        config.handshakeTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.handshakeTimeout);
+        config.maxConnections = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    // 每个端点同时占用全部变体的连接
+    const size_t parallelEndpoints = std::max<size_t>(1, config.maxConnections / TlsFingerprinter::VARIANT_COUNT);
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    TlsProber prober(loop, config);
+    TlsFingerprinter fingerprinter(prober);
+
+    size_t nextEndpoint = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    std::map<std::string, uint64_t> clusters;
+    std::string records;
+
+    notifyOutput(context, "TLS指纹 " + std::to_string(endpoints.size()) + " 个端点");
+
+    std::function<void()> pump;
+    auto onResult = [&](const TlsFingerprintResult& probe) {
+        std::string label = probe.address.toString() + ":" + std::to_string(probe.port);
+
+        if (!probe.ok() || probe.responses == 0) {
+            ++failed;
+            if (endpoints.size() <= 16) {
+                notifyError(context, "TLS指纹失败: " + label + " (" +
+                            (probe.ok() ? std::string("no ServerHello received") : probe.error) + ")");
+            }
+            pump();
+            return;
+        }
+
+        ++succeeded;
+        ++clusters[probe.fingerprint];
+        std::string record = fingerprintRecord(probe);
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+        notifyOutput(context, label + "  " + probe.fingerprint);
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextEndpoint < endpoints.size() && fingerprinter.active() < parallelEndpoints && !m_stopRequested) {
+            const TlsEndpoint& endpoint = endpoints[nextEndpoint++];
+            fingerprinter.fingerprint(Utils::IPAddress(endpoint.ip), static_cast<uint16_t>(endpoint.port),
+                                      endpoint.serverName, onResult);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    pump();
+    prober.run(m_stopRequested);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    // 按端点数从多到少列出指纹簇
+    std::vector<std::pair<std::string, uint64_t>> ranked(clusters.begin(), clusters.end());
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (!ranked.empty()) {
+        notifyOutput(context, "指纹聚类:");
+        for (const auto& cluster : ranked) {
+            notifyOutput(context, "  " + cluster.first + "  " + std::to_string(cluster.second) + " 个端点");
+        }
+    }
+
+    result.success = true;
+    result.message = "TLS指纹完成，" + std::to_string(succeeded) + " 个端点, " + std::to_string(failed) +
+                     " 个失败, " + std::to_string(clusters.size()) + " 种不同指纹";
+    result.data["fingerprinted"] = std::to_string(succeeded);
+    result.data["failures"] = std::to_string(failed);
+    result.data["clusters"] = std::to_string(clusters.size());
+    result.data["peak_connections"] = std::to_string(prober.getStats().peakConnections);
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+std::vector<size_t> TlsEngine::clusterEndpoints(const CommandContext& context, TlsProber& prober,
+                                                const std::vector<TlsEndpoint>& endpoints, size_t maxConnections) {
+    std::vector<size_t> representativeOf(endpoints.size());
+    std::vector<std::vector<std::string>> features(endpoints.size());
+    TlsFingerprinter fingerprinter(prober);
+    const size_t parallelEndpoints = std::max<size_t>(1, maxConnections / TlsFingerprinter::VARIANT_COUNT);
+
+    // 指纹的每个变体编码和扩展哈希作为特征，没有任何应答的端点单独成簇
+    size_t next = 0;
+    std::function<void()> pump = [&]() {
+        while (next < endpoints.size() && fingerprinter.active() < parallelEndpoints && !m_stopRequested) {
+            size_t index = next++;
+            const TlsEndpoint& endpoint = endpoints[index];
+            fingerprinter.fingerprint(Utils::IPAddress(endpoint.ip), static_cast<uint16_t>(endpoint.port),
+                                      endpoint.serverName, [&, index](const TlsFingerprintResult& probe) {
+                if (probe.ok() && probe.responses > 0) {
+                    const std::string& fp = probe.fingerprint;
+                    for (size_t variant = 0; variant < TlsFingerprinter::VARIANT_COUNT; ++variant) {
+                        features[index].push_back("fp" + std::to_string(variant) + ":" + fp.substr(variant * 3, 3));
+                    }
+                    features[index].push_back("fpext:" + fp.substr(TlsFingerprinter::VARIANT_COUNT * 3));
+                }
+                pump();
+            });
+        }
+    };
+    pump();
+    prober.run(m_stopRequested);
+
+    // 套件结果只能在完全相同的指纹之间传播
+    Utils::HostClusterIndex index(1.0);
+    std::vector<size_t> representativeOfCluster;
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        bool created = false;
+        size_t cluster = index.add(features[i], created);
+        if (created) {
+            representativeOfCluster.push_back(i);
+        }
+        representativeOf[i] = representativeOfCluster[cluster];
+    }
+
+    notifyOutput(context, "TLS指纹聚类: " + std::to_string(endpoints.size()) + " 个端点归为 " +
+                 std::to_string(index.clusterCount()) + " 个簇");
+    return representativeOf;
+}
+
+bool TlsEngine::collectEndpoints(const CommandContext& context, std::vector<TlsEndpoint>& endpoints,
+                                 std::string& error) {
+    std::string target = context.target;
+    std::string sni = parameter(context, "sni");
+    int explicitPort = 0;
+
+    // host:port 或 [IPv6]:port
+    size_t colonPos = target.rfind(':');
+    size_t bracketPos = target.rfind(']');
+    if (colonPos != std::string::npos && target.find_first_of(",/") == std::string::npos &&
+        (bracketPos != std::string::npos ? colonPos > bracketPos : target.find(':') == colonPos)) {
+        try {
+            explicitPort = std::stoi(target.substr(colonPos + 1));
+        } catch (const std::exception&) {
+            error = "Invalid port in target: " + target;
+            return false;
+        }
+        if (explicitPort <= 0 || explicitPort > 65535) {
+            error = "Invalid port in target: " + target;
+            return false;
+        }
+        target = target.substr(0, colonPos);
+        if (target.size() > 2 && target.front() == '[' && target.back() == ']') {
+            target = target.substr(1, target.size() - 2);
+        }
+    }
+    if (sni.empty() && isHostName(target)) {
+        sni = target;
+    }
+
+    Utils::TargetSpace space;
+    if (!space.addTargets(target)) {
+        error = "Invalid target format";
+        return false;
+    }
+
+    // -from-scan: 终端从结果库注入端口扫描结果，只取落在目标范围内的TLS端口
+    if (context.parameters.count("from-scan")) {
+        auto baselineParam = context.parameters.find("baseline");
+        if (baselineParam == context.parameters.end()) {
+            error = "No scan result found for from-scan " + context.parameters.at("from-scan");
+            return false;
+        }
+
+        Network::ScanBaseline scan;
+        scan.parse(baselineParam->second);
+        for (const auto& entry : scan.entries()) {
+            if (!space.containsHost(Utils::IPAddress(entry.ip)) || !isTlsService(entry.port, entry.service)) {
+                continue;
+            }
+            TlsEndpoint endpoint;
+            endpoint.ip = entry.ip;
+            endpoint.port = entry.port;
+            endpoint.serverName = sni;
+            endpoints.push_back(endpoint);
+        }
+        return true;
+    }
+
+    std::vector<int> ports = DEFAULT_TLS_PORTS;
+    std::string portSpec = parameter(context, "ports");
+    if (explicitPort != 0) {
+        ports = {explicitPort};
+    } else if (!portSpec.empty()) {
+        ports.clear();
+        for (const auto& range : Utils::NetworkUtils::parsePortRange(portSpec)) {
+            auto values = range.toVector();
+            ports.insert(ports.end(), values.begin(), values.end());
+        }
+        if (ports.empty()) {
+            error = "No valid ports to probe";
+            return false;
+        }
+    }
+
+    for (uint64_t host = 0; host < space.hostCount(); ++host) {
+        std::string ip = space.hostAt(host).toString();
+        for (int port : ports) {
+            TlsEndpoint endpoint;
+            endpoint.ip = ip;
+            endpoint.port = port;
+            endpoint.serverName = sni;
+            endpoints.push_back(endpoint);
+        }
+    }
+    return true;
+}
+
+bool TlsEngine::isTlsService(int port, const std::string& service) {
+    if (service.find("ssl") != std::string::npos || service.find("tls") != std::string::npos ||
+        service == "https" || service == "imaps" || service == "pop3s" || service == "smtps" ||
+        service == "ldaps" || service == "ftps") {
+        return true;
+    }
+    return std::find(DEFAULT_TLS_PORTS.begin(), DEFAULT_TLS_PORTS.end(), port) != DEFAULT_TLS_PORTS.end();
+}
+
+std::string TlsEngine::parameter(const CommandContext& context, const std::string& key) const {
+    auto it = context.parameters.find(key);
+    if (it != context.parameters.end()) {
+        return it->second;
+    }
+    return getOption(key);
+}
+
+} // namespace MindSploit::Tls
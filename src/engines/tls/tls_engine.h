@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../engine_interface.h"
+#include "x509_info.h"
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace MindSploit::Tls {
+
+class TlsProber;
+
+// 一个待探测的TLS端点
+struct TlsEndpoint {
+    std::string ip;
+    int port = 443;
+    std::string serverName;     // SNI，为空时不发送
+};
+
+// 单个端点的探测结果
+struct TlsEndpointResult {
+    std::string ip;
+    int port = 0;
+    std::string serverName;
+    std::string version;
+    std::string cipher;
+    std::string alpn;
+    bool resumed = false;
+    CertificateInfo certificate;
+    size_t chainLength = 0;
+    std::chrono::milliseconds elapsed{0};
+};
+
+// TLS探测引擎: 并发握手、证书采集、会话缓存、协议版本和套件枚举、服务端指纹
+class TlsEngine : public EngineInterface {
+public:
+    static constexpr const char* ENGINE_NAME = "TlsEngine";
+
+    TlsEngine();
+    virtual ~TlsEngine();
+
+    // 基础接口实现
+    bool initialize() override;
+    bool shutdown() override;
+    ExecutionResult execute(const CommandContext& context) override;
+    void stop() override;
+
+    EngineStatus getStatus() const override;
+    std::string getName() const override { return "TlsEngine"; }
+    std::string getVersion() const override { return "2.0.0"; }
+    std::string getDescription() const override;
+
+    std::vector<std::string> getSupportedCommands() const override;
+    std::map<std::string, std::string> getRequiredParameters(const std::string& command) const override;
+    std::map<std::string, std::string> getOptionalParameters(const std::string& command) const override;
+
+    bool setOption(const std::string& key, const std::string& value) override;
+    std::string getOption(const std::string& key) const override;
+    std::map<std::string, std::string> getAllOptions() const override;
+
+    bool checkDependencies() const override;
+    std::vector<std::string> getMissingDependencies() const override;
+
+    std::string getHelp() const override;
+    std::string getCommandHelp(const std::string& command) const override;
+
+    // 端口扫描结果中可能是TLS的服务
+    static bool isTlsService(int port, const std::string& service);
+
+private:
+    ExecutionResult executeTls(const CommandContext& context);
+    ExecutionResult executeCiphers(const CommandContext& context);
+    ExecutionResult executeFingerprint(const CommandContext& context);
+
+    // 按TLS指纹聚类，返回每个端点所属簇的代表端点下标
+    std::vector<size_t> clusterEndpoints(const CommandContext& context, TlsProber& prober,
+                                         const std::vector<TlsEndpoint>& endpoints, size_t maxConnections);
+
+    // 端点收集: host:port、目标×端口，或 -from-scan 的开放TLS端口
+    bool collectEndpoints(const CommandContext& context, std::vector<TlsEndpoint>& endpoints,
+                          std::string& error);
+    std::string parameter(const CommandContext& context, const std::string& key) const;
+
+private:
+    std::atomic<EngineStatus> m_status{EngineStatus::IDLE};
+    std::atomic<bool> m_stopRequested{false};
+    std::map<std::string, std::string> m_options;
+
+    static const std::vector<int> DEFAULT_TLS_PORTS;
+};
+
+} // namespace MindSploit::Tls
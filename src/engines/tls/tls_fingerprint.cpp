@@ -0,0 +1,216 @@
+#include "tls_fingerprint.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace MindSploit::Tls {
+
+namespace {
+
+enum class Order {
+    FORWARD,
+    REVERSE,
+    TOP_HALF,
+    BOTTOM_HALF,
+    MIDDLE_OUT
+};
+
+// 变体定义: 版本范围、套件顺序、ALPN和扩展顺序
+struct Variant {
+    bool offerTls13;
+    uint16_t legacyVersion;
+    Order order;
+    int alpn;               // 0=无 1=常见 2=少见
+    bool grease;
+    bool reverseExtensions;
+};
+
+constexpr Variant VARIANTS[TlsFingerprinter::VARIANT_COUNT] = {
+    {false, TLS_VERSION_1_2, Order::FORWARD,     1, false, false},
+    {false, TLS_VERSION_1_2, Order::REVERSE,     1, false, false},
+    {false, TLS_VERSION_1_2, Order::TOP_HALF,    1, false, false},
+    {false, TLS_VERSION_1_2, Order::BOTTOM_HALF, 2, false, true},
+    {false, TLS_VERSION_1_2, Order::MIDDLE_OUT,  1, true,  false},
+    {false, TLS_VERSION_1_1, Order::FORWARD,     0, false, false},
+    {true,  TLS_VERSION_1_2, Order::FORWARD,     1, false, false},
+    {true,  TLS_VERSION_1_2, Order::REVERSE,     1, false, false},
+    {true,  TLS_VERSION_1_2, Order::FORWARD,     2, false, false},
+    {true,  TLS_VERSION_1_2, Order::MIDDLE_OUT,  1, true,  true},
+};
+
+std::vector<uint16_t> orderSuites(std::vector<uint16_t> suites, Order order) {
+    switch (order) {
+        case Order::FORWARD:
+            return suites;
+        case Order::REVERSE:
+            std::reverse(suites.begin(), suites.end());
+            return suites;
+        case Order::TOP_HALF:
+            suites.resize(suites.size() / 2);
+            return suites;
+        case Order::BOTTOM_HALF:
+            suites.erase(suites.begin(), suites.begin() + static_cast<std::ptrdiff_t>(suites.size() / 2));
+            return suites;
+        case Order::MIDDLE_OUT: {
+            // 从中间开始向两侧交替取
+            std::vector<uint16_t> ordered;
+            ordered.reserve(suites.size());
+            size_t middle = suites.size() / 2;
+            ordered.push_back(suites[middle]);
+            for (size_t step = 1; ordered.size() < suites.size(); ++step) {
+                if (middle + step < suites.size()) {
+                    ordered.push_back(suites[middle + step]);
+                }
+                if (step <= middle) {
+                    ordered.push_back(suites[middle - step]);
+                }
+            }
+            return ordered;
+        }
+    }
+    return suites;
+}
+
+uint64_t fnv1a(const std::string& data, uint64_t hash) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+TlsFingerprinter::TlsFingerprinter(TlsProber& prober) : m_prober(prober) {}
+
+void TlsFingerprinter::fingerprint(const Utils::IPAddress& address, uint16_t port, const std::string& serverName,
+                                   Callback callback) {
+    auto job = std::make_shared<Job>();
+    job->result.address = address;
+    job->result.port = port;
+    job->result.serverName = serverName;
+    job->callback = std::move(callback);
+    job->started = Clock::now();
+    job->responses.resize(VARIANT_COUNT);
+    job->remaining = VARIANT_COUNT;
+    ++m_active;
+
+    // 全部变体同时发出，端点的指纹耗时约为一次往返
+    for (size_t i = 0; i < VARIANT_COUNT; ++i) {
+        TlsProbeRequest request;
+        request.address = address;
+        request.port = port;
+        request.serverName = serverName;
+        request.mode = TlsProbeRequest::Mode::HELLO;
+        request.clientHello = buildVariant(i, serverName);
+        request.stopAt = TlsHandshakeReader::StopAt::SERVER_HELLO;
+        m_prober.submit(std::move(request), [this, job, i](const TlsProbeRequest&, const TlsProbeResult& probe) {
+            onResult(job, i, probe);
+        });
+    }
+}
+
+void TlsFingerprinter::onResult(const std::shared_ptr<Job>& job, size_t index, const TlsProbeResult& probe) {
+    if (probe.connected) {
+        ++job->connected;
+    } else if (job->result.error.empty()) {
+        job->result.error = probe.error;
+    }
+    if (probe.serverHello.received) {
+        job->responses[index] = probe.serverHello;
+        ++job->result.responses;
+    }
+    if (--job->remaining > 0) {
+        return;
+    }
+
+    TlsFingerprintResult& result = job->result;
+    if (job->connected > 0) {
+        result.error.clear();
+        result.fingerprint = compute(job->responses);
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - job->started);
+
+    --m_active;
+    if (job->callback) {
+        job->callback(result);
+    }
+}
+
+std::string TlsFingerprinter::buildVariant(size_t index, const std::string& serverName) {
+    const Variant& variant = VARIANTS[index % VARIANT_COUNT];
+
+    std::vector<uint16_t> suites;
+    for (const auto& suite : knownCipherSuites()) {
+        if (variant.offerTls13 || !isTls13CipherSuite(suite.id)) {
+            suites.push_back(suite.id);
+        }
+    }
+
+    ClientHelloSpec spec;
+    spec.serverName = serverName;
+    spec.legacyVersion = variant.legacyVersion;
+    spec.cipherSuites = orderSuites(std::move(suites), variant.order);
+    if (variant.offerTls13) {
+        spec.supportedVersions = {TLS_VERSION_1_3, TLS_VERSION_1_2, TLS_VERSION_1_1, TLS_VERSION_1_0};
+    }
+    if (variant.alpn == 1) {
+        spec.alpn = {"h2", "http/1.1"};
+    } else if (variant.alpn == 2) {
+        spec.alpn = {"http/0.9", "http/1.0", "spdy/3", "h2c"};
+    }
+    spec.grease = variant.grease;
+    spec.reverseExtensions = variant.reverseExtensions;
+    return buildClientHello(spec);
+}
+
+std::string TlsFingerprinter::compute(const std::vector<ServerHelloInfo>& responses) {
+    const auto& table = knownCipherSuites();
+    std::string choices;
+    std::string extensions;
+    bool any = false;
+
+    for (const auto& hello : responses) {
+        if (!hello.received) {
+            choices += "000";
+            extensions += "|";
+            continue;
+        }
+        any = true;
+
+        size_t position = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (table[i].id == hello.cipherSuite) {
+                position = i + 1;
+                break;
+            }
+        }
+        char code[8];
+        std::snprintf(code, sizeof(code), "%02x", position == 0 || position > 0xff ? 0xff : static_cast<unsigned>(position));
+        choices += code;
+        int version = hello.version >= SSL_VERSION_3_0 && hello.version <= TLS_VERSION_1_3
+                          ? hello.version - SSL_VERSION_3_0 : 15;
+        choices += static_cast<char>(version == 15 ? 'f' : 'a' + version);
+
+        extensions += hello.alpn + "-";
+        for (size_t i = 0; i < hello.extensions.size(); ++i) {
+            extensions += (i > 0 ? "." : "") + std::to_string(hello.extensions[i]);
+        }
+        if (hello.helloRetryRequest) {
+            extensions += "-hrr";
+        }
+        extensions += "|";
+    }
+
+    if (!any) {
+        return std::string(FINGERPRINT_LENGTH, '0');
+    }
+
+    // 两个不同初值的FNV-1a拼成128位
+    char digest[40];
+    std::snprintf(digest, sizeof(digest), "%016llx%016llx",
+                  static_cast<unsigned long long>(fnv1a(extensions, 0xcbf29ce484222325ULL)),
+                  static_cast<unsigned long long>(fnv1a(extensions, 0x84222325cbf29ce4ULL)));
+    return choices + digest;
+}
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "tls_prober.h"
+
+namespace MindSploit::Tls {
+
+// 单个端点的指纹
+struct TlsFingerprintResult {
+    Utils::IPAddress address;
+    uint16_t port = 0;
+    std::string serverName;
+    std::string fingerprint;                    // 62位十六进制，全零表示没有任何应答
+    size_t responses = 0;                       // 收到ServerHello的变体数
+    std::string error;                          // 端点不可达
+    std::chrono::milliseconds elapsed{0};
+
+    bool ok() const { return error.empty(); }
+};
+
+// JARM风格的主动TLS服务端指纹
+//
+// 向端点同时发送一组固定的ClientHello变体 (版本、套件顺序、ALPN、扩展顺序各不相同)，
+// 记录服务端对每个变体选择的版本和套件以及ServerHello的扩展列表:
+//   - 前30位: 每个变体3位，2位为套件在已知套件表中的序号，1位为协商版本 (a=SSLv3 ... e=TLS1.3)，
+//     没有应答为000
+//   - 后32位: 全部变体的ALPN和扩展列表的128位哈希
+// 相同的TLS实现和配置得到相同的指纹，可用于在大量资产中聚类而无需逐个做服务识别。
+// 变体集合和编码与JARM不同，指纹不能与JARM数据库互相比较。
+class TlsFingerprinter {
+public:
+    using Callback = std::function<void(const TlsFingerprintResult& result)>;
+
+    static constexpr size_t VARIANT_COUNT = 10;
+    static constexpr size_t FINGERPRINT_LENGTH = 62;
+
+    explicit TlsFingerprinter(TlsProber& prober);
+
+    TlsFingerprinter(const TlsFingerprinter&) = delete;
+    TlsFingerprinter& operator=(const TlsFingerprinter&) = delete;
+
+    void fingerprint(const Utils::IPAddress& address, uint16_t port, const std::string& serverName,
+                     Callback callback);
+    // 进行中的端点数
+    size_t active() const { return m_active; }
+
+    // 第index个变体的ClientHello
+    static std::string buildVariant(size_t index, const std::string& serverName);
+    // 按变体顺序排列的应答 (未应答的received为false) 计算指纹
+    static std::string compute(const std::vector<ServerHelloInfo>& responses);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        TlsFingerprintResult result;
+        Callback callback;
+        Clock::time_point started;
+        std::vector<ServerHelloInfo> responses;
+        size_t remaining = 0;
+        size_t connected = 0;
+    };
+
+    void onResult(const std::shared_ptr<Job>& job, size_t index, const TlsProbeResult& probe);
+
+private:
+    TlsProber& m_prober;
+    size_t m_active = 0;
+};
+
+} // namespace MindSploit::Tls
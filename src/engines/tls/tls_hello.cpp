@@ -0,0 +1,598 @@
+#include "tls_hello.h"
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace MindSploit::Tls {
+
+namespace {
+
+constexpr uint8_t RECORD_CHANGE_CIPHER_SPEC = 20;
+constexpr uint8_t RECORD_ALERT = 21;
+constexpr uint8_t RECORD_HANDSHAKE = 22;
+constexpr uint8_t RECORD_APPLICATION_DATA = 23;
+
+constexpr uint8_t HANDSHAKE_CLIENT_HELLO = 1;
+constexpr uint8_t HANDSHAKE_SERVER_HELLO = 2;
+constexpr uint8_t HANDSHAKE_CERTIFICATE = 11;
+constexpr uint8_t HANDSHAKE_SERVER_HELLO_DONE = 14;
+
+// 单条记录的最大长度 (2^14 + 扩展余量)
+constexpr size_t MAX_RECORD_LENGTH = 18432;
+// 证书链等握手消息的上限
+constexpr size_t MAX_HANDSHAKE_LENGTH = 256 * 1024;
+
+// SHA-256("HelloRetryRequest")，TLS 1.3用它作为HelloRetryRequest的random
+const uint8_t HELLO_RETRY_RANDOM[32] = {
+    0xcf, 0x21, 0xad, 0x74, 0xe5, 0x9a, 0x61, 0x11, 0xbe, 0x1d, 0x8c, 0x02, 0x1e, 0x65, 0xb8, 0x91,
+    0xc2, 0xa2, 0x11, 0x16, 0x7a, 0xbb, 0x8c, 0x5e, 0x07, 0x9e, 0x09, 0xe2, 0xc8, 0xa8, 0x33, 0x9c
+};
+
+const std::vector<CipherSuite> CIPHER_SUITES = {
+    // TLS 1.3
+    {0x1301, "TLS_AES_128_GCM_SHA256"},
+    {0x1302, "TLS_AES_256_GCM_SHA384"},
+    {0x1303, "TLS_CHACHA20_POLY1305_SHA256"},
+    {0x1304, "TLS_AES_128_CCM_SHA256"},
+    {0x1305, "TLS_AES_128_CCM_8_SHA256"},
+    // ECDHE
+    {0xc02b, "TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256"},
+    {0xc02c, "TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384"},
+    {0xc02f, "TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256"},
+    {0xc030, "TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384"},
+    {0xcca8, "TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256"},
+    {0xcca9, "TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256"},
+    {0xc023, "TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256"},
+    {0xc024, "TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA384"},
+    {0xc027, "TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256"},
+    {0xc028, "TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA384"},
+    {0xc009, "TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA"},
+    {0xc00a, "TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA"},
+    {0xc013, "TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA"},
+    {0xc014, "TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA"},
+    {0xc0ac, "TLS_ECDHE_ECDSA_WITH_AES_128_CCM"},
+    {0xc0ad, "TLS_ECDHE_ECDSA_WITH_AES_256_CCM"},
+    {0xc0ae, "TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8"},
+    {0xc0af, "TLS_ECDHE_ECDSA_WITH_AES_256_CCM_8"},
+    {0xc072, "TLS_ECDHE_ECDSA_WITH_CAMELLIA_128_CBC_SHA256"},
+    {0xc073, "TLS_ECDHE_ECDSA_WITH_CAMELLIA_256_CBC_SHA384"},
+    {0xc076, "TLS_ECDHE_RSA_WITH_CAMELLIA_128_CBC_SHA256"},
+    {0xc077, "TLS_ECDHE_RSA_WITH_CAMELLIA_256_CBC_SHA384"},
+    {0xc05c, "TLS_ECDHE_ECDSA_WITH_ARIA_128_GCM_SHA256"},
+    {0xc05d, "TLS_ECDHE_ECDSA_WITH_ARIA_256_GCM_SHA384"},
+    {0xc060, "TLS_ECDHE_RSA_WITH_ARIA_128_GCM_SHA256"},
+    {0xc061, "TLS_ECDHE_RSA_WITH_ARIA_256_GCM_SHA384"},
+    {0xc008, "TLS_ECDHE_ECDSA_WITH_3DES_EDE_CBC_SHA"},
+    {0xc012, "TLS_ECDHE_RSA_WITH_3DES_EDE_CBC_SHA"},
+    {0xc007, "TLS_ECDHE_ECDSA_WITH_RC4_128_SHA"},
+    {0xc011, "TLS_ECDHE_RSA_WITH_RC4_128_SHA"},
+    {0xc006, "TLS_ECDHE_ECDSA_WITH_NULL_SHA"},
+    {0xc010, "TLS_ECDHE_RSA_WITH_NULL_SHA"},
+    // DHE
+    {0x009e, "TLS_DHE_RSA_WITH_AES_128_GCM_SHA256"},
+    {0x009f, "TLS_DHE_RSA_WITH_AES_256_GCM_SHA384"},
+    {0xccaa, "TLS_DHE_RSA_WITH_CHACHA20_POLY1305_SHA256"},
+    {0x0067, "TLS_DHE_RSA_WITH_AES_128_CBC_SHA256"},
+    {0x006b, "TLS_DHE_RSA_WITH_AES_256_CBC_SHA256"},
+    {0x0033, "TLS_DHE_RSA_WITH_AES_128_CBC_SHA"},
+    {0x0039, "TLS_DHE_RSA_WITH_AES_256_CBC_SHA"},
+    {0xc09e, "TLS_DHE_RSA_WITH_AES_128_CCM"},
+    {0xc09f, "TLS_DHE_RSA_WITH_AES_256_CCM"},
+    {0x0045, "TLS_DHE_RSA_WITH_CAMELLIA_128_CBC_SHA"},
+    {0x0088, "TLS_DHE_RSA_WITH_CAMELLIA_256_CBC_SHA"},
+    {0x009a, "TLS_DHE_RSA_WITH_SEED_CBC_SHA"},
+    {0x0016, "TLS_DHE_RSA_WITH_3DES_EDE_CBC_SHA"},
+    {0x0015, "TLS_DHE_RSA_WITH_DES_CBC_SHA"},
+    {0x0014, "TLS_DHE_RSA_EXPORT_WITH_DES40_CBC_SHA"},
+    {0x00a2, "TLS_DHE_DSS_WITH_AES_128_GCM_SHA256"},
+    {0x00a3, "TLS_DHE_DSS_WITH_AES_256_GCM_SHA384"},
+    {0x0040, "TLS_DHE_DSS_WITH_AES_128_CBC_SHA256"},
+    {0x006a, "TLS_DHE_DSS_WITH_AES_256_CBC_SHA256"},
+    {0x0032, "TLS_DHE_DSS_WITH_AES_128_CBC_SHA"},
+    {0x0038, "TLS_DHE_DSS_WITH_AES_256_CBC_SHA"},
+    {0x0013, "TLS_DHE_DSS_WITH_3DES_EDE_CBC_SHA"},
+    {0x0012, "TLS_DHE_DSS_WITH_DES_CBC_SHA"},
+    {0x0011, "TLS_DHE_DSS_EXPORT_WITH_DES40_CBC_SHA"},
+    // 静态ECDH
+    {0xc02d, "TLS_ECDH_ECDSA_WITH_AES_128_GCM_SHA256"},
+    {0xc02e, "TLS_ECDH_ECDSA_WITH_AES_256_GCM_SHA384"},
+    {0xc031, "TLS_ECDH_RSA_WITH_AES_128_GCM_SHA256"},
+    {0xc032, "TLS_ECDH_RSA_WITH_AES_256_GCM_SHA384"},
+    {0xc004, "TLS_ECDH_ECDSA_WITH_AES_128_CBC_SHA"},
+    {0xc005, "TLS_ECDH_ECDSA_WITH_AES_256_CBC_SHA"},
+    {0xc00e, "TLS_ECDH_RSA_WITH_AES_128_CBC_SHA"},
+    {0xc00f, "TLS_ECDH_RSA_WITH_AES_256_CBC_SHA"},
+    // RSA密钥交换
+    {0x009c, "TLS_RSA_WITH_AES_128_GCM_SHA256"},
+    {0x009d, "TLS_RSA_WITH_AES_256_GCM_SHA384"},
+    {0x003c, "TLS_RSA_WITH_AES_128_CBC_SHA256"},
+    {0x003d, "TLS_RSA_WITH_AES_256_CBC_SHA256"},
+    {0x002f, "TLS_RSA_WITH_AES_128_CBC_SHA"},
+    {0x0035, "TLS_RSA_WITH_AES_256_CBC_SHA"},
+    {0xc09c, "TLS_RSA_WITH_AES_128_CCM"},
+    {0xc09d, "TLS_RSA_WITH_AES_256_CCM"},
+    {0x0041, "TLS_RSA_WITH_CAMELLIA_128_CBC_SHA"},
+    {0x0084, "TLS_RSA_WITH_CAMELLIA_256_CBC_SHA"},
+    {0x0096, "TLS_RSA_WITH_SEED_CBC_SHA"},
+    {0x0007, "TLS_RSA_WITH_IDEA_CBC_SHA"},
+    {0x000a, "TLS_RSA_WITH_3DES_EDE_CBC_SHA"},
+    {0x0009, "TLS_RSA_WITH_DES_CBC_SHA"},
+    {0x0005, "TLS_RSA_WITH_RC4_128_SHA"},
+    {0x0004, "TLS_RSA_WITH_RC4_128_MD5"},
+    {0x0062, "TLS_RSA_EXPORT1024_WITH_DES_CBC_SHA"},
+    {0x0064, "TLS_RSA_EXPORT1024_WITH_RC4_56_SHA"},
+    {0x0008, "TLS_RSA_EXPORT_WITH_DES40_CBC_SHA"},
+    {0x0006, "TLS_RSA_EXPORT_WITH_RC2_CBC_40_MD5"},
+    {0x0003, "TLS_RSA_EXPORT_WITH_RC4_40_MD5"},
+    {0x003b, "TLS_RSA_WITH_NULL_SHA256"},
+    {0x0002, "TLS_RSA_WITH_NULL_SHA"},
+    {0x0001, "TLS_RSA_WITH_NULL_MD5"},
+    // 匿名
+    {0x00a6, "TLS_DH_anon_WITH_AES_128_GCM_SHA256"},
+    {0x00a7, "TLS_DH_anon_WITH_AES_256_GCM_SHA384"},
+    {0x0034, "TLS_DH_anon_WITH_AES_128_CBC_SHA"},
+    {0x003a, "TLS_DH_anon_WITH_AES_256_CBC_SHA"},
+    {0x001b, "TLS_DH_anon_WITH_3DES_EDE_CBC_SHA"},
+    {0x0018, "TLS_DH_anon_WITH_RC4_128_MD5"},
+    {0xc018, "TLS_ECDH_anon_WITH_AES_128_CBC_SHA"},
+    {0xc019, "TLS_ECDH_anon_WITH_AES_256_CBC_SHA"},
+    {0xc017, "TLS_ECDH_anon_WITH_3DES_EDE_CBC_SHA"},
+    {0xc016, "TLS_ECDH_anon_WITH_RC4_128_SHA"},
+    {0xc015, "TLS_ECDH_anon_WITH_NULL_SHA"},
+    // PSK / SRP
+    {0x00a8, "TLS_PSK_WITH_AES_128_GCM_SHA256"},
+    {0x00a9, "TLS_PSK_WITH_AES_256_GCM_SHA384"},
+    {0x008c, "TLS_PSK_WITH_AES_128_CBC_SHA"},
+    {0x008d, "TLS_PSK_WITH_AES_256_CBC_SHA"},
+    {0xc01d, "TLS_SRP_SHA_WITH_AES_128_CBC_SHA"},
+    {0xc020, "TLS_SRP_SHA_WITH_AES_256_CBC_SHA"},
+};
+
+const std::unordered_map<uint16_t, const char*>& cipherIndex() {
+    static const std::unordered_map<uint16_t, const char*> index = [] {
+        std::unordered_map<uint16_t, const char*> map;
+        for (const auto& suite : CIPHER_SUITES) {
+            map[suite.id] = suite.name;
+        }
+        return map;
+    }();
+    return index;
+}
+
+std::mt19937_64& randomEngine() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+void appendRandom(std::string& out, size_t count) {
+    auto& engine = randomEngine();
+    for (size_t i = 0; i < count; ++i) {
+        out += static_cast<char>(engine() & 0xff);
+    }
+}
+
+uint16_t greaseValue() {
+    // 0x0a0a, 0x1a1a, ... 0xfafa
+    uint16_t nibble = static_cast<uint16_t>(randomEngine()() % 16);
+    return static_cast<uint16_t>((nibble << 12) | 0x0a00 | (nibble << 4) | 0x0a);
+}
+
+void put8(std::string& out, uint8_t value) {
+    out += static_cast<char>(value);
+}
+
+void put16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value & 0xff);
+}
+
+void put24(std::string& out, uint32_t value) {
+    out += static_cast<char>((value >> 16) & 0xff);
+    out += static_cast<char>((value >> 8) & 0xff);
+    out += static_cast<char>(value & 0xff);
+}
+
+uint16_t get16(const char* p) {
+    return static_cast<uint16_t>((static_cast<uint8_t>(p[0]) << 8) | static_cast<uint8_t>(p[1]));
+}
+
+uint32_t get24(const char* p) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) | static_cast<uint8_t>(p[2]);
+}
+
+void appendExtension(std::vector<std::pair<uint16_t, std::string>>& extensions, uint16_t type, std::string data) {
+    extensions.emplace_back(type, std::move(data));
+}
+
+bool isIpLiteral(const std::string& name) {
+    return name.find_first_not_of("0123456789.") == std::string::npos || name.find(':') != std::string::npos;
+}
+
+} // namespace
+
+const std::vector<CipherSuite>& knownCipherSuites() {
+    return CIPHER_SUITES;
+}
+
+std::string cipherSuiteName(uint16_t id) {
+    auto it = cipherIndex().find(id);
+    if (it != cipherIndex().end()) {
+        return it->second;
+    }
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "0x%04x", id);
+    return buffer;
+}
+
+bool isTls13CipherSuite(uint16_t id) {
+    return id >= 0x1301 && id <= 0x1305;
+}
+
+bool isWeakCipherSuite(uint16_t id) {
+    std::string name = cipherSuiteName(id);
+    for (const char* marker : {"RC4", "DES", "EXPORT", "NULL", "anon", "MD5", "RC2", "IDEA"}) {
+        if (name.find(marker) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string versionName(uint16_t version) {
+    switch (version) {
+        case SSL_VERSION_3_0: return "SSLv3";
+        case TLS_VERSION_1_0: return "TLSv1.0";
+        case TLS_VERSION_1_1: return "TLSv1.1";
+        case TLS_VERSION_1_2: return "TLSv1.2";
+        case TLS_VERSION_1_3: return "TLSv1.3";
+        default: {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "0x%04x", version);
+            return buffer;
+        }
+    }
+}
+
+std::string alertName(uint8_t description) {
+    switch (description) {
+        case 0: return "close_notify";
+        case 10: return "unexpected_message";
+        case 20: return "bad_record_mac";
+        case 40: return "handshake_failure";
+        case 42: return "bad_certificate";
+        case 47: return "illegal_parameter";
+        case 50: return "decode_error";
+        case 70: return "protocol_version";
+        case 71: return "insufficient_security";
+        case 80: return "internal_error";
+        case 86: return "inappropriate_fallback";
+        case 109: return "missing_extension";
+        case 110: return "unsupported_extension";
+        case 112: return "unrecognized_name";
+        case 120: return "no_application_protocol";
+        default: return "alert_" + std::to_string(description);
+    }
+}
+
+std::string buildClientHello(const ClientHelloSpec& spec) {
+    bool offersTls13 = std::find(spec.supportedVersions.begin(), spec.supportedVersions.end(),
+                                 TLS_VERSION_1_3) != spec.supportedVersions.end();
+
+    std::vector<std::pair<uint16_t, std::string>> extensions;
+
+    if (!spec.serverName.empty() && !isIpLiteral(spec.serverName)) {
+        std::string data;
+        put16(data, static_cast<uint16_t>(spec.serverName.size() + 3));
+        put8(data, 0);      // host_name
+        put16(data, static_cast<uint16_t>(spec.serverName.size()));
+        data += spec.serverName;
+        appendExtension(extensions, EXT_SERVER_NAME, data);
+    }
+    if (spec.extendedMasterSecret) {
+        appendExtension(extensions, EXT_EXTENDED_MASTER_SECRET, "");
+    }
+    if (spec.renegotiationInfo) {
+        appendExtension(extensions, EXT_RENEGOTIATION_INFO, std::string(1, '\0'));
+    }
+    if (!spec.groups.empty()) {
+        std::vector<uint16_t> groups = spec.groups;
+        if (spec.grease) {
+            groups.insert(groups.begin(), greaseValue());
+        }
+        std::string data;
+        put16(data, static_cast<uint16_t>(groups.size() * 2));
+        for (uint16_t group : groups) {
+            put16(data, group);
+        }
+        appendExtension(extensions, EXT_SUPPORTED_GROUPS, data);
+        // uncompressed
+        appendExtension(extensions, EXT_EC_POINT_FORMATS, std::string("\x01\x00", 2));
+    }
+    if (spec.sessionTicket) {
+        appendExtension(extensions, EXT_SESSION_TICKET, "");
+    }
+    if (!spec.alpn.empty()) {
+        std::string list;
+        for (const auto& protocol : spec.alpn) {
+            put8(list, static_cast<uint8_t>(protocol.size()));
+            list += protocol;
+        }
+        std::string data;
+        put16(data, static_cast<uint16_t>(list.size()));
+        appendExtension(extensions, EXT_ALPN, data + list);
+    }
+    if (spec.statusRequest) {
+        appendExtension(extensions, EXT_STATUS_REQUEST, std::string("\x01\x00\x00\x00\x00", 5));
+    }
+    if (!spec.signatureAlgorithms.empty()) {
+        std::string data;
+        put16(data, static_cast<uint16_t>(spec.signatureAlgorithms.size() * 2));
+        for (uint16_t algorithm : spec.signatureAlgorithms) {
+            put16(data, algorithm);
+        }
+        appendExtension(extensions, EXT_SIGNATURE_ALGORITHMS, data);
+    }
+    if (offersTls13) {
+        // x25519 随机公钥: 服务端据此选择参数即可，之后不会真正完成密钥交换
+        std::string share;
+        put16(share, GROUP_X25519);
+        put16(share, 32);
+        appendRandom(share, 32);
+        std::string data;
+        put16(data, static_cast<uint16_t>(share.size()));
+        appendExtension(extensions, EXT_KEY_SHARE, data + share);
+        appendExtension(extensions, EXT_PSK_KEY_EXCHANGE_MODES, std::string("\x01\x01", 2));
+    }
+    if (!spec.supportedVersions.empty()) {
+        std::vector<uint16_t> versions = spec.supportedVersions;
+        if (spec.grease) {
+            versions.insert(versions.begin(), greaseValue());
+        }
+        std::string data;
+        put8(data, static_cast<uint8_t>(versions.size() * 2));
+        for (uint16_t version : versions) {
+            put16(data, version);
+        }
+        appendExtension(extensions, EXT_SUPPORTED_VERSIONS, data);
+    }
+
+    if (spec.reverseExtensions) {
+        std::reverse(extensions.begin(), extensions.end());
+    }
+    if (spec.grease) {
+        extensions.insert(extensions.begin(), {greaseValue(), ""});
+    }
+
+    // ClientHello正文
+    std::string body;
+    put16(body, spec.legacyVersion);
+    appendRandom(body, 32);
+    // TLS 1.3中间设备兼容模式要求非空的会话ID
+    if (offersTls13) {
+        put8(body, 32);
+        appendRandom(body, 32);
+    } else {
+        put8(body, 0);
+    }
+
+    std::vector<uint16_t> suites = spec.cipherSuites;
+    if (spec.grease) {
+        suites.insert(suites.begin(), greaseValue());
+    }
+    put16(body, static_cast<uint16_t>(suites.size() * 2));
+    for (uint16_t suite : suites) {
+        put16(body, suite);
+    }
+    put8(body, 1);
+    put8(body, 0);      // null压缩
+
+    std::string extensionData;
+    for (const auto& [type, data] : extensions) {
+        put16(extensionData, type);
+        put16(extensionData, static_cast<uint16_t>(data.size()));
+        extensionData += data;
+    }
+    put16(body, static_cast<uint16_t>(extensionData.size()));
+    body += extensionData;
+
+    std::string handshake;
+    put8(handshake, HANDSHAKE_CLIENT_HELLO);
+    put24(handshake, static_cast<uint32_t>(body.size()));
+    handshake += body;
+
+    std::string record;
+    put8(record, RECORD_HANDSHAKE);
+    put16(record, spec.recordVersion);
+    put16(record, static_cast<uint16_t>(handshake.size()));
+    record += handshake;
+    return record;
+}
+
+TlsHandshakeReader::Result TlsHandshakeReader::feed(const char* data, size_t length) {
+    if (m_done) {
+        return Result::DONE;
+    }
+    m_buffer.append(data, length);
+
+    size_t offset = 0;
+    Result result = Result::NEED_MORE;
+    while (m_buffer.size() - offset >= 5) {
+        const char* header = m_buffer.data() + offset;
+        uint8_t type = static_cast<uint8_t>(header[0]);
+        uint16_t recordLength = get16(header + 3);
+
+        if (type < RECORD_CHANGE_CIPHER_SPEC || type > RECORD_APPLICATION_DATA ||
+            static_cast<uint8_t>(header[1]) != 0x03 || recordLength > MAX_RECORD_LENGTH) {
+            m_error = "Not a TLS response";
+            return Result::PARSE_ERROR;
+        }
+        if (m_buffer.size() - offset < 5u + recordLength) {
+            break;
+        }
+
+        std::string payload = m_buffer.substr(offset + 5, recordLength);
+        offset += 5u + recordLength;
+        result = processRecord(type, payload);
+        if (result != Result::NEED_MORE) {
+            m_done = true;
+            break;
+        }
+    }
+    m_buffer.erase(0, offset);
+    return result;
+}
+
+TlsHandshakeReader::Result TlsHandshakeReader::processRecord(uint8_t type, const std::string& payload) {
+    if (type == RECORD_ALERT) {
+        if (payload.size() < 2) {
+            m_error = "Truncated alert";
+            return Result::PARSE_ERROR;
+        }
+        m_serverHello.alert = true;
+        m_serverHello.alertLevel = static_cast<uint8_t>(payload[0]);
+        m_serverHello.alertDescription = static_cast<uint8_t>(payload[1]);
+        m_error = "TLS alert: " + alertName(m_serverHello.alertDescription);
+        return Result::ALERT;
+    }
+
+    if (type == RECORD_CHANGE_CIPHER_SPEC || type == RECORD_APPLICATION_DATA) {
+        // 之后的内容都已加密: TLS 1.3的兼容CCS或会话复用的简短握手
+        if (!m_serverHello.received) {
+            m_error = "Encrypted data before ServerHello";
+            return Result::PARSE_ERROR;
+        }
+        if (m_serverHello.version != TLS_VERSION_1_3) {
+            m_serverHello.sessionResumed = true;
+        }
+        return Result::DONE;
+    }
+
+    // 握手记录: 消息可能跨越多个记录
+    m_handshake += payload;
+    while (m_handshake.size() >= 4) {
+        uint8_t messageType = static_cast<uint8_t>(m_handshake[0]);
+        uint32_t messageLength = get24(m_handshake.data() + 1);
+        if (messageLength > MAX_HANDSHAKE_LENGTH) {
+            m_error = "Handshake message too large";
+            return Result::PARSE_ERROR;
+        }
+        if (m_handshake.size() < 4u + messageLength) {
+            break;
+        }
+
+        Result result = processHandshake(messageType, m_handshake.data() + 4, messageLength);
+        m_handshake.erase(0, 4u + messageLength);
+        if (result != Result::NEED_MORE) {
+            return result;
+        }
+    }
+    return Result::NEED_MORE;
+}
+
+TlsHandshakeReader::Result TlsHandshakeReader::processHandshake(uint8_t type, const char* body, size_t length) {
+    switch (type) {
+        case HANDSHAKE_SERVER_HELLO:
+            if (!parseServerHello(body, length)) {
+                m_error = "Malformed ServerHello";
+                return Result::PARSE_ERROR;
+            }
+            // TLS 1.3的后续消息全部加密
+            if (m_stopAt == StopAt::SERVER_HELLO || m_serverHello.version == TLS_VERSION_1_3 ||
+                m_serverHello.helloRetryRequest) {
+                return Result::DONE;
+            }
+            return Result::NEED_MORE;
+
+        case HANDSHAKE_CERTIFICATE:
+            if (!parseCertificate(body, length)) {
+                m_error = "Malformed Certificate";
+                return Result::PARSE_ERROR;
+            }
+            return m_stopAt == StopAt::CERTIFICATE ? Result::DONE : Result::NEED_MORE;
+
+        case HANDSHAKE_SERVER_HELLO_DONE:
+            return Result::DONE;
+
+        default:
+            // ServerKeyExchange、CertificateStatus、CertificateRequest等不关心
+            return Result::NEED_MORE;
+    }
+}
+
+bool TlsHandshakeReader::parseServerHello(const char* body, size_t length) {
+    // version(2) random(32) session_id(1+n) cipher(2) compression(1) [extensions(2+n)]
+    if (length < 38) {
+        return false;
+    }
+    ServerHelloInfo& info = m_serverHello;
+    info.received = true;
+    info.version = get16(body);
+    info.helloRetryRequest = std::memcmp(body + 2, HELLO_RETRY_RANDOM, sizeof(HELLO_RETRY_RANDOM)) == 0;
+
+    size_t offset = 34;
+    uint8_t sessionIdLength = static_cast<uint8_t>(body[offset]);
+    offset += 1u + sessionIdLength;
+    if (offset + 3 > length) {
+        return false;
+    }
+    info.cipherSuite = get16(body + offset);
+    info.compression = static_cast<uint8_t>(body[offset + 2]);
+    offset += 3;
+
+    if (offset + 2 > length) {
+        return true;        // 没有扩展
+    }
+    size_t extensionsEnd = offset + 2 + get16(body + offset);
+    offset += 2;
+    if (extensionsEnd > length) {
+        return false;
+    }
+
+    while (offset + 4 <= extensionsEnd) {
+        uint16_t type = get16(body + offset);
+        uint16_t size = get16(body + offset + 2);
+        const char* data = body + offset + 4;
+        offset += 4u + size;
+        if (offset > extensionsEnd) {
+            return false;
+        }
+        info.extensions.push_back(type);
+
+        if (type == EXT_SUPPORTED_VERSIONS && size == 2) {
+            info.version = get16(data);
+        } else if (type == EXT_ALPN && size >= 3) {
+            uint8_t nameLength = static_cast<uint8_t>(data[2]);
+            if (3u + nameLength <= size) {
+                info.alpn.assign(data + 3, nameLength);
+            }
+        }
+    }
+    return true;
+}
+
+bool TlsHandshakeReader::parseCertificate(const char* body, size_t length) {
+    if (length < 3) {
+        return false;
+    }
+    size_t listEnd = 3 + get24(body);
+    if (listEnd > length) {
+        return false;
+    }
+
+    size_t offset = 3;
+    while (offset + 3 <= listEnd) {
+        size_t certLength = get24(body + offset);
+        offset += 3;
+        if (offset + certLength > listEnd) {
+            return false;
+        }
+        m_certificates.emplace_back(body + offset, certLength);
+        offset += certLength;
+    }
+    return true;
+}
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace MindSploit::Tls {
+
+// 协议版本
+constexpr uint16_t SSL_VERSION_3_0 = 0x0300;
+constexpr uint16_t TLS_VERSION_1_0 = 0x0301;
+constexpr uint16_t TLS_VERSION_1_1 = 0x0302;
+constexpr uint16_t TLS_VERSION_1_2 = 0x0303;
+constexpr uint16_t TLS_VERSION_1_3 = 0x0304;
+
+// 扩展类型
+constexpr uint16_t EXT_SERVER_NAME = 0;
+constexpr uint16_t EXT_STATUS_REQUEST = 5;
+constexpr uint16_t EXT_SUPPORTED_GROUPS = 10;
+constexpr uint16_t EXT_EC_POINT_FORMATS = 11;
+constexpr uint16_t EXT_SIGNATURE_ALGORITHMS = 13;
+constexpr uint16_t EXT_ALPN = 16;
+constexpr uint16_t EXT_SIGNED_CERT_TIMESTAMP = 18;
+constexpr uint16_t EXT_EXTENDED_MASTER_SECRET = 23;
+constexpr uint16_t EXT_SESSION_TICKET = 35;
+constexpr uint16_t EXT_SUPPORTED_VERSIONS = 43;
+constexpr uint16_t EXT_PSK_KEY_EXCHANGE_MODES = 45;
+constexpr uint16_t EXT_KEY_SHARE = 51;
+constexpr uint16_t EXT_RENEGOTIATION_INFO = 0xff01;
+
+// 密钥交换组
+constexpr uint16_t GROUP_SECP256R1 = 0x0017;
+constexpr uint16_t GROUP_SECP384R1 = 0x0018;
+constexpr uint16_t GROUP_SECP521R1 = 0x0019;
+constexpr uint16_t GROUP_X25519 = 0x001d;
+constexpr uint16_t GROUP_X448 = 0x001e;
+
+// 已知密码套件
+struct CipherSuite {
+    uint16_t id;
+    const char* name;           // IANA名称
+};
+
+const std::vector<CipherSuite>& knownCipherSuites();
+// 未知套件返回 0xXXXX 形式
+std::string cipherSuiteName(uint16_t id);
+bool isTls13CipherSuite(uint16_t id);
+// RC4/DES/3DES/EXPORT/NULL/匿名/MD5等不安全套件
+bool isWeakCipherSuite(uint16_t id);
+std::string versionName(uint16_t version);
+
+// ClientHello构造参数
+struct ClientHelloSpec {
+    uint16_t recordVersion = TLS_VERSION_1_0;       // 记录层版本 (兼容性考虑固定为1.0)
+    uint16_t legacyVersion = TLS_VERSION_1_2;       // ClientHello.version
+    std::vector<uint16_t> supportedVersions;        // 非空时发送supported_versions扩展
+    std::vector<uint16_t> cipherSuites;
+    std::string serverName;                         // SNI，IP地址不发送
+    std::vector<std::string> alpn;
+    std::vector<uint16_t> groups = {GROUP_X25519, GROUP_SECP256R1, GROUP_SECP384R1, GROUP_SECP521R1};
+    std::vector<uint16_t> signatureAlgorithms = {
+        0x0403, 0x0503, 0x0603, 0x0804, 0x0805, 0x0806, 0x0401, 0x0501, 0x0601, 0x0807, 0x0201, 0x0203
+    };
+    bool sessionTicket = true;
+    bool extendedMasterSecret = true;
+    bool renegotiationInfo = true;
+    bool statusRequest = false;
+    bool grease = false;                            // 在套件、扩展和组列表前插入GREASE值
+    bool reverseExtensions = false;                 // 倒序发送扩展
+};
+
+// 生成完整的ClientHello记录 (含5字节记录头)
+// 提供TLS 1.3时附带x25519的随机key_share，足以让服务端回应ServerHello
+std::string buildClientHello(const ClientHelloSpec& spec);
+
+// ServerHello中的协商结果
+struct ServerHelloInfo {
+    bool received = false;
+    uint16_t version = 0;                   // 协商版本 (supported_versions优先)
+    uint16_t cipherSuite = 0;
+    uint8_t compression = 0;
+    std::vector<uint16_t> extensions;       // 按服务端发送顺序
+    std::string alpn;
+    bool helloRetryRequest = false;
+    bool sessionResumed = false;            // 服务端直接发送ChangeCipherSpec (会话复用)
+
+    bool alert = false;
+    uint8_t alertLevel = 0;
+    uint8_t alertDescription = 0;
+};
+
+std::string alertName(uint8_t description);
+
+// 增量解析服务端握手消息，只处理明文部分 (TLS 1.3的证书已加密)
+class TlsHandshakeReader {
+public:
+    enum class StopAt {
+        SERVER_HELLO,       // 收到ServerHello即结束 (枚举、指纹)
+        CERTIFICATE,        // 收到证书即结束 (仅证书模式)
+        SERVER_HELLO_DONE
+    };
+
+    enum class Result {
+        NEED_MORE,
+        DONE,
+        ALERT,
+        PARSE_ERROR
+    };
+
+    explicit TlsHandshakeReader(StopAt stopAt = StopAt::CERTIFICATE) : m_stopAt(stopAt) {}
+
+    Result feed(const char* data, size_t length);
+
+    const ServerHelloInfo& serverHello() const { return m_serverHello; }
+    // DER编码的证书链，首个为服务端证书
+    const std::vector<std::string>& certificates() const { return m_certificates; }
+    const std::string& error() const { return m_error; }
+
+private:
+    Result processRecord(uint8_t type, const std::string& payload);
+    Result processHandshake(uint8_t type, const char* body, size_t length);
+    bool parseServerHello(const char* body, size_t length);
+    bool parseCertificate(const char* body, size_t length);
+
+private:
+    StopAt m_stopAt;
+    std::string m_buffer;           // 未完整的记录
+    std::string m_handshake;        // 跨记录的握手消息
+    ServerHelloInfo m_serverHello;
+    std::vector<std::string> m_certificates;
+    std::string m_error;
+    bool m_done = false;
+};
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,434 @@
+#include "tls_prober.h"
+#include "../../utils/socket_budget.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace MindSploit::Tls {
+
+namespace {
+
+constexpr std::chrono::milliseconds SWEEP_INTERVAL{100};
+constexpr size_t RECEIVE_CHUNK = 16 * 1024;
+
+int lastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool wouldBlock(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+}
+
+bool connectInProgress(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EINPROGRESS;
+#endif
+}
+
+} // namespace
+
+TlsProber::TlsProber(Utils::EventLoop& loop, const TlsProberConfig& config)
+    : m_loop(loop), m_config(config) {
+    m_config.maxConnections = std::max<size_t>(1, m_config.maxConnections);
+}
+
+TlsProber::~TlsProber() {
+    cancelAll("TLS prober destroyed");
+    if (m_sweepTimer != 0) {
+        m_loop.cancelTimer(m_sweepTimer);
+    }
+}
+
+void TlsProber::submit(TlsProbeRequest request, Callback callback) {
+    Pending pending;
+    pending.request = std::move(request);
+    pending.callback = std::move(callback);
+    pending.submitted = Clock::now();
+
+    ++m_stats.probes;
+    m_queue.push_back(std::move(pending));
+    startQueued();
+    scheduleSweep();
+}
+
+void TlsProber::run(const std::atomic<bool>& stopRequested) {
+    while (!stopRequested && outstanding() > 0) {
+        m_loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (stopRequested) {
+        cancelAll("Probe cancelled");
+    }
+}
+
+void TlsProber::cancelAll(const std::string& reason) {
+    m_cancelling = true;
+
+    std::vector<int> fds;
+    fds.reserve(m_active.size());
+    for (const auto& entry : m_active) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        auto it = m_active.find(fd);
+        if (it != m_active.end()) {
+            finishProbe(*it->second, reason);
+        }
+    }
+    std::deque<Pending> queue = std::move(m_queue);
+    m_queue.clear();
+    for (Pending& pending : queue) {
+        fail(pending, reason);
+    }
+
+    m_cancelling = false;
+}
+
+void TlsProber::startQueued() {
+    if (m_cancelling) {
+        return;
+    }
+
+    while (!m_queue.empty() && m_active.size() < m_config.maxConnections) {
+        std::string error;
+        StartResult result = start(m_queue.front(), error);
+        if (result == StartResult::NO_CAPACITY) {
+            // 等待其它探测释放名额或由定时清理重试
+            break;
+        }
+        Pending pending = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (result == StartResult::FAILED) {
+            fail(pending, error);
+        }
+    }
+}
+
+TlsProber::StartResult TlsProber::start(Pending& pending, std::string& error) {
+    auto& budget = Utils::SocketBudget::instance();
+    if (!budget.acquire(std::chrono::milliseconds(0))) {
+        return StartResult::NO_CAPACITY;
+    }
+
+    const TlsProbeRequest& request = pending.request;
+    int fd = budget.openProbeSocket(request.address);
+    if (fd < 0) {
+        budget.release();
+        return StartResult::NO_CAPACITY;
+    }
+
+    // ClientHello和握手消息都是小写操作
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen = Utils::NetworkUtils::toSockaddr(request.address, request.port, addr);
+    int result = ::connect(fd, (struct sockaddr*)&addr, addrLen);
+    if (result != 0) {
+        int code = lastSocketError();
+        if (!connectInProgress(code)) {
+            budget.reportError(code);
+            budget.closeProbeSocket(fd);
+            budget.release();
+            error = std::string("Connection failed: ") + strerror(code);
+            return StartResult::FAILED;
+        }
+    }
+
+    auto probe = std::make_unique<Probe>(std::move(pending));
+    probe->fd = fd;
+    probe->deadline = Clock::now() + m_config.connectTimeout;
+    Probe* raw = probe.get();
+    m_active[fd] = std::move(probe);
+    ++m_stats.connectionsOpened;
+    m_stats.peakConnections = std::max(m_stats.peakConnections, m_active.size());
+
+    m_loop.watch(fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE,
+                 [this, fd](uint32_t events) { onEvent(fd, events); });
+    if (result == 0) {
+        onConnected(*raw);
+    }
+    return StartResult::STARTED;
+}
+
+void TlsProber::onEvent(int fd, uint32_t events) {
+    auto it = m_active.find(fd);
+    if (it == m_active.end()) {
+        return;
+    }
+    Probe& probe = *it->second;
+
+    if (!probe.connected) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+        if (error != 0 || !(events & Utils::EventLoop::EVENT_WRITE)) {
+            Utils::SocketBudget::instance().reportError(error);
+            finishProbe(probe, error != 0 ? std::string("Connection failed: ") + strerror(error)
+                                          : "Connection failed");
+            return;
+        }
+        onConnected(probe);
+        return;
+    }
+
+    if (probe.pending.request.mode == TlsProbeRequest::Mode::HELLO) {
+        if (events & Utils::EventLoop::EVENT_WRITE) {
+            flushHello(probe);
+            if (m_active.count(fd) == 0) {
+                return;
+            }
+        }
+        if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+            readHello(probe);
+        }
+    } else if (probe.draining) {
+        drainTickets(probe);
+    } else {
+        advanceHandshake(probe);
+    }
+}
+
+void TlsProber::onConnected(Probe& probe) {
+    probe.connected = true;
+    probe.result.connected = true;
+    probe.deadline = Clock::now() + m_config.handshakeTimeout;
+    Utils::SocketBudget::instance().reportSuccess();
+
+    const TlsProbeRequest& request = probe.pending.request;
+    if (request.mode == TlsProbeRequest::Mode::HELLO) {
+        probe.output = request.clientHello;
+        flushHello(probe);
+        return;
+    }
+
+    std::string cacheKey;
+    if (request.useSessionCache) {
+        cacheKey = TlsSessionCache::key(request.address.address, request.port, request.serverName);
+    }
+    probe.stream = std::make_unique<TlsStream>(probe.fd, request.serverName, cacheKey, request.alpn);
+    advanceHandshake(probe);
+}
+
+void TlsProber::flushHello(Probe& probe) {
+    while (probe.outputOffset < probe.output.size()) {
+#ifdef _WIN32
+        int flags = 0;
+#else
+        int flags = MSG_NOSIGNAL;
+#endif
+        int sent = ::send(probe.fd, probe.output.data() + probe.outputOffset,
+                          static_cast<int>(probe.output.size() - probe.outputOffset), flags);
+        if (sent < 0) {
+            if (wouldBlock(lastSocketError())) {
+                break;
+            }
+            finishProbe(probe, "Send failed");
+            return;
+        }
+        probe.outputOffset += static_cast<size_t>(sent);
+    }
+
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (probe.outputOffset < probe.output.size()) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(probe.fd, events);
+}
+
+void TlsProber::readHello(Probe& probe) {
+    char buffer[RECEIVE_CHUNK];
+
+    while (true) {
+        int received = ::recv(probe.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            auto result = probe.reader.feed(buffer, static_cast<size_t>(received));
+            if (result == TlsHandshakeReader::Result::NEED_MORE) {
+                continue;
+            }
+            probe.result.serverHello = probe.reader.serverHello();
+            probe.result.certificates = probe.reader.certificates();
+            // 告警也是有效应答 (例如拒绝了提供的全部套件)
+            finishProbe(probe, result == TlsHandshakeReader::Result::PARSE_ERROR ? probe.reader.error() : "");
+            return;
+        }
+        if (received < 0 && wouldBlock(lastSocketError())) {
+            return;
+        }
+
+        // 对端在完整应答前关闭: 很多实现以直接断开代替告警
+        probe.result.serverHello = probe.reader.serverHello();
+        probe.result.certificates = probe.reader.certificates();
+        finishProbe(probe, probe.result.serverHello.received ? "Connection closed during handshake"
+                                                             : "Connection closed by peer");
+        return;
+    }
+}
+
+void TlsProber::advanceHandshake(Probe& probe) {
+    TlsStream& stream = *probe.stream;
+    switch (stream.handshake()) {
+        case TlsStream::Status::OK:
+            break;
+        case TlsStream::Status::WANT_READ:
+            m_loop.update(probe.fd, Utils::EventLoop::EVENT_READ);
+            return;
+        case TlsStream::Status::WANT_WRITE:
+            m_loop.update(probe.fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE);
+            return;
+        default:
+            finishProbe(probe, stream.lastError().empty() ? "TLS handshake failed" : stream.lastError());
+            return;
+    }
+
+    collectHandshake(probe);
+
+    // TLS 1.3的会话票据在握手之后发送，短暂读取以便后续连接复用
+    if (probe.pending.request.useSessionCache && !stream.sessionStored() && probe.result.version == "TLSv1.3") {
+        probe.draining = true;
+        probe.deadline = Clock::now() + m_config.ticketWait;
+        m_loop.update(probe.fd, Utils::EventLoop::EVENT_READ);
+        drainTickets(probe);
+        return;
+    }
+    finishProbe(probe, "");
+}
+
+void TlsProber::drainTickets(Probe& probe) {
+    char buffer[RECEIVE_CHUNK];
+    TlsStream& stream = *probe.stream;
+
+    while (!stream.sessionStored()) {
+        size_t received = 0;
+        TlsStream::Status status = stream.read(buffer, sizeof(buffer), received);
+        if (status != TlsStream::Status::OK) {
+            // 票据在同一次读取中处理完后才返回WANT_READ
+            if ((status == TlsStream::Status::WANT_READ || status == TlsStream::Status::WANT_WRITE) &&
+                !stream.sessionStored()) {
+                return;
+            }
+            break;
+        }
+    }
+    finishProbe(probe, "");
+}
+
+void TlsProber::collectHandshake(Probe& probe) {
+    TlsStream& stream = *probe.stream;
+    TlsProbeResult& result = probe.result;
+    result.handshakeComplete = true;
+    result.resumed = stream.resumed();
+    result.version = stream.version();
+    result.cipher = stream.cipher();
+    result.alpn = stream.alpn();
+    result.certificates = stream.peerCertificates();
+
+    ++m_stats.handshakes;
+    if (result.resumed) {
+        ++m_stats.resumed;
+    }
+}
+
+void TlsProber::finishProbe(Probe& probe, const std::string& error) {
+    int fd = probe.fd;
+    m_loop.unwatch(fd);
+
+    // TLS对象必须在关闭套接字之前释放
+    probe.stream.reset();
+    auto& budget = Utils::SocketBudget::instance();
+    budget.closeProbeSocket(fd);
+    budget.release();
+
+    Pending pending = std::move(probe.pending);
+    TlsProbeResult result = std::move(probe.result);
+    m_active.erase(fd);
+
+    result.error = error;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    if (result.ok()) {
+        ++m_stats.completed;
+    } else {
+        ++m_stats.failures;
+    }
+    if (pending.callback) {
+        pending.callback(pending.request, result);
+    }
+
+    startQueued();
+}
+
+void TlsProber::fail(Pending& pending, const std::string& error) {
+    TlsProbeResult result;
+    result.error = error;
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    ++m_stats.failures;
+    if (pending.callback) {
+        pending.callback(pending.request, result);
+    }
+}
+
+void TlsProber::scheduleSweep() {
+    if (m_sweepTimer != 0) {
+        return;
+    }
+    m_sweepTimer = m_loop.addTimer(SWEEP_INTERVAL, [this]() {
+        m_sweepTimer = 0;
+        sweep();
+        if (outstanding() > 0) {
+            scheduleSweep();
+        }
+    });
+}
+
+void TlsProber::sweep() {
+    auto now = Clock::now();
+
+    std::vector<int> expired;
+    for (const auto& entry : m_active) {
+        if (now >= entry.second->deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        auto it = m_active.find(fd);
+        if (it == m_active.end()) {
+            continue;
+        }
+        Probe& probe = *it->second;
+        if (probe.draining) {
+            // 没等到票据不影响握手结果
+            finishProbe(probe, "");
+        } else if (!probe.connected) {
+            finishProbe(probe, "Connection timeout");
+        } else {
+            probe.result.serverHello = probe.reader.serverHello();
+            probe.result.certificates = probe.reader.certificates();
+            finishProbe(probe, "Handshake timeout");
+        }
+    }
+
+    // 等待连接名额的探测同样受超时约束
+    auto queueLimit = m_config.connectTimeout + m_config.handshakeTimeout;
+    while (!m_queue.empty() && now - m_queue.front().submitted >= queueLimit) {
+        Pending pending = std::move(m_queue.front());
+        m_queue.pop_front();
+        fail(pending, "Probe timeout");
+    }
+
+    startQueued();
+}
+
+} // namespace MindSploit::Tls
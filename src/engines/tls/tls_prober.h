@@ -0,0 +1,153 @@
+#pragma once
+
+#include "tls_hello.h"
+#include "tls_session.h"
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace MindSploit::Tls {
+
+// TLS探测器配置
+struct TlsProberConfig {
+    size_t maxConnections = 1024;               // 同时进行的握手数 (另受SocketBudget约束)
+    std::chrono::milliseconds connectTimeout{5000};
+    std::chrono::milliseconds handshakeTimeout{10000};
+    // TLS 1.3的会话票据在握手完成后才发送，完整握手后最多等待这么久以便缓存
+    std::chrono::milliseconds ticketWait{300};
+};
+
+// 单次探测
+struct TlsProbeRequest {
+    enum class Mode {
+        HELLO,          // 发送原始ClientHello并解析明文应答 (不需要OpenSSL)
+        HANDSHAKE       // 通过OpenSSL完成握手
+    };
+
+    Utils::IPAddress address;
+    uint16_t port = 443;
+    std::string serverName;                     // SNI，为空或IP地址时不发送
+    Mode mode = Mode::HANDSHAKE;
+
+    // HELLO模式
+    std::string clientHello;                    // buildClientHello生成的记录
+    TlsHandshakeReader::StopAt stopAt = TlsHandshakeReader::StopAt::CERTIFICATE;
+
+    // HANDSHAKE模式
+    std::vector<std::string> alpn;
+    bool useSessionCache = true;                // 复用并保存会话
+};
+
+// 探测结果
+struct TlsProbeResult {
+    bool connected = false;                     // TCP连接已建立
+    std::string error;
+
+    ServerHelloInfo serverHello;                // HELLO模式的解析结果
+    std::vector<std::string> certificates;      // DER编码证书链
+
+    bool handshakeComplete = false;             // HANDSHAKE模式
+    bool resumed = false;
+    std::string version;
+    std::string cipher;
+    std::string alpn;
+
+    std::chrono::milliseconds elapsed{0};
+
+    bool ok() const { return error.empty(); }
+};
+
+// 探测器统计
+struct TlsProberStats {
+    uint64_t probes = 0;
+    uint64_t completed = 0;
+    uint64_t failures = 0;
+    uint64_t handshakes = 0;
+    uint64_t resumed = 0;
+    uint64_t connectionsOpened = 0;
+    size_t peakConnections = 0;
+};
+
+// 基于事件循环的并发TLS探测器
+//
+// 每个探测使用独立的连接；连接名额不足时排队等待其它探测结束。
+// 回调在事件循环线程中执行，可以在回调里继续submit。
+class TlsProber {
+public:
+    using Callback = std::function<void(const TlsProbeRequest& request, const TlsProbeResult& result)>;
+
+    TlsProber(Utils::EventLoop& loop, const TlsProberConfig& config);
+    ~TlsProber();
+
+    TlsProber(const TlsProber&) = delete;
+    TlsProber& operator=(const TlsProber&) = delete;
+
+    void submit(TlsProbeRequest request, Callback callback);
+    // 排队和进行中的探测数
+    size_t outstanding() const { return m_queue.size() + m_active.size(); }
+    // 驱动事件循环直到全部探测完成或stopRequested置位
+    void run(const std::atomic<bool>& stopRequested);
+    void cancelAll(const std::string& reason);
+
+    TlsProberStats getStats() const { return m_stats; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        TlsProbeRequest request;
+        Callback callback;
+        Clock::time_point submitted;
+    };
+
+    struct Probe {
+        int fd = -1;
+        Pending pending;
+        bool connected = false;
+        bool draining = false;                  // 握手已完成，等待会话票据
+        Clock::time_point deadline;
+        std::string output;
+        size_t outputOffset = 0;
+        TlsHandshakeReader reader;
+        std::unique_ptr<TlsStream> stream;
+        TlsProbeResult result;
+
+        explicit Probe(Pending p) : pending(std::move(p)), reader(pending.request.stopAt) {}
+    };
+
+    void startQueued();
+    enum class StartResult {
+        STARTED,
+        NO_CAPACITY,
+        FAILED
+    };
+    StartResult start(Pending& pending, std::string& error);
+
+    void onEvent(int fd, uint32_t events);
+    void onConnected(Probe& probe);
+    void flushHello(Probe& probe);
+    void readHello(Probe& probe);
+    void advanceHandshake(Probe& probe);
+    void drainTickets(Probe& probe);
+    void collectHandshake(Probe& probe);
+    void finishProbe(Probe& probe, const std::string& error);
+    void fail(Pending& pending, const std::string& error);
+
+    void scheduleSweep();
+    void sweep();
+
+private:
+    Utils::EventLoop& m_loop;
+    TlsProberConfig m_config;
+    std::deque<Pending> m_queue;
+    std::unordered_map<int, std::unique_ptr<Probe>> m_active;
+    Utils::EventLoop::TimerId m_sweepTimer = 0;
+    bool m_cancelling = false;
+    TlsProberStats m_stats;
+};
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,363 @@
+#include "tls_session.h"
+
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509.h>
+#endif
+
+namespace MindSploit::Tls {
+
+namespace {
+
+bool isIpLiteral(const std::string& name) {
+    return name.find_first_not_of("0123456789.") == std::string::npos || name.find(':') != std::string::npos;
+}
+
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+std::string opensslError(const char* operation) {
+    unsigned long code = ERR_get_error();
+    ERR_clear_error();
+    if (code == 0) {
+        return std::string(operation) + " failed";
+    }
+    char buffer[256];
+    ERR_error_string_n(code, buffer, sizeof(buffer));
+    return std::string(operation) + ": " + buffer;
+}
+#else
+const char* const NOT_AVAILABLE = "TLS support not compiled in (OpenSSL not found)";
+#endif
+
+} // namespace
+
+bool tlsAvailable() {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// TlsSessionCache
+
+TlsSessionCache& TlsSessionCache::instance() {
+    // 进程退出时不释放缓存的会话，避免与OpenSSL自身的清理顺序冲突
+    static TlsSessionCache* cache = new TlsSessionCache();
+    return *cache;
+}
+
+TlsSessionCache::~TlsSessionCache() = default;
+
+std::string TlsSessionCache::key(const std::string& address, uint16_t port, const std::string& serverName) {
+    // IP地址不作为SNI发送，与不带名称的握手共用会话
+    return address + ":" + std::to_string(port) + "|" + (isIpLiteral(serverName) ? "" : serverName);
+}
+
+size_t TlsSessionCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sessions.size();
+}
+
+void TlsSessionCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    for (auto& entry : m_sessions) {
+        SSL_SESSION_free(entry.second);
+    }
+#endif
+    m_sessions.clear();
+}
+
+TlsSessionCacheStats TlsSessionCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TlsSessionCacheStats stats = m_stats;
+    stats.sessions = m_sessions.size();
+    return stats;
+}
+
+void TlsSessionCache::store(const std::string& key, ssl_session_st* session) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& slot = m_sessions[key];
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (slot != nullptr) {
+        SSL_SESSION_free(slot);
+    }
+#endif
+    slot = session;
+    ++m_stats.stored;
+}
+
+ssl_session_st* TlsSessionCache::lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end()) {
+        return nullptr;
+    }
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    SSL_SESSION_up_ref(it->second);
+#endif
+    ++m_stats.offered;
+    return it->second;
+}
+
+void TlsSessionCache::recordResumed() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.resumed;
+}
+
+// ---------------------------------------------------------------------------
+// TlsStream
+
+TlsStream::TlsStream(int fd, const std::string& serverName, const std::string& cacheKey,
+                     const std::vector<std::string>& alpn)
+    : m_cacheKey(cacheKey) {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    // 探测用途: 不校验证书，允许所有协议版本和套件
+    static SSL_CTX* context = [] {
+        SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+        if (ctx == nullptr) {
+            return ctx;
+        }
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, nullptr);
+        SSL_CTX_set_min_proto_version(ctx, 0);
+        SSL_CTX_set_security_level(ctx, 0);
+        SSL_CTX_set_cipher_list(ctx, "ALL:COMPLEMENTOFALL:@SECLEVEL=0");
+        SSL_CTX_set_options(ctx, SSL_OP_LEGACY_SERVER_CONNECT | SSL_OP_NO_COMPRESSION);
+        // HTTP流水线会在WANT_WRITE期间追加输出缓冲区
+        SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx, &TlsStream::onNewSession);
+        return ctx;
+    }();
+
+    if (context == nullptr || (m_ssl = SSL_new(context)) == nullptr) {
+        m_error = opensslError("SSL_new");
+        return;
+    }
+    SSL_set_fd(m_ssl, fd);
+    SSL_set_app_data(m_ssl, this);
+    SSL_set_connect_state(m_ssl);
+
+    if (!serverName.empty() && !isIpLiteral(serverName)) {
+        SSL_set_tlsext_host_name(m_ssl, serverName.c_str());
+    }
+    if (!alpn.empty()) {
+        std::string wire;
+        for (const auto& protocol : alpn) {
+            wire += static_cast<char>(protocol.size());
+            wire += protocol;
+        }
+        SSL_set_alpn_protos(m_ssl, reinterpret_cast<const unsigned char*>(wire.data()),
+                            static_cast<unsigned int>(wire.size()));
+    }
+    if (!m_cacheKey.empty()) {
+        SSL_SESSION* session = TlsSessionCache::instance().lookup(m_cacheKey);
+        if (session != nullptr) {
+            SSL_set_session(m_ssl, session);
+            SSL_SESSION_free(session);
+        }
+    }
+#else
+    (void)fd;
+    (void)serverName;
+    (void)alpn;
+    m_error = NOT_AVAILABLE;
+#endif
+}
+
+TlsStream::~TlsStream() {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (m_ssl != nullptr) {
+        // 套接字由调用方关闭 (SSL_set_fd不接管fd)
+        SSL_set_app_data(m_ssl, nullptr);
+        // 不发送close_notify直接断开时OpenSSL会把会话标记为不可复用，探测连接视为正常结束
+        if (m_handshakeComplete) {
+            SSL_set_shutdown(m_ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+        }
+        SSL_free(m_ssl);
+    }
+#endif
+}
+
+TlsStream::Status TlsStream::handshake() {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (m_ssl == nullptr) {
+        return Status::FAILED;
+    }
+    if (m_handshakeComplete) {
+        return Status::OK;
+    }
+    int result = SSL_connect(m_ssl);
+    if (result == 1) {
+        m_handshakeComplete = true;
+        if (SSL_session_reused(m_ssl)) {
+            TlsSessionCache::instance().recordResumed();
+        }
+        return Status::OK;
+    }
+    return translate(result, "TLS handshake");
+#else
+    return Status::FAILED;
+#endif
+}
+
+TlsStream::Status TlsStream::read(char* buffer, size_t length, size_t& received) {
+    received = 0;
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (m_ssl == nullptr) {
+        return Status::FAILED;
+    }
+    int result = SSL_read_ex(m_ssl, buffer, length, &received);
+    return result == 1 ? Status::OK : translate(result, "TLS read");
+#else
+    (void)buffer;
+    (void)length;
+    return Status::FAILED;
+#endif
+}
+
+TlsStream::Status TlsStream::write(const char* data, size_t length, size_t& written) {
+    written = 0;
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (m_ssl == nullptr) {
+        return Status::FAILED;
+    }
+    int result = SSL_write_ex(m_ssl, data, length, &written);
+    return result == 1 ? Status::OK : translate(result, "TLS write");
+#else
+    (void)data;
+    (void)length;
+    return Status::FAILED;
+#endif
+}
+
+bool TlsStream::resumed() const {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    return m_ssl != nullptr && m_handshakeComplete && SSL_session_reused(m_ssl);
+#else
+    return false;
+#endif
+}
+
+std::string TlsStream::version() const {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    return m_ssl != nullptr && m_handshakeComplete ? SSL_get_version(m_ssl) : "";
+#else
+    return "";
+#endif
+}
+
+std::string TlsStream::cipher() const {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    const SSL_CIPHER* current = m_ssl != nullptr ? SSL_get_current_cipher(m_ssl) : nullptr;
+    if (current == nullptr) {
+        return "";
+    }
+    const char* name = SSL_CIPHER_standard_name(current);
+    return name != nullptr ? name : SSL_CIPHER_get_name(current);
+#else
+    return "";
+#endif
+}
+
+std::string TlsStream::alpn() const {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    const unsigned char* data = nullptr;
+    unsigned int length = 0;
+    if (m_ssl != nullptr) {
+        SSL_get0_alpn_selected(m_ssl, &data, &length);
+    }
+    return data != nullptr ? std::string(reinterpret_cast<const char*>(data), length) : "";
+#else
+    return "";
+#endif
+}
+
+std::vector<std::string> TlsStream::peerCertificates() const {
+    std::vector<std::string> chain;
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    if (m_ssl == nullptr) {
+        return chain;
+    }
+
+    auto append = [&chain](X509* certificate) {
+        int length = i2d_X509(certificate, nullptr);
+        if (length <= 0) {
+            return;
+        }
+        std::string der(static_cast<size_t>(length), '\0');
+        unsigned char* out = reinterpret_cast<unsigned char*>(&der[0]);
+        i2d_X509(certificate, &out);
+        chain.push_back(std::move(der));
+    };
+
+    STACK_OF(X509)* peerChain = SSL_get_peer_cert_chain(m_ssl);
+    if (peerChain != nullptr && sk_X509_num(peerChain) > 0) {
+        for (int i = 0; i < sk_X509_num(peerChain); ++i) {
+            append(sk_X509_value(peerChain, i));
+        }
+        return chain;
+    }
+
+    // 复用的会话只保存了服务端证书
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    X509* peer = SSL_get1_peer_certificate(m_ssl);
+#else
+    X509* peer = SSL_get_peer_certificate(m_ssl);
+#endif
+    if (peer != nullptr) {
+        append(peer);
+        X509_free(peer);
+    }
+#endif
+    return chain;
+}
+
+TlsStream::Status TlsStream::translate(int result, const char* operation) {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    switch (SSL_get_error(m_ssl, result)) {
+        case SSL_ERROR_WANT_READ:
+            return Status::WANT_READ;
+        case SSL_ERROR_WANT_WRITE:
+            return Status::WANT_WRITE;
+        case SSL_ERROR_ZERO_RETURN:
+            return Status::CLOSED;
+        case SSL_ERROR_SYSCALL:
+            // 没有错误码的SYSCALL是对端直接断开
+            if (ERR_peek_error() == 0) {
+                m_error = std::string(operation) + ": connection closed by peer";
+                return m_handshakeComplete ? Status::CLOSED : Status::FAILED;
+            }
+            m_error = opensslError(operation);
+            return Status::FAILED;
+        default:
+            m_error = opensslError(operation);
+            return Status::FAILED;
+    }
+#else
+    (void)result;
+    (void)operation;
+    return Status::FAILED;
+#endif
+}
+
+int TlsStream::onNewSession(ssl_st* ssl, ssl_session_st* session) {
+#ifdef MINDSPLOIT_HAVE_OPENSSL
+    auto* stream = static_cast<TlsStream*>(SSL_get_app_data(ssl));
+    if (stream == nullptr || stream->m_cacheKey.empty() || !SSL_SESSION_is_resumable(session)) {
+        return 0;
+    }
+    // 返回1表示缓存接管这份会话引用
+    TlsSessionCache::instance().store(stream->m_cacheKey, session);
+    stream->m_sessionStored = true;
+    return 1;
+#else
+    (void)ssl;
+    (void)session;
+    return 0;
+#endif
+}
+
+} // namespace MindSploit::Tls
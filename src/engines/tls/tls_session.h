@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+// OpenSSL类型前置声明，头文件不依赖OpenSSL
+struct ssl_st;
+struct ssl_session_st;
+
+namespace MindSploit::Tls {
+
+// 是否编译了OpenSSL支持 (完整握手、会话复用、HTTPS)
+bool tlsAvailable();
+
+// 会话缓存统计
+struct TlsSessionCacheStats {
+    size_t sessions = 0;
+    uint64_t stored = 0;
+    uint64_t offered = 0;       // 握手时提供了缓存的会话
+    uint64_t resumed = 0;       // 服务端接受了会话复用
+};
+
+// 按 地址:端口|SNI 缓存的TLS会话和票据
+//
+// 完整握手 (tls命令) 收到的会话在这里保存，后续对同一端点的HTTPS请求和
+// 枚举探测直接复用，省去证书传输和非对称运算。
+class TlsSessionCache {
+public:
+    static TlsSessionCache& instance();
+
+    static std::string key(const std::string& address, uint16_t port, const std::string& serverName);
+
+    size_t size() const;
+    void clear();
+    TlsSessionCacheStats getStats() const;
+
+private:
+    friend class TlsStream;
+
+    TlsSessionCache() = default;
+    ~TlsSessionCache();
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    // 缓存获得一份会话引用，替换同一键下的旧会话
+    void store(const std::string& key, ssl_session_st* session);
+    // 返回带引用的会话，调用方负责释放；不存在时返回nullptr
+    ssl_session_st* lookup(const std::string& key);
+    void recordResumed();
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, ssl_session_st*> m_sessions;
+    TlsSessionCacheStats m_stats;
+};
+
+// 已连接非阻塞套接字上的TLS客户端连接
+// 握手和读写返回WANT_READ/WANT_WRITE时由调用方在事件循环中等待对应事件后重试。
+class TlsStream {
+public:
+    enum class Status {
+        OK,
+        WANT_READ,
+        WANT_WRITE,
+        CLOSED,
+        FAILED
+    };
+
+    // cacheKey为空时不使用会话缓存
+    TlsStream(int fd, const std::string& serverName, const std::string& cacheKey,
+              const std::vector<std::string>& alpn = {});
+    ~TlsStream();
+
+    TlsStream(const TlsStream&) = delete;
+    TlsStream& operator=(const TlsStream&) = delete;
+
+    Status handshake();
+    Status read(char* buffer, size_t length, size_t& received);
+    Status write(const char* data, size_t length, size_t& written);
+
+    bool handshakeComplete() const { return m_handshakeComplete; }
+    bool resumed() const;
+    bool sessionStored() const { return m_sessionStored; }
+    std::string version() const;
+    std::string cipher() const;
+    std::string alpn() const;
+    // DER编码的证书链，首个为服务端证书 (复用会话时可能只有服务端证书)
+    std::vector<std::string> peerCertificates() const;
+    const std::string& lastError() const { return m_error; }
+
+private:
+    Status translate(int result, const char* operation);
+    static int onNewSession(ssl_st* ssl, ssl_session_st* session);
+
+private:
+    ssl_st* m_ssl = nullptr;
+    std::string m_cacheKey;
+    std::string m_error;
+    bool m_handshakeComplete = false;
+    bool m_sessionStored = false;
+};
+
+} // namespace MindSploit::Tls
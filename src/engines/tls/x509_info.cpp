@@ -0,0 +1,413 @@
+#include "x509_info.h"
+#include <cstdio>
+#include <cstring>
+
+namespace MindSploit::Tls {
+
+namespace {
+
+constexpr uint8_t TAG_BOOLEAN = 0x01;
+constexpr uint8_t TAG_INTEGER = 0x02;
+constexpr uint8_t TAG_BIT_STRING = 0x03;
+constexpr uint8_t TAG_OCTET_STRING = 0x04;
+constexpr uint8_t TAG_OID = 0x06;
+constexpr uint8_t TAG_UTC_TIME = 0x17;
+constexpr uint8_t TAG_GENERALIZED_TIME = 0x18;
+constexpr uint8_t TAG_SEQUENCE = 0x30;
+constexpr uint8_t TAG_CONTEXT_0 = 0xa0;
+constexpr uint8_t TAG_CONTEXT_3 = 0xa3;
+constexpr uint8_t TAG_SAN_DNS = 0x82;
+constexpr uint8_t TAG_SAN_IP = 0x87;
+
+struct DerElement {
+    uint8_t tag = 0;
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    const uint8_t* raw = nullptr;       // 含标签和长度的完整编码
+    size_t rawLength = 0;
+};
+
+// 顺序读取同一层级的DER元素
+class DerReader {
+public:
+    DerReader(const uint8_t* data, size_t length) : m_data(data), m_end(data + length) {}
+    explicit DerReader(const DerElement& element) : DerReader(element.data, element.length) {}
+
+    bool atEnd() const { return m_data >= m_end; }
+    bool peekTag(uint8_t tag) const { return !atEnd() && *m_data == tag; }
+
+    bool next(DerElement& element) {
+        if (m_end - m_data < 2) {
+            return false;
+        }
+        const uint8_t* start = m_data;
+        element.tag = *m_data++;
+
+        size_t length = *m_data++;
+        if (length & 0x80) {
+            size_t count = length & 0x7f;
+            if (count == 0 || count > 4 || static_cast<size_t>(m_end - m_data) < count) {
+                return false;
+            }
+            length = 0;
+            for (size_t i = 0; i < count; ++i) {
+                length = (length << 8) | *m_data++;
+            }
+        }
+        if (static_cast<size_t>(m_end - m_data) < length) {
+            return false;
+        }
+
+        element.data = m_data;
+        element.length = length;
+        element.raw = start;
+        element.rawLength = static_cast<size_t>(m_data + length - start);
+        m_data += length;
+        return true;
+    }
+
+    bool expect(uint8_t tag, DerElement& element) {
+        return next(element) && element.tag == tag;
+    }
+
+private:
+    const uint8_t* m_data;
+    const uint8_t* m_end;
+};
+
+struct OidName {
+    const char* der;        // OID内容字节
+    size_t length;
+    const char* name;
+};
+
+#define OID(bytes, name) {bytes, sizeof(bytes) - 1, name}
+
+const OidName ATTRIBUTE_NAMES[] = {
+    OID("\x55\x04\x03", "CN"),
+    OID("\x55\x04\x06", "C"),
+    OID("\x55\x04\x07", "L"),
+    OID("\x55\x04\x08", "ST"),
+    OID("\x55\x04\x0a", "O"),
+    OID("\x55\x04\x0b", "OU"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x09\x01", "emailAddress"),
+};
+
+const OidName SIGNATURE_NAMES[] = {
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x04", "md5WithRSAEncryption"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x05", "sha1WithRSAEncryption"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0b", "sha256WithRSAEncryption"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0c", "sha384WithRSAEncryption"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0d", "sha512WithRSAEncryption"),
+    OID("\x2a\x86\x48\x86\xf7\x0d\x01\x01\x0a", "rsassaPss"),
+    OID("\x2a\x86\x48\xce\x3d\x04\x01", "ecdsa-with-SHA1"),
+    OID("\x2a\x86\x48\xce\x3d\x04\x03\x02", "ecdsa-with-SHA256"),
+    OID("\x2a\x86\x48\xce\x3d\x04\x03\x03", "ecdsa-with-SHA384"),
+    OID("\x2a\x86\x48\xce\x3d\x04\x03\x04", "ecdsa-with-SHA512"),
+    OID("\x2b\x65\x70", "Ed25519"),
+};
+
+const OidName CURVE_NAMES[] = {
+    OID("\x2a\x86\x48\xce\x3d\x03\x01\x07", "P-256"),
+    OID("\x2b\x81\x04\x00\x22", "P-384"),
+    OID("\x2b\x81\x04\x00\x23", "P-521"),
+    OID("\x2b\x24\x03\x03\x02\x08\x01\x01\x07", "brainpoolP256r1"),
+};
+
+const char OID_RSA[] = "\x2a\x86\x48\x86\xf7\x0d\x01\x01\x01";
+const char OID_EC[] = "\x2a\x86\x48\xce\x3d\x02\x01";
+const char OID_DSA[] = "\x2a\x86\x48\xce\x38\x04\x01";
+const char OID_ED25519[] = "\x2b\x65\x70";
+const char OID_SUBJECT_ALT_NAME[] = "\x55\x1d\x11";
+
+#undef OID
+
+bool oidEquals(const DerElement& element, const char* oid, size_t length) {
+    return element.length == length && std::memcmp(element.data, oid, length) == 0;
+}
+
+template <size_t N>
+const char* lookupOid(const DerElement& element, const OidName (&table)[N]) {
+    for (const auto& entry : table) {
+        if (oidEquals(element, entry.der, entry.length)) {
+            return entry.name;
+        }
+    }
+    return nullptr;
+}
+
+// 点分形式的OID，用于未知属性
+std::string oidToString(const DerElement& element) {
+    if (element.length == 0) {
+        return "";
+    }
+    std::string text = std::to_string(element.data[0] / 40) + "." + std::to_string(element.data[0] % 40);
+    uint64_t value = 0;
+    for (size_t i = 1; i < element.length; ++i) {
+        value = (value << 7) | (element.data[i] & 0x7f);
+        if (!(element.data[i] & 0x80)) {
+            text += "." + std::to_string(value);
+            value = 0;
+        }
+    }
+    return text;
+}
+
+std::string hexString(const uint8_t* data, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(length * 2);
+    for (size_t i = 0; i < length; ++i) {
+        text += digits[data[i] >> 4];
+        text += digits[data[i] & 0x0f];
+    }
+    return text;
+}
+
+// Name ::= SEQUENCE OF SET OF AttributeTypeAndValue
+std::string parseName(const DerElement& name, std::string* commonName) {
+    std::string text;
+    DerReader sets(name);
+    DerElement set;
+    while (sets.next(set)) {
+        DerReader attributes(set);
+        DerElement attribute;
+        while (attributes.next(attribute)) {
+            DerReader fields(attribute);
+            DerElement oid, value;
+            if (!fields.expect(TAG_OID, oid) || !fields.next(value)) {
+                continue;
+            }
+            const char* key = lookupOid(oid, ATTRIBUTE_NAMES);
+            std::string valueText(reinterpret_cast<const char*>(value.data), value.length);
+            if (!text.empty()) {
+                text += ",";
+            }
+            text += (key != nullptr ? key : oidToString(oid)) + "=" + valueText;
+            if (commonName != nullptr && key != nullptr && std::strcmp(key, "CN") == 0) {
+                *commonName = valueText;
+            }
+        }
+    }
+    return text;
+}
+
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// UTCTime (YYMMDDHHMMSSZ) 或 GeneralizedTime (YYYYMMDDHHMMSSZ)
+bool parseTime(const DerElement& element, std::string& text, int64_t& epoch) {
+    std::string value(reinterpret_cast<const char*>(element.data), element.length);
+    int year, month, day, hour, minute, second;
+    if (element.tag == TAG_UTC_TIME) {
+        if (std::sscanf(value.c_str(), "%2d%2d%2d%2d%2d%2d", &year, &month, &day, &hour, &minute, &second) != 6) {
+            return false;
+        }
+        year += year < 50 ? 2000 : 1900;
+    } else if (element.tag == TAG_GENERALIZED_TIME) {
+        if (std::sscanf(value.c_str(), "%4d%2d%2d%2d%2d%2d", &year, &month, &day, &hour, &minute, &second) != 6) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d", year, month, day, hour, minute, second);
+    text = buffer;
+    epoch = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400 +
+            hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+// 去掉INTEGER的前导零后按位计算长度
+int integerBits(const DerElement& integer) {
+    const uint8_t* data = integer.data;
+    size_t length = integer.length;
+    while (length > 0 && *data == 0) {
+        ++data;
+        --length;
+    }
+    if (length == 0) {
+        return 0;
+    }
+    int bits = static_cast<int>((length - 1) * 8);
+    for (uint8_t top = *data; top != 0; top >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+void parsePublicKey(const DerElement& spki, CertificateInfo& info) {
+    DerReader reader(spki);
+    DerElement algorithm, key;
+    if (!reader.expect(TAG_SEQUENCE, algorithm) || !reader.expect(TAG_BIT_STRING, key)) {
+        return;
+    }
+    DerReader algorithmReader(algorithm);
+    DerElement oid, parameters;
+    if (!algorithmReader.expect(TAG_OID, oid)) {
+        return;
+    }
+    bool hasParameters = algorithmReader.next(parameters);
+
+    if (oidEquals(oid, OID_RSA, sizeof(OID_RSA) - 1)) {
+        info.keyType = "RSA";
+        // BIT STRING: 未用位数(1字节) + RSAPublicKey ::= SEQUENCE { modulus, exponent }
+        if (key.length > 1) {
+            DerReader keyReader(key.data + 1, key.length - 1);
+            DerElement sequence, modulus;
+            if (keyReader.expect(TAG_SEQUENCE, sequence) && DerReader(sequence).expect(TAG_INTEGER, modulus)) {
+                info.keyBits = integerBits(modulus);
+            }
+        }
+    } else if (oidEquals(oid, OID_EC, sizeof(OID_EC) - 1)) {
+        info.keyType = "EC";
+        if (hasParameters && parameters.tag == TAG_OID) {
+            const char* curve = lookupOid(parameters, CURVE_NAMES);
+            info.curve = curve != nullptr ? curve : oidToString(parameters);
+        }
+        // 未压缩点: 0x04 || X || Y
+        if (key.length > 2) {
+            info.keyBits = static_cast<int>((key.length - 2) / 2 * 8);
+        }
+        if (info.curve == "P-521") {
+            info.keyBits = 521;
+        }
+    } else if (oidEquals(oid, OID_ED25519, sizeof(OID_ED25519) - 1)) {
+        info.keyType = "Ed25519";
+        info.keyBits = 256;
+    } else if (oidEquals(oid, OID_DSA, sizeof(OID_DSA) - 1)) {
+        info.keyType = "DSA";
+    } else {
+        info.keyType = oidToString(oid);
+    }
+}
+
+void parseExtensions(const DerElement& wrapper, CertificateInfo& info) {
+    DerElement extensions;
+    if (!DerReader(wrapper).expect(TAG_SEQUENCE, extensions)) {
+        return;
+    }
+
+    DerReader reader(extensions);
+    DerElement extension;
+    while (reader.next(extension)) {
+        DerReader fields(extension);
+        DerElement oid, value;
+        if (!fields.expect(TAG_OID, oid)) {
+            continue;
+        }
+        if (fields.peekTag(TAG_BOOLEAN)) {
+            DerElement critical;
+            fields.next(critical);
+        }
+        if (!fields.expect(TAG_OCTET_STRING, value) ||
+            !oidEquals(oid, OID_SUBJECT_ALT_NAME, sizeof(OID_SUBJECT_ALT_NAME) - 1)) {
+            continue;
+        }
+
+        DerElement names;
+        if (!DerReader(value).expect(TAG_SEQUENCE, names)) {
+            continue;
+        }
+        DerReader nameReader(names);
+        DerElement name;
+        while (nameReader.next(name)) {
+            if (name.tag == TAG_SAN_DNS) {
+                info.subjectAltNames.emplace_back(reinterpret_cast<const char*>(name.data), name.length);
+            } else if (name.tag == TAG_SAN_IP && name.length == 4) {
+                char buffer[16];
+                std::snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", name.data[0], name.data[1], name.data[2],
+                              name.data[3]);
+                info.subjectAltNames.push_back(buffer);
+            } else if (name.tag == TAG_SAN_IP && name.length == 16) {
+                std::string text;
+                for (size_t i = 0; i < 16; i += 2) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "%s%x", i == 0 ? "" : ":",
+                                  (name.data[i] << 8) | name.data[i + 1]);
+                    text += buffer;
+                }
+                info.subjectAltNames.push_back(text);
+            }
+        }
+    }
+}
+
+} // namespace
+
+std::string CertificateInfo::keyDescription() const {
+    if (keyType.empty()) {
+        return "";
+    }
+    if (!curve.empty()) {
+        return keyType + "-" + curve;
+    }
+    return keyBits > 0 ? keyType + "-" + std::to_string(keyBits) : keyType;
+}
+
+CertificateInfo parseCertificate(const std::string& der) {
+    CertificateInfo info;
+    DerReader top(reinterpret_cast<const uint8_t*>(der.data()), der.size());
+
+    // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }
+    DerElement certificate, tbs;
+    if (!top.expect(TAG_SEQUENCE, certificate) || !DerReader(certificate).expect(TAG_SEQUENCE, tbs)) {
+        return info;
+    }
+
+    DerReader fields(tbs);
+    DerElement element;
+    if (fields.peekTag(TAG_CONTEXT_0)) {
+        fields.next(element);       // version
+    }
+
+    DerElement serial, signature, issuer, validity, subject, spki;
+    if (!fields.expect(TAG_INTEGER, serial) || !fields.expect(TAG_SEQUENCE, signature) ||
+        !fields.expect(TAG_SEQUENCE, issuer) || !fields.expect(TAG_SEQUENCE, validity) ||
+        !fields.expect(TAG_SEQUENCE, subject) || !fields.expect(TAG_SEQUENCE, spki)) {
+        return info;
+    }
+
+    info.serialNumber = hexString(serial.data, serial.length);
+
+    DerElement signatureOid;
+    if (DerReader(signature).expect(TAG_OID, signatureOid)) {
+        const char* name = lookupOid(signatureOid, SIGNATURE_NAMES);
+        info.signatureAlgorithm = name != nullptr ? name : oidToString(signatureOid);
+    }
+
+    info.issuer = parseName(issuer, nullptr);
+    info.subject = parseName(subject, &info.commonName);
+    info.selfSigned = issuer.length == subject.length &&
+                      std::memcmp(issuer.data, subject.data, issuer.length) == 0;
+
+    DerReader validityReader(validity);
+    DerElement notBefore, notAfter;
+    int64_t notBeforeEpoch = 0;
+    if (validityReader.next(notBefore) && validityReader.next(notAfter)) {
+        parseTime(notBefore, info.notBefore, notBeforeEpoch);
+        parseTime(notAfter, info.notAfter, info.notAfterEpoch);
+    }
+
+    parsePublicKey(spki, info);
+
+    // 可选字段: issuerUniqueID [1]、subjectUniqueID [2]、extensions [3]
+    while (fields.next(element)) {
+        if (element.tag == TAG_CONTEXT_3) {
+            parseExtensions(element, info);
+        }
+    }
+
+    info.valid = true;
+    return info;
+}
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace MindSploit::Tls {
+
+// 证书中与资产识别相关的字段
+struct CertificateInfo {
+    bool valid = false;
+    std::string subject;                // CN=...,O=...,C=...
+    std::string issuer;
+    std::string commonName;
+    std::vector<std::string> subjectAltNames;   // DNS名称和IP地址
+    std::string serialNumber;           // 十六进制
+    std::string notBefore;              // YYYY-MM-DD HH:MM:SS (UTC)
+    std::string notAfter;
+    int64_t notAfterEpoch = 0;
+    std::string keyType;                // RSA / EC / Ed25519 / DSA
+    int keyBits = 0;
+    std::string curve;                  // EC曲线
+    std::string signatureAlgorithm;
+    bool selfSigned = false;            // subject与issuer相同
+
+    // 例如 RSA-2048、EC-P-256
+    std::string keyDescription() const;
+};
+
+// 解析DER编码的X.509证书，只提取上述字段，不做签名校验
+CertificateInfo parseCertificate(const std::string& der);
+
+} // namespace MindSploit::Tls
@@ -0,0 +1,286 @@
+#include "content_discovery.h"
+#include <algorithm>
+#include <random>
+
+namespace MindSploit::Web {
+
+namespace {
+
+constexpr std::string_view EXTENSION_PLACEHOLDER = "%EXT%";
+
+// 路径中的空白和控制字符按百分号编码，其余原样发送
+void appendEncoded(std::string& path, std::string_view text) {
+    static const char HEX[] = "0123456789ABCDEF";
+    for (unsigned char c : text) {
+        if (c <= 0x20 || c == 0x7f || c == '#') {
+            path += '%';
+            path += HEX[c >> 4];
+            path += HEX[c & 0x0f];
+        } else {
+            path += static_cast<char>(c);
+        }
+    }
+}
+
+} // namespace
+
+ContentDiscovery::ContentDiscovery(Utils::EventLoop& loop, HttpClient& client, const Utils::Wordlist& wordlist,
+                                   const ContentDiscoveryConfig& config)
+    : m_loop(loop), m_client(client), m_wordlist(wordlist), m_config(config) {
+    m_config.perHost = std::max<size_t>(1, m_config.perHost);
+    m_config.maxConsecutiveFailures = std::max<size_t>(1, m_config.maxConsecutiveFailures);
+    m_randomState = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+}
+
+ContentDiscovery::~ContentDiscovery() {
+    for (const auto& host : m_hosts) {
+        if (host->timer != 0) {
+            m_loop.cancelTimer(host->timer);
+        }
+    }
+}
+
+uint64_t ContentDiscovery::requestsPerHost() const {
+    const uint64_t extensions = m_config.extensions.size();
+    uint64_t total = 0;
+    size_t offset = 0;
+    std::string_view word;
+    while (m_wordlist.next(offset, word)) {
+        if (word.find(EXTENSION_PLACEHOLDER) != std::string_view::npos) {
+            total += extensions;
+        } else if (word.back() == '/') {
+            total += 1;
+        } else {
+            total += 1 + extensions;
+        }
+    }
+    return total;
+}
+
+void ContentDiscovery::discover(const WebEndpoint& endpoint, HitCallback onHit, DoneCallback onDone) {
+    auto host = std::make_shared<Host>();
+    host->endpoint = endpoint;
+    host->prefix = endpoint.path.empty() ? "/" : endpoint.path;
+    if (host->prefix.front() != '/') {
+        host->prefix.insert(host->prefix.begin(), '/');
+    }
+    if (host->prefix.back() != '/') {
+        host->prefix += '/';
+    }
+    host->onHit = std::move(onHit);
+    host->onDone = std::move(onDone);
+    host->started = Clock::now();
+    host->refilled = host->started;
+    host->filter = ResponseFilter(m_config.similarityThreshold, m_config.maxDuplicates);
+    m_hosts.push_back(host);
+
+    if (m_config.filterSoftNotFound) {
+        calibrate(host);
+    } else {
+        pump(host);
+    }
+}
+
+void ContentDiscovery::calibrate(const std::shared_ptr<Host>& host) {
+    // 随机路径: 普通文件、每个扩展名 (最多3个)、目录
+    static const char ALPHABET[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::string token;
+    for (int i = 0; i < 12; ++i) {
+        m_randomState = m_randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+        token += ALPHABET[(m_randomState >> 33) % (sizeof(ALPHABET) - 1)];
+    }
+
+    std::vector<std::string> paths = {host->prefix + token};
+    for (size_t i = 0; i < m_config.extensions.size() && i < 3; ++i) {
+        paths.push_back(host->prefix + token + "." + m_config.extensions[i]);
+    }
+    if (m_config.extensions.empty()) {
+        paths.push_back(host->prefix + token + ".html");
+    }
+    paths.push_back(host->prefix + token + "/");
+
+    host->calibrating = paths.size();
+    for (auto& path : paths) {
+        submit(host, std::move(path), true);
+    }
+}
+
+void ContentDiscovery::submit(const std::shared_ptr<Host>& host, std::string path, bool baseline) {
+    HttpRequest request;
+    request.address = Utils::IPAddress(host->endpoint.ip);
+    request.port = static_cast<uint16_t>(host->endpoint.port);
+    request.tls = host->endpoint.tls;
+    request.host = host->endpoint.host;
+    request.path = std::move(path);
+
+    ++host->inflight;
+    ++host->stats.requests;
+    m_client.submit(std::move(request), [this, host, baseline](const HttpRequest& req, const HttpResponse& resp) {
+        if (baseline) {
+            --host->inflight;
+            --host->calibrating;
+            if (resp.ok()) {
+                host->filter.addBaseline(ResponseSignature::of(resp, req.path));
+            }
+            if (host->calibrating == 0) {
+                host->stats.baselines = host->filter.baselineCount();
+                pump(host);
+            }
+            return;
+        }
+        onResponse(host, req, resp);
+    });
+}
+
+void ContentDiscovery::pump(const std::shared_ptr<Host>& host) {
+    if (host->calibrating > 0) {
+        return;
+    }
+    while (!host->exhausted && host->inflight < m_config.perHost) {
+        if (!takeToken(host)) {
+            return;
+        }
+        std::string path;
+        if (!nextPath(*host, path)) {
+            host->exhausted = true;
+            break;
+        }
+
+        submit(host, std::move(path), false);
+    }
+
+    if (host->exhausted && host->inflight == 0 && host->timer == 0) {
+        finish(host);
+    }
+}
+
+bool ContentDiscovery::takeToken(const std::shared_ptr<Host>& host) {
+    if (m_config.ratePerHost <= 0) {
+        return true;
+    }
+
+    // 令牌桶容量为1，请求在时间上均匀分布
+    auto now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - host->refilled).count();
+    host->tokens = std::min(1.0, host->tokens + seconds * m_config.ratePerHost);
+    host->refilled = now;
+    if (host->tokens >= 1.0) {
+        host->tokens -= 1.0;
+        return true;
+    }
+
+    if (host->timer == 0) {
+        auto wait = std::chrono::milliseconds(
+            static_cast<int64_t>((1.0 - host->tokens) / m_config.ratePerHost * 1000.0) + 1);
+        host->timer = m_loop.addTimer(wait, [this, host]() {
+            host->timer = 0;
+            pump(host);
+        });
+    }
+    return false;
+}
+
+bool ContentDiscovery::nextPath(Host& host, std::string& path) {
+    const auto& extensions = m_config.extensions;
+
+    while (host.variant >= host.variants) {
+        if (!m_wordlist.next(host.offset, host.word)) {
+            return false;
+        }
+        host.variant = 0;
+        if (host.word.find(EXTENSION_PLACEHOLDER) != std::string_view::npos) {
+            // 没有指定扩展名时跳过带占位符的词
+            host.variants = extensions.size();
+        } else if (host.word.back() == '/') {
+            host.variants = 1;
+        } else {
+            host.variants = 1 + extensions.size();
+        }
+    }
+
+    size_t variant = host.variant++;
+    std::string_view word = host.word;
+    if (word.front() == '/') {
+        word.remove_prefix(1);
+    }
+
+    path = host.prefix;
+    size_t placeholder = word.find(EXTENSION_PLACEHOLDER);
+    if (placeholder != std::string_view::npos) {
+        appendEncoded(path, word.substr(0, placeholder));
+        appendEncoded(path, extensions[variant]);
+        appendEncoded(path, word.substr(placeholder + EXTENSION_PLACEHOLDER.size()));
+    } else {
+        appendEncoded(path, word);
+        if (variant > 0) {
+            path += '.';
+            appendEncoded(path, extensions[variant - 1]);
+        }
+    }
+    return true;
+}
+
+void ContentDiscovery::onResponse(const std::shared_ptr<Host>& host, const HttpRequest& request,
+                                  const HttpResponse& response) {
+    --host->inflight;
+
+    if (!response.ok()) {
+        ++host->stats.failures;
+        // 端点持续无响应时放弃剩余字典，已发出的请求照常完成
+        if (++host->consecutiveFailures >= m_config.maxConsecutiveFailures && !host->exhausted) {
+            host->exhausted = true;
+            host->stats.abandoned = true;
+        }
+    } else {
+        host->consecutiveFailures = 0;
+        if (matches(response.status)) {
+            ResponseSignature signature = ResponseSignature::of(response, request.path);
+            auto verdict = m_config.filterSoftNotFound ? host->filter.classify(signature)
+                                                       : ResponseFilter::Verdict::UNIQUE;
+            if (verdict == ResponseFilter::Verdict::SOFT_NOT_FOUND) {
+                ++host->stats.softNotFound;
+            } else if (verdict == ResponseFilter::Verdict::DUPLICATE) {
+                ++host->stats.duplicates;
+            } else {
+                ContentHit hit;
+                hit.path = request.path;
+                hit.status = response.status;
+                hit.length = signature.length;
+                hit.location = std::string(response.header("Location"));
+                hit.simhash = signature.simhash;
+                hit.elapsed = response.elapsed;
+                ++host->stats.hits;
+                if (host->onHit) {
+                    host->onHit(host->endpoint, hit);
+                }
+            }
+        }
+    }
+
+    pump(host);
+}
+
+bool ContentDiscovery::matches(int status) const {
+    if (m_config.matchStatus.empty()) {
+        return status != 404;
+    }
+    return std::find(m_config.matchStatus.begin(), m_config.matchStatus.end(), status) !=
+           m_config.matchStatus.end();
+}
+
+void ContentDiscovery::finish(const std::shared_ptr<Host>& host) {
+    auto it = std::find(m_hosts.begin(), m_hosts.end(), host);
+    if (it == m_hosts.end()) {
+        return;
+    }
+    m_hosts.erase(it);
+
+    host->stats.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - host->started);
+    // 回调中可能继续discover下一个端点
+    DoneCallback onDone = std::move(host->onDone);
+    if (onDone) {
+        onDone(host->endpoint, host->stats);
+    }
+}
+
+} // namespace MindSploit::Web
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "web_engine.h"
+#include "http_client.h"
+#include "response_filter.h"
+#include "../../utils/wordlist.h"
+#include <memory>
+
+namespace MindSploit::Web {
+
+// 内容发现配置
+struct ContentDiscoveryConfig {
+    size_t perHost = 8;                         // 每个端点同时在途的请求数
+    double ratePerHost = 0;                     // 每个端点每秒请求数上限，0表示不限
+    std::vector<std::string> extensions;        // 扩展名 (不含点)，词中有%EXT%时替换，否则追加
+    std::vector<int> matchStatus;               // 报告的状态码，为空时报告404以外的全部响应
+    size_t maxConsecutiveFailures = 16;         // 连续请求失败达到此数时放弃该端点
+    bool filterSoftNotFound = true;             // 以随机路径的响应为基线过滤软404和重复响应
+    int similarityThreshold = ResponseFilter::DEFAULT_THRESHOLD;   // SimHash汉明距离阈值
+    size_t maxDuplicates = 8;                   // 同一簇的相似结果最多报告次数
+};
+
+// 一个发现结果
+struct ContentHit {
+    std::string path;
+    int status = 0;
+    size_t length = 0;
+    std::string location;                       // 重定向目标
+    uint64_t simhash = 0;
+    std::chrono::milliseconds elapsed{0};
+};
+
+// 单个端点的发现统计
+struct ContentDiscoveryStats {
+    uint64_t requests = 0;
+    uint64_t hits = 0;
+    uint64_t failures = 0;
+    uint64_t softNotFound = 0;                  // 与基线相似被过滤的响应
+    uint64_t duplicates = 0;                    // 同一簇超过上限被过滤的响应
+    size_t baselines = 0;
+    bool abandoned = false;                     // 因连续失败提前放弃
+    std::chrono::milliseconds elapsed{0};
+};
+
+// 目录和文件内容发现
+//
+// 字典只映射一次，所有端点共享同一份Wordlist，各端点只保存读取偏移和当前词的扩展序号，
+// 扩展名在取词时即时展开，不生成完整的路径列表。请求全部经由同一个HttpClient发送，
+// 同一端点的请求复用keep-alive连接池; 每个端点的在途请求数和请求速率分别限制，
+// 速率用令牌桶实现，令牌不足时挂定时器等待。
+// 开始遍历字典前先请求几个随机路径 (无扩展名、各扩展名、目录形式) 作为该端点和虚拟主机的
+// 软404基线，之后的响应经ResponseFilter按SimHash判定，与基线或已报告结果相似的不再报告。
+class ContentDiscovery {
+public:
+    using HitCallback = std::function<void(const WebEndpoint& endpoint, const ContentHit& hit)>;
+    using DoneCallback = std::function<void(const WebEndpoint& endpoint, const ContentDiscoveryStats& stats)>;
+
+    ContentDiscovery(Utils::EventLoop& loop, HttpClient& client, const Utils::Wordlist& wordlist,
+                     const ContentDiscoveryConfig& config);
+    ~ContentDiscovery();
+
+    ContentDiscovery(const ContentDiscovery&) = delete;
+    ContentDiscovery& operator=(const ContentDiscovery&) = delete;
+
+    void discover(const WebEndpoint& endpoint, HitCallback onHit, DoneCallback onDone);
+    // 进行中的端点数
+    size_t active() const { return m_hosts.size(); }
+    // 每个端点要发送的请求数 (遍历一次字典统计)
+    uint64_t requestsPerHost() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Host {
+        WebEndpoint endpoint;
+        std::string prefix;                     // 以'/'结尾的基础路径
+        HitCallback onHit;
+        DoneCallback onDone;
+        size_t offset = 0;                      // 字典读取偏移
+        std::string_view word;
+        size_t variant = 0;                     // 当前词的下一个展开序号
+        size_t variants = 0;
+        bool exhausted = false;
+        size_t inflight = 0;
+        size_t consecutiveFailures = 0;
+        size_t calibrating = 0;                 // 未完成的基线请求数
+        ResponseFilter filter;
+        double tokens = 1.0;
+        Clock::time_point refilled;
+        Utils::EventLoop::TimerId timer = 0;
+        Clock::time_point started;
+        ContentDiscoveryStats stats;
+    };
+
+    void calibrate(const std::shared_ptr<Host>& host);
+    void pump(const std::shared_ptr<Host>& host);
+    bool takeToken(const std::shared_ptr<Host>& host);
+    bool nextPath(Host& host, std::string& path);
+    void onResponse(const std::shared_ptr<Host>& host, const HttpRequest& request, const HttpResponse& response);
+    void submit(const std::shared_ptr<Host>& host, std::string path, bool baseline);
+    bool matches(int status) const;
+    void finish(const std::shared_ptr<Host>& host);
+
+private:
+    Utils::EventLoop& m_loop;
+    HttpClient& m_client;
+    const Utils::Wordlist& m_wordlist;
+    ContentDiscoveryConfig m_config;
+    std::vector<std::shared_ptr<Host>> m_hosts;
+    uint64_t m_randomState;
+};
+
+} // namespace MindSploit::Web
@@ -0,0 +1,463 @@
+#include "crawler.h"
+#include "html_tokenizer.h"
+#include <algorithm>
+#include <cctype>
+
+namespace MindSploit::Web {
+
+namespace {
+
+constexpr size_t MAX_PATH_LENGTH = 2048;
+constexpr auto MAX_BACKOFF = std::chrono::milliseconds(30000);
+
+// 只记录目录、不抓取的资源扩展名
+const std::unordered_set<std::string> ASSET_EXTENSIONS = {
+    "png", "jpg", "jpeg", "gif", "svg", "ico", "webp", "bmp", "css", "js", "mjs", "map",
+    "woff", "woff2", "ttf", "eot", "otf", "mp3", "mp4", "webm", "avi", "mov", "pdf",
+    "zip", "gz", "tgz", "rar", "7z", "exe", "dmg", "iso"
+};
+
+std::string toLower(std::string_view text) {
+    std::string value(text);
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+std::string hostKey(bool tls, std::string_view host, int port) {
+    return std::string(tls ? "https://" : "http://") + toLower(host) + ":" + std::to_string(port);
+}
+
+// authority (userinfo@host:port) -> 主机键
+std::string authorityKey(bool tls, std::string_view authority) {
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority.remove_prefix(at + 1);
+    }
+    int port = tls ? 443 : 80;
+    std::string_view host = authority;
+    size_t colon = authority.rfind(':');
+    size_t bracket = authority.rfind(']');
+    if (colon != std::string_view::npos && (bracket == std::string_view::npos || colon > bracket)) {
+        host = authority.substr(0, colon);
+        port = 0;
+        for (char c : authority.substr(colon + 1)) {
+            if (!std::isdigit(static_cast<unsigned char>(c)) || port > 65535) {
+                return "";
+            }
+            port = port * 10 + (c - '0');
+        }
+        if (colon + 1 == authority.size()) {
+            port = tls ? 443 : 80;
+        }
+    }
+    return hostKey(tls, host, port);
+}
+
+// 去掉 . 和 .. 路径段，查询串保持不变
+std::string normalizePath(std::string_view path) {
+    std::string_view query;
+    size_t queryPos = path.find('?');
+    if (queryPos != std::string_view::npos) {
+        query = path.substr(queryPos);
+        path = path.substr(0, queryPos);
+    }
+
+    std::vector<std::string_view> segments;
+    size_t pos = 1;
+    const bool trailingSlash = path.empty() || path.back() == '/';
+    bool directory = false;
+    while (pos <= path.size()) {
+        size_t next = path.find('/', pos);
+        if (next == std::string_view::npos) {
+            next = path.size();
+        }
+        std::string_view segment = path.substr(pos, next - pos);
+        if (segment == "..") {
+            if (!segments.empty()) {
+                segments.pop_back();
+            }
+            directory = true;
+        } else if (segment == ".") {
+            directory = true;
+        } else if (!segment.empty()) {
+            segments.push_back(segment);
+            directory = false;
+        }
+        pos = next + 1;
+    }
+    directory = directory || trailingSlash;
+
+    std::string normalized;
+    for (const auto& segment : segments) {
+        normalized += '/';
+        normalized += segment;
+    }
+    if (normalized.empty() || directory) {
+        normalized += '/';
+    }
+    normalized += query;
+    return normalized;
+}
+
+// 空白、控制字符和非ASCII字节按百分号编码，&amp;还原为&
+std::string encodePath(std::string_view path) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(path.size());
+    for (size_t i = 0; i < path.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(path[i]);
+        if (c == '&' && path.compare(i, 5, "&amp;") == 0) {
+            encoded += '&';
+            i += 4;
+        } else if (c <= 0x20 || c >= 0x7f) {
+            encoded += '%';
+            encoded += HEX[c >> 4];
+            encoded += HEX[c & 0x0f];
+        } else {
+            encoded += static_cast<char>(c);
+        }
+    }
+    return encoded;
+}
+
+bool isAsset(std::string_view path) {
+    path = path.substr(0, path.find('?'));
+    size_t slash = path.rfind('/');
+    size_t dot = path.rfind('.');
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+        return false;
+    }
+    return ASSET_EXTENSIONS.count(toLower(path.substr(dot + 1))) > 0;
+}
+
+bool isHtml(const HttpResponse& response) {
+    std::string_view type = response.header("Content-Type");
+    if (!type.empty()) {
+        return toLower(type).find("html") != std::string::npos;
+    }
+    std::string_view body = trim(response.body());
+    return !body.empty() && body.front() == '<';
+}
+
+} // namespace
+
+Crawler::Crawler(Utils::EventLoop& loop, HttpClient& client, const CrawlerConfig& config)
+    : m_loop(loop), m_client(client), m_config(config),
+      m_seen(config.expectedUrls, config.falsePositiveRate, config.maxFilterBytes) {
+    m_config.perHost = std::max<size_t>(1, m_config.perHost);
+    m_config.concurrency = std::max<size_t>(1, m_config.concurrency);
+}
+
+Crawler::~Crawler() {
+    for (const auto& host : m_hosts) {
+        if (host->timer != 0) {
+            m_loop.cancelTimer(host->timer);
+        }
+    }
+}
+
+size_t Crawler::addHost(const WebEndpoint& endpoint) {
+    std::string name = endpoint.host;
+    if (name.empty()) {
+        name = endpoint.ip.find(':') != std::string::npos ? "[" + endpoint.ip + "]" : endpoint.ip;
+        name += ":" + std::to_string(endpoint.port);
+    }
+    std::string key = authorityKey(endpoint.tls, name);
+
+    size_t id;
+    auto it = m_hostIndex.find(key);
+    if (it != m_hostIndex.end()) {
+        id = it->second;
+    } else {
+        auto host = std::make_unique<Host>();
+        host->endpoint = endpoint;
+        host->key = key;
+        host->nextAllowed = Clock::now();
+        id = m_hosts.size();
+        m_hosts.push_back(std::move(host));
+        m_hostIndex.emplace(key, id);
+    }
+
+    std::string path = endpoint.path.empty() ? "/" : endpoint.path;
+    if (path.front() != '/') {
+        path.insert(path.begin(), '/');
+    }
+    enqueue(id, normalizePath(path), 0);
+    return id;
+}
+
+void Crawler::start(PageCallback onPage) {
+    m_onPage = std::move(onPage);
+    pump();
+}
+
+void Crawler::stop() {
+    m_stopped = true;
+}
+
+bool Crawler::active() const {
+    return m_inflight > 0 || (!m_stopped && m_queued > 0 && m_stats.pages < m_config.maxPages);
+}
+
+void Crawler::schedule(size_t id) {
+    Host& host = *m_hosts[id];
+    if (!host.ready && !host.queue.empty() && host.inflight < m_config.perHost) {
+        host.ready = true;
+        m_ready.push_back(id);
+    }
+}
+
+void Crawler::pump() {
+    while (!m_ready.empty() && !m_stopped && m_client.outstanding() < m_config.concurrency &&
+           m_stats.pages < m_config.maxPages) {
+        size_t id = m_ready.front();
+        m_ready.pop_front();
+        Host& host = *m_hosts[id];
+        host.ready = false;
+        if (host.queue.empty() || host.inflight >= m_config.perHost || host.timer != 0) {
+            continue;
+        }
+
+        auto now = Clock::now();
+        if (now < host.nextAllowed) {
+            // 间隔未到，到时间后重新进入就绪队列
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(host.nextAllowed - now) +
+                        std::chrono::milliseconds(1);
+            host.timer = m_loop.addTimer(wait, [this, id]() {
+                m_hosts[id]->timer = 0;
+                schedule(id);
+                pump();
+            });
+            continue;
+        }
+
+        fetch(id);
+        // 轮转: 还能发请求的主机排到队尾
+        schedule(id);
+    }
+}
+
+void Crawler::fetch(size_t id) {
+    Host& host = *m_hosts[id];
+    Entry entry = std::move(host.queue.front());
+    host.queue.pop_front();
+    --m_queued;
+    ++host.inflight;
+    ++m_inflight;
+    ++host.pages;
+    ++m_stats.pages;
+    host.nextAllowed = Clock::now() + m_config.delay + host.backoff;
+
+    HttpRequest request;
+    request.address = Utils::IPAddress(host.endpoint.ip);
+    request.port = static_cast<uint16_t>(host.endpoint.port);
+    request.tls = host.endpoint.tls;
+    request.host = host.endpoint.host;
+    request.path = entry.path;
+    m_client.submit(std::move(request), [this, id, entry](const HttpRequest& req, const HttpResponse& resp) {
+        onResponse(id, entry, req, resp);
+    });
+}
+
+void Crawler::onResponse(size_t id, const Entry& entry, const HttpRequest& request, const HttpResponse& response) {
+    Host& host = *m_hosts[id];
+    --host.inflight;
+    --m_inflight;
+
+    CrawlPage page;
+    page.host = id;
+    page.path = request.path;
+    page.depth = entry.depth;
+    page.elapsed = response.elapsed;
+
+    if (!response.ok()) {
+        ++m_stats.failures;
+        page.error = response.error;
+    } else {
+        page.status = response.status;
+        page.length = response.body().size();
+
+        // 限流或过载时退避，恢复后逐步取消
+        if (response.status == 429 || response.status == 503) {
+            host.backoff = std::min(MAX_BACKOFF, std::max(std::chrono::milliseconds(1000), host.backoff * 2));
+            host.nextAllowed = Clock::now() + m_config.delay + host.backoff;
+        } else if (host.backoff.count() > 0) {
+            host.backoff /= 2;
+        }
+
+        if (!m_stopped) {
+            std::string_view location = response.header("Location");
+            if (response.status >= 300 && response.status < 400 && !location.empty()) {
+                // 重定向不算一层链接
+                size_t links = 0;
+                if (follow(id, request.path, location, entry.depth, links)) {
+                    ++page.queued;
+                }
+                page.links = links;
+            } else if (response.status >= 200 && response.status < 300 && entry.depth < m_config.maxDepth &&
+                       isHtml(response)) {
+                page.links = extractLinks(id, entry, response.body(), page.queued);
+            }
+        }
+    }
+
+    if (m_onPage) {
+        m_onPage(page, response);
+    }
+    schedule(id);
+    pump();
+}
+
+size_t Crawler::extractLinks(size_t id, const Entry& entry, std::string_view html, size_t& queued) {
+    // <base href>只改变相对链接的基准，同样只接受种子主机
+    std::string base = entry.path;
+    size_t baseHost = id;
+
+    size_t links = 0;
+    HtmlTokenizer tokenizer(html);
+    HtmlTag tag;
+    std::string_view value;
+    while (tokenizer.next(tag)) {
+        bool found = false;
+        if (tag.is("a") || tag.is("link") || tag.is("area")) {
+            found = tag.attribute("href", value);
+        } else if (tag.is("script") || tag.is("img") || tag.is("iframe") || tag.is("frame") ||
+                   tag.is("source") || tag.is("embed")) {
+            found = tag.attribute("src", value);
+        } else if (tag.is("form")) {
+            found = tag.attribute("action", value);
+        } else if (tag.is("base") && tag.attribute("href", value)) {
+            std::string_view href = trim(value);
+            if (href.find("://") != std::string_view::npos) {
+                size_t authorityStart = href.find("://") + 3;
+                size_t pathStart = href.find('/', authorityStart);
+                bool tls = toLower(href.substr(0, authorityStart - 3)) == "https";
+                auto it = m_hostIndex.find(authorityKey(tls, href.substr(authorityStart, pathStart - authorityStart)));
+                if (it == m_hostIndex.end()) {
+                    // 基准指向种子以外的主机，相对链接都不可抓取
+                    return links;
+                }
+                baseHost = it->second;
+                base = pathStart == std::string_view::npos ? "/" : std::string(href.substr(pathStart));
+            } else if (!href.empty() && href.front() == '/') {
+                base = std::string(href);
+            }
+            continue;
+        }
+        if (!found) {
+            continue;
+        }
+        if (follow(baseHost, base, value, entry.depth + 1, links)) {
+            ++queued;
+        }
+    }
+    return links;
+}
+
+bool Crawler::follow(size_t id, std::string_view base, std::string_view href, size_t depth, size_t& links) {
+    href = trim(href);
+    href = href.substr(0, href.find('#'));
+    if (href.empty()) {
+        return false;
+    }
+
+    // scheme: 只跟随http(s)，mailto:、javascript:、data:等忽略
+    size_t target = id;
+    std::string path;
+    size_t colon = href.find(':');
+    size_t delimiter = href.find_first_of("/?");
+    bool hasScheme = colon != std::string_view::npos && (delimiter == std::string_view::npos || colon < delimiter);
+    if (hasScheme || href.compare(0, 2, "//") == 0) {
+        bool tls = m_hosts[id]->endpoint.tls;
+        if (hasScheme) {
+            std::string scheme = toLower(href.substr(0, colon));
+            if (scheme != "http" && scheme != "https") {
+                return false;
+            }
+            tls = scheme == "https";
+            href.remove_prefix(colon + 1);
+        }
+        if (href.compare(0, 2, "//") != 0) {
+            return false;
+        }
+        href.remove_prefix(2);
+        size_t pathStart = href.find_first_of("/?");
+        auto it = m_hostIndex.find(authorityKey(tls, href.substr(0, pathStart)));
+        if (it == m_hostIndex.end()) {
+            ++m_stats.external;
+            return false;
+        }
+        target = it->second;
+        path = pathStart == std::string_view::npos ? "/" : std::string(href.substr(pathStart));
+        if (path.front() == '?') {
+            path.insert(path.begin(), '/');
+        }
+    } else if (href.front() == '/') {
+        path = std::string(href);
+    } else if (href.front() == '?') {
+        path = std::string(base.substr(0, base.find('?'))) + std::string(href);
+    } else {
+        std::string_view directory = base.substr(0, base.find('?'));
+        directory = directory.substr(0, directory.rfind('/') + 1);
+        path = std::string(directory) + std::string(href);
+    }
+
+    ++links;
+    ++m_stats.links;
+    path = normalizePath(encodePath(path));
+    if (path.size() > MAX_PATH_LENGTH) {
+        ++m_stats.dropped;
+        return false;
+    }
+    return depth <= m_config.maxDepth && enqueue(target, std::move(path), depth);
+}
+
+bool Crawler::enqueue(size_t id, std::string path, size_t depth) {
+    Host& host = *m_hosts[id];
+    if (!m_seen.insert(host.key + path)) {
+        ++m_stats.duplicates;
+        return false;
+    }
+    recordDirectories(host, path);
+    if (isAsset(path)) {
+        ++m_stats.assets;
+        return false;
+    }
+    if (host.queue.size() >= m_config.maxQueuedPerHost) {
+        ++m_stats.dropped;
+        return false;
+    }
+
+    host.queue.push_back({std::move(path), depth});
+    ++m_queued;
+    ++m_stats.queued;
+    schedule(id);
+    return true;
+}
+
+void Crawler::recordDirectories(Host& host, std::string_view path) {
+    path = path.substr(0, path.find('?'));
+    // 每一级父目录都记录，根目录除外
+    for (size_t slash = path.find('/', 1); slash != std::string_view::npos; slash = path.find('/', slash + 1)) {
+        if (host.directories.size() >= m_config.maxDirectoriesPerHost) {
+            return;
+        }
+        std::string directory(path.substr(0, slash + 1));
+        if (host.directorySet.insert(directory).second) {
+            host.directories.push_back(std::move(directory));
+        }
+    }
+}
+
+} // namespace MindSploit::Web
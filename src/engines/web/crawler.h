@@ -0,0 +1,132 @@
+#pragma once
+
+#include "web_engine.h"
+#include "http_client.h"
+#include "../../utils/bloom_filter.h"
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace MindSploit::Web {
+
+// 爬虫配置
+struct CrawlerConfig {
+    size_t maxDepth = 3;                        // 从种子页面起的链接层数
+    uint64_t maxPages = 10000;                  // 全部主机抓取的页面总数上限
+    size_t concurrency = 1000;                  // 全部主机同时在途的请求上限
+    size_t perHost = 2;                         // 每个主机同时在途的请求上限
+    std::chrono::milliseconds delay{0};         // 同一主机相邻两次请求的最小间隔
+    size_t maxQueuedPerHost = 10000;            // 每个主机待抓取队列上限，超出的链接丢弃
+    size_t maxDirectoriesPerHost = 256;         // 每个主机记录的目录数上限
+    size_t expectedUrls = 1 << 16;              // URL去重过滤器的初始容量
+    double falsePositiveRate = 0.001;
+    size_t maxFilterBytes = 64 << 20;           // URL去重过滤器的内存上限
+};
+
+// 一个抓取结果
+struct CrawlPage {
+    size_t host = 0;
+    std::string path;
+    size_t depth = 0;
+    int status = 0;
+    size_t length = 0;
+    size_t links = 0;                           // 页面中指向可抓取主机的链接数
+    size_t queued = 0;                          // 其中新加入队列的
+    std::string error;
+    std::chrono::milliseconds elapsed{0};
+};
+
+struct CrawlerStats {
+    uint64_t pages = 0;
+    uint64_t failures = 0;
+    uint64_t links = 0;
+    uint64_t queued = 0;
+    uint64_t duplicates = 0;                    // 去重过滤器判定已见过的链接
+    uint64_t external = 0;                      // 指向种子以外主机的链接
+    uint64_t assets = 0;                        // 图片、样式、脚本等只记录目录不抓取的链接
+    uint64_t dropped = 0;                       // 队列已满丢弃的链接
+};
+
+// 多主机爬虫
+//
+// 只抓取种子所在的主机 (scheme://host:port 相同)，链接用HtmlTokenizer提取:
+//   - URL去重用一个全部主机共享的ScalableBloomFilter，内存有上限，不保存URL本身
+//   - 每个主机一个待抓取队列，限制在途请求数和相邻请求间隔，429/503时退避;
+//     可以发请求的主机在一个就绪队列中轮转，调度代价与主机数量无关
+//   - 全部在途请求受concurrency限制，请求经由共享的HttpClient复用连接
+// 抓到的页面和链接所在的目录按主机记录，供内容发现作为额外的扫描起点。
+class Crawler {
+public:
+    using PageCallback = std::function<void(const CrawlPage& page, const HttpResponse& response)>;
+
+    Crawler(Utils::EventLoop& loop, HttpClient& client, const CrawlerConfig& config);
+    ~Crawler();
+
+    Crawler(const Crawler&) = delete;
+    Crawler& operator=(const Crawler&) = delete;
+
+    // 加入种子端点 (从endpoint.path开始抓取)，返回主机编号; 必须在start之前调用
+    size_t addHost(const WebEndpoint& endpoint);
+    void start(PageCallback onPage);
+    void stop();
+    // 还有在途请求或可抓取的队列
+    bool active() const;
+
+    size_t hostCount() const { return m_hosts.size(); }
+    const WebEndpoint& endpoint(size_t host) const { return m_hosts[host]->endpoint; }
+    uint64_t pages(size_t host) const { return m_hosts[host]->pages; }
+    // 主机上发现的目录 (以'/'结尾，按发现顺序)
+    const std::vector<std::string>& directories(size_t host) const { return m_hosts[host]->directories; }
+
+    const CrawlerStats& stats() const { return m_stats; }
+    size_t filterBytes() const { return m_seen.memoryBytes(); }
+    bool filterSaturated() const { return m_seen.saturated(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string path;
+        size_t depth = 0;
+    };
+
+    struct Host {
+        WebEndpoint endpoint;
+        std::string key;                        // scheme://host:port
+        std::deque<Entry> queue;
+        size_t inflight = 0;
+        bool ready = false;                     // 在就绪队列中
+        Clock::time_point nextAllowed;
+        std::chrono::milliseconds backoff{0};
+        Utils::EventLoop::TimerId timer = 0;
+        uint64_t pages = 0;
+        std::vector<std::string> directories;
+        std::unordered_set<std::string> directorySet;
+    };
+
+    void pump();
+    void schedule(size_t host);
+    void fetch(size_t host);
+    void onResponse(size_t host, const Entry& entry, const HttpRequest& request, const HttpResponse& response);
+    // 解析页面中的链接并入队，返回指向可抓取主机的链接数
+    size_t extractLinks(size_t host, const Entry& entry, std::string_view html, size_t& queued);
+    bool follow(size_t host, std::string_view base, std::string_view href, size_t depth, size_t& links);
+    bool enqueue(size_t host, std::string path, size_t depth);
+    void recordDirectories(Host& host, std::string_view path);
+
+private:
+    Utils::EventLoop& m_loop;
+    HttpClient& m_client;
+    CrawlerConfig m_config;
+    PageCallback m_onPage;
+    std::vector<std::unique_ptr<Host>> m_hosts;
+    std::unordered_map<std::string, size_t> m_hostIndex;
+    std::deque<size_t> m_ready;
+    Utils::ScalableBloomFilter m_seen;
+    size_t m_inflight = 0;
+    size_t m_queued = 0;
+    bool m_stopped = false;
+    CrawlerStats m_stats;
+};
+
+} // namespace MindSploit::Web
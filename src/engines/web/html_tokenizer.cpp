@@ -0,0 +1,201 @@
+#include "html_tokenizer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINDSPLOIT_HTML_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace MindSploit::Web {
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+#ifdef MINDSPLOIT_HTML_SSE2
+inline unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// 从pos开始查找'<'，不存在时返回npos
+size_t findTagOpen(std::string_view html, size_t pos) {
+    const char* p = html.data() + pos;
+    const char* end = html.data() + html.size();
+#ifdef MINDSPLOIT_HTML_SSE2
+    const __m128i open = _mm_set1_epi8('<');
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, open)));
+        if (mask != 0) {
+            return static_cast<size_t>(p - html.data()) + lowestBit(mask);
+        }
+        p += 16;
+    }
+#endif
+    const void* found = std::memchr(p, '<', static_cast<size_t>(end - p));
+    return found != nullptr ? static_cast<size_t>(static_cast<const char*>(found) - html.data())
+                            : std::string_view::npos;
+}
+
+// 标签结束的'>'，引号内的'>'不算
+size_t findTagClose(std::string_view html, size_t pos) {
+    char quote = 0;
+    for (; pos < html.size(); ++pos) {
+        char c = html[pos];
+        if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return pos;
+        }
+    }
+    return std::string_view::npos;
+}
+
+bool isRawTextElement(std::string_view name) {
+    return equalsIgnoreCase(name, "script") || equalsIgnoreCase(name, "style") ||
+           equalsIgnoreCase(name, "textarea") || equalsIgnoreCase(name, "xmp");
+}
+
+} // namespace
+
+bool HtmlTag::is(std::string_view lowerName) const {
+    return equalsIgnoreCase(name, lowerName);
+}
+
+bool HtmlTag::attribute(std::string_view lowerName, std::string_view& value) const {
+    std::string_view text = attributes;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && (isSpace(text[i]) || text[i] == '/')) {
+            ++i;
+        }
+        size_t nameStart = i;
+        while (i < text.size() && text[i] != '=' && text[i] != '/' && !isSpace(text[i])) {
+            ++i;
+        }
+        std::string_view name = text.substr(nameStart, i - nameStart);
+        while (i < text.size() && isSpace(text[i])) {
+            ++i;
+        }
+
+        std::string_view current;
+        if (i < text.size() && text[i] == '=') {
+            ++i;
+            while (i < text.size() && isSpace(text[i])) {
+                ++i;
+            }
+            if (i < text.size() && (text[i] == '"' || text[i] == '\'')) {
+                char quote = text[i++];
+                size_t close = text.find(quote, i);
+                if (close == std::string_view::npos) {
+                    close = text.size();
+                }
+                current = text.substr(i, close - i);
+                i = close + 1;
+            } else {
+                size_t valueStart = i;
+                while (i < text.size() && !isSpace(text[i])) {
+                    ++i;
+                }
+                current = text.substr(valueStart, i - valueStart);
+            }
+        }
+
+        if (!name.empty() && equalsIgnoreCase(name, lowerName)) {
+            value = current;
+            return true;
+        }
+        if (name.empty() && i < text.size()) {
+            ++i;
+        }
+    }
+    return false;
+}
+
+bool HtmlTokenizer::next(HtmlTag& tag) {
+    while (m_pos < m_html.size()) {
+        size_t open = findTagOpen(m_html, m_pos);
+        if (open == std::string_view::npos || open + 1 >= m_html.size()) {
+            m_pos = m_html.size();
+            return false;
+        }
+
+        char first = m_html[open + 1];
+        if (m_html.compare(open, 4, "<!--") == 0) {
+            size_t close = m_html.find("-->", open + 4);
+            m_pos = close == std::string_view::npos ? m_html.size() : close + 3;
+            continue;
+        }
+        if (first == '!' || first == '/' || first == '?') {
+            size_t close = m_html.find('>', open + 2);
+            m_pos = close == std::string_view::npos ? m_html.size() : close + 1;
+            continue;
+        }
+        if (!std::isalpha(static_cast<unsigned char>(first))) {
+            // 文本中的'<'
+            m_pos = open + 1;
+            continue;
+        }
+
+        size_t nameEnd = open + 1;
+        while (nameEnd < m_html.size() &&
+               (std::isalnum(static_cast<unsigned char>(m_html[nameEnd])) || m_html[nameEnd] == '-' ||
+                m_html[nameEnd] == ':')) {
+            ++nameEnd;
+        }
+        size_t close = findTagClose(m_html, nameEnd);
+        if (close == std::string_view::npos) {
+            m_pos = m_html.size();
+            return false;
+        }
+
+        tag.name = m_html.substr(open + 1, nameEnd - open - 1);
+        tag.attributes = m_html.substr(nameEnd, close - nameEnd);
+        m_pos = isRawTextElement(tag.name) ? skipRawText(close + 1, tag.name) : close + 1;
+        return true;
+    }
+    return false;
+}
+
+size_t HtmlTokenizer::skipRawText(size_t pos, std::string_view name) const {
+    // 查找对应的结束标签 </name
+    while (true) {
+        size_t open = findTagOpen(m_html, pos);
+        if (open == std::string_view::npos) {
+            return m_html.size();
+        }
+        if (open + 2 + name.size() <= m_html.size() && m_html[open + 1] == '/' &&
+            equalsIgnoreCase(m_html.substr(open + 2, name.size()), name)) {
+            return open;
+        }
+        pos = open + 1;
+    }
+}
+
+} // namespace MindSploit::Web
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string_view>
+#include <cstddef>
+
+namespace MindSploit::Web {
+
+// 一个HTML开始标签
+struct HtmlTag {
+    std::string_view name;                      // 标签名原文
+    std::string_view attributes;                // 标签名之后到'>'之前的原文
+
+    // 标签名比较 (不区分大小写)
+    bool is(std::string_view lowerName) const;
+    // 查找属性值 (属性名不区分大小写)，不存在时返回false; 没有值的属性返回空值
+    bool attribute(std::string_view lowerName, std::string_view& value) const;
+};
+
+// 只提取开始标签的HTML扫描器
+//
+// 不构建DOM也不解码实体，只为链接提取和指纹识别找出开始标签及其属性区:
+//   - 用SSE2按16字节查找'<'，标签之间的文本不逐字节处理
+//   - 注释、结束标签、<!DOCTYPE>和处理指令整体跳过
+//   - <script>、<style>等原始文本元素的内容跳过，内联脚本中的'<'不会被当作标签
+//   - 属性值中的'>'按引号处理
+// 所有结果都是输入的视图，扫描期间输入必须保持有效。
+class HtmlTokenizer {
+public:
+    explicit HtmlTokenizer(std::string_view html) : m_html(html) {}
+
+    // 下一个开始标签，没有时返回false
+    bool next(HtmlTag& tag);
+
+private:
+    size_t skipRawText(size_t pos, std::string_view name) const;
+
+private:
+    std::string_view m_html;
+    size_t m_pos = 0;
+};
+
+} // namespace MindSploit::Web
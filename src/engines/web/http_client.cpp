@@ -0,0 +1,855 @@
+#include "http_client.h"
+#include "../../utils/socket_budget.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace MindSploit::Web {
+
+namespace {
+
+// 未开始接收响应的请求在连接意外关闭时最多重试的次数
+constexpr int MAX_RETRIES = 1;
+constexpr std::chrono::milliseconds SWEEP_INTERVAL{200};
+constexpr size_t RECEIVE_CHUNK = 64 * 1024;
+// 同一主机连续因代理故障失败的连接数上限，超过后按连接失败处理
+constexpr size_t MAX_PROXY_FAILURES = 3;
+
+int lastSocketError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+bool wouldBlock(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+}
+
+bool connectInProgress(int error) {
+#ifdef _WIN32
+    return error == WSAEWOULDBLOCK;
+#else
+    return error == EINPROGRESS;
+#endif
+}
+
+bool isIdempotent(const std::string& method) {
+    return method == "GET" || method == "HEAD" || method == "OPTIONS";
+}
+
+std::string defaultHost(const HttpRequest& request) {
+    std::string host = request.address.isIPv6 ? "[" + request.address.address + "]" : request.address.address;
+    if (request.port != (request.tls ? 443 : 80)) {
+        host += ":" + std::to_string(request.port);
+    }
+    return host;
+}
+
+// Host首部去掉端口和IPv6方括号后作为SNI
+std::string serverNameOf(const std::string& host) {
+    if (!host.empty() && host.front() == '[') {
+        size_t end = host.find(']');
+        return end == std::string::npos ? host : host.substr(1, end - 1);
+    }
+    size_t colon = host.find(':');
+    return colon == std::string::npos ? host : host.substr(0, colon);
+}
+
+} // namespace
+
+HttpClient::HttpClient(Utils::EventLoop& loop, const HttpClientConfig& config)
+    : m_loop(loop), m_config(config) {
+    m_config.maxConnections = std::max<size_t>(1, m_config.maxConnections);
+    m_config.maxConnectionsPerHost = std::max<size_t>(1, m_config.maxConnectionsPerHost);
+    m_config.pipelineDepth = std::max<size_t>(1, m_config.pipelineDepth);
+    m_config.maxRequestsPerConnection = std::max<size_t>(1, m_config.maxRequestsPerConnection);
+}
+
+HttpClient::~HttpClient() {
+    cancelAll("HTTP client destroyed");
+    if (m_sweepTimer != 0) {
+        m_loop.cancelTimer(m_sweepTimer);
+    }
+}
+
+void HttpClient::submit(HttpRequest request, Callback callback) {
+    if (request.host.empty()) {
+        request.host = defaultHost(request);
+    }
+
+    Pending pending;
+    pending.request = std::move(request);
+    pending.callback = std::move(callback);
+    pending.submitted = Clock::now();
+
+    ++m_outstanding;
+    ++m_stats.requests;
+
+    HostPool& pool = poolFor(pending.request);
+    pool.queue.push_back(std::move(pending));
+    dispatch(pool);
+    scheduleSweep();
+}
+
+void HttpClient::run(const std::atomic<bool>& stopRequested) {
+    while (!stopRequested && m_outstanding > 0) {
+        m_loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (stopRequested) {
+        cancelAll("Request cancelled");
+    }
+}
+
+void HttpClient::cancelAll(const std::string& reason) {
+    m_cancelling = true;
+
+    std::vector<int> fds;
+    fds.reserve(m_connections.size());
+    for (const auto& entry : m_connections) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        auto it = m_connections.find(fd);
+        if (it != m_connections.end()) {
+            closeConnection(*it->second, reason, true);
+        }
+    }
+    for (HostPool* pool : snapshotPools()) {
+        failQueue(*pool, reason);
+    }
+    m_waitingPools.clear();
+
+    m_cancelling = false;
+}
+
+HttpClient::HostPool& HttpClient::poolFor(const HttpRequest& request) {
+    std::string key = request.address.address + "|" + std::to_string(request.port);
+    if (request.tls) {
+        // 不同SNI对应不同的证书和会话，分开建池
+        key += "|tls|" + serverNameOf(request.host);
+    }
+    auto it = m_pools.find(key);
+    if (it != m_pools.end()) {
+        return *it->second;
+    }
+
+    auto pool = std::make_unique<HostPool>();
+    pool->key = key;
+    pool->address = request.address;
+    pool->port = request.port;
+    pool->tls = request.tls;
+    if (request.tls) {
+        pool->serverName = serverNameOf(request.host);
+    }
+    HostPool& ref = *pool;
+    m_pools[key] = std::move(pool);
+    return ref;
+}
+
+void HttpClient::dispatch(HostPool& pool) {
+    if (m_cancelling) {
+        return;
+    }
+
+    while (!pool.queue.empty()) {
+        const Pending& next = pool.queue.front();
+        Connection* target = nullptr;
+
+        // 1. 空闲连接
+        for (Connection* conn : pool.connections) {
+            if (conn->connected && !conn->closing && conn->inflight.empty() &&
+                conn->served < m_config.maxRequestsPerConnection) {
+                target = conn;
+                break;
+            }
+        }
+
+        // 2. 流水线: 选择在途请求最少的连接
+        if (target == nullptr) {
+            for (Connection* conn : pool.connections) {
+                if (canPipeline(*conn, next) &&
+                    (target == nullptr || conn->inflight.size() < target->inflight.size())) {
+                    target = conn;
+                }
+            }
+        }
+
+        if (target != nullptr) {
+            Pending pending = std::move(pool.queue.front());
+            pool.queue.pop_front();
+            sendRequest(*target, std::move(pending));
+            continue;
+        }
+
+        // 3. 新建连接: 正在建立的连接已足以承接排队请求时不再新建
+        if (pool.connecting >= pool.queue.size() ||
+            pool.connections.size() >= m_config.maxConnectionsPerHost) {
+            break;
+        }
+
+        OpenResult result = m_connections.size() >= m_config.maxConnections
+                                ? OpenResult::NO_CAPACITY
+                                : openConnection(pool);
+        if (result == OpenResult::OPENED) {
+            continue;
+        }
+        if (result == OpenResult::NO_CAPACITY) {
+            if (!pool.waiting) {
+                pool.waiting = true;
+                m_waitingPools.push_back(&pool);
+            }
+        } else if (pool.connections.empty() && !pool.everConnected) {
+            failQueue(pool, "Connection failed");
+        }
+        break;
+    }
+}
+
+bool HttpClient::canPipeline(const Connection& conn, const Pending& pending) const {
+    if (m_config.pipelineDepth <= 1 || !conn.connected || !conn.reusable || conn.closing ||
+        conn.pool->pipelineBroken) {
+        return false;
+    }
+    if (conn.inflight.size() >= m_config.pipelineDepth ||
+        conn.served + conn.inflight.size() >= m_config.maxRequestsPerConnection) {
+        return false;
+    }
+    // 只流水线幂等请求，且前面在途的请求也必须是幂等的
+    if (!isIdempotent(pending.request.method)) {
+        return false;
+    }
+    return std::all_of(conn.inflight.begin(), conn.inflight.end(),
+                       [](const Pending& p) { return isIdempotent(p.request.method); });
+}
+
+void HttpClient::sendRequest(Connection& conn, Pending pending) {
+    const HttpRequest& request = pending.request;
+
+    std::string text;
+    text.reserve(256);
+    text += request.method + " " + (request.path.empty() ? "/" : request.path) + " HTTP/1.1\r\n";
+    text += "Host: " + request.host + "\r\n";
+    text += "User-Agent: " + m_config.userAgent + "\r\n";
+    text += "Accept: */*\r\n";
+    text += "Connection: keep-alive\r\n";
+    for (const auto& [name, value] : request.headers) {
+        text += name + ": " + value + "\r\n";
+    }
+    text += "\r\n";
+
+    pending.reused = conn.served > 0 || !conn.inflight.empty();
+    pending.pipelined = !conn.inflight.empty();
+    if (pending.reused) {
+        ++m_stats.reusedRequests;
+    }
+    if (pending.pipelined) {
+        ++m_stats.pipelinedRequests;
+    }
+
+    if (conn.inflight.empty()) {
+        conn.parser.reset(request.method == "HEAD");
+        conn.responseStarted = false;
+        conn.deadline = Clock::now() + m_config.requestTimeout;
+    }
+    conn.inflight.push_back(std::move(pending));
+    conn.output += text;
+
+    // 发送失败留给读事件处理 (连接关闭时在途请求会被重试或失败)
+    flushOutput(conn);
+}
+
+HttpClient::OpenResult HttpClient::openConnection(HostPool& pool) {
+    // 经代理时连接代理地址，代理名额满载时与预算不足一样等待
+    int proxy = -1;
+    Utils::IPAddress address = pool.address;
+    uint16_t port = pool.port;
+    if (m_config.proxies) {
+        proxy = m_config.proxies->acquire(pool.failedProxy);
+        if (proxy < 0) {
+            return m_config.proxies->exhausted() ? OpenResult::FAILED : OpenResult::NO_CAPACITY;
+        }
+        address = m_config.proxies->endpoint(static_cast<size_t>(proxy)).address;
+        port = m_config.proxies->endpoint(static_cast<size_t>(proxy)).port;
+    }
+
+    auto& budget = Utils::SocketBudget::instance();
+    if (!budget.acquire(std::chrono::milliseconds(0))) {
+        if (proxy >= 0) {
+            m_config.proxies->cancel(proxy);
+        }
+        return OpenResult::NO_CAPACITY;
+    }
+
+    int fd = budget.openProbeSocket(address);
+    if (fd < 0) {
+        budget.release();
+        if (proxy >= 0) {
+            m_config.proxies->cancel(proxy);
+        }
+        return OpenResult::NO_CAPACITY;
+    }
+
+    // 流水线请求是连续的小写操作，关闭Nagle避免等待ACK
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+    struct sockaddr_storage addr;
+    socklen_t addrLen = Utils::NetworkUtils::toSockaddr(address, port, addr);
+    int result = ::connect(fd, (struct sockaddr*)&addr, addrLen);
+    if (result != 0) {
+        int error = lastSocketError();
+        if (!connectInProgress(error)) {
+            budget.reportError(error);
+            budget.closeProbeSocket(fd);
+            budget.release();
+            if (proxy >= 0) {
+                // 代理拒绝连接: 换一个代理
+                m_config.proxies->release(proxy, Utils::ProxyOutcome::PROXY_FAILED);
+                pool.failedProxy = proxy;
+                if (++pool.proxyFailures <= MAX_PROXY_FAILURES && !m_config.proxies->exhausted()) {
+                    return openConnection(pool);
+                }
+            }
+            return OpenResult::FAILED;
+        }
+    }
+
+    auto conn = std::make_unique<Connection>(m_config.maxBodySize);
+    conn->fd = fd;
+    conn->pool = &pool;
+    conn->proxy = proxy;
+    conn->deadline = Clock::now() + m_config.connectTimeout;
+    Connection* raw = conn.get();
+
+    pool.connections.push_back(raw);
+    ++pool.connecting;
+    m_connections[fd] = std::move(conn);
+    ++m_stats.connectionsOpened;
+    m_stats.peakConnections = std::max(m_stats.peakConnections, m_connections.size());
+
+    m_loop.watch(fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE,
+                 [this, fd](uint32_t events) { onEvent(fd, events); });
+    if (result == 0) {
+        onConnected(*raw);
+    }
+    return OpenResult::OPENED;
+}
+
+void HttpClient::onEvent(int fd, uint32_t events) {
+    auto it = m_connections.find(fd);
+    if (it == m_connections.end()) {
+        return;
+    }
+    Connection& conn = *it->second;
+
+    if (!conn.connected && conn.tunnel) {
+        advanceTunnel(conn, events);
+        return;
+    }
+    if (!conn.connected && conn.tls) {
+        advanceHandshake(conn);
+        return;
+    }
+    if (!conn.connected) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length);
+        if (error != 0 || !(events & Utils::EventLoop::EVENT_WRITE)) {
+            Utils::SocketBudget::instance().reportError(error);
+            closeConnection(conn, error != 0 ? std::string("Connection failed: ") + strerror(error)
+                                             : "Connection failed", false);
+            return;
+        }
+        onConnected(conn);
+        return;
+    }
+
+    if ((events & Utils::EventLoop::EVENT_WRITE) && !flushOutput(conn)) {
+        closeConnection(conn, "Send failed", false);
+        return;
+    }
+    if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+        readInput(conn);
+    }
+}
+
+void HttpClient::onConnected(Connection& conn) {
+    Utils::SocketBudget::instance().reportSuccess();
+
+    HostPool& pool = *conn.pool;
+    if (conn.proxy >= 0) {
+        conn.tunnel = std::make_unique<Utils::ProxyHandshake>(
+            m_config.proxies->endpoint(static_cast<size_t>(conn.proxy)), pool.address, pool.port);
+        advanceTunnel(conn, Utils::EventLoop::EVENT_WRITE);
+        return;
+    }
+    startSession(conn);
+}
+
+void HttpClient::advanceTunnel(Connection& conn, uint32_t events) {
+    Utils::ProxyHandshake& tunnel = *conn.tunnel;
+
+    if (events & (Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_ERROR)) {
+        char buffer[1024];
+        while (true) {
+            long received = ::recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (received < 0 && wouldBlock(lastSocketError())) {
+                break;
+            }
+            if (received <= 0) {
+                conn.proxyOutcome = tunnel.timeoutOutcome();
+                closeConnection(conn, "Proxy closed the connection", false);
+                return;
+            }
+            // 服务端在请求前不会发送数据，隧道建立后的剩余数据直接丢弃
+            size_t consumed = 0;
+            auto result = tunnel.feed(buffer, static_cast<size_t>(received), consumed);
+            if (result == Utils::ProxyHandshake::Result::DONE) {
+                conn.proxyOutcome = Utils::ProxyOutcome::ESTABLISHED;
+                conn.tunnel.reset();
+                startSession(conn);
+                return;
+            }
+            if (result == Utils::ProxyHandshake::Result::FAILED) {
+                // closeConnection会释放连接和握手状态，先复制错误信息
+                std::string error = tunnel.error();
+                conn.proxyOutcome = tunnel.outcome();
+                closeConnection(conn, error, false);
+                return;
+            }
+        }
+    }
+
+    while (!tunnel.pendingOutput().empty()) {
+        const std::string& output = tunnel.pendingOutput();
+#ifdef _WIN32
+        int result = ::send(conn.fd, output.data(), static_cast<int>(output.size()), 0);
+#else
+        int result = ::send(conn.fd, output.data(), output.size(), MSG_NOSIGNAL);
+#endif
+        if (result < 0) {
+            if (wouldBlock(lastSocketError())) {
+                break;
+            }
+            closeConnection(conn, "Send to proxy failed", false);
+            return;
+        }
+        tunnel.consumeOutput(static_cast<size_t>(result));
+    }
+    uint32_t watch = Utils::EventLoop::EVENT_READ;
+    if (!tunnel.pendingOutput().empty()) {
+        watch |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(conn.fd, watch);
+}
+
+void HttpClient::startSession(Connection& conn) {
+    HostPool& pool = *conn.pool;
+    if (!pool.tls) {
+        onReady(conn);
+        return;
+    }
+
+    // 握手计入连接超时
+    std::string cacheKey = Tls::TlsSessionCache::key(pool.address.address, pool.port, pool.serverName);
+    conn.tls = std::make_unique<Tls::TlsStream>(conn.fd, pool.serverName, cacheKey,
+                                                std::vector<std::string>{"http/1.1"});
+    conn.deadline = Clock::now() + m_config.connectTimeout;
+    advanceHandshake(conn);
+}
+
+void HttpClient::advanceHandshake(Connection& conn) {
+    switch (conn.tls->handshake()) {
+        case Tls::TlsStream::Status::OK:
+            ++m_stats.tlsHandshakes;
+            if (conn.tls->resumed()) {
+                ++m_stats.tlsResumed;
+            }
+            onReady(conn);
+            return;
+        case Tls::TlsStream::Status::WANT_READ:
+            m_loop.update(conn.fd, Utils::EventLoop::EVENT_READ);
+            return;
+        case Tls::TlsStream::Status::WANT_WRITE:
+            m_loop.update(conn.fd, Utils::EventLoop::EVENT_READ | Utils::EventLoop::EVENT_WRITE);
+            return;
+        default: {
+            std::string error = conn.tls->lastError();
+            closeConnection(conn, error.empty() ? "TLS handshake failed" : error, false);
+            return;
+        }
+    }
+}
+
+void HttpClient::onReady(Connection& conn) {
+    HostPool& pool = *conn.pool;
+    conn.connected = true;
+    --pool.connecting;
+    pool.everConnected = true;
+    conn.deadline = Clock::now() + m_config.requestTimeout;
+    pool.proxyFailures = 0;
+    pool.failedProxy = -1;
+
+    m_loop.update(conn.fd, Utils::EventLoop::EVENT_READ);
+    dispatch(pool);
+}
+
+bool HttpClient::flushOutput(Connection& conn) {
+    if (!conn.connected) {
+        return true;
+    }
+
+    while (conn.outputOffset < conn.output.size()) {
+        const char* data = conn.output.data() + conn.outputOffset;
+        size_t remaining = conn.output.size() - conn.outputOffset;
+        size_t sent = 0;
+
+        if (conn.tls) {
+            auto status = conn.tls->write(data, remaining, sent);
+            if (status == Tls::TlsStream::Status::WANT_READ || status == Tls::TlsStream::Status::WANT_WRITE) {
+                break;
+            }
+            if (status != Tls::TlsStream::Status::OK) {
+                return false;
+            }
+        } else {
+#ifdef _WIN32
+            int flags = 0;
+#else
+            int flags = MSG_NOSIGNAL;
+#endif
+            int result = ::send(conn.fd, data, static_cast<int>(remaining), flags);
+            if (result < 0) {
+                int error = lastSocketError();
+                if (wouldBlock(error)) {
+                    break;
+                }
+                return false;
+            }
+            sent = static_cast<size_t>(result);
+        }
+        conn.outputOffset += sent;
+    }
+
+    bool pending = conn.outputOffset < conn.output.size();
+    if (!pending) {
+        conn.output.clear();
+        conn.outputOffset = 0;
+    }
+    uint32_t events = Utils::EventLoop::EVENT_READ;
+    if (pending) {
+        events |= Utils::EventLoop::EVENT_WRITE;
+    }
+    m_loop.update(conn.fd, events);
+    return true;
+}
+
+void HttpClient::readInput(Connection& conn) {
+    char buffer[RECEIVE_CHUNK];
+
+    while (true) {
+        long received = 0;
+        if (conn.tls) {
+            // TLS记录可能已被解密缓存在OpenSSL内部，必须读到WANT_READ为止
+            size_t length = 0;
+            auto status = conn.tls->read(buffer, sizeof(buffer), length);
+            if (status == Tls::TlsStream::Status::WANT_READ || status == Tls::TlsStream::Status::WANT_WRITE) {
+                break;
+            }
+            received = status == Tls::TlsStream::Status::OK ? static_cast<long>(length) : 0;
+        } else {
+            received = ::recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (received < 0 && wouldBlock(lastSocketError())) {
+                break;
+            }
+        }
+        if (received > 0) {
+            if (!consumeInput(conn, buffer, static_cast<size_t>(received))) {
+                return;
+            }
+            if (!conn.tls && static_cast<size_t>(received) < sizeof(buffer)) {
+                break;
+            }
+            continue;
+        }
+
+        // 对端关闭或出错
+        if (!conn.inflight.empty() && conn.responseStarted &&
+            conn.parser.finish() == HttpResponseParser::Result::COMPLETE) {
+            completeResponse(conn);
+        }
+        closeConnection(conn, "Connection closed by peer", conn.responseStarted);
+        return;
+    }
+
+    if (conn.closing) {
+        // 服务端声明关闭后追加的流水线请求不会被应答
+        if (!conn.inflight.empty()) {
+            conn.pool->pipelineBroken = true;
+        }
+        closeConnection(conn, "Connection closed by peer", false);
+    }
+}
+
+bool HttpClient::consumeInput(Connection& conn, const char* data, size_t length) {
+    if (conn.inflight.empty()) {
+        return true;
+    }
+
+    // 没有残留数据时直接在接收缓冲区上解析，只把未消费的尾部保存到连接上
+    const char* input = data;
+    size_t size = length;
+    bool buffered = !conn.input.empty();
+    if (buffered) {
+        conn.input.append(data, length);
+        input = conn.input.data();
+        size = conn.input.size();
+    }
+
+    // 依次解析响应，流水线时一次读取可能包含多个
+    size_t offset = 0;
+    while (!conn.inflight.empty() && offset < size) {
+        conn.responseStarted = true;
+        size_t consumed = 0;
+        auto result = conn.parser.feed(input + offset, size - offset, consumed);
+        offset += consumed;
+
+        if (result == HttpResponseParser::Result::PARSE_ERROR) {
+            closeConnection(conn, "Malformed HTTP response", true);
+            return false;
+        }
+        if (result == HttpResponseParser::Result::NEED_MORE) {
+            break;
+        }
+        completeResponse(conn);
+    }
+
+    // 没有在途请求时多余的数据直接丢弃
+    size_t rest = conn.inflight.empty() ? 0 : size - offset;
+    if (buffered) {
+        if (rest == 0) {
+            conn.input.clear();
+        } else {
+            conn.input.erase(0, offset);
+        }
+    } else if (rest > 0) {
+        conn.input.assign(input + offset, rest);
+    }
+    return true;
+}
+
+void HttpClient::completeResponse(Connection& conn) {
+    Pending pending = std::move(conn.inflight.front());
+    conn.inflight.pop_front();
+
+    HttpResponse response = std::move(conn.parser.response());
+    bool keepAlive = conn.parser.keepAlive();
+    response.reused = pending.reused;
+    response.pipelined = pending.pipelined;
+
+    ++conn.served;
+    conn.responseStarted = false;
+    if (keepAlive && response.version() == "HTTP/1.1") {
+        conn.reusable = true;
+    }
+    if (!keepAlive || conn.served >= m_config.maxRequestsPerConnection) {
+        conn.closing = true;
+    }
+
+    if (!conn.inflight.empty()) {
+        conn.parser.reset(conn.inflight.front().request.method == "HEAD");
+    }
+    conn.deadline = Clock::now() + m_config.requestTimeout;
+
+    finish(pending, response);
+
+    // 空闲后继续处理排队请求
+    if (!conn.closing && conn.inflight.empty()) {
+        dispatch(*conn.pool);
+    }
+}
+
+void HttpClient::closeConnection(Connection& conn, const std::string& reason, bool failFirst) {
+    HostPool& pool = *conn.pool;
+    int fd = conn.fd;
+    bool wasConnected = conn.connected;
+
+    if (!wasConnected && pool.connecting > 0) {
+        --pool.connecting;
+    }
+    pool.connections.erase(std::remove(pool.connections.begin(), pool.connections.end(), &conn),
+                           pool.connections.end());
+
+    m_loop.unwatch(fd);
+    conn.tls.reset();
+    auto& budget = Utils::SocketBudget::instance();
+    budget.closeProbeSocket(fd);
+    budget.release();
+
+    // 代理故障: 换代理重新连接，不让排队的请求失败
+    bool proxyFault = false;
+    if (conn.proxy >= 0) {
+        m_config.proxies->release(conn.proxy, conn.proxyOutcome);
+        if (!wasConnected && conn.proxyOutcome == Utils::ProxyOutcome::PROXY_FAILED) {
+            pool.failedProxy = conn.proxy;
+            proxyFault = ++pool.proxyFailures <= MAX_PROXY_FAILURES && !m_config.proxies->exhausted();
+        }
+    }
+
+    std::deque<Pending> inflight = std::move(conn.inflight);
+    m_connections.erase(fd);
+
+    // 已开始接收响应的请求失败，其余未应答请求按原顺序放回队首重试
+    size_t requeued = 0;
+    for (size_t i = inflight.size(); i-- > 0;) {
+        Pending& pending = inflight[i];
+        bool retry = !m_cancelling && !(i == 0 && failFirst) && pending.attempts < MAX_RETRIES &&
+                     isIdempotent(pending.request.method);
+        if (retry) {
+            ++pending.attempts;
+            ++m_stats.retries;
+            ++requeued;
+            pool.queue.push_front(std::move(pending));
+        } else {
+            fail(pending, reason);
+        }
+    }
+    if (requeued > 1) {
+        pool.pipelineBroken = true;
+    }
+
+    if (m_cancelling) {
+        return;
+    }
+    // 连接失败: 从未连通过的主机整组失败，否则让队首请求失败以免反复重连
+    if (!wasConnected && !proxyFault) {
+        if (!pool.everConnected) {
+            failQueue(pool, reason);
+        } else if (!pool.queue.empty()) {
+            Pending pending = std::move(pool.queue.front());
+            pool.queue.pop_front();
+            fail(pending, reason);
+        }
+    }
+    releaseCapacity();
+    dispatch(pool);
+}
+
+void HttpClient::failQueue(HostPool& pool, const std::string& reason) {
+    std::deque<Pending> queue = std::move(pool.queue);
+    pool.queue.clear();
+    for (Pending& pending : queue) {
+        fail(pending, reason);
+    }
+}
+
+void HttpClient::finish(Pending& pending, HttpResponse& response) {
+    response.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    --m_outstanding;
+    ++m_stats.responses;
+    if (pending.callback) {
+        pending.callback(pending.request, response);
+    }
+}
+
+void HttpClient::fail(Pending& pending, const std::string& error) {
+    HttpResponse response;
+    response.error = error;
+    response.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - pending.submitted);
+    --m_outstanding;
+    ++m_stats.failures;
+    if (pending.callback) {
+        pending.callback(pending.request, response);
+    }
+}
+
+void HttpClient::releaseCapacity() {
+    while (!m_waitingPools.empty() && m_connections.size() < m_config.maxConnections) {
+        HostPool* pool = m_waitingPools.front();
+        m_waitingPools.pop_front();
+        pool->waiting = false;
+        size_t before = m_connections.size();
+        dispatch(*pool);
+        // 预算仍不足时 (连接数未增加且重新进入等待) 停止唤醒
+        if (pool->waiting && m_connections.size() == before) {
+            break;
+        }
+    }
+}
+
+void HttpClient::scheduleSweep() {
+    if (m_sweepTimer != 0) {
+        return;
+    }
+    m_sweepTimer = m_loop.addTimer(SWEEP_INTERVAL, [this]() {
+        m_sweepTimer = 0;
+        sweep();
+        if (m_outstanding > 0 || !m_connections.empty()) {
+            scheduleSweep();
+        }
+    });
+}
+
+void HttpClient::sweep() {
+    auto now = Clock::now();
+
+    std::vector<int> expired;
+    for (const auto& entry : m_connections) {
+        const Connection& conn = *entry.second;
+        // 空闲连接超过请求超时后也关闭，避免长期占用预算
+        if (now >= conn.deadline) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int fd : expired) {
+        auto it = m_connections.find(fd);
+        if (it == m_connections.end()) {
+            continue;
+        }
+        Connection& conn = *it->second;
+        if (conn.tunnel) {
+            conn.proxyOutcome = conn.tunnel->timeoutOutcome();
+        }
+        closeConnection(conn, conn.connected ? "Request timeout" : "Connection timeout", true);
+    }
+
+    // 等待连接预算的请求同样受超时约束 (回调中可能submit新的主机，遍历快照)
+    auto queueLimit = m_config.connectTimeout + m_config.requestTimeout;
+    std::vector<HostPool*> pools = snapshotPools();
+    for (HostPool* poolPtr : pools) {
+        HostPool& pool = *poolPtr;
+        while (!pool.queue.empty() && now - pool.queue.front().submitted >= queueLimit) {
+            Pending pending = std::move(pool.queue.front());
+            pool.queue.pop_front();
+            fail(pending, "Request timeout");
+        }
+    }
+
+    releaseCapacity();
+    for (HostPool* pool : pools) {
+        if (!pool->queue.empty()) {
+            dispatch(*pool);
+        }
+    }
+}
+
+std::vector<HttpClient::HostPool*> HttpClient::snapshotPools() const {
+    std::vector<HostPool*> pools;
+    pools.reserve(m_pools.size());
+    for (const auto& entry : m_pools) {
+        pools.push_back(entry.second.get());
+    }
+    return pools;
+}
+
+} // namespace MindSploit::Web
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "http_parser.h"
+#include "../tls/tls_session.h"
+#include "../../utils/event_loop.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/proxy_pool.h"
+#include <functional>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+
+namespace MindSploit::Web {
+
+// HTTP客户端配置
+struct HttpClientConfig {
+    size_t maxConnections = 1024;               // 全局连接上限 (另受SocketBudget约束)
+    size_t maxConnectionsPerHost = 4;
+    size_t pipelineDepth = 4;                   // 每个连接最多同时在途的请求数，1表示不流水线
+    size_t maxRequestsPerConnection = 100;
+    size_t maxBodySize = 1 << 20;
+    std::chrono::milliseconds connectTimeout{5000};
+    std::chrono::milliseconds requestTimeout{10000};
+    std::string userAgent = "Mozilla/5.0 (compatible; MindSploit/2.0)";
+    std::shared_ptr<Utils::ProxyPool> proxies;  // 经上游代理池建立连接 (为空则直连)
+};
+
+// HTTP请求
+struct HttpRequest {
+    Utils::IPAddress address;
+    uint16_t port = 80;
+    bool tls = false;                           // HTTPS (需要OpenSSL支持)
+    std::string host;                           // Host首部，为空时使用地址
+    std::string method = "GET";
+    std::string path = "/";
+    std::vector<std::pair<std::string, std::string>> headers;
+};
+
+// 客户端统计
+struct HttpClientStats {
+    uint64_t requests = 0;
+    uint64_t responses = 0;
+    uint64_t failures = 0;
+    uint64_t retries = 0;
+    uint64_t connectionsOpened = 0;
+    uint64_t reusedRequests = 0;                // 在已有连接上发送的请求
+    uint64_t pipelinedRequests = 0;             // 在有请求在途时追加发送的请求
+    uint64_t tlsHandshakes = 0;
+    uint64_t tlsResumed = 0;                    // 复用了缓存会话的TLS握手
+    size_t peakConnections = 0;
+};
+
+// 基于事件循环的HTTP/1.1客户端
+//
+// 请求按 地址:端口 分组排队，每组维护一个keep-alive连接池:
+//   - 优先使用空闲连接，其次在已确认keep-alive的HTTP/1.1连接上流水线发送幂等请求，
+//     最后在组内/全局连接上限内新建连接
+//   - 流水线连接被服务端提前关闭时，未应答的请求重新排队并停用该组的流水线
+// HTTPS连接使用TlsSessionCache中的会话，tls命令握手过的端点直接复用。
+// 配置了代理池时，每个连接先连到选中的代理并建立CONNECT隧道，再进行TLS握手和请求;
+// 代理故障导致的连接失败换代理重新建立，不计为目标失败。
+// 回调在事件循环线程中执行，可以在回调里继续submit。
+class HttpClient {
+public:
+    using Callback = std::function<void(const HttpRequest& request, const HttpResponse& response)>;
+
+    HttpClient(Utils::EventLoop& loop, const HttpClientConfig& config);
+    ~HttpClient();
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    void submit(HttpRequest request, Callback callback);
+    // 排队和在途的请求数
+    size_t outstanding() const { return m_outstanding; }
+    // 驱动事件循环直到全部请求完成或stopRequested置位
+    void run(const std::atomic<bool>& stopRequested);
+    // 以失败结束全部请求并关闭连接
+    void cancelAll(const std::string& reason);
+
+    HttpClientStats getStats() const { return m_stats; }
+    const HttpClientConfig& config() const { return m_config; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        HttpRequest request;
+        Callback callback;
+        Clock::time_point submitted;
+        int attempts = 0;
+        bool reused = false;
+        bool pipelined = false;
+    };
+
+    struct HostPool;
+
+    struct Connection {
+        int fd = -1;
+        HostPool* pool = nullptr;
+        bool connected = false;         // TCP连接、代理隧道和TLS握手 (HTTPS) 均已完成
+        std::unique_ptr<Tls::TlsStream> tls;
+        int proxy = -1;                 // 代理池中的代理，-1为直连
+        std::unique_ptr<Utils::ProxyHandshake> tunnel;  // 正在建立的代理隧道
+        Utils::ProxyOutcome proxyOutcome = Utils::ProxyOutcome::PROXY_FAILED;
+        bool reusable = false;          // 已收到keep-alive的HTTP/1.1响应，可以流水线
+        bool closing = false;           // 服务端要求关闭，不再发送新请求
+        std::deque<Pending> inflight;   // 已发送、按顺序等待响应的请求
+        std::string output;
+        size_t outputOffset = 0;
+        std::string input;              // 跨越多次读取的未完成响应
+        HttpResponseParser parser;
+        size_t served = 0;
+        bool responseStarted = false;
+        Clock::time_point deadline;
+
+        explicit Connection(size_t maxBodySize) : parser(maxBodySize) {}
+    };
+
+    struct HostPool {
+        std::string key;
+        Utils::IPAddress address;
+        uint16_t port = 0;
+        bool tls = false;
+        std::string serverName;         // SNI
+        std::deque<Pending> queue;
+        std::vector<Connection*> connections;
+        size_t connecting = 0;
+        bool everConnected = false;
+        bool pipelineBroken = false;
+        bool waiting = false;           // 已在全局等待队列中
+        size_t proxyFailures = 0;       // 连续因代理故障失败的连接数
+        int failedProxy = -1;           // 最近故障的代理，新建连接时避开
+    };
+
+    HostPool& poolFor(const HttpRequest& request);
+    void dispatch(HostPool& pool);
+    bool canPipeline(const Connection& conn, const Pending& pending) const;
+    void sendRequest(Connection& conn, Pending pending);
+    enum class OpenResult {
+        OPENED,
+        NO_CAPACITY,                    // fd/端口预算或全局上限已满，等待其它连接释放
+        FAILED                          // 连接立即失败
+    };
+    OpenResult openConnection(HostPool& pool);
+
+    void onEvent(int fd, uint32_t events);
+    void onConnected(Connection& conn);
+    void advanceTunnel(Connection& conn, uint32_t events);
+    // TCP连接 (及代理隧道) 已就绪: 明文直接可用，HTTPS开始TLS握手
+    void startSession(Connection& conn);
+    void advanceHandshake(Connection& conn);
+    void onReady(Connection& conn);
+    bool flushOutput(Connection& conn);
+    void readInput(Connection& conn);
+    // 返回false表示连接已因解析错误关闭
+    bool consumeInput(Connection& conn, const char* data, size_t length);
+    void completeResponse(Connection& conn);
+    // failFirst: 首个在途请求以失败结束而不是重试 (超时、响应已部分接收)
+    void closeConnection(Connection& conn, const std::string& reason, bool failFirst);
+    void failQueue(HostPool& pool, const std::string& reason);
+    void finish(Pending& pending, HttpResponse& response);
+    void fail(Pending& pending, const std::string& error);
+    void releaseCapacity();
+
+    std::vector<HostPool*> snapshotPools() const;
+
+    void scheduleSweep();
+    void sweep();
+
+private:
+    Utils::EventLoop& m_loop;
+    HttpClientConfig m_config;
+    std::unordered_map<std::string, std::unique_ptr<HostPool>> m_pools;
+    std::unordered_map<int, std::unique_ptr<Connection>> m_connections;
+    std::deque<HostPool*> m_waitingPools;
+    size_t m_outstanding = 0;
+    Utils::EventLoop::TimerId m_sweepTimer = 0;
+    bool m_cancelling = false;
+    HttpClientStats m_stats;
+};
+
+} // namespace MindSploit::Web
@@ -0,0 +1,385 @@
+#include "http_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MINDSPLOIT_HTTP_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace MindSploit::Web {
+
+namespace {
+
+// 首部总长度上限，超出视为格式错误
+constexpr size_t MAX_HEAD_SIZE = 64 * 1024;
+// chunk长度行上限 (含扩展参数)
+constexpr size_t MAX_CHUNK_LINE = 1024;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+bool containsToken(std::string_view value, std::string_view token) {
+    auto it = std::search(value.begin(), value.end(), token.begin(), token.end(),
+                          [](unsigned char x, unsigned char y) { return std::tolower(x) == std::tolower(y); });
+    return it != value.end();
+}
+
+#ifdef MINDSPLOIT_HTTP_SSE2
+inline unsigned lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// 查找第一个'\n'，不存在时返回end
+const char* findNewline(const char* p, const char* end) {
+#ifdef MINDSPLOIT_HTTP_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        if (mask != 0) {
+            return p + lowestBit(mask);
+        }
+        p += 16;
+    }
+#endif
+    const void* found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return found != nullptr ? static_cast<const char*>(found) : end;
+}
+
+// 查找首部结束的空行 ("\r\n\r\n" 或 "\n\n")，返回空行之后的位置，数据不足时返回nullptr
+const char* findHeadEnd(const char* p, const char* end) {
+    while (true) {
+        const char* newline = findNewline(p, end);
+        if (newline == end) {
+            return nullptr;
+        }
+        const char* next = newline + 1;
+        if (next < end && *next == '\n') {
+            return next + 1;
+        }
+        if (end - next >= 2 && next[0] == '\r' && next[1] == '\n') {
+            return next + 2;
+        }
+        p = next;
+    }
+}
+
+// 去掉行尾的'\r'
+size_t lineLength(const char* line, const char* newline) {
+    size_t length = static_cast<size_t>(newline - line);
+    return length > 0 && line[length - 1] == '\r' ? length - 1 : length;
+}
+
+} // namespace
+
+std::string_view HttpResponse::body() const {
+    if (m_bodyOffset >= m_data.size()) {
+        return std::string_view();
+    }
+    return std::string_view(m_data.data() + m_bodyOffset, m_data.size() - m_bodyOffset);
+}
+
+std::string_view HttpResponse::header(std::string_view name) const {
+    for (const auto& field : m_headers) {
+        if (equalsIgnoreCase(view(field.name), name)) {
+            return view(field.value);
+        }
+    }
+    return std::string_view();
+}
+
+void HttpResponseParser::reset(bool headRequest) {
+    m_response = HttpResponse();
+    m_state = State::HEAD;
+    m_scanned = 0;
+    m_headRequest = headRequest;
+    m_keepAlive = false;
+    m_remaining = 0;
+}
+
+HttpResponseParser::Result HttpResponseParser::feed(const char* data, size_t length, size_t& consumed) {
+    const char* end = data + length;
+    size_t offset = 0;
+
+    while (true) {
+        switch (m_state) {
+            case State::HEAD: {
+                // 容忍响应前的空行
+                if (m_scanned == 0) {
+                    while (offset < length && (data[offset] == '\r' || data[offset] == '\n')) {
+                        ++offset;
+                    }
+                }
+                const char* begin = data + offset;
+                size_t available = length - offset;
+                const char* headEnd = findHeadEnd(begin + std::min(m_scanned, available), end);
+                if (headEnd == nullptr) {
+                    if (available > MAX_HEAD_SIZE) {
+                        consumed = offset;
+                        return Result::PARSE_ERROR;
+                    }
+                    // 结束标记最多跨越已有数据的最后3个字节
+                    m_scanned = available > 3 ? available - 3 : 0;
+                    consumed = offset;
+                    return Result::NEED_MORE;
+                }
+
+                size_t headLength = static_cast<size_t>(headEnd - begin);
+                if (headLength > MAX_HEAD_SIZE || !parseHead(begin, headLength)) {
+                    consumed = offset;
+                    return Result::PARSE_ERROR;
+                }
+                offset += headLength;
+                m_scanned = 0;
+                beginBody();
+                continue;
+            }
+
+            case State::BODY_LENGTH: {
+                if (offset == length) break;
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(m_remaining, length - offset));
+                appendBody(data + offset, chunk);
+                offset += chunk;
+                m_remaining -= chunk;
+                if (m_remaining == 0) {
+                    m_state = State::DONE;
+                }
+                continue;
+            }
+
+            case State::BODY_CHUNK_SIZE: {
+                const char* newline = findNewline(data + offset, end);
+                if (newline == end) {
+                    if (length - offset > MAX_CHUNK_LINE) {
+                        consumed = offset;
+                        return Result::PARSE_ERROR;
+                    }
+                    break;
+                }
+
+                // 十六进制长度，忽略 ;ext 扩展参数
+                uint64_t size = 0;
+                size_t digits = 0;
+                for (const char* p = data + offset; p < newline && std::isxdigit(static_cast<unsigned char>(*p)); ++p) {
+                    char c = static_cast<char>(std::tolower(static_cast<unsigned char>(*p)));
+                    size = size * 16 + static_cast<uint64_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+                    if (++digits > 15) {
+                        consumed = offset;
+                        return Result::PARSE_ERROR;
+                    }
+                }
+                if (digits == 0) {
+                    consumed = offset;
+                    return Result::PARSE_ERROR;
+                }
+                offset = static_cast<size_t>(newline - data) + 1;
+                m_remaining = size;
+                m_state = size == 0 ? State::BODY_TRAILERS : State::BODY_CHUNK_DATA;
+                continue;
+            }
+
+            case State::BODY_CHUNK_DATA: {
+                if (offset == length) break;
+                size_t chunk = static_cast<size_t>(std::min<uint64_t>(m_remaining, length - offset));
+                appendBody(data + offset, chunk);
+                offset += chunk;
+                m_remaining -= chunk;
+                if (m_remaining == 0) {
+                    m_state = State::BODY_CHUNK_CRLF;
+                }
+                continue;
+            }
+
+            case State::BODY_CHUNK_CRLF: {
+                const char* newline = findNewline(data + offset, end);
+                if (newline == end) break;
+                offset = static_cast<size_t>(newline - data) + 1;
+                m_state = State::BODY_CHUNK_SIZE;
+                continue;
+            }
+
+            case State::BODY_TRAILERS: {
+                const char* newline = findNewline(data + offset, end);
+                if (newline == end) {
+                    if (length - offset > MAX_HEAD_SIZE) {
+                        consumed = offset;
+                        return Result::PARSE_ERROR;
+                    }
+                    break;
+                }
+                size_t trailerLength = lineLength(data + offset, newline);
+                offset = static_cast<size_t>(newline - data) + 1;
+                if (trailerLength == 0) {
+                    m_state = State::DONE;
+                }
+                continue;
+            }
+
+            case State::BODY_UNTIL_CLOSE:
+                appendBody(data + offset, length - offset);
+                offset = length;
+                break;
+
+            case State::DONE:
+                consumed = offset;
+                return Result::COMPLETE;
+        }
+
+        // 数据不足
+        break;
+    }
+
+    consumed = offset;
+    return Result::NEED_MORE;
+}
+
+HttpResponseParser::Result HttpResponseParser::finish() {
+    if (m_state == State::BODY_UNTIL_CLOSE || m_state == State::DONE) {
+        m_state = State::DONE;
+        m_keepAlive = false;
+        return Result::COMPLETE;
+    }
+    return Result::PARSE_ERROR;
+}
+
+bool HttpResponseParser::parseHead(const char* data, size_t length) {
+    HttpResponse& response = m_response;
+    response.m_data.assign(data, length);
+    response.m_headers.clear();
+
+    const char* base = response.m_data.data();
+    const char* end = base + length;
+    auto span = [base](const char* begin, size_t size) {
+        return HttpResponse::Span{static_cast<uint32_t>(begin - base), static_cast<uint32_t>(size)};
+    };
+
+    // 状态行: HTTP/1.1 200 OK
+    const char* newline = findNewline(base, end);
+    size_t statusLength = lineLength(base, newline);
+    if (statusLength < 12 || std::memcmp(base, "HTTP/", 5) != 0) {
+        return false;
+    }
+    const char* space = static_cast<const char*>(std::memchr(base, ' ', statusLength));
+    if (space == nullptr || base + statusLength - space < 4) {
+        return false;
+    }
+    response.m_version = span(base, static_cast<size_t>(space - base));
+
+    int status = 0;
+    for (int i = 1; i <= 3; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(space[i]))) {
+            return false;
+        }
+        status = status * 10 + (space[i] - '0');
+    }
+    if (status < 100) {
+        return false;
+    }
+    response.status = status;
+
+    const char* reason = space + 4;
+    const char* statusEnd = base + statusLength;
+    while (reason < statusEnd && (*reason == ' ' || *reason == '\t')) ++reason;
+    response.m_reason = span(reason, static_cast<size_t>(statusEnd - reason));
+
+    // 首部行: 名称和值直接指向缓冲区
+    const char* line = newline + 1;
+    while (line < end) {
+        newline = findNewline(line, end);
+        size_t size = lineLength(line, newline);
+        if (size == 0) {
+            break;
+        }
+
+        const char* colon = static_cast<const char*>(std::memchr(line, ':', size));
+        if (colon == nullptr || colon == line) {
+            return false;
+        }
+        const char* value = colon + 1;
+        const char* valueEnd = line + size;
+        while (value < valueEnd && (*value == ' ' || *value == '\t')) ++value;
+        while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t')) --valueEnd;
+
+        response.m_headers.push_back({span(line, static_cast<size_t>(colon - line)),
+                                      span(value, static_cast<size_t>(valueEnd - value))});
+        line = newline + 1;
+    }
+    return true;
+}
+
+void HttpResponseParser::beginBody() {
+    HttpResponse& response = m_response;
+    response.m_bodyOffset = response.m_data.size();
+
+    std::string_view connection = response.header("Connection");
+    if (response.version() == "HTTP/1.0") {
+        m_keepAlive = containsToken(connection, "keep-alive");
+    } else {
+        m_keepAlive = !containsToken(connection, "close");
+    }
+
+    int status = response.status;
+    if (status >= 100 && status < 200 && status != 101) {
+        // 1xx中间响应直接跳过，继续等待最终响应
+        response = HttpResponse();
+        m_state = State::HEAD;
+        return;
+    }
+    if (m_headRequest || status < 200 || status == 204 || status == 304) {
+        m_state = State::DONE;
+        return;
+    }
+
+    if (containsToken(response.header("Transfer-Encoding"), "chunked")) {
+        m_state = State::BODY_CHUNK_SIZE;
+        return;
+    }
+
+    std::string_view contentLength = response.header("Content-Length");
+    if (!contentLength.empty()) {
+        m_remaining = 0;
+        for (char c : contentLength) {
+            if (!std::isdigit(static_cast<unsigned char>(c)) || m_remaining > (UINT64_MAX - 9) / 10) {
+                break;
+            }
+            m_remaining = m_remaining * 10 + static_cast<uint64_t>(c - '0');
+        }
+        response.m_data.reserve(response.m_data.size() +
+                                static_cast<size_t>(std::min<uint64_t>(m_remaining, m_maxBodySize)));
+        m_state = m_remaining == 0 ? State::DONE : State::BODY_LENGTH;
+        return;
+    }
+
+    // 没有长度信息时读到连接关闭为止
+    m_keepAlive = false;
+    m_state = State::BODY_UNTIL_CLOSE;
+}
+
+void HttpResponseParser::appendBody(const char* data, size_t length) {
+    size_t bodySize = m_response.m_data.size() - m_response.m_bodyOffset;
+    size_t room = m_maxBodySize > bodySize ? m_maxBodySize - bodySize : 0;
+    if (length > room) {
+        m_response.truncated = true;
+        length = room;
+    }
+    m_response.m_data.append(data, length);
+}
+
+} // namespace MindSploit::Web
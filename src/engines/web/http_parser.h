@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace MindSploit::Web {
+
+// HTTP响应
+//
+// 首部原文和响应体保存在同一个缓冲区中，版本、原因短语和各首部只记录
+// 偏移和长度，通过string_view访问，解析时不为单个首部分配内存。
+struct HttpResponse {
+    int status = 0;
+    bool truncated = false;             // 响应体超过上限被截断
+
+    std::string error;                  // 非空表示请求失败
+    std::chrono::milliseconds elapsed{0};
+    bool reused = false;                // 复用了已有连接
+    bool pipelined = false;             // 与其它请求流水线发送
+
+    bool ok() const { return error.empty() && status > 0; }
+
+    std::string_view version() const { return view(m_version); }    // HTTP/1.1
+    std::string_view reason() const { return view(m_reason); }
+    std::string_view body() const;
+
+    size_t headerCount() const { return m_headers.size(); }
+    std::string_view headerName(size_t index) const { return view(m_headers[index].name); }
+    std::string_view headerValue(size_t index) const { return view(m_headers[index].value); }
+    // 按名称查找首部 (不区分大小写)，不存在时返回空
+    std::string_view header(std::string_view name) const;
+
+private:
+    friend class HttpResponseParser;
+
+    struct Span {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+    struct HeaderSpan {
+        Span name;
+        Span value;
+    };
+
+    std::string_view view(Span span) const { return std::string_view(m_data.data() + span.offset, span.length); }
+
+    std::string m_data;                 // 首部原文 + 响应体
+    size_t m_bodyOffset = 0;
+    Span m_version;
+    Span m_reason;
+    std::vector<HeaderSpan> m_headers;
+};
+
+// 增量HTTP/1.x响应解析器
+// 支持Content-Length、chunked和读到连接关闭三种响应体
+//
+// 首部在接收缓冲区中原地查找结束位置 (SSE2按16字节扫描换行)，完整到达后一次性
+// 拷入响应缓冲区再切分；首部不完整时不消费数据，调用方下次输入时必须把未消费
+// 的字节原样放在开头，解析器据此跳过已扫描过的部分。
+class HttpResponseParser {
+public:
+    enum class Result {
+        NEED_MORE,
+        COMPLETE,
+        PARSE_ERROR
+    };
+
+    explicit HttpResponseParser(size_t maxBodySize = 1 << 20) : m_maxBodySize(maxBodySize) {}
+
+    // 开始解析新响应，HEAD请求的响应没有响应体
+    void reset(bool headRequest);
+    // 输入数据，consumed返回本次使用的字节数 (COMPLETE时剩余数据属于下一个响应)
+    Result feed(const char* data, size_t length, size_t& consumed);
+    // 连接关闭: 以读到关闭为界的响应体在此完成
+    Result finish();
+
+    HttpResponse& response() { return m_response; }
+    bool started() const { return m_state != State::HEAD || m_scanned > 0; }
+    // 响应完成后连接能否继续使用
+    bool keepAlive() const { return m_keepAlive; }
+
+private:
+    enum class State {
+        HEAD,
+        BODY_LENGTH,
+        BODY_CHUNK_SIZE,
+        BODY_CHUNK_DATA,
+        BODY_CHUNK_CRLF,
+        BODY_TRAILERS,
+        BODY_UNTIL_CLOSE,
+        DONE
+    };
+
+    bool parseHead(const char* data, size_t length);
+    void beginBody();
+    void appendBody(const char* data, size_t length);
+
+private:
+    size_t m_maxBodySize;
+    HttpResponse m_response;
+    State m_state = State::HEAD;
+    size_t m_scanned = 0;               // 首部中已确认不含结束标记的前缀长度
+    bool m_headRequest = false;
+    bool m_keepAlive = false;
+    uint64_t m_remaining = 0;
+};
+
+} // namespace MindSploit::Web
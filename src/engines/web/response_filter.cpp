@@ -0,0 +1,247 @@
+#include "response_filter.h"
+#include "web_engine.h"
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+
+namespace MindSploit::Web {
+
+namespace {
+
+constexpr size_t MAX_HASHED_BODY = 64 * 1024;
+constexpr size_t MAX_TOKEN_LENGTH = 32;
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+// 归一化后的占位词
+constexpr uint64_t DYNAMIC_TOKEN = 0x9e3779b97f4a7c15ULL;
+constexpr uint64_t LONG_TOKEN = 0xc2b2ae3d27d4eb4fULL;
+constexpr uint64_t PATH_TOKEN = 0x165667b19e3779f9ULL;
+
+bool isWordChar(unsigned char c) {
+    return std::isalnum(c) || c == '_' || c >= 0x80;
+}
+
+uint64_t hashLower(std::string_view token) {
+    uint64_t hash = FNV_OFFSET;
+    for (unsigned char c : token) {
+        hash ^= static_cast<unsigned char>(std::tolower(c));
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// 按字母数字切分，对每个词及其偏移调用handler
+template <typename Handler>
+void tokenize(std::string_view text, Handler&& handler) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isWordChar(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < text.size() && isWordChar(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        if (i > start) {
+            handler(text.substr(start, i - start), start);
+        }
+    }
+}
+
+std::string normalizeLocation(std::string_view location, std::string_view requestPath) {
+    std::string normalized(location);
+    if (requestPath.size() > 1) {
+        size_t pos = normalized.find(requestPath);
+        if (pos != std::string::npos) {
+            normalized.replace(pos, requestPath.size(), "{path}");
+        }
+    }
+    // 去掉可能回显随机值的查询串
+    size_t query = normalized.find('?');
+    if (query != std::string::npos) {
+        normalized.erase(query);
+    }
+    return normalized;
+}
+
+} // namespace
+
+uint64_t responseSimHash(std::string_view body, std::string_view requestPath) {
+    body = body.substr(0, std::min(body.size(), MAX_HASHED_BODY));
+
+    // 页面中回显的请求路径 (取最后一段，如 index.php) 整体视为一个占位词
+    std::string_view segment = requestPath;
+    while (!segment.empty() && segment.back() == '/') {
+        segment.remove_suffix(1);
+    }
+    size_t slash = segment.rfind('/');
+    if (slash != std::string_view::npos) {
+        segment.remove_prefix(slash + 1);
+    }
+    std::vector<std::pair<size_t, size_t>> echoes;
+    if (segment.size() >= 3) {
+        for (size_t pos = body.find(segment); pos != std::string_view::npos && echoes.size() < 64;
+             pos = body.find(segment, pos + segment.size())) {
+            echoes.emplace_back(pos, pos + segment.size());
+        }
+    }
+
+    int weights[64] = {0};
+    uint64_t previous = 0;
+    size_t features = 0;
+    size_t echo = 0;
+
+    auto addFeature = [&](uint64_t feature) {
+        for (int bit = 0; bit < 64; ++bit) {
+            weights[bit] += ((feature >> bit) & 1) ? 1 : -1;
+        }
+        ++features;
+    };
+    auto addToken = [&](uint64_t hash) {
+        // 相邻词对作为特征，保留词序信息
+        if (previous != 0) {
+            uint64_t pair = (previous ^ (hash >> 1)) * FNV_PRIME;
+            addFeature(pair ^ (pair >> 29));
+        }
+        previous = hash;
+    };
+
+    tokenize(body, [&](std::string_view token, size_t offset) {
+        while (echo < echoes.size() && echoes[echo].second <= offset) {
+            ++echo;
+        }
+        if (echo < echoes.size() && offset >= echoes[echo].first) {
+            // 回显区域内的第一个词记一次占位词，其余跳过
+            if (previous != PATH_TOKEN) {
+                addToken(PATH_TOKEN);
+            }
+            return;
+        }
+        if (token.size() > MAX_TOKEN_LENGTH) {
+            addToken(LONG_TOKEN);
+        } else if (std::any_of(token.begin(), token.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            addToken(DYNAMIC_TOKEN);
+        } else {
+            addToken(hashLower(token));
+        }
+    });
+
+    // 只有一个词时以该词本身为特征
+    if (features == 0 && previous != 0) {
+        addFeature(previous);
+    }
+
+    uint64_t simhash = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (weights[bit] > 0) {
+            simhash |= 1ULL << bit;
+        }
+    }
+    return simhash;
+}
+
+int hammingDistance(uint64_t a, uint64_t b) {
+    return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
+
+std::vector<std::string> responseFeatures(const HttpResponse& response, std::string_view requestPath) {
+    std::vector<std::string> features;
+    features.push_back("status:" + std::to_string(response.status));
+
+    auto lower = [](std::string_view text) {
+        std::string value(text);
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        return value;
+    };
+    for (size_t i = 0; i < response.headerCount(); ++i) {
+        std::string name = lower(response.headerName(i));
+        // 日期、长度等每次都变的首部只取名称
+        features.push_back("header:" + name);
+        if (name == "server" || name == "x-powered-by" || name == "x-aspnet-version") {
+            features.push_back(name + ":" + std::string(response.headerValue(i)));
+        } else if (name == "set-cookie") {
+            std::string_view cookie = response.headerValue(i);
+            features.push_back("cookie:" + std::string(cookie.substr(0, cookie.find('='))));
+        }
+    }
+
+    std::string_view body = response.body();
+    std::string title = WebEngine::extractTitle(body);
+    if (!title.empty()) {
+        features.push_back("title:" + lower(title));
+    }
+    std::string_view location = response.header("Location");
+    if (!location.empty()) {
+        features.push_back("location:" + normalizeLocation(location, requestPath));
+    }
+    if (!body.empty()) {
+        uint64_t simhash = responseSimHash(body, requestPath);
+        for (int part = 0; part < 4; ++part) {
+            features.push_back("simhash" + std::to_string(part) + ":" +
+                               std::to_string((simhash >> (part * 16)) & 0xffff));
+        }
+    }
+    return features;
+}
+
+ResponseSignature ResponseSignature::of(const HttpResponse& response, std::string_view requestPath) {
+    ResponseSignature signature;
+    signature.status = response.status;
+    std::string_view body = response.body();
+    signature.simhash = responseSimHash(body, requestPath);
+    signature.length = body.size();
+    std::string_view location = response.header("Location");
+    if (!location.empty()) {
+        signature.location = normalizeLocation(location, requestPath);
+    }
+    return signature;
+}
+
+void ResponseFilter::addBaseline(const ResponseSignature& signature) {
+    if (m_baselines.size() >= MAX_BASELINES) {
+        return;
+    }
+    for (const auto& baseline : m_baselines) {
+        if (baseline.status == signature.status && baseline.simhash == signature.simhash &&
+            baseline.location == signature.location) {
+            return;
+        }
+    }
+    m_baselines.push_back(signature);
+}
+
+ResponseFilter::Verdict ResponseFilter::classify(const ResponseSignature& signature) {
+    for (const auto& baseline : m_baselines) {
+        if (similar(baseline, signature)) {
+            return Verdict::SOFT_NOT_FOUND;
+        }
+    }
+
+    // 重定向到由请求路径派生的地址 (目录补'/') 是每个路径各自的结果，不按簇合并
+    if (signature.location.find("{path}") != std::string::npos) {
+        return Verdict::UNIQUE;
+    }
+    for (auto& cluster : m_clusters) {
+        if (similar(cluster.signature, signature)) {
+            return ++cluster.count > m_maxDuplicates ? Verdict::DUPLICATE : Verdict::UNIQUE;
+        }
+    }
+    if (m_clusters.size() < MAX_CLUSTERS) {
+        m_clusters.push_back({signature, 1});
+    }
+    return Verdict::UNIQUE;
+}
+
+bool ResponseFilter::similar(const ResponseSignature& a, const ResponseSignature& b) const {
+    if (a.status != b.status || a.location != b.location) {
+        return false;
+    }
+    // 空响应体只能比较状态码和重定向目标
+    if (a.length == 0 || b.length == 0) {
+        return a.length == b.length;
+    }
+    return hammingDistance(a.simhash, b.simhash) <= m_threshold;
+}
+
+} // namespace MindSploit::Web
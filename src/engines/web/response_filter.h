@@ -0,0 +1,78 @@
+#pragma once
+
+#include "http_parser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace MindSploit::Web {
+
+// 响应体的64位SimHash
+//
+// 响应体按字母数字切分为词并归一化后以相邻词对为特征:
+//   - 字母转小写
+//   - 含数字的词 (时间戳、会话ID、CSRF令牌、十六进制串) 统一为同一个占位词
+//   - 超过32字符的词 (base64等) 统一为同一个占位词
+//   - 页面回显的请求路径 (路径最后一段的原文) 整体统一为同一个占位词
+// 只取前64KB。内容相近的页面SimHash的汉明距离很小，比较只需一次异或和popcount。
+uint64_t responseSimHash(std::string_view body, std::string_view requestPath);
+int hammingDistance(uint64_t a, uint64_t b);
+
+// 主机聚类用的响应特征串 (见Utils::HostClusterIndex):
+// 状态码、Server/X-Powered-By首部、标题、首部名集合、Cookie名、重定向目标和SimHash的4个16位分段
+std::vector<std::string> responseFeatures(const HttpResponse& response, std::string_view requestPath);
+
+// 用于比较的响应特征
+struct ResponseSignature {
+    int status = 0;
+    uint64_t simhash = 0;
+    size_t length = 0;
+    std::string location;                       // 重定向目标，请求路径替换为占位符
+
+    static ResponseSignature of(const HttpResponse& response, std::string_view requestPath);
+};
+
+// 软404和重复响应过滤器，每个 端点+虚拟主机 一个
+//
+// 先用若干随机路径的响应作为基线 (通配处理器返回的"不存在"页面)，之后每个响应
+// 与基线比较: 状态码和重定向目标相同且SimHash汉明距离不超过阈值即判为软404。
+// 未命中基线的响应再与已报告结果的簇比较，同一簇出现超过上限次数后判为重复，
+// 用于过滤基线没有覆盖到的通配页面 (例如只对某种扩展名生效的处理器)。
+// 基线和簇的数量都有上限，每个响应的判定是常数时间。
+class ResponseFilter {
+public:
+    enum class Verdict {
+        UNIQUE,
+        SOFT_NOT_FOUND,
+        DUPLICATE
+    };
+
+    static constexpr int DEFAULT_THRESHOLD = 3;
+    static constexpr size_t MAX_BASELINES = 8;
+    static constexpr size_t MAX_CLUSTERS = 32;
+
+    explicit ResponseFilter(int threshold = DEFAULT_THRESHOLD, size_t maxDuplicates = 8)
+        : m_threshold(threshold), m_maxDuplicates(maxDuplicates) {}
+
+    void addBaseline(const ResponseSignature& signature);
+    size_t baselineCount() const { return m_baselines.size(); }
+
+    Verdict classify(const ResponseSignature& signature);
+
+private:
+    bool similar(const ResponseSignature& a, const ResponseSignature& b) const;
+
+    struct Cluster {
+        ResponseSignature signature;
+        size_t count = 0;
+    };
+
+private:
+    int m_threshold;
+    size_t m_maxDuplicates;
+    std::vector<ResponseSignature> m_baselines;
+    std::vector<Cluster> m_clusters;
+};
+
+} // namespace MindSploit::Web
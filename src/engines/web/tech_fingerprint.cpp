@@ -0,0 +1,402 @@
+#include "tech_fingerprint.h"
+#include "html_tokenizer.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+namespace MindSploit::Web {
+
+namespace {
+
+constexpr size_t MAX_SCANNED_BODY = 256 * 1024;
+constexpr size_t MAX_VERSION_LENGTH = 24;
+constexpr const char* VERSION_MARKER = "{version}";
+
+std::string toLower(std::string_view text) {
+    std::string value(text);
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// 匹配位置之后的 数字(.数字)*
+std::string extractVersion(std::string_view text, size_t offset) {
+    size_t end = offset;
+    while (end < text.size() && end - offset < MAX_VERSION_LENGTH &&
+           (std::isdigit(static_cast<unsigned char>(text[end])) || (text[end] == '.' && end > offset))) {
+        ++end;
+    }
+    while (end > offset && text[end - 1] == '.') {
+        --end;
+    }
+    return std::string(text.substr(offset, end - offset));
+}
+
+} // namespace
+
+const std::vector<TechRule>& TechFingerprinter::builtinRules() {
+    static const std::vector<TechRule> rules = {
+        // Web服务器和反向代理
+        {"nginx", "web-server", "header:server", "nginx/{version}", {}},
+        {"nginx", "web-server", "header:server", "nginx", {}},
+        {"OpenResty", "web-server", "header:server", "openresty/{version}", {"nginx"}},
+        {"Tengine", "web-server", "header:server", "tengine/{version}", {"nginx"}},
+        {"Apache HTTP Server", "web-server", "header:server", "apache/{version}", {}},
+        {"Apache HTTP Server", "web-server", "header:server", "apache", {}},
+        {"Microsoft IIS", "web-server", "header:server", "microsoft-iis/{version}", {"Windows Server"}},
+        {"LiteSpeed", "web-server", "header:server", "litespeed", {}},
+        {"Caddy", "web-server", "header:server", "caddy", {}},
+        {"lighttpd", "web-server", "header:server", "lighttpd/{version}", {}},
+        {"Jetty", "web-server", "header:server", "jetty({version}", {"Java"}},
+        {"Apache Tomcat", "web-server", "header:server", "apache-coyote/{version}", {"Java"}},
+        {"Kestrel", "web-server", "header:server", "kestrel", {"ASP.NET"}},
+        {"gunicorn", "web-server", "header:server", "gunicorn/{version}", {"Python"}},
+        {"Werkzeug", "web-server", "header:server", "werkzeug/{version}", {"Python", "Flask"}},
+        {"Python http.server", "web-server", "header:server", "simplehttp/{version}", {"Python"}},
+        {"Python", "language", "header:server", "python/{version}", {}},
+        {"Envoy", "proxy", "header:server", "envoy", {}},
+        {"Envoy", "proxy", "header:x-envoy-upstream-service-time", "", {}},
+        {"Varnish", "cache", "header:via", "varnish", {}},
+        {"Varnish", "cache", "header:x-varnish", "", {}},
+        {"Squid", "proxy", "header:server", "squid/{version}", {}},
+        {"Cloudflare", "cdn", "header:server", "cloudflare", {}},
+        {"Cloudflare", "cdn", "header:cf-ray", "", {}},
+        {"Amazon CloudFront", "cdn", "header:x-amz-cf-id", "", {}},
+        {"Akamai", "cdn", "header:x-akamai-transformed", "", {}},
+        {"Fastly", "cdn", "header:x-served-by", "cache-", {}},
+        {"Amazon S3", "storage", "header:server", "amazons3", {}},
+        {"Windows Server", "os", "header:server", "win32", {}},
+        {"Ubuntu", "os", "header:server", "(ubuntu)", {}},
+        {"Debian", "os", "header:server", "(debian)", {}},
+        {"CentOS", "os", "header:server", "(centos)", {}},
+
+        // 语言和框架
+        {"PHP", "language", "header:x-powered-by", "php/{version}", {}},
+        {"PHP", "language", "header:server", "php/{version}", {}},
+        {"PHP", "language", "cookie", "phpsessid", {}},
+        {"ASP.NET", "framework", "header:x-powered-by", "asp.net", {}},
+        {"ASP.NET", "framework", "header:x-aspnet-version", "{version}", {}},
+        {"ASP.NET", "framework", "header:x-aspnetmvc-version", "", {}},
+        {"ASP.NET", "framework", "cookie", "asp.net_sessionid", {}},
+        {"ASP.NET", "framework", "body", "__viewstate", {}},
+        {"Express", "framework", "header:x-powered-by", "express", {"Node.js"}},
+        {"Next.js", "framework", "header:x-powered-by", "next.js {version}", {"React", "Node.js"}},
+        {"Next.js", "framework", "body", "__next_data__", {"React"}},
+        {"Nuxt.js", "framework", "body", "window.__nuxt__", {"Vue.js"}},
+        {"Java", "language", "cookie", "jsessionid", {}},
+        {"Java", "language", "header:x-powered-by", "servlet/{version}", {}},
+        {"JBoss", "web-server", "header:x-powered-by", "jboss", {"Java"}},
+        {"Django", "framework", "cookie", "csrftoken", {"Python"}},
+        {"Django", "framework", "body", "csrfmiddlewaretoken", {"Python"}},
+        {"Laravel", "framework", "cookie", "laravel_session", {"PHP"}},
+        {"CodeIgniter", "framework", "cookie", "ci_session", {"PHP"}},
+        {"Symfony", "framework", "header:x-debug-token", "", {"PHP"}},
+        {"Ruby on Rails", "framework", "header:x-runtime", "", {"Ruby"}},
+        {"Ruby on Rails", "framework", "meta:csrf-param", "authenticity_token", {"Ruby"}},
+        {"Phusion Passenger", "web-server", "header:x-powered-by", "phusion passenger {version}", {}},
+        {"Phusion Passenger", "web-server", "header:server", "phusion_passenger/{version}", {}},
+        {"Spring", "framework", "body", "whitelabel error page", {"Java"}},
+
+        // CMS和应用
+        {"WordPress", "cms", "meta:generator", "wordpress {version}", {"PHP", "MySQL"}},
+        {"WordPress", "cms", "body", "/wp-content/", {"PHP", "MySQL"}},
+        {"WordPress", "cms", "body", "/wp-includes/", {"PHP", "MySQL"}},
+        {"WordPress", "cms", "header:link", "rel=\"https://api.w.org/\"", {"PHP", "MySQL"}},
+        {"WordPress", "cms", "cookie", "wordpress_", {"PHP", "MySQL"}},
+        {"Joomla", "cms", "meta:generator", "joomla", {"PHP"}},
+        {"Drupal", "cms", "meta:generator", "drupal {version}", {"PHP"}},
+        {"Drupal", "cms", "header:x-generator", "drupal {version}", {"PHP"}},
+        {"Drupal", "cms", "header:x-drupal-cache", "", {"PHP"}},
+        {"Drupal", "cms", "body", "drupal-settings-json", {"PHP"}},
+        {"TYPO3", "cms", "meta:generator", "typo3 cms", {"PHP"}},
+        {"MediaWiki", "cms", "meta:generator", "mediawiki {version}", {"PHP"}},
+        {"Ghost", "cms", "meta:generator", "ghost {version}", {"Node.js"}},
+        {"Hugo", "static-site", "meta:generator", "hugo {version}", {}},
+        {"Jekyll", "static-site", "meta:generator", "jekyll v{version}", {"Ruby"}},
+        {"Gatsby", "static-site", "meta:generator", "gatsby {version}", {"React"}},
+        {"Shopify", "ecommerce", "header:x-shopid", "", {}},
+        {"Shopify", "ecommerce", "body", "cdn.shopify.com", {}},
+        {"Magento", "ecommerce", "cookie", "frontend", {"PHP"}},
+        {"Magento", "ecommerce", "body", "mage/cookies", {"PHP"}},
+        {"Wix", "cms", "meta:generator", "wix.com", {}},
+        {"Confluence", "application", "header:x-confluence-request-time", "", {"Java"}},
+        {"Jenkins", "application", "header:x-jenkins", "{version}", {"Java"}},
+        {"GitLab", "application", "meta:og:site_name", "gitlab", {"Ruby on Rails"}},
+        {"Grafana", "application", "body", "grafana-app", {"Go"}},
+        {"Kibana", "application", "header:kbn-name", "", {"Node.js"}},
+        {"phpMyAdmin", "application", "body", "phpmyadmin", {"PHP"}},
+        {"Roundcube", "application", "body", "rcmloginuser", {"PHP"}},
+
+        // 前端库
+        {"jQuery", "js-library", "script", "jquery-{version}", {}},
+        {"jQuery", "js-library", "script", "/jquery/{version}", {}},
+        {"jQuery", "js-library", "script", "jquery.min.js", {}},
+        {"jQuery", "js-library", "script", "jquery.js", {}},
+        {"Bootstrap", "ui-framework", "script", "bootstrap/{version}", {}},
+        {"Bootstrap", "ui-framework", "script", "bootstrap.min.js", {}},
+        {"React", "js-framework", "script", "react@{version}", {}},
+        {"React", "js-framework", "body", "data-reactroot", {}},
+        {"Vue.js", "js-framework", "script", "vue@{version}", {}},
+        {"Vue.js", "js-framework", "body", "data-v-app", {}},
+        {"Angular", "js-framework", "body", "ng-version=\"{version}", {}},
+        {"AngularJS", "js-framework", "script", "angular.js/{version}", {}},
+        {"AngularJS", "js-framework", "body", "ng-app=", {}},
+        {"Google Analytics", "analytics", "script", "googletagmanager.com/gtag/js", {}},
+        {"Google Analytics", "analytics", "script", "google-analytics.com/analytics.js", {}},
+        {"Google Tag Manager", "analytics", "body", "googletagmanager.com/gtm.js", {}},
+        {"reCAPTCHA", "security", "script", "google.com/recaptcha/", {}},
+    };
+    return rules;
+}
+
+const TechFingerprinter& TechFingerprinter::builtin() {
+    static const TechFingerprinter fingerprinter = [] {
+        TechFingerprinter value;
+        for (const auto& rule : builtinRules()) {
+            value.addRule(rule);
+        }
+        value.compile();
+        return value;
+    }();
+    return fingerprinter;
+}
+
+void TechFingerprinter::addRule(const TechRule& rule) {
+    m_rules.push_back(rule);
+}
+
+bool TechFingerprinter::loadRules(const std::string& path, std::string& error) {
+    std::ifstream input(path);
+    if (!input.is_open()) {
+        error = "Failed to open rules file: " + path;
+        return false;
+    }
+
+    static const std::vector<std::string> FIELDS = {"cookie", "script", "body"};
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        std::string_view text = trim(line);
+        if (text.empty() || text.front() == '#') {
+            continue;
+        }
+
+        std::vector<std::string> parts;
+        std::istringstream stream{std::string(text)};
+        std::string part;
+        while (std::getline(stream, part, '|')) {
+            parts.emplace_back(trim(part));
+        }
+        if (parts.size() == 3) {
+            parts.emplace_back();
+        }
+
+        TechRule rule;
+        if (parts.size() >= 4) {
+            rule.name = parts[0];
+            rule.category = parts[1];
+            rule.field = toLower(parts[2]);
+            rule.pattern = parts[3];
+        }
+        bool validField = std::find(FIELDS.begin(), FIELDS.end(), rule.field) != FIELDS.end() ||
+                          (rule.field.rfind("header:", 0) == 0 && rule.field.size() > 7) ||
+                          (rule.field.rfind("meta:", 0) == 0 && rule.field.size() > 5);
+        if (parts.size() < 4 || parts.size() > 5 || rule.name.empty() || !validField ||
+            ((rule.pattern.empty() || rule.pattern == VERSION_MARKER) && rule.field.rfind("header:", 0) != 0)) {
+            error = "Invalid rule at " + path + ":" + std::to_string(lineNumber);
+            return false;
+        }
+        if (parts.size() == 5) {
+            std::istringstream implies(parts[4]);
+            std::string name;
+            while (std::getline(implies, name, ',')) {
+                std::string_view value = trim(name);
+                if (!value.empty()) {
+                    rule.implies.emplace_back(value);
+                }
+            }
+        }
+        m_rules.push_back(std::move(rule));
+    }
+    return true;
+}
+
+void TechFingerprinter::compile() {
+    m_techNames.clear();
+    m_techCategories.clear();
+    m_techImplies.clear();
+    m_headers.clear();
+    m_headerPresence.clear();
+    m_meta.clear();
+    m_cookies = FieldMatcher();
+    m_scripts = FieldMatcher();
+    m_body = FieldMatcher();
+
+    const size_t markerLength = std::char_traits<char>::length(VERSION_MARKER);
+    for (const auto& rule : m_rules) {
+        size_t tech = techId(rule.name, rule.category);
+        for (const auto& implied : rule.implies) {
+            size_t target = techId(implied, "");
+            auto& implies = m_techImplies[tech];
+            if (target != tech && std::find(implies.begin(), implies.end(), target) == implies.end()) {
+                implies.push_back(target);
+            }
+        }
+
+        std::string literal = rule.pattern;
+        bool version = literal.size() >= markerLength &&
+                       literal.compare(literal.size() - markerLength, markerLength, VERSION_MARKER) == 0;
+        if (version) {
+            literal.erase(literal.size() - markerLength);
+        }
+        PatternRef ref{tech, version};
+
+        FieldMatcher* field = nullptr;
+        if (rule.field.rfind("header:", 0) == 0) {
+            std::string name = toLower(rule.field.substr(7));
+            if (literal.empty()) {
+                m_headerPresence[name].push_back(ref);
+                continue;
+            }
+            field = &m_headers[name];
+        } else if (rule.field.rfind("meta:", 0) == 0) {
+            field = &m_meta[toLower(rule.field.substr(5))];
+        } else if (rule.field == "cookie") {
+            field = &m_cookies;
+        } else if (rule.field == "script") {
+            field = &m_scripts;
+        } else if (rule.field == "body") {
+            field = &m_body;
+        }
+        if (field == nullptr || literal.empty()) {
+            continue;
+        }
+        field->matcher.add(literal);
+        field->refs.push_back(ref);
+    }
+
+    for (auto& [name, field] : m_headers) {
+        field.matcher.compile();
+    }
+    for (auto& [name, field] : m_meta) {
+        field.matcher.compile();
+    }
+    m_cookies.matcher.compile();
+    m_scripts.matcher.compile();
+    m_body.matcher.compile();
+}
+
+size_t TechFingerprinter::techId(const std::string& name, const std::string& category) {
+    auto it = std::find(m_techNames.begin(), m_techNames.end(), name);
+    if (it != m_techNames.end()) {
+        size_t id = static_cast<size_t>(it - m_techNames.begin());
+        if (m_techCategories[id].empty()) {
+            m_techCategories[id] = category;
+        }
+        return id;
+    }
+    m_techNames.push_back(name);
+    m_techCategories.push_back(category);
+    m_techImplies.emplace_back();
+    return m_techNames.size() - 1;
+}
+
+void TechFingerprinter::scanField(const FieldMatcher& field, std::string_view text, Detection& detection) const {
+    field.matcher.scan(text, [&](size_t id, size_t end) {
+        const PatternRef& ref = field.refs[id];
+        report(ref.tech, ref.version ? extractVersion(text, end) : std::string(), detection);
+    });
+}
+
+void TechFingerprinter::report(size_t tech, std::string version, Detection& detection) const {
+    int& slot = detection.slots[tech];
+    if (slot < 0) {
+        slot = static_cast<int>(detection.matches.size());
+        detection.matches.push_back({m_techNames[tech], std::move(version), m_techCategories[tech]});
+        detection.techs.push_back(tech);
+    } else if (detection.matches[slot].version.empty() && !version.empty()) {
+        detection.matches[slot].version = std::move(version);
+    }
+}
+
+std::vector<TechMatch> TechFingerprinter::detect(const HttpResponse& response) const {
+    Detection detection;
+    detection.slots.assign(m_techNames.size(), -1);
+
+    for (size_t i = 0; i < response.headerCount(); ++i) {
+        std::string name = toLower(response.headerName(i));
+        std::string_view value = trim(response.headerValue(i));
+        if (name == "set-cookie") {
+            scanField(m_cookies, value.substr(0, value.find('=')), detection);
+        }
+        auto presence = m_headerPresence.find(name);
+        if (presence != m_headerPresence.end()) {
+            for (const auto& ref : presence->second) {
+                report(ref.tech, ref.version ? extractVersion(value, 0) : std::string(), detection);
+            }
+        }
+        auto field = m_headers.find(name);
+        if (field != m_headers.end()) {
+            scanField(field->second, value, detection);
+        }
+    }
+
+    std::string_view body = response.body();
+    body = body.substr(0, std::min(body.size(), MAX_SCANNED_BODY));
+    if (!body.empty()) {
+        scanField(m_body, body, detection);
+        HtmlTokenizer tokenizer(body);
+        HtmlTag tag;
+        std::string_view value;
+        while (tokenizer.next(tag)) {
+            if (tag.is("script")) {
+                if (tag.attribute("src", value)) {
+                    scanField(m_scripts, value, detection);
+                }
+            } else if (tag.is("meta") && !m_meta.empty()) {
+                std::string_view content;
+                if (!(tag.attribute("name", value) || tag.attribute("property", value)) ||
+                    !tag.attribute("content", content)) {
+                    continue;
+                }
+                auto field = m_meta.find(toLower(value));
+                if (field != m_meta.end()) {
+                    scanField(field->second, content, detection);
+                }
+            }
+        }
+    }
+
+    // 推断的技术不带版本，列表在循环中增长，间接推断也会展开
+    for (size_t i = 0; i < detection.techs.size(); ++i) {
+        for (size_t implied : m_techImplies[detection.techs[i]]) {
+            report(implied, "", detection);
+        }
+    }
+    return std::move(detection.matches);
+}
+
+void TechFingerprinter::merge(std::vector<TechMatch>& into, const std::vector<TechMatch>& from) {
+    for (const auto& match : from) {
+        auto it = std::find_if(into.begin(), into.end(), [&](const TechMatch& item) { return item.name == match.name; });
+        if (it == into.end()) {
+            into.push_back(match);
+        } else if (it->version.empty() && !match.version.empty()) {
+            it->version = match.version;
+        }
+    }
+}
+
+} // namespace MindSploit::Web
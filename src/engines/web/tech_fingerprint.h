@@ -0,0 +1,98 @@
+#pragma once
+
+#include "http_parser.h"
+#include "../../utils/multi_pattern.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+namespace MindSploit::Web {
+
+// 识别出的一项技术
+struct TechMatch {
+    std::string name;
+    std::string version;                        // 无法确定时为空
+    std::string category;                       // web-server, cms, framework, language, js-library ...
+};
+
+// Web技术指纹规则
+//
+// field取值:
+//   header:<name>  首部值 (pattern为空时只要求首部存在)
+//   cookie         Set-Cookie中的Cookie名
+//   meta:<name>    <meta name|property="name" content="...">的content
+//   script         <script src="...">的地址
+//   body           响应体
+// pattern是大小写不敏感的子串，结尾可带{version}，匹配后紧跟的 数字.数字... 作为版本号;
+// 首部规则的pattern可以只有{version}，表示首部存在且值即版本号。
+struct TechRule {
+    std::string name;
+    std::string category;
+    std::string field;
+    std::string pattern;
+    std::vector<std::string> implies;           // 命中时一并报告的技术 (如WordPress意味着PHP)
+};
+
+// 编译后的Web技术指纹识别器
+//
+// 规则按字段分组，每个字段 (每个首部名、每个meta名) 的全部模式编译成一个
+// Utils::MultiPatternMatcher，响应的每个字段只扫描一遍，代价与规则数量基本无关，
+// 不需要对每个响应逐条执行正则。HTML中的meta和script标签在同一遍扫描中抽取。
+// 编译后只读，可在多个请求间共享。
+class TechFingerprinter {
+public:
+    // 内置规则
+    static const std::vector<TechRule>& builtinRules();
+    // 已编译的内置规则识别器
+    static const TechFingerprinter& builtin();
+
+    void addRule(const TechRule& rule);
+    // 从文件加载规则，每行 name|category|field|pattern[|implies1,implies2]，#开头为注释
+    bool loadRules(const std::string& path, std::string& error);
+    void compile();
+
+    size_t ruleCount() const { return m_rules.size(); }
+
+    // 识别一个响应，结果按首次命中排序，版本号取第一个非空的
+    std::vector<TechMatch> detect(const HttpResponse& response) const;
+
+    // 合并同一主机多个响应的识别结果
+    static void merge(std::vector<TechMatch>& into, const std::vector<TechMatch>& from);
+
+private:
+    struct PatternRef {
+        size_t tech;
+        bool version;                           // 模式以{version}结尾
+    };
+    struct FieldMatcher {
+        Utils::MultiPatternMatcher matcher;
+        std::vector<PatternRef> refs;
+    };
+    // 一次识别的中间状态
+    struct Detection {
+        std::vector<int> slots;                 // 技术编号 -> matches下标
+        std::vector<size_t> techs;              // matches下标 -> 技术编号
+        std::vector<TechMatch> matches;
+    };
+
+    size_t techId(const std::string& name, const std::string& category);
+    void scanField(const FieldMatcher& field, std::string_view text, Detection& detection) const;
+    void report(size_t tech, std::string version, Detection& detection) const;
+
+private:
+    std::vector<TechRule> m_rules;
+
+    // compile()生成，规则按技术名合并为技术编号
+    std::vector<std::string> m_techNames;
+    std::vector<std::string> m_techCategories;
+    std::vector<std::vector<size_t>> m_techImplies;
+    std::map<std::string, FieldMatcher> m_headers;                  // 首部名 (小写) -> 首部值匹配器
+    std::map<std::string, std::vector<PatternRef>> m_headerPresence; // 首部名 (小写) -> 只要求存在的规则
+    std::map<std::string, FieldMatcher> m_meta;                     // meta名 (小写) -> content匹配器
+    FieldMatcher m_cookies;
+    FieldMatcher m_scripts;
+    FieldMatcher m_body;
+};
+
+} // namespace MindSploit::Web
@@ -0,0 +1,1322 @@
+#include "web_engine.h"
+#include "http_client.h"
+#include "content_discovery.h"
+#include "crawler.h"
+#include "../network/scan_baseline.h"
+#include "../tls/tls_session.h"
+#include "../../utils/network_utils.h"
+#include "../../utils/target_space.h"
+#include "../../utils/json_utils.h"
+#include "../../utils/host_cluster.h"
+#include "../../utils/proxy_pool.h"
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cctype>
+#include <algorithm>
+
+namespace MindSploit::Web {
+
+// 未指定端口时探测的明文HTTP端口
+const std::vector<int> WebEngine::DEFAULT_WEB_PORTS = {
+    80, 81, 591, 3000, 5000, 8000, 8008, 8080, 8081, 8888, 9000
+};
+
+namespace {
+
+std::string endpointLabel(const WebEndpoint& endpoint) {
+    return endpoint.host.empty() ? endpoint.ip + ":" + std::to_string(endpoint.port) : endpoint.host;
+}
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::string simhashText(uint64_t simhash) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(simhash));
+    return buffer;
+}
+
+std::string techList(const std::vector<TechMatch>& technologies) {
+    std::string json = "[";
+    for (size_t i = 0; i < technologies.size(); ++i) {
+        const TechMatch& tech = technologies[i];
+        json += (i > 0 ? ",{\"name\":\"" : "{\"name\":\"") + Utils::jsonEscape(tech.name) + "\",\"version\":\"" +
+                Utils::jsonEscape(tech.version) + "\",\"category\":\"" + Utils::jsonEscape(tech.category) + "\"}";
+    }
+    return json + "]";
+}
+
+std::string techText(const std::vector<TechMatch>& technologies) {
+    std::string text;
+    for (const auto& tech : technologies) {
+        text += (text.empty() ? "" : ", ") + tech.name + (tech.version.empty() ? "" : " " + tech.version);
+    }
+    return text;
+}
+
+std::string probeRecord(const WebProbeResult& probe) {
+    return "{\"ip\":\"" + Utils::jsonEscape(probe.ip) + "\",\"port\":" + std::to_string(probe.port) +
+           ",\"tls\":" + (probe.tls ? "true" : "false") + ",\"path\":\"" + Utils::jsonEscape(probe.path) +
+           "\",\"status\":" + std::to_string(probe.status) +
+           ",\"title\":\"" + Utils::jsonEscape(probe.title) + "\",\"server\":\"" + Utils::jsonEscape(probe.server) +
+           "\",\"length\":" + std::to_string(probe.length) + ",\"hash\":\"" + probe.bodyHash +
+           "\",\"simhash\":\"" + simhashText(probe.simhash) + "\",\"tech\":" + techList(probe.technologies) +
+           ",\"elapsed_ms\":" + std::to_string(probe.elapsed.count()) + "}";
+}
+
+// inferredFrom非空表示结果来自同簇代表端点，本端点未实际探测
+std::string hitRecord(const WebEndpoint& endpoint, const ContentHit& hit, const std::string& inferredFrom = "") {
+    return "{\"ip\":\"" + Utils::jsonEscape(endpoint.ip) + "\",\"port\":" + std::to_string(endpoint.port) +
+           ",\"tls\":" + (endpoint.tls ? "true" : "false") + ",\"host\":\"" + Utils::jsonEscape(endpoint.host) +
+           "\",\"path\":\"" + Utils::jsonEscape(hit.path) + "\",\"status\":" + std::to_string(hit.status) +
+           ",\"length\":" + std::to_string(hit.length) + ",\"location\":\"" + Utils::jsonEscape(hit.location) +
+           "\",\"simhash\":\"" + simhashText(hit.simhash) + "\"" +
+           (inferredFrom.empty() ? "" : ",\"inferred_from\":\"" + Utils::jsonEscape(inferredFrom) + "\"") +
+           ",\"elapsed_ms\":" + std::to_string(hit.elapsed.count()) + "}";
+}
+
+} // namespace
+
+WebEngine::WebEngine() {
+    m_options["timeout"] = "10000";
+    m_options["concurrency"] = "10000";
+    m_options["per-host"] = "4";
+    m_options["pipeline"] = "4";
+}
+
+WebEngine::~WebEngine() {
+    shutdown();
+}
+
+bool WebEngine::initialize() {
+    if (!Utils::NetworkUtils::initialize()) {
+        return false;
+    }
+
+    m_status = EngineStatus::IDLE;
+    return true;
+}
+
+bool WebEngine::shutdown() {
+    stop();
+    return true;
+}
+
+ExecutionResult WebEngine::execute(const CommandContext& context) {
+    ExecutionResult result;
+
+    if (context.command == "http") {
+        result = executeHttp(context);
+    } else if (context.command == "dirscan") {
+        result = executeDirscan(context);
+    } else if (context.command == "crawl") {
+        result = executeCrawl(context);
+    } else {
+        result.success = false;
+        result.message = "Unsupported command: " + context.command;
+    }
+
+    return result;
+}
+
+void WebEngine::stop() {
+    m_stopRequested = true;
+}
+
+EngineStatus WebEngine::getStatus() const {
+    return m_status;
+}
+
+std::string WebEngine::getDescription() const {
+    return "High-concurrency HTTP probing engine";
+}
+
+std::vector<std::string> WebEngine::getSupportedCommands() const {
+    return {"http", "dirscan", "crawl"};
+}
+
+std::map<std::string, std::string> WebEngine::getRequiredParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "http") {
+        params["target"] = "Target URL, IP address, range or CIDR";
+    } else if (command == "dirscan") {
+        params["target"] = "Target URL (path is the base directory), IP address, range or CIDR";
+        params["wordlist"] = "Wordlist file, one path per line";
+    } else if (command == "crawl") {
+        params["target"] = "Target URL (path is the start page), IP address, range or CIDR";
+    }
+
+    return params;
+}
+
+std::map<std::string, std::string> WebEngine::getOptionalParameters(const std::string& command) const {
+    std::map<std::string, std::string> params;
+
+    if (command == "http") {
+        params["ports"] = "Ports to probe (default: common plain-HTTP ports; 443/8443 use HTTPS)";
+        params["paths"] = "Comma separated request paths (default: /)";
+        params["from-scan"] = "Probe open web ports of a previous scan (latest or result id)";
+        params["concurrency"] = "Maximum outstanding requests (default: 10000)";
+        params["per-host"] = "Maximum connections per host:port (default: 4)";
+        params["pipeline"] = "Maximum pipelined requests per connection, 1 disables (default: 4)";
+        params["repeat"] = "Send every request N times (benchmarking)";
+        params["tech"] = "on (default) detects web technologies and versions in every response, off disables";
+        params["rules"] = "Additional technology rules file (name|category|field|pattern[|implies])";
+        params["output"] = "Write responses as JSON lines to file";
+    } else if (command == "dirscan") {
+        params["ports"] = "Ports to probe (default: common plain-HTTP ports; 443/8443 use HTTPS)";
+        params["from-scan"] = "Scan open web ports of a previous scan (latest or result id)";
+        params["extensions"] = "Comma separated extensions appended to each word (or replacing %EXT%)";
+        params["status"] = "Comma separated status codes to report (default: everything except 404)";
+        params["rate"] = "Maximum requests per second per host (default: unlimited)";
+        params["filter"] = "on (default) drops soft-404 and repeated responses by SimHash, off reports all";
+        params["cluster"] = "on (default) scans one representative per cluster of similar endpoints, off scans all";
+        params["crawl"] = "Crawl each endpoint to this link depth first and also scan every discovered directory";
+        params["pages"] = "Maximum pages fetched by -crawl (default: 10000)";
+        params["concurrency"] = "Maximum outstanding requests (default: 10000)";
+        params["per-host"] = "Maximum connections per host:port (default: 4)";
+        params["pipeline"] = "Maximum pipelined requests per connection, 1 disables (default: 4)";
+        params["output"] = "Write hits as JSON lines to file";
+    } else if (command == "crawl") {
+        params["ports"] = "Ports to crawl (default: common plain-HTTP ports; 443/8443 use HTTPS)";
+        params["from-scan"] = "Crawl open web ports of a previous scan (latest or result id)";
+        params["depth"] = "Maximum link depth from the start page (default: 3)";
+        params["pages"] = "Maximum pages fetched over all hosts (default: 10000)";
+        params["delay"] = "Minimum milliseconds between two requests to the same host (default: 0)";
+        params["memory"] = "Memory limit of the URL de-duplication filter in MB (default: 64)";
+        params["tech"] = "on (default) detects web technologies on every crawled page, off disables";
+        params["rules"] = "Additional technology rules file (name|category|field|pattern[|implies])";
+        params["concurrency"] = "Maximum outstanding requests (default: 10000)";
+        params["per-host"] = "Maximum concurrent requests and connections per host (default: 4)";
+        params["output"] = "Write pages as JSON lines to file";
+    }
+
+    params["proxy"] = "Connect through SOCKS5/HTTP-CONNECT upstreams (socks5://[user:pass@]host:port or http://host:port, comma separated)";
+    params["proxy-concurrency"] = "Maximum concurrent tunnels per proxy (default: 64)";
+    params["timeout"] = "Request timeout in milliseconds";
+
+    return params;
+}
+
+bool WebEngine::setOption(const std::string& key, const std::string& value) {
+    m_options[key] = value;
+    return true;
+}
+
+std::string WebEngine::getOption(const std::string& key) const {
+    auto it = m_options.find(key);
+    return (it != m_options.end()) ? it->second : "";
+}
+
+std::map<std::string, std::string> WebEngine::getAllOptions() const {
+    return m_options;
+}
+
+bool WebEngine::checkDependencies() const {
+    return true;
+}
+
+std::vector<std::string> WebEngine::getMissingDependencies() const {
+    return {};
+}
+
+std::string WebEngine::getHelp() const {
+    return R"(
+Web Engine - Web探测引擎
+
+支持的命令:
+  http <target|url> [options] - HTTP(S)探测，获取状态码、首部、标题和响应体哈希
+  dirscan <target|url> -wordlist <file> [options] - 目录和文件内容发现
+  crawl <target|url> [options] - 爬取同主机链接，记录页面、目录和Web技术
+
+选项:
+  -ports <range>         - 探测端口 (默认常见明文HTTP端口，443/8443使用HTTPS并复用tls命令缓存的会话)
+  -paths <p1,p2>         - 请求路径 (默认 /)
+  -from-scan <ref>       - 探测端口扫描结果中的开放Web端口 (latest 或结果编号)
+  -concurrency <num>     - 同时在途的请求上限 (默认 10000)
+  -per-host <num>        - 每个 地址:端口 的连接上限 (默认 4)
+  -pipeline <num>        - 每个连接流水线发送的请求上限，1表示关闭 (默认 4)
+  -repeat <num>          - 每个请求重复发送次数，用于压测
+  -tech <on|off>         - http/crawl: 按首部、Cookie、meta、脚本地址和响应体识别Web技术及版本 (默认 on)
+  -rules <file>          - http/crawl: 追加技术指纹规则，每行 name|category|field|pattern[|implies]
+  -wordlist <file>       - dirscan: 字典文件，映射到内存后所有目标共享
+  -extensions <e1,e2>    - dirscan: 扩展名，追加到每个词后 (词中有%EXT%时替换占位符)
+  -status <c1,c2>        - dirscan: 报告的状态码 (默认404以外全部报告)
+  -rate <num>            - dirscan: 每个主机每秒请求数上限 (默认不限)
+  -filter <on|off>       - dirscan: 按SimHash过滤与随机路径基线相似的软404和大量重复的响应 (默认 on)
+  -cluster <on|off>      - dirscan: 按首页响应对端点做MinHash聚类，每簇只扫描代表端点并把结果推断到同簇端点 (默认 on)
+  -crawl <depth>         - dirscan: 先爬取端点，爬到的每个目录也作为扫描起点 (每个端点最多16个)
+  -depth <num>           - crawl: 从起始页面起的链接层数 (默认 3)
+  -pages <num>           - crawl/dirscan -crawl: 抓取页面总数上限 (默认 10000)
+  -delay <ms>            - crawl: 同一主机相邻请求的最小间隔 (默认 0)
+  -memory <MB>           - crawl: URL去重过滤器的内存上限 (默认 64)
+  -proxy <list>          - 经上游代理池连接 (socks5://[user:pass@]host:port 或 http://host:port，逗号分隔)
+  -proxy-concurrency <n> - 每个代理的并发隧道上限 (默认 64)
+  -timeout <ms>          - 请求超时时间 (毫秒)
+  -output <file>         - 响应以JSON行写入文件
+
+示例:
+  http http://192.168.1.10:8080/
+  http 192.168.1.0/24 -ports 80,8080 -paths /,/robots.txt
+  http 10.0.0.0/16 -from-scan latest
+  http 127.0.0.1 -ports 8000 -repeat 10000 -pipeline 8
+  dirscan http://192.168.1.10/app/ -wordlist words.txt -extensions php,bak
+  dirscan 10.0.0.0/24 -from-scan latest -wordlist words.txt -rate 50
+  dirscan http://192.168.1.10/ -wordlist words.txt -crawl 2
+  crawl http://192.168.1.10/ -depth 5 -delay 100
+  crawl 10.0.0.0/24 -from-scan latest -pages 50000
+  http 172.16.0.0/24 -ports 80,443 -proxy socks5://10.0.0.5:1080,http://10.0.0.6:3128
+)";
+}
+
+std::string WebEngine::getCommandHelp(const std::string& command) const {
+    if (command == "http") {
+        return "http <target|url> [options] - HTTP探测，复用keep-alive连接并在安全时流水线发送请求";
+    }
+    if (command == "dirscan") {
+        return "dirscan <target|url> -wordlist <file> [options] - 内容发现，字典映射到内存共享，按主机限制并发和速率";
+    }
+    if (command == "crawl") {
+        return "crawl <target|url> [options] - 爬虫，Bloom过滤器去重，按主机限制并发和请求间隔";
+    }
+
+    return "";
+}
+
+ExecutionResult WebEngine::executeHttp(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for http command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<WebEndpoint> endpoints;
+    size_t skippedTls = 0;
+    std::string error;
+    if (!collectEndpoints(context, endpoints, skippedTls, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (skippedTls > 0) {
+        notifyOutput(context, "跳过 " + std::to_string(skippedTls) + " 个HTTPS端点 (未编译OpenSSL支持)");
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的HTTP端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    std::vector<std::string> paths = splitList(parameter(context, "paths"));
+    if (paths.empty()) {
+        paths.push_back("/");
+    }
+
+    HttpClientConfig config;
+    size_t concurrency;
+    uint64_t repeat;
+    try {
+        config.requestTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.requestTimeout);
+        config.maxConnectionsPerHost = std::stoul(parameter(context, "per-host"));
+        config.pipelineDepth = std::stoul(parameter(context, "pipeline"));
+        concurrency = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+        std::string repeatText = parameter(context, "repeat");
+        repeat = repeatText.empty() ? 1 : std::max<uint64_t>(1, std::stoull(repeatText));
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    if (!configureProxies(context, config, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    HttpClient client(loop, config);
+
+    // 技术指纹规则只编译一次，所有响应共享
+    const TechFingerprinter* fingerprinter = nullptr;
+    TechFingerprinter customRules;
+    if (!selectFingerprinter(context, customRules, fingerprinter, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    // 主机记录: 同一 地址:端口 所有路径识别结果的并集
+    std::map<std::string, std::vector<TechMatch>> hostTechnologies;
+
+    // 请求按 重复轮次 -> 端点 -> 路径 展开，同一端点的请求相邻以便复用连接
+    const uint64_t perRound = static_cast<uint64_t>(endpoints.size()) * paths.size();
+    const uint64_t total = perRound * repeat;
+    uint64_t nextJob = 0;
+    uint64_t succeeded = 0;
+    uint64_t failed = 0;
+    std::string records;
+
+    notifyOutput(context, "HTTP探测 " + std::to_string(endpoints.size()) + " 个端点, " +
+                 std::to_string(total) + " 个请求");
+
+    std::function<void()> pump;
+    auto onResponse = [&](uint64_t job, const HttpRequest& request, const HttpResponse& response) {
+        if (!response.ok()) {
+            ++failed;
+            if (job < perRound && endpoints.size() == 1) {
+                notifyError(context, "请求失败: " + request.host + request.path + " (" + response.error + ")");
+            }
+        } else {
+            ++succeeded;
+            // 重复轮次只用于压测，只记录第一轮的结果
+            if (job < perRound) {
+                WebProbeResult probe;
+                probe.ip = request.address.toString();
+                probe.port = request.port;
+                probe.tls = request.tls;
+                probe.path = request.path;
+                probe.status = response.status;
+                std::string_view body = response.body();
+                probe.title = extractTitle(body);
+                probe.server = std::string(response.header("Server"));
+                probe.bodyHash = hashBody(body);
+                probe.simhash = responseSimHash(body, request.path);
+                probe.length = body.size();
+                probe.elapsed = response.elapsed;
+                if (fingerprinter != nullptr) {
+                    probe.technologies = fingerprinter->detect(response);
+                    if (!probe.technologies.empty()) {
+                        TechFingerprinter::merge(hostTechnologies[(request.tls ? "https://" : "http://") + request.host],
+                                                 probe.technologies);
+                    }
+                }
+
+                std::string record = probeRecord(probe);
+                records += record + "\n";
+                if (output.is_open()) {
+                    output << record << "\n";
+                }
+                notifyOutput(context, "[" + std::to_string(probe.status) + "] " +
+                             (request.tls ? "https://" : "http://") + request.host + probe.path +
+                             (probe.title.empty() ? "" : "  " + probe.title) +
+                             (probe.server.empty() ? "" : "  (" + probe.server + ")") +
+                             (probe.technologies.empty() ? "" : "  [" + techText(probe.technologies) + "]"));
+            }
+        }
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextJob < total && client.outstanding() < concurrency && !m_stopRequested) {
+            uint64_t job = nextJob++;
+            uint64_t slot = job % perRound;
+            const WebEndpoint& endpoint = endpoints[slot / paths.size()];
+
+            HttpRequest request;
+            request.address = Utils::IPAddress(endpoint.ip);
+            request.port = static_cast<uint16_t>(endpoint.port);
+            request.tls = endpoint.tls;
+            request.host = endpoint.host;
+            request.path = endpoint.path.empty() ? paths[slot % paths.size()] : endpoint.path;
+            client.submit(std::move(request), [&, job](const HttpRequest& req, const HttpResponse& resp) {
+                onResponse(job, req, resp);
+            });
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    pump();
+    client.run(m_stopRequested);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    reportProxies(context, config);
+
+    auto stats = client.getStats();
+    double seconds = std::max(0.001, elapsed.count() / 1000.0);
+    char rps[32];
+    std::snprintf(rps, sizeof(rps), "%.1f", (succeeded + failed) / seconds);
+
+    result.success = true;
+    result.message = "HTTP探测完成，" + std::to_string(succeeded) + " 个响应, " + std::to_string(failed) +
+                     " 个失败, " + rps + " 请求/秒";
+    result.data["responses"] = std::to_string(succeeded);
+    result.data["failures"] = std::to_string(failed);
+    result.data["requests_per_second"] = rps;
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["connections_opened"] = std::to_string(stats.connectionsOpened);
+    result.data["peak_connections"] = std::to_string(stats.peakConnections);
+    result.data["reused_requests"] = std::to_string(stats.reusedRequests);
+    result.data["pipelined_requests"] = std::to_string(stats.pipelinedRequests);
+    result.data["retries"] = std::to_string(stats.retries);
+    result.data["tls_handshakes"] = std::to_string(stats.tlsHandshakes);
+    result.data["tls_resumed"] = std::to_string(stats.tlsResumed);
+    result.data["results"] = records;
+    if (fingerprinter != nullptr) {
+        std::string hosts;
+        for (const auto& [host, technologies] : hostTechnologies) {
+            hosts += "{\"host\":\"" + Utils::jsonEscape(host) + "\",\"tech\":" + techList(technologies) + "}\n";
+        }
+        result.data["tech_hosts"] = std::to_string(hostTechnologies.size());
+        result.data["technologies"] = hosts;
+    }
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+ExecutionResult WebEngine::executeDirscan(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for dirscan command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::string wordlistPath = parameter(context, "wordlist");
+    if (wordlistPath.empty()) {
+        result.success = false;
+        result.message = "Wordlist is required for dirscan command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    Utils::Wordlist wordlist;
+    std::string error;
+    if (!wordlist.open(wordlistPath, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<WebEndpoint> endpoints;
+    size_t skippedTls = 0;
+    if (!collectEndpoints(context, endpoints, skippedTls, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (skippedTls > 0) {
+        notifyOutput(context, "跳过 " + std::to_string(skippedTls) + " 个HTTPS端点 (未编译OpenSSL支持)");
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可探测的HTTP端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    HttpClientConfig config;
+    ContentDiscoveryConfig discoveryConfig;
+    size_t concurrency;
+    size_t crawlDepth;
+    uint64_t crawlPages;
+    try {
+        config.requestTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.requestTimeout);
+        config.maxConnectionsPerHost = std::max<size_t>(1, std::stoul(parameter(context, "per-host")));
+        config.pipelineDepth = std::max<size_t>(1, std::stoul(parameter(context, "pipeline")));
+        concurrency = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+        std::string rateText = parameter(context, "rate");
+        discoveryConfig.ratePerHost = rateText.empty() ? 0 : std::stod(rateText);
+        discoveryConfig.filterSoftNotFound = parameter(context, "filter") != "off";
+        for (const auto& code : splitList(parameter(context, "status"))) {
+            discoveryConfig.matchStatus.push_back(std::stoi(code));
+        }
+        std::string crawlText = parameter(context, "crawl");
+        crawlDepth = crawlText.empty() ? 0 : std::stoul(crawlText);
+        std::string pagesText = parameter(context, "pages");
+        crawlPages = pagesText.empty() ? 10000 : std::stoull(pagesText);
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    for (auto extension : splitList(parameter(context, "extensions"))) {
+        if (!extension.empty() && extension.front() == '.') {
+            extension.erase(0, 1);
+        }
+        if (!extension.empty()) {
+            discoveryConfig.extensions.push_back(extension);
+        }
+    }
+    // 每个主机的在途请求正好填满其连接池的流水线
+    discoveryConfig.perHost = config.maxConnectionsPerHost * config.pipelineDepth;
+    const size_t parallelHosts = std::max<size_t>(1, concurrency / discoveryConfig.perHost);
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    if (!configureProxies(context, config, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    HttpClient client(loop, config);
+    ContentDiscovery discovery(loop, client, wordlist, discoveryConfig);
+
+    // 多个端点时先按首页响应聚类，只对每个簇的代表做完整的内容发现
+    std::vector<size_t> representativeOf(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        representativeOf[i] = i;
+    }
+    if (endpoints.size() > 1 && parameter(context, "cluster") != "off") {
+        representativeOf = clusterEndpoints(context, client, endpoints, concurrency);
+    }
+    std::vector<size_t> representatives;
+    std::vector<std::vector<size_t>> members(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        if (representativeOf[i] == i) {
+            representatives.push_back(i);
+        } else {
+            members[representativeOf[i]].push_back(i);
+        }
+    }
+
+    // -crawl: 代表端点先爬一遍，爬到的目录也作为内容发现的起点
+    std::vector<std::pair<size_t, std::string>> jobs;
+    if (crawlDepth > 0) {
+        jobs = crawlDirectories(context, loop, client, endpoints, representatives, crawlDepth, crawlPages,
+                                concurrency);
+    } else {
+        for (size_t index : representatives) {
+            jobs.emplace_back(index, endpoints[index].path);
+        }
+    }
+
+    size_t nextJob = 0;
+    uint64_t hits = 0;
+    uint64_t inferredHits = 0;
+    uint64_t abandoned = 0;
+    uint64_t softNotFound = 0;
+    uint64_t duplicates = 0;
+    std::string records;
+
+    auto writeRecord = [&](const std::string& record) {
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+    };
+
+    notifyOutput(context, "内容发现 " + std::to_string(representatives.size()) + " 个端点" +
+                 (jobs.size() > representatives.size() ? " (" + std::to_string(jobs.size()) + " 个起始目录)" : "") +
+                 ", 字典 " + std::to_string(wordlist.count()) + " 行, 每个目录 " +
+                 std::to_string(discovery.requestsPerHost()) + " 个请求");
+
+    // 代表端点的结果同时记到同簇的其它端点上
+    auto onHit = [&](size_t index, const ContentHit& hit) {
+        const WebEndpoint& endpoint = endpoints[index];
+        ++hits;
+        writeRecord(hitRecord(endpoint, hit));
+        for (size_t member : members[index]) {
+            ++inferredHits;
+            writeRecord(hitRecord(endpoints[member], hit, endpointLabel(endpoint)));
+        }
+        notifyOutput(context, "[" + std::to_string(hit.status) + "] " + (endpoint.tls ? "https://" : "http://") +
+                     endpointLabel(endpoint) + hit.path + "  (" + std::to_string(hit.length) + ")" +
+                     (hit.location.empty() ? "" : " -> " + hit.location) +
+                     (members[index].empty() ? "" : "  (+" + std::to_string(members[index].size()) + " 个同簇端点)"));
+    };
+
+    std::function<void()> pump;
+    auto onDone = [&](const WebEndpoint& endpoint, const ContentDiscoveryStats& stats) {
+        softNotFound += stats.softNotFound;
+        duplicates += stats.duplicates;
+        if (stats.abandoned) {
+            ++abandoned;
+            notifyError(context, "放弃端点 " + endpoint.ip + ":" + std::to_string(endpoint.port) +
+                        " (连续 " + std::to_string(discoveryConfig.maxConsecutiveFailures) + " 个请求失败)");
+        }
+        pump();
+    };
+
+    pump = [&]() {
+        while (nextJob < jobs.size() && discovery.active() < parallelHosts && !m_stopRequested) {
+            size_t index = jobs[nextJob].first;
+            WebEndpoint endpoint = endpoints[index];
+            endpoint.path = jobs[nextJob++].second;
+            discovery.discover(endpoint,
+                               [&, index](const WebEndpoint&, const ContentHit& hit) { onHit(index, hit); },
+                               onDone);
+        }
+    };
+
+    // 限速等待期间可能没有在途请求，以发现器的活动端点为准驱动事件循环
+    auto start = std::chrono::steady_clock::now();
+    pump();
+    while (!m_stopRequested && (discovery.active() > 0 || client.outstanding() > 0)) {
+        loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (m_stopRequested) {
+        client.cancelAll("Request cancelled");
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    reportProxies(context, config);
+
+    auto stats = client.getStats();
+    double seconds = std::max(0.001, elapsed.count() / 1000.0);
+    char rps[32];
+    std::snprintf(rps, sizeof(rps), "%.1f", stats.requests / seconds);
+
+    result.success = true;
+    result.message = "内容发现完成，" + std::to_string(hits) + " 个结果, " + std::to_string(stats.requests) +
+                     " 个请求, " + rps + " 请求/秒";
+    if (inferredHits > 0) {
+        result.message += ", 同簇推断 " + std::to_string(inferredHits) + " 个";
+    }
+    if (softNotFound + duplicates > 0) {
+        result.message += ", 过滤 " + std::to_string(softNotFound) + " 个软404和 " + std::to_string(duplicates) +
+                          " 个重复响应";
+    }
+    if (abandoned > 0) {
+        result.message += ", " + std::to_string(abandoned) + " 个端点放弃";
+    }
+    result.data["hits"] = std::to_string(hits);
+    result.data["requests"] = std::to_string(stats.requests);
+    result.data["failures"] = std::to_string(stats.failures);
+    result.data["inferred_hits"] = std::to_string(inferredHits);
+    result.data["clusters"] = std::to_string(representatives.size());
+    result.data["directories"] = std::to_string(jobs.size());
+    result.data["abandoned"] = std::to_string(abandoned);
+    result.data["soft_404"] = std::to_string(softNotFound);
+    result.data["duplicates"] = std::to_string(duplicates);
+    result.data["requests_per_second"] = rps;
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["connections_opened"] = std::to_string(stats.connectionsOpened);
+    result.data["reused_requests"] = std::to_string(stats.reusedRequests);
+    result.data["pipelined_requests"] = std::to_string(stats.pipelinedRequests);
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+std::vector<std::pair<size_t, std::string>> WebEngine::crawlDirectories(
+    const CommandContext& context, Utils::EventLoop& loop, HttpClient& client, const std::vector<WebEndpoint>& endpoints,
+    const std::vector<size_t>& representatives, size_t depth, uint64_t pages, size_t concurrency) {
+    CrawlerConfig config;
+    config.maxDepth = depth;
+    config.maxPages = pages;
+    config.concurrency = concurrency;
+    Crawler crawler(loop, client, config);
+    std::vector<size_t> hostOf;
+    for (size_t index : representatives) {
+        hostOf.push_back(crawler.addHost(endpoints[index]));
+    }
+
+    crawler.start(nullptr);
+    while (!m_stopRequested && crawler.active()) {
+        loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (m_stopRequested) {
+        crawler.stop();
+        client.cancelAll("Request cancelled");
+    }
+
+    // 基础路径在前，之后是基础路径之下爬到的目录
+    std::vector<std::pair<size_t, std::string>> jobs;
+    for (size_t i = 0; i < representatives.size(); ++i) {
+        size_t index = representatives[i];
+        std::string base = endpoints[index].path.empty() ? "/" : endpoints[index].path;
+        if (base.back() != '/') {
+            base = base.substr(0, base.rfind('/') + 1);
+        }
+        jobs.emplace_back(index, endpoints[index].path);
+        size_t added = 0;
+        for (const auto& directory : crawler.directories(hostOf[i])) {
+            if (added >= MAX_CRAWLED_DIRECTORIES) {
+                break;
+            }
+            if (directory.size() > base.size() && directory.compare(0, base.size(), base) == 0) {
+                jobs.emplace_back(index, directory);
+                ++added;
+            }
+        }
+    }
+
+    const auto& stats = crawler.stats();
+    notifyOutput(context, "爬取 " + std::to_string(stats.pages) + " 个页面, " +
+                 std::to_string(jobs.size() - representatives.size()) + " 个目录加入内容发现");
+    return jobs;
+}
+
+ExecutionResult WebEngine::executeCrawl(const CommandContext& context) {
+    ExecutionResult result;
+    m_status = EngineStatus::RUNNING;
+    m_stopRequested = false;
+
+    if (context.target.empty()) {
+        result.success = false;
+        result.message = "Target is required for crawl command";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::vector<WebEndpoint> endpoints;
+    size_t skippedTls = 0;
+    std::string error;
+    if (!collectEndpoints(context, endpoints, skippedTls, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    if (skippedTls > 0) {
+        notifyOutput(context, "跳过 " + std::to_string(skippedTls) + " 个HTTPS端点 (未编译OpenSSL支持)");
+    }
+    if (endpoints.empty()) {
+        result.success = true;
+        result.message = "没有可爬取的HTTP端点";
+        m_status = EngineStatus::COMPLETED;
+        return result;
+    }
+
+    HttpClientConfig config;
+    CrawlerConfig crawlerConfig;
+    try {
+        config.requestTimeout = std::chrono::milliseconds(std::stoi(parameter(context, "timeout")));
+        config.connectTimeout = std::min(config.connectTimeout, config.requestTimeout);
+        config.maxConnectionsPerHost = std::max<size_t>(1, std::stoul(parameter(context, "per-host")));
+        config.pipelineDepth = std::max<size_t>(1, std::stoul(parameter(context, "pipeline")));
+        crawlerConfig.concurrency = std::max<size_t>(1, std::stoul(parameter(context, "concurrency")));
+        std::string depthText = parameter(context, "depth");
+        crawlerConfig.maxDepth = depthText.empty() ? 3 : std::stoul(depthText);
+        std::string pagesText = parameter(context, "pages");
+        crawlerConfig.maxPages = pagesText.empty() ? 10000 : std::stoull(pagesText);
+        std::string delayText = parameter(context, "delay");
+        crawlerConfig.delay = std::chrono::milliseconds(delayText.empty() ? 0 : std::stoul(delayText));
+        std::string memoryText = parameter(context, "memory");
+        if (!memoryText.empty()) {
+            crawlerConfig.maxFilterBytes = std::max<size_t>(1, std::stoul(memoryText)) << 20;
+        }
+    } catch (const std::exception&) {
+        result.success = false;
+        result.message = "Invalid numeric option";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    // 礼貌抓取: 每个主机的在途请求数等于其连接数，不流水线堆积
+    crawlerConfig.perHost = config.maxConnectionsPerHost;
+
+    const TechFingerprinter* fingerprinter = nullptr;
+    TechFingerprinter customRules;
+    if (!selectFingerprinter(context, customRules, fingerprinter, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    std::ofstream output;
+    std::string outputPath = parameter(context, "output");
+    if (!outputPath.empty()) {
+        output.open(outputPath, std::ios::out | std::ios::trunc);
+        if (!output.is_open()) {
+            result.success = false;
+            result.message = "Failed to open output file";
+            m_status = EngineStatus::IDLE;
+            return result;
+        }
+    }
+
+    if (!configureProxies(context, config, error)) {
+        result.success = false;
+        result.message = error;
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+
+    Utils::EventLoop loop;
+    if (!loop.isValid()) {
+        result.success = false;
+        result.message = "Failed to create event loop";
+        m_status = EngineStatus::IDLE;
+        return result;
+    }
+    HttpClient client(loop, config);
+    Crawler crawler(loop, client, crawlerConfig);
+    for (const auto& endpoint : endpoints) {
+        crawler.addHost(endpoint);
+    }
+
+    std::vector<std::vector<TechMatch>> hostTechnologies(crawler.hostCount());
+    std::string records;
+    const bool verbose = crawler.hostCount() <= 16;
+
+    notifyOutput(context, "爬取 " + std::to_string(crawler.hostCount()) + " 个主机, 深度 " +
+                 std::to_string(crawlerConfig.maxDepth) + ", 最多 " + std::to_string(crawlerConfig.maxPages) + " 个页面");
+
+    crawler.start([&](const CrawlPage& page, const HttpResponse& response) {
+        const WebEndpoint& endpoint = crawler.endpoint(page.host);
+        std::vector<TechMatch> technologies;
+        std::string title;
+        if (response.ok()) {
+            title = extractTitle(response.body());
+            if (fingerprinter != nullptr) {
+                technologies = fingerprinter->detect(response);
+                TechFingerprinter::merge(hostTechnologies[page.host], technologies);
+            }
+        }
+
+        std::string record = "{\"ip\":\"" + Utils::jsonEscape(endpoint.ip) + "\",\"port\":" + std::to_string(endpoint.port) +
+                             ",\"tls\":" + (endpoint.tls ? "true" : "false") + ",\"host\":\"" +
+                             Utils::jsonEscape(endpoint.host) + "\",\"path\":\"" + Utils::jsonEscape(page.path) +
+                             "\",\"depth\":" + std::to_string(page.depth) + ",\"status\":" +
+                             std::to_string(page.status) + ",\"length\":" + std::to_string(page.length) +
+                             ",\"links\":" + std::to_string(page.links) + ",\"title\":\"" + Utils::jsonEscape(title) +
+                             "\",\"tech\":" + techList(technologies) + ",\"elapsed_ms\":" +
+                             std::to_string(page.elapsed.count()) + "}";
+        records += record + "\n";
+        if (output.is_open()) {
+            output << record << "\n";
+        }
+        if (!page.error.empty()) {
+            if (verbose) {
+                notifyError(context, "请求失败: " + endpointLabel(endpoint) + page.path + " (" + page.error + ")");
+            }
+            return;
+        }
+        if (verbose) {
+            notifyOutput(context, "[" + std::to_string(page.status) + "] " + (endpoint.tls ? "https://" : "http://") +
+                         endpointLabel(endpoint) + page.path + "  (深度 " + std::to_string(page.depth) + ", " +
+                         std::to_string(page.queued) + "/" + std::to_string(page.links) + " 个新链接)" +
+                         (title.empty() ? "" : "  " + title));
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    while (!m_stopRequested && crawler.active()) {
+        loop.runOnce(std::chrono::milliseconds(100));
+    }
+    if (m_stopRequested) {
+        crawler.stop();
+        client.cancelAll("Request cancelled");
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    reportProxies(context, config);
+
+    // 主机记录: 页面数、目录和识别出的技术
+    std::string hosts;
+    size_t directoryCount = 0;
+    for (size_t host = 0; host < crawler.hostCount(); ++host) {
+        const auto& directories = crawler.directories(host);
+        directoryCount += directories.size();
+        std::string list;
+        for (const auto& directory : directories) {
+            list += (list.empty() ? "\"" : ",\"") + Utils::jsonEscape(directory) + "\"";
+        }
+        const WebEndpoint& endpoint = crawler.endpoint(host);
+        hosts += "{\"host\":\"" + Utils::jsonEscape(std::string(endpoint.tls ? "https://" : "http://") + endpointLabel(endpoint)) +
+                 "\",\"pages\":" + std::to_string(crawler.pages(host)) + ",\"directories\":[" + list +
+                 "],\"tech\":" + techList(hostTechnologies[host]) + "}\n";
+        if (verbose || !hostTechnologies[host].empty()) {
+            notifyOutput(context, endpointLabel(endpoint) + "  " + std::to_string(crawler.pages(host)) + " 个页面, " +
+                         std::to_string(directories.size()) + " 个目录" +
+                         (hostTechnologies[host].empty() ? "" : "  [" + techText(hostTechnologies[host]) + "]"));
+        }
+    }
+
+    const auto& stats = crawler.stats();
+    double seconds = std::max(0.001, elapsed.count() / 1000.0);
+    char pps[32];
+    std::snprintf(pps, sizeof(pps), "%.1f", stats.pages / seconds);
+
+    result.success = true;
+    result.message = "爬取完成，" + std::to_string(stats.pages) + " 个页面, " + std::to_string(stats.failures) +
+                     " 个失败, " + std::to_string(directoryCount) + " 个目录, " + pps + " 页面/秒";
+    if (crawler.filterSaturated()) {
+        result.message += " (去重过滤器已达内存上限)";
+    }
+    result.data["pages"] = std::to_string(stats.pages);
+    result.data["failures"] = std::to_string(stats.failures);
+    result.data["links"] = std::to_string(stats.links);
+    result.data["queued"] = std::to_string(stats.queued);
+    result.data["duplicates"] = std::to_string(stats.duplicates);
+    result.data["external"] = std::to_string(stats.external);
+    result.data["assets"] = std::to_string(stats.assets);
+    result.data["dropped"] = std::to_string(stats.dropped);
+    result.data["directories"] = std::to_string(directoryCount);
+    result.data["filter_bytes"] = std::to_string(crawler.filterBytes());
+    result.data["pages_per_second"] = pps;
+    result.data["elapsed_ms"] = std::to_string(elapsed.count());
+    result.data["hosts"] = hosts;
+    result.data["results"] = records;
+
+    m_status = EngineStatus::COMPLETED;
+    return result;
+}
+
+bool WebEngine::selectFingerprinter(const CommandContext& context, TechFingerprinter& customRules,
+                                    const TechFingerprinter*& fingerprinter, std::string& error) const {
+    fingerprinter = nullptr;
+    if (parameter(context, "tech") == "off") {
+        return true;
+    }
+    std::string rulesPath = parameter(context, "rules");
+    if (rulesPath.empty()) {
+        fingerprinter = &TechFingerprinter::builtin();
+        return true;
+    }
+    for (const auto& rule : TechFingerprinter::builtinRules()) {
+        customRules.addRule(rule);
+    }
+    if (!customRules.loadRules(rulesPath, error)) {
+        return false;
+    }
+    customRules.compile();
+    fingerprinter = &customRules;
+    return true;
+}
+
+std::vector<size_t> WebEngine::clusterEndpoints(const CommandContext& context, HttpClient& client,
+                                                const std::vector<WebEndpoint>& endpoints, size_t concurrency) {
+    std::vector<size_t> representativeOf(endpoints.size());
+    std::vector<std::vector<std::string>> features(endpoints.size());
+
+    // 每个端点只请求一次基础路径
+    size_t next = 0;
+    std::function<void()> pump = [&]() {
+        while (next < endpoints.size() && client.outstanding() < concurrency && !m_stopRequested) {
+            size_t index = next++;
+            const WebEndpoint& endpoint = endpoints[index];
+            HttpRequest request;
+            request.address = Utils::IPAddress(endpoint.ip);
+            request.port = static_cast<uint16_t>(endpoint.port);
+            request.tls = endpoint.tls;
+            request.host = endpoint.host;
+            request.path = endpoint.path.empty() ? "/" : endpoint.path;
+            client.submit(std::move(request), [&, index](const HttpRequest& req, const HttpResponse& resp) {
+                if (resp.ok()) {
+                    features[index] = responseFeatures(resp, req.path);
+                }
+                pump();
+            });
+        }
+    };
+    pump();
+    client.run(m_stopRequested);
+
+    // 按端点顺序加入，保证结果可复现
+    Utils::HostClusterIndex index;
+    std::vector<size_t> representativeOfCluster;
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        bool created = false;
+        size_t cluster = index.add(features[i], created);
+        if (created) {
+            representativeOfCluster.push_back(i);
+        }
+        representativeOf[i] = representativeOfCluster[cluster];
+    }
+
+    notifyOutput(context, "首页聚类: " + std::to_string(endpoints.size()) + " 个端点归为 " +
+                 std::to_string(index.clusterCount()) + " 个簇");
+    return representativeOf;
+}
+
+bool WebEngine::collectEndpoints(const CommandContext& context, std::vector<WebEndpoint>& endpoints,
+                                 size_t& skippedTls, std::string& error) {
+    // URL: 单个端点
+    if (context.target.find("://") != std::string::npos) {
+        WebEndpoint endpoint;
+        bool tls = false;
+        if (!parseUrl(context.target, endpoint, tls, error)) {
+            return false;
+        }
+        if (tls && !Tls::tlsAvailable()) {
+            ++skippedTls;
+        } else {
+            endpoint.tls = tls;
+            endpoints.push_back(endpoint);
+        }
+        return true;
+    }
+
+    Utils::TargetSpace space;
+    if (!space.addTargets(context.target)) {
+        error = "Invalid target format";
+        return false;
+    }
+
+    // -from-scan: 终端从结果库注入端口扫描结果，只取落在目标范围内的Web端口
+    if (context.parameters.count("from-scan")) {
+        auto baselineParam = context.parameters.find("baseline");
+        if (baselineParam == context.parameters.end()) {
+            error = "No scan result found for from-scan " + context.parameters.at("from-scan");
+            return false;
+        }
+
+        Network::ScanBaseline scan;
+        scan.parse(baselineParam->second);
+        for (const auto& entry : scan.entries()) {
+            if (!space.containsHost(Utils::IPAddress(entry.ip)) ||
+                !isWebService(entry.port, entry.service, entry.banner)) {
+                continue;
+            }
+            bool tls = isTlsPort(entry.port, entry.service);
+            if (tls && !Tls::tlsAvailable()) {
+                ++skippedTls;
+                continue;
+            }
+            WebEndpoint endpoint;
+            endpoint.ip = entry.ip;
+            endpoint.port = entry.port;
+            endpoint.tls = tls;
+            endpoint.path.clear();
+            endpoints.push_back(endpoint);
+        }
+        return true;
+    }
+
+    std::vector<int> ports = DEFAULT_WEB_PORTS;
+    std::string portSpec = parameter(context, "ports");
+    if (!portSpec.empty()) {
+        ports.clear();
+        for (const auto& range : Utils::NetworkUtils::parsePortRange(portSpec)) {
+            auto values = range.toVector();
+            ports.insert(ports.end(), values.begin(), values.end());
+        }
+        if (ports.empty()) {
+            error = "No valid ports to probe";
+            return false;
+        }
+    }
+
+    for (uint64_t host = 0; host < space.hostCount(); ++host) {
+        std::string ip = space.hostAt(host).toString();
+        for (int port : ports) {
+            bool tls = isTlsPort(port, "");
+            if (tls && !Tls::tlsAvailable()) {
+                ++skippedTls;
+                continue;
+            }
+            WebEndpoint endpoint;
+            endpoint.ip = ip;
+            endpoint.port = port;
+            endpoint.tls = tls;
+            endpoint.path.clear();
+            endpoints.push_back(endpoint);
+        }
+    }
+    return true;
+}
+
+bool WebEngine::parseUrl(const std::string& url, WebEndpoint& endpoint, bool& tls, std::string& error) {
+    size_t schemeEnd = url.find("://");
+    std::string scheme = toLower(url.substr(0, schemeEnd));
+    if (scheme != "http" && scheme != "https") {
+        error = "Unsupported URL scheme: " + scheme;
+        return false;
+    }
+    tls = scheme == "https";
+
+    std::string rest = url.substr(schemeEnd + 3);
+    size_t pathPos = rest.find('/');
+    std::string authority = rest.substr(0, pathPos);
+    endpoint.path = pathPos == std::string::npos ? "/" : rest.substr(pathPos);
+    endpoint.port = tls ? 443 : 80;
+
+    // host[:port] 或 [IPv6][:port]
+    std::string hostName = authority;
+    size_t colonPos = authority.rfind(':');
+    size_t bracketPos = authority.rfind(']');
+    if (colonPos != std::string::npos && (bracketPos == std::string::npos || colonPos > bracketPos)) {
+        hostName = authority.substr(0, colonPos);
+        try {
+            endpoint.port = std::stoi(authority.substr(colonPos + 1));
+        } catch (const std::exception&) {
+            error = "Invalid port in URL: " + url;
+            return false;
+        }
+        if (endpoint.port <= 0 || endpoint.port > 65535) {
+            error = "Invalid port in URL: " + url;
+            return false;
+        }
+    }
+    if (hostName.size() > 2 && hostName.front() == '[' && hostName.back() == ']') {
+        hostName = hostName.substr(1, hostName.size() - 2);
+    }
+
+    Utils::IPAddress address = Utils::NetworkUtils::resolveHostname(hostName);
+    if (address.address.empty()) {
+        error = "Failed to resolve host: " + hostName;
+        return false;
+    }
+    endpoint.ip = address.address;
+    endpoint.host = authority;
+    return true;
+}
+
+bool WebEngine::isWebService(int port, const std::string& service, const std::string& banner) {
+    if (service.find("http") != std::string::npos || banner.compare(0, 5, "HTTP/") == 0) {
+        return true;
+    }
+    return std::find(DEFAULT_WEB_PORTS.begin(), DEFAULT_WEB_PORTS.end(), port) != DEFAULT_WEB_PORTS.end() ||
+           isTlsPort(port, service);
+}
+
+bool WebEngine::isTlsPort(int port, const std::string& service) {
+    return service == "https" || port == 443 || port == 8443;
+}
+
+std::string WebEngine::extractTitle(std::string_view body) {
+    std::string lower = toLower(std::string(body.substr(0, std::min<size_t>(body.size(), 64 * 1024))));
+    size_t open = lower.find("<title");
+    if (open == std::string::npos) {
+        return "";
+    }
+    size_t start = lower.find('>', open);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = lower.find("</title", ++start);
+    if (end == std::string::npos) {
+        return "";
+    }
+
+    // 合并空白，长度上限200
+    std::string title;
+    bool space = false;
+    for (size_t i = start; i < end && title.size() < 200; ++i) {
+        unsigned char c = static_cast<unsigned char>(body[i]);
+        if (std::isspace(c)) {
+            space = !title.empty();
+            continue;
+        }
+        if (space) {
+            title += ' ';
+            space = false;
+        }
+        title += static_cast<char>(c);
+    }
+    return title;
+}
+
+std::string WebEngine::hashBody(std::string_view body) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+bool WebEngine::configureProxies(const CommandContext& context, HttpClientConfig& config, std::string& error) {
+    std::string proxyText = parameter(context, "proxy");
+    if (proxyText.empty()) {
+        return true;
+    }
+
+    std::vector<Utils::ProxyEndpoint> proxies;
+    if (!Utils::parseProxyList(proxyText, proxies, error)) {
+        return false;
+    }
+    size_t perProxy = 64;
+    std::string concurrencyText = parameter(context, "proxy-concurrency");
+    if (!concurrencyText.empty()) {
+        try {
+            perProxy = std::max<size_t>(1, std::stoul(concurrencyText));
+        } catch (const std::exception&) {
+            error = "Invalid proxy concurrency: " + concurrencyText;
+            return false;
+        }
+    }
+
+    config.proxies = std::make_shared<Utils::ProxyPool>(std::move(proxies), perProxy);
+    // 连接数上限不超过代理池能承载的隧道数，多出的连接只会在代理名额上排队
+    config.maxConnections = std::min(config.maxConnections, config.proxies->capacity());
+    notifyOutput(context, "经 " + std::to_string(config.proxies->size()) + " 个上游代理连接, 每个代理并发上限 " +
+                 std::to_string(perProxy));
+    return true;
+}
+
+void WebEngine::reportProxies(const CommandContext& context, const HttpClientConfig& config) {
+    if (!config.proxies) {
+        return;
+    }
+    for (const auto& stats : config.proxies->getStats()) {
+        notifyOutput(context, "代理 " + stats.endpoint + " [" + stats.state + "]: 隧道 " +
+                     std::to_string(stats.established) + ", 目标失败 " + std::to_string(stats.targetFailures) +
+                     ", 代理失败 " + std::to_string(stats.proxyFailures) + ", 并发峰值 " +
+                     std::to_string(stats.peakInFlight));
+    }
+}
+
+std::string WebEngine::parameter(const CommandContext& context, const std::string& key) const {
+    auto it = context.parameters.find(key);
+    if (it != context.parameters.end()) {
+        return it->second;
+    }
+    return getOption(key);
+}
+
+} // namespace MindSploit::Web
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../engine_interface.h"
+#include "http_parser.h"
+#include "tech_fingerprint.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+namespace MindSploit::Utils {
+struct IPAddress;
+class EventLoop;
+}
+
+namespace MindSploit::Web {
+
+class HttpClient;
+struct HttpClientConfig;
+
+// 一个待探测的Web端点
+struct WebEndpoint {
+    std::string ip;
+    int port = 80;
+    bool tls = false;       // HTTPS
+    std::string host;       // Host首部，为空时使用ip[:port]
+    std::string path = "/"; // URL中带有路径时覆盖 -paths
+};
+
+// 单个端点的探测结果
+struct WebProbeResult {
+    std::string ip;
+    int port = 0;
+    bool tls = false;
+    std::string path;
+    int status = 0;
+    std::string title;
+    std::string server;
+    std::string bodyHash;   // FNV-1a 64位十六进制
+    uint64_t simhash = 0;   // 归一化后的SimHash，用于近似重复判断
+    std::vector<TechMatch> technologies;
+    size_t length = 0;
+    std::chrono::milliseconds elapsed{0};
+};
+
+// Web探测引擎
+class WebEngine : public EngineInterface {
+public:
+    static constexpr const char* ENGINE_NAME = "WebEngine";
+
+    WebEngine();
+    virtual ~WebEngine();
+
+    // 基础接口实现
+    bool initialize() override;
+    bool shutdown() override;
+    ExecutionResult execute(const CommandContext& context) override;
+    void stop() override;
+
+    EngineStatus getStatus() const override;
+    std::string getName() const override { return "WebEngine"; }
+    std::string getVersion() const override { return "2.0.0"; }
+    std::string getDescription() const override;
+
+    std::vector<std::string> getSupportedCommands() const override;
+    std::map<std::string, std::string> getRequiredParameters(const std::string& command) const override;
+    std::map<std::string, std::string> getOptionalParameters(const std::string& command) const override;
+
+    bool setOption(const std::string& key, const std::string& value) override;
+    std::string getOption(const std::string& key) const override;
+    std::map<std::string, std::string> getAllOptions() const override;
+
+    bool checkDependencies() const override;
+    std::vector<std::string> getMissingDependencies() const override;
+
+    std::string getHelp() const override;
+    std::string getCommandHelp(const std::string& command) const override;
+
+    // 响应分析
+    static std::string extractTitle(std::string_view body);
+    static std::string hashBody(std::string_view body);
+
+private:
+    ExecutionResult executeHttp(const CommandContext& context);
+    ExecutionResult executeDirscan(const CommandContext& context);
+    ExecutionResult executeCrawl(const CommandContext& context);
+
+    // -tech/-rules: 关闭时fingerprinter为空，有追加规则时编译到customRules
+    bool selectFingerprinter(const CommandContext& context, TechFingerprinter& customRules,
+                             const TechFingerprinter*& fingerprinter, std::string& error) const;
+
+    // 按基础路径的响应聚类，返回每个端点所属簇的代表端点下标
+    std::vector<size_t> clusterEndpoints(const CommandContext& context, HttpClient& client,
+                                         const std::vector<WebEndpoint>& endpoints, size_t concurrency);
+
+    // dirscan -crawl: 爬取代表端点，返回 (端点下标, 起始目录) 列表
+    std::vector<std::pair<size_t, std::string>> crawlDirectories(
+        const CommandContext& context, Utils::EventLoop& loop, HttpClient& client,
+        const std::vector<WebEndpoint>& endpoints, const std::vector<size_t>& representatives, size_t depth,
+        uint64_t pages, size_t concurrency);
+
+    // 端点收集: URL、目标×端口，或 -from-scan 的开放Web端口
+    bool collectEndpoints(const CommandContext& context, std::vector<WebEndpoint>& endpoints,
+                          size_t& skippedTls, std::string& error);
+    static bool parseUrl(const std::string& url, WebEndpoint& endpoint, bool& tls, std::string& error);
+    static bool isWebService(int port, const std::string& service, const std::string& banner);
+    static bool isTlsPort(int port, const std::string& service);
+    // -proxy/-proxy-concurrency: 为客户端配置上游代理池
+    bool configureProxies(const CommandContext& context, HttpClientConfig& config, std::string& error);
+    void reportProxies(const CommandContext& context, const HttpClientConfig& config);
+    std::string parameter(const CommandContext& context, const std::string& key) const;
+
+private:
+    std::atomic<EngineStatus> m_status{EngineStatus::IDLE};
+    std::atomic<bool> m_stopRequested{false};
+    std::map<std::string, std::string> m_options;
+
+    static const std::vector<int> DEFAULT_WEB_PORTS;
+    // dirscan -crawl 每个端点追加的起始目录上限
+    static constexpr size_t MAX_CRAWLED_DIRECTORIES = 16;
+};
+
+} // namespace MindSploit::Web
@@ -0,0 +1,109 @@
+#include "bloom_filter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr size_t MAX_HASHES = 32;
+
+uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// FNV-1a后再混合一次，避免相近URL的低位相关
+void hashItem(std::string_view item, uint64_t& h1, uint64_t& h2) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : item) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    h1 = mix(hash);
+    // h2为奇数，k个位置不会重合
+    h2 = mix(hash ^ 0x2545f4914f6cdd1dULL) | 1;
+}
+
+} // namespace
+
+ScalableBloomFilter::ScalableBloomFilter(size_t initialCapacity, double errorRate, size_t maxBytes)
+    : m_initialCapacity(std::max<size_t>(64, initialCapacity)),
+      m_errorRate(std::min(0.5, std::max(1e-9, errorRate))),
+      m_maxBytes(maxBytes) {
+    addLayer();
+}
+
+bool ScalableBloomFilter::addLayer() {
+    const size_t index = m_layers.size();
+    // 容量按2倍增长，误判率按1/2收紧
+    const double capacity = static_cast<double>(m_initialCapacity) * std::pow(2.0, static_cast<double>(index));
+    const double errorRate = m_errorRate * std::pow(0.5, static_cast<double>(index + 1));
+    const double ln2 = std::log(2.0);
+
+    uint64_t bitCount = static_cast<uint64_t>(std::ceil(-capacity * std::log(errorRate) / (ln2 * ln2)));
+    bitCount = std::max<uint64_t>(64, (bitCount + 63) & ~uint64_t(63));
+    const size_t bytes = static_cast<size_t>(bitCount / 8);
+    if (m_maxBytes > 0 && !m_layers.empty() && m_bytes + bytes > m_maxBytes) {
+        m_saturated = true;
+        return false;
+    }
+
+    Layer layer;
+    layer.bits.assign(static_cast<size_t>(bitCount / 64), 0);
+    layer.bitCount = bitCount;
+    layer.hashes = std::min(MAX_HASHES, static_cast<size_t>(std::ceil(-std::log2(errorRate))));
+    layer.capacity = static_cast<size_t>(capacity);
+    m_layers.push_back(std::move(layer));
+    m_bytes += bytes;
+    return true;
+}
+
+bool ScalableBloomFilter::insert(std::string_view item) {
+    uint64_t h1, h2;
+    hashItem(item, h1, h2);
+    for (const auto& layer : m_layers) {
+        if (test(layer, h1, h2)) {
+            return false;
+        }
+    }
+
+    Layer* layer = &m_layers.back();
+    if (layer->size >= layer->capacity && !m_saturated && addLayer()) {
+        layer = &m_layers.back();
+    }
+    set(*layer, h1, h2);
+    ++layer->size;
+    ++m_size;
+    return true;
+}
+
+bool ScalableBloomFilter::contains(std::string_view item) const {
+    uint64_t h1, h2;
+    hashItem(item, h1, h2);
+    return std::any_of(m_layers.begin(), m_layers.end(),
+                       [&](const Layer& layer) { return test(layer, h1, h2); });
+}
+
+bool ScalableBloomFilter::test(const Layer& layer, uint64_t h1, uint64_t h2) {
+    uint64_t position = h1;
+    for (size_t i = 0; i < layer.hashes; ++i, position += h2) {
+        uint64_t bit = position % layer.bitCount;
+        if ((layer.bits[bit >> 6] & (uint64_t(1) << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ScalableBloomFilter::set(Layer& layer, uint64_t h1, uint64_t h2) {
+    uint64_t position = h1;
+    for (size_t i = 0; i < layer.hashes; ++i, position += h2) {
+        uint64_t bit = position % layer.bitCount;
+        layer.bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace MindSploit::Utils {
+
+// 可扩展Bloom过滤器 (Scalable Bloom Filter)
+//
+// 由若干层普通Bloom过滤器组成，当前层的元素数达到容量时追加新的一层:
+//   - 第i层容量为初始容量的2^i倍，误判率为目标值的2^-(i+1)，各层误判率之和不超过目标值
+//   - 每个元素只哈希一次得到两个64位值，k个位置用双重哈希 h1 + j*h2 生成
+//   - 查询检查所有层，插入只写最后一层
+// 设置内存上限后不再追加新层，之后的元素继续写入最后一层，误判率随之上升但内存不再增长。
+class ScalableBloomFilter {
+public:
+    explicit ScalableBloomFilter(size_t initialCapacity = 1 << 16, double errorRate = 0.001,
+                                 size_t maxBytes = 0);
+
+    // 加入元素，返回false表示元素 (可能) 已经存在
+    bool insert(std::string_view item);
+    bool contains(std::string_view item) const;
+
+    size_t size() const { return m_size; }
+    size_t layerCount() const { return m_layers.size(); }
+    size_t memoryBytes() const { return m_bytes; }
+    // 已达到内存上限，误判率不再受控
+    bool saturated() const { return m_saturated; }
+
+private:
+    struct Layer {
+        std::vector<uint64_t> bits;
+        uint64_t bitCount = 0;
+        size_t hashes = 0;
+        size_t capacity = 0;
+        size_t size = 0;
+    };
+
+    bool addLayer();
+    static bool test(const Layer& layer, uint64_t h1, uint64_t h2);
+    static void set(Layer& layer, uint64_t h1, uint64_t h2);
+
+private:
+    size_t m_initialCapacity;
+    double m_errorRate;
+    size_t m_maxBytes;
+    std::vector<Layer> m_layers;
+    size_t m_size = 0;
+    size_t m_bytes = 0;
+    bool m_saturated = false;
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,48 @@
+#include "buffer_arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+// 块按缓存行对齐，相邻连接的缓冲区不共享缓存行
+constexpr size_t BLOCK_ALIGNMENT = 64;
+
+} // namespace
+
+BufferArena::BufferArena(size_t blockSize, size_t blocksPerChunk)
+    : m_blockSize((std::max<size_t>(1, blockSize) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1)),
+      m_blocksPerChunk(std::max<size_t>(1, blocksPerChunk)) {
+}
+
+char* BufferArena::acquire() {
+    if (m_free.empty()) {
+        std::unique_ptr<char[]> chunk(new char[m_blockSize * m_blocksPerChunk + BLOCK_ALIGNMENT]);
+        char* base = chunk.get();
+        size_t misalignment = reinterpret_cast<uintptr_t>(base) % BLOCK_ALIGNMENT;
+        if (misalignment != 0) {
+            base += BLOCK_ALIGNMENT - misalignment;
+        }
+        m_chunks.push_back(std::move(chunk));
+
+        // 逆序放入，先分配低地址的块
+        m_free.reserve(m_free.size() + m_blocksPerChunk);
+        for (size_t i = m_blocksPerChunk; i > 0; --i) {
+            m_free.push_back(base + (i - 1) * m_blockSize);
+        }
+        m_capacity += m_blocksPerChunk;
+    }
+
+    char* block = m_free.back();
+    m_free.pop_back();
+    return block;
+}
+
+void BufferArena::release(char* block) {
+    if (block != nullptr) {
+        m_free.push_back(block);
+    }
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace MindSploit::Utils {
+
+// 固定大小缓冲区池
+//
+// 以块为单位从整块内存中切分，释放的块进入空闲链表供下次复用:
+//   - 每次向系统申请blocksPerChunk个块，之后的分配和释放只是链表操作
+//   - 块在池销毁前不归还系统，峰值之后的分配不再触发堆分配
+// 适合每个连接一个接收缓冲区这类生命周期短、大小固定、数量随并发变化的场景。
+// 非线程安全，应在事件循环线程中使用。
+class BufferArena {
+public:
+    explicit BufferArena(size_t blockSize, size_t blocksPerChunk = 64);
+
+    BufferArena(const BufferArena&) = delete;
+    BufferArena& operator=(const BufferArena&) = delete;
+
+    char* acquire();
+    void release(char* block);
+
+    size_t blockSize() const { return m_blockSize; }
+    // 已从系统申请的块数
+    size_t capacity() const { return m_capacity; }
+    size_t inUse() const { return m_capacity - m_free.size(); }
+
+private:
+    size_t m_blockSize;
+    size_t m_blocksPerChunk;
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    std::vector<char*> m_free;
+    size_t m_capacity = 0;
+};
+
+} // namespace MindSploit::Utils
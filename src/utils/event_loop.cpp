@@ -0,0 +1,251 @@
+#include "event_loop.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr int MAX_EVENTS_PER_WAIT = 256;
+
+#ifdef __linux__
+uint32_t toEpollEvents(uint32_t events) {
+    uint32_t result = 0;
+    if (events & EventLoop::EVENT_READ) result |= EPOLLIN;
+    if (events & EventLoop::EVENT_WRITE) result |= EPOLLOUT;
+    return result;
+}
+
+uint32_t fromEpollEvents(uint32_t events) {
+    uint32_t result = 0;
+    if (events & (EPOLLIN | EPOLLPRI)) result |= EventLoop::EVENT_READ;
+    if (events & EPOLLOUT) result |= EventLoop::EVENT_WRITE;
+    if (events & (EPOLLERR | EPOLLHUP)) result |= EventLoop::EVENT_ERROR;
+    return result;
+}
+#else
+#ifdef _WIN32
+using PollFd = WSAPOLLFD;
+int pollFds(PollFd* fds, size_t count, int timeoutMs) {
+    return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+}
+#else
+using PollFd = struct pollfd;
+int pollFds(PollFd* fds, size_t count, int timeoutMs) {
+    return poll(fds, static_cast<nfds_t>(count), timeoutMs);
+}
+#endif
+#endif
+
+} // namespace
+
+EventLoop::EventLoop() {
+#ifdef __linux__
+    m_pollFd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+}
+
+EventLoop::~EventLoop() {
+#ifdef __linux__
+    if (m_pollFd >= 0) {
+        close(m_pollFd);
+    }
+#endif
+}
+
+bool EventLoop::isValid() const {
+#ifdef __linux__
+    return m_pollFd >= 0;
+#else
+    return true;
+#endif
+}
+
+bool EventLoop::watch(int fd, uint32_t events, IoHandler handler) {
+    if (fd < 0 || m_watches.count(fd)) {
+        return false;
+    }
+
+    auto entry = std::make_unique<Watch>();
+    entry->events = events;
+    entry->generation = m_nextGeneration++;
+    entry->handler = std::move(handler);
+
+#ifdef __linux__
+    struct epoll_event ev {};
+    ev.events = toEpollEvents(events);
+    ev.data.u64 = (static_cast<uint64_t>(entry->generation) << 32) | static_cast<uint32_t>(fd);
+    if (epoll_ctl(m_pollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        return false;
+    }
+#endif
+
+    m_watches[fd] = std::move(entry);
+    return true;
+}
+
+bool EventLoop::update(int fd, uint32_t events) {
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end()) {
+        return false;
+    }
+    if (it->second->events == events) {
+        return true;
+    }
+    it->second->events = events;
+
+#ifdef __linux__
+    struct epoll_event ev {};
+    ev.events = toEpollEvents(events);
+    ev.data.u64 = (static_cast<uint64_t>(it->second->generation) << 32) | static_cast<uint32_t>(fd);
+    return epoll_ctl(m_pollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+#else
+    return true;
+#endif
+}
+
+void EventLoop::unwatch(int fd) {
+    auto it = m_watches.find(fd);
+    if (it == m_watches.end()) {
+        return;
+    }
+
+#ifdef __linux__
+    epoll_ctl(m_pollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+
+    m_retired.push_back(std::move(it->second));
+    m_watches.erase(it);
+}
+
+EventLoop::TimerId EventLoop::addTimer(std::chrono::milliseconds delay, TimerHandler handler) {
+    TimerId id = m_nextTimerId++;
+    m_timers[id] = std::move(handler);
+    m_timerQueue.push({Clock::now() + delay, id});
+    return id;
+}
+
+void EventLoop::cancelTimer(TimerId id) {
+    // 队列中的条目在到期时发现已取消再丢弃
+    m_timers.erase(id);
+}
+
+std::chrono::milliseconds EventLoop::nextTimerDelay(std::chrono::milliseconds maxWait) const {
+    if (m_timerQueue.empty()) {
+        return maxWait;
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(m_timerQueue.top().deadline - Clock::now());
+    if (delay.count() < 0) {
+        return std::chrono::milliseconds(0);
+    }
+    return std::min(delay, maxWait);
+}
+
+size_t EventLoop::dispatchTimers() {
+    size_t fired = 0;
+    auto now = Clock::now();
+
+    while (!m_timerQueue.empty() && m_timerQueue.top().deadline <= now) {
+        TimerId id = m_timerQueue.top().id;
+        m_timerQueue.pop();
+
+        auto it = m_timers.find(id);
+        if (it == m_timers.end()) {
+            continue;
+        }
+        TimerHandler handler = std::move(it->second);
+        m_timers.erase(it);
+        handler();
+        ++fired;
+    }
+
+    return fired;
+}
+
+void EventLoop::dispatchIo(int fd, uint32_t generation, uint32_t events) {
+    auto it = m_watches.find(fd);
+    // fd在本轮中已被注销或被复用时丢弃过期事件
+    if (it == m_watches.end() || it->second->generation != generation) {
+        return;
+    }
+
+    Watch* entry = it->second.get();
+    uint32_t interested = (entry->events & (EVENT_READ | EVENT_WRITE)) | EVENT_ERROR;
+    if (events & interested) {
+        entry->handler(events & interested);
+    }
+}
+
+size_t EventLoop::runOnce(std::chrono::milliseconds maxWait) {
+    size_t dispatched = dispatchTimers();
+    int timeoutMs = static_cast<int>(nextTimerDelay(maxWait).count());
+    if (dispatched > 0) {
+        timeoutMs = 0;
+    }
+
+#ifdef __linux__
+    struct epoll_event events[MAX_EVENTS_PER_WAIT];
+    int count = epoll_wait(m_pollFd, events, MAX_EVENTS_PER_WAIT, timeoutMs);
+    for (int i = 0; i < count; ++i) {
+        int fd = static_cast<int>(events[i].data.u64 & 0xFFFFFFFFu);
+        uint32_t generation = static_cast<uint32_t>(events[i].data.u64 >> 32);
+        dispatchIo(fd, generation, fromEpollEvents(events[i].events));
+        ++dispatched;
+    }
+#else
+    std::vector<PollFd> fds;
+    std::vector<uint32_t> generations;
+    fds.reserve(m_watches.size());
+    generations.reserve(m_watches.size());
+    for (const auto& [fd, entry] : m_watches) {
+        PollFd pfd {};
+        pfd.fd = fd;
+        if (entry->events & EVENT_READ) pfd.events |= POLLIN;
+        if (entry->events & EVENT_WRITE) pfd.events |= POLLOUT;
+        fds.push_back(pfd);
+        generations.push_back(entry->generation);
+    }
+
+    int count = fds.empty() ? 0 : pollFds(fds.data(), fds.size(), timeoutMs);
+    if (fds.empty() && timeoutMs > 0) {
+#ifdef _WIN32
+        Sleep(static_cast<DWORD>(timeoutMs));
+#else
+        poll(nullptr, 0, timeoutMs);
+#endif
+    }
+    for (size_t i = 0; count > 0 && i < fds.size(); ++i) {
+        if (!fds[i].revents) continue;
+        uint32_t events = 0;
+        if (fds[i].revents & POLLIN) events |= EVENT_READ;
+        if (fds[i].revents & POLLOUT) events |= EVENT_WRITE;
+        if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) events |= EVENT_ERROR;
+        dispatchIo(static_cast<int>(fds[i].fd), generations[i], events);
+        ++dispatched;
+    }
+#endif
+
+    dispatched += dispatchTimers();
+    m_retired.clear();
+    return dispatched;
+}
+
+void EventLoop::run() {
+    m_stopRequested = false;
+    while (!m_stopRequested && (!m_watches.empty() || !m_timers.empty())) {
+        runOnce(std::chrono::milliseconds(1000));
+    }
+}
+
+} // namespace MindSploit::Utils
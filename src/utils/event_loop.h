@@ -0,0 +1,88 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+namespace MindSploit::Utils {
+
+// 单线程事件循环 (Linux使用epoll，其它平台使用poll)
+//
+// 处理函数可以在回调中注册/注销任意fd或定时器，包括自身；
+// 被注销的处理函数延迟到本轮分发结束后再释放。
+class EventLoop {
+public:
+    // 事件标志 (避免与Windows的ERROR宏冲突)
+    enum Event : uint32_t {
+        EVENT_READ  = 0x1,
+        EVENT_WRITE = 0x2,
+        EVENT_ERROR = 0x4     // 错误或对端挂断，总是上报
+    };
+
+    using IoHandler = std::function<void(uint32_t events)>;
+    using TimerHandler = std::function<void()>;
+    using TimerId = uint64_t;
+    using Clock = std::chrono::steady_clock;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool isValid() const;
+
+    // fd管理
+    bool watch(int fd, uint32_t events, IoHandler handler);
+    bool update(int fd, uint32_t events);
+    void unwatch(int fd);
+    bool isWatched(int fd) const { return m_watches.count(fd) != 0; }
+    size_t watchedCount() const { return m_watches.size(); }
+
+    // 定时器 (一次性)
+    TimerId addTimer(std::chrono::milliseconds delay, TimerHandler handler);
+    void cancelTimer(TimerId id);
+    size_t timerCount() const { return m_timers.size(); }
+
+    // 运行: runOnce最多等待maxWait，返回分发的事件数
+    size_t runOnce(std::chrono::milliseconds maxWait);
+    // 运行直到stop()或没有任何fd和定时器
+    void run();
+    void stop() { m_stopRequested = true; }
+    bool stopRequested() const { return m_stopRequested; }
+
+private:
+    struct Watch {
+        uint32_t events = 0;
+        uint32_t generation = 0;
+        IoHandler handler;
+    };
+
+    struct TimerEntry {
+        Clock::time_point deadline;
+        TimerId id;
+        bool operator>(const TimerEntry& other) const { return deadline > other.deadline; }
+    };
+
+    size_t dispatchTimers();
+    std::chrono::milliseconds nextTimerDelay(std::chrono::milliseconds maxWait) const;
+    void dispatchIo(int fd, uint32_t generation, uint32_t events);
+
+private:
+    int m_pollFd = -1;                                  // epoll实例 (仅Linux)
+    std::unordered_map<int, std::unique_ptr<Watch>> m_watches;
+    std::vector<std::unique_ptr<Watch>> m_retired;      // 分发期间注销的处理函数
+    uint32_t m_nextGeneration = 1;
+
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry>> m_timerQueue;
+    std::unordered_map<TimerId, TimerHandler> m_timers;
+    TimerId m_nextTimerId = 1;
+
+    bool m_stopRequested = false;
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,116 @@
+#include "host_cluster.h"
+#include <algorithm>
+#include <limits>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// splitmix64终结函数，用不同种子模拟独立的哈希排列
+uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+} // namespace
+
+size_t HostClusterIndex::add(const std::vector<std::string>& features, bool& created) {
+    ++m_hosts;
+    created = false;
+
+    if (features.empty()) {
+        Cluster cluster;
+        cluster.signature.fill(0);
+        cluster.members = 1;
+        m_clusters.push_back(cluster);
+        created = true;
+        return m_clusters.size() - 1;
+    }
+
+    Signature signature = signatureOf(features);
+
+    // 同桶的候选簇中取相似度最高的
+    size_t best = m_clusters.size();
+    double bestSimilarity = 0;
+    std::array<uint64_t, BANDS> keys;
+    for (size_t band = 0; band < BANDS; ++band) {
+        keys[band] = bandKey(signature, band);
+        auto it = m_buckets.find(keys[band]);
+        if (it == m_buckets.end()) {
+            continue;
+        }
+        for (size_t candidate : it->second) {
+            double value = similarity(signature, m_clusters[candidate].signature);
+            if (value > bestSimilarity) {
+                bestSimilarity = value;
+                best = candidate;
+            }
+        }
+    }
+    if (best < m_clusters.size() && bestSimilarity >= m_threshold) {
+        ++m_clusters[best].members;
+        return best;
+    }
+
+    Cluster cluster;
+    cluster.signature = signature;
+    cluster.members = 1;
+    m_clusters.push_back(cluster);
+    size_t id = m_clusters.size() - 1;
+    for (uint64_t key : keys) {
+        auto& bucket = m_buckets[key];
+        if (std::find(bucket.begin(), bucket.end(), id) == bucket.end()) {
+            bucket.push_back(id);
+        }
+    }
+    created = true;
+    return id;
+}
+
+double HostClusterIndex::estimateSimilarity(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+    if (a.empty() || b.empty()) {
+        return 0;
+    }
+    return similarity(signatureOf(a), signatureOf(b));
+}
+
+HostClusterIndex::Signature HostClusterIndex::signatureOf(const std::vector<std::string>& features) {
+    Signature signature;
+    signature.fill(std::numeric_limits<uint64_t>::max());
+    for (const auto& feature : features) {
+        uint64_t base = fnv1a(feature);
+        for (size_t i = 0; i < SIGNATURE_SIZE; ++i) {
+            signature[i] = std::min(signature[i], mix(base ^ (0x2545f4914f6cdd1dULL * (i + 1))));
+        }
+    }
+    return signature;
+}
+
+double HostClusterIndex::similarity(const Signature& a, const Signature& b) {
+    size_t equal = 0;
+    for (size_t i = 0; i < SIGNATURE_SIZE; ++i) {
+        equal += a[i] == b[i] ? 1 : 0;
+    }
+    return static_cast<double>(equal) / SIGNATURE_SIZE;
+}
+
+uint64_t HostClusterIndex::bandKey(const Signature& signature, size_t band) {
+    uint64_t key = mix(band + 1);
+    for (size_t row = 0; row < ROWS; ++row) {
+        key = mix(key ^ signature[band * ROWS + row]);
+    }
+    return key;
+}
+
+} // namespace MindSploit::Utils
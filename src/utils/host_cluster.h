@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace MindSploit::Utils {
+
+// 基于MinHash/LSH的增量主机聚类
+//
+// 每个主机用一组特征串描述 (HTTP状态码、Server首部、标题、首部名、响应体SimHash分段、
+// TLS指纹、证书签发者、服务banner等)，按特征集合的Jaccard相似度聚类:
+//   - 特征集合压缩为64个最小哈希值的签名，两个签名相同位置相等的比例即Jaccard估计值
+//   - 签名分成16段，每段4个值哈希成桶键; 相似的主机至少有一段落入同一个桶
+//   - 新主机只与同桶的簇代表比较，估计相似度达到阈值即加入该簇，否则成为新簇的代表
+// 只保存簇代表的签名和桶，内存随簇数而不是主机数增长; 每次加入的开销与已有主机数无关。
+// 后续的深度扫描只对每个簇的代表执行，结果再传播给同簇的其它主机。
+class HostClusterIndex {
+public:
+    static constexpr size_t SIGNATURE_SIZE = 64;
+    static constexpr size_t BANDS = 16;
+    static constexpr size_t ROWS = SIGNATURE_SIZE / BANDS;
+
+    explicit HostClusterIndex(double threshold = 0.8) : m_threshold(threshold) {}
+
+    // 加入一个主机，返回所属簇的编号; created表示该主机成为新簇的代表
+    // 没有特征的主机无法比较，总是单独成簇
+    size_t add(const std::vector<std::string>& features, bool& created);
+
+    size_t clusterCount() const { return m_clusters.size(); }
+    size_t memberCount(size_t cluster) const { return m_clusters[cluster].members; }
+    size_t hostCount() const { return m_hosts; }
+
+    // 两组特征的Jaccard相似度估计值
+    static double estimateSimilarity(const std::vector<std::string>& a, const std::vector<std::string>& b);
+
+private:
+    using Signature = std::array<uint64_t, SIGNATURE_SIZE>;
+
+    struct Cluster {
+        Signature signature;
+        size_t members = 0;
+    };
+
+    static Signature signatureOf(const std::vector<std::string>& features);
+    static double similarity(const Signature& a, const Signature& b);
+    static uint64_t bandKey(const Signature& signature, size_t band);
+
+private:
+    double m_threshold;
+    std::vector<Cluster> m_clusters;
+    std::unordered_map<uint64_t, std::vector<size_t>> m_buckets;
+    size_t m_hosts = 0;
+};
+
+} // namespace MindSploit::Utils
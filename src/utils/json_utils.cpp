@@ -0,0 +1,40 @@
+#include "json_utils.h"
+#include <cstdio>
+
+namespace MindSploit::Utils {
+
+std::string jsonEscape(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += static_cast<char>(c);
+                }
+        }
+    }
+    return escaped;
+}
+
+std::string jsonArray(const std::vector<std::string>& values) {
+    std::string text = "[";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            text += ",";
+        }
+        text += "\"" + jsonEscape(values[i]) + "\"";
+    }
+    return text + "]";
+}
+
+} // namespace MindSploit::Utils
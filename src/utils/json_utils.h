@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace MindSploit::Utils {
+
+// JSON字符串转义 (引号、反斜杠和控制字符)，用于各引擎逐行写出的结果记录
+std::string jsonEscape(const std::string& value);
+// 字符串数组，如 ["a","b"]
+std::string jsonArray(const std::vector<std::string>& values);
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,98 @@
+#include "multi_pattern.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr uint32_t NO_STATE = std::numeric_limits<uint32_t>::max();
+
+} // namespace
+
+size_t MultiPatternMatcher::add(std::string_view pattern) {
+    std::string lower(pattern);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    m_patterns.push_back(std::move(lower));
+    m_transitions.clear();
+    return m_patterns.size() - 1;
+}
+
+void MultiPatternMatcher::compile() {
+    // 字符类: 模式中出现的每个字节一个类，大写字母与小写共用
+    m_classes.fill(0);
+    m_classCount = 1;
+    for (const auto& pattern : m_patterns) {
+        for (unsigned char c : pattern) {
+            if (m_classes[c] == 0) {
+                m_classes[c] = static_cast<uint16_t>(m_classCount++);
+            }
+        }
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        m_classes[std::toupper(c)] = m_classes[c];
+    }
+
+    // 字典树
+    std::vector<uint32_t> transitions(m_classCount, NO_STATE);
+    std::vector<std::vector<uint32_t>> outputs(1);
+    for (size_t id = 0; id < m_patterns.size(); ++id) {
+        const std::string& pattern = m_patterns[id];
+        if (pattern.empty()) {
+            continue;
+        }
+        uint32_t state = 0;
+        for (unsigned char c : pattern) {
+            uint32_t& next = transitions[state * m_classCount + m_classes[c]];
+            if (next == NO_STATE) {
+                next = static_cast<uint32_t>(outputs.size());
+                outputs.emplace_back();
+                transitions.resize(transitions.size() + m_classCount, NO_STATE);
+            }
+            // resize之后引用可能失效，重新取下标
+            state = transitions[state * m_classCount + m_classes[c]];
+        }
+        outputs[state].push_back(static_cast<uint32_t>(id));
+    }
+
+    // 按层次计算失败转移并展开进转移表，输出合并失败状态的输出
+    const size_t states = outputs.size();
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(states);
+    for (size_t c = 0; c < m_classCount; ++c) {
+        uint32_t& next = transitions[c];
+        if (next == NO_STATE) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t state = queue[head];
+        const auto& inherited = outputs[fail[state]];
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+        for (size_t c = 0; c < m_classCount; ++c) {
+            uint32_t& next = transitions[state * m_classCount + c];
+            uint32_t fallback = transitions[fail[state] * m_classCount + c];
+            if (next == NO_STATE) {
+                next = fallback;
+            } else {
+                fail[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    m_outputStart.assign(1, 0);
+    m_outputs.clear();
+    for (const auto& list : outputs) {
+        m_outputs.insert(m_outputs.end(), list.begin(), list.end());
+        m_outputStart.push_back(static_cast<uint32_t>(m_outputs.size()));
+    }
+    m_transitions = std::move(transitions);
+}
+
+} // namespace MindSploit::Utils
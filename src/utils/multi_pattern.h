@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace MindSploit::Utils {
+
+// Aho-Corasick多模式匹配器，ASCII大小写不敏感
+//
+// 所有模式编译为一个确定自动机，文本只扫描一遍，每字节一次查表，开销与模式数量无关:
+//   - 模式中出现的字节 (大小写合并) 各占一个字符类，其余字节共用类0，转移表按 状态×字符类 稠密存放
+//   - 失败转移在编译时展开进转移表，扫描时没有回退
+//   - 每个状态的输出 (以该状态结尾的全部模式) 连续存放
+// 先add全部模式再compile，编译后只读，可在多线程间共享。
+class MultiPatternMatcher {
+public:
+    // 加入模式，返回模式编号; 空模式永远不匹配
+    size_t add(std::string_view pattern);
+    void compile();
+
+    bool compiled() const { return !m_transitions.empty(); }
+    size_t patternCount() const { return m_patterns.size(); }
+    size_t stateCount() const { return m_outputStart.empty() ? 0 : m_outputStart.size() - 1; }
+
+    // 对每个出现调用handler(模式编号, 结束偏移)，同一位置结束的模式按长度从长到短
+    template <typename Handler>
+    void scan(std::string_view text, Handler&& handler) const {
+        if (m_transitions.empty()) {
+            return;
+        }
+        uint32_t state = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            state = m_transitions[state * m_classCount + m_classes[static_cast<unsigned char>(text[i])]];
+            for (uint32_t k = m_outputStart[state]; k < m_outputStart[state + 1]; ++k) {
+                handler(static_cast<size_t>(m_outputs[k]), i + 1);
+            }
+        }
+    }
+
+private:
+    std::vector<std::string> m_patterns;
+    std::array<uint16_t, 256> m_classes{};
+    size_t m_classCount = 1;
+    std::vector<uint32_t> m_transitions;
+    std::vector<uint32_t> m_outputStart;
+    std::vector<uint32_t> m_outputs;
+};
+
+} // namespace MindSploit::Utils
@@ -1,4 +1,6 @@
 #include "network_utils.h"
+#include "packet_template.h"
+#include "socket_budget.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -62,6 +64,33 @@ bool IPAddress::isLoopback() const {
     }
 }
 
+namespace {
+
+// 解析套接字地址
+IPAddress parseSockaddr(const struct sockaddr_storage& addr, uint16_t& port) {
+    char buffer[INET6_ADDRSTRLEN] = {0};
+    if (addr.ss_family == AF_INET6) {
+        const struct sockaddr_in6* addr6 = (const struct sockaddr_in6*)&addr;
+        inet_ntop(AF_INET6, &addr6->sin6_addr, buffer, sizeof(buffer));
+        port = ntohs(addr6->sin6_port);
+    } else {
+        const struct sockaddr_in* addr4 = (const struct sockaddr_in*)&addr;
+        inet_ntop(AF_INET, &addr4->sin_addr, buffer, sizeof(buffer));
+        port = ntohs(addr4->sin_port);
+    }
+    return IPAddress(buffer);
+}
+
+void closeHandle(int handle) {
+#ifdef _WIN32
+    closesocket(handle);
+#else
+    ::close(handle);
+#endif
+}
+
+} // namespace
+
 // PortRange 方法实现
 std::vector<uint16_t> PortRange::toVector() const {
     std::vector<uint16_t> result;
@@ -236,6 +265,23 @@ std::vector<IPAddress> NetworkUtils::parseCIDR(const std::string& cidr) {
     return result;
 }
 
+std::vector<IPAddress> NetworkUtils::parseIPList(const std::string& list) {
+    std::vector<IPAddress> result;
+    std::stringstream ss(list);
+    std::string item;
+
+    while (std::getline(ss, item, ',')) {
+        // 去除空格
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+
+        if (!item.empty() && isValidIP(item)) {
+            result.push_back(IPAddress(item));
+        }
+    }
+
+    return result;
+}
+
 bool NetworkUtils::isValidPort(int port) {
     return port >= 1 && port <= 65535;
 }
@@ -327,25 +373,24 @@ ConnectionResult NetworkUtils::testTCPConnection(const IPAddress& target, uint16
         return result;
     }
 
+    // 占用一个在途连接名额，超出fd/端口预算时在此等待
+    auto& budget = SocketBudget::instance();
+    SocketBudget::Slot slot(timeout);
+    if (!slot.acquired()) {
+        result.errorMessage = "Connection budget exhausted";
+        return result;
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
 
-    // 创建套接字
-    int sock = socket(target.isIPv6 ? AF_INET6 : AF_INET, SOCK_STREAM, 0);
+    // 创建非阻塞探测套接字 (RST关闭、轮转源地址)
+    int sock = budget.openProbeSocket(target);
     if (sock < 0) {
         result.errorMessage = "Failed to create socket";
         result.errorCode = errno;
         return result;
     }
 
-    // 设置非阻塞模式
-    #ifdef _WIN32
-    u_long mode = 1;
-    ioctlsocket(sock, FIONBIO, &mode);
-    #else
-    int flags = fcntl(sock, F_GETFL, 0);
-    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
-    #endif
-
     // 准备地址结构
     struct sockaddr_storage addr;
     socklen_t addr_len;
@@ -378,18 +423,8 @@ ConnectionResult NetworkUtils::testTCPConnection(const IPAddress& target, uint16
         #else
         if (errno == EINPROGRESS) {
         #endif
-            // 连接正在进行中，使用select等待
-            fd_set write_fds;
-            FD_ZERO(&write_fds);
-            FD_SET(sock, &write_fds);
-
-            struct timeval tv;
-            tv.tv_sec = timeout.count() / 1000;
-            tv.tv_usec = (timeout.count() % 1000) * 1000;
-
-            int select_result = select(sock + 1, nullptr, &write_fds, nullptr, &tv);
-
-            if (select_result > 0 && FD_ISSET(sock, &write_fds)) {
+            // 连接正在进行中，等待可写 (fd可能超过FD_SETSIZE，不能用select)
+            if (waitSocket(sock, POLLOUT, timeout)) {
                 // 检查连接是否成功
                 int error = 0;
                 socklen_t len = sizeof(error);
@@ -413,11 +448,13 @@ ConnectionResult NetworkUtils::testTCPConnection(const IPAddress& target, uint16
     auto end = std::chrono::high_resolution_clock::now();
     result.responseTime = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    #ifdef _WIN32
-    closesocket(sock);
-    #else
-    close(sock);
-    #endif
+    // 反馈给预算管理器: 端口/fd耗尽时收缩窗口，否则逐步放开
+    if (result.errorCode != 0) {
+        budget.reportError(result.errorCode);
+    } else {
+        budget.reportSuccess();
+    }
+    budget.closeProbeSocket(sock);
 
     return result;
 }
@@ -543,6 +580,254 @@ ConnectionResult NetworkUtils::pingHost(const IPAddress& target, std::chrono::mi
     return result;
 }
 
+int NetworkUtils::pollSockets(struct pollfd* fds, size_t count, std::chrono::milliseconds timeout) {
+    int timeoutMs = static_cast<int>(std::max<int64_t>(0, timeout.count()));
+#ifdef _WIN32
+    return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs);
+#else
+    int ready;
+    do {
+        ready = poll(fds, static_cast<nfds_t>(count), timeoutMs);
+    } while (ready < 0 && errno == EINTR);
+    return ready;
+#endif
+}
+
+bool NetworkUtils::waitSocket(int socket, short events, std::chrono::milliseconds timeout) {
+    struct pollfd pfd;
+    pfd.fd = socket;
+    pfd.events = events;
+    pfd.revents = 0;
+    // 错误和挂断也算就绪，由调用方通过SO_ERROR或recv区分
+    return pollSockets(&pfd, 1, timeout) > 0 && pfd.revents != 0;
+}
+
+socklen_t NetworkUtils::toSockaddr(const IPAddress& address, uint16_t port, struct sockaddr_storage& addr) {
+    memset(&addr, 0, sizeof(addr));
+    if (address.isIPv6) {
+        struct sockaddr_in6* addr6 = (struct sockaddr_in6*)&addr;
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = htons(port);
+        inet_pton(AF_INET6, address.address.c_str(), &addr6->sin6_addr);
+        return sizeof(*addr6);
+    }
+    struct sockaddr_in* addr4 = (struct sockaddr_in*)&addr;
+    addr4->sin_family = AF_INET;
+    addr4->sin_port = htons(port);
+    if (!address.address.empty()) {
+        inet_pton(AF_INET, address.address.c_str(), &addr4->sin_addr);
+    }
+    return sizeof(*addr4);
+}
+
+std::string NetworkUtils::grabBanner(const IPAddress& target, uint16_t port, std::chrono::milliseconds timeout) {
+    // 与testTCPConnection相同: 占用名额，套接字RST关闭并绑定轮转源地址
+    auto& budget = SocketBudget::instance();
+    SocketBudget::Slot slot(timeout);
+    if (!slot.acquired()) {
+        return "";
+    }
+
+    Socket sock = Socket::adopt(budget.openProbeSocket(target));
+    if (!sock.isValid()) {
+        return "";
+    }
+    errno = 0;
+    if (!sock.connect(target, port, timeout)) {
+        budget.reportError(errno);
+        return "";
+    }
+    budget.reportSuccess();
+    return readBanner(sock, timeout);
+}
+
+std::string NetworkUtils::readBanner(Socket& sock, std::chrono::milliseconds timeout, const std::string& received) {
+    if (!received.empty()) {
+        return bannerLine(received.data(), received.size());
+    }
+    // 先短暂等待服务端主动发送的横幅
+    sock.setReceiveTimeout(std::min(timeout, std::chrono::milliseconds(1000)));
+
+    char buffer[1024];
+    auto length = sock.receive(buffer, sizeof(buffer));
+    if (length <= 0) {
+        // 服务端不主动发送横幅时，按HTTP请求一次响应头
+        static const char probe[] = "HEAD / HTTP/1.0\r\n\r\n";
+        sock.setReceiveTimeout(timeout);
+        if (sock.send(probe, sizeof(probe) - 1) <= 0) {
+            return "";
+        }
+        length = sock.receive(buffer, sizeof(buffer));
+        if (length <= 0) {
+            return "";
+        }
+    }
+    return bannerLine(buffer, static_cast<size_t>(length));
+}
+
+std::string NetworkUtils::bannerLine(const char* data, size_t length) {
+    // 只保留首行，去掉控制字符
+    std::string banner;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c == '\r' || c == '\n') {
+            if (!banner.empty()) break;
+            continue;
+        }
+        banner += (c >= 0x20 && c < 0x7F) ? static_cast<char>(c) : '.';
+    }
+    return banner;
+}
+
+std::string NetworkUtils::detectService(uint16_t port, const std::string& banner) {
+    static const std::vector<std::pair<std::string, std::string>> bannerPrefixes = {
+        {"SSH-", "ssh"}, {"HTTP/", "http"}, {"+OK", "pop3"}, {"* OK", "imap"},
+        {"RFB ", "vnc"}, {"-ERR", "redis"}, {"AMQP", "amqp"}
+    };
+    for (const auto& [prefix, service] : bannerPrefixes) {
+        if (banner.compare(0, prefix.size(), prefix) == 0) {
+            return service;
+        }
+    }
+    if (banner.compare(0, 4, "220 ") == 0 || banner.compare(0, 4, "220-") == 0) {
+        return banner.find("FTP") != std::string::npos || port == 21 ? "ftp" : "smtp";
+    }
+
+    switch (port) {
+        case 21: return "ftp";
+        case 22: return "ssh";
+        case 23: return "telnet";
+        case 25: return "smtp";
+        case 53: return "dns";
+        case 80: return "http";
+        case 110: return "pop3";
+        case 143: return "imap";
+        case 443: return "https";
+        case 3306: return "mysql";
+        case 3389: return "rdp";
+        case 5432: return "postgresql";
+        case 6379: return "redis";
+        case 8080: return "http-proxy";
+        default: return "unknown";
+    }
+}
+
+int NetworkUtils::createRawSocket(int protocol, bool ipv6) {
+    if (!isInitialized()) {
+        setLastError(0, "NetworkUtils not initialized");
+        return -1;
+    }
+
+    int sock = static_cast<int>(socket(ipv6 ? AF_INET6 : AF_INET, SOCK_RAW, protocol));
+    if (sock < 0) {
+        // 原始套接字需要root权限或CAP_NET_RAW
+        setLastError(errno, "Failed to create raw socket");
+        return -1;
+    }
+
+    // IPv4下由调用方构造IP首部 (IPv6的IPPROTO_RAW套接字隐含此行为)
+    if (protocol == IPPROTO_RAW && !ipv6) {
+        int on = 1;
+        if (setsockopt(sock, IPPROTO_IP, IP_HDRINCL, (const char*)&on, sizeof(on)) < 0) {
+            setLastError(errno, "Failed to set IP_HDRINCL");
+            closeRawSocket(sock);
+            return -1;
+        }
+    }
+
+    return sock;
+}
+
+void NetworkUtils::closeRawSocket(int socket) {
+    if (socket < 0) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+bool NetworkUtils::sendRawPacket(int socket, const void* data, size_t length, const IPAddress& target) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    memset(&addr, 0, sizeof(addr));
+
+    if (target.isIPv6) {
+        struct sockaddr_in6* addr6 = (struct sockaddr_in6*)&addr;
+        addr6->sin6_family = AF_INET6;
+        inet_pton(AF_INET6, target.address.c_str(), &addr6->sin6_addr);
+        addr_len = sizeof(*addr6);
+    } else {
+        struct sockaddr_in* addr4 = (struct sockaddr_in*)&addr;
+        addr4->sin_family = AF_INET;
+        inet_pton(AF_INET, target.address.c_str(), &addr4->sin_addr);
+        addr_len = sizeof(*addr4);
+    }
+
+    auto sent = sendto(socket, (const char*)data, static_cast<int>(length), 0,
+                       (struct sockaddr*)&addr, addr_len);
+    if (sent < 0) {
+        setLastError(errno, "Failed to send raw packet");
+        return false;
+    }
+    return static_cast<size_t>(sent) == length;
+}
+
+size_t NetworkUtils::sendRawBatch(int socket, PacketBatch& batch, size_t* failed) {
+    size_t sent = 0;
+    size_t errors = 0;
+
+#ifdef __linux__
+    // sendmmsg一次系统调用提交整批，被信号或缓冲区满打断时从断点继续
+    // 单个报文出错 (广播地址EACCES、ENETUNREACH、netfilter的EPERM) 时跳过该报文，其余照常发送
+    size_t position = 0;
+    while (position < batch.size()) {
+        int result = sendmmsg(socket, batch.messages() + position,
+                              static_cast<unsigned int>(batch.size() - position), 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            setLastError(errno, "sendmmsg failed");
+            ++position;
+            ++errors;
+            continue;
+        }
+        position += static_cast<size_t>(result);
+        sent += static_cast<size_t>(result);
+    }
+#else
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto result = sendto(socket, (const char*)batch.packet(i), static_cast<int>(batch.packetSize()), 0,
+                             (const struct sockaddr*)&batch.destination(i), batch.destinationLength());
+        if (result < 0) {
+            setLastError(errno, "Failed to send raw packet");
+            ++errors;
+            continue;
+        }
+        ++sent;
+    }
+#endif
+
+    if (failed != nullptr) {
+        *failed += errors;
+    }
+    return sent;
+}
+
+bool NetworkUtils::receiveRawPacket(int socket, void* buffer, size_t bufferSize, size_t& received) {
+    received = 0;
+    auto result = recv(socket, (char*)buffer, static_cast<int>(bufferSize), 0);
+    if (result < 0) {
+        setLastError(errno, "Failed to receive raw packet");
+        return false;
+    }
+    received = static_cast<size_t>(result);
+    return true;
+}
+
 std::vector<NetworkInterface> NetworkUtils::getNetworkInterfaces() {
     std::vector<NetworkInterface> interfaces;
     
@@ -695,6 +980,227 @@ std::vector<NetworkInterface> NetworkUtils::getLinuxInterfaces() {
 }
 #endif
 
+// Socket 方法实现
+Socket::Socket(int domain, int type, int protocol)
+    : m_socket(static_cast<int>(::socket(domain, type, protocol))) {
+    if (m_socket < 0) {
+        m_socket = -1;
+    }
+}
+
+Socket::Socket(int handle, bool connected) : m_socket(handle), m_connected(connected) {}
+
+Socket Socket::adopt(int handle) {
+    return Socket(handle < 0 ? -1 : handle, false);
+}
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept
+    : m_socket(other.m_socket), m_connected(other.m_connected) {
+    other.m_socket = -1;
+    other.m_connected = false;
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_socket = other.m_socket;
+        m_connected = other.m_connected;
+        other.m_socket = -1;
+        other.m_connected = false;
+    }
+    return *this;
+}
+
+bool Socket::bind(const IPAddress& address, uint16_t port) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = NetworkUtils::toSockaddr(address, port, addr);
+    return ::bind(m_socket, (struct sockaddr*)&addr, addr_len) == 0;
+}
+
+bool Socket::connect(const IPAddress& address, uint16_t port, std::chrono::milliseconds timeout) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = NetworkUtils::toSockaddr(address, port, addr);
+
+    // 非阻塞连接并等待超时，完成后恢复阻塞模式
+    setNonBlocking(true);
+    int result = ::connect(m_socket, (struct sockaddr*)&addr, addr_len);
+    if (result != 0) {
+#ifdef _WIN32
+        if (WSAGetLastError() != WSAEWOULDBLOCK) {
+#else
+        if (errno != EINPROGRESS) {
+#endif
+            setNonBlocking(false);
+            return false;
+        }
+
+        if (!NetworkUtils::waitSocket(m_socket, POLLOUT, timeout)) {
+            setNonBlocking(false);
+            return false;
+        }
+
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(m_socket, SOL_SOCKET, SO_ERROR, (char*)&error, &len);
+        if (error != 0) {
+            setNonBlocking(false);
+            return false;
+        }
+    }
+
+    setNonBlocking(false);
+    m_connected = true;
+    return true;
+}
+
+bool Socket::listen(int backlog) {
+    return ::listen(m_socket, backlog) == 0;
+}
+
+Socket Socket::accept() {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    int handle = static_cast<int>(::accept(m_socket, (struct sockaddr*)&addr, &addr_len));
+    return Socket(handle < 0 ? -1 : handle, handle >= 0);
+}
+
+ssize_t Socket::send(const void* data, size_t length) {
+#ifdef _WIN32
+    return ::send(m_socket, (const char*)data, static_cast<int>(length), 0);
+#else
+    return ::send(m_socket, data, length, MSG_NOSIGNAL);
+#endif
+}
+
+ssize_t Socket::receive(void* buffer, size_t bufferSize) {
+    return ::recv(m_socket, (char*)buffer, static_cast<int>(bufferSize), 0);
+}
+
+ssize_t Socket::sendTo(const void* data, size_t length, const IPAddress& address, uint16_t port) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = NetworkUtils::toSockaddr(address, port, addr);
+    return ::sendto(m_socket, (const char*)data, static_cast<int>(length), 0, (struct sockaddr*)&addr, addr_len);
+}
+
+ssize_t Socket::receiveFrom(void* buffer, size_t bufferSize, IPAddress& fromAddress, uint16_t& fromPort) {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    auto received = ::recvfrom(m_socket, (char*)buffer, static_cast<int>(bufferSize), 0,
+                               (struct sockaddr*)&addr, &addr_len);
+    if (received >= 0) {
+        fromAddress = parseSockaddr(addr, fromPort);
+    }
+    return received;
+}
+
+bool Socket::setNonBlocking(bool nonBlocking) {
+#ifdef _WIN32
+    u_long mode = nonBlocking ? 1 : 0;
+    return ioctlsocket(m_socket, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(m_socket, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(m_socket, F_SETFL, flags) == 0;
+#endif
+}
+
+bool Socket::setReuseAddress(bool reuse) {
+    int value = reuse ? 1 : 0;
+    return setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&value, sizeof(value)) == 0;
+}
+
+bool Socket::setTimeout(std::chrono::milliseconds timeout) {
+    return setReceiveTimeout(timeout) && setSendTimeout(timeout);
+}
+
+bool Socket::setReceiveTimeout(std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    DWORD value = static_cast<DWORD>(timeout.count());
+    return setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&value, sizeof(value)) == 0;
+#else
+    struct timeval tv;
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    return setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+#endif
+}
 
+bool Socket::setSendTimeout(std::chrono::milliseconds timeout) {
+#ifdef _WIN32
+    DWORD value = static_cast<DWORD>(timeout.count());
+    return setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, (const char*)&value, sizeof(value)) == 0;
+#else
+    struct timeval tv;
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    return setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) == 0;
+#endif
+}
+
+bool Socket::isConnected() const {
+    return m_socket != -1 && m_connected;
+}
+
+IPAddress Socket::getLocalAddress() const {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    uint16_t port = 0;
+    if (getsockname(m_socket, (struct sockaddr*)&addr, &addr_len) != 0) {
+        return IPAddress();
+    }
+    return parseSockaddr(addr, port);
+}
+
+uint16_t Socket::getLocalPort() const {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    uint16_t port = 0;
+    if (getsockname(m_socket, (struct sockaddr*)&addr, &addr_len) == 0) {
+        parseSockaddr(addr, port);
+    }
+    return port;
+}
+
+IPAddress Socket::getRemoteAddress() const {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    uint16_t port = 0;
+    if (getpeername(m_socket, (struct sockaddr*)&addr, &addr_len) != 0) {
+        return IPAddress();
+    }
+    return parseSockaddr(addr, port);
+}
+
+uint16_t Socket::getRemotePort() const {
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    uint16_t port = 0;
+    if (getpeername(m_socket, (struct sockaddr*)&addr, &addr_len) == 0) {
+        parseSockaddr(addr, port);
+    }
+    return port;
+}
+
+void Socket::close() {
+    if (m_socket != -1) {
+        closeHandle(m_socket);
+        m_socket = -1;
+    }
+    m_connected = false;
+}
+
+int Socket::release() {
+    int handle = m_socket;
+    m_socket = -1;
+    m_connected = false;
+    return handle;
+}
 
 } // namespace MindSploit::Utils
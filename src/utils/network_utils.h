@@ -15,10 +15,13 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
+#include <poll.h>
 #endif
 
 namespace MindSploit::Utils {
 
+class PacketBatch;
+
 // IP地址结构
 struct IPAddress {
     std::string address;
@@ -66,6 +69,8 @@ struct ConnectionResult {
     int errorCode = 0;
 };
 
+class Socket;
+
 // 网络工具类
 class NetworkUtils {
 public:
@@ -111,11 +116,26 @@ public:
     // 网络扫描辅助
     static std::string grabBanner(const IPAddress& target, uint16_t port,
                                  std::chrono::milliseconds timeout = std::chrono::milliseconds(3000));
+    // 在已连接的套接字上读取横幅 (received为已收到的数据，非空时直接取其首行)
+    static std::string readBanner(Socket& sock, std::chrono::milliseconds timeout,
+                                  const std::string& received = "");
+    // 横幅首行，控制字符替换为'.'
+    static std::string bannerLine(const char* data, size_t length);
     static std::string detectService(uint16_t port, const std::string& banner = "");
     
-    // 原始套接字相关
-    static int createRawSocket(int protocol);
+    // 等待套接字就绪 (poll，fd不受FD_SETSIZE限制); pollSockets返回就绪数，waitSocket超时或出错返回false
+    static int pollSockets(struct pollfd* fds, size_t count, std::chrono::milliseconds timeout);
+    static bool waitSocket(int socket, short events, std::chrono::milliseconds timeout);
+    
+    // 套接字地址 (地址为空时为INADDR_ANY)
+    static socklen_t toSockaddr(const IPAddress& address, uint16_t port, struct sockaddr_storage& addr);
+    
+    // 原始套接字相关 (IPPROTO_RAW套接字由调用方提供完整IP首部)
+    static int createRawSocket(int protocol, bool ipv6 = false);
+    static void closeRawSocket(int socket);
     static bool sendRawPacket(int socket, const void* data, size_t length, const IPAddress& target);
+    // 返回发送成功的个数; 发送失败的报文被跳过，个数累加到failed
+    static size_t sendRawBatch(int socket, PacketBatch& batch, size_t* failed = nullptr);
     static bool receiveRawPacket(int socket, void* buffer, size_t bufferSize, size_t& received);
     
     // 工具方法
@@ -159,6 +179,9 @@ public:
     Socket(Socket&& other) noexcept;
     Socket& operator=(Socket&& other) noexcept;
     
+    // 接管已创建的套接字句柄 (如SocketBudget::openProbeSocket的返回值)，句柄无效时返回无效套接字
+    static Socket adopt(int handle);
+    
     // 基本操作
     bool bind(const IPAddress& address, uint16_t port);
     bool connect(const IPAddress& address, uint16_t port, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000));
@@ -189,8 +212,12 @@ public:
     
     // 关闭
     void close();
+    // 放弃所有权并返回句柄
+    int release();
 
 private:
+    Socket(int handle, bool connected);
+
     int m_socket = -1;
     bool m_connected = false;
 };
@@ -0,0 +1,186 @@
+#include "packet_channel.h"
+#include "xdp_channel.h"
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 256;
+constexpr size_t RECEIVE_BUFFER = 2048;
+constexpr int SOCKET_BUFFER = 16 * 1024 * 1024;
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+// 原始套接字通道
+class RawSocketChannel : public PacketChannel {
+public:
+    explicit RawSocketChannel(const PacketChannelConfig& config) : m_config(config) {}
+
+    ~RawSocketChannel() override {
+        NetworkUtils::closeRawSocket(m_sendSocket);
+        NetworkUtils::closeRawSocket(m_receiveSocket);
+    }
+
+    bool open(const IPAddress& probeTarget, std::string& error) {
+#ifdef _WIN32
+        (void)probeTarget;
+        error = "Raw socket probing is not supported on Windows";
+        return false;
+#else
+        // 传输层校验和包含源地址，由到探测目标的路由决定
+        Socket route(AF_INET, SOCK_DGRAM);
+        if (!route.isValid() || !route.connect(probeTarget, 80)) {
+            error = "No route to " + probeTarget.address;
+            return false;
+        }
+        m_source = route.getLocalAddress();
+
+        m_sendSocket = NetworkUtils::createRawSocket(IPPROTO_RAW);
+        m_receiveSocket = static_cast<int>(socket(AF_INET, SOCK_RAW, m_config.protocol));
+        if (m_sendSocket < 0 || m_receiveSocket < 0) {
+            error = "Failed to create raw sockets (requires root or CAP_NET_RAW)";
+            return false;
+        }
+
+        // 高速率下应答成批到达，接收缓冲区要能容纳发送间隙中的突发
+        fcntl(m_receiveSocket, F_SETFL, fcntl(m_receiveSocket, F_GETFL, 0) | O_NONBLOCK);
+        setsockopt(m_receiveSocket, SOL_SOCKET, SO_RCVBUF, &SOCKET_BUFFER, sizeof(SOCKET_BUFFER));
+        setsockopt(m_sendSocket, SOL_SOCKET, SO_SNDBUF, &SOCKET_BUFFER, sizeof(SOCKET_BUFFER));
+        return true;
+#endif
+    }
+
+    size_t send(const PacketTemplate& packetTemplate, const ProbeTarget* targets, size_t count) override {
+        PacketBatch& batch = batchFor(packetTemplate);
+        size_t sent = 0;
+        size_t failed = 0;
+        for (size_t i = 0; i < count; ++i) {
+            batch.add(targets[i]);
+            if (batch.full() || i + 1 == count) {
+                sent += NetworkUtils::sendRawBatch(m_sendSocket, batch, &failed);
+                batch.clear();
+            }
+        }
+        m_stats.sent += sent;
+        m_stats.sendErrors += failed;
+        return sent;
+    }
+
+    size_t receive(const Handler& handler) override {
+        uint8_t buffer[RECEIVE_BUFFER];
+        size_t handled = 0;
+        int received;
+        while ((received = recv(m_receiveSocket, (char*)buffer, sizeof(buffer), 0)) > 0) {
+            // 协议原始套接字收到本机的所有该协议报文，TCP/UDP按目的端口过滤
+            size_t length = static_cast<size_t>(received);
+            size_t headerLength = (buffer[0] & 0x0f) * 4;
+            if ((m_config.protocol == IPPROTO_TCP || m_config.protocol == IPPROTO_UDP) &&
+                length >= headerLength + 4) {
+                uint16_t port = readU16(buffer + headerLength + 2);
+                if (port < m_config.firstPort || port > m_config.lastPort) {
+                    continue;
+                }
+            }
+            ++handled;
+            handler(buffer, length);
+        }
+        m_stats.received += handled;
+        return handled;
+    }
+
+    void wait(std::chrono::microseconds timeout) override {
+#ifdef __linux__
+        // 高速率下发送间隙不到1毫秒，ppoll保留微秒精度
+        struct pollfd pfd = {m_receiveSocket, POLLIN, 0};
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000) * 1000;
+        ppoll(&pfd, 1, &ts, nullptr);
+#else
+        NetworkUtils::waitSocket(m_receiveSocket, POLLIN, std::chrono::ceil<std::chrono::milliseconds>(timeout));
+#endif
+    }
+
+    std::string describe() const override { return "raw socket"; }
+    PacketChannelStats getStats() const override { return m_stats; }
+
+private:
+    // 每个模板一个批量缓冲区，扫描中使用的模板只有几个
+    PacketBatch& batchFor(const PacketTemplate& packetTemplate) {
+        for (auto& entry : m_batches) {
+            if (entry.first == &packetTemplate) {
+                return *entry.second;
+            }
+        }
+        m_batches.emplace_back(&packetTemplate, std::make_unique<PacketBatch>(packetTemplate, BATCH_SIZE));
+        return *m_batches.back().second;
+    }
+
+    PacketChannelConfig m_config;
+    int m_sendSocket = -1;
+    int m_receiveSocket = -1;
+    std::vector<std::pair<const PacketTemplate*, std::unique_ptr<PacketBatch>>> m_batches;
+    PacketChannelStats m_stats;
+};
+
+} // namespace
+
+std::string packetBackendName(PacketBackend backend) {
+    return backend == PacketBackend::XDP ? "xdp" : "raw";
+}
+
+bool parsePacketBackend(const std::string& name, PacketBackend& backend) {
+    if (name == "raw") {
+        backend = PacketBackend::RAW_SOCKET;
+    } else if (name == "xdp" || name == "af_xdp") {
+        backend = PacketBackend::XDP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseXdpMode(const std::string& name, XdpMode& mode) {
+    if (name == "auto") {
+        mode = XdpMode::AUTO;
+    } else if (name == "native" || name == "drv") {
+        mode = XdpMode::NATIVE;
+    } else if (name == "skb" || name == "generic") {
+        mode = XdpMode::SKB;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<PacketChannel> PacketChannel::open(const PacketChannelConfig& config, const IPAddress& probeTarget,
+                                                   std::string& error) {
+    if (config.backend == PacketBackend::XDP) {
+#ifdef __linux__
+        auto channel = std::make_unique<XdpChannel>(config);
+        if (!channel->open(probeTarget, error)) {
+            return nullptr;
+        }
+        return channel;
+#else
+        error = "AF_XDP is only supported on Linux";
+        return nullptr;
+#endif
+    }
+
+    auto channel = std::make_unique<RawSocketChannel>(config);
+    if (!channel->open(probeTarget, error)) {
+        return nullptr;
+    }
+    return channel;
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "packet_template.h"
+#include <functional>
+#include <memory>
+
+namespace MindSploit::Utils {
+
+// 原始探测的收发方式
+enum class PacketBackend {
+    RAW_SOCKET,     // IP_HDRINCL原始套接字发送，协议原始套接字接收
+    XDP             // AF_XDP套接字，UMEM帧直接交给网卡队列 (仅Linux)
+};
+
+std::string packetBackendName(PacketBackend backend);
+bool parsePacketBackend(const std::string& name, PacketBackend& backend);
+
+// XDP程序挂载方式
+enum class XdpMode {
+    AUTO,           // 先尝试驱动模式，不支持时退回通用模式
+    NATIVE,         // 驱动模式 (XDP_FLAGS_DRV_MODE)
+    SKB             // 通用模式 (XDP_FLAGS_SKB_MODE)，任何接口都可用，包括veth
+};
+
+bool parseXdpMode(const std::string& name, XdpMode& mode);
+
+struct PacketChannelConfig {
+    PacketBackend backend = PacketBackend::RAW_SOCKET;
+    uint8_t protocol = 6;                   // 接收的传输层协议 (默认TCP)
+    uint16_t firstPort = 0;                 // 只接收目的端口在此范围内的报文 (AF_XDP在内核中过滤，范围须在临时端口之外)
+    uint16_t lastPort = 65535;
+    std::string interface;                  // AF_XDP: 收发接口，为空时按到探测目标的路由选择
+    uint32_t queue = 0;                     // AF_XDP: 绑定的网卡队列
+    XdpMode xdpMode = XdpMode::AUTO;
+    size_t frames = 8192;                   // AF_XDP: UMEM帧数，一半用于接收
+};
+
+struct PacketChannelStats {
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t dropped = 0;                   // 接收环满或内核丢弃的报文
+    uint64_t sendErrors = 0;                // 发送时被拒绝的报文 (不可达、广播地址、防火墙)
+};
+
+// 原始探测的收发通道
+//
+// 扫描器用PacketTemplate描述要发送的报文，通道决定报文写到哪里:
+// 原始套接字写入PacketBatch后sendmmsg提交; AF_XDP直接在UMEM帧中stamp，
+// 描述符放入发送环即交给网卡队列，用户态不再拷贝。收到的报文都从IP首部开始交给处理函数。
+class PacketChannel {
+public:
+    using Handler = std::function<void(const uint8_t* packet, size_t length)>;
+
+    // probeTarget用于选择源地址 (以及AF_XDP的接口和下一跳)
+    static std::unique_ptr<PacketChannel> open(const PacketChannelConfig& config, const IPAddress& probeTarget,
+                                               std::string& error);
+
+    virtual ~PacketChannel() = default;
+
+    const IPAddress& source() const { return m_source; }
+    // 填写模板的源地址，需要时补全二层封装
+    virtual void configureTemplate(PacketTemplateConfig& config) const { config.source = m_source; }
+
+    // 以packetTemplate为每个目标生成并发送报文，返回发送的个数
+    virtual size_t send(const PacketTemplate& packetTemplate, const ProbeTarget* targets, size_t count) = 0;
+    // 处理已到达的报文，不阻塞，返回处理的个数
+    virtual size_t receive(const Handler& handler) = 0;
+    // 等待报文到达，最多timeout
+    virtual void wait(std::chrono::microseconds timeout) = 0;
+
+    virtual std::string describe() const = 0;
+    virtual PacketChannelStats getStats() const = 0;
+
+protected:
+    IPAddress m_source;
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,339 @@
+#include "packet_template.h"
+#include <cstring>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr size_t ETHERNET_HEADER_SIZE = 14;
+constexpr size_t IPV4_HEADER_SIZE = 20;
+constexpr size_t IPV6_HEADER_SIZE = 40;
+constexpr size_t TCP_HEADER_SIZE = 20;
+constexpr size_t UDP_HEADER_SIZE = 8;
+constexpr size_t ICMP_HEADER_SIZE = 8;
+
+constexpr uint8_t PROTO_ICMP = 1;
+constexpr uint8_t PROTO_TCP = 6;
+constexpr uint8_t PROTO_UDP = 17;
+constexpr uint8_t PROTO_ICMPV6 = 58;
+
+// 槽位按缓存行对齐，避免相邻探测包共享缓存行
+constexpr size_t SLOT_ALIGNMENT = 64;
+
+inline void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value >> 8);
+    p[1] = static_cast<uint8_t>(value);
+}
+
+inline void writeU32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value >> 24);
+    p[1] = static_cast<uint8_t>(value >> 16);
+    p[2] = static_cast<uint8_t>(value >> 8);
+    p[3] = static_cast<uint8_t>(value);
+}
+
+uint8_t transportProtocol(ProbeType type, bool ipv6) {
+    switch (type) {
+        case ProbeType::TCP_SYN:
+        case ProbeType::TCP_ACK:
+        case ProbeType::TCP_DATA:
+        case ProbeType::TCP_RST:
+            return PROTO_TCP;
+        case ProbeType::UDP:
+            return PROTO_UDP;
+        case ProbeType::ICMP_ECHO:
+            return ipv6 ? PROTO_ICMPV6 : PROTO_ICMP;
+    }
+    return PROTO_TCP;
+}
+
+uint8_t tcpFlags(ProbeType type) {
+    switch (type) {
+        case ProbeType::TCP_SYN: return 0x02;
+        case ProbeType::TCP_DATA: return 0x18;      // PSH+ACK
+        case ProbeType::TCP_RST: return 0x14;       // RST+ACK
+        default: break;
+    }
+    return 0x10;
+}
+
+} // namespace
+
+bool ProbeTarget::setAddress(const IPAddress& ip) {
+    std::memset(address, 0, sizeof(address));
+    if (ip.isIPv6) {
+        return inet_pton(AF_INET6, ip.address.c_str(), address) == 1;
+    }
+    return inet_pton(AF_INET, ip.address.c_str(), address) == 1;
+}
+
+PacketTemplate::PacketTemplate(const PacketTemplateConfig& config)
+    : m_type(config.type), m_ipv6(config.source.isIPv6), m_defaultTtl(config.ttl) {
+    if (config.includeEthernet) {
+        buildEthernet(config);
+    }
+    m_l3Offset = m_packet.size();
+    m_l4Offset = m_l3Offset + (m_ipv6 ? IPV6_HEADER_SIZE : IPV4_HEADER_SIZE);
+
+    // 先构建传输层以得到长度，再回填网络层首部
+    m_packet.resize(m_l4Offset);
+    size_t l4Length = buildTransport(config);
+
+    uint8_t protocol = transportProtocol(m_type, m_ipv6);
+    if (m_ipv6) {
+        buildIPv6(config, protocol, l4Length);
+    } else {
+        buildIPv4(config, protocol, l4Length);
+    }
+
+    // 传输层校验和常量部分: 伪首部(不含目标地址) + 首部(不含可变字段) + 负载
+    const uint8_t* ip = m_packet.data() + m_l3Offset;
+    uint32_t sum = 0;
+    bool pseudoHeader = !(m_type == ProbeType::ICMP_ECHO && !m_ipv6);
+    if (pseudoHeader) {
+        uint8_t tail[4] = {0, 0, 0, protocol};
+        if (m_ipv6) {
+            sum = partialSum(ip + 8, 16, sum);          // 源地址
+            uint8_t length[4];
+            writeU32(length, static_cast<uint32_t>(l4Length));
+            sum = partialSum(length, 4, sum);
+        } else {
+            sum = partialSum(ip + 12, 4, sum);          // 源地址
+            uint8_t length[2];
+            writeU16(length, static_cast<uint16_t>(l4Length));
+            sum = partialSum(length, 2, sum);
+        }
+        sum = partialSum(tail, 4, sum);
+    }
+    m_l4SumBase = partialSum(m_packet.data() + m_l4Offset, l4Length, sum);
+}
+
+void PacketTemplate::buildEthernet(const PacketTemplateConfig& config) {
+    m_packet.resize(ETHERNET_HEADER_SIZE);
+    uint8_t* eth = m_packet.data();
+    std::memcpy(eth, config.gatewayMac, 6);
+    std::memcpy(eth + 6, config.sourceMac, 6);
+    writeU16(eth + 12, m_ipv6 ? 0x86DD : 0x0800);
+}
+
+void PacketTemplate::buildIPv4(const PacketTemplateConfig& config, uint8_t protocol, size_t l4Length) {
+    uint8_t* ip = m_packet.data() + m_l3Offset;
+    std::memset(ip, 0, IPV4_HEADER_SIZE);
+    ip[0] = 0x45;                                   // 版本4, 首部长度5
+    writeU16(ip + 2, static_cast<uint16_t>(IPV4_HEADER_SIZE + l4Length));
+    ip[8] = 0;                                      // TTL在stamp时写入
+    ip[9] = protocol;
+    inet_pton(AF_INET, config.source.address.c_str(), ip + 12);
+
+    // 标识、TTL和目标地址为可变字段，常量部分的累加和在此时计算
+    m_ipSumBase = partialSum(ip, IPV4_HEADER_SIZE);
+    ip[8] = config.ttl;
+}
+
+void PacketTemplate::buildIPv6(const PacketTemplateConfig& config, uint8_t nextHeader, size_t l4Length) {
+    uint8_t* ip = m_packet.data() + m_l3Offset;
+    std::memset(ip, 0, IPV6_HEADER_SIZE);
+    ip[0] = 0x60;                                   // 版本6
+    writeU16(ip + 4, static_cast<uint16_t>(l4Length));
+    ip[6] = nextHeader;
+    ip[7] = config.ttl;
+    inet_pton(AF_INET6, config.source.address.c_str(), ip + 8);
+}
+
+size_t PacketTemplate::buildTransport(const PacketTemplateConfig& config) {
+    size_t headerSize = 0;
+    switch (m_type) {
+        case ProbeType::TCP_SYN:
+        case ProbeType::TCP_ACK:
+        case ProbeType::TCP_DATA:
+        case ProbeType::TCP_RST:
+            headerSize = TCP_HEADER_SIZE + (config.tcpMss ? 4 : 0);
+            break;
+        case ProbeType::UDP:
+            headerSize = UDP_HEADER_SIZE;
+            break;
+        case ProbeType::ICMP_ECHO:
+            headerSize = ICMP_HEADER_SIZE;
+            break;
+    }
+
+    // TCP只有数据段携带负载
+    size_t payloadSize = (m_type == ProbeType::UDP || m_type == ProbeType::ICMP_ECHO ||
+                          m_type == ProbeType::TCP_DATA) ? config.payload.size() : 0;
+    size_t l4Length = headerSize + payloadSize;
+    m_packet.resize(m_l4Offset + l4Length, 0);
+    uint8_t* l4 = m_packet.data() + m_l4Offset;
+
+    switch (m_type) {
+        case ProbeType::TCP_SYN:
+        case ProbeType::TCP_ACK:
+        case ProbeType::TCP_DATA:
+        case ProbeType::TCP_RST:
+            l4[12] = static_cast<uint8_t>((headerSize / 4) << 4);
+            l4[13] = tcpFlags(m_type);
+            writeU16(l4 + 14, config.tcpWindow);
+            if (config.tcpMss) {
+                l4[20] = 2;                         // MSS选项
+                l4[21] = 4;
+                writeU16(l4 + 22, config.tcpMss);
+            }
+            m_checksumOffset = 16;
+            break;
+        case ProbeType::UDP:
+            writeU16(l4 + 4, static_cast<uint16_t>(l4Length));
+            m_checksumOffset = 6;
+            break;
+        case ProbeType::ICMP_ECHO:
+            l4[0] = m_ipv6 ? 128 : 8;               // Echo Request
+            m_checksumOffset = 2;
+            break;
+    }
+
+    if (payloadSize) {
+        std::memcpy(l4 + headerSize, config.payload.data(), payloadSize);
+    }
+    return l4Length;
+}
+
+void PacketTemplate::stamp(uint8_t* buffer, const ProbeTarget& target) const {
+    std::memcpy(buffer, m_packet.data(), m_packet.size());
+
+    uint8_t* ip = buffer + m_l3Offset;
+    uint8_t* l4 = buffer + m_l4Offset;
+    const size_t addressSize = m_ipv6 ? 16 : 4;
+    uint8_t ttl = target.ttl ? target.ttl : m_defaultTtl;
+
+    // 网络层
+    const uint8_t* destination;
+    if (m_ipv6) {
+        ip[7] = ttl;
+        std::memcpy(ip + 24, target.address, 16);
+        destination = ip + 24;
+    } else {
+        writeU16(ip + 4, target.ipId);
+        ip[8] = ttl;
+        std::memcpy(ip + 16, target.address, 4);
+        destination = ip + 16;
+
+        uint8_t ttlWord[2] = {ttl, 0};
+        uint32_t sum = partialSum(ip + 4, 2, m_ipSumBase);
+        sum = partialSum(ttlWord, 2, sum);
+        sum = partialSum(destination, 4, sum);
+        uint16_t checksum = foldChecksum(sum);
+        std::memcpy(ip + 10, &checksum, 2);
+    }
+
+    // 传输层可变字段
+    const uint8_t* variable = l4;
+    size_t variableSize = 0;
+    switch (m_type) {
+        case ProbeType::TCP_SYN:
+        case ProbeType::TCP_ACK:
+        case ProbeType::TCP_DATA:
+        case ProbeType::TCP_RST:
+            writeU16(l4, target.sourcePort);
+            writeU16(l4 + 2, target.destinationPort);
+            writeU32(l4 + 4, target.sequence);
+            writeU32(l4 + 8, m_type == ProbeType::TCP_SYN ? 0 : target.acknowledgment);
+            variableSize = 12;
+            break;
+        case ProbeType::UDP:
+            writeU16(l4, target.sourcePort);
+            writeU16(l4 + 2, target.destinationPort);
+            variableSize = 4;
+            break;
+        case ProbeType::ICMP_ECHO:
+            writeU16(l4 + 4, target.sourcePort);
+            writeU16(l4 + 6, static_cast<uint16_t>(target.sequence));
+            variable = l4 + 4;
+            variableSize = 4;
+            break;
+    }
+
+    uint32_t sum = partialSum(variable, variableSize, m_l4SumBase);
+    if (!(m_type == ProbeType::ICMP_ECHO && !m_ipv6)) {
+        sum = partialSum(destination, addressSize, sum);
+    }
+    uint16_t checksum = foldChecksum(sum);
+    if (m_type == ProbeType::UDP && checksum == 0) {
+        checksum = 0xFFFF;                          // UDP中0表示无校验和
+    }
+    std::memcpy(l4 + m_checksumOffset, &checksum, 2);
+}
+
+uint32_t PacketTemplate::partialSum(const uint8_t* data, size_t length, uint32_t sum) {
+    // 以本机字节序累加16位字，反码和与字节序无关 (RFC 1071)
+    while (length > 1) {
+        uint16_t word;
+        std::memcpy(&word, data, 2);
+        sum += word;
+        data += 2;
+        length -= 2;
+    }
+    if (length == 1) {
+        uint8_t tail[2] = {*data, 0};
+        uint16_t word;
+        std::memcpy(&word, tail, 2);
+        sum += word;
+    }
+    return sum;
+}
+
+uint16_t PacketTemplate::foldChecksum(uint32_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+PacketBatch::PacketBatch(const PacketTemplate& packetTemplate, size_t capacity)
+    : m_template(packetTemplate),
+      m_capacity(capacity),
+      m_stride((packetTemplate.size() + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT),
+      m_destinationLength(packetTemplate.isIPv6() ? sizeof(sockaddr_in6) : sizeof(sockaddr_in)),
+      m_buffer(m_stride * capacity, 0),
+      m_destinations(capacity) {
+    std::memset(m_destinations.data(), 0, sizeof(sockaddr_storage) * capacity);
+#ifdef __linux__
+    m_iovecs.resize(capacity);
+    m_messages.resize(capacity);
+    std::memset(m_messages.data(), 0, sizeof(struct mmsghdr) * capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        m_iovecs[i].iov_base = m_buffer.data() + i * m_stride;
+        m_iovecs[i].iov_len = packetTemplate.size();
+        m_messages[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_messages[i].msg_hdr.msg_iovlen = 1;
+        // 二层帧通过已绑定接口的AF_PACKET套接字发送，无需目标地址
+        if (!packetTemplate.hasEthernet()) {
+            m_messages[i].msg_hdr.msg_name = &m_destinations[i];
+            m_messages[i].msg_hdr.msg_namelen = m_destinationLength;
+        }
+    }
+#endif
+}
+
+bool PacketBatch::add(const ProbeTarget& target) {
+    if (m_count == m_capacity) {
+        return false;
+    }
+
+    m_template.stamp(m_buffer.data() + m_count * m_stride, target);
+
+    if (!m_template.hasEthernet()) {
+        sockaddr_storage& destination = m_destinations[m_count];
+        if (m_template.isIPv6()) {
+            auto* addr6 = reinterpret_cast<sockaddr_in6*>(&destination);
+            addr6->sin6_family = AF_INET6;
+            std::memcpy(&addr6->sin6_addr, target.address, 16);
+        } else {
+            auto* addr4 = reinterpret_cast<sockaddr_in*>(&destination);
+            addr4->sin_family = AF_INET;
+            std::memcpy(&addr4->sin_addr, target.address, 4);
+        }
+    }
+
+    ++m_count;
+    return true;
+}
+
+} // namespace MindSploit::Utils
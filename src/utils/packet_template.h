@@ -0,0 +1,133 @@
+#pragma once
+
+#include "network_utils.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
+
+namespace MindSploit::Utils {
+
+// 探测包类型
+enum class ProbeType {
+    TCP_SYN,        // TCP SYN探测
+    TCP_ACK,        // TCP ACK探测
+    TCP_DATA,       // TCP PSH+ACK，携带负载 (用户态TCP发送请求)
+    TCP_RST,        // TCP RST+ACK (用户态TCP结束连接)
+    UDP,            // UDP探测 (可携带负载)
+    ICMP_ECHO       // ICMP/ICMPv6 Echo请求
+};
+
+// 模板配置 - 每次扫描每种探测类型构建一次
+struct PacketTemplateConfig {
+    ProbeType type = ProbeType::TCP_SYN;
+    IPAddress source;                   // 源地址 (决定IPv4/IPv6)
+    uint8_t ttl = 64;                   // 默认TTL/Hop Limit
+    uint16_t tcpWindow = 1024;          // TCP窗口大小
+    uint16_t tcpMss = 1460;             // TCP MSS选项 (0表示不带选项)
+    std::vector<uint8_t> payload;       // UDP/ICMP/TCP_DATA负载
+
+    // 二层封装 (用于AF_PACKET/数据包环形缓冲区)
+    bool includeEthernet = false;
+    uint8_t sourceMac[6] = {0};
+    uint8_t gatewayMac[6] = {0};
+};
+
+// 单个探测的目标相关字段
+struct ProbeTarget {
+    uint8_t address[16] = {0};          // 目标地址 (网络字节序, IPv4只用前4字节)
+    uint16_t destinationPort = 0;       // 目标端口 (ICMP忽略)
+    uint16_t sourcePort = 0;            // 源端口 / ICMP标识符
+    uint32_t sequence = 0;              // TCP序列号 / ICMP序列号(低16位)
+    uint32_t acknowledgment = 0;        // TCP确认号 (SYN忽略)
+    uint16_t ipId = 0;                  // IPv4标识 (IPv6忽略)
+    uint8_t ttl = 0;                    // 0表示使用模板默认TTL
+
+    bool setAddress(const IPAddress& ip);
+};
+
+// 预构建的探测包模板
+// 所有常量首部字段和校验和的常量部分在构造时计算，
+// stamp() 只拷贝模板并写入目标相关字段，随后做增量校验和
+class PacketTemplate {
+public:
+    explicit PacketTemplate(const PacketTemplateConfig& config);
+
+    size_t size() const { return m_packet.size(); }
+    bool isIPv6() const { return m_ipv6; }
+    bool hasEthernet() const { return m_l3Offset != 0; }
+    ProbeType type() const { return m_type; }
+    size_t l3Offset() const { return m_l3Offset; }
+    size_t l4Offset() const { return m_l4Offset; }
+
+    // 将模板写入buffer (至少size()字节) 并填充目标字段，不分配内存
+    void stamp(uint8_t* buffer, const ProbeTarget& target) const;
+
+private:
+    void buildEthernet(const PacketTemplateConfig& config);
+    void buildIPv4(const PacketTemplateConfig& config, uint8_t protocol, size_t l4Length);
+    void buildIPv6(const PacketTemplateConfig& config, uint8_t nextHeader, size_t l4Length);
+    size_t buildTransport(const PacketTemplateConfig& config);
+
+    static uint32_t partialSum(const uint8_t* data, size_t length, uint32_t sum = 0);
+    static uint16_t foldChecksum(uint32_t sum);
+
+private:
+    ProbeType m_type;
+    bool m_ipv6 = false;
+    uint8_t m_defaultTtl = 64;
+    std::vector<uint8_t> m_packet;      // 完整模板 (目标字段为0)
+    size_t m_l3Offset = 0;
+    size_t m_l4Offset = 0;
+    size_t m_checksumOffset = 0;        // 传输层校验和偏移
+    uint32_t m_ipSumBase = 0;           // IPv4首部常量部分的累加和
+    uint32_t m_l4SumBase = 0;           // 伪首部+传输层常量部分的累加和
+};
+
+// 批量探测缓冲区
+// 一次性分配capacity个槽位及对应的iovec/mmsghdr，发送循环中只做stamp
+class PacketBatch {
+public:
+    PacketBatch(const PacketTemplate& packetTemplate, size_t capacity);
+
+    PacketBatch(const PacketBatch&) = delete;
+    PacketBatch& operator=(const PacketBatch&) = delete;
+
+    // 追加一个探测，批次已满时返回false
+    bool add(const ProbeTarget& target);
+    void clear() { m_count = 0; }
+
+    size_t size() const { return m_count; }
+    size_t capacity() const { return m_capacity; }
+    bool full() const { return m_count == m_capacity; }
+    size_t packetSize() const { return m_template.size(); }
+    size_t stride() const { return m_stride; }
+
+    const uint8_t* packet(size_t index) const { return m_buffer.data() + index * m_stride; }
+    const sockaddr_storage& destination(size_t index) const { return m_destinations[index]; }
+    socklen_t destinationLength() const { return m_destinationLength; }
+    const PacketTemplate& packetTemplate() const { return m_template; }
+
+#ifdef __linux__
+    // 供sendmmsg使用的消息数组 (前size()项有效)
+    struct mmsghdr* messages() { return m_messages.data(); }
+#endif
+
+private:
+    const PacketTemplate& m_template;
+    size_t m_capacity;
+    size_t m_stride;
+    size_t m_count = 0;
+    socklen_t m_destinationLength;
+    std::vector<uint8_t> m_buffer;
+    std::vector<sockaddr_storage> m_destinations;
+#ifdef __linux__
+    std::vector<struct iovec> m_iovecs;
+    std::vector<struct mmsghdr> m_messages;
+#endif
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,576 @@
+#include "proxy_pool.h"
+#include "socket_budget.h"
+#include <algorithm>
+#include <thread>
+#include <cctype>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr std::chrono::milliseconds BASE_COOLDOWN{5000};
+constexpr std::chrono::milliseconds MAX_COOLDOWN{60000};
+constexpr size_t MAX_HTTP_RESPONSE_HEADER = 8192;
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(start, end - start + 1);
+}
+
+std::string base64Encode(const std::string& data) {
+    static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string output;
+    output.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t value = (static_cast<uint8_t>(data[i]) << 16) | (static_cast<uint8_t>(data[i + 1]) << 8) |
+                         static_cast<uint8_t>(data[i + 2]);
+        output += ALPHABET[(value >> 18) & 0x3F];
+        output += ALPHABET[(value >> 12) & 0x3F];
+        output += ALPHABET[(value >> 6) & 0x3F];
+        output += ALPHABET[value & 0x3F];
+    }
+    if (i < data.size()) {
+        uint32_t value = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size()) {
+            value |= static_cast<uint8_t>(data[i + 1]) << 8;
+        }
+        output += ALPHABET[(value >> 18) & 0x3F];
+        output += ALPHABET[(value >> 12) & 0x3F];
+        output += i + 1 < data.size() ? ALPHABET[(value >> 6) & 0x3F] : '=';
+        output += '=';
+    }
+    return output;
+}
+
+std::string hostPort(const IPAddress& address, uint16_t port) {
+    return (address.isIPv6 ? "[" + address.address + "]" : address.address) + ":" + std::to_string(port);
+}
+
+std::string socksReplyName(uint8_t code) {
+    switch (code) {
+        case 0x01: return "general failure";
+        case 0x02: return "connection not allowed by ruleset";
+        case 0x03: return "network unreachable";
+        case 0x04: return "host unreachable";
+        case 0x05: return "connection refused";
+        case 0x06: return "TTL expired";
+        case 0x07: return "command not supported";
+        case 0x08: return "address type not supported";
+        default: return "reply " + std::to_string(code);
+    }
+}
+
+} // namespace
+
+std::string ProxyEndpoint::toString() const {
+    return std::string(type == Type::SOCKS5 ? "socks5://" : "http://") + hostPort(address, port);
+}
+
+bool parseProxyList(const std::string& text, std::vector<ProxyEndpoint>& proxies, std::string& error) {
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        std::string item = trim(text.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        start = comma == std::string::npos ? text.size() + 1 : comma + 1;
+        if (item.empty()) {
+            continue;
+        }
+
+        ProxyEndpoint proxy;
+        std::string rest = item;
+        size_t scheme = rest.find("://");
+        if (scheme != std::string::npos) {
+            std::string name = rest.substr(0, scheme);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            if (name == "socks5" || name == "socks5h" || name == "socks") {
+                proxy.type = ProxyEndpoint::Type::SOCKS5;
+            } else if (name == "http") {
+                proxy.type = ProxyEndpoint::Type::HTTP_CONNECT;
+            } else {
+                error = "Unsupported proxy scheme: " + item;
+                return false;
+            }
+            rest = rest.substr(scheme + 3);
+        }
+        while (!rest.empty() && rest.back() == '/') {
+            rest.pop_back();
+        }
+
+        size_t at = rest.rfind('@');
+        if (at != std::string::npos) {
+            std::string credentials = rest.substr(0, at);
+            size_t colon = credentials.find(':');
+            proxy.username = credentials.substr(0, colon);
+            proxy.password = colon == std::string::npos ? "" : credentials.substr(colon + 1);
+            rest = rest.substr(at + 1);
+        }
+
+        std::string host;
+        std::string portText;
+        if (!rest.empty() && rest.front() == '[') {
+            size_t close = rest.find(']');
+            if (close == std::string::npos || close + 1 >= rest.size() || rest[close + 1] != ':') {
+                error = "Invalid proxy address: " + item;
+                return false;
+            }
+            host = rest.substr(1, close - 1);
+            portText = rest.substr(close + 2);
+        } else {
+            size_t colon = rest.rfind(':');
+            if (colon == std::string::npos) {
+                error = "Proxy port is required: " + item;
+                return false;
+            }
+            host = rest.substr(0, colon);
+            portText = rest.substr(colon + 1);
+        }
+
+        unsigned long port = 0;
+        try {
+            port = std::stoul(portText);
+        } catch (const std::exception&) {
+            port = 0;
+        }
+        if (port == 0 || port > 65535) {
+            error = "Invalid proxy port: " + item;
+            return false;
+        }
+        proxy.port = static_cast<uint16_t>(port);
+
+        proxy.address = NetworkUtils::isValidIP(host) ? IPAddress(host) : NetworkUtils::resolveHostname(host);
+        if (!proxy.address.isValid()) {
+            error = "Cannot resolve proxy host: " + host;
+            return false;
+        }
+        if (proxy.username.size() > 255 || proxy.password.size() > 255) {
+            error = "Proxy credentials too long: " + item;
+            return false;
+        }
+        proxies.push_back(std::move(proxy));
+    }
+
+    if (proxies.empty()) {
+        error = "No proxy specified";
+        return false;
+    }
+    return true;
+}
+
+// ProxyHandshake
+
+ProxyHandshake::ProxyHandshake(const ProxyEndpoint& proxy, const IPAddress& target, uint16_t port)
+    : m_proxy(proxy), m_target(target), m_port(port) {
+    if (m_proxy.type == ProxyEndpoint::Type::SOCKS5) {
+        m_stage = Stage::GREETING;
+        bool auth = !m_proxy.username.empty();
+        m_output = auth ? std::string("\x05\x02\x00\x02", 4) : std::string("\x05\x01\x00", 3);
+        return;
+    }
+
+    m_stage = Stage::HTTP_RESPONSE;
+    std::string authority = hostPort(m_target, m_port);
+    m_output = "CONNECT " + authority + " HTTP/1.1\r\nHost: " + authority + "\r\n";
+    if (!m_proxy.username.empty()) {
+        m_output += "Proxy-Authorization: Basic " + base64Encode(m_proxy.username + ":" + m_proxy.password) + "\r\n";
+    }
+    m_output += "\r\n";
+}
+
+ProxyOutcome ProxyHandshake::timeoutOutcome() const {
+    if (m_proxy.type == ProxyEndpoint::Type::SOCKS5) {
+        return m_stage == Stage::CONNECT ? ProxyOutcome::TARGET_FAILED : ProxyOutcome::PROXY_FAILED;
+    }
+    // HTTP代理在连接目标期间不发送任何数据，请求已发出即视为代理在处理
+    return m_output.empty() ? ProxyOutcome::TARGET_FAILED : ProxyOutcome::PROXY_FAILED;
+}
+
+void ProxyHandshake::queueSocksConnect() {
+    m_stage = Stage::CONNECT;
+    std::string request("\x05\x01\x00", 3);
+    struct sockaddr_storage addr;
+    NetworkUtils::toSockaddr(m_target, m_port, addr);
+    if (m_target.isIPv6) {
+        const auto* in6 = reinterpret_cast<const struct sockaddr_in6*>(&addr);
+        request += '\x04';
+        request.append(reinterpret_cast<const char*>(&in6->sin6_addr), 16);
+    } else {
+        const auto* in4 = reinterpret_cast<const struct sockaddr_in*>(&addr);
+        request += '\x01';
+        request.append(reinterpret_cast<const char*>(&in4->sin_addr), 4);
+    }
+    request += static_cast<char>(m_port >> 8);
+    request += static_cast<char>(m_port & 0xFF);
+    m_output += request;
+}
+
+ProxyHandshake::Result ProxyHandshake::fail(ProxyOutcome outcome, const std::string& error) {
+    m_stage = Stage::FINISHED;
+    m_outcome = outcome;
+    m_error = error;
+    return Result::FAILED;
+}
+
+ProxyHandshake::Result ProxyHandshake::feed(const char* data, size_t length, size_t& consumed) {
+    consumed = 0;
+    if (m_stage == Stage::FINISHED) {
+        return m_outcome == ProxyOutcome::ESTABLISHED ? Result::DONE : Result::FAILED;
+    }
+
+    if (m_stage == Stage::HTTP_RESPONSE) {
+        // 响应头结束后的数据属于目标，不能多消费
+        size_t searchFrom = m_input.size() >= 3 ? m_input.size() - 3 : 0;
+        m_input.append(data, length);
+        size_t end = m_input.find("\r\n\r\n", searchFrom);
+        if (end == std::string::npos) {
+            consumed = length;
+            if (m_input.size() > MAX_HTTP_RESPONSE_HEADER) {
+                return fail(ProxyOutcome::PROXY_FAILED, "Proxy response header too large");
+            }
+            return Result::NEED_MORE;
+        }
+        size_t headerEnd = end + 4;
+        consumed = length - (m_input.size() - headerEnd);
+
+        int status = 0;
+        if (m_input.compare(0, 5, "HTTP/") == 0) {
+            size_t space = m_input.find(' ');
+            if (space != std::string::npos && space + 4 <= m_input.size()) {
+                status = std::atoi(m_input.c_str() + space + 1);
+            }
+        }
+        std::string statusLine = m_input.substr(0, m_input.find("\r\n"));
+        m_input.clear();
+        if (status >= 200 && status < 300) {
+            m_stage = Stage::FINISHED;
+            m_outcome = ProxyOutcome::ESTABLISHED;
+            return Result::DONE;
+        }
+        if (status == 0 || status == 400 || status == 405 || status == 407 || status == 501) {
+            return fail(ProxyOutcome::PROXY_FAILED, status == 0 ? "Malformed proxy response" : statusLine);
+        }
+        return fail(ProxyOutcome::TARGET_FAILED, statusLine);
+    }
+
+    while (true) {
+        // 各阶段应答的长度: 问候/认证2字节，CONNECT应答取决于绑定地址类型
+        size_t needed = 2;
+        if (m_stage == Stage::CONNECT) {
+            needed = 5;
+            if (m_input.size() >= 5) {
+                switch (static_cast<uint8_t>(m_input[3])) {
+                    case 0x01: needed = 4 + 4 + 2; break;
+                    case 0x04: needed = 4 + 16 + 2; break;
+                    case 0x03: needed = 4 + 1 + static_cast<uint8_t>(m_input[4]) + 2; break;
+                    default:
+                        // 失败应答可能不带合法地址，按应答码处理
+                        needed = m_input[1] != 0 ? 5 : 0;
+                        break;
+                }
+            }
+        }
+        if (needed == 0) {
+            return fail(ProxyOutcome::PROXY_FAILED, "Invalid SOCKS5 address type");
+        }
+        if (m_input.size() < needed) {
+            size_t take = std::min(needed - m_input.size(), length - consumed);
+            m_input.append(data + consumed, take);
+            consumed += take;
+            if (m_input.size() < needed) {
+                return Result::NEED_MORE;
+            }
+            if (m_stage == Stage::CONNECT && needed == 5) {
+                // 读到地址类型后重新计算完整长度
+                continue;
+            }
+        }
+
+        const uint8_t version = static_cast<uint8_t>(m_input[0]);
+        const uint8_t code = static_cast<uint8_t>(m_input[1]);
+        if (m_stage == Stage::GREETING) {
+            m_input.clear();
+            if (version != 0x05) {
+                return fail(ProxyOutcome::PROXY_FAILED, "Not a SOCKS5 proxy");
+            }
+            if (code == 0x00) {
+                queueSocksConnect();
+            } else if (code == 0x02 && !m_proxy.username.empty()) {
+                m_stage = Stage::AUTH;
+                m_output += '\x01';
+                m_output += static_cast<char>(m_proxy.username.size());
+                m_output += m_proxy.username;
+                m_output += static_cast<char>(m_proxy.password.size());
+                m_output += m_proxy.password;
+            } else {
+                return fail(ProxyOutcome::PROXY_FAILED, "No acceptable SOCKS5 authentication method");
+            }
+            return Result::NEED_MORE;
+        }
+        if (m_stage == Stage::AUTH) {
+            m_input.clear();
+            if (code != 0x00) {
+                return fail(ProxyOutcome::PROXY_FAILED, "SOCKS5 authentication failed");
+            }
+            queueSocksConnect();
+            return Result::NEED_MORE;
+        }
+
+        // CONNECT应答
+        m_input.clear();
+        if (version != 0x05) {
+            return fail(ProxyOutcome::PROXY_FAILED, "Malformed SOCKS5 reply");
+        }
+        if (code == 0x00) {
+            m_stage = Stage::FINISHED;
+            m_outcome = ProxyOutcome::ESTABLISHED;
+            return Result::DONE;
+        }
+        bool proxyFault = code == 0x02 || code == 0x07 || code == 0x08;
+        return fail(proxyFault ? ProxyOutcome::PROXY_FAILED : ProxyOutcome::TARGET_FAILED,
+                    "SOCKS5 " + socksReplyName(code));
+    }
+}
+
+// ProxyPool
+
+ProxyPool::ProxyPool(std::vector<ProxyEndpoint> proxies, size_t perProxyLimit)
+    : m_perProxyLimit(std::max<size_t>(1, perProxyLimit)) {
+    m_proxies.reserve(proxies.size());
+    for (auto& endpoint : proxies) {
+        Proxy proxy;
+        proxy.endpoint = std::move(endpoint);
+        m_proxies.push_back(std::move(proxy));
+    }
+}
+
+size_t ProxyPool::limitOf(Proxy& proxy, Clock::time_point now) {
+    if (proxy.state == State::DOWN && now >= proxy.downUntil) {
+        proxy.state = State::PROBING;
+    }
+    switch (proxy.state) {
+        case State::UP: return m_perProxyLimit;
+        case State::PROBING: return 1;
+        default: return 0;
+    }
+}
+
+int ProxyPool::acquire(int avoid) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = Clock::now();
+
+    // 负载按 在途数/上限 比较，从上次选中的下一个开始遍历，负载相同时轮转
+    int best = -1;
+    double bestLoad = 0;
+    bool othersUsable = false;
+    for (size_t i = 0; i < m_proxies.size(); ++i) {
+        size_t index = (m_next + i) % m_proxies.size();
+        Proxy& proxy = m_proxies[index];
+        size_t limit = limitOf(proxy, now);
+        if (static_cast<int>(index) != avoid && limit > 0) {
+            othersUsable = true;
+        }
+        if (proxy.inFlight >= limit || static_cast<int>(index) == avoid) {
+            continue;
+        }
+        double load = static_cast<double>(proxy.inFlight) / static_cast<double>(limit);
+        if (best < 0 || load < bestLoad) {
+            best = static_cast<int>(index);
+            bestLoad = load;
+        }
+    }
+    if (best < 0 && avoid >= 0 && static_cast<size_t>(avoid) < m_proxies.size() && !othersUsable &&
+        m_proxies[avoid].inFlight < limitOf(m_proxies[avoid], now)) {
+        best = avoid;
+    }
+    if (best < 0) {
+        return -1;
+    }
+
+    Proxy& proxy = m_proxies[best];
+    ++proxy.inFlight;
+    proxy.peakInFlight = std::max(proxy.peakInFlight, proxy.inFlight);
+    m_next = (static_cast<size_t>(best) + 1) % m_proxies.size();
+    return best;
+}
+
+void ProxyPool::release(int index, ProxyOutcome outcome) {
+    if (index < 0 || static_cast<size_t>(index) >= m_proxies.size()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Proxy& proxy = m_proxies[index];
+    if (proxy.inFlight > 0) {
+        --proxy.inFlight;
+    }
+
+    if (outcome != ProxyOutcome::PROXY_FAILED) {
+        if (outcome == ProxyOutcome::ESTABLISHED) {
+            ++proxy.established;
+        } else {
+            ++proxy.targetFailures;
+        }
+        proxy.consecutiveFailures = 0;
+        if (proxy.state == State::PROBING) {
+            proxy.state = State::UP;
+            proxy.downCycles = 0;
+            proxy.cooldown = std::chrono::milliseconds(0);
+        }
+        return;
+    }
+
+    ++proxy.proxyFailures;
+    ++proxy.consecutiveFailures;
+    if (proxy.state == State::DEAD || proxy.state == State::DOWN) {
+        return;
+    }
+    if (proxy.state == State::UP && proxy.consecutiveFailures < PROXY_FAILED_THRESHOLD) {
+        return;
+    }
+
+    // 停用: 试探失败时冷却加倍
+    ++proxy.downCycles;
+    if (proxy.downCycles >= MAX_DOWN_CYCLES) {
+        proxy.state = State::DEAD;
+        return;
+    }
+    proxy.cooldown = proxy.cooldown.count() == 0 ? BASE_COOLDOWN : std::min(MAX_COOLDOWN, proxy.cooldown * 2);
+    proxy.state = State::DOWN;
+    proxy.downUntil = Clock::now() + proxy.cooldown;
+}
+
+void ProxyPool::cancel(int index) {
+    if (index < 0 || static_cast<size_t>(index) >= m_proxies.size()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Proxy& proxy = m_proxies[index];
+    if (proxy.inFlight > 0) {
+        --proxy.inFlight;
+    }
+}
+
+bool ProxyPool::exhausted() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::all_of(m_proxies.begin(), m_proxies.end(),
+                       [](const Proxy& proxy) { return proxy.state == State::DEAD; });
+}
+
+size_t ProxyPool::capacity() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t total = 0;
+    for (const auto& proxy : m_proxies) {
+        if (proxy.state != State::DEAD) {
+            total += m_perProxyLimit;
+        }
+    }
+    return total;
+}
+
+std::vector<ProxyStats> ProxyPool::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<ProxyStats> stats;
+    for (const auto& proxy : m_proxies) {
+        ProxyStats entry;
+        entry.endpoint = proxy.endpoint.toString();
+        switch (proxy.state) {
+            case State::UP: entry.state = "up"; break;
+            case State::DOWN: entry.state = "down"; break;
+            case State::PROBING: entry.state = "probing"; break;
+            case State::DEAD: entry.state = "dead"; break;
+        }
+        entry.inFlight = proxy.inFlight;
+        entry.peakInFlight = proxy.peakInFlight;
+        entry.established = proxy.established;
+        entry.targetFailures = proxy.targetFailures;
+        entry.proxyFailures = proxy.proxyFailures;
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+// 阻塞隧道
+
+ProxyConnection connectThroughProxy(ProxyPool& pool, const IPAddress& target, uint16_t port,
+                                    std::chrono::milliseconds timeout) {
+    ProxyConnection connection;
+    connection.error = "No proxy available";
+
+    // 每个代理最多尝试一次; 所有代理都停用或满载时等待名额直到超时
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    int last = -1;
+    for (size_t attempt = 0; attempt < pool.size();) {
+        int index = pool.acquire(last);
+        if (index < 0) {
+            if (pool.exhausted() || std::chrono::steady_clock::now() >= deadline) {
+                return connection;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        ++attempt;
+        last = index;
+
+        const ProxyEndpoint& proxy = pool.endpoint(static_cast<size_t>(index));
+        connection.proxy = proxy.toString();
+
+        SocketBudget::Slot slot(timeout);
+        auto sock = std::make_unique<Socket>(proxy.address.isIPv6 ? AF_INET6 : AF_INET, SOCK_STREAM);
+        if (!slot.acquired() || !sock->isValid() || !sock->connect(proxy.address, proxy.port, timeout)) {
+            pool.release(index, ProxyOutcome::PROXY_FAILED);
+            connection.outcome = ProxyOutcome::PROXY_FAILED;
+            connection.error = "Cannot connect to proxy " + connection.proxy;
+            continue;
+        }
+        sock->setReceiveTimeout(timeout);
+
+        ProxyHandshake handshake(proxy, target, port);
+        ProxyHandshake::Result result = ProxyHandshake::Result::NEED_MORE;
+        char buffer[1024];
+        while (result == ProxyHandshake::Result::NEED_MORE) {
+            const std::string& output = handshake.pendingOutput();
+            if (!output.empty()) {
+                auto sent = sock->send(output.data(), output.size());
+                if (sent <= 0) {
+                    break;
+                }
+                handshake.consumeOutput(static_cast<size_t>(sent));
+                continue;
+            }
+            auto received = sock->receive(buffer, sizeof(buffer));
+            if (received <= 0) {
+                break;
+            }
+            size_t consumed = 0;
+            result = handshake.feed(buffer, static_cast<size_t>(received), consumed);
+            if (result == ProxyHandshake::Result::DONE) {
+                connection.initialData.assign(buffer + consumed, static_cast<size_t>(received) - consumed);
+            }
+        }
+
+        ProxyOutcome outcome;
+        if (result == ProxyHandshake::Result::NEED_MORE) {
+            outcome = handshake.timeoutOutcome();
+            connection.error = "Proxy handshake timed out";
+        } else {
+            outcome = handshake.outcome();
+            connection.error = handshake.error();
+        }
+        pool.release(index, outcome);
+        connection.outcome = outcome;
+        if (outcome == ProxyOutcome::ESTABLISHED) {
+            connection.error.clear();
+            connection.socket = std::move(sock);
+            return connection;
+        }
+        if (outcome == ProxyOutcome::TARGET_FAILED) {
+            return connection;
+        }
+    }
+    return connection;
+}
+
+} // namespace MindSploit::Utils
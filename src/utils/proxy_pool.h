@@ -0,0 +1,173 @@
+#pragma once
+
+#include "network_utils.h"
+#include <memory>
+#include <mutex>
+
+namespace MindSploit::Utils {
+
+// 上游代理
+struct ProxyEndpoint {
+    enum class Type {
+        SOCKS5,
+        HTTP_CONNECT
+    };
+
+    Type type = Type::SOCKS5;
+    IPAddress address;
+    uint16_t port = 0;
+    std::string username;
+    std::string password;
+
+    std::string toString() const;
+};
+
+// 解析代理列表: 逗号分隔的 socks5://[user:pass@]host:port 或 http://[user:pass@]host:port
+// 不带协议前缀时按SOCKS5处理，主机名在解析时转换为地址
+bool parseProxyList(const std::string& text, std::vector<ProxyEndpoint>& proxies, std::string& error);
+
+// 隧道建立结果
+enum class ProxyOutcome {
+    ESTABLISHED,
+    TARGET_FAILED,      // 代理正常应答，但目标不可达/拒绝 (端口关闭)
+    PROXY_FAILED        // 代理本身不可用: 连接失败、协议错误、认证失败
+};
+
+// 非阻塞的代理握手状态机，只处理字节，不接触套接字:
+// 调用方发送pendingOutput()，把收到的数据交给feed()，直到返回DONE或失败
+//
+// SOCKS5应答中的03-06 (网络/主机不可达、拒绝、TTL超时) 和01 (许多实现以此表示拒绝) 归为目标失败;
+// 02/07/08 (规则禁止、命令或地址类型不支持) 说明代理无法承担扫描，归为代理失败。
+// HTTP CONNECT的2xx为成功，400/405/407/501为代理失败，其余状态 (502/503/504等) 为目标失败。
+class ProxyHandshake {
+public:
+    enum class Result {
+        NEED_MORE,
+        DONE,
+        FAILED
+    };
+
+    ProxyHandshake(const ProxyEndpoint& proxy, const IPAddress& target, uint16_t port);
+
+    // 待发送的数据，调用方发送后调用consumeOutput
+    const std::string& pendingOutput() const { return m_output; }
+    void consumeOutput(size_t length) { m_output.erase(0, length); }
+
+    // consumed: 本次消费的字节数; DONE时剩余数据属于目标 (例如紧跟应答的服务横幅)
+    Result feed(const char* data, size_t length, size_t& consumed);
+
+    ProxyOutcome outcome() const { return m_outcome; }
+    const std::string& error() const { return m_error; }
+    // 超时时的归类: SOCKS5已应答问候或HTTP代理已接受连接时视为目标无应答
+    ProxyOutcome timeoutOutcome() const;
+
+private:
+    enum class Stage {
+        GREETING,           // SOCKS5: 等待方法选择
+        AUTH,               // SOCKS5: 等待用户名/密码认证结果
+        CONNECT,            // SOCKS5: 等待CONNECT应答
+        HTTP_RESPONSE,      // HTTP: 等待响应头
+        FINISHED
+    };
+
+    void queueSocksConnect();
+    Result fail(ProxyOutcome outcome, const std::string& error);
+
+private:
+    ProxyEndpoint m_proxy;
+    IPAddress m_target;
+    uint16_t m_port;
+    Stage m_stage;
+    std::string m_output;
+    std::string m_input;
+    ProxyOutcome m_outcome = ProxyOutcome::PROXY_FAILED;
+    std::string m_error;
+};
+
+// 代理统计
+struct ProxyStats {
+    std::string endpoint;
+    std::string state;              // up / down / probing / dead
+    size_t inFlight = 0;
+    size_t peakInFlight = 0;
+    uint64_t established = 0;
+    uint64_t targetFailures = 0;
+    uint64_t proxyFailures = 0;
+};
+
+// 上游代理池
+//
+// - 每个代理有独立的并发上限，acquire选择 在途数/上限 最小的可用代理
+// - 连续PROXY_FAILED_THRESHOLD次代理失败后停用，冷却后进入试探状态只放行一个连接，
+//   试探成功恢复，失败则冷却时间加倍; 连续MAX_DOWN_CYCLES轮都失败的代理永久停用
+// - 目标失败说明代理工作正常，不影响健康状态
+class ProxyPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t PROXY_FAILED_THRESHOLD = 3;
+    static constexpr size_t MAX_DOWN_CYCLES = 3;
+
+    ProxyPool(std::vector<ProxyEndpoint> proxies, size_t perProxyLimit);
+
+    size_t size() const { return m_proxies.size(); }
+    const ProxyEndpoint& endpoint(size_t index) const { return m_proxies[index].endpoint; }
+
+    // 获取一个代理名额，没有可用名额时返回-1
+    // avoid: 重试时避开的代理，只有在其它代理都已停用时才会再选中它
+    int acquire(int avoid = -1);
+    void release(int index, ProxyOutcome outcome);
+    // 归还未使用的名额 (例如本地套接字预算不足)，不计入健康统计
+    void cancel(int index);
+
+    // 所有代理都已永久停用
+    bool exhausted() const;
+    // 当前未停用代理的并发上限之和
+    size_t capacity() const;
+
+    std::vector<ProxyStats> getStats() const;
+
+private:
+    enum class State {
+        UP,
+        DOWN,
+        PROBING,
+        DEAD
+    };
+
+    struct Proxy {
+        ProxyEndpoint endpoint;
+        State state = State::UP;
+        Clock::time_point downUntil;
+        std::chrono::milliseconds cooldown{0};
+        size_t consecutiveFailures = 0;
+        size_t downCycles = 0;
+        size_t inFlight = 0;
+        size_t peakInFlight = 0;
+        uint64_t established = 0;
+        uint64_t targetFailures = 0;
+        uint64_t proxyFailures = 0;
+    };
+
+    size_t limitOf(Proxy& proxy, Clock::time_point now);
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<Proxy> m_proxies;
+    size_t m_perProxyLimit;
+    size_t m_next = 0;
+};
+
+// 阻塞方式经代理池建立隧道 (代理失败时换一个代理重试)
+struct ProxyConnection {
+    std::unique_ptr<Socket> socket;     // 隧道建立时有效
+    ProxyOutcome outcome = ProxyOutcome::PROXY_FAILED;
+    std::string proxy;
+    std::string error;
+    std::string initialData;            // 紧跟代理应答到达的目标数据
+};
+
+ProxyConnection connectThroughProxy(ProxyPool& pool, const IPAddress& target, uint16_t port,
+                                    std::chrono::milliseconds timeout);
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,304 @@
+#include "socket_budget.h"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+namespace MindSploit::Utils {
+
+namespace {
+
+// 为系统其它连接保留1/8的临时端口
+constexpr size_t PORT_HEADROOM_DIVISOR = 8;
+
+#ifdef _WIN32
+// Windows套接字不受fd表限制，默认动态端口范围为49152-65535
+constexpr size_t WINDOWS_SOCKET_LIMIT = 65536;
+constexpr uint16_t WINDOWS_EPHEMERAL_FIRST = 49152;
+#endif
+
+bool isAddressExhaustion(int errorCode) {
+#ifdef _WIN32
+    return errorCode == WSAEADDRNOTAVAIL || errorCode == WSAENOBUFS;
+#else
+    return errorCode == EADDRNOTAVAIL || errorCode == ENOBUFS;
+#endif
+}
+
+bool isDescriptorExhaustion(int errorCode) {
+#ifdef _WIN32
+    return errorCode == WSAEMFILE;
+#else
+    return errorCode == EMFILE || errorCode == ENFILE;
+#endif
+}
+
+} // namespace
+
+SocketBudget& SocketBudget::instance() {
+    static SocketBudget budget;
+    return budget;
+}
+
+SocketBudget::SocketBudget() {
+    m_portsPerSource = readEphemeralPortCount();
+    raiseFileLimit();
+}
+
+void SocketBudget::configure(const SocketBudgetConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    recalculate();
+    m_window = m_ceiling;
+    m_successStreak = 0;
+    m_available.notify_all();
+}
+
+SocketBudgetConfig SocketBudget::getConfig() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+size_t SocketBudget::raiseFileLimit() {
+    size_t limit = 0;
+
+#ifdef _WIN32
+    limit = WINDOWS_SOCKET_LIMIT;
+#else
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        if (rl.rlim_cur < rl.rlim_max) {
+            rlim_t previous = rl.rlim_cur;
+            rl.rlim_cur = rl.rlim_max;
+            if (setrlimit(RLIMIT_NOFILE, &rl) != 0) {
+                rl.rlim_cur = previous;
+            }
+        }
+        limit = (rl.rlim_cur == RLIM_INFINITY) ? SIZE_MAX : static_cast<size_t>(rl.rlim_cur);
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fileLimit = limit;
+    recalculate();
+    if (m_window == 0 || m_window > m_ceiling) {
+        m_window = m_ceiling;
+    }
+    return limit;
+}
+
+void SocketBudget::recalculate() {
+    size_t fdBudget = m_fileLimit > m_config.fdReserve ? m_fileLimit - m_config.fdReserve : 1;
+
+    size_t sources = std::max<size_t>(1, m_config.sourceAddresses.size());
+    size_t usablePorts = m_portsPerSource - m_portsPerSource / PORT_HEADROOM_DIVISOR;
+    size_t portBudget = std::max<size_t>(1, usablePorts * sources);
+
+    m_ceiling = std::min(fdBudget, portBudget);
+    if (m_config.maxInFlight > 0) {
+        m_ceiling = std::min(m_ceiling, m_config.maxInFlight);
+    }
+    m_ceiling = std::max<size_t>(1, m_ceiling);
+}
+
+PortRange SocketBudget::ephemeralPortRange() {
+#ifdef _WIN32
+    return PortRange(WINDOWS_EPHEMERAL_FIRST, 65535);
+#else
+    std::ifstream file("/proc/sys/net/ipv4/ip_local_port_range");
+    unsigned long low = 0, high = 0;
+    if (file >> low >> high && low > 0 && high >= low && high <= 65535) {
+        return PortRange(static_cast<uint16_t>(low), static_cast<uint16_t>(high));
+    }
+    return PortRange(32768, 60999); // Linux默认
+#endif
+}
+
+size_t SocketBudget::readEphemeralPortCount() {
+    PortRange range = ephemeralPortRange();
+    return static_cast<size_t>(range.end - range.start) + 1;
+}
+
+bool SocketBudget::acquire(std::chrono::milliseconds wait) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool ready = m_available.wait_for(lock, wait, [this] { return m_inFlight < m_window; });
+    if (!ready) {
+        return false;
+    }
+
+    ++m_inFlight;
+    m_peakInFlight = std::max(m_peakInFlight, m_inFlight);
+    return true;
+}
+
+void SocketBudget::release() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_inFlight > 0) {
+            --m_inFlight;
+        }
+    }
+    m_available.notify_one();
+}
+
+int SocketBudget::openProbeSocket(const IPAddress& target) {
+    int sock = static_cast<int>(socket(target.isIPv6 ? AF_INET6 : AF_INET, SOCK_STREAM, 0));
+    if (sock < 0) {
+        reportError(errno);
+        return -1;
+    }
+
+    // 非阻塞模式
+#ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+#endif
+
+    // close()时直接发送RST，本地端口立即可复用
+    bool resetOnClose;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        resetOnClose = m_config.resetOnClose;
+    }
+    if (resetOnClose) {
+        struct linger lg;
+        lg.l_onoff = 1;
+        lg.l_linger = 0;
+        setsockopt(sock, SOL_SOCKET, SO_LINGER, (const char*)&lg, sizeof(lg));
+    }
+
+    if (!bindSource(sock, target)) {
+        int error = errno;
+        closeProbeSocket(sock);
+        reportError(error);
+        return -1;
+    }
+
+    ++m_opened;
+    return sock;
+}
+
+bool SocketBudget::bindSource(int sock, const IPAddress& target) {
+    IPAddress source;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto& sources = m_config.sourceAddresses;
+        if (sources.empty()) {
+            return true;
+        }
+
+        // 从轮转位置开始找同地址族的源地址
+        size_t start = m_nextSource++;
+        for (size_t i = 0; i < sources.size(); ++i) {
+            const auto& candidate = sources[(start + i) % sources.size()];
+            if (candidate.isIPv6 == target.isIPv6) {
+                source = candidate;
+                break;
+            }
+        }
+    }
+    if (source.address.empty()) {
+        return true;
+    }
+
+#ifdef IP_BIND_ADDRESS_NO_PORT
+    // 绑定时不占用端口，由connect根据完整四元组选择，同一端口可服务不同目标
+    int on = 1;
+    setsockopt(sock, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &on, sizeof(on));
+#endif
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len;
+    memset(&addr, 0, sizeof(addr));
+    if (source.isIPv6) {
+        struct sockaddr_in6* addr6 = (struct sockaddr_in6*)&addr;
+        addr6->sin6_family = AF_INET6;
+        inet_pton(AF_INET6, source.address.c_str(), &addr6->sin6_addr);
+        addr_len = sizeof(*addr6);
+    } else {
+        struct sockaddr_in* addr4 = (struct sockaddr_in*)&addr;
+        addr4->sin_family = AF_INET;
+        inet_pton(AF_INET, source.address.c_str(), &addr4->sin_addr);
+        addr_len = sizeof(*addr4);
+    }
+
+    return ::bind(sock, (struct sockaddr*)&addr, addr_len) == 0;
+}
+
+void SocketBudget::closeProbeSocket(int sock) {
+    if (sock < 0) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+void SocketBudget::reportSuccess() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_window >= m_ceiling) {
+        return;
+    }
+
+    // 加性增长: 每完成一个窗口的连接，窗口+1
+    if (++m_successStreak >= m_window) {
+        ++m_window;
+        m_successStreak = 0;
+        m_available.notify_one();
+    }
+}
+
+void SocketBudget::reportError(int errorCode) {
+    bool addressExhausted = isAddressExhaustion(errorCode);
+    bool fdExhausted = isDescriptorExhaustion(errorCode);
+    if (!addressExhausted && !fdExhausted) {
+        // 拒绝、不可达等错误说明连接已正常结束，按成功计入窗口
+        reportSuccess();
+        return;
+    }
+
+    if (addressExhausted) {
+        ++m_addressExhausted;
+    } else {
+        ++m_fdExhausted;
+    }
+
+    // 乘性减小: 资源耗尽时窗口减半，并收紧到当前在途数以下
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t reduced = std::max<size_t>(1, std::min(m_window, m_inFlight) / 2);
+    m_window = std::min(m_window, reduced);
+    m_successStreak = 0;
+}
+
+bool SocketBudget::isExhaustion(int errorCode) {
+    return isAddressExhaustion(errorCode) || isDescriptorExhaustion(errorCode);
+}
+
+SocketBudgetStats SocketBudget::getStats() const {
+    SocketBudgetStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.fileLimit = m_fileLimit;
+        stats.portsPerSource = m_portsPerSource;
+        stats.ceiling = m_ceiling;
+        stats.window = m_window;
+        stats.inFlight = m_inFlight;
+        stats.peakInFlight = m_peakInFlight;
+    }
+    stats.opened = m_opened;
+    stats.addressExhausted = m_addressExhausted;
+    stats.fdExhausted = m_fdExhausted;
+    return stats;
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "network_utils.h"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace MindSploit::Utils {
+
+// 连接预算配置
+struct SocketBudgetConfig {
+    size_t maxInFlight = 0;                 // 在途连接上限 (0表示按fd和端口预算自动计算)
+    size_t fdReserve = 64;                  // 为程序其它部分保留的文件描述符
+    std::vector<IPAddress> sourceAddresses; // 轮转使用的本地源地址 (为空则由内核选择)
+    bool resetOnClose = true;               // 以RST关闭探测连接，避免TIME_WAIT
+};
+
+// 预算统计
+struct SocketBudgetStats {
+    size_t fileLimit = 0;           // 当前RLIMIT_NOFILE软限制
+    size_t portsPerSource = 0;      // 每个源地址可用的临时端口数
+    size_t ceiling = 0;             // 硬上限
+    size_t window = 0;              // 当前自适应窗口
+    size_t inFlight = 0;            // 在途连接数
+    size_t peakInFlight = 0;        // 在途峰值
+    uint64_t opened = 0;            // 已创建的探测套接字
+    uint64_t addressExhausted = 0;  // EADDRNOTAVAIL次数
+    uint64_t fdExhausted = 0;       // EMFILE/ENFILE次数
+};
+
+// 连接扫描的文件描述符与临时端口预算管理器
+//
+// - 启动时把RLIMIT_NOFILE软限制提升到硬限制，并扣除保留量作为fd预算
+// - 读取临时端口范围，按源地址数计算不会触发EADDRNOTAVAIL的在途上限
+// - 探测套接字设置SO_LINGER{1,0}，关闭时发送RST而不是进入TIME_WAIT
+// - 多个源地址轮转绑定，并使用IP_BIND_ADDRESS_NO_PORT推迟端口分配到connect
+// - 在途窗口按AIMD调整: 成功时线性增长，端口/fd耗尽时减半
+class SocketBudget {
+public:
+    static SocketBudget& instance();
+
+    void configure(const SocketBudgetConfig& config);
+    SocketBudgetConfig getConfig() const;
+
+    // 提升fd软限制，返回提升后的限制
+    size_t raiseFileLimit();
+
+    // 获取一个在途连接名额，超时或预算为0时返回false
+    bool acquire(std::chrono::milliseconds wait = std::chrono::milliseconds(5000));
+    void release();
+
+    // 创建非阻塞探测套接字 (已绑定轮转源地址)，失败返回-1
+    int openProbeSocket(const IPAddress& target);
+    void closeProbeSocket(int sock);
+
+    // 连接结果反馈，用于调整自适应窗口
+    void reportSuccess();
+    void reportError(int errorCode);
+    // 临时端口或fd耗尽的错误 (稍后重试即可，不代表目标状态)
+    static bool isExhaustion(int errorCode);
+    // 内核分配临时端口的范围 (Linux: net.ipv4.ip_local_port_range)
+    static PortRange ephemeralPortRange();
+
+    SocketBudgetStats getStats() const;
+
+    // 作用域内持有一个名额
+    class Slot {
+    public:
+        explicit Slot(std::chrono::milliseconds wait = std::chrono::milliseconds(5000))
+            : m_acquired(SocketBudget::instance().acquire(wait)) {}
+        ~Slot() { if (m_acquired) SocketBudget::instance().release(); }
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        bool acquired() const { return m_acquired; }
+    private:
+        bool m_acquired;
+    };
+
+private:
+    SocketBudget();
+    SocketBudget(const SocketBudget&) = delete;
+    SocketBudget& operator=(const SocketBudget&) = delete;
+
+    void recalculate();
+    static size_t readEphemeralPortCount();
+    bool bindSource(int sock, const IPAddress& target);
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_available;
+    SocketBudgetConfig m_config;
+
+    size_t m_fileLimit = 0;
+    size_t m_portsPerSource = 0;
+    size_t m_ceiling = 0;
+    size_t m_window = 0;
+    size_t m_inFlight = 0;
+    size_t m_peakInFlight = 0;
+    size_t m_successStreak = 0;
+
+    std::atomic<size_t> m_nextSource{0};
+    std::atomic<uint64_t> m_opened{0};
+    std::atomic<uint64_t> m_addressExhausted{0};
+    std::atomic<uint64_t> m_fdExhausted{0};
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,357 @@
+#include "target_space.h"
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
+namespace MindSploit::Utils {
+
+namespace {
+
+// splitmix64，用于从种子派生本原元和起点
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+bool parseIPv4(const std::string& text, uint32_t& address) {
+    struct in_addr addr;
+    if (inet_pton(AF_INET, text.c_str(), &addr) != 1) {
+        return false;
+    }
+    address = ntohl(addr.s_addr);
+    return true;
+}
+
+std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(start, end - start + 1);
+}
+
+} // namespace
+
+bool ShardSpec::parse(const std::string& text, ShardSpec& shard) {
+    size_t slashPos = text.find('/');
+    if (slashPos == std::string::npos) {
+        return false;
+    }
+
+    try {
+        size_t consumed = 0;
+        unsigned long index = std::stoul(text.substr(0, slashPos), &consumed);
+        if (consumed != slashPos) return false;
+        std::string countText = text.substr(slashPos + 1);
+        unsigned long count = std::stoul(countText, &consumed);
+        if (consumed != countText.size()) return false;
+
+        if (count == 0 || index >= count || count > UINT32_MAX) {
+            return false;
+        }
+        shard.index = static_cast<uint32_t>(index);
+        shard.count = static_cast<uint32_t>(count);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool TargetSpace::addTargets(const std::string& spec) {
+    std::stringstream ss(spec);
+    std::string item;
+    bool added = false;
+
+    while (std::getline(ss, item, ',')) {
+        item = trim(item);
+        if (item.empty()) continue;
+        if (!addSingleSpec(item)) {
+            return false;
+        }
+        added = true;
+    }
+
+    return added;
+}
+
+bool TargetSpace::addSingleSpec(const std::string& spec) {
+    // CIDR格式
+    size_t slashPos = spec.find('/');
+    if (slashPos != std::string::npos) {
+        uint32_t base;
+        if (!parseIPv4(spec.substr(0, slashPos), base)) {
+            return false;
+        }
+        int prefixLength;
+        try {
+            prefixLength = std::stoi(spec.substr(slashPos + 1));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (prefixLength < 0 || prefixLength > 32) {
+            return false;
+        }
+
+        uint64_t count = 1ULL << (32 - prefixLength);
+        uint32_t mask = prefixLength == 0 ? 0 : (0xFFFFFFFFu << (32 - prefixLength));
+        addIPv4Range(base & mask, count);
+        return true;
+    }
+
+    // 范围格式: 192.168.1.1-192.168.1.10 或 192.168.1.1-10
+    // 横线前不是IPv4地址时按主机名解析 (如 my-host.example.com)
+    size_t dashPos = spec.find('-');
+    uint32_t start;
+    if (dashPos != std::string::npos && parseIPv4(spec.substr(0, dashPos), start)) {
+        uint32_t end;
+        std::string endText = spec.substr(dashPos + 1);
+        if (endText.find('.') == std::string::npos) {
+            int lastOctet;
+            try {
+                lastOctet = std::stoi(endText);
+            } catch (const std::exception&) {
+                return false;
+            }
+            if (lastOctet < 0 || lastOctet > 255) {
+                return false;
+            }
+            end = (start & 0xFFFFFF00u) | static_cast<uint32_t>(lastOctet);
+        } else if (!parseIPv4(endText, end)) {
+            return false;
+        }
+        if (end < start) {
+            return false;
+        }
+        addIPv4Range(start, static_cast<uint64_t>(end) - start + 1);
+        return true;
+    }
+
+    // 单个地址或主机名
+    IPAddress ip = NetworkUtils::resolveHostname(spec);
+    if (ip.address.empty()) {
+        return false;
+    }
+    if (ip.isIPv6) {
+        Range range;
+        range.offset = m_hostCount;
+        range.count = 1;
+        range.ipv6 = ip.address;
+        m_ranges.push_back(range);
+        m_hostCount += 1;
+        return true;
+    }
+
+    uint32_t address;
+    if (!parseIPv4(ip.address, address)) {
+        return false;
+    }
+    addIPv4Range(address, 1);
+    return true;
+}
+
+void TargetSpace::addIPv4Range(uint32_t start, uint64_t count) {
+    Range range;
+    range.offset = m_hostCount;
+    range.count = count;
+    range.ipv4Start = start;
+    m_ranges.push_back(range);
+    m_hostCount += count;
+}
+
+IPAddress TargetSpace::hostAt(uint64_t hostIndex) const {
+    // 按起点二分查找所在地址段
+    auto it = std::upper_bound(m_ranges.begin(), m_ranges.end(), hostIndex,
+                               [](uint64_t value, const Range& range) { return value < range.offset; });
+    if (it == m_ranges.begin()) {
+        return IPAddress();
+    }
+    const Range& range = *(it - 1);
+    if (hostIndex - range.offset >= range.count) {
+        return IPAddress();
+    }
+    if (!range.ipv6.empty()) {
+        return IPAddress(range.ipv6);
+    }
+
+    struct in_addr addr;
+    addr.s_addr = htonl(range.ipv4Start + static_cast<uint32_t>(hostIndex - range.offset));
+    char buffer[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr, buffer, sizeof(buffer));
+    return IPAddress(buffer);
+}
+
+int TargetSpace::portAt(uint64_t index) const {
+    if (m_ports.empty()) {
+        return 0;
+    }
+    return m_ports[index % m_ports.size()];
+}
+
+bool TargetSpace::containsHost(const IPAddress& address) const {
+    if (address.isIPv6) {
+        return std::any_of(m_ranges.begin(), m_ranges.end(),
+                           [&](const Range& range) { return range.ipv6 == address.address; });
+    }
+
+    uint32_t value;
+    if (!parseIPv4(address.address, value)) {
+        return false;
+    }
+    return std::any_of(m_ranges.begin(), m_ranges.end(), [&](const Range& range) {
+        return range.ipv6.empty() && value >= range.ipv4Start &&
+               static_cast<uint64_t>(value - range.ipv4Start) < range.count;
+    });
+}
+
+bool TargetSpace::containsPort(int port) const {
+    return std::find(m_ports.begin(), m_ports.end(), port) != m_ports.end();
+}
+
+TargetPermutation::TargetPermutation(uint64_t size, uint64_t seed)
+    : m_size(size), m_seed(seed) {
+    // 大于size的最小素数
+    m_prime = std::max<uint64_t>(size + 1, 2);
+    while (!isPrime(m_prime)) {
+        ++m_prime;
+    }
+
+    uint64_t state = seed;
+    uint64_t order = m_prime - 1;
+    if (m_prime > 3) {
+        // g是本原元当且仅当对p-1的每个素因子q都有 g^((p-1)/q) != 1
+        auto factors = primeFactors(order);
+        while (true) {
+            uint64_t candidate = 2 + splitMix64(state) % (m_prime - 3);
+            bool primitive = std::all_of(factors.begin(), factors.end(), [&](uint64_t q) {
+                return powMod(candidate, order / q, m_prime) != 1;
+            });
+            if (primitive) {
+                m_generator = candidate;
+                break;
+            }
+        }
+    } else {
+        m_generator = m_prime - 1;
+    }
+
+    m_start = 1 + splitMix64(state) % order;
+}
+
+TargetPermutation::Cursor TargetPermutation::shard(const ShardSpec& shard) const {
+    return Cursor(this, shard.index, cycleLength(), std::max<uint32_t>(1, shard.count));
+}
+
+TargetPermutation::Cursor TargetPermutation::block(uint64_t beginPosition, uint64_t endPosition) const {
+    return Cursor(this, beginPosition, std::min(endPosition, cycleLength()), 1);
+}
+
+uint64_t TargetPermutation::deriveSeed(const std::string& text) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+uint64_t TargetPermutation::elementAt(uint64_t position) const {
+    return mulMod(m_start, powMod(m_generator, position, m_prime), m_prime);
+}
+
+TargetPermutation::Cursor::Cursor(const TargetPermutation* owner, uint64_t begin, uint64_t end, uint64_t stride)
+    : m_owner(owner),
+      m_value(owner->elementAt(begin)),
+      m_multiplier(powMod(owner->m_generator, stride, owner->m_prime)),
+      m_position(begin),
+      m_end(end),
+      m_stride(stride) {}
+
+bool TargetPermutation::Cursor::next(uint64_t& index) {
+    while (m_position < m_end) {
+        uint64_t element = m_value;
+        m_value = mulMod(m_value, m_multiplier, m_owner->m_prime);
+        m_position += m_stride;
+
+        // 群元素取值[1, p-1]，超出空间的部分直接跳过
+        if (element - 1 < m_owner->m_size) {
+            index = element - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t TargetPermutation::mulMod(uint64_t a, uint64_t b, uint64_t m) {
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) % m);
+#else
+    uint64_t result = 0;
+    a %= m;
+    while (b) {
+        if (b & 1) result = (result + a) % m;
+        a = (a << 1) % m;
+        b >>= 1;
+    }
+    return result;
+#endif
+}
+
+uint64_t TargetPermutation::powMod(uint64_t base, uint64_t exponent, uint64_t m) {
+    uint64_t result = 1 % m;
+    base %= m;
+    while (exponent) {
+        if (exponent & 1) result = mulMod(result, base, m);
+        base = mulMod(base, base, m);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+bool TargetPermutation::isPrime(uint64_t n) {
+    if (n < 2) return false;
+    for (uint64_t p : {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 19ULL, 23ULL, 29ULL, 31ULL, 37ULL}) {
+        if (n % p == 0) return n == p;
+    }
+
+    // 确定性Miller-Rabin (上述底数对64位整数足够)
+    uint64_t d = n - 1;
+    int r = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        ++r;
+    }
+    for (uint64_t a : {2ULL, 3ULL, 5ULL, 7ULL, 11ULL, 13ULL, 17ULL, 19ULL, 23ULL, 29ULL, 31ULL, 37ULL}) {
+        uint64_t x = powMod(a, d, n);
+        if (x == 1 || x == n - 1) continue;
+        bool composite = true;
+        for (int i = 1; i < r; ++i) {
+            x = mulMod(x, x, n);
+            if (x == n - 1) {
+                composite = false;
+                break;
+            }
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+std::vector<uint64_t> TargetPermutation::primeFactors(uint64_t n) {
+    std::vector<uint64_t> factors;
+    for (uint64_t q = 2; q * q <= n; q += (q == 2 ? 1 : 2)) {
+        if (n % q == 0) {
+            factors.push_back(q);
+            while (n % q == 0) n /= q;
+        }
+    }
+    if (n > 1) {
+        factors.push_back(n);
+    }
+    return factors;
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "network_utils.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace MindSploit::Utils {
+
+// 扫描分片描述 (i/n, 0 <= i < n)
+struct ShardSpec {
+    uint32_t index = 0;
+    uint32_t count = 1;
+
+    static bool parse(const std::string& text, ShardSpec& shard);
+    std::string toString() const { return std::to_string(index) + "/" + std::to_string(count); }
+};
+
+// 目标×端口索引空间
+// 目标以地址段形式保存，不展开成地址列表；索引 = 主机序号 * 端口数 + 端口序号
+class TargetSpace {
+public:
+    // 添加目标: 单个IP、CIDR、a.b.c.d-e.f.g.h 或 a.b.c.d-h，可用逗号分隔多个
+    bool addTargets(const std::string& spec);
+    // 端口列表为空时每个主机只占一个索引 (端口为0)，用于主机发现
+    void setPorts(const std::vector<int>& ports) { m_ports = ports; }
+
+    uint64_t hostCount() const { return m_hostCount; }
+    uint64_t size() const { return m_hostCount * portSlots(); }
+    bool empty() const { return size() == 0; }
+
+    IPAddress hostAt(uint64_t hostIndex) const;
+    uint64_t hostIndexOf(uint64_t index) const { return index / portSlots(); }
+    int portAt(uint64_t index) const;
+
+    // 成员判断 (用于筛选落在本次扫描范围内的历史结果)
+    bool containsHost(const IPAddress& address) const;
+    bool containsPort(int port) const;
+    const std::vector<int>& ports() const { return m_ports; }
+
+private:
+    struct Range {
+        uint64_t offset = 0;        // 在主机序号空间中的起点
+        uint64_t count = 0;
+        uint32_t ipv4Start = 0;     // IPv4段起始地址 (主机字节序)
+        std::string ipv6;           // IPv6目标只支持单个地址
+    };
+
+    uint64_t portSlots() const { return m_ports.empty() ? 1 : m_ports.size(); }
+    bool addSingleSpec(const std::string& spec);
+    void addIPv4Range(uint32_t start, uint64_t count);
+
+private:
+    std::vector<Range> m_ranges;
+    std::vector<int> m_ports;
+    uint64_t m_hostCount = 0;
+};
+
+// 基于乘法循环群的确定性伪随机排列
+//
+// 取大于空间大小N的最小素数p，以种子选出模p的本原元g，
+// 序列 x_k = x0 * g^k (mod p) 遍历 [1, p-1] 恰好一次，丢弃 x > N 的值后即为 [0, N) 的排列。
+// 相同(N, seed)在任何进程/机器上生成相同序列，因此:
+//   - 分片 i/n 取循环位置 k ≡ i (mod n)，各分片互不重叠且合起来覆盖全部
+//   - 工作块取连续位置区间 [begin, end)
+class TargetPermutation {
+public:
+    TargetPermutation(uint64_t size, uint64_t seed);
+
+    uint64_t size() const { return m_size; }
+    uint64_t cycleLength() const { return m_prime - 1; }
+    uint64_t seed() const { return m_seed; }
+
+    class Cursor {
+    public:
+        // 取下一个索引，遍历结束返回false
+        bool next(uint64_t& index);
+        uint64_t position() const { return m_position; }
+        uint64_t end() const { return m_end; }
+        // 提前结束位置 (只能缩短)，用于把剩余区间让给其它工作节点
+        void truncate(uint64_t endPosition) { m_end = std::min(m_end, endPosition); }
+
+    private:
+        friend class TargetPermutation;
+        Cursor(const TargetPermutation* owner, uint64_t begin, uint64_t end, uint64_t stride);
+
+        const TargetPermutation* m_owner;
+        uint64_t m_value;           // 当前群元素
+        uint64_t m_multiplier;      // g^stride
+        uint64_t m_position;        // 当前循环位置
+        uint64_t m_end;
+        uint64_t m_stride;
+    };
+
+    Cursor shard(const ShardSpec& shard) const;
+    Cursor block(uint64_t beginPosition, uint64_t endPosition) const;
+
+    // 由目标描述派生默认种子，保证各分片无需协商即可得到同一排列
+    static uint64_t deriveSeed(const std::string& text);
+
+private:
+    uint64_t elementAt(uint64_t position) const;
+    static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t m);
+    static uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t m);
+    static bool isPrime(uint64_t n);
+    static std::vector<uint64_t> primeFactors(uint64_t n);
+
+private:
+    uint64_t m_size;
+    uint64_t m_seed;
+    uint64_t m_prime = 2;
+    uint64_t m_generator = 1;
+    uint64_t m_start = 1;
+};
+
+} // namespace MindSploit::Utils
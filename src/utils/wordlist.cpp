@@ -0,0 +1,180 @@
+#include "wordlist.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace MindSploit::Utils {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    moveFrom(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+void MappedFile::moveFrom(MappedFile& other) {
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_open = other.m_open;
+#ifdef _WIN32
+    m_file = other.m_file;
+    m_mapping = other.m_mapping;
+    other.m_file = nullptr;
+    other.m_mapping = nullptr;
+#endif
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_open = false;
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Failed to open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        error = "Failed to stat " + path;
+        return false;
+    }
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_open = true;
+    // 空文件不能建立映射
+    if (m_size == 0) {
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        error = "Failed to map " + path;
+        return false;
+    }
+    m_mapping = mapping;
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        close();
+        error = "Failed to map " + path;
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Failed to open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        error = "Not a regular file: " + path;
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    m_open = true;
+    if (m_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后描述符即可关闭
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        m_size = 0;
+        m_open = false;
+        error = "Failed to map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    // 字典按顺序读取，提示内核提前预读
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(data);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+    if (m_file != nullptr) {
+        CloseHandle(static_cast<HANDLE>(m_file));
+    }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+bool Wordlist::open(const std::string& path, std::string& error) {
+    if (!m_file.open(path, error)) {
+        return false;
+    }
+    m_path = path;
+    m_count = 0;
+
+    size_t offset = 0;
+    std::string_view word;
+    while (next(offset, word)) {
+        ++m_count;
+    }
+    return true;
+}
+
+bool Wordlist::next(size_t& offset, std::string_view& word) const {
+    const char* data = m_file.data();
+    const size_t size = m_file.size();
+
+    while (offset < size) {
+        const char* start = data + offset;
+        const char* newline = static_cast<const char*>(std::memchr(start, '\n', size - offset));
+        const char* end = newline != nullptr ? newline : data + size;
+        offset = static_cast<size_t>(end - data) + (newline != nullptr ? 1 : 0);
+
+        while (start < end && (*start == ' ' || *start == '\t')) {
+            ++start;
+        }
+        while (end > start && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+            --end;
+        }
+        if (start == end || *start == '#') {
+            continue;
+        }
+        word = std::string_view(start, static_cast<size_t>(end - start));
+        return true;
+    }
+    return false;
+}
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace MindSploit::Utils {
+
+// 只读内存映射文件
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    void moveFrom(MappedFile& other);
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+// 字典文件
+//
+// 整个文件映射到内存，按行迭代时返回指向映射区的string_view，不逐行拷贝；
+// 数百万行的字典只占用页缓存，多个目标共享同一份映射，各自只保存一个读取偏移。
+// 行首尾空白和CR被去掉，空行和 # 开头的注释行跳过。
+class Wordlist {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    const std::string& path() const { return m_path; }
+    size_t bytes() const { return m_file.size(); }
+    // 有效行数 (打开时统计一次)
+    uint64_t count() const { return m_count; }
+
+    // 从offset开始读取下一个词并推进offset，到达末尾返回false
+    bool next(size_t& offset, std::string_view& word) const;
+
+private:
+    MappedFile m_file;
+    std::string m_path;
+    uint64_t m_count = 0;
+};
+
+} // namespace MindSploit::Utils
@@ -0,0 +1,642 @@
+#include "xdp_channel.h"
+#include "socket_budget.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <errno.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace MindSploit::Utils {
+
+namespace {
+
+constexpr uint32_t FRAME_SIZE = 2048;
+constexpr size_t ETHERNET_HEADER_SIZE = 14;
+constexpr auto NEIGHBOR_TIMEOUT = std::chrono::milliseconds(1000);
+constexpr int TX_FULL_RETRIES = 100;
+
+long bpf(int command, union bpf_attr& attr) {
+    return syscall(__NR_bpf, command, &attr, sizeof(attr));
+}
+
+std::string systemError(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+// 手工汇编XDP程序用到的指令
+struct Assembler {
+    std::vector<struct bpf_insn> code;
+    std::vector<size_t> passJumps;              // 跳到XDP_PASS出口的指令，汇编结束时回填偏移
+
+    void emit(uint8_t opcode, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+        struct bpf_insn insn;
+        std::memset(&insn, 0, sizeof(insn));
+        insn.code = opcode;
+        insn.dst_reg = dst & 0x0f;
+        insn.src_reg = src & 0x0f;
+        insn.off = off;
+        insn.imm = imm;
+        code.push_back(insn);
+    }
+    void movReg(uint8_t dst, uint8_t src) { emit(BPF_ALU64 | BPF_MOV | BPF_X, dst, src, 0, 0); }
+    void movImm(uint8_t dst, int32_t imm) { emit(BPF_ALU64 | BPF_MOV | BPF_K, dst, 0, 0, imm); }
+    void aluImm(uint8_t op, uint8_t dst, int32_t imm) { emit(BPF_ALU64 | op | BPF_K, dst, 0, 0, imm); }
+    void aluReg(uint8_t op, uint8_t dst, uint8_t src) { emit(BPF_ALU64 | op | BPF_X, dst, src, 0, 0); }
+    void load(uint8_t size, uint8_t dst, uint8_t src, int16_t off) { emit(BPF_LDX | size | BPF_MEM, dst, src, off, 0); }
+    void passIfImm(uint8_t op, uint8_t dst, int32_t imm) {
+        passJumps.push_back(code.size());
+        emit(BPF_JMP | op | BPF_K, dst, 0, 0, imm);
+    }
+    void passIfReg(uint8_t op, uint8_t dst, uint8_t src) {
+        passJumps.push_back(code.size());
+        emit(BPF_JMP | op | BPF_X, dst, src, 0, 0);
+    }
+    void loadMap(uint8_t dst, int fd) {
+        emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, fd);
+        emit(0, 0, 0, 0, 0);
+    }
+    // 64位立即数: 与寄存器比较时32位立即数会被符号扩展，高位为1的值须用这种方式装入
+    void loadImm64(uint8_t dst, uint64_t value) {
+        emit(BPF_LD | BPF_DW | BPF_IMM, dst, 0, 0, static_cast<int32_t>(static_cast<uint32_t>(value)));
+        emit(0, 0, 0, 0, static_cast<int32_t>(static_cast<uint32_t>(value >> 32)));
+    }
+    void call(int32_t helper) { emit(BPF_JMP | BPF_CALL, 0, 0, 0, helper); }
+    void exit() { emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0); }
+    void bindPass() {
+        size_t target = code.size();
+        for (size_t at : passJumps) {
+            code[at].off = static_cast<int16_t>(target - at - 1);
+        }
+    }
+};
+
+bool readMac(const std::string& interface, uint8_t mac[6]) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct ifreq request;
+    std::memset(&request, 0, sizeof(request));
+    std::strncpy(request.ifr_name, interface.c_str(), IFNAMSIZ - 1);
+    bool ok = ioctl(fd, SIOCGIFHWADDR, &request) == 0;
+    if (ok) {
+        std::memcpy(mac, request.ifr_hwaddr.sa_data, 6);
+    }
+    close(fd);
+    return ok;
+}
+
+bool parseMac(const std::string& text, uint8_t mac[6]) {
+    unsigned int bytes[6];
+    if (std::sscanf(text.c_str(), "%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                    &bytes[4], &bytes[5]) != 6) {
+        return false;
+    }
+    for (int i = 0; i < 6; ++i) {
+        mac[i] = static_cast<uint8_t>(bytes[i]);
+    }
+    return true;
+}
+
+// 在邻居表中查找已完成解析的条目
+bool lookupNeighbor(const std::string& address, const std::string& interface, uint8_t mac[6]) {
+    std::ifstream arp("/proc/net/arp");
+    std::string line;
+    std::getline(arp, line);                    // 表头
+    while (std::getline(arp, line)) {
+        std::istringstream fields(line);
+        std::string ip, type, flags, hw, mask, device;
+        if (!(fields >> ip >> type >> flags >> hw >> mask >> device)) {
+            continue;
+        }
+        if (ip == address && device == interface && (std::stoul(flags, nullptr, 16) & 0x2)) {
+            return parseMac(hw, mac);
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<struct bpf_insn> buildXdpRedirectProgram(uint32_t destination, uint8_t protocol, uint16_t firstPort,
+                                                     uint16_t lastPort, int mapFd) {
+    // r6 = ctx; r2 = data; r3 = data_end
+    Assembler as;
+    as.movReg(BPF_REG_6, BPF_REG_1);
+    as.load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, data));
+    as.load(BPF_W, BPF_REG_3, BPF_REG_6, offsetof(struct xdp_md, data_end));
+    // 以太网首部 + 最短IPv4首部
+    as.movReg(BPF_REG_4, BPF_REG_2);
+    as.aluImm(BPF_ADD, BPF_REG_4, ETHERNET_HEADER_SIZE + 20);
+    as.passIfReg(BPF_JGT, BPF_REG_4, BPF_REG_3);
+    as.load(BPF_H, BPF_REG_5, BPF_REG_2, 12);
+    as.passIfImm(BPF_JNE, BPF_REG_5, htons(0x0800));
+    as.load(BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + 9);
+    as.passIfImm(BPF_JNE, BPF_REG_5, protocol);
+    // 目的地址按内存字节序读出，与网络字节序的地址值直接比较
+    as.load(BPF_W, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + 16);
+    as.loadImm64(BPF_REG_7, destination);
+    as.passIfReg(BPF_JNE, BPF_REG_5, BPF_REG_7);
+    // 跳过IP首部 (IHL*4) 后检查目的端口
+    as.load(BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE);
+    as.aluImm(BPF_AND, BPF_REG_5, 0x0f);
+    as.aluImm(BPF_LSH, BPF_REG_5, 2);
+    as.aluReg(BPF_ADD, BPF_REG_2, BPF_REG_5);
+    as.movReg(BPF_REG_4, BPF_REG_2);
+    as.aluImm(BPF_ADD, BPF_REG_4, ETHERNET_HEADER_SIZE + 4);
+    as.passIfReg(BPF_JGT, BPF_REG_4, BPF_REG_3);
+    as.load(BPF_B, BPF_REG_5, BPF_REG_2, ETHERNET_HEADER_SIZE + 2);
+    as.aluImm(BPF_LSH, BPF_REG_5, 8);
+    as.load(BPF_B, BPF_REG_7, BPF_REG_2, ETHERNET_HEADER_SIZE + 3);
+    as.aluReg(BPF_OR, BPF_REG_5, BPF_REG_7);
+    as.passIfImm(BPF_JLT, BPF_REG_5, firstPort);
+    as.passIfImm(BPF_JGT, BPF_REG_5, lastPort);
+    // bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS): 队列上没有套接字时交给内核
+    as.loadMap(BPF_REG_1, mapFd);
+    as.load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, rx_queue_index));
+    as.movImm(BPF_REG_3, XDP_PASS);
+    as.call(BPF_FUNC_redirect_map);
+    as.exit();
+    as.bindPass();
+    as.movImm(BPF_REG_0, XDP_PASS);
+    as.exit();
+    return as.code;
+}
+
+XdpChannel::XdpChannel(const PacketChannelConfig& config)
+    : m_config(config) {
+    // 帧数取2的幂，接收和发送各一半
+    size_t frames = 64;
+    while (frames < m_config.frames && frames < (1u << 20)) {
+        frames <<= 1;
+    }
+    m_config.frames = frames;
+}
+
+XdpChannel::~XdpChannel() {
+    // 关闭bpf_link即从接口卸载XDP程序
+    for (int fd : {m_linkFd, m_programFd, m_mapFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    unmapRing(m_rx);
+    unmapRing(m_tx);
+    unmapRing(m_fill);
+    unmapRing(m_completion);
+    if (m_socket >= 0) {
+        close(m_socket);
+    }
+    if (m_umem != nullptr) {
+        munmap(m_umem, m_umemSize);
+    }
+}
+
+bool XdpChannel::open(const IPAddress& probeTarget, std::string& error) {
+    if (probeTarget.isIPv6) {
+        error = "AF_XDP channel only supports IPv4 targets";
+        return false;
+    }
+    // 重定向的报文不经过协议栈: 端口范围与临时端口范围重叠时，内核自己连接的应答也会被截走
+    PortRange ephemeral = SocketBudget::ephemeralPortRange();
+    if (m_config.firstPort <= ephemeral.end && m_config.lastPort >= ephemeral.start) {
+        error = "AF_XDP port range " + std::to_string(m_config.firstPort) + "-" + std::to_string(m_config.lastPort) +
+                " overlaps the ephemeral port range " + std::to_string(ephemeral.start) + "-" +
+                std::to_string(ephemeral.end);
+        return false;
+    }
+    return resolveRoute(probeTarget, error) && createUmem(error) && loadProgram(error) &&
+           attachProgram(error) && bindSocket(error);
+}
+
+bool XdpChannel::resolveRoute(const IPAddress& probeTarget, std::string& error) {
+    Socket route(AF_INET, SOCK_DGRAM);
+    if (!route.isValid() || !route.connect(probeTarget, 80)) {
+        error = "No route to " + probeTarget.address;
+        return false;
+    }
+    m_source = route.getLocalAddress();
+
+    // 未指定接口时取拥有源地址的接口
+    m_interface = m_config.interface;
+    if (m_interface.empty()) {
+        struct ifaddrs* addresses = nullptr;
+        if (getifaddrs(&addresses) == 0) {
+            for (auto* entry = addresses; entry != nullptr; entry = entry->ifa_next) {
+                if (entry->ifa_addr == nullptr || entry->ifa_addr->sa_family != AF_INET) {
+                    continue;
+                }
+                char text[INET_ADDRSTRLEN] = {0};
+                inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(entry->ifa_addr)->sin_addr, text, sizeof(text));
+                if (m_source.address == text) {
+                    m_interface = entry->ifa_name;
+                    break;
+                }
+            }
+            freeifaddrs(addresses);
+        }
+    }
+    m_ifindex = static_cast<int>(if_nametoindex(m_interface.c_str()));
+    if (m_interface.empty() || m_ifindex == 0) {
+        error = m_config.interface.empty() ? "Cannot determine interface for source address " + m_source.address
+                                           : "Interface " + m_config.interface + " not found";
+        return false;
+    }
+    if (!readMac(m_interface, m_sourceMac)) {
+        error = systemError("Failed to read MAC address of " + m_interface);
+        return false;
+    }
+    if (m_interface == "lo") {
+        return true;
+    }
+
+    // 下一跳: 主路由表中该接口上最长匹配的路由，没有网关则为目标本身
+    uint32_t target = 0;
+    inet_pton(AF_INET, probeTarget.address.c_str(), &target);
+    uint32_t nextHop = target;
+    int bestPrefix = -1;
+    std::ifstream routes("/proc/net/route");
+    std::string line;
+    std::getline(routes, line);
+    while (std::getline(routes, line)) {
+        std::istringstream fields(line);
+        std::string iface, destination, gateway, flags, refcnt, use, metric, mask;
+        if (!(fields >> iface >> destination >> gateway >> flags >> refcnt >> use >> metric >> mask) ||
+            iface != m_interface) {
+            continue;
+        }
+        // 字段为网络字节序数值的十六进制表示，与内存中的地址直接比较
+        uint32_t destinationValue = static_cast<uint32_t>(std::stoul(destination, nullptr, 16));
+        uint32_t maskValue = static_cast<uint32_t>(std::stoul(mask, nullptr, 16));
+        int prefix = __builtin_popcount(maskValue);
+        if ((target & maskValue) == destinationValue && prefix > bestPrefix) {
+            bestPrefix = prefix;
+            uint32_t gatewayValue = static_cast<uint32_t>(std::stoul(gateway, nullptr, 16));
+            nextHop = gatewayValue != 0 ? gatewayValue : target;
+        }
+    }
+    char nextHopText[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &nextHop, nextHopText, sizeof(nextHopText));
+
+    // 邻居表中没有时发一个UDP报文触发ARP解析
+    if (!lookupNeighbor(nextHopText, m_interface, m_nextHopMac)) {
+        Socket trigger(AF_INET, SOCK_DGRAM);
+        if (trigger.isValid() && trigger.connect(IPAddress(nextHopText), 9)) {
+            trigger.send("", 0);
+        }
+        auto deadline = std::chrono::steady_clock::now() + NEIGHBOR_TIMEOUT;
+        while (!lookupNeighbor(nextHopText, m_interface, m_nextHopMac)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                error = "Cannot resolve MAC address of next hop " + std::string(nextHopText) + " on " + m_interface;
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    return true;
+}
+
+bool XdpChannel::createUmem(std::string& error) {
+    m_socket = socket(AF_XDP, SOCK_RAW, 0);
+    if (m_socket < 0) {
+        error = systemError("Failed to create AF_XDP socket");
+        return false;
+    }
+
+    m_umemSize = m_config.frames * FRAME_SIZE;
+    void* area = mmap(nullptr, m_umemSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (area == MAP_FAILED) {
+        error = systemError("Failed to allocate UMEM");
+        return false;
+    }
+    m_umem = static_cast<uint8_t*>(area);
+
+    struct xdp_umem_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.addr = reinterpret_cast<uint64_t>(m_umem);
+    reg.len = m_umemSize;
+    reg.chunk_size = FRAME_SIZE;
+    if (setsockopt(m_socket, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+        error = systemError("Failed to register UMEM");
+        return false;
+    }
+
+    const uint32_t ringSize = static_cast<uint32_t>(m_config.frames / 2);
+    for (int option : {XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING, XDP_TX_RING}) {
+        if (setsockopt(m_socket, SOL_XDP, option, &ringSize, sizeof(ringSize)) < 0) {
+            error = systemError("Failed to size AF_XDP rings");
+            return false;
+        }
+    }
+
+    struct xdp_mmap_offsets offsets;
+    socklen_t length = sizeof(offsets);
+    if (getsockopt(m_socket, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &length) < 0) {
+        error = systemError("Failed to query AF_XDP ring offsets");
+        return false;
+    }
+    if (!mapRing(m_fill, XDP_UMEM_FILL_RING, XDP_UMEM_PGOFF_FILL_RING, sizeof(uint64_t), ringSize, &offsets.fr, error) ||
+        !mapRing(m_completion, XDP_UMEM_COMPLETION_RING, XDP_UMEM_PGOFF_COMPLETION_RING, sizeof(uint64_t), ringSize,
+                 &offsets.cr, error) ||
+        !mapRing(m_rx, XDP_RX_RING, XDP_PGOFF_RX_RING, sizeof(struct xdp_desc), ringSize, &offsets.rx, error) ||
+        !mapRing(m_tx, XDP_TX_RING, XDP_PGOFF_TX_RING, sizeof(struct xdp_desc), ringSize, &offsets.tx, error)) {
+        return false;
+    }
+
+    // 前一半帧交给填充环接收，后一半用于发送
+    for (uint32_t i = 0; i < ringSize; ++i) {
+        m_fill.at<uint64_t>(i) = static_cast<uint64_t>(i) * FRAME_SIZE;
+    }
+    m_fill.produce(ringSize);
+    for (size_t i = ringSize; i < m_config.frames; ++i) {
+        m_freeFrames.push_back(static_cast<uint64_t>(i) * FRAME_SIZE);
+    }
+    return true;
+}
+
+bool XdpChannel::mapRing(Ring& ring, int option, uint64_t offset, size_t descriptorSize, uint32_t size,
+                         const void* offsets, std::string& error) {
+    (void)option;
+    const auto* ringOffsets = static_cast<const struct xdp_ring_offset*>(offsets);
+    ring.mapLength = ringOffsets->desc + size * descriptorSize;
+    void* map = mmap(nullptr, ring.mapLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_socket,
+                     static_cast<off_t>(offset));
+    if (map == MAP_FAILED) {
+        ring.mapLength = 0;
+        error = systemError("Failed to map AF_XDP ring");
+        return false;
+    }
+    auto* base = static_cast<uint8_t*>(map);
+    ring.map = map;
+    ring.producer = reinterpret_cast<uint32_t*>(base + ringOffsets->producer);
+    ring.consumer = reinterpret_cast<uint32_t*>(base + ringOffsets->consumer);
+    ring.flags = reinterpret_cast<uint32_t*>(base + ringOffsets->flags);
+    ring.descriptors = base + ringOffsets->desc;
+    ring.size = size;
+    return true;
+}
+
+bool XdpChannel::loadProgram(std::string& error) {
+    union bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = m_config.queue + 1;
+    m_mapFd = static_cast<int>(bpf(BPF_MAP_CREATE, attr));
+    if (m_mapFd < 0) {
+        error = systemError("Failed to create XSKMAP (requires CAP_BPF or root)");
+        return false;
+    }
+
+    // 发往本机源地址、协议匹配且目的端口在范围内的IPv4报文重定向到本队列的套接字，其余XDP_PASS
+    uint32_t destination = 0;
+    inet_pton(AF_INET, m_source.address.c_str(), &destination);
+    std::vector<struct bpf_insn> code =
+        buildXdpRedirectProgram(destination, m_config.protocol, m_config.firstPort, m_config.lastPort, m_mapFd);
+
+    static const char license[] = "GPL";
+    std::vector<char> log(16384, 0);
+    std::memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insn_cnt = static_cast<uint32_t>(code.size());
+    attr.insns = reinterpret_cast<uint64_t>(code.data());
+    attr.license = reinterpret_cast<uint64_t>(license);
+    attr.expected_attach_type = BPF_XDP;
+    attr.log_level = 1;
+    attr.log_buf = reinterpret_cast<uint64_t>(log.data());
+    attr.log_size = static_cast<uint32_t>(log.size());
+    m_programFd = static_cast<int>(bpf(BPF_PROG_LOAD, attr));
+    if (m_programFd < 0) {
+        error = systemError("Failed to load XDP program");
+        // 校验器日志的末尾是拒绝的原因
+        std::string verifier(log.data());
+        while (!verifier.empty() && verifier.back() == '\n') {
+            verifier.pop_back();
+        }
+        if (!verifier.empty()) {
+            error += " (" + verifier.substr(verifier.rfind('\n') + 1) + ")";
+        }
+        return false;
+    }
+    return true;
+}
+
+bool XdpChannel::attachProgram(std::string& error) {
+    std::vector<uint32_t> modes;
+    if (m_config.xdpMode != XdpMode::SKB) {
+        modes.push_back(XDP_FLAGS_DRV_MODE);
+    }
+    if (m_config.xdpMode != XdpMode::NATIVE) {
+        modes.push_back(XDP_FLAGS_SKB_MODE);
+    }
+
+    for (uint32_t mode : modes) {
+        union bpf_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.link_create.prog_fd = static_cast<uint32_t>(m_programFd);
+        attr.link_create.target_ifindex = static_cast<uint32_t>(m_ifindex);
+        attr.link_create.attach_type = BPF_XDP;
+        attr.link_create.flags = mode;
+        m_linkFd = static_cast<int>(bpf(BPF_LINK_CREATE, attr));
+        if (m_linkFd >= 0) {
+            m_nativeMode = mode == XDP_FLAGS_DRV_MODE;
+            return true;
+        }
+        if (errno == EBUSY || errno == EEXIST) {
+            error = "Interface " + m_interface + " already has an XDP program attached";
+            return false;
+        }
+    }
+    error = systemError("Failed to attach XDP program to " + m_interface);
+    return false;
+}
+
+bool XdpChannel::bindSocket(std::string& error) {
+    // 驱动模式下先尝试零拷贝，再依次去掉零拷贝和唤醒标志
+    std::vector<uint16_t> attempts;
+    if (m_nativeMode) {
+        attempts.push_back(XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP);
+    }
+    attempts.push_back(XDP_COPY | XDP_USE_NEED_WAKEUP);
+    attempts.push_back(XDP_COPY);
+
+    bool bound = false;
+    for (uint16_t flags : attempts) {
+        struct sockaddr_xdp address;
+        std::memset(&address, 0, sizeof(address));
+        address.sxdp_family = AF_XDP;
+        address.sxdp_ifindex = static_cast<uint32_t>(m_ifindex);
+        address.sxdp_queue_id = m_config.queue;
+        address.sxdp_flags = flags;
+        if (bind(m_socket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0) {
+            m_zeroCopy = (flags & XDP_ZEROCOPY) != 0;
+            m_needWakeup = (flags & XDP_USE_NEED_WAKEUP) != 0;
+            bound = true;
+            break;
+        }
+    }
+    if (!bound) {
+        error = systemError("Failed to bind AF_XDP socket to " + m_interface + " queue " + std::to_string(m_config.queue));
+        return false;
+    }
+
+    union bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    uint32_t key = m_config.queue;
+    uint32_t value = static_cast<uint32_t>(m_socket);
+    attr.map_fd = static_cast<uint32_t>(m_mapFd);
+    attr.key = reinterpret_cast<uint64_t>(&key);
+    attr.value = reinterpret_cast<uint64_t>(&value);
+    if (bpf(BPF_MAP_UPDATE_ELEM, attr) < 0) {
+        error = systemError("Failed to register AF_XDP socket in XSKMAP");
+        return false;
+    }
+    return true;
+}
+
+void XdpChannel::configureTemplate(PacketTemplateConfig& config) const {
+    config.source = m_source;
+    config.includeEthernet = true;
+    std::memcpy(config.sourceMac, m_sourceMac, 6);
+    std::memcpy(config.gatewayMac, m_nextHopMac, 6);
+}
+
+size_t XdpChannel::send(const PacketTemplate& packetTemplate, const ProbeTarget* targets, size_t count) {
+    if (!packetTemplate.hasEthernet() || packetTemplate.size() > FRAME_SIZE) {
+        return 0;
+    }
+    size_t sent = 0;
+    int retries = 0;
+    while (sent < count) {
+        reclaimCompleted();
+        size_t available = std::min<size_t>({count - sent, m_tx.space(), m_freeFrames.size()});
+        if (available == 0) {
+            // 发送环或空闲帧用尽: 催促内核发送并等待完成环归还帧
+            kick();
+            if (++retries > TX_FULL_RETRIES) {
+                break;
+            }
+            struct pollfd pfd = {m_socket, POLLOUT, 0};
+            poll(&pfd, 1, 1);
+            continue;
+        }
+        retries = 0;
+
+        // 模板直接写入UMEM帧，网卡 (零拷贝) 或内核 (拷贝模式) 从这里取走报文
+        const uint32_t producer = *m_tx.producer;
+        for (size_t i = 0; i < available; ++i) {
+            uint64_t frame = m_freeFrames.back();
+            m_freeFrames.pop_back();
+            packetTemplate.stamp(m_umem + frame, targets[sent + i]);
+            struct xdp_desc& desc = m_tx.at<struct xdp_desc>(producer + static_cast<uint32_t>(i));
+            desc.addr = frame;
+            desc.len = static_cast<uint32_t>(packetTemplate.size());
+            desc.options = 0;
+        }
+        m_tx.produce(static_cast<uint32_t>(available));
+        sent += available;
+    }
+    kick();
+    m_stats.sent += sent;
+    return sent;
+}
+
+size_t XdpChannel::receive(const Handler& handler) {
+    uint32_t count = m_rx.ready();
+    if (count == 0) {
+        return 0;
+    }
+
+    // 接收帧处理后原样放回填充环; 两个环大小相同，填充环总有足够的空位
+    const uint32_t consumer = *m_rx.consumer;
+    const uint32_t fillProducer = *m_fill.producer;
+    for (uint32_t i = 0; i < count; ++i) {
+        const struct xdp_desc& desc = m_rx.at<struct xdp_desc>(consumer + i);
+        const uint8_t* frame = m_umem + desc.addr;
+        if (desc.len > ETHERNET_HEADER_SIZE && frame[12] == 0x08 && frame[13] == 0x00) {
+            handler(frame + ETHERNET_HEADER_SIZE, desc.len - ETHERNET_HEADER_SIZE);
+        }
+        m_fill.at<uint64_t>(fillProducer + i) = desc.addr & ~static_cast<uint64_t>(FRAME_SIZE - 1);
+    }
+    m_fill.produce(count);
+    m_rx.consume(count);
+    m_stats.received += count;
+    return count;
+}
+
+void XdpChannel::wait(std::chrono::microseconds timeout) {
+    if (m_rx.ready() > 0) {
+        return;
+    }
+    struct pollfd pfd = {m_socket, POLLIN, 0};
+    poll(&pfd, 1, static_cast<int>(std::max<int64_t>(1, (timeout.count() + 999) / 1000)));
+}
+
+std::string XdpChannel::describe() const {
+    return "AF_XDP " + m_interface + " queue " + std::to_string(m_config.queue) + " (" +
+           (m_nativeMode ? "native" : "skb") + ", " + (m_zeroCopy ? "zero-copy" : "copy") + ")";
+}
+
+PacketChannelStats XdpChannel::getStats() const {
+    PacketChannelStats stats = m_stats;
+    struct xdp_statistics xdpStats;
+    socklen_t length = sizeof(xdpStats);
+    if (getsockopt(m_socket, SOL_XDP, XDP_STATISTICS, &xdpStats, &length) == 0) {
+        stats.dropped = xdpStats.rx_dropped + xdpStats.rx_ring_full;
+    }
+    return stats;
+}
+
+void XdpChannel::reclaimCompleted() {
+    uint32_t count = m_completion.ready();
+    if (count == 0) {
+        return;
+    }
+    const uint32_t consumer = *m_completion.consumer;
+    for (uint32_t i = 0; i < count; ++i) {
+        m_freeFrames.push_back(m_completion.at<uint64_t>(consumer + i));
+    }
+    m_completion.consume(count);
+}
+
+void XdpChannel::kick() {
+    if (m_needWakeup && !(__atomic_load_n(m_tx.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP)) {
+        return;
+    }
+    // EAGAIN/EBUSY表示内核正在处理发送环，稍后重试即可
+    sendto(m_socket, nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+}
+
+void XdpChannel::unmapRing(Ring& ring) {
+    if (ring.map != nullptr) {
+        munmap(ring.map, ring.mapLength);
+        ring.map = nullptr;
+    }
+}
+
+} // namespace MindSploit::Utils
+
+#endif // __linux__
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "packet_channel.h"
+
+#ifdef __linux__
+
+#include <linux/bpf.h>
+
+namespace MindSploit::Utils {
+
+// 生成AF_XDP通道的分流程序: 目的地址为destination (网络字节序)、指定协议且目的端口在
+// [firstPort, lastPort]内的IPv4报文经XSKMAP (mapFd) 重定向到接收队列上的套接字，其余XDP_PASS
+std::vector<struct bpf_insn> buildXdpRedirectProgram(uint32_t destination, uint8_t protocol, uint16_t firstPort,
+                                                     uint16_t lastPort, int mapFd);
+
+// 内核与用户态共享的单生产者/单消费者环 (填充、完成、接收、发送环)
+//
+// 生产者和消费者下标是自由增长的32位计数，无符号相减即环中条目数，回绕后依然成立;
+// 条目位置为 下标 & (size-1)，size须为2的幂。本端写自己的下标用release，读对端的用acquire。
+struct XdpRing {
+    uint32_t* producer = nullptr;
+    uint32_t* consumer = nullptr;
+    uint32_t* flags = nullptr;
+    void* descriptors = nullptr;
+    uint32_t size = 0;
+    void* map = nullptr;
+    size_t mapLength = 0;
+
+    // 消费端: 可取出的条目数
+    uint32_t ready() const { return __atomic_load_n(producer, __ATOMIC_ACQUIRE) - *consumer; }
+    // 生产端: 可放入的空位数
+    uint32_t space() const { return size - (*producer - __atomic_load_n(consumer, __ATOMIC_ACQUIRE)); }
+    template <typename T>
+    T& at(uint32_t index) const { return static_cast<T*>(descriptors)[index & (size - 1)]; }
+    void produce(uint32_t count) { __atomic_store_n(producer, *producer + count, __ATOMIC_RELEASE); }
+    void consume(uint32_t count) { __atomic_store_n(consumer, *consumer + count, __ATOMIC_RELEASE); }
+};
+
+// AF_XDP收发通道
+//
+// - UMEM是一块mmap的帧区，一半帧放入填充环供网卡队列接收，一半作为发送帧:
+//   PacketTemplate::stamp直接写入空闲发送帧，描述符放入发送环即完成发送，
+//   完成环归还的帧回到空闲列表; 接收环中的帧就地解析后放回填充环
+// - 接收由一段手工汇编的XDP程序分流: 只有发往源地址、指定协议且目的端口在范围内的IPv4报文
+//   经XSKMAP重定向到本套接字，其余报文 (包括ARP、SSH会话、发往本机其它地址或转发的流量) 照常
+//   交给内核协议栈。内核看不到这些应答，也就不会对SYN-ACK回复RST; 端口范围因此不能与内核
+//   临时端口范围重叠，否则内核自己连接的应答也会被截走
+// - 先尝试驱动模式挂载和零拷贝绑定，不支持时退回通用 (SKB) 模式和拷贝模式，veth上也可用
+// - 发送的是二层帧: 源MAC取自接口，目的MAC为到探测目标的下一跳 (网关或同网段目标本身)，
+//   所有探测都发往该下一跳
+// 需要root权限 (CAP_NET_ADMIN、CAP_BPF/CAP_SYS_ADMIN) 和Linux 5.9以上 (bpf_link挂载XDP)。
+// 只接收绑定队列上的报文，多队列网卡需把应答引导到该队列，或把队列数设为1。
+class XdpChannel : public PacketChannel {
+public:
+    explicit XdpChannel(const PacketChannelConfig& config);
+    ~XdpChannel() override;
+
+    XdpChannel(const XdpChannel&) = delete;
+    XdpChannel& operator=(const XdpChannel&) = delete;
+
+    bool open(const IPAddress& probeTarget, std::string& error);
+
+    void configureTemplate(PacketTemplateConfig& config) const override;
+    size_t send(const PacketTemplate& packetTemplate, const ProbeTarget* targets, size_t count) override;
+    size_t receive(const Handler& handler) override;
+    void wait(std::chrono::microseconds timeout) override;
+
+    std::string describe() const override;
+    PacketChannelStats getStats() const override;
+
+private:
+    using Ring = XdpRing;
+
+    bool resolveRoute(const IPAddress& probeTarget, std::string& error);
+    bool createUmem(std::string& error);
+    bool mapRing(Ring& ring, int option, uint64_t offset, size_t descriptorSize, uint32_t size,
+                 const void* offsets, std::string& error);
+    bool bindSocket(std::string& error);
+    bool loadProgram(std::string& error);
+    bool attachProgram(std::string& error);
+
+    // 回收完成环中已发送的帧
+    void reclaimCompleted();
+    // 通知内核处理发送环 (拷贝模式和需要唤醒时)
+    void kick();
+    static void unmapRing(Ring& ring);
+
+private:
+    PacketChannelConfig m_config;
+    int m_socket = -1;
+    int m_mapFd = -1;
+    int m_programFd = -1;
+    int m_linkFd = -1;
+
+    std::string m_interface;
+    int m_ifindex = 0;
+    uint8_t m_sourceMac[6] = {0};
+    uint8_t m_nextHopMac[6] = {0};
+
+    uint8_t* m_umem = nullptr;
+    size_t m_umemSize = 0;
+    Ring m_fill;
+    Ring m_completion;
+    Ring m_rx;
+    Ring m_tx;
+    std::vector<uint64_t> m_freeFrames;         // 空闲的发送帧地址
+    bool m_zeroCopy = false;
+    bool m_nativeMode = false;
+    bool m_needWakeup = false;
+
+    PacketChannelStats m_stats;
+};
+
+} // namespace MindSploit::Utils
+
+#endif // __linux__
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <string>
+#include "../src/utils/bloom_filter.h"
+
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 形如爬虫URL的元素，相邻编号只差一两个字符
+std::string url(size_t i) {
+    return "http://example.com:8080/app/item?id=" + std::to_string(i);
+}
+
+// 未插入过的元素中被判为存在的比例
+double falsePositiveRate(const ScalableBloomFilter& filter, size_t begin, size_t count) {
+    size_t positives = 0;
+    for (size_t i = begin; i < begin + count; ++i) {
+        if (filter.contains(url(i))) {
+            ++positives;
+        }
+    }
+    return static_cast<double>(positives) / static_cast<double>(count);
+}
+
+void testSingleLayer() {
+    std::cout << "=== 测试单层过滤器 ===" << std::endl;
+
+    ScalableBloomFilter filter(10000, 0.01);
+    CHECK(filter.layerCount() == 1);
+    CHECK(filter.size() == 0);
+    CHECK(!filter.contains(url(0)));
+    // 第一层误判率为目标值的一半，约 -n*ln(0.005)/ln2^2 位
+    CHECK(filter.memoryBytes() >= 13000 && filter.memoryBytes() <= 14000);
+
+    size_t duplicates = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        if (!filter.insert(url(i))) {
+            ++duplicates;
+        }
+    }
+    // 插入时的重复判定也是误判，数量应与误判率相符
+    CHECK(duplicates < 100);
+    CHECK(filter.size() == 10000 - duplicates);
+    CHECK(filter.layerCount() == 1);
+
+    // 没有漏判
+    bool allFound = true;
+    for (size_t i = 0; i < 10000; ++i) {
+        allFound = allFound && filter.contains(url(i));
+    }
+    CHECK(allFound);
+    CHECK(!filter.insert(url(42)));
+    CHECK(falsePositiveRate(filter, 1000000, 100000) < 0.01);
+
+    std::cout << "单层过滤器测试完成" << std::endl;
+}
+
+void testScaling() {
+    std::cout << "\n=== 测试扩容 ===" << std::endl;
+
+    // 插入初始容量的30倍: 需要 1+2+4+8+16 层
+    ScalableBloomFilter filter(1000, 0.01);
+    size_t previousBytes = filter.memoryBytes();
+    size_t previousLayers = filter.layerCount();
+    bool growthOk = true;
+    for (size_t i = 0; i < 30000; ++i) {
+        filter.insert(url(i));
+        if (filter.layerCount() != previousLayers) {
+            // 新层的容量翻倍，误判率减半，位数多于上一层的两倍
+            growthOk = growthOk && filter.layerCount() == previousLayers + 1 &&
+                       filter.memoryBytes() - previousBytes > 2 * 1000;
+            previousLayers = filter.layerCount();
+            previousBytes = filter.memoryBytes();
+        }
+    }
+    CHECK(growthOk);
+    CHECK(filter.layerCount() == 5);
+    CHECK(!filter.saturated());
+
+    bool allFound = true;
+    for (size_t i = 0; i < 30000; ++i) {
+        allFound = allFound && filter.contains(url(i));
+    }
+    CHECK(allFound);
+    // 各层误判率之和不超过目标值
+    CHECK(falsePositiveRate(filter, 1000000, 100000) < 0.01);
+
+    std::cout << "扩容测试完成" << std::endl;
+}
+
+void testMemoryLimit() {
+    std::cout << "\n=== 测试内存上限 ===" << std::endl;
+
+    // 上限只够第一层和第二层
+    ScalableBloomFilter unlimited(1000, 0.01);
+    size_t first = unlimited.memoryBytes();
+    ScalableBloomFilter filter(1000, 0.01, first * 3 + first / 2);
+    for (size_t i = 0; i < 20000; ++i) {
+        filter.insert(url(i));
+    }
+    CHECK(filter.saturated());
+    CHECK(filter.layerCount() == 2);
+    CHECK(filter.memoryBytes() <= first * 3 + first / 2);
+
+    // 过载后误判率上升，但仍然没有漏判
+    bool allFound = true;
+    for (size_t i = 0; i < 20000; ++i) {
+        allFound = allFound && filter.contains(url(i));
+    }
+    CHECK(allFound);
+    CHECK(falsePositiveRate(filter, 1000000, 10000) > 0.01);
+
+    // 第一层总会分配，即使超过上限
+    ScalableBloomFilter tiny(1000, 0.01, 1);
+    CHECK(tiny.layerCount() == 1);
+    CHECK(tiny.insert("a") && !tiny.insert("a"));
+
+    std::cout << "内存上限测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit Bloom过滤器测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    try {
+        testSingleLayer();
+        testScaling();
+        testMemoryLimit();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,242 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "../src/engines/tls/cipher_enum.h"
+
+using namespace MindSploit::Tls;
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+uint16_t get16(const std::string& data, size_t offset) {
+    return static_cast<uint16_t>((static_cast<uint8_t>(data[offset]) << 8) | static_cast<uint8_t>(data[offset + 1]));
+}
+
+void put16(std::string& out, uint16_t value) {
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value & 0xff);
+}
+
+// 只回应ServerHello的本地TLS服务端: 按客户端顺序选第一个支持的套件，没有则以handshake_failure拒绝，
+// 不支持的版本以protocol_version拒绝。统计收到的ClientHello数
+class FakeTlsServer {
+public:
+    FakeTlsServer(std::set<uint16_t> tls12, std::set<uint16_t> tls13)
+        : m_tls12(std::move(tls12)), m_tls13(std::move(tls13)), m_listener(AF_INET, SOCK_STREAM) {
+        m_listener.setReuseAddress(true);
+        m_listener.bind(IPAddress("127.0.0.1"), 0);
+        m_listener.listen(128);
+        m_thread = std::thread([this] { serve(); });
+    }
+
+    ~FakeTlsServer() {
+        m_stop = true;
+        // 唤醒阻塞的accept
+        Socket wake(AF_INET, SOCK_STREAM);
+        wake.connect(IPAddress("127.0.0.1"), port(), std::chrono::milliseconds(1000));
+        m_thread.join();
+    }
+
+    uint16_t port() const { return m_listener.getLocalPort(); }
+    size_t hellos() const { return m_hellos; }
+
+private:
+    void serve() {
+        while (!m_stop) {
+            Socket client = m_listener.accept();
+            if (!client.isValid() || m_stop) {
+                continue;
+            }
+            client.setReceiveTimeout(std::chrono::milliseconds(2000));
+            std::string hello;
+            char buffer[4096];
+            while (hello.size() < 5 || hello.size() < 5u + get16(hello, 3)) {
+                auto received = client.receive(buffer, sizeof(buffer));
+                if (received <= 0) {
+                    break;
+                }
+                hello.append(buffer, static_cast<size_t>(received));
+            }
+            std::string reply = respond(hello);
+            client.send(reply.data(), reply.size());
+        }
+    }
+
+    std::string respond(const std::string& record) {
+        // 记录头(5) 握手头(4) version(2) random(32) session_id(1+n) cipher_suites(2+n)
+        if (record.size() < 5 + 4 + 2 + 32 + 1) {
+            return alert(40);
+        }
+        ++m_hellos;
+        uint16_t version = get16(record, 9);
+        size_t offset = 9 + 2 + 32;
+        offset += 1 + static_cast<uint8_t>(record[offset]);
+        size_t listEnd = offset + 2 + get16(record, offset);
+        std::vector<uint16_t> offered;
+        for (offset += 2; offset + 1 < listEnd && offset + 1 < record.size(); offset += 2) {
+            offered.push_back(get16(record, offset));
+        }
+
+        // TLS 1.3的提议只含1.3套件，版本在supported_versions中
+        bool tls13 = !offered.empty() && isTls13CipherSuite(offered.front());
+        if (!tls13 && version != TLS_VERSION_1_2) {
+            return alert(70);
+        }
+        const std::set<uint16_t>& supported = tls13 ? m_tls13 : m_tls12;
+        for (uint16_t suite : offered) {
+            if (supported.count(suite)) {
+                return serverHello(tls13, suite);
+            }
+        }
+        return alert(40);
+    }
+
+    static std::string serverHello(bool tls13, uint16_t suite) {
+        std::string body;
+        put16(body, TLS_VERSION_1_2);
+        body.append(32, '\x11');
+        body += '\0';
+        put16(body, suite);
+        body += '\0';
+        if (tls13) {
+            put16(body, 6);
+            put16(body, EXT_SUPPORTED_VERSIONS);
+            put16(body, 2);
+            put16(body, TLS_VERSION_1_3);
+        }
+        std::string handshake = "\x02";
+        handshake += '\0';
+        put16(handshake, static_cast<uint16_t>(body.size()));
+        handshake += body;
+        std::string out = "\x16\x03\x03";
+        put16(out, static_cast<uint16_t>(handshake.size()));
+        return out + handshake;
+    }
+
+    static std::string alert(uint8_t description) {
+        std::string out = "\x15\x03\x03";
+        put16(out, 2);
+        out += '\x02';
+        out += static_cast<char>(description);
+        return out;
+    }
+
+    std::set<uint16_t> m_tls12;
+    std::set<uint16_t> m_tls13;
+    Socket m_listener;
+    std::atomic<bool> m_stop{false};
+    std::atomic<size_t> m_hellos{0};
+    std::thread m_thread;
+};
+
+CipherEnumResult enumerate(uint16_t port, const CipherEnumConfig& config) {
+    EventLoop loop;
+    TlsProber prober(loop, TlsProberConfig());
+    CipherEnumerator enumerator(prober, config);
+    CipherEnumResult result;
+    bool called = false;
+    enumerator.enumerate(IPAddress("127.0.0.1"), port, "", [&](const CipherEnumResult& r) {
+        result = r;
+        called = true;
+    });
+    std::atomic<bool> stop{false};
+    prober.run(stop);
+    CHECK(called);
+    CHECK(enumerator.active() == 0);
+    return result;
+}
+
+void testEnumeration() {
+    std::cout << "=== 测试套件枚举与拆分 ===" << std::endl;
+
+    // 服务端只支持TLS 1.2的几个分散在列表各处的套件和一个TLS 1.3套件
+    std::vector<uint16_t> tls12Candidates, tls13Candidates;
+    for (const auto& suite : knownCipherSuites()) {
+        (isTls13CipherSuite(suite.id) ? tls13Candidates : tls12Candidates).push_back(suite.id);
+    }
+    CHECK(tls12Candidates.size() >= 16);
+    CHECK(!tls13Candidates.empty());
+    std::set<uint16_t> tls12 = {tls12Candidates[0], tls12Candidates[3], tls12Candidates[tls12Candidates.size() / 2],
+                                tls12Candidates.back()};
+    std::set<uint16_t> tls13 = {tls13Candidates.back()};
+    FakeTlsServer server(tls12, tls13);
+
+    CipherEnumConfig config;
+    CipherEnumResult result = enumerate(server.port(), config);
+    CHECK(result.ok());
+    CHECK(result.versions == std::vector<uint16_t>({TLS_VERSION_1_2, TLS_VERSION_1_3}));
+    CHECK(result.cipherSuites[TLS_VERSION_1_2] == std::vector<uint16_t>(tls12.begin(), tls12.end()));
+    CHECK(result.cipherSuites[TLS_VERSION_1_3] == std::vector<uint16_t>(tls13.begin(), tls13.end()));
+    CHECK(result.inconclusive == 0);
+    CHECK(result.probes == server.hellos());
+    // 整批排除: 探测数远少于逐个套件握手
+    size_t total = tls12Candidates.size() * 4 + tls13Candidates.size();
+    CHECK(result.probes < total / 4);
+
+    // 不拆分时: 每个版本首轮一次，每个支持的套件一次，最后被拒绝一次
+    config.splitThreshold = 10000;
+    size_t before = server.hellos();
+    CipherEnumResult serial = enumerate(server.port(), config);
+    CHECK(serial.cipherSuites == result.cipherSuites);
+    CHECK(serial.probes == server.hellos() - before);
+    CHECK(serial.probes == 3 + (tls12.size() + 1) + (tls13.size() + 1));
+    // 拆分后每轮的候选列表更短，总轮数更少，但被拒绝的分支更多
+    CHECK(result.probes >= serial.probes);
+
+    std::cout << "套件枚举测试完成" << std::endl;
+}
+
+void testUnreachable() {
+    std::cout << "\n=== 测试端点不可达 ===" << std::endl;
+
+    // 拿到一个空闲端口后关闭监听，连接被拒绝
+    uint16_t port;
+    {
+        Socket listener(AF_INET, SOCK_STREAM);
+        listener.bind(IPAddress("127.0.0.1"), 0);
+        port = listener.getLocalPort();
+    }
+    CipherEnumConfig config;
+    config.versions = {TLS_VERSION_1_2};
+    CipherEnumResult result = enumerate(port, config);
+    CHECK(!result.ok());
+    CHECK(result.versions.empty());
+    // 连接失败先重试，重试后仍失败记为不确定
+    CHECK(result.probes == static_cast<size_t>(config.maxRetries + 1));
+    CHECK(result.inconclusive == 1);
+
+    std::cout << "端点不可达测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 密码套件枚举测试" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    try {
+        NetworkUtils::initialize();
+        testEnumeration();
+        testUnreachable();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../src/engines/service/conversation.h"
+
+using namespace MindSploit::Service;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+void testLineAndCoded() {
+    std::cout << "=== 测试单行和应答码应答 ===" << std::endl;
+
+    ReplyMatcher line = ReplyMatcher::line();
+    CHECK(line.match("") == 0);
+    CHECK(line.match("+PONG") == 0);
+    CHECK(line.match("+PONG\r\n$5\r\n") == 7);
+    CHECK(line.match("\n") == 1);
+
+    ReplyMatcher coded = ReplyMatcher::coded();
+    CHECK(coded.match("220 mail.example ESMTP\r\n") == 24);
+    CHECK(coded.match("220 mail.example ESMTP") == 0);
+    // 不是应答码的行按单行处理
+    CHECK(coded.match("SSH-2.0-OpenSSH\r\n") == 17);
+
+    const std::string ehlo =
+        "250-mail.example\r\n"
+        "250-PIPELINING\r\n"
+        "250-STARTTLS\r\n"
+        "250 SIZE 10240000\r\n"
+        "MAIL FROM";
+    CHECK(coded.match(ehlo) == ehlo.size() - 9);
+    // 续行未结束前不完整
+    for (size_t length = 0; length < ehlo.size() - 9; ++length) {
+        CHECK(coded.match(std::string_view(ehlo).substr(0, length)) == 0);
+    }
+
+    // FTP的FEAT列表: 续行不带应答码，以同一应答码加空格的行结束; 其它应答码的行不结束应答
+    const std::string feat =
+        "211-Features:\r\n"
+        " MDTM\r\n"
+        "212 not the end\r\n"
+        " UTF8\r\n"
+        "211 End\r\n";
+    CHECK(coded.match(feat) == feat.size());
+    CHECK(coded.match(std::string_view(feat).substr(0, feat.size() - 9)) == 0);
+
+    std::cout << "单行和应答码测试完成" << std::endl;
+}
+
+void testDotTerminatedAndTagged() {
+    std::cout << "\n=== 测试点结尾和带标签应答 ===" << std::endl;
+
+    ReplyMatcher pop3 = ReplyMatcher::dotTerminated();
+    const std::string capa = "+OK Capability list follows\r\nUSER\r\nSTLS\r\n.\r\n";
+    CHECK(pop3.match(capa + "+OK next") == capa.size());
+    CHECK(pop3.match(capa.substr(0, capa.size() - 1)) == 0);
+    // "-ERR"只有一行; 行内的点不是结束标记
+    CHECK(pop3.match("-ERR unknown command\r\n.\r\n") == 22);
+    CHECK(pop3.match("+OK\n..escaped\n.\n") == 16);
+
+    ReplyMatcher imap = ReplyMatcher::tagged("a1 ");
+    const std::string reply =
+        "* CAPABILITY IMAP4rev1 STARTTLS\r\n"
+        "a1 OK CAPABILITY completed\r\n";
+    CHECK(imap.match(reply + "* BYE") == reply.size());
+    CHECK(imap.match("* CAPABILITY IMAP4rev1\r\n") == 0);
+    CHECK(imap.match("a1 BAD\r\n") == 8);
+    // 标签必须在行首
+    CHECK(imap.match("* OK xa1 \r\n") == 0);
+
+    std::cout << "点结尾和带标签测试完成" << std::endl;
+}
+
+int greeting(ServiceInfo& info, std::string_view reply) {
+    if (reply.compare(0, 4, "220 ") != 0) {
+        return ConversationScript::FAILED;
+    }
+    info.service = "smtp";
+    return 1;
+}
+
+int capabilities(ServiceInfo& info, std::string_view reply) {
+    size_t start = 0;
+    while (start < reply.size()) {
+        size_t end = reply.find('\n', start);
+        std::string_view line = reply.substr(start + 4, end - start - 5);
+        if (start > 0) {
+            info.capabilities.emplace_back(line);
+        }
+        start = end + 1;
+    }
+    return ConversationScript::DONE;
+}
+
+void testDialog() {
+    std::cout << "\n=== 测试多步对话 ===" << std::endl;
+
+    ConversationScript script;
+    script.name = "smtp";
+    script.steps = {
+        {"", ReplyMatcher::coded(), greeting, std::chrono::milliseconds(0)},
+        {"EHLO mindsploit\r\n", ReplyMatcher::coded(), capabilities, std::chrono::milliseconds(0)},
+    };
+
+    auto dialog = std::make_unique<ConversationDialog>(script);
+    CHECK(dialog->request().empty());
+
+    size_t consumed = 0;
+    std::string_view output;
+    CHECK(dialog->receive("220 mail.exa", consumed, output) == ServiceDialog::Status::NEED_MORE);
+    CHECK(consumed == 0);
+
+    std::string input = "220 mail.example ESMTP\r\n250-mail.example";
+    CHECK(dialog->receive(input, consumed, output) == ServiceDialog::Status::SEND);
+    CHECK(consumed == 24);
+    CHECK(output == "EHLO mindsploit\r\n");
+
+    input = input.substr(consumed) + "\r\n250-STARTTLS\r\n250 8BITMIME\r\n";
+    CHECK(dialog->receive(input, consumed, output) == ServiceDialog::Status::DONE);
+    CHECK(consumed == input.size());
+    CHECK(dialog->info().service == "smtp");
+    CHECK((dialog->info().capabilities == std::vector<std::string>{"STARTTLS", "8BITMIME"}));
+
+    // 不符合脚本的应答
+    auto other = std::make_unique<ConversationDialog>(script);
+    CHECK(other->receive("SSH-2.0-OpenSSH\r\n", consumed, output) == ServiceDialog::Status::FAILED);
+    CHECK(!other->error().empty());
+    CHECK(other->closed("") == ServiceDialog::Status::FAILED);
+
+    // 对象池: 归还的块被复用
+    size_t pooled = ConversationDialog::pooled();
+    dialog.reset();
+    other.reset();
+    auto reused = std::make_unique<ConversationDialog>(script);
+    CHECK(ConversationDialog::pooled() == pooled);
+
+    std::cout << "多步对话测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 对话脚本测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    try {
+        testLineAndCoded();
+        testDotTerminatedAndTagged();
+        testDialog();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
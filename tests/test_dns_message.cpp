@@ -0,0 +1,203 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/engines/dns/dns_message.h"
+
+using namespace MindSploit::Dns;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 按网络字节序拼装报文
+class Packet {
+public:
+    Packet& u8(uint8_t value) { m_data.push_back(value); return *this; }
+    Packet& u16(uint16_t value) { return u8(static_cast<uint8_t>(value >> 8)).u8(static_cast<uint8_t>(value)); }
+    Packet& u32(uint32_t value) { return u16(static_cast<uint16_t>(value >> 16)).u16(static_cast<uint16_t>(value)); }
+    Packet& bytes(const std::string& text) { m_data.insert(m_data.end(), text.begin(), text.end()); return *this; }
+    // 未压缩的名字
+    Packet& name(const std::string& text) {
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t dot = text.find('.', start);
+            if (dot == std::string::npos) dot = text.size();
+            u8(static_cast<uint8_t>(dot - start)).bytes(text.substr(start, dot - start));
+            start = dot + 1;
+        }
+        return u8(0);
+    }
+    Packet& pointer(uint16_t offset) { return u16(static_cast<uint16_t>(0xc000 | offset)); }
+    // 资源记录首部 (名字之后): 类型、类IN、TTL、数据长度
+    Packet& record(uint16_t type, uint32_t ttl, uint16_t dataLength) {
+        return u16(type).u16(1).u32(ttl).u16(dataLength);
+    }
+
+    size_t size() const { return m_data.size(); }
+    const uint8_t* data() const { return m_data.data(); }
+    std::vector<uint8_t>& raw() { return m_data; }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+void testNames() {
+    std::cout << "=== 测试域名规范化 ===" << std::endl;
+
+    std::string name;
+    CHECK(normalizeDnsName("WWW.Example.COM.", name) && name == "www.example.com");
+    CHECK(normalizeDnsName("_dmarc.example.com", name) && name == "_dmarc.example.com");
+    CHECK(normalizeDnsName("my-host.example.com", name));
+    CHECK(!normalizeDnsName("", name));
+    CHECK(!normalizeDnsName(".", name));
+    CHECK(!normalizeDnsName("a..b", name));
+    CHECK(!normalizeDnsName(".example.com", name));
+    CHECK(!normalizeDnsName("bad name.com", name));
+    CHECK(!normalizeDnsName(std::string(64, 'a') + ".com", name));
+    CHECK(normalizeDnsName(std::string(63, 'a') + ".com", name));
+
+    std::string longName;
+    for (int i = 0; i < 63; ++i) {
+        longName += "abc.";
+    }
+    CHECK(!normalizeDnsName(longName + "example", name));
+
+    uint16_t type = 0;
+    CHECK(parseDnsType("aaaa", type) && type == TYPE_AAAA);
+    CHECK(!parseDnsType("OPT", type));
+    CHECK(dnsTypeName(99) == "TYPE99");
+    CHECK(dnsRcodeName(RCODE_NXDOMAIN) == "NXDOMAIN");
+
+    std::cout << "域名测试完成" << std::endl;
+}
+
+void testQuery() {
+    std::cout << "\n=== 测试查询编码 ===" << std::endl;
+
+    uint8_t buffer[DNS_QUERY_MAX];
+    size_t length = encodeDnsQuery(0xbeef, "www.example.com", TYPE_AAAA, buffer, sizeof(buffer));
+    Packet expected;
+    expected.u16(0xbeef).u16(0x0100).u16(1).u16(0).u16(0).u16(1)
+            .name("www.example.com").u16(TYPE_AAAA).u16(1)
+            .u8(0).u16(TYPE_OPT).u16(DNS_UDP_PAYLOAD).u32(0).u16(0);
+    CHECK(length == expected.size());
+    CHECK(std::vector<uint8_t>(buffer, buffer + length) == expected.raw());
+
+    CHECK(encodeDnsQuery(1, "www.example.com", TYPE_A, buffer, 20) == 0);
+    CHECK(encodeDnsQuery(1, "a..b", TYPE_A, buffer, sizeof(buffer)) == 0);
+    CHECK(encodeDnsQuery(1, "", TYPE_A, buffer, sizeof(buffer)) == 0);
+
+    // 最长的名字也能放进DNS_QUERY_MAX
+    std::string longest;
+    while (longest.size() + 4 <= 253) {
+        longest += longest.empty() ? "abc" : ".abc";
+    }
+    CHECK(encodeDnsQuery(1, longest, TYPE_A, buffer, sizeof(buffer)) > 0);
+
+    std::cout << "查询编码测试完成" << std::endl;
+}
+
+void testResponse() {
+    std::cout << "\n=== 测试应答解析 ===" << std::endl;
+
+    Packet packet;
+    packet.u16(0x1234).u16(0x8180).u16(1).u16(6).u16(0).u16(0);
+    packet.name("WWW.Example.com").u16(TYPE_A).u16(1);
+    // www.example.com CNAME web.example.com (压缩指向问题中的example.com)
+    packet.pointer(12).record(TYPE_CNAME, 300, 6).u8(3).bytes("web").pointer(16);
+    size_t web = packet.size() - 6;
+    packet.pointer(static_cast<uint16_t>(web)).record(TYPE_A, 60, 4).u8(192).u8(0).u8(2).u8(1);
+    packet.pointer(static_cast<uint16_t>(web)).record(TYPE_AAAA, 60, 16).u16(0x2001).u16(0x0db8);
+    for (int i = 0; i < 5; ++i) packet.u16(0);
+    packet.u16(1);
+    packet.pointer(16).record(TYPE_MX, 3600, 9).u16(10).u8(4).bytes("mail").pointer(16);
+    packet.pointer(16).record(TYPE_TXT, 3600, 14).u8(6).bytes("v=spf1").u8(6).bytes(" -all.");
+    packet.pointer(16).record(TYPE_SOA, 3600, 2).u16(0);
+
+    DnsResponse response;
+    CHECK(parseDnsResponse(packet.data(), packet.size(), response));
+    CHECK(response.id == 0x1234);
+    CHECK(response.rcode == RCODE_NOERROR);
+    CHECK(!response.truncated);
+    CHECK(response.question == "www.example.com");
+    CHECK(response.questionType == TYPE_A);
+    CHECK(response.answers.size() == 6);
+    if (response.answers.size() == 6) {
+        CHECK(response.answers[0].name == "www.example.com");
+        CHECK(response.answers[0].type == TYPE_CNAME);
+        CHECK(response.answers[0].ttl == 300);
+        CHECK(response.answers[0].data == "web.example.com");
+        CHECK(response.answers[1].name == "web.example.com");
+        CHECK(response.answers[1].data == "192.0.2.1");
+        CHECK(response.answers[2].data == "2001:db8::1");
+        CHECK(response.answers[3].data == "10 mail.example.com");
+        CHECK(response.answers[4].data == "v=spf1 -all.");
+        CHECK(response.answers[5].type == TYPE_SOA);
+        CHECK(response.answers[5].data.empty());
+    }
+
+    // 任何位置截断都返回false而不越界
+    bool truncatedRejected = true;
+    for (size_t length = 0; length < packet.size(); ++length) {
+        DnsResponse partial;
+        truncatedRejected = truncatedRejected && !parseDnsResponse(packet.data(), length, partial);
+    }
+    CHECK(truncatedRejected);
+
+    // NXDOMAIN和TC位
+    Packet nxdomain;
+    nxdomain.u16(7).u16(0x8383).u16(1).u16(0).u16(0).u16(0).name("nope.example.com").u16(TYPE_A).u16(1);
+    CHECK(parseDnsResponse(nxdomain.data(), nxdomain.size(), response));
+    CHECK(response.rcode == RCODE_NXDOMAIN);
+    CHECK(response.truncated);
+    CHECK(response.answers.empty());
+
+    // 查询报文不是应答
+    Packet query;
+    query.u16(7).u16(0x0100).u16(1).u16(0).u16(0).u16(0).name("example.com").u16(TYPE_A).u16(1);
+    CHECK(!parseDnsResponse(query.data(), query.size(), response));
+
+    // 压缩指针构成的环
+    Packet loop;
+    loop.u16(7).u16(0x8180).u16(1).u16(0).u16(0).u16(0).pointer(12).u16(TYPE_A).u16(1);
+    CHECK(!parseDnsResponse(loop.data(), loop.size(), response));
+
+    // 保留的标签类型 (0x40/0x80)
+    Packet reserved;
+    reserved.u16(7).u16(0x8180).u16(1).u16(0).u16(0).u16(0).u8(0x41).bytes("a").u8(0).u16(TYPE_A).u16(1);
+    CHECK(!parseDnsResponse(reserved.data(), reserved.size(), response));
+
+    // TXT字符串长度超出记录
+    Packet badTxt;
+    badTxt.u16(7).u16(0x8180).u16(0).u16(1).u16(0).u16(0).name("example.com").record(TYPE_TXT, 1, 3).u8(5).bytes("ab");
+    CHECK(!parseDnsResponse(badTxt.data(), badTxt.size(), response));
+
+    std::cout << "应答解析测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit DNS报文测试" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    try {
+        testNames();
+        testQuery();
+        testResponse();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <string>
+#include "../src/engines/network/host_guard.h"
+
+using namespace MindSploit::Network;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 发出count个探测，返回被允许的数量
+int admitMany(HostGuard& guard, const std::string& host, int count) {
+    int admitted = 0;
+    for (int i = 0; i < count; ++i) {
+        admitted += guard.admit(host) ? 1 : 0;
+    }
+    return admitted;
+}
+
+void testOrdinaryHosts() {
+    std::cout << "=== 测试普通主机不被标记 ===" << std::endl;
+
+    HostGuard guard;
+
+    // DROP防火墙后的主机: 大量探测超时，超时不计入时间预算
+    CHECK(admitMany(guard, "10.0.0.1", 5000) == 5000);
+    guard.recordOpen("10.0.0.1", 12.0, -1);
+    guard.recordSpent("10.0.0.1", 800.0, true);
+    CHECK(!guard.flagged("10.0.0.1"));
+    CHECK(guard.verdict("10.0.0.1") == HostVerdict::NORMAL);
+
+    // 开放端口很多但握手时间分散、给出横幅
+    for (int i = 0; i < 100; ++i) {
+        CHECK(guard.admit("10.0.0.2"));
+        if (i % 3 == 0) {
+            guard.recordOpen("10.0.0.2", 5.0 + (i % 7) * 3.0, 64240);
+            guard.recordSpent("10.0.0.2", 20.0, i % 2 == 0);
+        }
+    }
+    CHECK(!guard.flagged("10.0.0.2"));
+    CHECK(!guard.flagged("10.0.0.3"));
+    CHECK(guard.suspiciousHosts().empty());
+    CHECK(guard.skipped() == 0);
+
+    std::cout << "普通主机测试完成" << std::endl;
+}
+
+void testTarpits() {
+    std::cout << "\n=== 测试tarpit判定 ===" << std::endl;
+
+    HostGuardConfig config;
+    config.flaggedSamples = 4;
+    HostGuard guard(config);
+
+    // 抽样中几乎所有端口开放
+    for (uint32_t i = 0; i < config.sampleSize; ++i) {
+        CHECK(guard.admit("10.0.1.1"));
+        guard.recordOpen("10.0.1.1", -1.0, -1);
+    }
+    CHECK(guard.verdict("10.0.1.1") == HostVerdict::ALL_OPEN);
+    CHECK(guard.isTarpit("10.0.1.1"));
+    // 标记后只再抽样flaggedSamples个端口
+    CHECK(admitMany(guard, "10.0.1.1", 100) == 4);
+
+    // 握手时间几乎相同且没有横幅
+    for (int i = 0; i < 32; ++i) {
+        CHECK(guard.admit("10.0.1.2"));
+        if (i % 2 == 0) {
+            guard.recordOpen("10.0.1.2", 10.0 + (i % 4) * 0.01, 29200);
+        }
+    }
+    CHECK(guard.verdict("10.0.1.2") == HostVerdict::UNIFORM_TIMING);
+
+    // 同样均匀但有横幅的不是伪造协议栈
+    for (int i = 0; i < 32; ++i) {
+        guard.admit("10.0.1.3");
+        if (i % 2 == 0) {
+            guard.recordOpen("10.0.1.3", 10.0, 29200);
+            guard.recordSpent("10.0.1.3", 1.0, i == 0);
+        }
+    }
+    CHECK(!guard.flagged("10.0.1.3"));
+
+    // LaBrea式零窗口
+    guard.admit("10.0.1.4");
+    guard.recordOpen("10.0.1.4", 3.0, 0);
+    CHECK(!guard.flagged("10.0.1.4"));
+    guard.admit("10.0.1.4");
+    guard.recordOpen("10.0.1.4", 3.0, 0);
+    CHECK(guard.verdict("10.0.1.4") == HostVerdict::ZERO_WINDOW);
+    CHECK(guard.isTarpit("10.0.1.4"));
+
+    auto hosts = guard.suspiciousHosts();
+    CHECK(hosts.size() == 3);
+    if (hosts.size() == 3) {
+        CHECK(hosts[0].host == "10.0.1.1");
+        CHECK(hosts[0].verdict == HostVerdict::ALL_OPEN);
+        CHECK(hosts[0].probed == config.sampleSize + 4);
+        CHECK(hosts[0].skipped == 96);
+        CHECK(hosts[2].host == "10.0.1.4");
+    }
+    CHECK(guard.skipped() == 96);
+    CHECK(hostVerdictName(HostVerdict::UNIFORM_TIMING) == "uniform-timing");
+
+    std::cout << "tarpit测试完成" << std::endl;
+}
+
+void testTimeBudget() {
+    std::cout << "\n=== 测试主机时间预算 ===" << std::endl;
+
+    HostGuardConfig config;
+    config.hostBudget = std::chrono::milliseconds(1000);
+    HostGuard guard(config);
+
+    // 只有已建立连接上等待横幅的时间计入
+    CHECK(admitMany(guard, "10.0.2.1", 10) == 10);
+    guard.recordOpen("10.0.2.1", 2.0, -1);
+    guard.recordSpent("10.0.2.1", 600.0, false);
+    CHECK(!guard.flagged("10.0.2.1"));
+    guard.recordOpen("10.0.2.1", 9.0, -1);
+    guard.recordSpent("10.0.2.1", 600.0, true);
+    CHECK(guard.verdict("10.0.2.1") == HostVerdict::TIME_BUDGET);
+    CHECK(guard.flagged("10.0.2.1"));
+    // 超时不是tarpit判定: 已发现的开放端口照常报告，只是不再探测
+    CHECK(!guard.isTarpit("10.0.2.1"));
+    CHECK(!guard.admit("10.0.2.1"));
+
+    // 已标记为tarpit的主机超出预算后抽样也停止
+    for (uint32_t i = 0; i < config.sampleSize; ++i) {
+        guard.admit("10.0.2.2");
+        guard.recordOpen("10.0.2.2", -1.0, -1);
+    }
+    CHECK(guard.verdict("10.0.2.2") == HostVerdict::ALL_OPEN);
+    CHECK(guard.admit("10.0.2.2"));
+    guard.recordSpent("10.0.2.2", 2000.0, false);
+    CHECK(guard.verdict("10.0.2.2") == HostVerdict::ALL_OPEN);
+    CHECK(!guard.admit("10.0.2.2"));
+
+    // 预算为0时不限
+    HostGuardConfig unlimitedConfig;
+    unlimitedConfig.hostBudget = std::chrono::milliseconds(0);
+    HostGuard unlimited(unlimitedConfig);
+    unlimited.admit("10.0.2.3");
+    unlimited.recordOpen("10.0.2.3", 5.0, -1);
+    unlimited.recordSpent("10.0.2.3", 1e9, true);
+    CHECK(!unlimited.flagged("10.0.2.3"));
+
+    std::cout << "时间预算测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 主机检测测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    try {
+        testOrdinaryHosts();
+        testTarpits();
+        testTimeBudget();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <string>
+#include "../src/engines/web/http_parser.h"
+
+using namespace MindSploit::Web;
+using Result = HttpResponseParser::Result;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 按接收顺序每次追加step字节，未消费的数据留在缓冲区开头，与HTTP客户端的用法相同
+// rest返回响应完成后属于下一个响应的数据
+Result feedInSteps(HttpResponseParser& parser, const std::string& input, size_t step, std::string* rest = nullptr) {
+    std::string pending;
+    size_t position = 0;
+    while (true) {
+        size_t take = std::min(step, input.size() - position);
+        pending.append(input, position, take);
+        position += take;
+
+        size_t consumed = 0;
+        Result result = parser.feed(pending.data(), pending.size(), consumed);
+        pending.erase(0, consumed);
+        if (result != Result::NEED_MORE) {
+            if (rest != nullptr) {
+                *rest = pending + input.substr(position);
+            }
+            return result;
+        }
+        if (position == input.size()) {
+            return Result::NEED_MORE;
+        }
+    }
+}
+
+void testContentLength() {
+    std::cout << "=== 测试Content-Length响应 ===" << std::endl;
+
+    const std::string input =
+        "HTTP/1.1 200 OK\r\n"
+        "Server:  nginx \r\n"
+        "content-length: 11\r\n"
+        "\r\n"
+        "hello world";
+
+    for (size_t step : {input.size(), size_t(1), size_t(7)}) {
+        HttpResponseParser parser;
+        parser.reset(false);
+        CHECK(feedInSteps(parser, input, step) == Result::COMPLETE);
+        HttpResponse& response = parser.response();
+        CHECK(response.status == 200);
+        CHECK(response.version() == "HTTP/1.1");
+        CHECK(response.reason() == "OK");
+        CHECK(response.headerCount() == 2);
+        CHECK(response.header("SERVER") == "nginx");
+        CHECK(response.header("X-Missing").empty());
+        CHECK(response.body() == "hello world");
+        CHECK(parser.keepAlive());
+    }
+
+    // HEAD请求的响应没有响应体; HTTP/1.0默认不保持连接
+    HttpResponseParser head;
+    head.reset(true);
+    std::string rest;
+    CHECK(feedInSteps(head, "HTTP/1.0 200 OK\r\nContent-Length: 5\r\n\r\nnext", 64, &rest) == Result::COMPLETE);
+    CHECK(head.response().body().empty());
+    CHECK(!head.keepAlive());
+    CHECK(rest == "next");
+
+    std::cout << "Content-Length测试完成" << std::endl;
+}
+
+void testChunked() {
+    std::cout << "\n=== 测试chunked响应 ===" << std::endl;
+
+    const std::string input =
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: gzip, Chunked\r\n"
+        "Connection: close\r\n"
+        "\r\n"
+        "4\r\nWiki\r\n"
+        "6;name=value\r\npedia \r\n"
+        "E\r\nin \r\n\r\nchunks.\r\n"
+        "0\r\n"
+        "Expires: never\r\n"
+        "\r\n"
+        "HTTP/1.1 204 No Content\r\n\r\n";
+
+    // 逐字节输入覆盖所有跨边界的位置: 长度行、数据、CRLF和尾部首部
+    for (size_t step : {input.size(), size_t(1), size_t(3), size_t(16)}) {
+        HttpResponseParser parser;
+        parser.reset(false);
+        std::string rest;
+        CHECK(feedInSteps(parser, input, step, &rest) == Result::COMPLETE);
+        CHECK(parser.response().body() == "Wikipedia in \r\n\r\nchunks.");
+        CHECK(!parser.keepAlive());
+        CHECK(rest == "HTTP/1.1 204 No Content\r\n\r\n");
+
+        // 剩余数据是流水线中的下一个响应
+        parser.reset(false);
+        CHECK(feedInSteps(parser, rest, step) == Result::COMPLETE);
+        CHECK(parser.response().status == 204);
+        CHECK(parser.response().body().empty());
+    }
+
+    // 响应体超过上限时截断，但仍完整消费chunk
+    HttpResponseParser limited(8);
+    limited.reset(false);
+    CHECK(feedInSteps(limited, input, 5) == Result::COMPLETE);
+    CHECK(limited.response().body() == "Wikipedi");
+    CHECK(limited.response().truncated);
+
+    HttpResponseParser invalid;
+    invalid.reset(false);
+    CHECK(feedInSteps(invalid, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n", 1) ==
+          Result::PARSE_ERROR);
+    invalid.reset(false);
+    CHECK(feedInSteps(invalid, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n1000000000000000\r\n", 4) ==
+          Result::PARSE_ERROR);
+
+    // 连接在chunk中途关闭
+    HttpResponseParser cut;
+    cut.reset(false);
+    CHECK(feedInSteps(cut, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n8\r\nabc", 2) == Result::NEED_MORE);
+    CHECK(cut.finish() == Result::PARSE_ERROR);
+
+    std::cout << "chunked测试完成" << std::endl;
+}
+
+void testOtherBodies() {
+    std::cout << "\n=== 测试其它响应形式 ===" << std::endl;
+
+    // 1xx中间响应被跳过
+    HttpResponseParser interim;
+    interim.reset(false);
+    CHECK(feedInSteps(interim, "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 201 Created\r\nContent-Length: 2\r\n\r\nok", 5) ==
+          Result::COMPLETE);
+    CHECK(interim.response().status == 201);
+    CHECK(interim.response().body() == "ok");
+
+    // 没有长度信息时读到连接关闭; 响应前的空行被容忍，"\n\n"也可以结束首部
+    HttpResponseParser untilClose;
+    untilClose.reset(false);
+    CHECK(!untilClose.started());
+    CHECK(feedInSteps(untilClose, "\r\nHTTP/1.1 404 Not Found\nServer: x\n\nbody text", 3) == Result::NEED_MORE);
+    CHECK(untilClose.started());
+    CHECK(untilClose.finish() == Result::COMPLETE);
+    CHECK(untilClose.response().status == 404);
+    CHECK(untilClose.response().reason() == "Not Found");
+    CHECK(untilClose.response().body() == "body text");
+    CHECK(!untilClose.keepAlive());
+
+    HttpResponseParser invalid;
+    invalid.reset(false);
+    CHECK(feedInSteps(invalid, "SSH-2.0-OpenSSH_9.6\r\n\r\n", 64) == Result::PARSE_ERROR);
+    invalid.reset(false);
+    CHECK(feedInSteps(invalid, "HTTP/1.1 200 OK\r\nno colon here\r\n\r\n", 64) == Result::PARSE_ERROR);
+    invalid.reset(false);
+    CHECK(feedInSteps(invalid, "HTTP/1.1 2x0 OK\r\n\r\n", 64) == Result::PARSE_ERROR);
+
+    std::cout << "其它响应测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit HTTP解析器测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    try {
+        testContentLength();
+        testChunked();
+        testOtherBodies();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
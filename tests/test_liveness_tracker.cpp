@@ -0,0 +1,260 @@
+#include <iostream>
+#include <string>
+#include "../src/engines/network/liveness_tracker.h"
+
+using namespace MindSploit::Network;
+using MindSploit::Utils::IPAddress;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 在index处探测host并记录超时
+void probeTimeout(LivenessTracker& tracker, const IPAddress& host, uint64_t index) {
+    CHECK(tracker.admit(host, index) == ProbeDecision::PROBE);
+    tracker.recordTimeout(host);
+}
+
+void testLevels() {
+    std::cout << "=== 测试激进程度 ===" << std::endl;
+
+    LivenessLevel level;
+    CHECK(parseLivenessLevel("medium", level) && level == LivenessLevel::MEDIUM);
+    CHECK(!parseLivenessLevel("max", level));
+
+    LivenessConfig low = LivenessConfig::forLevel(LivenessLevel::LOW);
+    CHECK(!low.skipHosts && !low.skipSubnets);
+    LivenessConfig medium = LivenessConfig::forLevel(LivenessLevel::MEDIUM);
+    CHECK(medium.skipHosts && !medium.skipSubnets);
+    LivenessConfig high = LivenessConfig::forLevel(LivenessLevel::HIGH);
+    CHECK(high.skipHosts && high.skipSubnets);
+    CHECK(high.hostTimeouts < medium.hostTimeouts && medium.hostTimeouts < low.hostTimeouts);
+
+    // off从不作出决定
+    LivenessTracker off(LivenessConfig::forLevel(LivenessLevel::OFF));
+    IPAddress host("10.0.0.1");
+    for (uint64_t i = 0; i < 1000; ++i) {
+        probeTimeout(off, host, i);
+    }
+    CHECK(!off.hasDeferred());
+    CHECK(off.decisions().empty());
+
+    std::cout << "激进程度测试完成" << std::endl;
+}
+
+void testSilentHosts() {
+    std::cout << "\n=== 测试沉寂主机 ===" << std::endl;
+
+    // low: 推迟，第二遍只补做第一遍没有探测过的位置
+    LivenessConfig config = LivenessConfig::forLevel(LivenessLevel::LOW);
+    LivenessTracker low(config);
+    IPAddress host("10.0.0.1");
+    for (uint64_t i = 0; i < config.hostTimeouts; ++i) {
+        probeTimeout(low, host, i);
+    }
+    CHECK(low.admit(host, 100) == ProbeDecision::DEFER);
+    CHECK(low.admit(host, 101) == ProbeDecision::DEFER);
+    CHECK(low.hasDeferred());
+    CHECK(low.admitDeferred(host, 100));
+    CHECK(low.admitDeferred(host, 101));
+    CHECK(!low.admitDeferred(host, 0));
+    // 其它主机不受影响
+    CHECK(low.admit(IPAddress("10.0.0.2"), 200) == ProbeDecision::PROBE);
+    CHECK(!low.admitDeferred(IPAddress("10.0.0.2"), 201));
+
+    auto decisions = low.decisions();
+    CHECK(decisions.size() == 1);
+    if (decisions.size() == 1) {
+        CHECK(decisions[0].scope == "host");
+        CHECK(decisions[0].target == "10.0.0.1");
+        CHECK(decisions[0].action == ProbeDecision::DEFER);
+        CHECK(decisions[0].timeouts == config.hostTimeouts);
+        CHECK(decisions[0].deferred == 2);
+        CHECK(decisions[0].revisited == 2);
+    }
+    CHECK(low.getStats().deadHosts == 1);
+
+    // 有RST或ICMP应答的主机不会被判定沉寂
+    LivenessTracker answered(config);
+    IPAddress closed("10.0.0.3");
+    answered.admit(closed, 0);
+    answered.recordAlive(closed);
+    for (uint64_t i = 1; i < 100; ++i) {
+        probeTimeout(answered, closed, i);
+    }
+    CHECK(answered.decisions().empty());
+
+    // medium: 直接放弃
+    LivenessConfig mediumConfig = LivenessConfig::forLevel(LivenessLevel::MEDIUM);
+    LivenessTracker medium(mediumConfig);
+    for (uint64_t i = 0; i < mediumConfig.hostTimeouts; ++i) {
+        probeTimeout(medium, host, i);
+    }
+    CHECK(medium.admit(host, 50) == ProbeDecision::SKIP);
+    CHECK(!medium.hasDeferred());
+    CHECK(!medium.admitDeferred(host, 50));
+    CHECK(medium.getStats().skipped == 1);
+
+    std::cout << "沉寂主机测试完成" << std::endl;
+}
+
+void testSilentSubnets() {
+    std::cout << "\n=== 测试沉寂子网 ===" << std::endl;
+
+    LivenessConfig config = LivenessConfig::forLevel(LivenessLevel::HIGH);
+    config.hostTimeouts = 100;      // 只测试子网判定
+    LivenessTracker tracker(config);
+
+    uint64_t index = 0;
+    for (uint32_t host = 1; host <= config.subnetHosts; ++host) {
+        for (uint32_t i = 0; i < config.subnetTimeouts / config.subnetHosts; ++i) {
+            probeTimeout(tracker, IPAddress("10.1.2." + std::to_string(host)), index++);
+        }
+    }
+    CHECK(tracker.admit(IPAddress("10.1.2.200"), index++) == ProbeDecision::SKIP);
+    CHECK(tracker.admit(IPAddress("10.1.3.1"), index++) == ProbeDecision::PROBE);
+
+    auto decisions = tracker.decisions();
+    CHECK(decisions.size() == 1);
+    if (decisions.size() == 1) {
+        CHECK(decisions[0].scope == "subnet");
+        CHECK(decisions[0].target == "10.1.2.0/24");
+        CHECK(decisions[0].hosts == config.subnetHosts);
+        CHECK(decisions[0].action == ProbeDecision::SKIP);
+    }
+
+    // 子网内有任何应答就不会判定
+    LivenessTracker alive(config);
+    alive.admit(IPAddress("10.1.2.9"), 0);
+    alive.recordAlive(IPAddress("10.1.2.9"));
+    index = 1;
+    for (uint32_t host = 1; host <= 64; ++host) {
+        probeTimeout(alive, IPAddress("10.1.2." + std::to_string(host + 10)), index++);
+    }
+    CHECK(alive.decisions().empty());
+
+    // IPv6按/64聚合
+    LivenessTracker v6(config);
+    index = 0;
+    for (uint32_t host = 1; host <= config.subnetHosts; ++host) {
+        for (uint32_t i = 0; i < config.subnetTimeouts / config.subnetHosts; ++i) {
+            IPAddress address("2001:db8:0:1::" + std::to_string(host));
+            address.isIPv6 = true;
+            probeTimeout(v6, address, index++);
+        }
+    }
+    decisions = v6.decisions();
+    CHECK(decisions.size() == 1 && decisions[0].target == "2001:db8:0:1::/64");
+
+    std::cout << "沉寂子网测试完成" << std::endl;
+}
+
+void testLateAnswers() {
+    std::cout << "\n=== 测试判定之后才有应答的主机 ===" << std::endl;
+
+    LivenessConfig config = LivenessConfig::forLevel(LivenessLevel::LOW);
+    config.hostTimeouts = 100;
+    config.subnetHosts = 2;
+    config.subnetTimeouts = 4;
+    LivenessTracker tracker(config);
+    IPAddress early("10.2.0.1");
+    IPAddress late("10.2.0.2");
+    IPAddress silent("10.2.0.3");
+
+    // early的探测在子网判定前发出，应答在判定之后才到达
+    CHECK(tracker.admit(early, 0) == ProbeDecision::PROBE);
+    // late和silent的探测超时，子网随之被判定沉寂 (推迟)
+    probeTimeout(tracker, late, 1);
+    probeTimeout(tracker, late, 2);
+    probeTimeout(tracker, silent, 3);
+    probeTimeout(tracker, silent, 4);
+    CHECK(tracker.decisions().size() == 1);
+    tracker.recordAlive(early);
+
+    // 已有应答的主机不受子网判定约束，其它主机仍按判定推迟
+    CHECK(tracker.admit(early, 5) == ProbeDecision::PROBE);
+    CHECK(tracker.admit(silent, 6) == ProbeDecision::DEFER);
+    CHECK(tracker.admit(late, 7) == ProbeDecision::DEFER);
+
+    // late之后有了应答: 余下的端口照常探测
+    tracker.recordAlive(late);
+    CHECK(tracker.admit(late, 8) == ProbeDecision::PROBE);
+    CHECK(tracker.admit(late, 9) == ProbeDecision::PROBE);
+
+    // 第二遍: 只补做被推迟的位置
+    CHECK(!tracker.admitDeferred(early, 0));
+    CHECK(!tracker.admitDeferred(early, 5));
+    CHECK(!tracker.admitDeferred(late, 1));
+    CHECK(!tracker.admitDeferred(late, 2));
+    CHECK(tracker.admitDeferred(late, 7));
+    CHECK(!tracker.admitDeferred(late, 8));
+    CHECK(!tracker.admitDeferred(late, 9));
+    CHECK(tracker.admitDeferred(silent, 6));
+    CHECK(!tracker.admitDeferred(silent, 3));
+
+    // 主机自身被判定沉寂后又有应答
+    LivenessConfig hostConfig = LivenessConfig::forLevel(LivenessLevel::MEDIUM);
+    LivenessTracker hosts(hostConfig);
+    IPAddress host("10.3.0.1");
+    for (uint64_t i = 0; i < hostConfig.hostTimeouts; ++i) {
+        probeTimeout(hosts, host, i);
+    }
+    CHECK(hosts.admit(host, 10) == ProbeDecision::SKIP);
+    hosts.recordAlive(host);
+    CHECK(hosts.admit(host, 11) == ProbeDecision::PROBE);
+
+    std::cout << "延迟应答测试完成" << std::endl;
+}
+
+void testPendingProbes() {
+    std::cout << "\n=== 测试异步探测的应答窗口 ===" << std::endl;
+
+    LivenessConfig config = LivenessConfig::forLevel(LivenessLevel::LOW);
+    config.replyWindow = std::chrono::milliseconds(0);
+    LivenessTracker tracker(config);
+    IPAddress silent("10.4.0.1");
+    IPAddress answering("10.4.0.2");
+
+    uint64_t index = 0;
+    for (uint32_t i = 0; i < config.hostTimeouts; ++i) {
+        CHECK(tracker.admit(silent, index++) == ProbeDecision::PROBE);
+        tracker.recordPending(silent);
+        CHECK(tracker.admit(answering, index++) == ProbeDecision::PROBE);
+        tracker.recordPending(answering);
+    }
+    // 应答在窗口结束前到达的探测不计为超时
+    tracker.recordAlive(answering);
+    CHECK(tracker.admit(silent, index++) == ProbeDecision::DEFER);
+    CHECK(tracker.admit(answering, index++) == ProbeDecision::PROBE);
+
+    std::cout << "应答窗口测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 存活推断测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    try {
+        testLevels();
+        testSilentHosts();
+        testSilentSubnets();
+        testLateAnswers();
+        testPendingProbes();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
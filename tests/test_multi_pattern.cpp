@@ -0,0 +1,238 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include "../src/utils/multi_pattern.h"
+#include "../src/engines/web/tech_fingerprint.h"
+
+using namespace MindSploit::Utils;
+using namespace MindSploit::Web;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+using Hit = std::pair<size_t, size_t>;     // 模式编号, 结束偏移
+
+std::vector<Hit> scanAll(const MultiPatternMatcher& matcher, const std::string& text) {
+    std::vector<Hit> hits;
+    matcher.scan(text, [&](size_t id, size_t end) { hits.emplace_back(id, end); });
+    return hits;
+}
+
+// 逐个模式逐个位置比较的参照实现，结果按 (结束偏移, 长度降序) 排列，与scan的输出顺序一致
+std::vector<Hit> naiveScan(const std::vector<std::string>& patterns, const std::string& text) {
+    auto lower = [](unsigned char c) { return std::tolower(c); };
+    std::vector<Hit> hits;
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        const std::string& pattern = patterns[id];
+        if (pattern.empty() || pattern.size() > text.size()) {
+            continue;
+        }
+        for (size_t start = 0; start + pattern.size() <= text.size(); ++start) {
+            bool match = true;
+            for (size_t k = 0; k < pattern.size() && match; ++k) {
+                match = lower(text[start + k]) == lower(pattern[k]);
+            }
+            if (match) {
+                hits.emplace_back(id, start + pattern.size());
+            }
+        }
+    }
+    std::sort(hits.begin(), hits.end(), [&](const Hit& a, const Hit& b) {
+        if (a.second != b.second) {
+            return a.second < b.second;
+        }
+        return patterns[a.first].size() > patterns[b.first].size();
+    });
+    return hits;
+}
+
+HttpResponse parseResponse(const std::string& input) {
+    HttpResponseParser parser;
+    parser.reset(false);
+    size_t consumed = 0;
+    CHECK(parser.feed(input.data(), input.size(), consumed) == HttpResponseParser::Result::COMPLETE);
+    return parser.response();
+}
+
+const TechMatch* findTech(const std::vector<TechMatch>& matches, const std::string& name) {
+    auto it = std::find_if(matches.begin(), matches.end(), [&](const TechMatch& m) { return m.name == name; });
+    return it == matches.end() ? nullptr : &*it;
+}
+
+void testMatcher() {
+    std::cout << "=== 测试多模式匹配 ===" << std::endl;
+
+    // 经典的重叠模式: 失败转移须把 she 的输出连到 he
+    MultiPatternMatcher matcher;
+    std::vector<std::string> patterns = {"he", "she", "his", "hers", ""};
+    for (const auto& pattern : patterns) {
+        matcher.add(pattern);
+    }
+    CHECK(!matcher.compiled());
+    CHECK(scanAll(matcher, "ushers").empty());
+    matcher.compile();
+    CHECK(matcher.compiled());
+    CHECK(matcher.patternCount() == 5);
+
+    std::vector<Hit> hits = scanAll(matcher, "USHers");
+    // 同一位置结束的模式从长到短
+    CHECK(hits == std::vector<Hit>({{1, 4}, {0, 4}, {3, 6}}));
+    CHECK(scanAll(matcher, "hishe") == naiveScan(patterns, "hishe"));
+    CHECK(scanAll(matcher, "").empty());
+
+    // 含非字母字节和高位字节的模式，与参照实现逐一比较
+    std::vector<std::string> mixed = {"nginx/", "x-powered", "/wp-", "wp-content", "\xff\xfe", "aaa", "aa", "a.b"};
+    MultiPatternMatcher mixedMatcher;
+    for (const auto& pattern : mixed) {
+        mixedMatcher.add(pattern);
+    }
+    mixedMatcher.compile();
+    const std::string alphabet = "aAbBnNgGiIxX/-.wWpPcCoOtTeE\xff\xfe ";
+    std::mt19937 random(12345);
+    for (int round = 0; round < 500; ++round) {
+        std::string text;
+        size_t length = random() % 64;
+        for (size_t i = 0; i < length; ++i) {
+            text += alphabet[random() % alphabet.size()];
+        }
+        if (round % 5 == 0) {
+            text.insert(random() % (text.size() + 1), mixed[random() % mixed.size()]);
+        }
+        CHECK(scanAll(mixedMatcher, text) == naiveScan(mixed, text));
+    }
+
+    std::cout << "多模式匹配测试完成" << std::endl;
+}
+
+void testFingerprint() {
+    std::cout << "\n=== 测试Web技术识别 ===" << std::endl;
+
+    const std::string body =
+        "<html><head>"
+        "<meta name=\"generator\" content=\"WordPress 6.4.2\">"
+        "<script src=\"/static/jquery-3.7.1.min.js\"></script>"
+        "</head><body><img src=\"/wp-content/uploads/logo.png\"></body></html>";
+    HttpResponse response = parseResponse(
+        "HTTP/1.1 200 OK\r\n"
+        "Server: nginx/1.25.3\r\n"
+        "X-Powered-By: PHP/8.2.1\r\n"
+        "Set-Cookie: wordpress_test_cookie=WP+Cookie+check; path=/\r\n"
+        "CF-Ray: 8a1b2c3d4e5f-LAX\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "\r\n" + body);
+
+    std::vector<TechMatch> matches = TechFingerprinter::builtin().detect(response);
+    const TechMatch* nginx = findTech(matches, "nginx");
+    CHECK(nginx != nullptr && nginx->version == "1.25.3" && nginx->category == "web-server");
+    const TechMatch* php = findTech(matches, "PHP");
+    CHECK(php != nullptr && php->version == "8.2.1");
+    const TechMatch* wordpress = findTech(matches, "WordPress");
+    CHECK(wordpress != nullptr && wordpress->version == "6.4.2" && wordpress->category == "cms");
+    const TechMatch* jquery = findTech(matches, "jQuery");
+    CHECK(jquery != nullptr && jquery->version == "3.7.1");
+    CHECK(findTech(matches, "Cloudflare") != nullptr);
+    // WordPress推断出MySQL，不带版本
+    const TechMatch* mysql = findTech(matches, "MySQL");
+    CHECK(mysql != nullptr && mysql->version.empty());
+    CHECK(findTech(matches, "Drupal") == nullptr);
+    // 每项技术只报告一次
+    for (const auto& match : matches) {
+        CHECK(std::count_if(matches.begin(), matches.end(),
+                            [&](const TechMatch& m) { return m.name == match.name; }) == 1);
+    }
+
+    // 空响应没有命中
+    HttpResponse empty = parseResponse("HTTP/1.1 204 No Content\r\n\r\n");
+    CHECK(TechFingerprinter::builtin().detect(empty).empty());
+
+    // 合并: 只补空缺的版本，不重复
+    std::vector<TechMatch> merged = {{"nginx", "", "web-server"}};
+    TechFingerprinter::merge(merged, matches);
+    CHECK(merged.size() == matches.size());
+    CHECK(merged.front().name == "nginx" && merged.front().version == "1.25.3");
+
+    std::cout << "Web技术识别测试完成" << std::endl;
+}
+
+void testRuleFile() {
+    std::cout << "\n=== 测试规则文件 ===" << std::endl;
+
+    const std::string path = "test_multi_pattern_rules.txt";
+    {
+        std::ofstream out(path);
+        out << "# 自定义规则\n"
+               "\n"
+               "Acme Portal | application | header:X-Acme | acme/{version} | Java, Tomcat\n"
+               "Acme Portal|application|body|acme-portal-root\n"
+               "Tomcat|web-server|header:x-tomcat\n";
+    }
+    TechFingerprinter fingerprinter;
+    std::string error;
+    CHECK(fingerprinter.loadRules(path, error));
+    CHECK(fingerprinter.ruleCount() == 3);
+    fingerprinter.compile();
+
+    HttpResponse response = parseResponse(
+        "HTTP/1.1 200 OK\r\n"
+        "x-acme: ACME/2.0.1-beta\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n");
+    std::vector<TechMatch> matches = fingerprinter.detect(response);
+    CHECK(matches.size() == 3);
+    if (matches.size() == 3) {
+        CHECK(matches[0].name == "Acme Portal" && matches[0].version == "2.0.1" &&
+              matches[0].category == "application");
+        CHECK(matches[1].name == "Java" && matches[2].name == "Tomcat");
+        // 先被推断后才有规则的技术保留规则中的类别
+        CHECK(matches[2].category == "web-server");
+    }
+
+    // 非首部规则必须有模式，字段名须合法
+    for (const char* line : {"Bad|cms|body|\n", "Bad|cms|header:|x\n", "Bad|cms|cookies|x\n", "Bad|cms\n"}) {
+        {
+            std::ofstream out(path);
+            out << line;
+        }
+        TechFingerprinter invalid;
+        error.clear();
+        CHECK(!invalid.loadRules(path, error));
+        CHECK(error.find(":1") != std::string::npos);
+    }
+    CHECK(!fingerprinter.loadRules("/nonexistent/rules.txt", error));
+    std::remove(path.c_str());
+
+    std::cout << "规则文件测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 多模式匹配和Web技术识别测试" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    try {
+        testMatcher();
+        testFingerprint();
+        testRuleFile();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
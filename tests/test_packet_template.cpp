@@ -0,0 +1,253 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/utils/packet_template.h"
+
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return (static_cast<uint32_t>(readU16(p)) << 16) | readU16(p + 2);
+}
+
+// 按RFC 1071逐字节计算的反码和，用来独立验证模板的增量校验和
+uint32_t onesSum(const uint8_t* data, size_t length, uint32_t sum = 0) {
+    for (size_t i = 0; i < length; i += 2) {
+        sum += static_cast<uint32_t>(data[i]) << 8;
+        if (i + 1 < length) {
+            sum += data[i + 1];
+        }
+    }
+    return sum;
+}
+
+// 包含校验和字段时结果为0xFFFF即校验通过
+bool sumValid(uint32_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return sum == 0xFFFF;
+}
+
+// 伪首部 + 传输层
+bool transportValid(const uint8_t* ip, const uint8_t* l4, size_t l4Length, bool ipv6, uint8_t protocol) {
+    uint32_t sum = 0;
+    if (ipv6) {
+        sum = onesSum(ip + 8, 32);
+        sum += static_cast<uint32_t>(l4Length);
+    } else {
+        sum = onesSum(ip + 12, 8);
+        sum += static_cast<uint32_t>(l4Length);
+    }
+    sum += protocol;
+    return sumValid(onesSum(l4, l4Length, sum));
+}
+
+ProbeTarget makeTarget(const std::string& address, uint16_t port, uint32_t sequence) {
+    ProbeTarget target;
+    CHECK(target.setAddress(IPAddress(address)));
+    target.destinationPort = port;
+    target.sourcePort = 40001;
+    target.sequence = sequence;
+    target.acknowledgment = 0x01020304;
+    target.ipId = 0xabcd;
+    return target;
+}
+
+void testTcpIPv4() {
+    std::cout << "=== 测试IPv4 TCP模板 ===" << std::endl;
+
+    PacketTemplateConfig config;
+    config.type = ProbeType::TCP_SYN;
+    config.source = IPAddress("192.0.2.10");
+    PacketTemplate packetTemplate(config);
+    CHECK(packetTemplate.size() == 44);
+    CHECK(packetTemplate.l4Offset() == 20);
+
+    std::vector<uint8_t> packet(packetTemplate.size());
+    // 不同目标复用同一模板，每个包的校验和都独立正确
+    for (uint32_t i = 0; i < 64; ++i) {
+        ProbeTarget target = makeTarget("198.51.100." + std::to_string(i), static_cast<uint16_t>(i * 1021), i * 0x9e3779b9);
+        target.ttl = static_cast<uint8_t>(i % 3 == 0 ? 0 : i);
+        packetTemplate.stamp(packet.data(), target);
+        const uint8_t* ip = packet.data();
+        const uint8_t* tcp = ip + 20;
+        CHECK(sumValid(onesSum(ip, 20)));
+        CHECK(transportValid(ip, tcp, 24, false, 6));
+        CHECK(ip[8] == (i % 3 == 0 ? 64 : i));
+        CHECK(ip[19] == i);
+        CHECK(readU16(ip + 4) == 0xabcd);
+        CHECK(readU16(tcp) == 40001);
+        CHECK(readU16(tcp + 2) == static_cast<uint16_t>(i * 1021));
+        CHECK(readU32(tcp + 4) == i * 0x9e3779b9);
+        // SYN不带确认号
+        CHECK(readU32(tcp + 8) == 0);
+        CHECK(tcp[13] == 0x02);
+        CHECK(tcp[20] == 2 && readU16(tcp + 22) == 1460);
+    }
+
+    // RST+ACK带确认号，无MSS选项时首部20字节
+    config.type = ProbeType::TCP_RST;
+    config.tcpMss = 0;
+    PacketTemplate reset(config);
+    CHECK(reset.size() == 40);
+    packet.resize(reset.size());
+    reset.stamp(packet.data(), makeTarget("203.0.113.1", 443, 7));
+    CHECK(packet[33] == 0x14);
+    CHECK(readU32(packet.data() + 28) == 0x01020304);
+    CHECK(transportValid(packet.data(), packet.data() + 20, 20, false, 6));
+
+    // 数据段携带负载，奇数长度也要正确补零
+    config.type = ProbeType::TCP_DATA;
+    config.payload = {'G', 'E', 'T', ' ', '/'};
+    PacketTemplate data(config);
+    CHECK(data.size() == 45);
+    packet.resize(data.size());
+    data.stamp(packet.data(), makeTarget("203.0.113.1", 80, 100));
+    CHECK(readU16(packet.data() + 2) == 45);
+    CHECK(transportValid(packet.data(), packet.data() + 20, 25, false, 6));
+
+    std::cout << "IPv4 TCP模板测试完成" << std::endl;
+}
+
+void testOtherProtocols() {
+    std::cout << "\n=== 测试UDP、ICMP和IPv6模板 ===" << std::endl;
+
+    PacketTemplateConfig config;
+    config.type = ProbeType::UDP;
+    config.source = IPAddress("10.0.0.1");
+    config.payload = {0x12, 0x34, 0x01};
+    PacketTemplate udp(config);
+    std::vector<uint8_t> packet(udp.size());
+    udp.stamp(packet.data(), makeTarget("10.0.0.2", 53, 0));
+    CHECK(udp.size() == 31);
+    CHECK(readU16(packet.data() + 24) == 11);
+    CHECK(readU16(packet.data() + 26) != 0);
+    CHECK(transportValid(packet.data(), packet.data() + 20, 11, false, 17));
+
+    // ICMPv4校验和不含伪首部
+    config.type = ProbeType::ICMP_ECHO;
+    config.payload = {'p', 'i', 'n', 'g'};
+    PacketTemplate icmp(config);
+    packet.resize(icmp.size());
+    icmp.stamp(packet.data(), makeTarget("10.0.0.2", 0, 0x10005));
+    CHECK(packet[20] == 8);
+    CHECK(readU16(packet.data() + 24) == 40001);
+    CHECK(readU16(packet.data() + 26) == 5);
+    CHECK(sumValid(onesSum(packet.data() + 20, 12)));
+
+    // IPv6 TCP和ICMPv6
+    config.type = ProbeType::TCP_SYN;
+    config.source = IPAddress("2001:db8::1");
+    PacketTemplate tcp6(config);
+    CHECK(tcp6.isIPv6());
+    CHECK(tcp6.size() == 64);
+    packet.resize(tcp6.size());
+    tcp6.stamp(packet.data(), makeTarget("2001:db8::ff", 22, 1));
+    CHECK(packet[0] == 0x60);
+    CHECK(packet[6] == 6 && packet[7] == 64);
+    CHECK(packet[39] == 0xff);
+    CHECK(transportValid(packet.data(), packet.data() + 40, 24, true, 6));
+
+    config.type = ProbeType::ICMP_ECHO;
+    PacketTemplate icmp6(config);
+    packet.resize(icmp6.size());
+    icmp6.stamp(packet.data(), makeTarget("2001:db8::ff", 0, 9));
+    CHECK(packet[40] == 128);
+    CHECK(transportValid(packet.data(), packet.data() + 40, 12, true, 58));
+
+    // 二层封装
+    config.type = ProbeType::TCP_SYN;
+    config.source = IPAddress("10.0.0.1");
+    config.includeEthernet = true;
+    config.gatewayMac[0] = 0xaa;
+    config.sourceMac[5] = 0xbb;
+    PacketTemplate framed(config);
+    CHECK(framed.hasEthernet());
+    CHECK(framed.l3Offset() == 14);
+    packet.resize(framed.size());
+    framed.stamp(packet.data(), makeTarget("10.0.0.2", 80, 1));
+    CHECK(packet[0] == 0xaa && packet[11] == 0xbb);
+    CHECK(readU16(packet.data() + 12) == 0x0800);
+    CHECK(sumValid(onesSum(packet.data() + 14, 20)));
+    CHECK(transportValid(packet.data() + 14, packet.data() + 34, 24, false, 6));
+
+    std::cout << "其它模板测试完成" << std::endl;
+}
+
+void testBatch() {
+    std::cout << "\n=== 测试批量缓冲区 ===" << std::endl;
+
+    PacketTemplateConfig config;
+    config.source = IPAddress("10.0.0.1");
+    PacketTemplate packetTemplate(config);
+    PacketBatch batch(packetTemplate, 3);
+    CHECK(batch.stride() % 64 == 0 && batch.stride() >= packetTemplate.size());
+    CHECK(batch.add(makeTarget("10.0.0.2", 1, 1)));
+    CHECK(batch.add(makeTarget("10.0.0.3", 2, 2)));
+    CHECK(batch.add(makeTarget("10.0.0.4", 3, 3)));
+    CHECK(batch.full());
+    CHECK(!batch.add(makeTarget("10.0.0.5", 4, 4)));
+    CHECK(batch.packet(1)[19] == 3);
+    auto* destination = reinterpret_cast<const sockaddr_in*>(&batch.destination(2));
+    CHECK(destination->sin_family == AF_INET);
+    CHECK(reinterpret_cast<const uint8_t*>(&destination->sin_addr)[3] == 4);
+    batch.clear();
+    CHECK(batch.size() == 0);
+
+    // 批次中间的报文被拒绝时跳过它，其余照常发送 (需要原始套接字权限)
+    NetworkUtils::initialize();
+    int sock = NetworkUtils::createRawSocket(IPPROTO_RAW);
+    if (sock < 0) {
+        std::cout << "  跳过发送测试: 无法创建原始套接字" << std::endl;
+    } else {
+        PacketTemplateConfig loopbackConfig;
+        loopbackConfig.source = IPAddress("127.0.0.1");
+        PacketTemplate loopback(loopbackConfig);
+        PacketBatch sendBatch(loopback, 4);
+        sendBatch.add(makeTarget("127.0.0.1", 9, 1));
+        sendBatch.add(makeTarget("255.255.255.255", 9, 2));     // 未设置SO_BROADCAST: EACCES
+        sendBatch.add(makeTarget("127.0.0.1", 9, 3));
+        sendBatch.add(makeTarget("127.0.0.1", 9, 4));
+        size_t failed = 0;
+        CHECK(NetworkUtils::sendRawBatch(sock, sendBatch, &failed) == 3);
+        CHECK(failed == 1);
+        NetworkUtils::closeRawSocket(sock);
+    }
+
+    std::cout << "批量缓冲区测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 探测包模板测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    try {
+        testTcpIPv4();
+        testOtherProtocols();
+        testBatch();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
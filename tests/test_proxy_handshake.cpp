@@ -0,0 +1,343 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/utils/proxy_pool.h"
+
+using namespace MindSploit::Utils;
+using Result = ProxyHandshake::Result;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+std::string bytes(std::initializer_list<int> values) {
+    std::string out;
+    for (int value : values) {
+        out += static_cast<char>(value);
+    }
+    return out;
+}
+
+// 按step字节分批输入，NEED_MORE时未消费的部分留到下一批; rest返回DONE后属于目标的数据
+Result feedInSteps(ProxyHandshake& handshake, const std::string& input, size_t step, std::string* rest = nullptr) {
+    std::string pending;
+    size_t position = 0;
+    while (true) {
+        size_t take = std::min(step, input.size() - position);
+        pending.append(input, position, take);
+        position += take;
+
+        size_t consumed = 0;
+        Result result = handshake.feed(pending.data(), pending.size(), consumed);
+        pending.erase(0, consumed);
+        if (result != Result::NEED_MORE) {
+            if (rest != nullptr) {
+                *rest = pending + input.substr(position);
+            }
+            return result;
+        }
+        // 一个应答处理完后可能还有下一阶段的数据
+        if (consumed > 0 && !pending.empty()) {
+            position -= std::min(position, pending.size());
+            pending.clear();
+            continue;
+        }
+        if (position == input.size()) {
+            return Result::NEED_MORE;
+        }
+    }
+}
+
+ProxyEndpoint socksProxy(const std::string& username = "", const std::string& password = "") {
+    ProxyEndpoint proxy;
+    proxy.type = ProxyEndpoint::Type::SOCKS5;
+    proxy.address = IPAddress("127.0.0.1");
+    proxy.port = 1080;
+    proxy.username = username;
+    proxy.password = password;
+    return proxy;
+}
+
+ProxyEndpoint httpProxy(const std::string& username = "", const std::string& password = "") {
+    ProxyEndpoint proxy = socksProxy(username, password);
+    proxy.type = ProxyEndpoint::Type::HTTP_CONNECT;
+    proxy.port = 3128;
+    return proxy;
+}
+
+void testSocks5() {
+    std::cout << "=== 测试SOCKS5握手 ===" << std::endl;
+
+    // 无认证，IPv4目标，应答后紧跟目标横幅
+    for (size_t step : {size_t(64), size_t(1), size_t(3)}) {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.1.2.3"), 8080);
+        CHECK(handshake.pendingOutput() == bytes({5, 1, 0}));
+        CHECK(handshake.timeoutOutcome() == ProxyOutcome::PROXY_FAILED);
+        handshake.consumeOutput(3);
+
+        CHECK(feedInSteps(handshake, bytes({5, 0}), step) == Result::NEED_MORE);
+        CHECK(handshake.pendingOutput() == bytes({5, 1, 0, 1, 10, 1, 2, 3, 0x1f, 0x90}));
+        // 问候已应答，之后超时是目标无应答
+        CHECK(handshake.timeoutOutcome() == ProxyOutcome::TARGET_FAILED);
+        handshake.consumeOutput(handshake.pendingOutput().size());
+
+        std::string rest;
+        std::string reply = bytes({5, 0, 0, 1, 192, 168, 0, 1, 0x30, 0x39}) + "SSH-2.0-OpenSSH\r\n";
+        CHECK(feedInSteps(handshake, reply, step, &rest) == Result::DONE);
+        CHECK(rest == "SSH-2.0-OpenSSH\r\n");
+        CHECK(handshake.outcome() == ProxyOutcome::ESTABLISHED);
+        CHECK(handshake.error().empty());
+    }
+
+    // 用户名密码认证，IPv6目标，绑定地址为域名
+    {
+        ProxyHandshake handshake(socksProxy("user", "secret"), IPAddress("2001:db8::1"), 443);
+        CHECK(handshake.pendingOutput() == bytes({5, 2, 0, 2}));
+        handshake.consumeOutput(4);
+        CHECK(feedInSteps(handshake, bytes({5, 2}), 1) == Result::NEED_MORE);
+        CHECK(handshake.pendingOutput() == bytes({1, 4}) + "user" + bytes({6}) + "secret");
+        handshake.consumeOutput(handshake.pendingOutput().size());
+        CHECK(feedInSteps(handshake, bytes({1, 0}), 1) == Result::NEED_MORE);
+        std::string request = handshake.pendingOutput();
+        CHECK(request.size() == 4 + 16 + 2);
+        CHECK(request.substr(0, 4) == bytes({5, 1, 0, 4}));
+        CHECK(request.substr(4, 2) == bytes({0x20, 0x01}) && request.substr(18) == bytes({0, 1, 1, 0xbb}));
+        handshake.consumeOutput(request.size());
+
+        std::string rest;
+        std::string reply = bytes({5, 0, 0, 3, 9}) + "proxy.lan" + bytes({0x04, 0x38});
+        CHECK(feedInSteps(handshake, reply, 2, &rest) == Result::DONE);
+        CHECK(rest.empty());
+        CHECK(handshake.outcome() == ProxyOutcome::ESTABLISHED);
+    }
+
+    // 问候和认证应答在同一批数据中到达
+    {
+        ProxyHandshake handshake(socksProxy("u", "p"), IPAddress("10.0.0.1"), 22);
+        handshake.consumeOutput(handshake.pendingOutput().size());
+        CHECK(feedInSteps(handshake, bytes({5, 2, 1, 0}), 64) == Result::NEED_MORE);
+        CHECK(handshake.pendingOutput().substr(0, 2) == bytes({1, 1}));
+        CHECK(handshake.pendingOutput().find(bytes({5, 1, 0, 1})) != std::string::npos);
+    }
+
+    std::cout << "SOCKS5握手测试完成" << std::endl;
+}
+
+void testSocks5Failures() {
+    std::cout << "\n=== 测试SOCKS5失败归类 ===" << std::endl;
+
+    // CONNECT应答码 -> 归类
+    struct Case {
+        int code;
+        ProxyOutcome outcome;
+    };
+    for (const Case& c : {Case{1, ProxyOutcome::TARGET_FAILED}, Case{2, ProxyOutcome::PROXY_FAILED},
+                          Case{3, ProxyOutcome::TARGET_FAILED}, Case{4, ProxyOutcome::TARGET_FAILED},
+                          Case{5, ProxyOutcome::TARGET_FAILED}, Case{6, ProxyOutcome::TARGET_FAILED},
+                          Case{7, ProxyOutcome::PROXY_FAILED}, Case{8, ProxyOutcome::PROXY_FAILED}}) {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.0.0.1"), 80);
+        CHECK(feedInSteps(handshake, bytes({5, 0}), 64) == Result::NEED_MORE);
+        std::string reply = bytes({5, c.code, 0, 1, 0, 0, 0, 0, 0, 0});
+        CHECK(feedInSteps(handshake, reply, 1) == Result::FAILED);
+        CHECK(handshake.outcome() == c.outcome);
+        CHECK(handshake.error().find("SOCKS5") == 0);
+    }
+
+    // 失败应答不带合法地址类型时按应答码处理
+    {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.0.0.1"), 80);
+        feedInSteps(handshake, bytes({5, 0}), 64);
+        CHECK(feedInSteps(handshake, bytes({5, 5, 0, 0, 0}), 64) == Result::FAILED);
+        CHECK(handshake.outcome() == ProxyOutcome::TARGET_FAILED);
+        CHECK(handshake.error() == "SOCKS5 connection refused");
+    }
+    // 成功应答的地址类型非法是协议错误
+    {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.0.0.1"), 80);
+        feedInSteps(handshake, bytes({5, 0}), 64);
+        CHECK(feedInSteps(handshake, bytes({5, 0, 0, 9, 0}), 64) == Result::FAILED);
+        CHECK(handshake.outcome() == ProxyOutcome::PROXY_FAILED);
+    }
+    // 不是SOCKS5代理 (例如HTTP服务)
+    {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.0.0.1"), 80);
+        CHECK(feedInSteps(handshake, "HTTP/1.1 400 Bad Request\r\n\r\n", 64) == Result::FAILED);
+        CHECK(handshake.outcome() == ProxyOutcome::PROXY_FAILED);
+        // 失败后再输入保持失败
+        size_t consumed = 0;
+        CHECK(handshake.feed("\x05\x00", 2, consumed) == Result::FAILED && consumed == 0);
+    }
+    // 代理要求认证但未配置凭据，认证被拒绝
+    {
+        ProxyHandshake handshake(socksProxy(), IPAddress("10.0.0.1"), 80);
+        CHECK(feedInSteps(handshake, bytes({5, 2}), 64) == Result::FAILED);
+        CHECK(handshake.outcome() == ProxyOutcome::PROXY_FAILED);
+
+        ProxyHandshake auth(socksProxy("user", "wrong"), IPAddress("10.0.0.1"), 80);
+        CHECK(feedInSteps(auth, bytes({5, 2}), 64) == Result::NEED_MORE);
+        CHECK(feedInSteps(auth, bytes({1, 1}), 64) == Result::FAILED);
+        CHECK(auth.outcome() == ProxyOutcome::PROXY_FAILED);
+        CHECK(auth.error() == "SOCKS5 authentication failed");
+    }
+
+    std::cout << "SOCKS5失败归类测试完成" << std::endl;
+}
+
+void testHttpConnect() {
+    std::cout << "\n=== 测试HTTP CONNECT握手 ===" << std::endl;
+
+    {
+        ProxyHandshake handshake(httpProxy("user", "pass"), IPAddress("10.0.0.5"), 443);
+        CHECK(handshake.pendingOutput() ==
+              "CONNECT 10.0.0.5:443 HTTP/1.1\r\nHost: 10.0.0.5:443\r\n"
+              "Proxy-Authorization: Basic dXNlcjpwYXNz\r\n\r\n");
+        // 请求未发出时超时是代理的问题
+        CHECK(handshake.timeoutOutcome() == ProxyOutcome::PROXY_FAILED);
+        handshake.consumeOutput(handshake.pendingOutput().size());
+        CHECK(handshake.timeoutOutcome() == ProxyOutcome::TARGET_FAILED);
+    }
+    {
+        ProxyHandshake handshake(httpProxy(), IPAddress("2001:db8::5"), 22);
+        CHECK(handshake.pendingOutput() == "CONNECT [2001:db8::5]:22 HTTP/1.1\r\nHost: [2001:db8::5]:22\r\n\r\n");
+    }
+
+    // 响应头结束标记跨越分批边界，之后的数据属于目标
+    const std::string response = "HTTP/1.1 200 Connection established\r\nVia: squid\r\n\r\n";
+    for (size_t step : {size_t(1), size_t(2), size_t(5), response.size() + 4}) {
+        ProxyHandshake handshake(httpProxy(), IPAddress("10.0.0.5"), 22);
+        handshake.consumeOutput(handshake.pendingOutput().size());
+        std::string rest;
+        CHECK(feedInSteps(handshake, response + "SSH-2.0", step, &rest) == Result::DONE);
+        CHECK(rest == "SSH-2.0");
+        CHECK(handshake.outcome() == ProxyOutcome::ESTABLISHED);
+    }
+
+    // 状态码 -> 归类
+    struct Case {
+        const char* response;
+        ProxyOutcome outcome;
+    };
+    for (const Case& c : {Case{"HTTP/1.1 407 Proxy Authentication Required\r\n\r\n", ProxyOutcome::PROXY_FAILED},
+                          Case{"HTTP/1.1 405 Method Not Allowed\r\n\r\n", ProxyOutcome::PROXY_FAILED},
+                          Case{"HTTP/1.0 403 Forbidden\r\n\r\n", ProxyOutcome::TARGET_FAILED},
+                          Case{"HTTP/1.1 502 Bad Gateway\r\n\r\n", ProxyOutcome::TARGET_FAILED},
+                          Case{"HTTP/1.1 504 Gateway Timeout\r\n\r\n", ProxyOutcome::TARGET_FAILED},
+                          Case{"SSH-2.0-OpenSSH\r\n\r\n", ProxyOutcome::PROXY_FAILED}}) {
+        ProxyHandshake handshake(httpProxy(), IPAddress("10.0.0.5"), 22);
+        CHECK(feedInSteps(handshake, c.response, 3) == Result::FAILED);
+        CHECK(handshake.outcome() == c.outcome);
+    }
+    {
+        ProxyHandshake handshake(httpProxy(), IPAddress("10.0.0.5"), 22);
+        CHECK(feedInSteps(handshake, "HTTP/1.1 502 Bad Gateway\r\nX: y\r\n\r\n", 64) == Result::FAILED);
+        CHECK(handshake.error() == "HTTP/1.1 502 Bad Gateway");
+    }
+
+    // 响应头过大
+    {
+        ProxyHandshake handshake(httpProxy(), IPAddress("10.0.0.5"), 22);
+        std::string header = "HTTP/1.1 200 OK\r\nX-Padding: " + std::string(9000, 'a');
+        CHECK(feedInSteps(handshake, header, 1000) == Result::FAILED);
+        CHECK(handshake.outcome() == ProxyOutcome::PROXY_FAILED);
+    }
+
+    std::cout << "HTTP CONNECT握手测试完成" << std::endl;
+}
+
+void testProxyList() {
+    std::cout << "\n=== 测试代理列表解析 ===" << std::endl;
+
+    std::vector<ProxyEndpoint> proxies;
+    std::string error;
+    CHECK(parseProxyList(" socks5://user:p:ss@127.0.0.1:1080/, http://[::1]:3128 ,127.0.0.2:9050,,", proxies, error));
+    CHECK(proxies.size() == 3);
+    if (proxies.size() == 3) {
+        CHECK(proxies[0].type == ProxyEndpoint::Type::SOCKS5);
+        CHECK(proxies[0].username == "user" && proxies[0].password == "p:ss");
+        CHECK(proxies[0].port == 1080);
+        CHECK(proxies[1].type == ProxyEndpoint::Type::HTTP_CONNECT);
+        CHECK(proxies[1].address.isIPv6 && proxies[1].address.address == "::1" && proxies[1].port == 3128);
+        CHECK(proxies[1].toString() == "http://[::1]:3128");
+        CHECK(proxies[2].type == ProxyEndpoint::Type::SOCKS5 && proxies[2].username.empty());
+    }
+
+    for (const char* text : {"", " , ", "ftp://127.0.0.1:21", "127.0.0.1", "127.0.0.1:0", "127.0.0.1:70000",
+                             "[::1]3128", "socks5://127.0.0.1:abc"}) {
+        std::vector<ProxyEndpoint> invalid;
+        CHECK(!parseProxyList(text, invalid, error));
+    }
+
+    std::cout << "代理列表解析测试完成" << std::endl;
+}
+
+void testPool() {
+    std::cout << "\n=== 测试代理池 ===" << std::endl;
+
+    std::vector<ProxyEndpoint> proxies = {socksProxy(), httpProxy()};
+    ProxyPool pool(proxies, 2);
+    CHECK(pool.capacity() == 4);
+
+    // 负载均衡: 轮流选择，满额后返回-1
+    int first = pool.acquire();
+    int second = pool.acquire();
+    CHECK(first >= 0 && second >= 0 && first != second);
+    CHECK(pool.acquire() >= 0 && pool.acquire() >= 0);
+    CHECK(pool.acquire() == -1);
+    for (int index : {0, 0, 1, 1}) {
+        pool.release(index, ProxyOutcome::ESTABLISHED);
+    }
+
+    // 目标失败不影响健康状态
+    for (int i = 0; i < 10; ++i) {
+        int index = pool.acquire(1);
+        CHECK(index == 0);
+        pool.release(index, ProxyOutcome::TARGET_FAILED);
+    }
+
+    // 连续代理失败达到阈值后停用，重试时只剩被避开的代理也不会选中停用的
+    for (size_t i = 0; i < ProxyPool::PROXY_FAILED_THRESHOLD; ++i) {
+        pool.release(pool.acquire(1), ProxyOutcome::PROXY_FAILED);
+    }
+    auto stats = pool.getStats();
+    CHECK(stats[0].state == "down" && stats[0].proxyFailures == ProxyPool::PROXY_FAILED_THRESHOLD);
+    CHECK(stats[0].targetFailures == 10 && stats[0].established == 2);
+    CHECK(pool.acquire(1) == 1);
+    CHECK(pool.acquire() == 1);
+    CHECK(pool.acquire() == -1);
+    pool.cancel(1);
+    pool.cancel(1);
+    CHECK(pool.getStats()[1].inFlight == 0);
+    CHECK(!pool.exhausted());
+
+    std::cout << "代理池测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 代理握手测试" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    try {
+        NetworkUtils::initialize();
+        testSocks5();
+        testSocks5Failures();
+        testHttpConnect();
+        testProxyList();
+        testPool();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
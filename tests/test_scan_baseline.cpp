@@ -0,0 +1,130 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include "../src/engines/network/scan_baseline.h"
+#include "../src/utils/json_utils.h"
+
+using namespace MindSploit::Network;
+using MindSploit::Utils::jsonEscape;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 与扫描结果文件相同格式的端口记录
+std::string portRecord(const BaselineEntry& entry, bool open = true, const std::string& change = "") {
+    std::string record = "{\"ip\":\"" + jsonEscape(entry.ip) + "\",\"port\":" + std::to_string(entry.port) +
+                         ",\"open\":" + (open ? "true" : "false") +
+                         ",\"service\":\"" + jsonEscape(entry.service) + "\"";
+    if (!entry.banner.empty()) {
+        record += ",\"banner\":\"" + jsonEscape(entry.banner) + "\"";
+    }
+    if (!change.empty()) {
+        record += ",\"change\":\"" + change + "\"";
+    }
+    return record + ",\"shard\":\"0/1\"}\n";
+}
+
+void testRoundTrip() {
+    std::cout << "=== 测试基线读写往返 ===" << std::endl;
+
+    BaselineEntry ssh{"10.0.0.1", 22, "ssh", "SSH-2.0-OpenSSH_9.6"};
+    BaselineEntry http{"10.0.0.1", 80, "http", "HTTP/1.1 200 OK\r\nServer: \"quoted\" \\path\\\t\x01"};
+    BaselineEntry bare{"10.0.0.2", 8443, "unknown", ""};
+
+    std::string text = portRecord(ssh) + portRecord(http) + portRecord(bare);
+    // 可疑主机和存活推断的记录没有port字段，不属于基线
+    text += "{\"ip\":\"10.0.0.3\",\"suspicious\":\"all-open\",\"probed\":64,\"open\":64}\n";
+    text += "{\"subnet\":\"10.0.1.0/24\",\"liveness\":\"skipped\",\"timeouts\":8}\n";
+
+    ScanBaseline baseline;
+    CHECK(baseline.parse(text) == 3);
+    CHECK(baseline.size() == 3);
+
+    const BaselineEntry* found = baseline.find("10.0.0.1", 80);
+    CHECK(found != nullptr);
+    if (found) {
+        CHECK(found->service == "http");
+        CHECK(found->banner == http.banner);
+    }
+    found = baseline.find("10.0.0.2", 8443);
+    CHECK(found != nullptr && found->banner.empty());
+    CHECK(baseline.find("10.0.0.1", 443) == nullptr);
+    CHECK(baseline.find("10.0.0.3", 0) == nullptr);
+
+    // 解析结果重新写出后得到相同的基线
+    std::string rewritten;
+    for (const auto& entry : baseline.entries()) {
+        rewritten += portRecord(entry);
+    }
+    ScanBaseline again;
+    CHECK(again.parse(rewritten) == baseline.size());
+    for (const auto& entry : baseline.entries()) {
+        const BaselineEntry* copy = again.find(entry.ip, entry.port);
+        CHECK(copy != nullptr && copy->service == entry.service && copy->banner == entry.banner);
+    }
+
+    std::cout << "往返测试完成" << std::endl;
+}
+
+void testChanges() {
+    std::cout << "\n=== 测试变化记录 ===" << std::endl;
+
+    BaselineEntry ssh{"10.0.0.1", 22, "ssh", ""};
+    BaselineEntry web{"10.0.0.1", 80, "http", ""};
+    BaselineEntry rdp{"10.0.0.2", 3389, "rdp", ""};
+    BaselineEntry rdpBanner{"10.0.0.2", 3389, "rdp", "new banner"};
+
+    // 增量重扫的输出: 未变化的端口照常写出，新开放和横幅变化带change，关闭的端口被移除
+    std::string text = portRecord(ssh) + portRecord(web, false, "closed") + portRecord(rdp) +
+                       portRecord(rdpBanner, true, "banner") + "\n" + "not json\n" +
+                       "{\"ip\":\"10.0.0.9\",\"port\":70000,\"open\":true}\n";
+
+    ScanBaseline baseline;
+    baseline.parse(text);
+    CHECK(baseline.size() == 2);
+    CHECK(baseline.find("10.0.0.1", 22) != nullptr);
+    CHECK(baseline.find("10.0.0.1", 80) == nullptr);
+    const BaselineEntry* found = baseline.find("10.0.0.2", 3389);
+    CHECK(found != nullptr && found->banner == "new banner");
+
+    std::string path = "test_scan_baseline.jsonl";
+    {
+        std::ofstream file(path);
+        file << text;
+    }
+    ScanBaseline loaded;
+    CHECK(loaded.loadFile(path));
+    CHECK(loaded.size() == 2);
+    std::remove(path.c_str());
+    CHECK(!loaded.loadFile(path));
+
+    std::cout << "变化记录测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 扫描基线测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    try {
+        testRoundTrip();
+        testChanges();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,337 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "../src/engines/network/scan_protocol.h"
+#include "../src/engines/network/scan_coordinator.h"
+#include "../src/engines/network/scan_worker.h"
+#include "../src/engines/network/connect_scanner.h"
+#include "../src/utils/target_space.h"
+
+using namespace MindSploit::Network;
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 单帧的类型和负载
+bool decodeFrame(const std::vector<uint8_t>& frame, ScanMessageType& type, std::vector<uint8_t>& payload) {
+    size_t offset = 0;
+    return extractScanFrame(frame, offset, type, payload) == 1 && offset == frame.size();
+}
+
+// 以阻塞套接字直接收发帧的工作节点，用来驱动协调节点
+class RawWorker {
+public:
+    RawWorker() : m_socket(AF_INET, SOCK_STREAM) {}
+
+    bool connect(uint16_t port) {
+        m_socket.setReceiveTimeout(std::chrono::milliseconds(3000));
+        return m_socket.connect(IPAddress("127.0.0.1"), port, std::chrono::milliseconds(3000));
+    }
+
+    bool send(const std::vector<uint8_t>& frame) {
+        return m_socket.send(frame.data(), frame.size()) == static_cast<ssize_t>(frame.size());
+    }
+
+    // 连接关闭或超时返回false
+    bool read(ScanMessageType& type, std::vector<uint8_t>& payload) {
+        while (true) {
+            size_t offset = 0;
+            if (extractScanFrame(m_input, offset, type, payload) == 1) {
+                m_input.erase(m_input.begin(), m_input.begin() + offset);
+                return true;
+            }
+            uint8_t buffer[4096];
+            auto received = m_socket.receive(buffer, sizeof(buffer));
+            if (received <= 0) {
+                return false;
+            }
+            m_input.insert(m_input.end(), buffer, buffer + received);
+        }
+    }
+
+    bool readLease(ScanLease& lease) {
+        ScanMessageType type;
+        std::vector<uint8_t> payload;
+        return read(type, payload) && type == ScanMessageType::LEASE && decodeScanLease(payload, lease);
+    }
+
+    void close() { m_socket.close(); }
+
+private:
+    Socket m_socket;
+    std::vector<uint8_t> m_input;
+};
+
+void testEncoding() {
+    std::cout << "=== 测试消息编解码 ===" << std::endl;
+
+    ScanJob job;
+    job.seed = 0x0123456789abcdefULL;
+    job.size = 3 * 65536;
+    job.target = "10.0.0.0/30";
+    job.ports = {22, 80, 65535};
+    ScanMessageType type;
+    std::vector<uint8_t> payload;
+    CHECK(decodeFrame(encodeScanJob(job), type, payload));
+    CHECK(type == ScanMessageType::JOB);
+    ScanJob decodedJob;
+    CHECK(decodeScanJob(payload, decodedJob));
+    CHECK(decodedJob.seed == job.seed && decodedJob.size == job.size);
+    CHECK(decodedJob.target == job.target && decodedJob.ports == job.ports);
+    // 截短的负载不能解码
+    payload.pop_back();
+    CHECK(!decodeScanJob(payload, decodedJob));
+
+    ScanLease lease{7, 4096, 8192};
+    CHECK(decodeFrame(encodeScanLease(lease), type, payload));
+    ScanLease decodedLease;
+    CHECK(type == ScanMessageType::LEASE && decodeScanLease(payload, decodedLease));
+    CHECK(decodedLease.id == 7 && decodedLease.begin == 4096 && decodedLease.end == 8192);
+
+    CHECK(decodeFrame(encodeScanResult(3, {1, 1ULL << 40}), type, payload));
+    ScanMessageReader reader(payload.data(), payload.size());
+    uint32_t leaseId = 0, count = 0;
+    uint64_t first = 0, second = 0;
+    CHECK(reader.u32(leaseId) && reader.u32(count) && reader.u64(first) && reader.u64(second));
+    CHECK(leaseId == 3 && count == 2 && first == 1 && second == (1ULL << 40));
+    CHECK(reader.remaining() == 0);
+    uint8_t extra;
+    CHECK(!reader.u8(extra));
+
+    CHECK(decodeFrame(encodeScanHello("node-1", "s3cret"), type, payload));
+    ScanMessageReader hello(payload.data(), payload.size());
+    uint16_t version = 0;
+    std::string name, token;
+    CHECK(hello.u16(version) && hello.string(name) && hello.string(token));
+    CHECK(version == SCAN_PROTOCOL_VERSION && name == "node-1" && token == "s3cret");
+
+    CHECK(decodeFrame(encodeScanDone(), type, payload));
+    CHECK(type == ScanMessageType::DONE && payload.empty());
+
+    std::cout << "消息编解码测试完成" << std::endl;
+}
+
+void testFraming() {
+    std::cout << "\n=== 测试帧提取 ===" << std::endl;
+
+    // 一次接收中的多帧按offset依次取出，缓冲区不搬移
+    std::vector<uint8_t> buffer = encodeScanProgress(1, 100, 50);
+    auto complete = encodeScanComplete(1, 60);
+    buffer.insert(buffer.end(), complete.begin(), complete.end());
+    auto partial = encodeScanProgress(2, 5, 5);
+    buffer.insert(buffer.end(), partial.begin(), partial.begin() + 7);
+
+    ScanMessageType type;
+    std::vector<uint8_t> payload;
+    size_t offset = 0;
+    CHECK(extractScanFrame(buffer, offset, type, payload) == 1);
+    CHECK(type == ScanMessageType::PROGRESS);
+    size_t afterFirst = offset;
+    CHECK(extractScanFrame(buffer, offset, type, payload) == 1);
+    CHECK(type == ScanMessageType::COMPLETE && offset == afterFirst + complete.size());
+    // 不完整的帧: 数据不足，offset不动
+    size_t beforePartial = offset;
+    CHECK(extractScanFrame(buffer, offset, type, payload) == 0);
+    CHECK(offset == beforePartial);
+    buffer.insert(buffer.end(), partial.begin() + 7, partial.end());
+    CHECK(extractScanFrame(buffer, offset, type, payload) == 1);
+    CHECK(offset == buffer.size());
+
+    // 长度上限: 只凭帧头即可拒绝，不等负载到齐
+    std::vector<uint8_t> header = {static_cast<uint8_t>(ScanMessageType::HELLO), 0, 0, 0x08, 0x00};
+    offset = 0;
+    CHECK(extractScanFrame(header, offset, type, payload, SCAN_MAX_HELLO_SIZE) == -1);
+    CHECK(extractScanFrame(header, offset, type, payload) == 0);
+    std::vector<uint8_t> huge = {static_cast<uint8_t>(ScanMessageType::RESULT), 0x7f, 0xff, 0xff, 0xff};
+    CHECK(extractScanFrame(huge, offset, type, payload) == -1);
+
+    std::cout << "帧提取测试完成" << std::endl;
+}
+
+void testCoordinator() {
+    std::cout << "\n=== 测试租约拆分与回收 ===" << std::endl;
+
+    ScanJob job;
+    job.seed = 1;
+    job.size = 1000;
+    job.target = "127.0.0.1";
+    job.ports = {1};
+    ScanCoordinatorConfig config;
+    config.listenPort = 0;
+    config.token = "t";
+    config.blockSize = 1000;
+    config.leasesPerWorker = 1;
+    ScanCoordinator coordinator(job, 1000, config);
+    std::vector<uint64_t> results;
+    coordinator.setResultHandler([&](uint64_t index) { results.push_back(index); });
+    std::string error;
+    CHECK(coordinator.listen(error));
+    uint16_t port = coordinator.listenPort();
+
+    std::atomic<bool> stop{false};
+    bool completed = false;
+    std::thread thread([&] { completed = coordinator.run(stop); });
+
+    // 认证前的大帧只看帧头就断开
+    RawWorker intruder;
+    CHECK(intruder.connect(port));
+    CHECK(intruder.send({static_cast<uint8_t>(ScanMessageType::HELLO), 0, 0, 0x08, 0x00}));
+    ScanMessageType type;
+    std::vector<uint8_t> payload;
+    CHECK(!intruder.read(type, payload));
+
+    // 令牌错误同样断开
+    RawWorker stranger;
+    CHECK(stranger.connect(port));
+    CHECK(stranger.send(encodeScanHello("x", "wrong")));
+    CHECK(!stranger.read(type, payload));
+
+    RawWorker a;
+    CHECK(a.connect(port));
+    CHECK(a.send(encodeScanHello("a", "t")));
+    CHECK(a.read(type, payload) && type == ScanMessageType::JOB);
+    ScanLease leaseA;
+    CHECK(a.readLease(leaseA));
+    CHECK(leaseA.begin == 0 && leaseA.end == 1000);
+    CHECK(a.send(encodeScanProgress(leaseA.id, 100, 100)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // 空闲节点从剩余区间的中点分走后半段，原持有者收到截断
+    RawWorker b;
+    CHECK(b.connect(port));
+    CHECK(b.send(encodeScanHello("b", "t")));
+    CHECK(b.read(type, payload) && type == ScanMessageType::JOB);
+    ScanLease leaseB;
+    CHECK(b.readLease(leaseB));
+    CHECK(leaseB.begin == 550 && leaseB.end == 1000);
+    CHECK(a.read(type, payload) && type == ScanMessageType::TRUNCATE);
+    ScanMessageReader truncate(payload.data(), payload.size());
+    uint32_t truncatedId = 0;
+    uint64_t truncatedEnd = 0;
+    CHECK(truncate.u32(truncatedId) && truncate.u64(truncatedEnd));
+    CHECK(truncatedId == leaseA.id && truncatedEnd == 550);
+
+    // 持有者失联: 从最后上报的位置起回收，b完成手头的租约后领取
+    a.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    CHECK(b.send(encodeScanComplete(leaseB.id, 450)));
+    ScanLease requeued;
+    CHECK(b.readLease(requeued));
+    CHECK(requeued.begin == 100 && requeued.end == 550);
+
+    // 重复结果只计一次
+    CHECK(b.send(encodeScanResult(requeued.id, {7, 9})));
+    CHECK(b.send(encodeScanResult(requeued.id, {7})));
+    CHECK(b.send(encodeScanComplete(requeued.id, 450)));
+    CHECK(b.read(type, payload) && type == ScanMessageType::DONE);
+
+    thread.join();
+    CHECK(completed);
+    auto stats = coordinator.getStats();
+    CHECK(stats.workersJoined == 2);
+    CHECK(stats.workersLost == 1);
+    CHECK(stats.steals == 1);
+    CHECK(stats.leasesRequeued == 1);
+    CHECK(stats.openResults == 2 && stats.duplicates == 1);
+    CHECK(results.size() == 2);
+
+    std::cout << "租约拆分与回收测试完成" << std::endl;
+}
+
+void testWorker() {
+    std::cout << "\n=== 测试工作节点并发探测 ===" << std::endl;
+
+    // 本机监听一个端口作为开放目标，其余端口应被拒绝
+    Socket listener(AF_INET, SOCK_STREAM);
+    CHECK(listener.bind(IPAddress("127.0.0.1"), 0) && listener.listen(64));
+    int openPort = listener.getLocalPort();
+
+    ScanJob job;
+    job.seed = 42;
+    job.target = "127.0.0.1";
+    job.ports = {1, 3, openPort, 7, 9, 13};
+    TargetSpace space;
+    CHECK(space.addTargets(job.target));
+    space.setPorts(job.ports);
+    job.size = space.size();
+    TargetPermutation permutation(job.size, job.seed);
+
+    ScanCoordinatorConfig config;
+    config.listenPort = 0;
+    config.blockSize = 2;
+    ScanCoordinator coordinator(job, permutation.cycleLength(), config);
+    std::vector<uint64_t> results;
+    coordinator.setResultHandler([&](uint64_t index) { results.push_back(index); });
+    std::string error;
+    CHECK(coordinator.listen(error));
+
+    std::atomic<bool> stop{false};
+    bool coordinated = false;
+    std::thread thread([&] { coordinated = coordinator.run(stop); });
+
+    ScanWorker worker("w", "");
+    CHECK(worker.connect(IPAddress("127.0.0.1"), coordinator.listenPort(), error));
+    ConnectScanConfig connectConfig;
+    connectConfig.timeout = std::chrono::milliseconds(1000);
+    ConnectScanner scanner(worker.loop(), connectConfig);
+    bool completed = worker.run([&](const ScanWorker::Source& source, const ScanWorker::ResultHandler& onResult,
+                                    const std::atomic<bool>& stopRequested) {
+        scanner.run(source, [&](const ConnectProbeResult& probe) {
+            LeaseProbeResult result;
+            result.target = probe.target;
+            result.port = probe.port;
+            result.tag = probe.tag;
+            result.open = probe.open;
+            result.answered = probe.answered;
+            onResult(result);
+        }, stopRequested);
+    }, stop, error);
+    thread.join();
+
+    CHECK(completed);
+    CHECK(coordinated);
+    CHECK(results.size() == 1);
+    if (results.size() == 1) {
+        CHECK(space.portAt(results[0]) == openPort);
+    }
+    auto stats = worker.getStats();
+    CHECK(stats.probed == job.ports.size());
+    CHECK(stats.open == 1);
+    CHECK(stats.leases == coordinator.getStats().leasesIssued);
+
+    std::cout << "工作节点测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 分布式扫描协议测试" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    try {
+        NetworkUtils::initialize();
+        testEncoding();
+        testFraming();
+        testCoordinator();
+        testWorker();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
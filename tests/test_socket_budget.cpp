@@ -0,0 +1,199 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "../src/utils/socket_budget.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+constexpr std::chrono::milliseconds NO_WAIT(0);
+
+// 占满窗口，返回获取到的名额数
+size_t acquireAll(SocketBudget& budget) {
+    size_t acquired = 0;
+    while (acquired < 100000 && budget.acquire(NO_WAIT)) {
+        ++acquired;
+    }
+    return acquired;
+}
+
+void releaseAll(SocketBudget& budget, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        budget.release();
+    }
+}
+
+void testCeiling() {
+    std::cout << "=== 测试在途上限计算 ===" << std::endl;
+
+    auto& budget = SocketBudget::instance();
+    SocketBudgetConfig config;
+    budget.configure(config);
+    auto stats = budget.getStats();
+    CHECK(stats.fileLimit > 0);
+    CHECK(stats.portsPerSource > 0);
+
+    // 上限取fd预算和端口预算 (保留1/8端口) 中较小者
+    size_t fdBudget = stats.fileLimit > config.fdReserve ? stats.fileLimit - config.fdReserve : 1;
+    size_t portBudget = stats.portsPerSource - stats.portsPerSource / 8;
+    CHECK(stats.ceiling == std::min(fdBudget, portBudget));
+    CHECK(stats.window == stats.ceiling);
+
+    // 每个源地址有独立的临时端口空间
+    config.sourceAddresses = {IPAddress("127.0.0.2"), IPAddress("127.0.0.3"), IPAddress("127.0.0.4")};
+    budget.configure(config);
+    CHECK(budget.getStats().ceiling == std::min(fdBudget, portBudget * 3));
+
+    // 保留量超过fd限制时至少允许一个连接
+    config.fdReserve = stats.fileLimit + 1;
+    budget.configure(config);
+    CHECK(budget.getStats().ceiling == 1);
+
+    config.fdReserve = 64;
+    config.maxInFlight = 10;
+    budget.configure(config);
+    CHECK(budget.getStats().ceiling == 10);
+
+    std::cout << "在途上限测试完成" << std::endl;
+}
+
+void testWindow() {
+    std::cout << "\n=== 测试AIMD窗口 ===" << std::endl;
+
+    auto& budget = SocketBudget::instance();
+    SocketBudgetConfig config;
+    config.maxInFlight = 8;
+    budget.configure(config);
+
+    CHECK(acquireAll(budget) == 8);
+    CHECK(budget.getStats().inFlight == 8);
+    CHECK(budget.getStats().peakInFlight >= 8);
+
+    // 端口耗尽: 窗口减半
+    uint64_t exhausted = budget.getStats().addressExhausted;
+    budget.reportError(EADDRNOTAVAIL);
+    CHECK(budget.getStats().window == 4);
+    CHECK(budget.getStats().addressExhausted == exhausted + 1);
+    releaseAll(budget, 8);
+    CHECK(acquireAll(budget) == 4);
+
+    // fd耗尽同样减半，但不低于1
+    uint64_t fdExhausted = budget.getStats().fdExhausted;
+    budget.reportError(EMFILE);
+    budget.reportError(EMFILE);
+    budget.reportError(ENFILE);
+    CHECK(budget.getStats().window == 1);
+    CHECK(budget.getStats().fdExhausted == fdExhausted + 3);
+    releaseAll(budget, 4);
+
+    // 加性增长: 每完成一个窗口的连接窗口+1; 拒绝和不可达按成功计入
+    budget.reportSuccess();
+    CHECK(budget.getStats().window == 2);
+    budget.reportError(ECONNREFUSED);
+    CHECK(budget.getStats().window == 2);
+    budget.reportError(EHOSTUNREACH);
+    CHECK(budget.getStats().window == 3);
+    for (int i = 0; i < 100; ++i) {
+        budget.reportSuccess();
+    }
+    // 不超过上限
+    CHECK(budget.getStats().window == 8);
+
+    CHECK(SocketBudget::isExhaustion(EADDRNOTAVAIL));
+    CHECK(SocketBudget::isExhaustion(EMFILE));
+    CHECK(!SocketBudget::isExhaustion(ECONNREFUSED));
+    CHECK(!SocketBudget::isExhaustion(ETIMEDOUT));
+
+    // Slot在作用域结束时归还名额
+    {
+        SocketBudget::Slot slot(NO_WAIT);
+        CHECK(slot.acquired());
+        CHECK(budget.getStats().inFlight == 1);
+    }
+    CHECK(budget.getStats().inFlight == 0);
+
+    std::cout << "AIMD窗口测试完成" << std::endl;
+}
+
+void testProbeSockets() {
+    std::cout << "\n=== 测试探测套接字 ===" << std::endl;
+
+#ifndef _WIN32
+    auto& budget = SocketBudget::instance();
+    SocketBudgetConfig config;
+    config.sourceAddresses = {IPAddress("127.0.0.2"), IPAddress("::1"), IPAddress("127.0.0.3")};
+    budget.configure(config);
+
+    // 源地址轮转，跳过不同地址族
+    std::string bound[4];
+    for (auto& address : bound) {
+        int sock = budget.openProbeSocket(IPAddress("127.0.0.1"));
+        CHECK(sock >= 0);
+        struct linger lg;
+        socklen_t length = sizeof(lg);
+        CHECK(getsockopt(sock, SOL_SOCKET, SO_LINGER, &lg, &length) == 0);
+        CHECK(lg.l_onoff == 1 && lg.l_linger == 0);
+        CHECK((fcntl(sock, F_GETFL, 0) & O_NONBLOCK) != 0);
+
+        struct sockaddr_in local;
+        length = sizeof(local);
+        getsockname(sock, reinterpret_cast<struct sockaddr*>(&local), &length);
+        char text[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &local.sin_addr, text, sizeof(text));
+        address = text;
+        budget.closeProbeSocket(sock);
+    }
+    CHECK(bound[0] != bound[1]);
+    CHECK(bound[0] == bound[2] || bound[1] == bound[2]);
+    CHECK(bound[0].rfind("127.0.0.", 0) == 0 && bound[0] != "127.0.0.1");
+
+    // 关闭RST后不设置SO_LINGER
+    config.sourceAddresses.clear();
+    config.resetOnClose = false;
+    budget.configure(config);
+    int sock = budget.openProbeSocket(IPAddress("127.0.0.1"));
+    struct linger lg;
+    socklen_t length = sizeof(lg);
+    getsockopt(sock, SOL_SOCKET, SO_LINGER, &lg, &length);
+    CHECK(lg.l_onoff == 0);
+    budget.closeProbeSocket(sock);
+#endif
+
+    std::cout << "探测套接字测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit 连接预算测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    try {
+        NetworkUtils::initialize();
+        testCeiling();
+        testWindow();
+        testProbeSockets();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
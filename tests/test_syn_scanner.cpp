@@ -0,0 +1,168 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include "../src/engines/network/syn_scanner.h"
+#include "../src/utils/socket_budget.h"
+
+using namespace MindSploit::Network;
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+bool overlapsEphemeral(uint16_t first, uint16_t last) {
+    PortRange ephemeral = SocketBudget::ephemeralPortRange();
+    return first <= ephemeral.end && last >= ephemeral.start;
+}
+
+void testSourcePorts() {
+    std::cout << "=== 测试本地端口范围选择 ===" << std::endl;
+
+    PortRange ephemeral = SocketBudget::ephemeralPortRange();
+    CHECK(ephemeral.start > 0 && ephemeral.start <= ephemeral.end);
+
+    // 未指定: 选在临时端口范围之外，优先其上方
+    SynScanConfig config;
+    std::string error;
+    CHECK(SynScanner::selectSourcePorts(config, error));
+    CHECK(config.firstSourcePort >= 1024 && config.firstSourcePort <= config.lastSourcePort);
+    CHECK(!overlapsEphemeral(config.firstSourcePort, config.lastSourcePort));
+    if (ephemeral.end <= 65535 - 1024) {
+        CHECK(config.firstSourcePort == ephemeral.end + 1 && config.lastSourcePort == 65535);
+    }
+    // 再次调用不改变已选的范围
+    uint16_t first = config.firstSourcePort;
+    CHECK(SynScanner::selectSourcePorts(config, error) && config.firstSourcePort == first);
+
+    // 与临时端口范围重叠的范围被拒绝
+    SynScanConfig overlapping;
+    overlapping.firstSourcePort = ephemeral.end;
+    overlapping.lastSourcePort = 65535;
+    error.clear();
+    CHECK(!SynScanner::selectSourcePorts(overlapping, error));
+    CHECK(error.find("overlap") != std::string::npos);
+
+    SynScanConfig inside;
+    inside.firstSourcePort = ephemeral.start;
+    inside.lastSourcePort = ephemeral.start;
+    CHECK(!SynScanner::selectSourcePorts(inside, error));
+
+    // 范围外的指定值原样使用，颠倒的上下界被交换
+    if (ephemeral.start > 2000) {
+        SynScanConfig below;
+        below.firstSourcePort = 2000;
+        below.lastSourcePort = 1500;
+        CHECK(SynScanner::selectSourcePorts(below, error));
+        CHECK(below.firstSourcePort == 1500 && below.lastSourcePort == 2000);
+    }
+
+    SynScanConfig zero;
+    zero.lastSourcePort = 100;
+    CHECK(!SynScanner::selectSourcePorts(zero, error));
+
+    std::cout << "本地端口范围选择测试完成" << std::endl;
+}
+
+void testLoopbackScan() {
+    std::cout << "\n=== 测试本机SYN扫描 ===" << std::endl;
+
+    Socket listener(AF_INET, SOCK_STREAM);
+    CHECK(listener.bind(IPAddress("127.0.0.1"), 0) && listener.listen(64));
+    uint16_t openPort = listener.getLocalPort();
+    uint16_t closedPort;
+    {
+        Socket unused(AF_INET, SOCK_STREAM);
+        unused.bind(IPAddress("127.0.0.1"), 0);
+        closedPort = unused.getLocalPort();
+    }
+
+    // 开放端口出现两次: 同一目标的第二个SYN得到相同的本地端口和序列号，
+    // 其SYN-ACK落在已完成的记录上，只回RST不重复报告
+    std::vector<uint16_t> ports = {openPort, closedPort, openPort};
+    size_t next = 0;
+
+    SynScanConfig config;
+    config.rate = 1000;
+    config.wait = std::chrono::milliseconds(500);
+    config.bannerWait = std::chrono::milliseconds(0);
+    config.seed = 12345;
+
+    SynScanner scanner(config);
+    std::map<uint16_t, int> closed;
+    std::vector<uint32_t> rtts;
+    scanner.setClosedHandler([&](const IPAddress& target, uint16_t port) {
+        CHECK(target.address == "127.0.0.1");
+        ++closed[port];
+    });
+    scanner.setSynAckHandler([&](const IPAddress&, uint16_t, uint32_t rtt, uint16_t window) {
+        rtts.push_back(rtt);
+        CHECK(window > 0);
+        return true;
+    });
+
+    std::vector<SynProbeResult> results;
+    std::atomic<bool> stop{false};
+    std::string error;
+    bool ok = scanner.run([&](IPAddress& target, uint16_t& port) {
+        if (next == ports.size()) {
+            return false;
+        }
+        target = IPAddress("127.0.0.1");
+        port = ports[next++];
+        return true;
+    }, [&](const SynProbeResult& result) { results.push_back(result); }, stop, error);
+
+    if (!ok && error.find("CAP_NET_RAW") != std::string::npos) {
+        std::cout << "  跳过: 需要root权限或CAP_NET_RAW" << std::endl;
+        return;
+    }
+    CHECK(ok);
+
+    SynScanStats stats = scanner.getStats();
+    CHECK(stats.synSent == 3);
+    // 确认号校验通过 (本地端口和初始序列号由散列重新算出) 才会计入开放或关闭
+    CHECK(stats.open == 1);
+    CHECK(stats.closed == 1);
+    CHECK(closed[closedPort] == 1 && closed.count(openPort) == 0);
+    CHECK(results.size() == 1);
+    if (results.size() == 1) {
+        CHECK(results[0].port == openPort);
+        CHECK(results[0].banner.empty());
+        CHECK(results[0].window > 0);
+        // 往返时间来自初始序列号中的发送时刻，本机应答远小于一秒
+        CHECK(results[0].synAckTime >= 0 && results[0].synAckTime < 1000);
+    }
+    CHECK(rtts.size() == 1);
+    CHECK(stats.peakConnections == 0);
+
+    std::cout << "本机SYN扫描测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit SYN扫描测试" << std::endl;
+    std::cout << "=====================" << std::endl;
+
+    try {
+        NetworkUtils::initialize();
+        testSourcePorts();
+        testLoopbackScan();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/utils/target_space.h"
+
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+void testPermutationBijection() {
+    std::cout << "=== 测试排列是双射 ===" << std::endl;
+
+    for (uint64_t size : {1ULL, 2ULL, 3ULL, 7ULL, 256ULL, 1000ULL, 65537ULL}) {
+        for (uint64_t seed : {0ULL, 1ULL, 0x5eedULL}) {
+            TargetPermutation permutation(size, seed);
+            std::vector<bool> seen(size, false);
+            ShardSpec all;
+            auto cursor = permutation.shard(all);
+            uint64_t index;
+            uint64_t count = 0;
+            bool duplicate = false;
+            bool outOfRange = false;
+            while (cursor.next(index)) {
+                if (index >= size) {
+                    outOfRange = true;
+                    continue;
+                }
+                duplicate = duplicate || seen[index];
+                seen[index] = true;
+                ++count;
+            }
+            CHECK(!outOfRange);
+            CHECK(!duplicate);
+            CHECK(count == size);
+        }
+    }
+
+    // 相同的(N, seed)得到相同序列，不同种子得到不同序列
+    TargetPermutation first(1000, 42);
+    TargetPermutation second(1000, 42);
+    TargetPermutation other(1000, 43);
+    ShardSpec all;
+    auto a = first.shard(all);
+    auto b = second.shard(all);
+    auto c = other.shard(all);
+    uint64_t x, y, z;
+    bool same = true;
+    bool differs = false;
+    while (a.next(x) && b.next(y) && c.next(z)) {
+        same = same && x == y;
+        differs = differs || x != z;
+    }
+    CHECK(same);
+    CHECK(differs);
+
+    std::cout << "排列测试完成" << std::endl;
+}
+
+void testShards() {
+    std::cout << "\n=== 测试分片互不重叠且覆盖全部 ===" << std::endl;
+
+    const uint64_t size = 10007;
+    TargetPermutation permutation(size, 7);
+    for (uint32_t shardCount : {1u, 2u, 3u, 16u}) {
+        std::vector<int> owner(size, -1);
+        bool overlap = false;
+        for (uint32_t i = 0; i < shardCount; ++i) {
+            ShardSpec shard;
+            shard.index = i;
+            shard.count = shardCount;
+            auto cursor = permutation.shard(shard);
+            uint64_t index;
+            while (cursor.next(index)) {
+                overlap = overlap || owner[index] != -1;
+                owner[index] = static_cast<int>(i);
+            }
+        }
+        CHECK(!overlap);
+        bool covered = true;
+        for (int shard : owner) {
+            covered = covered && shard != -1;
+        }
+        CHECK(covered);
+    }
+
+    // 连续位置区间拼起来等于整个排列
+    std::vector<bool> seen(size, false);
+    uint64_t total = 0;
+    uint64_t cycle = permutation.cycleLength();
+    for (uint64_t begin = 0; begin < cycle; begin += 1000) {
+        auto cursor = permutation.block(begin, std::min(cycle, begin + 1000));
+        uint64_t index;
+        while (cursor.next(index)) {
+            CHECK(!seen[index]);
+            seen[index] = true;
+            ++total;
+        }
+    }
+    CHECK(total == size);
+
+    ShardSpec shard;
+    CHECK(ShardSpec::parse("2/8", shard) && shard.index == 2 && shard.count == 8);
+    CHECK(!ShardSpec::parse("8/8", shard));
+    CHECK(!ShardSpec::parse("1/0", shard));
+    CHECK(!ShardSpec::parse("1-4", shard));
+    CHECK(!ShardSpec::parse("1/4x", shard));
+
+    std::cout << "分片测试完成" << std::endl;
+}
+
+void testTargetParsing(const std::string& hyphenatedHost) {
+    std::cout << "\n=== 测试目标解析 ===" << std::endl;
+
+    TargetSpace cidr;
+    CHECK(cidr.addTargets("10.0.0.77/24"));
+    CHECK(cidr.hostCount() == 256);
+    CHECK(cidr.hostAt(0).address == "10.0.0.0");
+    CHECK(cidr.hostAt(255).address == "10.0.0.255");
+
+    TargetSpace ranges;
+    CHECK(ranges.addTargets("192.168.1.1-192.168.1.10, 192.168.2.5-7,127.0.0.1"));
+    CHECK(ranges.hostCount() == 14);
+    CHECK(ranges.hostAt(9).address == "192.168.1.10");
+    CHECK(ranges.hostAt(10).address == "192.168.2.5");
+    CHECK(ranges.hostAt(13).address == "127.0.0.1");
+    CHECK(ranges.containsHost(IPAddress("192.168.2.6")));
+    CHECK(!ranges.containsHost(IPAddress("192.168.2.8")));
+
+    TargetSpace invalid;
+    CHECK(!invalid.addTargets("10.0.0.10-5"));
+    CHECK(!invalid.addTargets("10.0.0.1-256"));
+    CHECK(!invalid.addTargets("10.0.0.0/33"));
+    CHECK(!invalid.addTargets(" , "));
+
+    // 索引 = 主机序号 * 端口数 + 端口序号
+    TargetSpace space;
+    space.setPorts({22, 80, 443});
+    CHECK(space.addTargets("10.1.0.0/30"));
+    CHECK(space.size() == 12);
+    CHECK(space.hostIndexOf(7) == 2);
+    CHECK(space.portAt(7) == 80);
+    CHECK(space.containsPort(443));
+    CHECK(!space.containsPort(8080));
+
+    // 横线前不是IPv4地址的按主机名解析，而不是当作地址范围
+    IPAddress resolved = NetworkUtils::resolveHostname(hyphenatedHost);
+    if (resolved.address.empty()) {
+        std::cout << "跳过带横线的主机名: " << hyphenatedHost << " 无法解析" << std::endl;
+    } else {
+        TargetSpace named;
+        CHECK(named.addTargets(hyphenatedHost));
+        CHECK(named.hostCount() == 1);
+        CHECK(named.hostAt(0).address == resolved.address);
+    }
+
+    std::cout << "目标解析测试完成" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "MindSploit 目标空间测试" << std::endl;
+    std::cout << "========================" << std::endl;
+
+    // 可指定一个能解析的带横线主机名，默认使用常见的 ip6-localhost
+    std::string hyphenatedHost = argc > 1 ? argv[1] : "ip6-localhost";
+
+    try {
+        testPermutationBijection();
+        testShards();
+        testTargetParsing(hyphenatedHost);
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/engines/tls/tls_hello.h"
+#include "../src/engines/tls/x509_info.h"
+
+using namespace MindSploit::Tls;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+// 自签名EC P-256证书 (DER): C=CN, O=MindSploit Test, CN=test.example，序列号1234abcd，
+// SAN为 test.example、*.test.example 和 10.0.0.1，有效期 2026-10-18 11:28:29 至 2036-10-15 11:28:29 (UTC)
+const unsigned char TEST_CERTIFICATE[] = {
+    0x30, 0x82, 0x01, 0xf2, 0x30, 0x82, 0x01, 0x98, 0xa0, 0x03, 0x02, 0x01,
+    0x02, 0x02, 0x04, 0x12, 0x34, 0xab, 0xcd, 0x30, 0x0a, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x3e, 0x31, 0x0b, 0x30,
+    0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x43, 0x4e, 0x31, 0x18,
+    0x30, 0x16, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0f, 0x4d, 0x69, 0x6e,
+    0x64, 0x53, 0x70, 0x6c, 0x6f, 0x69, 0x74, 0x20, 0x54, 0x65, 0x73, 0x74,
+    0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x74,
+    0x65, 0x73, 0x74, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x30,
+    0x1e, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x38, 0x31, 0x31, 0x32,
+    0x38, 0x32, 0x39, 0x5a, 0x17, 0x0d, 0x33, 0x36, 0x31, 0x30, 0x31, 0x35,
+    0x31, 0x31, 0x32, 0x38, 0x32, 0x39, 0x5a, 0x30, 0x3e, 0x31, 0x0b, 0x30,
+    0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x43, 0x4e, 0x31, 0x18,
+    0x30, 0x16, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x0f, 0x4d, 0x69, 0x6e,
+    0x64, 0x53, 0x70, 0x6c, 0x6f, 0x69, 0x74, 0x20, 0x54, 0x65, 0x73, 0x74,
+    0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x74,
+    0x65, 0x73, 0x74, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x30,
+    0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+    0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42,
+    0x00, 0x04, 0xcb, 0x7f, 0x36, 0x93, 0x43, 0xae, 0x62, 0xb2, 0x5b, 0x71,
+    0x2d, 0x36, 0x11, 0xe6, 0xd1, 0xdf, 0xda, 0x58, 0x43, 0x60, 0x8a, 0x90,
+    0xa5, 0x96, 0xe7, 0xe7, 0x78, 0x33, 0xb5, 0xaa, 0x85, 0x70, 0x84, 0x2d,
+    0x14, 0x40, 0xa7, 0x13, 0x80, 0xbc, 0x35, 0xd7, 0xf7, 0x36, 0x90, 0xc1,
+    0x41, 0xb6, 0x6c, 0x4b, 0x17, 0x11, 0xf5, 0xef, 0xfc, 0xfc, 0xab, 0xd3,
+    0xe8, 0x3f, 0x7d, 0x75, 0xa6, 0x93, 0xa3, 0x81, 0x83, 0x30, 0x81, 0x80,
+    0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x5b,
+    0xb6, 0x05, 0x39, 0x09, 0x75, 0xe0, 0x3a, 0x86, 0x12, 0xb3, 0xf5, 0xd1,
+    0x3c, 0xe0, 0xdc, 0x94, 0xf3, 0x24, 0x58, 0x30, 0x1f, 0x06, 0x03, 0x55,
+    0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x5b, 0xb6, 0x05, 0x39,
+    0x09, 0x75, 0xe0, 0x3a, 0x86, 0x12, 0xb3, 0xf5, 0xd1, 0x3c, 0xe0, 0xdc,
+    0x94, 0xf3, 0x24, 0x58, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01,
+    0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x2d, 0x06,
+    0x03, 0x55, 0x1d, 0x11, 0x04, 0x26, 0x30, 0x24, 0x82, 0x0c, 0x74, 0x65,
+    0x73, 0x74, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x82, 0x0e,
+    0x2a, 0x2e, 0x74, 0x65, 0x73, 0x74, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+    0x6c, 0x65, 0x87, 0x04, 0x0a, 0x00, 0x00, 0x01, 0x30, 0x0a, 0x06, 0x08,
+    0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30,
+    0x45, 0x02, 0x20, 0x3f, 0x26, 0x6f, 0x6c, 0x1a, 0x92, 0x0d, 0x4f, 0x60,
+    0xed, 0x93, 0x82, 0x95, 0x23, 0x56, 0x33, 0x3f, 0x5e, 0xa2, 0x85, 0x24,
+    0x83, 0x9b, 0x1a, 0xe5, 0xb8, 0x7e, 0xc9, 0x8e, 0xd4, 0x92, 0x77, 0x02,
+    0x21, 0x00, 0x8f, 0x38, 0xa9, 0x90, 0x8b, 0x6d, 0xd7, 0x95, 0xc1, 0x68,
+    0x32, 0x79, 0x5d, 0x02, 0x6b, 0x68, 0x44, 0xa7, 0x0c, 0xca, 0x10, 0x96,
+    0x74, 0x08, 0xcf, 0xa6, 0x36, 0x6e, 0x7d, 0x3a, 0x56, 0xfe
+};
+
+std::string testCertificate() {
+    return std::string(reinterpret_cast<const char*>(TEST_CERTIFICATE), sizeof(TEST_CERTIFICATE));
+}
+
+void put8(std::string& out, uint8_t value) {
+    out += static_cast<char>(value);
+}
+
+void put16(std::string& out, uint16_t value) {
+    put8(out, static_cast<uint8_t>(value >> 8));
+    put8(out, static_cast<uint8_t>(value));
+}
+
+void put24(std::string& out, uint32_t value) {
+    put8(out, static_cast<uint8_t>(value >> 16));
+    put16(out, static_cast<uint16_t>(value));
+}
+
+uint16_t get16(const std::string& data, size_t offset) {
+    return static_cast<uint16_t>((static_cast<uint8_t>(data[offset]) << 8) | static_cast<uint8_t>(data[offset + 1]));
+}
+
+std::string record(uint8_t type, const std::string& payload) {
+    std::string out;
+    put8(out, type);
+    put16(out, TLS_VERSION_1_2);
+    put16(out, static_cast<uint16_t>(payload.size()));
+    return out + payload;
+}
+
+std::string handshake(uint8_t type, const std::string& body) {
+    std::string out;
+    put8(out, type);
+    put24(out, static_cast<uint32_t>(body.size()));
+    return out + body;
+}
+
+std::string extension(uint16_t type, const std::string& data) {
+    std::string out;
+    put16(out, type);
+    put16(out, static_cast<uint16_t>(data.size()));
+    return out + data;
+}
+
+std::string serverHello(uint16_t version, uint16_t cipherSuite, const std::string& extensions,
+                        const std::string& random = std::string(32, '\x42')) {
+    std::string body;
+    put16(body, version);
+    body += random;
+    put8(body, 32);
+    body += std::string(32, '\x07');
+    put16(body, cipherSuite);
+    put8(body, 0);
+    if (!extensions.empty()) {
+        put16(body, static_cast<uint16_t>(extensions.size()));
+        body += extensions;
+    }
+    return handshake(2, body);
+}
+
+// 逐字节输入，返回第一个非NEED_MORE的结果
+TlsHandshakeReader::Result feedBytes(TlsHandshakeReader& reader, const std::string& data) {
+    for (char c : data) {
+        auto result = reader.feed(&c, 1);
+        if (result != TlsHandshakeReader::Result::NEED_MORE) {
+            return result;
+        }
+    }
+    return TlsHandshakeReader::Result::NEED_MORE;
+}
+
+void testCertificateParser() {
+    std::cout << "=== 测试X.509证书解析 ===" << std::endl;
+
+    CertificateInfo info = parseCertificate(testCertificate());
+    CHECK(info.valid);
+    CHECK(info.subject == "C=CN,O=MindSploit Test,CN=test.example");
+    CHECK(info.issuer == info.subject);
+    CHECK(info.selfSigned);
+    CHECK(info.commonName == "test.example");
+    CHECK(info.serialNumber == "1234abcd");
+    CHECK(info.notBefore == "2026-10-18 11:28:29");
+    CHECK(info.notAfter == "2036-10-15 11:28:29");
+    CHECK(info.notAfterEpoch == 2107682909);
+    CHECK(info.keyType == "EC");
+    CHECK(info.keyBits == 256);
+    CHECK(info.curve == "P-256");
+    CHECK(info.keyDescription() == "EC-P-256");
+    CHECK(info.signatureAlgorithm == "ecdsa-with-SHA256");
+    CHECK((info.subjectAltNames == std::vector<std::string>{"test.example", "*.test.example", "10.0.0.1"}));
+
+    // 截断或损坏的输入不会越界，只返回无效
+    std::string der = testCertificate();
+    CHECK(!parseCertificate("").valid);
+    for (size_t length : {size_t(1), size_t(4), size_t(100), der.size() - 1}) {
+        CHECK(!parseCertificate(der.substr(0, length)).valid);
+    }
+    std::string corrupted = der;
+    corrupted[1] = '\x84';
+    CHECK(!parseCertificate(corrupted).valid);
+
+    std::cout << "证书解析测试完成" << std::endl;
+}
+
+void testClientHello() {
+    std::cout << "\n=== 测试ClientHello构造 ===" << std::endl;
+
+    ClientHelloSpec spec;
+    spec.cipherSuites = {0x1301, 0xc02f};
+    spec.supportedVersions = {TLS_VERSION_1_3, TLS_VERSION_1_2};
+    spec.serverName = "test.example";
+    spec.alpn = {"h2", "http/1.1"};
+    spec.grease = true;
+    std::string hello = buildClientHello(spec);
+
+    CHECK(hello.size() > 9);
+    CHECK(static_cast<uint8_t>(hello[0]) == 22);
+    CHECK(get16(hello, 1) == TLS_VERSION_1_0);
+    CHECK(get16(hello, 3) == hello.size() - 5);
+    CHECK(static_cast<uint8_t>(hello[5]) == 1);
+    CHECK(get16(hello, 9) == TLS_VERSION_1_2);
+    CHECK(hello.find("test.example") != std::string::npos);
+    CHECK(hello.find("http/1.1") != std::string::npos);
+
+    // IP地址不发送SNI
+    spec.serverName = "10.0.0.1";
+    CHECK(buildClientHello(spec).find("10.0.0.1") == std::string::npos);
+
+    std::cout << "ClientHello测试完成" << std::endl;
+}
+
+void testHandshakeReader() {
+    std::cout << "\n=== 测试服务端握手解析 ===" << std::endl;
+    using Result = TlsHandshakeReader::Result;
+
+    // TLS 1.2: ServerHello + 跨两个记录的Certificate + ServerHelloDone
+    std::string alpn;
+    put16(alpn, 3);
+    put8(alpn, 2);
+    alpn += "h2";
+    std::string extensions = extension(EXT_RENEGOTIATION_INFO, std::string(1, '\0')) + extension(EXT_ALPN, alpn);
+    std::string der = testCertificate();
+    std::string chain;
+    put24(chain, static_cast<uint32_t>(der.size() + 3));
+    put24(chain, static_cast<uint32_t>(der.size()));
+    chain += der;
+    std::string certificate = handshake(11, chain);
+    std::string flight = record(22, serverHello(TLS_VERSION_1_2, 0xc02f, extensions)) +
+                         record(22, certificate.substr(0, 200)) +
+                         record(22, certificate.substr(200) + handshake(14, ""));
+
+    TlsHandshakeReader full(TlsHandshakeReader::StopAt::SERVER_HELLO_DONE);
+    CHECK(feedBytes(full, flight) == Result::DONE);
+    const ServerHelloInfo& hello = full.serverHello();
+    CHECK(hello.received);
+    CHECK(hello.version == TLS_VERSION_1_2);
+    CHECK(hello.cipherSuite == 0xc02f);
+    CHECK(hello.alpn == "h2");
+    CHECK((hello.extensions == std::vector<uint16_t>{EXT_RENEGOTIATION_INFO, EXT_ALPN}));
+    CHECK(!hello.helloRetryRequest);
+    CHECK(full.certificates().size() == 1);
+    CHECK(!full.certificates().empty() && full.certificates()[0] == der);
+
+    TlsHandshakeReader firstOnly(TlsHandshakeReader::StopAt::SERVER_HELLO);
+    CHECK(firstOnly.feed(flight.data(), flight.size()) == Result::DONE);
+    CHECK(firstOnly.certificates().empty());
+
+    // TLS 1.3: 版本取自supported_versions，后续消息已加密，收到ServerHello即结束
+    std::string version;
+    put16(version, TLS_VERSION_1_3);
+    TlsHandshakeReader tls13;
+    std::string data = record(22, serverHello(TLS_VERSION_1_2, 0x1301, extension(EXT_SUPPORTED_VERSIONS, version)));
+    CHECK(feedBytes(tls13, data) == Result::DONE);
+    CHECK(tls13.serverHello().version == TLS_VERSION_1_3);
+
+    // HelloRetryRequest以固定的random标识
+    const unsigned char retryRandom[32] = {
+        0xcf, 0x21, 0xad, 0x74, 0xe5, 0x9a, 0x61, 0x11, 0xbe, 0x1d, 0x8c, 0x02, 0x1e, 0x65, 0xb8, 0x91,
+        0xc2, 0xa2, 0x11, 0x16, 0x7a, 0xbb, 0x8c, 0x5e, 0x07, 0x9e, 0x09, 0xe2, 0xc8, 0xa8, 0x33, 0x9c
+    };
+    TlsHandshakeReader retry;
+    data = record(22, serverHello(TLS_VERSION_1_2, 0x1301, extension(EXT_SUPPORTED_VERSIONS, version),
+                                  std::string(reinterpret_cast<const char*>(retryRandom), 32)));
+    CHECK(retry.feed(data.data(), data.size()) == Result::DONE);
+    CHECK(retry.serverHello().helloRetryRequest);
+
+    // 会话复用: ServerHello之后直接是ChangeCipherSpec
+    TlsHandshakeReader resumed;
+    data = record(22, serverHello(TLS_VERSION_1_2, 0xc02f, "")) + record(20, std::string(1, '\x01'));
+    CHECK(feedBytes(resumed, data) == Result::DONE);
+    CHECK(resumed.serverHello().sessionResumed);
+
+    TlsHandshakeReader alert;
+    data = record(21, std::string("\x02\x28", 2));
+    CHECK(alert.feed(data.data(), data.size()) == Result::ALERT);
+    CHECK(alert.serverHello().alert);
+    CHECK(alert.serverHello().alertDescription == 40);
+
+    TlsHandshakeReader notTls;
+    data = "HTTP/1.1 400 Bad Request\r\n\r\n";
+    CHECK(notTls.feed(data.data(), data.size()) == Result::PARSE_ERROR);
+
+    TlsHandshakeReader early;
+    data = record(23, "encrypted");
+    CHECK(early.feed(data.data(), data.size()) == Result::PARSE_ERROR);
+
+    TlsHandshakeReader malformed;
+    data = record(22, handshake(2, std::string(20, '\0')));
+    CHECK(malformed.feed(data.data(), data.size()) == Result::PARSE_ERROR);
+
+    std::cout << "握手解析测试完成" << std::endl;
+}
+
+int main() {
+    std::cout << "MindSploit TLS解析测试" << std::endl;
+    std::cout << "======================" << std::endl;
+
+    try {
+        testCertificateParser();
+        testClientHello();
+        testHandshakeReader();
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include "../src/utils/xdp_channel.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace MindSploit::Utils;
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cout << "  失败: " << #condition << " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; \
+            ++failures; \
+        } \
+    } while (0)
+
+#ifdef __linux__
+
+long bpf(int command, union bpf_attr& attr) {
+    return syscall(__NR_bpf, command, &attr, sizeof(attr));
+}
+
+uint32_t ipv4(const char* text) {
+    uint32_t address = 0;
+    inet_pton(AF_INET, text, &address);
+    return address;
+}
+
+// 以太网帧: IPv4首部长度为ihl*4，目的端口之后补足TCP首部
+std::vector<uint8_t> makeFrame(uint16_t etherType, uint8_t protocol, const char* destination, uint16_t port,
+                               uint8_t ihl = 5) {
+    std::vector<uint8_t> frame(14 + ihl * 4 + 20, 0);
+    frame[12] = static_cast<uint8_t>(etherType >> 8);
+    frame[13] = static_cast<uint8_t>(etherType & 0xff);
+    frame[14] = static_cast<uint8_t>(0x40 | ihl);
+    frame[14 + 9] = protocol;
+    uint32_t address = ipv4(destination);
+    std::memcpy(&frame[14 + 16], &address, 4);
+    size_t l4 = 14 + ihl * 4;
+    frame[l4] = 0x01;
+    frame[l4 + 1] = 0xbb;
+    frame[l4 + 2] = static_cast<uint8_t>(port >> 8);
+    frame[l4 + 3] = static_cast<uint8_t>(port & 0xff);
+    return frame;
+}
+
+// 在内核中试运行 (BPF_PROG_TEST_RUN)，返回XDP动作，失败返回-1
+int testRun(int program, std::vector<uint8_t> frame) {
+    union bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.test.prog_fd = static_cast<uint32_t>(program);
+    attr.test.data_in = reinterpret_cast<uint64_t>(frame.data());
+    attr.test.data_size_in = static_cast<uint32_t>(frame.size());
+    attr.test.repeat = 1;
+    if (bpf(BPF_PROG_TEST_RUN, attr) < 0) {
+        return -1;
+    }
+    return static_cast<int>(attr.test.retval);
+}
+
+void testProgram() {
+    std::cout << "=== 测试XDP分流程序 ===" << std::endl;
+
+    // 源地址的最低字节大于127，按内存字节序读出的值最高位为1，检查比较时没有符号扩展
+    const char* source = "192.168.1.200";
+    std::vector<struct bpf_insn> code = buildXdpRedirectProgram(ipv4(source), 6, 61000, 65535, 0);
+    CHECK(!code.empty());
+    CHECK(code.back().code == (BPF_JMP | BPF_EXIT));
+    // 所有向前跳转都落在程序之内
+    bool jumpsValid = true;
+    for (size_t i = 0; i < code.size(); ++i) {
+        uint8_t opClass = code[i].code & 0x07;
+        uint8_t op = code[i].code & 0xf0;
+        if (opClass == BPF_JMP && op != BPF_CALL && op != BPF_EXIT) {
+            jumpsValid = jumpsValid && code[i].off >= 0 && i + 1 + code[i].off < code.size();
+        }
+    }
+    CHECK(jumpsValid);
+
+    // XSKMAP需要绑定的AF_XDP套接字，试运行改用DEVMAP: 有条目时bpf_redirect_map返回XDP_REDIRECT
+    union bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_DEVMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = 1;
+    int mapFd = static_cast<int>(bpf(BPF_MAP_CREATE, attr));
+    if (mapFd < 0) {
+        std::cout << "  跳过内核试运行: " << std::strerror(errno) << " (需要root权限或CAP_BPF)" << std::endl;
+        return;
+    }
+    uint32_t key = 0;
+    uint32_t loopback = 1;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.map_fd = static_cast<uint32_t>(mapFd);
+    attr.key = reinterpret_cast<uint64_t>(&key);
+    attr.value = reinterpret_cast<uint64_t>(&loopback);
+    CHECK(bpf(BPF_MAP_UPDATE_ELEM, attr) == 0);
+
+    code = buildXdpRedirectProgram(ipv4(source), 6, 61000, 65535, mapFd);
+    static const char license[] = "GPL";
+    std::vector<char> log(65536, 0);
+    std::memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insn_cnt = static_cast<uint32_t>(code.size());
+    attr.insns = reinterpret_cast<uint64_t>(code.data());
+    attr.license = reinterpret_cast<uint64_t>(license);
+    attr.expected_attach_type = BPF_XDP;
+    attr.log_level = 1;
+    attr.log_buf = reinterpret_cast<uint64_t>(log.data());
+    attr.log_size = static_cast<uint32_t>(log.size());
+    int program = static_cast<int>(bpf(BPF_PROG_LOAD, attr));
+    // 校验器必须接受程序
+    CHECK(program >= 0);
+    if (program < 0) {
+        std::cout << "  校验器: " << log.data() << std::endl;
+        close(mapFd);
+        return;
+    }
+
+    CHECK(testRun(program, makeFrame(0x0800, 6, source, 61000)) == XDP_REDIRECT);
+    CHECK(testRun(program, makeFrame(0x0800, 6, source, 65535)) == XDP_REDIRECT);
+    // 带选项的IP首部按IHL跳过
+    CHECK(testRun(program, makeFrame(0x0800, 6, source, 62000, 6)) == XDP_REDIRECT);
+    // 端口范围之外 (含内核临时端口)
+    CHECK(testRun(program, makeFrame(0x0800, 6, source, 60999)) == XDP_PASS);
+    CHECK(testRun(program, makeFrame(0x0800, 6, source, 22)) == XDP_PASS);
+    // 发往本机其它地址或转发的报文
+    CHECK(testRun(program, makeFrame(0x0800, 6, "192.168.1.201", 61000)) == XDP_PASS);
+    CHECK(testRun(program, makeFrame(0x0800, 6, "10.0.0.1", 61000)) == XDP_PASS);
+    // 其它协议和非IPv4
+    CHECK(testRun(program, makeFrame(0x0800, 17, source, 61000)) == XDP_PASS);
+    CHECK(testRun(program, makeFrame(0x0806, 6, source, 61000)) == XDP_PASS);
+    CHECK(testRun(program, makeFrame(0x86dd, 6, source, 61000)) == XDP_PASS);
+    // 截断的帧
+    std::vector<uint8_t> truncated = makeFrame(0x0800, 6, source, 61000);
+    truncated.resize(14 + 20 + 2);
+    CHECK(testRun(program, truncated) == XDP_PASS);
+    truncated.resize(14 + 10);
+    CHECK(testRun(program, truncated) == XDP_PASS);
+
+    close(program);
+    close(mapFd);
+    std::cout << "XDP分流程序测试完成" << std::endl;
+}
+
+void testRing() {
+    std::cout << "\n=== 测试环形队列下标 ===" << std::endl;
+
+    uint32_t producer = 0;
+    uint32_t consumer = 0;
+    uint64_t entries[8] = {0};
+    XdpRing ring;
+    ring.producer = &producer;
+    ring.consumer = &consumer;
+    ring.descriptors = entries;
+    ring.size = 8;
+
+    CHECK(ring.ready() == 0);
+    CHECK(ring.space() == 8);
+
+    // 下标在32位回绕前后连续
+    producer = consumer = 0xfffffffeu;
+    for (uint32_t i = 0; i < 5; ++i) {
+        ring.at<uint64_t>(producer + i) = 100 + i;
+    }
+    ring.produce(5);
+    CHECK(producer == 3);
+    CHECK(ring.ready() == 5);
+    CHECK(ring.space() == 3);
+    CHECK(entries[6] == 100 && entries[7] == 101 && entries[0] == 102 && entries[2] == 104);
+
+    std::vector<uint64_t> taken;
+    for (uint32_t i = 0; i < 3; ++i) {
+        taken.push_back(ring.at<uint64_t>(consumer + i));
+    }
+    ring.consume(3);
+    CHECK(taken == std::vector<uint64_t>({100, 101, 102}));
+    CHECK(consumer == 1);
+    CHECK(ring.ready() == 2 && ring.space() == 6);
+
+    // 填满后没有空位，条目数等于环大小
+    ring.produce(ring.space());
+    CHECK(ring.ready() == 8 && ring.space() == 0);
+    ring.consume(8);
+    CHECK(ring.ready() == 0 && ring.space() == 8);
+    CHECK(producer == consumer);
+
+    std::cout << "环形队列下标测试完成" << std::endl;
+}
+
+#endif // __linux__
+
+int main() {
+    std::cout << "MindSploit AF_XDP通道测试" << std::endl;
+    std::cout << "=========================" << std::endl;
+
+    try {
+#ifdef __linux__
+        testProgram();
+        testRing();
+#else
+        std::cout << "AF_XDP仅支持Linux" << std::endl;
+#endif
+    } catch (const std::exception& e) {
+        std::cout << "测试过程中发生错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::cout << "\n" << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "\n所有测试完成！" << std::endl;
+    return 0;
+}